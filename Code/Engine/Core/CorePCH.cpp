@@ -47,6 +47,7 @@ EZ_STATICLINK_LIBRARY(Core)
   EZ_STATICLINK_REFERENCE(Core_Prefabs_Implementation_PrefabReferenceComponent);
   EZ_STATICLINK_REFERENCE(Core_Prefabs_Implementation_PrefabResource);
   EZ_STATICLINK_REFERENCE(Core_ResourceManager_Implementation_Resource);
+  EZ_STATICLINK_REFERENCE(Core_ResourceManager_Implementation_ResourceDependencies);
   EZ_STATICLINK_REFERENCE(Core_ResourceManager_Implementation_ResourceHandle);
   EZ_STATICLINK_REFERENCE(Core_ResourceManager_Implementation_ResourceLoading);
   EZ_STATICLINK_REFERENCE(Core_ResourceManager_Implementation_ResourceManager);
@@ -73,6 +74,7 @@ EZ_STATICLINK_LIBRARY(Core)
   EZ_STATICLINK_REFERENCE(Core_World_Implementation_SettingsComponent);
   EZ_STATICLINK_REFERENCE(Core_World_Implementation_SpatialData);
   EZ_STATICLINK_REFERENCE(Core_World_Implementation_SpatialSystem);
+  EZ_STATICLINK_REFERENCE(Core_World_Implementation_SpatialSystem_LooseOctree);
   EZ_STATICLINK_REFERENCE(Core_World_Implementation_SpatialSystem_RegularGrid);
   EZ_STATICLINK_REFERENCE(Core_World_Implementation_World);
   EZ_STATICLINK_REFERENCE(Core_World_Implementation_WorldData);
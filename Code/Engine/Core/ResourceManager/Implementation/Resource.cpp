@@ -142,14 +142,12 @@ void ezResource::CallUnloadData(Unload WhatToUnload)
   m_uiQualityLevelsLoadable = ld.m_uiQualityLevelsLoadable;
 }
 
-#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
 thread_local const ezResource* g_pCurrentlyUpdatingContent = nullptr;
 
 const ezResource* ezResource::GetCurrentlyUpdatingContent()
 {
   return g_pCurrentlyUpdatingContent;
 }
-#endif
 
 void ezResource::CallUpdateContent(ezStreamReader* Stream)
 {
@@ -157,14 +155,10 @@ void ezResource::CallUpdateContent(ezStreamReader* Stream)
 
   EZ_LOG_BLOCK("ezResource::UpdateContent", GetResourceID().GetData());
 
-#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
   const ezResource* pPreviouslyUpdatingContent = g_pCurrentlyUpdatingContent;
   g_pCurrentlyUpdatingContent = this;
   ezResourceLoadDesc ld = UpdateContent(Stream);
   g_pCurrentlyUpdatingContent = pPreviouslyUpdatingContent;
-#else
-  ezResourceLoadDesc ld = UpdateContent(Stream);
-#endif
 
   EZ_ASSERT_DEV(ld.m_State != ezResourceState::Invalid, "UpdateContent() did not return a valid resource load state");
   EZ_ASSERT_DEV(ld.m_uiQualityLevelsDiscardable != 0xFF, "UpdateContent() did not fill out m_uiQualityLevelsDiscardable correctly");
@@ -236,6 +230,12 @@ void ezResource::SetPriority(ezResourcePriority priority)
 
   m_Priority = priority;
 
+  if (m_Flags.IsSet(ezResourceFlags::IsQueuedForLoading))
+  {
+    // re-sort the loading queue right away, instead of waiting for the next periodic update
+    ezResourceManager::UpdateLoadingQueuePriority(this);
+  }
+
   ezResourceEvent e;
   e.m_pResource = this;
   e.m_Type = ezResourceEvent::Type::ResourcePriorityChanged;
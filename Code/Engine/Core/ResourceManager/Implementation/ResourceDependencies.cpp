@@ -0,0 +1,334 @@
+#include <CorePCH.h>
+
+#include <Core/ResourceManager/Implementation/ResourceManagerState.h>
+#include <Core/ResourceManager/ResourceManager.h>
+#include <Foundation/IO/Stream.h>
+#include <Foundation/Profiling/Profiling.h>
+
+void ezResourceManager::SetRecordResourceDependencies(bool bEnable)
+{
+  EZ_LOCK(s_ResourceMutex);
+  s_State->s_bRecordResourceDependencies = bEnable;
+}
+
+bool ezResourceManager::GetRecordResourceDependencies()
+{
+  return s_State->s_bRecordResourceDependencies;
+}
+
+void ezResourceManager::SetPrefetchResourceDependencies(bool bEnable)
+{
+  EZ_LOCK(s_ResourceMutex);
+  s_State->s_bPrefetchResourceDependencies = bEnable;
+}
+
+bool ezResourceManager::GetPrefetchResourceDependencies()
+{
+  return s_State->s_bPrefetchResourceDependencies;
+}
+
+void ezResourceManager::ClearResourceDependencies()
+{
+  EZ_LOCK(s_ResourceMutex);
+  s_State->s_ResourceDependencies.Clear();
+}
+
+void ezResourceManager::RecordResourceDependency(ezResource* pDependency)
+{
+  EZ_ASSERT_DEBUG(s_ResourceMutex.IsLocked(), "Calling code must acquire s_ResourceMutex");
+
+  // resources that are looked up for prefetching were already recorded for the resource that needs them
+  if (!s_State->s_bRecordResourceDependencies || s_State->s_bPrefetchingResourceDependencies)
+    return;
+
+  const ezResource* pOwner = ezResource::GetCurrentlyUpdatingContent();
+
+  if (pOwner == nullptr || pOwner == pDependency || !pOwner->GetBaseResourceFlags().IsSet(ezResourceFlags::IsReloadable))
+    return;
+
+  ezResourceManagerState::LookupKey key;
+  key.m_pType = pOwner->GetDynamicRTTI();
+  key.m_uiIDHash = pOwner->GetResourceIDHash();
+
+  ezResourceManagerState::ResourceDependencies& deps = s_State->s_ResourceDependencies[key];
+
+  if (!deps.m_bRecordedThisSession)
+  {
+    deps.m_bRecordedThisSession = true;
+    deps.m_pType = key.m_pType;
+    deps.m_sResourceID.Assign(pOwner->GetResourceID());
+    deps.m_Dependencies.Clear();
+  }
+
+  const ezRTTI* pType = pDependency->GetDynamicRTTI();
+
+  for (const auto& dep : deps.m_Dependencies)
+  {
+    if (dep.m_pType == pType && dep.m_sResourceID.GetHash() == pDependency->GetResourceIDHash())
+      return;
+  }
+
+  auto& dep = deps.m_Dependencies.ExpandAndGetRef();
+  dep.m_pType = pType;
+  dep.m_sResourceID.Assign(pDependency->GetResourceID());
+}
+
+void ezResourceManager::PrefetchResourceDependencies(ezResource* pResource)
+{
+  EZ_ASSERT_DEBUG(s_ResourceMutex.IsLocked(), "Calling code must acquire s_ResourceMutex");
+
+  ezResourceManagerState::LookupKey key;
+  key.m_pType = pResource->GetDynamicRTTI();
+  key.m_uiIDHash = pResource->GetResourceIDHash();
+
+  auto it = s_State->s_ResourceDependencies.Find(key);
+  if (!it.IsValid())
+    return;
+
+  EZ_PROFILE_SCOPE("PrefetchResourceDependencies");
+
+  const bool bWasPrefetching = s_State->s_bPrefetchingResourceDependencies;
+  s_State->s_bPrefetchingResourceDependencies = true;
+
+  for (const auto& dep : it.Value().m_Dependencies)
+  {
+    ezResource* pDependency = GetResource(dep.m_pType, dep.m_sResourceID.GetData(), true);
+
+    // the dependency is needed by the time pResource is loaded, so it must not wait behind less important resources
+    if (pDependency->GetPriority() > pResource->GetPriority())
+    {
+      pDependency->SetPriority(pResource->GetPriority());
+    }
+
+    // nobody holds a handle to the dependency until pResource gets to it, don't let it be unloaded as unused right away
+    pDependency->m_LastAcquire = s_State->s_LastFrameUpdate;
+
+    // recurses into the dependencies of the dependency, resources that are already queued end the recursion
+    InternalPreloadResource(pDependency, false);
+  }
+
+  s_State->s_bPrefetchingResourceDependencies = bWasPrefetching;
+}
+
+void ezResourceManager::SaveResourceDependencies(ezStreamWriter& stream)
+{
+  EZ_LOCK(s_ResourceMutex);
+
+  // all strings are written once and referenced by index, the same dependencies are usually shared by many resources
+  ezDynamicArray<const ezRTTI*> types;
+  ezDynamicArray<ezHashedString> resourceIDs;
+  ezHashTable<const ezRTTI*, ezUInt32> typeToIndex;
+  ezHashTable<ezHashedString, ezUInt32> resourceIDToIndex;
+
+  auto addResourceID = [&](const ezHashedString& sResourceID) {
+    if (!resourceIDToIndex.Contains(sResourceID))
+    {
+      resourceIDToIndex.Insert(sResourceID, resourceIDs.GetCount());
+      resourceIDs.PushBack(sResourceID);
+    }
+  };
+
+  auto addType = [&](const ezRTTI* pType) {
+    if (!typeToIndex.Contains(pType))
+    {
+      typeToIndex.Insert(pType, types.GetCount());
+      types.PushBack(pType);
+    }
+  };
+
+  ezUInt32 uiNumEntries = 0;
+
+  for (auto it = s_State->s_ResourceDependencies.GetIterator(); it.IsValid(); ++it)
+  {
+    if (it.Value().m_Dependencies.IsEmpty())
+      continue;
+
+    ++uiNumEntries;
+    addType(it.Value().m_pType);
+    addResourceID(it.Value().m_sResourceID);
+
+    for (const auto& dep : it.Value().m_Dependencies)
+    {
+      addType(dep.m_pType);
+      addResourceID(dep.m_sResourceID);
+    }
+  }
+
+  const ezUInt8 uiVersion = 2;
+  stream << uiVersion;
+
+  stream << types.GetCount();
+  for (const ezRTTI* pType : types)
+  {
+    stream << pType->GetTypeName();
+  }
+
+  stream << resourceIDs.GetCount();
+  for (const ezHashedString& sResourceID : resourceIDs)
+  {
+    stream << sResourceID.GetData();
+  }
+
+  stream << uiNumEntries;
+  for (auto it = s_State->s_ResourceDependencies.GetIterator(); it.IsValid(); ++it)
+  {
+    const auto& deps = it.Value().m_Dependencies;
+
+    if (deps.IsEmpty())
+      continue;
+
+    stream << typeToIndex[it.Value().m_pType];
+    stream << resourceIDToIndex[it.Value().m_sResourceID];
+    stream << deps.GetCount();
+
+    for (const auto& dep : deps)
+    {
+      stream << typeToIndex[dep.m_pType];
+      stream << resourceIDToIndex[dep.m_sResourceID];
+    }
+  }
+}
+
+ezResult ezResourceManager::LoadResourceDependencies(ezStreamReader& stream)
+{
+  // the counts are only used after they were checked against these, so that broken data can't request huge allocations
+  constexpr ezUInt32 uiMaxTypes = 0xFFFF;
+  constexpr ezUInt32 uiMaxResourceIDs = 0xFFFFFF;
+
+  struct LoadedEntry
+  {
+    ezUInt32 m_uiType = 0;
+    ezUInt32 m_uiResourceID = 0;
+    ezUInt32 m_uiFirstDependency = 0;
+    ezUInt32 m_uiNumDependencies = 0;
+  };
+
+  ezUInt8 uiVersion = 0;
+  stream >> uiVersion;
+
+  if (uiVersion != 2)
+  {
+    ezLog::Warning("Unsupported resource dependency cache version {}", uiVersion);
+    return EZ_FAILURE;
+  }
+
+  // everything is read and validated first, the known dependencies are only modified once all of the data turned out to be fine
+  ezStringBuilder sTemp;
+
+  ezUInt32 uiNumTypes = 0;
+  EZ_SUCCEED_OR_RETURN(stream.ReadDWordValue(&uiNumTypes));
+
+  if (uiNumTypes > uiMaxTypes)
+    return EZ_FAILURE;
+
+  ezDynamicArray<const ezRTTI*> types;
+  types.Reserve(uiNumTypes);
+  for (ezUInt32 i = 0; i < uiNumTypes; ++i)
+  {
+    EZ_SUCCEED_OR_RETURN(stream.ReadString(sTemp));
+
+    if (sTemp.IsEmpty())
+      return EZ_FAILURE;
+
+    // the type may be in a plugin that is not loaded, or does not exist anymore
+    // a type that is not a resource or cannot be instantiated must never reach ezResourceManager::GetResource, treat it as unknown
+    const ezRTTI* pType = ezRTTI::FindTypeByName(sTemp);
+    if (pType != nullptr && (!pType->IsDerivedFrom<ezResource>() || !pType->GetAllocator()->CanAllocate()))
+      pType = nullptr;
+
+    types.PushBack(pType);
+  }
+
+  ezUInt32 uiNumResourceIDs = 0;
+  EZ_SUCCEED_OR_RETURN(stream.ReadDWordValue(&uiNumResourceIDs));
+
+  if (uiNumResourceIDs > uiMaxResourceIDs)
+    return EZ_FAILURE;
+
+  ezDynamicArray<ezHashedString> resourceIDs;
+  resourceIDs.Reserve(uiNumResourceIDs);
+  for (ezUInt32 i = 0; i < uiNumResourceIDs; ++i)
+  {
+    EZ_SUCCEED_OR_RETURN(stream.ReadString(sTemp));
+
+    if (sTemp.IsEmpty())
+      return EZ_FAILURE;
+
+    resourceIDs.ExpandAndGetRef().Assign(sTemp);
+  }
+
+  // every resource has at most one entry and depends on every other resource at most once
+  const ezUInt64 uiMaxCombinations = static_cast<ezUInt64>(uiNumTypes) * uiNumResourceIDs;
+
+  ezUInt32 uiNumEntries = 0;
+  EZ_SUCCEED_OR_RETURN(stream.ReadDWordValue(&uiNumEntries));
+
+  if (uiNumEntries > uiMaxCombinations)
+    return EZ_FAILURE;
+
+  ezDynamicArray<LoadedEntry> entries;
+  ezDynamicArray<ezResourceManagerState::ResourceDependency> dependencies;
+  entries.Reserve(uiNumEntries);
+
+  for (ezUInt32 e = 0; e < uiNumEntries; ++e)
+  {
+    LoadedEntry& entry = entries.ExpandAndGetRef();
+    EZ_SUCCEED_OR_RETURN(stream.ReadDWordValue(&entry.m_uiType));
+    EZ_SUCCEED_OR_RETURN(stream.ReadDWordValue(&entry.m_uiResourceID));
+    EZ_SUCCEED_OR_RETURN(stream.ReadDWordValue(&entry.m_uiNumDependencies));
+
+    if (entry.m_uiType >= uiNumTypes || entry.m_uiResourceID >= uiNumResourceIDs || entry.m_uiNumDependencies > uiMaxCombinations)
+      return EZ_FAILURE;
+
+    const ezUInt32 uiNumStored = entry.m_uiNumDependencies;
+    entry.m_uiFirstDependency = dependencies.GetCount();
+
+    for (ezUInt32 d = 0; d < uiNumStored; ++d)
+    {
+      ezUInt32 uiType = 0;
+      ezUInt32 uiDependencyID = 0;
+      EZ_SUCCEED_OR_RETURN(stream.ReadDWordValue(&uiType));
+      EZ_SUCCEED_OR_RETURN(stream.ReadDWordValue(&uiDependencyID));
+
+      if (uiType >= uiNumTypes || uiDependencyID >= uiNumResourceIDs)
+        return EZ_FAILURE;
+
+      if (types[uiType] == nullptr)
+        continue;
+
+      auto& dep = dependencies.ExpandAndGetRef();
+      dep.m_pType = types[uiType];
+      dep.m_sResourceID = resourceIDs[uiDependencyID];
+    }
+
+    entry.m_uiNumDependencies = dependencies.GetCount() - entry.m_uiFirstDependency;
+  }
+
+  EZ_LOCK(s_ResourceMutex);
+
+  for (const LoadedEntry& entry : entries)
+  {
+    if (types[entry.m_uiType] == nullptr)
+      continue;
+
+    const ezHashedString& sResourceID = resourceIDs[entry.m_uiResourceID];
+
+    ezResourceManagerState::LookupKey key;
+    key.m_pType = types[entry.m_uiType];
+    key.m_uiIDHash = ezHashingUtils::StringHash(sResourceID.GetData());
+
+    ezResourceManagerState::ResourceDependencies& deps = s_State->s_ResourceDependencies[key];
+
+    if (deps.m_bRecordedThisSession)
+      continue;
+
+    deps.m_pType = key.m_pType;
+    deps.m_sResourceID = sResourceID;
+    deps.m_Dependencies.Clear();
+    deps.m_Dependencies.PushBackRange(dependencies.GetArrayPtr().GetSubArray(entry.m_uiFirstDependency, entry.m_uiNumDependencies));
+  }
+
+  return EZ_SUCCESS;
+}
+
+EZ_STATICLINK_FILE(Core, Core_ResourceManager_Implementation_ResourceDependencies);
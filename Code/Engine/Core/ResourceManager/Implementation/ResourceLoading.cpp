@@ -6,6 +6,10 @@
 
 ezTypelessResourceHandle ezResourceManager::LoadResourceByType(const ezRTTI* pResourceType, const char* szResourceID)
 {
+  ezTypelessResourceHandle hIndexed = TryGetIndexedResource(pResourceType, szResourceID);
+  if (hIndexed.IsValid())
+    return hIndexed;
+
   // the mutex here is necessary to prevent a race between resource unloading and storing the pointer in the handle
   EZ_LOCK(s_ResourceMutex);
   return ezTypelessResourceHandle(GetResource(pResourceType, szResourceID, true));
@@ -39,9 +43,14 @@ void ezResourceManager::InternalPreloadResource(ezResource* pResource, bool bHig
     if (bHighestPriority)
     {
       // if it is not in the queue anymore, it has already been started by some thread
-      if (RemoveFromLoadingQueue(pResource).Succeeded())
+      for (LoadingQueue& queue : s_State->s_LoadingQueues)
       {
-        AddToLoadingQueue(pResource, bHighestPriority);
+        if (queue.Contains(pResource))
+        {
+          pResource->SetPriority(ezResourcePriority::Critical);
+          queue.UpdatePriority(pResource, 0.0f, true);
+          break;
+        }
       }
     }
 
@@ -53,10 +62,17 @@ void ezResourceManager::InternalPreloadResource(ezResource* pResource, bool bHig
 
     if (bHighestPriority && ezTaskSystem::GetCurrentThreadWorkerType() == ezWorkerThreadType::FileAccess)
     {
-      ezResourceManager::s_State->s_bAllowLaunchDataLoadTask = true;
+      // the data load that is running on this thread is going to wait for this resource,
+      // so it must not prevent another load from starting, even if that exceeds the limit
+      StartDataLoadTask();
     }
 
     RunWorkerTask(pResource);
+
+    if (s_State->s_bPrefetchResourceDependencies && pResource->GetLoadingState() == ezResourceState::Unloaded)
+    {
+      PrefetchResourceDependencies(pResource);
+    }
   }
 }
 
@@ -102,94 +118,322 @@ void ezResourceManager::RunWorkerTask(ezResource* pResource)
 
   SetupWorkerTasks();
 
-  if (s_State->s_bAllowLaunchDataLoadTask && !s_State->s_LoadingQueue.IsEmpty())
+  const LoadingQueue& defaultQueue = s_State->s_LoadingQueues[LoadingQueueType::Default];
+  const LoadingQueue& fastQueue = s_State->s_LoadingQueues[LoadingQueueType::Fast];
+
+  const ezUInt32 uiMaxLoads = GetMaxConcurrentDataLoads();
+  const ezUInt32 uiMaxDefaultLoads = uiMaxLoads > 1 ? uiMaxLoads - 1 : 1;
+
+  // don't start more tasks than there are resources that they would be allowed to pick up
+  ezUInt32 uiNumLoadable = fastQueue.GetCount();
+  if (defaultQueue.m_uiNumLoadsRunning < uiMaxDefaultLoads)
+    uiNumLoadable += ezMath::Min(defaultQueue.GetCount(), uiMaxDefaultLoads - defaultQueue.m_uiNumLoadsRunning);
+
+  // tasks that have been started, but have not yet taken a resource from a queue
+  ezUInt32 uiNumPicking = s_State->s_uiNumDataLoadsRunning - defaultQueue.m_uiNumLoadsRunning - fastQueue.m_uiNumLoadsRunning;
+
+  while (s_State->s_uiNumDataLoadsRunning < uiMaxLoads && uiNumPicking < uiNumLoadable)
   {
-    s_State->s_bAllowLaunchDataLoadTask = false;
+    // An UpdateContent() call that waits for another resource would wait forever, if nothing else could be loaded until it is done.
+    // Therefore one load is always allowed, no matter how much data is already waiting.
+    if (s_State->s_uiNumDataLoadsRunning > 0 && s_State->s_uiMaxDataLoadBytesInFlight > 0 &&
+        s_State->s_uiDataLoadBytesInFlight >= s_State->s_uiMaxDataLoadBytesInFlight)
+      break;
+
+    StartDataLoadTask();
+    ++uiNumPicking;
+  }
+}
 
-    for (ezUInt32 i = 0; i < s_State->s_WorkerTasksDataLoad.GetCount(); ++i)
-    {
-      if (s_State->s_WorkerTasksDataLoad[i].m_pTask->IsTaskFinished())
-      {
-        s_State->s_WorkerTasksDataLoad[i].m_GroupId =
-          ezTaskSystem::StartSingleTask(s_State->s_WorkerTasksDataLoad[i].m_pTask, ezTaskPriority::FileAccess);
-        return;
-      }
-    }
+void ezResourceManager::StartDataLoadTask()
+{
+  EZ_ASSERT_DEV(s_ResourceMutex.IsLocked(), "");
+
+  ++s_State->s_uiNumDataLoadsRunning;
 
-    // could not find any unused task -> need to create a new one
+  for (ezUInt32 i = 0; i < s_State->s_WorkerTasksDataLoad.GetCount(); ++i)
+  {
+    if (s_State->s_WorkerTasksDataLoad[i].m_pTask->IsTaskFinished())
     {
-      ezStringBuilder s;
-      s.Format("Resource Data Loader {0}", s_State->s_WorkerTasksDataLoad.GetCount());
-      auto& data = s_State->s_WorkerTasksDataLoad.ExpandAndGetRef();
-      data.m_pTask = EZ_DEFAULT_NEW(ezResourceManagerWorkerDataLoad);
-      data.m_pTask->ConfigureTask(s, ezTaskNesting::Maybe);
-      data.m_GroupId = ezTaskSystem::StartSingleTask(data.m_pTask, ezTaskPriority::FileAccess);
+      s_State->s_WorkerTasksDataLoad[i].m_GroupId = ezTaskSystem::StartSingleTask(s_State->s_WorkerTasksDataLoad[i].m_pTask, ezTaskPriority::FileAccess);
+      return;
     }
   }
+
+  // could not find any unused task -> need to create a new one
+  {
+    ezStringBuilder s;
+    s.Format("Resource Data Loader {0}", s_State->s_WorkerTasksDataLoad.GetCount());
+    auto& data = s_State->s_WorkerTasksDataLoad.ExpandAndGetRef();
+    data.m_pTask = EZ_DEFAULT_NEW(ezResourceManagerWorkerDataLoad);
+    data.m_pTask->ConfigureTask(s, ezTaskNesting::Maybe);
+    data.m_GroupId = ezTaskSystem::StartSingleTask(data.m_pTask, ezTaskPriority::FileAccess);
+  }
+}
+
+ezUInt32 ezResourceManager::GetMaxConcurrentDataLoads()
+{
+  const ezUInt32 uiNumThreads = ezTaskSystem::GetWorkerThreadCount(ezWorkerThreadType::FileAccess);
+
+  if (s_State->s_uiMaxConcurrentDataLoads == 0)
+    return uiNumThreads;
+
+  return ezMath::Min(s_State->s_uiMaxConcurrentDataLoads, uiNumThreads);
 }
 
-void ezResourceManager::ReverseBubbleSortStep(ezDeque<LoadingInfo>& data)
+void ezResourceManager::SetDataLoadLimits(ezUInt32 uiMaxConcurrentLoads, ezUInt64 uiMaxBytesInFlight)
 {
-  // Yep, it's really bubble sort!
-  // This will move the entry with the smallest value to the front and move all other values closer to their correct position,
-  // which is exactly what we need for the priority queue.
-  // We do this once a frame, which gives us nice iterative sorting, with relatively deterministic performance characteristics.
+  EZ_LOCK(s_ResourceMutex);
+
+  s_State->s_uiMaxConcurrentDataLoads = uiMaxConcurrentLoads;
+  s_State->s_uiMaxDataLoadBytesInFlight = uiMaxBytesInFlight;
+
+  RunWorkerTask(nullptr);
+}
 
+ezResourceManager::LoadingQueue* ezResourceManager::GetNextLoadingQueue()
+{
   EZ_ASSERT_DEBUG(s_ResourceMutex.IsLocked(), "Calling code must acquire s_ResourceMutex");
 
-  const ezUInt32 uiCount = data.GetCount();
+  LoadingQueue& defaultQueue = s_State->s_LoadingQueues[LoadingQueueType::Default];
+  LoadingQueue& fastQueue = s_State->s_LoadingQueues[LoadingQueueType::Fast];
+
+  UpdateLoadingDeadlines(defaultQueue);
+  UpdateLoadingDeadlines(fastQueue);
 
-  for (ezUInt32 i = uiCount; i > 1; --i)
+  bool bUseDefaultQueue = !defaultQueue.IsEmpty();
+
+  // with more than one concurrent load, one is kept free for the fast queue, unless someone is waiting for a resource
+  const ezUInt32 uiMaxLoads = GetMaxConcurrentDataLoads();
+  if (bUseDefaultQueue && uiMaxLoads > 1 && defaultQueue.m_uiNumLoadsRunning + 1 >= uiMaxLoads)
   {
-    const ezUInt32 idx2 = i - 1;
-    const ezUInt32 idx1 = i - 2;
+    bUseDefaultQueue = defaultQueue.PeekFront().m_fPriority <= 0.0f;
+  }
 
-    if (data[idx1].m_fPriority > data[idx1].m_fPriority)
-    {
-      ezMath::Swap(data[idx1], data[idx2]);
-    }
+  if (!fastQueue.IsEmpty())
+  {
+    if (!bUseDefaultQueue || fastQueue.PeekFront().m_fPriority <= defaultQueue.PeekFront().m_fPriority)
+      return &fastQueue;
   }
+
+  return bUseDefaultQueue ? &defaultQueue : nullptr;
 }
 
-void ezResourceManager::UpdateLoadingDeadlines()
+void ezResourceManager::UpdateLoadingDeadlines(LoadingQueue& queue)
 {
-  if (s_State->s_LoadingQueue.IsEmpty())
+  if (queue.IsEmpty())
     return;
 
   EZ_ASSERT_DEBUG(s_ResourceMutex.IsLocked(), "Calling code must acquire s_ResourceMutex");
 
   EZ_PROFILE_SCOPE("UpdateLoadingDeadlines");
 
-  const ezUInt32 uiCount = s_State->s_LoadingQueue.GetCount();
-  s_State->s_uiLastResourcePriorityUpdateIdx = ezMath::Min(s_State->s_uiLastResourcePriorityUpdateIdx, uiCount);
+  // Re-evaluating all priorities every time would be too expensive with many queued resources,
+  // so only a few are updated each time, round-robin through the heap.
+  // Updating an entry moves other entries around, therefore the resources are gathered first.
+  ezHybridArray<ezResource*, 50> resourcesToUpdate;
+
+  const ezUInt32 uiCount = queue.GetCount();
+  const ezUInt32 uiUpdateCount = ezMath::Min(50u, uiCount);
+
+  for (ezUInt32 i = 0; i < uiUpdateCount; ++i)
+  {
+    if (queue.m_uiLastPriorityUpdateIdx >= uiCount)
+      queue.m_uiLastPriorityUpdateIdx = 0;
+
+    resourcesToUpdate.PushBack(queue.m_Entries[queue.m_uiLastPriorityUpdateIdx].m_pResource);
+    ++queue.m_uiLastPriorityUpdateIdx;
+  }
 
-  ezUInt32 uiUpdateCount = ezMath::Min(50u, uiCount - s_State->s_uiLastResourcePriorityUpdateIdx);
+  const ezTime tNow = ezTime::Now();
 
-  if (uiUpdateCount == 0)
+  for (ezResource* pResource : resourcesToUpdate)
   {
-    s_State->s_uiLastResourcePriorityUpdateIdx = 0;
-    uiUpdateCount = ezMath::Min(50u, uiCount - s_State->s_uiLastResourcePriorityUpdateIdx);
+    queue.UpdatePriority(pResource, pResource->GetLoadingPriority(tNow));
   }
+}
 
-  if (uiUpdateCount > 0)
+void ezResourceManager::UpdateLoadingQueuePriority(ezResource* pResource)
+{
+  EZ_LOCK(s_ResourceMutex);
+
+  for (LoadingQueue& queue : s_State->s_LoadingQueues)
   {
+    if (queue.Contains(pResource))
     {
-      EZ_PROFILE_SCOPE("EvalLoadingDeadlines");
+      queue.UpdatePriority(pResource, pResource->GetLoadingPriority(ezTime::Now()));
+      return;
+    }
+  }
+}
+
+void ezResourceManager::LoadingQueue::Push(ezResource* pResource, float fPriority, bool bFront)
+{
+  LoadingInfo li;
+  li.m_pResource = pResource;
+  li.m_fPriority = fPriority;
+  li.m_iSequence = bFront ? m_iNextFrontSequence-- : m_iNextBackSequence++;
+  li.m_EnqueueTime = ezTime::Now();
+
+  m_Entries.PushBack(li);
+  pResource->m_uiLoadingQueueIndex = m_Entries.GetCount() - 1;
+
+  MoveUp(m_Entries.GetCount() - 1);
+}
+
+ezResourceManager::LoadingInfo ezResourceManager::LoadingQueue::PopFront()
+{
+  const LoadingInfo li = m_Entries[0];
+  li.m_pResource->m_uiLoadingQueueIndex = ezInvalidIndex;
+
+  const LoadingInfo last = m_Entries.PeekBack();
+  m_Entries.PopBack();
+
+  if (!m_Entries.IsEmpty())
+  {
+    Store(0, last);
+    MoveDown(0);
+  }
+
+  return li;
+}
+
+bool ezResourceManager::LoadingQueue::Remove(ezResource* pResource)
+{
+  if (!Contains(pResource))
+    return false;
+
+  const ezUInt32 uiIndex = pResource->m_uiLoadingQueueIndex;
+  pResource->m_uiLoadingQueueIndex = ezInvalidIndex;
+
+  const LoadingInfo last = m_Entries.PeekBack();
+  m_Entries.PopBack();
 
-      const ezTime tNow = ezTime::Now();
+  if (uiIndex < m_Entries.GetCount())
+  {
+    // the former last entry may need to move in either direction
+    Store(uiIndex, last);
+    MoveUp(uiIndex);
+    MoveDown(last.m_pResource->m_uiLoadingQueueIndex);
+  }
+
+  return true;
+}
+
+bool ezResourceManager::LoadingQueue::Contains(const ezResource* pResource) const
+{
+  const ezUInt32 uiIndex = pResource->m_uiLoadingQueueIndex;
+  return uiIndex < m_Entries.GetCount() && m_Entries[uiIndex].m_pResource == pResource;
+}
+
+void ezResourceManager::LoadingQueue::UpdatePriority(ezResource* pResource, float fPriority, bool bFront)
+{
+  EZ_ASSERT_DEBUG(Contains(pResource), "Resource is not in this loading queue");
+
+  LoadingInfo& li = m_Entries[pResource->m_uiLoadingQueueIndex];
+
+  if (bFront)
+  {
+    li.m_iSequence = m_iNextFrontSequence--;
+  }
+  else if (li.m_fPriority == fPriority)
+  {
+    return;
+  }
+
+  li.m_fPriority = fPriority;
+
+  MoveUp(pResource->m_uiLoadingQueueIndex);
+  MoveDown(pResource->m_uiLoadingQueueIndex);
+}
+
+void ezResourceManager::LoadingQueue::Clear()
+{
+  for (const LoadingInfo& li : m_Entries)
+  {
+    li.m_pResource->m_uiLoadingQueueIndex = ezInvalidIndex;
+  }
+
+  m_Entries.Clear();
+  m_uiLastPriorityUpdateIdx = 0;
+}
+
+void ezResourceManager::LoadingQueue::MoveUp(ezUInt32 uiIndex)
+{
+  const LoadingInfo li = m_Entries[uiIndex];
+
+  while (uiIndex > 0)
+  {
+    const ezUInt32 uiParent = (uiIndex - 1) / 2;
+
+    if (!(li < m_Entries[uiParent]))
+      break;
+
+    Store(uiIndex, m_Entries[uiParent]);
+    uiIndex = uiParent;
+  }
+
+  Store(uiIndex, li);
+}
+
+void ezResourceManager::LoadingQueue::MoveDown(ezUInt32 uiIndex)
+{
+  const ezUInt32 uiCount = m_Entries.GetCount();
+  const LoadingInfo li = m_Entries[uiIndex];
 
-      for (ezUInt32 i = 0; i < uiUpdateCount; ++i)
+  while (true)
+  {
+    ezUInt32 uiChild = uiIndex * 2 + 1;
+
+    if (uiChild >= uiCount)
+      break;
+
+    if (uiChild + 1 < uiCount && m_Entries[uiChild + 1] < m_Entries[uiChild])
+      ++uiChild;
+
+    if (!(m_Entries[uiChild] < li))
+      break;
+
+    Store(uiIndex, m_Entries[uiChild]);
+    uiIndex = uiChild;
+  }
+
+  Store(uiIndex, li);
+}
+
+void ezResourceManager::LoadingQueue::Store(ezUInt32 uiIndex, const LoadingInfo& li)
+{
+  m_Entries[uiIndex] = li;
+  li.m_pResource->m_uiLoadingQueueIndex = uiIndex;
+}
+
+ezResourceManager::LoadingQueueStats ezResourceManager::GetLoadingQueueStats(ezResourcePriority priority)
+{
+  EZ_LOCK(s_ResourceMutex);
+
+  LoadingQueueStats stats = s_State->s_LoadingQueueStats[(int)priority];
+
+  for (const LoadingQueue& queue : s_State->s_LoadingQueues)
+  {
+    for (const LoadingInfo& li : queue.m_Entries)
+    {
+      if (li.m_pResource->GetPriority() == priority)
       {
-        auto& element = s_State->s_LoadingQueue[s_State->s_uiLastResourcePriorityUpdateIdx];
-        element.m_fPriority = element.m_pResource->GetLoadingPriority(tNow);
-        ++s_State->s_uiLastResourcePriorityUpdateIdx;
+        ++stats.m_uiNumQueued;
       }
     }
+  }
 
-    {
-      EZ_PROFILE_SCOPE("SortLoadingDeadlines");
-      ReverseBubbleSortStep(s_State->s_LoadingQueue);
-    }
+  return stats;
+}
+
+void ezResourceManager::ResetLoadingQueueStats()
+{
+  EZ_LOCK(s_ResourceMutex);
+
+  for (LoadingQueueStats& stats : s_State->s_LoadingQueueStats)
+  {
+    stats = LoadingQueueStats();
   }
 }
 
@@ -221,13 +465,13 @@ ezResult ezResourceManager::RemoveFromLoadingQueue(ezResource* pResource)
   if (!IsQueuedForLoading(pResource))
     return EZ_SUCCESS;
 
-  LoadingInfo li;
-  li.m_pResource = pResource;
-
-  if (s_State->s_LoadingQueue.RemoveAndSwap(li))
+  for (LoadingQueue& queue : s_State->s_LoadingQueues)
   {
-    pResource->m_Flags.Remove(ezResourceFlags::IsQueuedForLoading);
-    return EZ_SUCCESS;
+    if (queue.Remove(pResource))
+    {
+      pResource->m_Flags.Remove(ezResourceFlags::IsQueuedForLoading);
+      return EZ_SUCCESS;
+    }
   }
 
   return EZ_FAILURE;
@@ -240,19 +484,17 @@ void ezResourceManager::AddToLoadingQueue(ezResource* pResource, bool bHighestPr
 
   pResource->m_Flags.Add(ezResourceFlags::IsQueuedForLoading);
 
-  LoadingInfo li;
-  li.m_pResource = pResource;
+  const bool bFastDataLoad = GetResourceTypeInfo(pResource->GetDynamicRTTI()).m_bFastDataLoad;
+  LoadingQueue& queue = s_State->s_LoadingQueues[bFastDataLoad ? LoadingQueueType::Fast : LoadingQueueType::Default];
 
   if (bHighestPriority)
   {
     pResource->SetPriority(ezResourcePriority::Critical);
-    li.m_fPriority = 0.0f;
-    s_State->s_LoadingQueue.PushFront(li);
+    queue.Push(pResource, 0.0f, true);
   }
   else
   {
-    li.m_fPriority = pResource->GetLoadingPriority(s_State->s_LastFrameUpdate);
-    s_State->s_LoadingQueue.PushBack(li);
+    queue.Push(pResource, pResource->GetLoadingPriority(s_State->s_LastFrameUpdate), false);
   }
 }
 
@@ -285,10 +527,8 @@ bool ezResourceManager::ReloadResource(ezResource* pResource, bool bForce)
   {
     bAllowPreloading = false;
 
-    LoadingInfo li;
-    li.m_pResource = pResource;
-
-    if (s_State->s_LoadingQueue.IndexOf(li) == ezInvalidIndex)
+    if (!s_State->s_LoadingQueues[LoadingQueueType::Default].Contains(pResource) &&
+        !s_State->s_LoadingQueues[LoadingQueueType::Fast].Contains(pResource))
     {
       // the resource is marked as 'loading' but it is not in the queue anymore
       // that means some task is already working on loading it
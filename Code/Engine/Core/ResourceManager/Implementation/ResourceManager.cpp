@@ -396,6 +396,12 @@ ezResult ezResourceManager::DeallocateResource(ezResource* pResource)
 {
   EZ_ASSERT_DEBUG(pResource->m_iLockCount == 0, "Resource '{0}' has a refcount of zero, but is still in an acquired state.", pResource->GetResourceID());
 
+  if (RemoveFromLookupIndex(pResource).Failed())
+  {
+    // someone just got a new handle to it
+    return EZ_FAILURE;
+  }
+
   if (RemoveFromLoadingQueue(pResource).Failed())
   {
     // cannot deallocate resources that are currently queued for loading,
@@ -541,7 +547,6 @@ void ezResourceManager::OnCoreStartup()
   s_State = EZ_DEFAULT_NEW(ezResourceManagerState);
 
   EZ_LOCK(s_ResourceMutex);
-  s_State->s_bAllowLaunchDataLoadTask = true;
   s_State->s_bShutdown = false;
 
   ezPlugin::s_PluginEvents.AddEventHandler(PluginEventHandler);
@@ -558,8 +563,7 @@ void ezResourceManager::EngineAboutToShutdown()
       return;
     }
 
-    s_State->s_bAllowLaunchDataLoadTask = false; // prevent a new one from starting
-    s_State->s_bShutdown = true;
+    s_State->s_bShutdown = true; // prevent a new one from starting
   }
 
   for (ezUInt32 i = 0; i < s_State->s_WorkerTasksDataLoad.GetCount(); ++i)
@@ -575,12 +579,21 @@ void ezResourceManager::EngineAboutToShutdown()
   {
     EZ_LOCK(s_ResourceMutex);
 
-    for (auto entry : s_State->s_LoadingQueue)
+    for (LoadingQueue& queue : s_State->s_LoadingQueues)
     {
-      entry.m_pResource->m_Flags.Remove(ezResourceFlags::IsQueuedForLoading);
+      for (auto entry : queue.m_Entries)
+      {
+        entry.m_pResource->m_Flags.Remove(ezResourceFlags::IsQueuedForLoading);
+      }
+
+      queue.Clear();
     }
 
-    s_State->s_LoadingQueue.Clear();
+    // the canceled tasks will never report back
+    s_State->s_uiNumDataLoadsRunning = 0;
+    s_State->s_LoadingQueues[LoadingQueueType::Default].m_uiNumLoadsRunning = 0;
+    s_State->s_LoadingQueues[LoadingQueueType::Fast].m_uiNumLoadsRunning = 0;
+    s_State->s_uiDataLoadBytesInFlight = 0;
 
     // Since we just canceled all loading tasks above and cleared the loading queue,
     // some resources may still be flagged as 'loading', but can never get loaded.
@@ -605,9 +618,12 @@ bool ezResourceManager::IsAnyLoadingInProgress()
 {
   EZ_LOCK(s_ResourceMutex);
 
-  if (s_State->s_LoadingQueue.GetCount() > 0)
+  for (const LoadingQueue& queue : s_State->s_LoadingQueues)
   {
-    return true;
+    if (!queue.IsEmpty())
+    {
+      return true;
+    }
   }
 
   for (ezUInt32 i = 0; i < s_State->s_WorkerTasksDataLoad.GetCount(); ++i)
@@ -689,6 +705,9 @@ ezResource* ezResourceManager::GetResource(const ezRTTI* pRtti, const char* szRe
 
   EZ_ASSERT_DEV(s_ResourceMutex.IsLocked(), "Calling code must lock the mutex until the resource pointer is stored in a handle");
 
+  // types that may be overridden are never put into the lookup index, the decision depends on the resource ID
+  bool bAddToLookupIndex = !s_State->s_DerivedTypeInfos.Contains(pRtti);
+
   // redirect requested type to override type, if available
   pRtti = FindResourceTypeOverride(pRtti, szResourceID);
 
@@ -703,12 +722,21 @@ ezResource* ezResourceManager::GetResource(const ezRTTI* pRtti, const char* szRe
   {
     sHashedResourceID = *redirection;
     szResourceID = redirection->GetData();
+    bAddToLookupIndex = false;
   }
 
   LoadedResources& lr = s_State->s_LoadedResources[pRtti];
 
   if (lr.m_Resources.TryGetValue(sHashedResourceID, pResource))
+  {
+    if (bAddToLookupIndex)
+      AddToLookupIndex(pResource);
+
+    if (bIsReloadable)
+      RecordResourceDependency(pResource);
+
     return pResource;
+  }
 
   ezResource* pNewResource = pRtti->GetAllocator()->Allocate<ezResource>();
   pNewResource->m_Priority = s_State->s_ResourceTypePriorities.GetValueOrDefault(pRtti, ezResourcePriority::Medium);
@@ -717,11 +745,91 @@ ezResource* ezResourceManager::GetResource(const ezRTTI* pRtti, const char* szRe
 
   lr.m_Resources.Insert(sHashedResourceID, pNewResource);
 
+  if (bAddToLookupIndex)
+    AddToLookupIndex(pNewResource);
+
+  if (bIsReloadable)
+    RecordResourceDependency(pNewResource);
+
   return pNewResource;
 }
 
+ezTypelessResourceHandle ezResourceManager::TryGetIndexedResource(const ezRTTI* pRtti, const char* szResourceID)
+{
+  if (ezStringUtils::IsNullOrEmpty(szResourceID))
+    return ezTypelessResourceHandle();
+
+  // GetResource() has to see these lookups to record them as dependencies
+  if (s_State->s_bRecordResourceDependencies && ezResource::GetCurrentlyUpdatingContent() != nullptr)
+    return ezTypelessResourceHandle();
+
+  ezResourceManagerState::LookupKey key;
+  key.m_pType = pRtti;
+  key.m_uiIDHash = ezHashingUtils::StringHash(szResourceID);
+
+  auto& shard = s_State->GetLookupShard(key);
+  EZ_LOCK(shard.m_Mutex);
+
+  ezResource* pResource = nullptr;
+  if (!shard.m_Resources.TryGetValue(key, pResource))
+    return ezTypelessResourceHandle();
+
+  // the refcount has to be increased while the shard is locked, RemoveFromLookupIndex() relies on that
+  return ezTypelessResourceHandle(pResource);
+}
+
+void ezResourceManager::AddToLookupIndex(ezResource* pResource)
+{
+  EZ_ASSERT_DEBUG(s_ResourceMutex.IsLocked(), "Calling code must acquire s_ResourceMutex");
+
+  ezResourceManagerState::LookupKey key;
+  key.m_pType = pResource->GetDynamicRTTI();
+  key.m_uiIDHash = pResource->GetResourceIDHash();
+
+  auto& shard = s_State->GetLookupShard(key);
+  EZ_LOCK(shard.m_Mutex);
+
+  shard.m_Resources.Insert(key, pResource);
+}
+
+ezResult ezResourceManager::RemoveFromLookupIndex(ezResource* pResource)
+{
+  EZ_ASSERT_DEBUG(s_ResourceMutex.IsLocked(), "Calling code must acquire s_ResourceMutex");
+
+  ezResourceManagerState::LookupKey key;
+  key.m_pType = pResource->GetDynamicRTTI();
+  key.m_uiIDHash = pResource->GetResourceIDHash();
+
+  auto& shard = s_State->GetLookupShard(key);
+  EZ_LOCK(shard.m_Mutex);
+
+  // another thread may have created a handle through TryGetIndexedResource() after the caller checked the refcount
+  if (pResource->GetReferenceCount() > 0)
+    return EZ_FAILURE;
+
+  ezResource* pIndexed = nullptr;
+  if (shard.m_Resources.TryGetValue(key, pIndexed) && pIndexed == pResource)
+  {
+    shard.m_Resources.Remove(key);
+  }
+
+  return EZ_SUCCESS;
+}
+
+void ezResourceManager::ClearLookupIndex()
+{
+  for (auto& shard : s_State->s_LookupShards)
+  {
+    EZ_LOCK(shard.m_Mutex);
+    shard.m_Resources.Clear();
+  }
+}
+
 void ezResourceManager::RegisterResourceOverrideType(const ezRTTI* pDerivedTypeToUse, ezDelegate<bool(const ezStringBuilder&)> OverrideDecider)
 {
+  // the base types may already be in the lookup index, but are now subject to the override
+  ClearLookupIndex();
+
   const ezRTTI* pParentType = pDerivedTypeToUse->GetParentType();
   while (pParentType != nullptr && pParentType != ezGetStaticRTTI<ezResource>())
   {
@@ -791,6 +899,10 @@ ezString ezResourceManager::GenerateUniqueResourceID(const char* prefix)
 
 ezTypelessResourceHandle ezResourceManager::GetExistingResourceByType(const ezRTTI* pResourceType, const char* szResourceID)
 {
+  ezTypelessResourceHandle hIndexed = TryGetIndexedResource(pResourceType, szResourceID);
+  if (hIndexed.IsValid())
+    return hIndexed;
+
   ezResource* pResource = nullptr;
 
   const ezTempHashedString sResourceHash(szResourceID);
@@ -829,6 +941,9 @@ void ezResourceManager::RegisterNamedResource(const char* szLookupName, const ch
   redirection.Assign(szRedirectionResource);
 
   s_State->s_NamedResources[lookup] = redirection;
+
+  // a resource that was previously looked up under this name must not be returned through the lookup index anymore
+  ClearLookupIndex();
 }
 
 void ezResourceManager::UnregisterNamedResource(const char* szLookupName)
@@ -50,19 +50,24 @@ private:
   bool s_bBroadcastExistsEvent = false;
   ezUInt32 s_uiForceNoFallbackAcquisition = 0;
 
-  // resources in this queue are waiting for a task to load them
-  ezDeque<ezResourceManager::LoadingInfo> s_LoadingQueue;
+  // resources in these queues are waiting for a task to load them
+  ezResourceManager::LoadingQueue s_LoadingQueues[ezResourceManager::LoadingQueueType::ENUM_COUNT];
 
   ezHashTable<const ezRTTI*, ezResourceManager::LoadedResources> s_LoadedResources;
 
-  bool s_bAllowLaunchDataLoadTask = true;
   bool s_bShutdown = false;
 
+  ezUInt32 s_uiMaxConcurrentDataLoads = 0; // zero means one per file access thread
+  ezUInt64 s_uiMaxDataLoadBytesInFlight = 0;
+  ezUInt32 s_uiNumDataLoadsRunning = 0;
+  ezUInt64 s_uiDataLoadBytesInFlight = 0; // loaded, but not yet processed by UpdateContent
+
+  ezResourceManager::LoadingQueueStats s_LoadingQueueStats[(int)ezResourcePriority::VeryLow + 1];
+
   ezHybridArray<TaskDataUpdateContent, 24> s_WorkerTasksUpdateContent;
   ezHybridArray<TaskDataDataLoad, 8> s_WorkerTasksDataLoad;
 
   ezTime s_LastFrameUpdate;
-  ezUInt32 s_uiLastResourcePriorityUpdateIdx = 0;
 
   ezDynamicArray<ezResource*> s_LoadedResourceOfTypeTempContainer;
   ezHashTable<ezTempHashedString, const ezRTTI*> s_ResourcesToUnloadOnMainThread;
@@ -83,10 +88,72 @@ private:
   ezMap<const ezRTTI*, ezHybridArray<ezResourceManager::DerivedTypeInfo, 4>> s_DerivedTypeInfos;
 
 
+  // Lookup index
+
+  struct LookupKey
+  {
+    const ezRTTI* m_pType = nullptr;
+    ezUInt64 m_uiIDHash = 0;
+  };
+
+  struct LookupKeyHashHelper
+  {
+    EZ_ALWAYS_INLINE static ezUInt32 Hash(const LookupKey& key)
+    {
+      return ezHashHelper<const ezRTTI*>::Hash(key.m_pType) ^ ezHashHelper<ezUInt64>::Hash(key.m_uiIDHash);
+    }
+
+    EZ_ALWAYS_INLINE static bool Equal(const LookupKey& a, const LookupKey& b)
+    {
+      return a.m_pType == b.m_pType && a.m_uiIDHash == b.m_uiIDHash;
+    }
+  };
+
+  /// \brief One stripe of the lookup index, only ever locked on its own or while s_ResourceMutex is already held.
+  struct LookupShard
+  {
+    ezMutex m_Mutex;
+    ezHashTable<LookupKey, ezResource*, LookupKeyHashHelper> m_Resources;
+  };
+
+  static constexpr ezUInt32 s_uiNumLookupShards = 32;
+
+  EZ_ALWAYS_INLINE LookupShard& GetLookupShard(const LookupKey& key)
+  {
+    // use the upper bits, the lower ones are used for the buckets of the hash table inside the shard
+    return s_LookupShards[(LookupKeyHashHelper::Hash(key) >> 16) % s_uiNumLookupShards];
+  }
+
+  LookupShard s_LookupShards[s_uiNumLookupShards];
+
+
   // Named resources
 
   ezHashTable<ezTempHashedString, ezHashedString> s_NamedResources;
 
+  // Resource dependencies
+
+  struct ResourceDependency
+  {
+    const ezRTTI* m_pType = nullptr;
+    ezHashedString m_sResourceID;
+  };
+
+  struct ResourceDependencies
+  {
+    const ezRTTI* m_pType = nullptr;
+    ezHashedString m_sResourceID;
+    bool m_bRecordedThisSession = false; ///< Otherwise the dependencies were loaded from a previous session and get replaced once recorded again
+    ezHybridArray<ResourceDependency, 4> m_Dependencies;
+  };
+
+  bool s_bRecordResourceDependencies = false;
+  bool s_bPrefetchResourceDependencies = false;
+  bool s_bPrefetchingResourceDependencies = false;
+
+  // key is the type and resource ID hash of the resource that loaded the dependencies
+  ezHashTable<LookupKey, ResourceDependencies, LookupKeyHashHelper> s_ResourceDependencies;
+
   // Asset system interaction
 
   ezMap<ezString, const ezRTTI*> s_AssetToResourceType;
@@ -11,6 +11,13 @@ ResourceType* ezResourceManager::GetResource(const char* szResourceID, bool bIsR
 template <typename ResourceType>
 ezTypedResourceHandle<ResourceType> ezResourceManager::LoadResource(const char* szResourceID)
 {
+  // fast path for resources that already exist, does not need to lock s_ResourceMutex
+  {
+    ezTypelessResourceHandle hIndexed = TryGetIndexedResource(ezGetStaticRTTI<ResourceType>(), szResourceID);
+    if (hIndexed.IsValid())
+      return ezTypedResourceHandle<ResourceType>(static_cast<ResourceType*>(hIndexed.m_pResource));
+  }
+
   // the mutex here is necessary to prevent a race between resource unloading and storing the pointer in the handle
   EZ_LOCK(s_ResourceMutex);
   return ezTypedResourceHandle<ResourceType>(GetResource<ResourceType>(szResourceID, true));
@@ -19,12 +26,7 @@ ezTypedResourceHandle<ResourceType> ezResourceManager::LoadResource(const char*
 template <typename ResourceType>
 ezTypedResourceHandle<ResourceType> ezResourceManager::LoadResource(const char* szResourceID, ezTypedResourceHandle<ResourceType> hLoadingFallback)
 {
-  ezTypedResourceHandle<ResourceType> hResource;
-  {
-    // the mutex here is necessary to prevent a race between resource unloading and storing the pointer in the handle
-    EZ_LOCK(s_ResourceMutex);
-    hResource = ezTypedResourceHandle<ResourceType>(GetResource<ResourceType>(szResourceID, true));
-  }
+  ezTypedResourceHandle<ResourceType> hResource = LoadResource<ResourceType>(szResourceID);
 
   ResourceType* pResource =
     ezResourceManager::BeginAcquireResource(hResource, ezResourceAcquireMode::PointerOnly, ezTypedResourceHandle<ResourceType>());
@@ -42,6 +44,12 @@ ezTypedResourceHandle<ResourceType> ezResourceManager::LoadResource(const char*
 template <typename ResourceType>
 ezTypedResourceHandle<ResourceType> ezResourceManager::GetExistingResource(const char* szResourceID)
 {
+  {
+    ezTypelessResourceHandle hIndexed = TryGetIndexedResource(ezGetStaticRTTI<ResourceType>(), szResourceID);
+    if (hIndexed.IsValid())
+      return ezTypedResourceHandle<ResourceType>(static_cast<ResourceType*>(hIndexed.m_pResource));
+  }
+
   ezResource* pResource = nullptr;
 
   const ezTempHashedString sResourceHash(szResourceID);
@@ -289,3 +297,10 @@ void ezResourceManager::SetIncrementalUnloadForResourceType(bool bActive)
 {
   GetResourceTypeInfo(ezGetStaticRTTI<ResourceType>()).m_bIncrementalUnload = bActive;
 }
+
+template <typename ResourceType>
+void ezResourceManager::SetFastDataLoadForResourceType(bool bFast)
+{
+  EZ_LOCK(s_ResourceMutex);
+  GetResourceTypeInfo(ezGetStaticRTTI<ResourceType>()).m_bFastDataLoad = bFast;
+}
@@ -4,14 +4,48 @@
 #include <Core/ResourceManager/ResourceTypeLoader.h>
 #include <Foundation/Containers/Blob.h>
 #include <Foundation/IO/FileSystem/FileReader.h>
+#include <Foundation/IO/MemoryMappedFile.h>
 #include <Foundation/IO/MemoryStream.h>
 #include <Foundation/IO/OSFile.h>
 #include <Foundation/Profiling/Profiling.h>
 
+namespace
+{
+  /// \brief Reads the file path that was written into a small header first and then the content of a memory mapped file.
+  class MappedFileStreamReader : public ezStreamReader
+  {
+  public:
+    virtual ezUInt64 ReadBytes(void* pReadBuffer, ezUInt64 uiBytesToRead) override
+    {
+      const ezUInt64 uiBytesRead = m_Header.ReadBytes(pReadBuffer, uiBytesToRead);
+
+      if (uiBytesRead == uiBytesToRead)
+        return uiBytesRead;
+
+      void* pRemainingBuffer = pReadBuffer != nullptr ? ezMemoryUtils::AddByteOffset(pReadBuffer, static_cast<ptrdiff_t>(uiBytesRead)) : nullptr;
+      return uiBytesRead + m_Content.ReadBytes(pRemainingBuffer, uiBytesToRead - uiBytesRead);
+    }
+
+    virtual ezUInt64 SkipBytes(ezUInt64 uiBytesToSkip) override
+    {
+      const ezUInt64 uiBytesSkipped = m_Header.SkipBytes(uiBytesToSkip);
+      return uiBytesSkipped + m_Content.SkipBytes(uiBytesToSkip - uiBytesSkipped);
+    }
+
+    ezRawMemoryStreamReader m_Header;
+    ezRawMemoryStreamReader m_Content;
+  };
+} // namespace
+
 struct FileResourceLoadData
 {
   ezBlob m_Storage;
   ezRawMemoryStreamReader m_Reader;
+
+#if EZ_ENABLED(EZ_SUPPORTS_MEMORY_MAPPED_FILE)
+  ezMemoryMappedFile m_MappedFile;
+  MappedFileStreamReader m_MappedReader;
+#endif
 };
 
 ezResourceLoadData ezResourceLoaderFromFile::OpenDataStream(const ezResource* pResource)
@@ -36,8 +70,44 @@ ezResourceLoadData ezResourceLoaderFromFile::OpenDataStream(const ezResource* pR
 #endif
 
   FileResourceLoadData* pData = EZ_DEFAULT_NEW(FileResourceLoadData);
+  res.m_pCustomLoaderData = pData;
+
+  ezUInt64 uiFileSize = File.GetFileSize();
 
-  const ezUInt64 uiFileSize = File.GetFileSize();
+#if EZ_ENABLED(EZ_SUPPORTS_MEMORY_MAPPED_FILE)
+  // files inside of archives have no path on disk and are read as usual
+  if (m_bUseMemoryMappedFiles && uiFileSize > 0 && ezOSFile::ExistsFile(File.GetFilePathAbsolute()))
+  {
+    const ezString128 sAbsolutePath = File.GetFilePathAbsolute();
+    File.Close();
+
+    if (pData->m_MappedFile.Open(sAbsolutePath, ezMemoryMappedFile::Mode::ReadOnly).Succeeded())
+    {
+      const ezUInt64 uiHeaderCapacity = sAbsolutePath.GetElementCount() + 8; // +8 for the string overhead
+      pData->m_Storage.SetCountUninitialized(uiHeaderCapacity);
+
+      ezUInt8* pHeaderPtr = pData->m_Storage.GetBlobPtr<ezUInt8>().GetPtr();
+
+      ezRawMemoryStreamWriter w(pHeaderPtr, uiHeaderCapacity);
+      w << sAbsolutePath;
+
+      pData->m_MappedReader.m_Header.Reset(pHeaderPtr, w.GetNumWrittenBytes());
+      pData->m_MappedReader.m_Content.Reset(pData->m_MappedFile.GetReadPointer(), pData->m_MappedFile.GetFileSize());
+      res.m_pDataStream = &pData->m_MappedReader;
+
+      // the mapped content is backed by the page cache, only the header is allocated
+      res.m_uiDataSize = uiHeaderCapacity;
+
+      return res;
+    }
+
+    // the file may have been removed or replaced in the meantime, open it through the file system again, like the regular path does
+    if (File.Open(pResource->GetResourceID().GetData()).Failed())
+      return res;
+
+    uiFileSize = File.GetFileSize();
+  }
+#endif
 
   const ezUInt64 uiBlobCapacity = uiFileSize + File.GetFilePathAbsolute().GetElementCount() + 8; // +8 for the string overhead
   pData->m_Storage.SetCountUninitialized(uiBlobCapacity);
@@ -55,7 +125,7 @@ ezResourceLoadData ezResourceLoaderFromFile::OpenDataStream(const ezResource* pR
 
   pData->m_Reader.Reset(pBlobPtr, w.GetNumWrittenBytes() + uiFileSize);
   res.m_pDataStream = &pData->m_Reader;
-  res.m_pCustomLoaderData = pData;
+  res.m_uiDataSize = uiBlobCapacity;
 
   return res;
 }
@@ -102,6 +172,7 @@ ezResourceLoadData ezResourceLoaderFromMemory::OpenDataStream(const ezResource*
   res.m_LoadedFileModificationDate = m_ModificationTimestamp;
   res.m_pDataStream = &m_Reader;
   res.m_pCustomLoaderData = nullptr;
+  res.m_uiDataSize = m_CustomData.GetStorageSize();
 
   return res;
 }
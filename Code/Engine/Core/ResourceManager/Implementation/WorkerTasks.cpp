@@ -15,21 +15,31 @@ void ezResourceManagerWorkerDataLoad::Execute()
   ezResource* pResourceToLoad = nullptr;
   ezResourceTypeLoader* pLoader = nullptr;
   ezUniquePtr<ezResourceTypeLoader> pCustomLoader;
+  ezResourceManager::LoadingQueue* pQueue = nullptr;
 
   {
     EZ_LOCK(ezResourceManager::s_ResourceMutex);
 
-    if (ezResourceManager::s_State->s_LoadingQueue.IsEmpty())
+    pQueue = ezResourceManager::GetNextLoadingQueue();
+
+    if (pQueue == nullptr)
     {
-      ezResourceManager::s_State->s_bAllowLaunchDataLoadTask = true;
+      --ezResourceManager::s_State->s_uiNumDataLoadsRunning;
       return;
     }
 
-    ezResourceManager::UpdateLoadingDeadlines();
+    const ezResourceManager::LoadingInfo li = pQueue->PopFront();
+    pResourceToLoad = li.m_pResource;
+    ++pQueue->m_uiNumLoadsRunning;
+
+    {
+      const ezTime tLatency = ezTime::Now() - li.m_EnqueueTime;
 
-    auto it = ezResourceManager::s_State->s_LoadingQueue.PeekFront();
-    pResourceToLoad = it.m_pResource;
-    ezResourceManager::s_State->s_LoadingQueue.PopFront();
+      auto& stats = ezResourceManager::s_State->s_LoadingQueueStats[(int)pResourceToLoad->GetPriority()];
+      ++stats.m_uiNumDequeued;
+      stats.m_TotalLatency += tLatency;
+      stats.m_MaxLatency = ezMath::Max(stats.m_MaxLatency, tLatency);
+    }
 
     if (pResourceToLoad->m_Flags.IsSet(ezResourceFlags::HasCustomDataLoader))
     {
@@ -58,6 +68,11 @@ void ezResourceManagerWorkerDataLoad::Execute()
 
   EZ_LOCK(ezResourceManager::s_ResourceMutex);
 
+  --pQueue->m_uiNumLoadsRunning;
+
+  // the loaded data stays in memory until the update content task is done with it
+  ezResourceManager::s_State->s_uiDataLoadBytesInFlight += LoaderData.m_uiDataSize;
+
   // try to find an update content task that has finished and can be reused
   for (ezUInt32 i = 0; i < ezResourceManager::s_State->s_WorkerTasksUpdateContent.GetCount(); ++i)
   {
@@ -100,7 +115,7 @@ void ezResourceManagerWorkerDataLoad::Execute()
       pUpdateContentTask, bResourceIsLoadedOnMainThread ? ezTaskPriority::SomeFrameMainThread : ezTaskPriority::LateNextFrame);
 
     // restart the next loading task (this one is about to finish)
-    ezResourceManager::s_State->s_bAllowLaunchDataLoadTask = true;
+    --ezResourceManager::s_State->s_uiNumDataLoadsRunning;
     ezResourceManager::RunWorkerTask(nullptr);
 
     pCustomLoader.Clear();
@@ -154,6 +169,10 @@ void ezResourceManagerWorkerUpdateContent::Execute()
     EZ_ASSERT_DEV(ezResourceManager::IsQueuedForLoading(m_pResourceToLoad), "Multi-threaded access detected");
     m_pResourceToLoad->m_Flags.Remove(ezResourceFlags::IsQueuedForLoading);
     m_pResourceToLoad->m_LastAcquire = ezResourceManager::GetLastFrameUpdate();
+
+    // loads may have been held back until this data is released
+    ezResourceManager::s_State->s_uiDataLoadBytesInFlight -= m_LoaderData.m_uiDataSize;
+    ezResourceManager::RunWorkerTask(nullptr);
   }
 
   m_pLoader = nullptr;
@@ -224,15 +224,14 @@ private:
   ezString m_sResourceDescription;
   MemoryUsage m_MemoryUsage;
   ezBitflags<ezResourceFlags> m_Flags;
+  ezUInt32 m_uiLoadingQueueIndex = ezInvalidIndex; ///< Position in the loading queue, maintained by ezResourceManager
 
   ezTime m_LastAcquire;
   ezResourcePriority m_Priority = ezResourcePriority::Medium;
   ezTimestamp m_LoadedFileModificationTime;
 
 private:
-#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
   static const ezResource* GetCurrentlyUpdatingContent();
-#endif
 };
 
 
@@ -101,6 +101,42 @@ public:
   /// \brief Returns the current loading state of the given resource.
   static ezResourceState GetLoadingState(const ezTypelessResourceHandle& hResource);
 
+  /// \brief Limits how many resources are read at the same time and how much loaded data may wait for its ezResource::UpdateContent() call.
+  ///
+  /// Resource data is read by ezTaskPriority::FileAccess tasks, so at most one load per file access thread can run at a time (see
+  /// ezTaskSystem::SetWorkerThreadCount()). If \a uiMaxConcurrentLoads is zero, which is the default, one load per file access thread is allowed.
+  /// If more than one load is allowed, one of them is reserved for resource types that use SetFastDataLoadForResourceType(), so that those
+  /// never wait behind large reads.
+  ///
+  /// Once \a uiMaxBytesInFlight bytes of loaded data wait to be processed, no further loads are started until some of it has been processed.
+  /// A single load is always allowed, though, so that a resource that is larger than the budget can still be loaded. Zero means no limit.
+  static void SetDataLoadLimits(ezUInt32 uiMaxConcurrentLoads, ezUInt64 uiMaxBytesInFlight);
+
+  /// \brief If set to 'true' resources of the given type are loaded through a separate queue that never waits behind resources of other types.
+  ///
+  /// Use this for types whose data is small and quick to process, e.g. materials. Has no effect if only one resource can be loaded at a time.
+  /// \sa SetDataLoadLimits()
+  template <typename ResourceType>
+  static void SetFastDataLoadForResourceType(bool bFast);
+
+  /// \brief Statistics about how long resources waited in the loading queue before their data was read.
+  struct LoadingQueueStats
+  {
+    ezUInt32 m_uiNumQueued = 0;   ///< How many resources with this priority are currently waiting.
+    ezUInt64 m_uiNumDequeued = 0; ///< How many resources with this priority have been taken from the queue to be loaded.
+    ezTime m_TotalLatency;        ///< The summed up waiting time of all dequeued resources, divide by m_uiNumDequeued for the average.
+    ezTime m_MaxLatency;          ///< The longest time any dequeued resource had to wait.
+  };
+
+  /// \brief Returns the loading queue statistics for all resources with the given priority.
+  ///
+  /// Resources are counted with the priority that they have at the time they are taken from the queue.
+  /// Resources that are acquired with a blocking acquire mode count as ezResourcePriority::Critical.
+  static LoadingQueueStats GetLoadingQueueStats(ezResourcePriority priority);
+
+  /// \brief Resets the statistics returned by GetLoadingQueueStats(), except for the number of currently queued resources.
+  static void ResetLoadingQueueStats();
+
   ///@}
   /// \name Reloading resources
   ///@{
@@ -385,6 +421,47 @@ public:
 
 private:
   static ezMap<const ezRTTI*, ezResourcePriority>& GetResourceTypePriorities();
+
+  ///@}
+  /// \name Resource Dependency Prefetching
+  ///@{
+
+public:
+  /// \brief Enables recording which resources get loaded while another resource executes its UpdateContent() function.
+  ///
+  /// For example a material loads its shader and textures that way. Usually these dependencies are only discovered one at a time,
+  /// whenever the UpdateContent() of the previous resource in the chain runs. The recorded dependencies can be stored with
+  /// SaveResourceDependencies() and restored in a later session, to be able to put all of them into the loading queue right away.
+  static void SetRecordResourceDependencies(bool bEnable);
+
+  /// \sa SetRecordResourceDependencies()
+  static bool GetRecordResourceDependencies();
+
+  /// \brief When enabled, preloading a resource also preloads all of its known dependencies (and theirs), with at least the same priority.
+  ///
+  /// This also applies to resources that are preloaded through ezCollectionResource::PreloadResources().
+  static void SetPrefetchResourceDependencies(bool bEnable);
+
+  /// \sa SetPrefetchResourceDependencies()
+  static bool GetPrefetchResourceDependencies();
+
+  /// \brief Writes all known resource dependencies to the stream, e.g. into a cache file at application shutdown.
+  static void SaveResourceDependencies(ezStreamWriter& stream);
+
+  /// \brief Reads resource dependencies that were written with SaveResourceDependencies().
+  ///
+  /// Dependencies that were already recorded in this session take precedence over the loaded ones.
+  /// Resource types that are unknown in this session are ignored.
+  /// Nothing is changed when the data is incomplete or invalid, in which case EZ_FAILURE is returned.
+  static ezResult LoadResourceDependencies(ezStreamReader& stream);
+
+  /// \brief Discards all known resource dependencies.
+  static void ClearResourceDependencies();
+
+private:
+  static void RecordResourceDependency(ezResource* pDependency);
+  static void PrefetchResourceDependencies(ezResource* pResource);
+
   ///@}
 
   //////////////////////////////////////////////////////////////////////////
@@ -423,11 +500,55 @@ private:
   struct LoadingInfo
   {
     float m_fPriority = 0;
+    ezInt64 m_iSequence = 0; ///< Keeps the insertion order for equal priorities, negative for entries that were pushed to the front
+    ezTime m_EnqueueTime;
     ezResource* m_pResource = nullptr;
 
-    EZ_ALWAYS_INLINE bool operator==(const LoadingInfo& rhs) const { return m_pResource == rhs.m_pResource; }
-    EZ_ALWAYS_INLINE bool operator<(const LoadingInfo& rhs) const { return m_fPriority < rhs.m_fPriority; }
+    EZ_ALWAYS_INLINE bool operator<(const LoadingInfo& rhs) const
+    {
+      return m_fPriority < rhs.m_fPriority || (m_fPriority == rhs.m_fPriority && m_iSequence < rhs.m_iSequence);
+    }
   };
+
+  struct LoadingQueueType
+  {
+    enum Enum
+    {
+      Default,
+      Fast, ///< Resource types that use SetFastDataLoadForResourceType()
+      ENUM_COUNT
+    };
+  };
+
+  /// \brief A binary min-heap of resources to load, ordered by their loading priority.
+  ///
+  /// Every queued resource stores its position in the heap in ezResource::m_uiLoadingQueueIndex,
+  /// so that it can be removed or its priority can be changed in O(log n).
+  struct LoadingQueue
+  {
+    void Push(ezResource* pResource, float fPriority, bool bFront);
+    LoadingInfo PopFront();
+    bool Remove(ezResource* pResource);
+    bool Contains(const ezResource* pResource) const;
+    void UpdatePriority(ezResource* pResource, float fPriority, bool bFront = false);
+    void Clear();
+
+    EZ_ALWAYS_INLINE const LoadingInfo& PeekFront() const { return m_Entries[0]; }
+    EZ_ALWAYS_INLINE bool IsEmpty() const { return m_Entries.IsEmpty(); }
+    EZ_ALWAYS_INLINE ezUInt32 GetCount() const { return m_Entries.GetCount(); }
+
+    ezDynamicArray<LoadingInfo> m_Entries;
+    ezUInt32 m_uiLastPriorityUpdateIdx = 0;
+    ezUInt32 m_uiNumLoadsRunning = 0; ///< Resources taken from this queue whose data is currently being read
+    ezInt64 m_iNextBackSequence = 0;
+    ezInt64 m_iNextFrontSequence = -1;
+
+  private:
+    void MoveUp(ezUInt32 uiIndex);
+    void MoveDown(ezUInt32 uiIndex);
+    void Store(ezUInt32 uiIndex, const LoadingInfo& li);
+  };
+
   static void EnsureResourceLoadingState(ezResource* pResource, const ezResourceState RequestedState);
   static void PreloadResource(ezResource* pResource);
   static void InternalPreloadResource(ezResource* pResource, bool bHighestPriority);
@@ -436,10 +557,22 @@ private:
   static ResourceType* GetResource(const char* szResourceID, bool bIsReloadable);
   static ezResource* GetResource(const ezRTTI* pRtti, const char* szResourceID, bool bIsReloadable);
   static void RunWorkerTask(ezResource* pResource);
-  static void UpdateLoadingDeadlines();
-  static void ReverseBubbleSortStep(ezDeque<LoadingInfo>& data);
+  static void StartDataLoadTask();
+  static ezUInt32 GetMaxConcurrentDataLoads();
+  static LoadingQueue* GetNextLoadingQueue();
+  static void UpdateLoadingDeadlines(LoadingQueue& queue);
+  static void UpdateLoadingQueuePriority(ezResource* pResource);
   static bool ReloadResource(ezResource* pResource, bool bForce);
 
+  /// \brief Returns a handle to the resource, if it is in the lookup index, without locking s_ResourceMutex.
+  ///
+  /// Returns an invalid handle otherwise, in which case the caller has to go through GetResource().
+  static ezTypelessResourceHandle TryGetIndexedResource(const ezRTTI* pRtti, const char* szResourceID);
+  static void AddToLookupIndex(ezResource* pResource);
+  /// \brief Fails, if the resource got referenced through the lookup index in the meantime and thus must not be deallocated.
+  [[nodiscard]] static ezResult RemoveFromLookupIndex(ezResource* pResource);
+  static void ClearLookupIndex();
+
   static void SetupWorkerTasks();
   static ezTime GetLastFrameUpdate();
   static ezHashTable<const ezRTTI*, LoadedResources>& GetLoadedResources();
@@ -452,6 +585,7 @@ private:
   struct ResourceTypeInfo
   {
     bool m_bIncrementalUnload = true;
+    bool m_bFastDataLoad = false;
     bool m_bAllowNestedAcquireCached = false;
 
     ezHybridArray<const ezRTTI*, 8> m_NestedTypes;
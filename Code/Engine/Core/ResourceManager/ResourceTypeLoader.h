@@ -19,6 +19,9 @@ struct EZ_CORE_DLL ezResourceLoadData
 
   /// Custom loader data, e.g. a pointer to a custom memory block, that needs to be freed when the resource is done updating.
   void* m_pCustomLoaderData = nullptr;
+
+  /// Size of the loaded data in bytes, if known. Used to limit how much loaded data may wait for processing, see ezResourceManager::SetDataLoadLimits().
+  ezUInt64 m_uiDataSize = 0;
 };
 
 /// \brief Base class for all resource loaders.
@@ -62,6 +65,19 @@ public:
   virtual ezResourceLoadData OpenDataStream(const ezResource* pResource) override;
   virtual void CloseDataStream(const ezResource* pResource, const ezResourceLoadData& LoaderData) override;
   virtual bool IsResourceOutdated(const ezResource* pResource) const override;
+
+  /// \brief If enabled, files are mapped into memory instead of being copied into a temporary buffer.
+  ///
+  /// The resource then reads directly from the mapped file until CloseDataStream() is called, which saves a copy of every file
+  /// and the memory for it. This is useful for large files, e.g. texture or mesh data.
+  /// Files that are not directly on disk, e.g. files inside of archives, and platforms without ezMemoryMappedFile support always use the regular path.
+  /// The file must not be modified while it is mapped, so this should not be used where files are written while the application runs.
+  /// Must not be changed while resources are being loaded.
+  void SetUseMemoryMappedFiles(bool bUse) { m_bUseMemoryMappedFiles = bUse; }
+  bool GetUseMemoryMappedFiles() const { return m_bUseMemoryMappedFiles; }
+
+private:
+  bool m_bUseMemoryMappedFiles = false;
 };
 
 
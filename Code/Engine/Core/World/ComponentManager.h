@@ -125,6 +125,47 @@ protected:
 };
 
 
+//////////////////////////////////////////////////////////////////////////
+
+/// \brief Component manager that additionally keeps the hot data of every component in a separate, tightly packed array.
+///
+/// Update functions that only read and write a few values per component can iterate over GetHotData() linearly instead of touching
+/// the full component objects with their vtables and rarely used members. The hot data at index i always belongs to the component at
+/// index i in m_ComponentStorage, so an update function can walk both in lockstep starting at context.m_uiFirstComponentIndex.
+/// To guarantee this the components are always stored compact and the hot data is moved along with them on deletion.
+///
+/// Components can access their own hot data with GetHotData(this). This has to search the storage, so it is meant for property
+/// accessors and events, not for per frame updates.
+template <typename T, typename HotDataType>
+class ezComponentManagerWithHotData : public ezComponentManager<T, ezBlockStorageType::Compact>
+{
+public:
+  typedef ezComponentManager<T, ezBlockStorageType::Compact> SUPER;
+  typedef HotDataType HotData;
+
+  ezComponentManagerWithHotData(ezWorld* pWorld);
+  ~ezComponentManagerWithHotData();
+
+  /// \brief Returns the hot data of the given component.
+  HotDataType& GetHotData(const T* pComponent);
+
+  /// \brief Returns the hot data of the given component.
+  const HotDataType& GetHotData(const T* pComponent) const;
+
+  /// \brief Returns the hot data of all components, in the same order as GetComponents().
+  ezArrayPtr<HotDataType> GetHotData();
+
+  /// \brief Returns the hot data of all components, in the same order as GetComponents().
+  ezArrayPtr<const HotDataType> GetHotData() const;
+
+protected:
+  virtual ezComponent* CreateComponentStorage() override;
+  virtual void DeleteComponentStorage(ezComponent* pComponent, ezComponent*& out_pMovedComponent) override;
+
+  ezDynamicArray<HotDataType> m_HotData;
+};
+
+
 //////////////////////////////////////////////////////////////////////////
 
 struct ezComponentUpdateType
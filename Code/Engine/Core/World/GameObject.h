@@ -464,6 +464,7 @@ public:
   void SetStableRandomSeed(ezUInt32 seed) { m_pTransformationData->m_uiStableRandomSeed = seed; }
 
 private:
+  friend class ezComponent;
   friend class ezComponentManagerBase;
   friend class ezGameObjectTest;
 
@@ -503,6 +504,14 @@ private:
 
   void SendNotificationMessage(ezMessage& msg);
 
+  // Message ids are folded into 16 bits, so a set bit only means that the message might be handled.
+  EZ_ALWAYS_INLINE static ezUInt16 GetMessageMask(ezMessageId id) { return static_cast<ezUInt16>(EZ_BIT(id & 15)); }
+
+  // Adds the messages that the given component handles to the message mask of this object and all its parents.
+  void AddHandledMessages(const ezComponent* pComponent);
+  void AddHandledMessages(ezUInt16 uiMessageMask);
+  ezUInt16 GetHandledMessageMask() const;
+
   struct EZ_CORE_DLL EZ_ALIGN_16(TransformationData)
   {
     EZ_DECLARE_POD_TYPE();
@@ -545,6 +554,9 @@ private:
     void UpdateGlobalBounds();
     void UpdateGlobalBoundsAndSpatialData(ezSpatialSystem& spatialSytem);
 
+    /// \brief Updates the global bounds and returns whether the spatial data needs to be updated as well, without touching the spatial system.
+    bool UpdateGlobalBoundsAndCheckSpatialData(bool& out_bWasAlwaysVisible, bool& out_bIsAlwaysVisible);
+
     void UpdateVelocity(const ezSimdFloat& fInvDeltaSeconds);
 
     void UpdateSpatialData(ezSpatialSystem& spatialSystem, bool bWasAlwaysVisible, bool bIsAlwaysVisible);
@@ -583,7 +595,10 @@ private:
   struct ComponentUserData
   {
     ezUInt16 m_uiVersion;
-    ezUInt16 m_uiUnused;
+
+    /// Has the bit GetMessageMask(id) set for every message id that a component of this object or of one of its children might handle.
+    /// Stored here instead of in the transformation data so recursive messages do not touch another cache line per object.
+    ezUInt16 m_uiHandledMessageMask;
   };
 
   ezTagSet m_Tags;
@@ -190,6 +190,11 @@ void ezComponent::OnSimulationStarted() {}
 void ezComponent::EnableUnhandledMessageHandler(bool enable)
 {
   m_ComponentFlags.AddOrRemove(ezObjectFlags::UnhandledMessageHandler, enable);
+
+  if (enable && m_pOwner != nullptr)
+  {
+    m_pOwner->AddHandledMessages(this);
+  }
 }
 
 bool ezComponent::OnUnhandledMessage(ezMessage& msg, bool bWasPostedMsg)
@@ -158,6 +158,68 @@ EZ_FORCE_INLINE void ezComponentManager<T, StorageType>::RegisterUpdateFunction(
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////
 
+template <typename T, typename HotDataType>
+ezComponentManagerWithHotData<T, HotDataType>::ezComponentManagerWithHotData(ezWorld* pWorld)
+  : SUPER(pWorld)
+  , m_HotData(this->GetAllocator())
+{
+}
+
+template <typename T, typename HotDataType>
+ezComponentManagerWithHotData<T, HotDataType>::~ezComponentManagerWithHotData()
+{
+}
+
+template <typename T, typename HotDataType>
+EZ_FORCE_INLINE HotDataType& ezComponentManagerWithHotData<T, HotDataType>::GetHotData(const T* pComponent)
+{
+  const ezUInt32 uiIndex = this->m_ComponentStorage.GetIndex(pComponent);
+  EZ_ASSERT_DEV(uiIndex != ezInvalidIndex, "Component {0} does not belong to this manager.", ezArgP(pComponent));
+
+  return m_HotData[uiIndex];
+}
+
+template <typename T, typename HotDataType>
+EZ_FORCE_INLINE const HotDataType& ezComponentManagerWithHotData<T, HotDataType>::GetHotData(const T* pComponent) const
+{
+  const ezUInt32 uiIndex = this->m_ComponentStorage.GetIndex(pComponent);
+  EZ_ASSERT_DEV(uiIndex != ezInvalidIndex, "Component {0} does not belong to this manager.", ezArgP(pComponent));
+
+  return m_HotData[uiIndex];
+}
+
+template <typename T, typename HotDataType>
+EZ_ALWAYS_INLINE ezArrayPtr<HotDataType> ezComponentManagerWithHotData<T, HotDataType>::GetHotData()
+{
+  return m_HotData;
+}
+
+template <typename T, typename HotDataType>
+EZ_ALWAYS_INLINE ezArrayPtr<const HotDataType> ezComponentManagerWithHotData<T, HotDataType>::GetHotData() const
+{
+  return m_HotData;
+}
+
+template <typename T, typename HotDataType>
+ezComponent* ezComponentManagerWithHotData<T, HotDataType>::CreateComponentStorage()
+{
+  m_HotData.PushBack(HotDataType());
+  return SUPER::CreateComponentStorage();
+}
+
+template <typename T, typename HotDataType>
+void ezComponentManagerWithHotData<T, HotDataType>::DeleteComponentStorage(ezComponent* pComponent, ezComponent*& out_pMovedComponent)
+{
+  // compact storage moves the last component into the free slot, so do the same with the hot data
+  const ezUInt32 uiIndex = this->m_ComponentStorage.GetIndex(static_cast<T*>(pComponent));
+  EZ_ASSERT_DEV(uiIndex != ezInvalidIndex, "Component {0} does not belong to this manager.", ezArgP(pComponent));
+
+  m_HotData.RemoveAtAndSwap(uiIndex);
+  SUPER::DeleteComponentStorage(pComponent, out_pMovedComponent);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////
+
 template <typename ComponentType, ezComponentUpdateType::Enum UpdateType, ezBlockStorageType::Enum StorageType>
 ezComponentManagerSimple<ComponentType, UpdateType, StorageType>::ezComponentManagerSimple(ezWorld* pWorld)
   : ezComponentManager<ComponentType, StorageType>(pWorld)
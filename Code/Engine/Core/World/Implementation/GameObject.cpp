@@ -728,6 +728,8 @@ void ezGameObject::AddComponent(ezComponent* pComponent)
   m_Components.PushBack(pComponent, GetWorld()->GetAllocator());
   m_Components.GetUserData<ComponentUserData>().m_uiVersion++;
 
+  AddHandledMessages(pComponent);
+
   pComponent->UpdateActiveState(IsActive());
 
   if (m_Flags.IsSet(ezObjectFlags::ComponentChangesNotifications))
@@ -761,6 +763,42 @@ void ezGameObject::RemoveComponent(ezComponent* pComponent)
   }
 }
 
+void ezGameObject::AddHandledMessages(const ezComponent* pComponent)
+{
+  ezUInt16 uiMessageMask = 0;
+
+  if (pComponent->m_ComponentFlags.IsSet(ezObjectFlags::UnhandledMessageHandler))
+  {
+    uiMessageMask = 0xFFFF;
+  }
+  else
+  {
+    for (const ezRTTI* pRtti = pComponent->GetDynamicRTTI(); pRtti != nullptr; pRtti = pRtti->GetParentType())
+    {
+      for (const ezAbstractMessageHandler* pHandler : pRtti->GetMessageHandlers())
+      {
+        uiMessageMask |= GetMessageMask(pHandler->GetMessageId());
+      }
+    }
+  }
+
+  AddHandledMessages(uiMessageMask);
+}
+
+void ezGameObject::AddHandledMessages(ezUInt16 uiMessageMask)
+{
+  // The masks are never reduced when components are removed or children are re-parented, stale bits only cost a few unnecessary visits.
+  // Since a parent mask always contains the masks of its children, propagation can stop at the first parent that already has all bits.
+  for (ezGameObject* pObject = this; pObject != nullptr; pObject = pObject->GetParent())
+  {
+    ezUInt16& uiObjectMask = pObject->m_Components.GetUserData<ComponentUserData>().m_uiHandledMessageMask;
+    if ((uiObjectMask & uiMessageMask) == uiMessageMask)
+      break;
+
+    uiObjectMask |= uiMessageMask;
+  }
+}
+
 bool ezGameObject::SendMessageInternal(ezMessage& msg, bool bWasPostedMsg)
 {
   bool bSentToAny = false;
@@ -810,9 +848,13 @@ bool ezGameObject::SendMessageInternal(ezMessage& msg, bool bWasPostedMsg) const
 
 bool ezGameObject::SendMessageRecursiveInternal(ezMessage& msg, bool bWasPostedMsg)
 {
-  bool bSentToAny = false;
-
   const ezRTTI* pRtti = ezGetStaticRTTI<ezGameObject>();
+
+  // nothing in this sub-tree can handle the message
+  if ((GetHandledMessageMask() & GetMessageMask(msg.GetId())) == 0 && !pRtti->CanHandleMessage(msg.GetId()))
+    return false;
+
+  bool bSentToAny = false;
   bSentToAny |= pRtti->DispatchMessage(this, msg);
 
   for (ezUInt32 i = 0; i < m_Components.GetCount(); ++i)
@@ -840,9 +882,13 @@ bool ezGameObject::SendMessageRecursiveInternal(ezMessage& msg, bool bWasPostedM
 
 bool ezGameObject::SendMessageRecursiveInternal(ezMessage& msg, bool bWasPostedMsg) const
 {
-  bool bSentToAny = false;
-
   const ezRTTI* pRtti = ezGetStaticRTTI<ezGameObject>();
+
+  // nothing in this sub-tree can handle the message
+  if ((GetHandledMessageMask() & GetMessageMask(msg.GetId())) == 0 && !pRtti->CanHandleMessage(msg.GetId()))
+    return false;
+
+  bool bSentToAny = false;
   bSentToAny |= pRtti->DispatchMessage(this, msg);
 
   for (ezUInt32 i = 0; i < m_Components.GetCount(); ++i)
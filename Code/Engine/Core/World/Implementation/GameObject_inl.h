@@ -504,6 +504,11 @@ EZ_ALWAYS_INLINE ezUInt16 ezGameObject::GetComponentVersion() const
   return m_Components.GetUserData<ComponentUserData>().m_uiVersion;
 }
 
+EZ_ALWAYS_INLINE ezUInt16 ezGameObject::GetHandledMessageMask() const
+{
+  return m_Components.GetUserData<ComponentUserData>().m_uiHandledMessageMask;
+}
+
 EZ_ALWAYS_INLINE ezTagSet& ezGameObject::GetTags()
 {
   return m_Tags;
@@ -560,6 +565,15 @@ EZ_FORCE_INLINE void ezGameObject::TransformationData::UpdateGlobalBounds()
 }
 
 EZ_FORCE_INLINE void ezGameObject::TransformationData::UpdateGlobalBoundsAndSpatialData(ezSpatialSystem& spatialSytem)
+{
+  bool bWasAlwaysVisible, bIsAlwaysVisible;
+  if (UpdateGlobalBoundsAndCheckSpatialData(bWasAlwaysVisible, bIsAlwaysVisible))
+  {
+    UpdateSpatialData(spatialSytem, bWasAlwaysVisible, bIsAlwaysVisible);
+  }
+}
+
+EZ_FORCE_INLINE bool ezGameObject::TransformationData::UpdateGlobalBoundsAndCheckSpatialData(bool& out_bWasAlwaysVisible, bool& out_bIsAlwaysVisible)
 {
   ezSimdBBoxSphere oldGlobalBounds = m_globalBounds;
 
@@ -570,11 +584,12 @@ EZ_FORCE_INLINE void ezGameObject::TransformationData::UpdateGlobalBoundsAndSpat
   if ((m_globalBounds.m_CenterAndRadius != oldGlobalBounds.m_CenterAndRadius || m_globalBounds.m_BoxHalfExtents != oldGlobalBounds.m_BoxHalfExtents)
         .AnySet<4>())
   {
-    bool bWasAlwaysVisible = oldGlobalBounds.m_BoxHalfExtents.w() != ezSimdFloat::Zero();
-    bool bIsAlwaysVisible = m_globalBounds.m_BoxHalfExtents.w() != ezSimdFloat::Zero();
-
-    UpdateSpatialData(spatialSytem, bWasAlwaysVisible, bIsAlwaysVisible);
+    out_bWasAlwaysVisible = oldGlobalBounds.m_BoxHalfExtents.w() != ezSimdFloat::Zero();
+    out_bIsAlwaysVisible = m_globalBounds.m_BoxHalfExtents.w() != ezSimdFloat::Zero();
+    return true;
   }
+
+  return false;
 }
 
 EZ_ALWAYS_INLINE void ezGameObject::TransformationData::UpdateVelocity(const ezSimdFloat& fInvDeltaSeconds)
@@ -1,6 +1,7 @@
 #include <CorePCH.h>
 
 #include <Core/World/SpatialSystem.h>
+#include <Foundation/Threading/AtomicInteger.h>
 #include <Foundation/Time/Stopwatch.h>
 
 // clang-format off
@@ -8,6 +9,13 @@ EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezSpatialSystem, 1, ezRTTINoAllocator)
 EZ_END_DYNAMIC_REFLECTED_TYPE;
 // clang-format on
 
+namespace
+{
+  static ezAtomicInteger32 s_iSpatialSystemIdCounter;
+}
+
+ezSpatialSystem::VisibilityCache::~VisibilityCache() = default;
+
 ezSpatialSystem::ezSpatialSystem()
   : m_Allocator("Spatial System", ezFoundation::GetDefaultAllocator())
   , m_AllocatorWrapper(&m_Allocator)
@@ -16,6 +24,7 @@ ezSpatialSystem::ezSpatialSystem()
   , m_DataStorage(&m_BlockAllocator, &m_Allocator)
   , m_DataAlwaysVisible(&m_Allocator)
 {
+  m_uiId = static_cast<ezUInt32>(s_iSpatialSystemIdCounter.Increment());
 }
 
 ezSpatialSystem::~ezSpatialSystem() = default;
@@ -113,6 +122,51 @@ void ezSpatialSystem::UpdateSpatialData(
   }
 }
 
+void ezSpatialSystem::UpdateSpatialDataBatch(ezArrayPtr<const SpatialDataUpdate> updates)
+{
+  m_ChangedData.Clear();
+
+  for (const SpatialDataUpdate& update : updates)
+  {
+    ezSpatialData* pData = nullptr;
+    if (!m_DataTable.TryGetValue(update.m_hData.GetInternalID(), pData))
+      continue;
+
+    pData->m_pObject = update.m_pObject;
+
+    if (!pData->m_Flags.IsSet(ezSpatialData::Flags::AlwaysVisible))
+    {
+      if (update.m_uiCategoryBitmask != pData->m_uiCategoryBitmask || update.m_Bounds != pData->m_Bounds)
+      {
+        auto& change = m_ChangedData.ExpandAndGetRef();
+        change.m_OldBounds = pData->m_Bounds;
+        change.m_pData = pData;
+        change.m_uiOldCategoryBitmask = pData->m_uiCategoryBitmask;
+
+        pData->m_uiCategoryBitmask = update.m_uiCategoryBitmask;
+        pData->m_Bounds = update.m_Bounds;
+      }
+    }
+    else
+    {
+      pData->m_uiCategoryBitmask = update.m_uiCategoryBitmask;
+    }
+  }
+
+  if (!m_ChangedData.IsEmpty())
+  {
+    SpatialDataChangedBatch(m_ChangedData);
+  }
+}
+
+void ezSpatialSystem::SpatialDataChangedBatch(ezArrayPtr<const ChangedSpatialData> changes)
+{
+  for (const ChangedSpatialData& change : changes)
+  {
+    SpatialDataChanged(change.m_pData, change.m_OldBounds, change.m_uiOldCategoryBitmask);
+  }
+}
+
 void ezSpatialSystem::FindObjectsInSphere(
   const ezBoundingSphere& sphere, ezUInt32 uiCategoryBitmask, ezDynamicArray<ezGameObject*>& out_Objects, QueryStats* pStats /*= nullptr*/) const
 {
@@ -185,9 +239,27 @@ void ezSpatialSystem::FindObjectsInBox(
   }
 }
 
-void ezSpatialSystem::FindVisibleObjects(
-  const ezFrustum& frustum, ezUInt32 uiCategoryBitmask, ezDynamicArray<const ezGameObject*>& out_Objects, QueryStats* pStats /*= nullptr*/) const
+ezUniquePtr<ezSpatialSystem::VisibilityCache> ezSpatialSystem::CreateVisibilityCache() const
+{
+  ezUniquePtr<VisibilityCache> pCache = CreateVisibilityCacheInternal();
+  if (pCache != nullptr)
+  {
+    pCache->m_uiSpatialSystemId = m_uiId;
+  }
+
+  return pCache;
+}
+
+bool ezSpatialSystem::IsVisibilityCacheValid(const VisibilityCache* pCache) const
 {
+  return pCache != nullptr && pCache->m_uiSpatialSystemId == m_uiId;
+}
+
+void ezSpatialSystem::FindVisibleObjects(const ezFrustum& frustum, ezUInt32 uiCategoryBitmask, ezDynamicArray<const ezGameObject*>& out_Objects,
+  QueryStats* pStats /*= nullptr*/, IsOccludedCallback isOccludedCallback /*= IsOccludedCallback()*/, VisibilityCache* pCache /*= nullptr*/) const
+{
+  EZ_ASSERT_DEV(pCache == nullptr || IsVisibilityCacheValid(pCache), "The visibility cache was created by a different spatial system");
+
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
   ezStopwatch timer;
 
@@ -199,7 +271,7 @@ void ezSpatialSystem::FindVisibleObjects(
   }
 #endif
 
-  FindVisibleObjectsInternal(frustum, uiCategoryBitmask, out_Objects, pStats);
+  FindVisibleObjectsInternal(frustum, uiCategoryBitmask, out_Objects, pStats, isOccludedCallback, pCache);
 
   for (auto pData : m_DataAlwaysVisible)
   {
@@ -218,5 +290,9 @@ void ezSpatialSystem::FindVisibleObjects(
 }
 
 
+ezUniquePtr<ezSpatialSystem::VisibilityCache> ezSpatialSystem::CreateVisibilityCacheInternal() const
+{
+  return nullptr;
+}
 
 EZ_STATICLINK_FILE(Core, Core_World_Implementation_SpatialSystem);
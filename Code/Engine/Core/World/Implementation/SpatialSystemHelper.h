@@ -0,0 +1,159 @@
+#pragma once
+
+#include <Foundation/Math/Frustum.h>
+#include <Foundation/SimdMath/SimdBSphere.h>
+#include <Foundation/SimdMath/SimdConversion.h>
+#include <Foundation/SimdMath/SimdMat4f.h>
+
+namespace ezInternal
+{
+  /// \brief The planes of a frustum in a layout that allows to test a sphere against all of them with a few SIMD operations.
+  struct FrustumPlaneData
+  {
+    ezSimdVec4f m_x0x1x2x3;
+    ezSimdVec4f m_y0y1y2y3;
+    ezSimdVec4f m_z0z1z2z3;
+    ezSimdVec4f m_w0w1w2w3;
+
+    ezSimdVec4f m_x4x5x4x5;
+    ezSimdVec4f m_y4y5y4y5;
+    ezSimdVec4f m_z4z5z4z5;
+    ezSimdVec4f m_w4w5w4w5;
+
+    void SetFrustum(const ezFrustum& frustum)
+    {
+      // Compiler is too stupid to properly unroll a constant loop so we do it by hand
+      ezSimdVec4f plane0 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(0).m_vNormal.x)));
+      ezSimdVec4f plane1 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(1).m_vNormal.x)));
+      ezSimdVec4f plane2 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(2).m_vNormal.x)));
+      ezSimdVec4f plane3 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(3).m_vNormal.x)));
+      ezSimdVec4f plane4 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(4).m_vNormal.x)));
+      ezSimdVec4f plane5 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(5).m_vNormal.x)));
+
+      ezSimdMat4f helperMat;
+      helperMat.SetRows(plane0, plane1, plane2, plane3);
+
+      m_x0x1x2x3 = helperMat.m_col0;
+      m_y0y1y2y3 = helperMat.m_col1;
+      m_z0z1z2z3 = helperMat.m_col2;
+      m_w0w1w2w3 = helperMat.m_col3;
+
+      helperMat.SetRows(plane4, plane5, plane4, plane5);
+
+      m_x4x5x4x5 = helperMat.m_col0;
+      m_y4y5y4y5 = helperMat.m_col1;
+      m_z4z5z4z5 = helperMat.m_col2;
+      m_w4w5w4w5 = helperMat.m_col3;
+    }
+  };
+
+  /// \brief Returns false if the sphere is completely outside of at least one frustum plane.
+  EZ_FORCE_INLINE bool SphereFrustumIntersect(const ezSimdBSphere& sphere, const FrustumPlaneData& planeData)
+  {
+    ezSimdVec4f pos_xxxx(sphere.m_CenterAndRadius.x());
+    ezSimdVec4f pos_yyyy(sphere.m_CenterAndRadius.y());
+    ezSimdVec4f pos_zzzz(sphere.m_CenterAndRadius.z());
+    ezSimdVec4f pos_rrrr(sphere.m_CenterAndRadius.w());
+
+    ezSimdVec4f dot_0123;
+    dot_0123 = ezSimdVec4f::MulAdd(pos_xxxx, planeData.m_x0x1x2x3, planeData.m_w0w1w2w3);
+    dot_0123 = ezSimdVec4f::MulAdd(pos_yyyy, planeData.m_y0y1y2y3, dot_0123);
+    dot_0123 = ezSimdVec4f::MulAdd(pos_zzzz, planeData.m_z0z1z2z3, dot_0123);
+
+    ezSimdVec4f dot_4545;
+    dot_4545 = ezSimdVec4f::MulAdd(pos_xxxx, planeData.m_x4x5x4x5, planeData.m_w4w5w4w5);
+    dot_4545 = ezSimdVec4f::MulAdd(pos_yyyy, planeData.m_y4y5y4y5, dot_4545);
+    dot_4545 = ezSimdVec4f::MulAdd(pos_zzzz, planeData.m_z4z5z4z5, dot_4545);
+
+    ezSimdVec4b cmp_0123 = dot_0123 > pos_rrrr;
+    ezSimdVec4b cmp_4545 = dot_4545 > pos_rrrr;
+    return (cmp_0123 || cmp_4545).NoneSet<4>();
+  }
+
+  /// \brief Tests two spheres at once. Bit 0 of the result is set if sphereA intersects, bit 1 if sphereB intersects.
+  EZ_FORCE_INLINE ezUInt32 SphereFrustumIntersect(const ezSimdBSphere& sphereA, const ezSimdBSphere& sphereB, const FrustumPlaneData& planeData)
+  {
+    ezSimdVec4f posA_xxxx(sphereA.m_CenterAndRadius.x());
+    ezSimdVec4f posA_yyyy(sphereA.m_CenterAndRadius.y());
+    ezSimdVec4f posA_zzzz(sphereA.m_CenterAndRadius.z());
+    ezSimdVec4f posA_rrrr(sphereA.m_CenterAndRadius.w());
+
+    ezSimdVec4f dotA_0123;
+    dotA_0123 = ezSimdVec4f::MulAdd(posA_xxxx, planeData.m_x0x1x2x3, planeData.m_w0w1w2w3);
+    dotA_0123 = ezSimdVec4f::MulAdd(posA_yyyy, planeData.m_y0y1y2y3, dotA_0123);
+    dotA_0123 = ezSimdVec4f::MulAdd(posA_zzzz, planeData.m_z0z1z2z3, dotA_0123);
+
+    ezSimdVec4f posB_xxxx(sphereB.m_CenterAndRadius.x());
+    ezSimdVec4f posB_yyyy(sphereB.m_CenterAndRadius.y());
+    ezSimdVec4f posB_zzzz(sphereB.m_CenterAndRadius.z());
+    ezSimdVec4f posB_rrrr(sphereB.m_CenterAndRadius.w());
+
+    ezSimdVec4f dotB_0123;
+    dotB_0123 = ezSimdVec4f::MulAdd(posB_xxxx, planeData.m_x0x1x2x3, planeData.m_w0w1w2w3);
+    dotB_0123 = ezSimdVec4f::MulAdd(posB_yyyy, planeData.m_y0y1y2y3, dotB_0123);
+    dotB_0123 = ezSimdVec4f::MulAdd(posB_zzzz, planeData.m_z0z1z2z3, dotB_0123);
+
+    ezSimdVec4f posAB_xxxx = posA_xxxx.GetCombined<ezSwizzle::XXXX>(posB_xxxx);
+    ezSimdVec4f posAB_yyyy = posA_yyyy.GetCombined<ezSwizzle::XXXX>(posB_yyyy);
+    ezSimdVec4f posAB_zzzz = posA_zzzz.GetCombined<ezSwizzle::XXXX>(posB_zzzz);
+    ezSimdVec4f posAB_rrrr = posA_rrrr.GetCombined<ezSwizzle::XXXX>(posB_rrrr);
+
+    ezSimdVec4f dot_A45B45;
+    dot_A45B45 = ezSimdVec4f::MulAdd(posAB_xxxx, planeData.m_x4x5x4x5, planeData.m_w4w5w4w5);
+    dot_A45B45 = ezSimdVec4f::MulAdd(posAB_yyyy, planeData.m_y4y5y4y5, dot_A45B45);
+    dot_A45B45 = ezSimdVec4f::MulAdd(posAB_zzzz, planeData.m_z4z5z4z5, dot_A45B45);
+
+    ezSimdVec4b cmp_A0123 = dotA_0123 > posA_rrrr;
+    ezSimdVec4b cmp_B0123 = dotB_0123 > posB_rrrr;
+    ezSimdVec4b cmp_A45B45 = dot_A45B45 > posAB_rrrr;
+
+    ezSimdVec4b cmp_A45 = cmp_A45B45.Get<ezSwizzle::XYXY>();
+    ezSimdVec4b cmp_B45 = cmp_A45B45.Get<ezSwizzle::ZWZW>();
+
+    ezUInt32 result = (cmp_A0123 || cmp_A45).NoneSet<4>() ? 1 : 0;
+    result |= (cmp_B0123 || cmp_B45).NoneSet<4>() ? 2 : 0;
+
+    return result;
+  }
+
+  EZ_ALWAYS_INLINE ezUInt32 ToPlaneMask(const ezSimdVec4b& b0123, const ezSimdVec4b& b4545)
+  {
+    return (b0123.x() ? EZ_BIT(0) : 0) | (b0123.y() ? EZ_BIT(1) : 0) | (b0123.z() ? EZ_BIT(2) : 0) | (b0123.w() ? EZ_BIT(3) : 0) |
+           (b4545.x() ? EZ_BIT(4) : 0) | (b4545.y() ? EZ_BIT(5) : 0);
+  }
+
+  /// \brief Returns false if the sphere is completely outside of at least one frustum plane.
+  /// Otherwise bit i of out_uiInsideMask is set for every plane i that the sphere is completely inside of.
+  EZ_FORCE_INLINE bool SphereFrustumClassify(const ezSimdBSphere& sphere, const FrustumPlaneData& planeData, ezUInt32& out_uiInsideMask)
+  {
+    ezSimdVec4f pos_xxxx(sphere.m_CenterAndRadius.x());
+    ezSimdVec4f pos_yyyy(sphere.m_CenterAndRadius.y());
+    ezSimdVec4f pos_zzzz(sphere.m_CenterAndRadius.z());
+    ezSimdVec4f pos_rrrr(sphere.m_CenterAndRadius.w());
+
+    ezSimdVec4f dot_0123;
+    dot_0123 = ezSimdVec4f::MulAdd(pos_xxxx, planeData.m_x0x1x2x3, planeData.m_w0w1w2w3);
+    dot_0123 = ezSimdVec4f::MulAdd(pos_yyyy, planeData.m_y0y1y2y3, dot_0123);
+    dot_0123 = ezSimdVec4f::MulAdd(pos_zzzz, planeData.m_z0z1z2z3, dot_0123);
+
+    ezSimdVec4f dot_4545;
+    dot_4545 = ezSimdVec4f::MulAdd(pos_xxxx, planeData.m_x4x5x4x5, planeData.m_w4w5w4w5);
+    dot_4545 = ezSimdVec4f::MulAdd(pos_yyyy, planeData.m_y4y5y4y5, dot_4545);
+    dot_4545 = ezSimdVec4f::MulAdd(pos_zzzz, planeData.m_z4z5z4z5, dot_4545);
+
+    if ((dot_0123 > pos_rrrr || dot_4545 > pos_rrrr).AnySet<4>())
+      return false;
+
+    out_uiInsideMask = ToPlaneMask(dot_0123 < -pos_rrrr, dot_4545 < -pos_rrrr);
+    return true;
+  }
+
+  /// \brief Returns a mask with bit i set for every plane i that is not exactly the same in both frustums.
+  EZ_FORCE_INLINE ezUInt32 GetChangedPlanesMask(const FrustumPlaneData& a, const FrustumPlaneData& b)
+  {
+    ezSimdVec4b equal_0123 = (a.m_x0x1x2x3 == b.m_x0x1x2x3) && (a.m_y0y1y2y3 == b.m_y0y1y2y3) && (a.m_z0z1z2z3 == b.m_z0z1z2z3) && (a.m_w0w1w2w3 == b.m_w0w1w2w3);
+    ezSimdVec4b equal_4545 = (a.m_x4x5x4x5 == b.m_x4x5x4x5) && (a.m_y4y5y4y5 == b.m_y4y5y4y5) && (a.m_z4z5z4z5 == b.m_z4z5z4z5) && (a.m_w4w5w4w5 == b.m_w4w5w4w5);
+
+    return ToPlaneMask(!equal_0123, !equal_4545);
+  }
+} // namespace ezInternal
@@ -0,0 +1,710 @@
+#include <CorePCH.h>
+
+#include <Core/World/Implementation/SpatialSystemHelper.h>
+#include <Core/World/SpatialSystem_LooseOctree.h>
+#include <Foundation/SimdMath/SimdConversion.h>
+#include <Foundation/Threading/TaskSystem.h>
+
+namespace
+{
+  enum
+  {
+    // smaller batches are not worth the overhead of the parallel update
+    MIN_PARALLEL_BATCH_SIZE = 256
+  };
+
+  EZ_ALWAYS_INLINE ezUInt32 GetLaneMask(const ezSimdVec4b& b)
+  {
+    return (b.x() ? 1u : 0u) | (b.y() ? 2u : 0u) | (b.z() ? 4u : 0u) | (b.w() ? 8u : 0u);
+  }
+
+  // The children of a node are indexed with the x side in bit 0, the y side in bit 1 and the z side in bit 2.
+  // So the children 0-3 and 4-7 share the same x and y offsets and only differ in z, which allows to test them in two groups of 4.
+  EZ_ALWAYS_INLINE ezSimdVec4f GetChildOffsetsX() { return ezSimdVec4f(-1.0f, 1.0f, -1.0f, 1.0f); }
+  EZ_ALWAYS_INLINE ezSimdVec4f GetChildOffsetsY() { return ezSimdVec4f(-1.0f, -1.0f, 1.0f, 1.0f); }
+
+  struct FrustumPlanes4
+  {
+    void SetFrustum(const ezFrustum& frustum)
+    {
+      for (ezUInt32 i = 0; i < ezFrustum::PLANE_COUNT; ++i)
+      {
+        const ezPlane& plane = frustum.GetPlane(i);
+        m_NormalX[i] = ezSimdVec4f(plane.m_vNormal.x);
+        m_NormalY[i] = ezSimdVec4f(plane.m_vNormal.y);
+        m_NormalZ[i] = ezSimdVec4f(plane.m_vNormal.z);
+        m_Distance[i] = ezSimdVec4f(plane.m_fNegDistance);
+        m_Extent[i] = ezSimdVec4f(ezMath::Abs(plane.m_vNormal.x) + ezMath::Abs(plane.m_vNormal.y) + ezMath::Abs(plane.m_vNormal.z));
+      }
+    }
+
+    /// \brief Tests 4 cubes with the same half size against the frustum. A lane is set if the cube is not completely outside of any plane.
+    EZ_FORCE_INLINE ezSimdVec4b Intersect(const ezSimdVec4f& x, const ezSimdVec4f& y, const ezSimdVec4f& z, const ezSimdFloat& fHalfSize) const
+    {
+      const ezSimdVec4f halfSize(fHalfSize);
+
+      ezSimdVec4b outside(false);
+      for (ezUInt32 i = 0; i < ezFrustum::PLANE_COUNT; ++i)
+      {
+        ezSimdVec4f dist = ezSimdVec4f::MulAdd(x, m_NormalX[i], m_Distance[i]);
+        dist = ezSimdVec4f::MulAdd(y, m_NormalY[i], dist);
+        dist = ezSimdVec4f::MulAdd(z, m_NormalZ[i], dist);
+
+        outside = outside || (dist > m_Extent[i].CompMul(halfSize));
+      }
+
+      return !outside;
+    }
+
+    ezSimdVec4f m_NormalX[ezFrustum::PLANE_COUNT];
+    ezSimdVec4f m_NormalY[ezFrustum::PLANE_COUNT];
+    ezSimdVec4f m_NormalZ[ezFrustum::PLANE_COUNT];
+    ezSimdVec4f m_Distance[ezFrustum::PLANE_COUNT];
+    ezSimdVec4f m_Extent[ezFrustum::PLANE_COUNT];
+  };
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////
+
+struct ezSpatialSystem_LooseOctree::SpatialUserData
+{
+  ezUInt32 m_uiNodeIndex = ezInvalidIndex;
+  ezUInt32 m_uiDataIndex = ezInvalidIndex;
+};
+
+//////////////////////////////////////////////////////////////////////////
+
+struct ezSpatialSystem_LooseOctree::Node
+{
+  EZ_DECLARE_MEM_RELOCATABLE_TYPE();
+
+  Node()
+  {
+    for (ezUInt32 i = 0; i < 8; ++i)
+    {
+      m_Children[i] = ezInvalidIndex;
+    }
+  }
+
+  EZ_ALWAYS_INLINE ezSimdBBox GetLooseBox() const
+  {
+    ezSimdBBox box;
+    box.SetCenterAndHalfExtents(m_CenterAndHalfSize, ezSimdVec4f(m_CenterAndHalfSize.w() * ezSimdFloat(2.0f)));
+    return box;
+  }
+
+  ezSimdVec4f m_CenterAndHalfSize; ///< Center and half size of the node's cell, the loose bounds are twice as large.
+  ezUInt32 m_Children[8];
+  ezUInt32 m_uiParent = ezInvalidIndex;
+  ezUInt32 m_uiDepth = 0;
+  ezUInt32 m_uiCategoryBitmask = 0;        ///< Categories of the objects in this node. Only reset once the node is empty.
+  ezUInt32 m_uiSubtreeCategoryBitmask = 0; ///< Categories of the objects in this node and all its children. Only reset once the node is freed.
+  ezUInt32 m_uiChildMask = 0;
+
+  ezDynamicArray<ezSimdBSphere, ezAlignedAllocatorWrapper> m_BoundingSpheres;
+  ezDynamicArray<ezSpatialData*> m_DataPointers;
+  ezDynamicArray<ezUInt32> m_CategoryBitmasks;
+};
+
+//////////////////////////////////////////////////////////////////////////
+
+// clang-format off
+EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezSpatialSystem_LooseOctree, 1, ezRTTINoAllocator)
+EZ_END_DYNAMIC_REFLECTED_TYPE;
+// clang-format on
+
+ezSpatialSystem_LooseOctree::ezSpatialSystem_LooseOctree(ezUInt32 uiWorldSize /*= 65536*/, ezUInt32 uiMinNodeSize /*= 16*/)
+  : m_AlignedAllocator("Spatial System Aligned", ezFoundation::GetAlignedAllocator())
+  , m_fRootHalfSize(uiWorldSize * 0.5f)
+  , m_Nodes(&m_AlignedAllocator)
+  , m_FreeNodes(&m_Allocator)
+  , m_UpdatedInPlace(&m_Allocator)
+{
+  EZ_CHECK_AT_COMPILETIME(sizeof(ezSpatialSystem_LooseOctree::SpatialUserData) <= sizeof(ezSpatialData::m_uiUserData));
+  EZ_ASSERT_DEV(uiMinNodeSize > 0 && uiMinNodeSize <= uiWorldSize, "Invalid min node size");
+
+  m_uiMaxDepth = 0;
+  for (ezUInt32 uiNodeSize = uiWorldSize; uiNodeSize / 2 >= uiMinNodeSize; uiNodeSize /= 2)
+  {
+    ++m_uiMaxDepth;
+  }
+
+  Node& root = m_Nodes.ExpandAndGetRef();
+  root.m_CenterAndHalfSize = ezSimdVec4f::ZeroVector();
+  root.m_CenterAndHalfSize.SetW(m_fRootHalfSize);
+}
+
+ezSpatialSystem_LooseOctree::~ezSpatialSystem_LooseOctree() = default;
+
+ezResult ezSpatialSystem_LooseOctree::GetNodeBoxForSpatialData(const ezSpatialDataHandle& hData, ezBoundingBox& out_BoundingBox) const
+{
+  ezSpatialData* pData;
+  if (!m_DataTable.TryGetValue(hData.GetInternalID(), pData))
+    return EZ_FAILURE;
+
+  auto pUserData = reinterpret_cast<SpatialUserData*>(&pData->m_uiUserData[0]);
+  if (pUserData->m_uiNodeIndex != ezInvalidIndex)
+  {
+    out_BoundingBox = ezSimdConversion::ToBBox(m_Nodes[pUserData->m_uiNodeIndex].GetLooseBox());
+    return EZ_SUCCESS;
+  }
+
+  return EZ_FAILURE;
+}
+
+void ezSpatialSystem_LooseOctree::GetAllNodeBoxes(ezHybridArray<ezBoundingBox, 16>& out_BoundingBoxes, ezSpatialData::Category filterCategory) const
+{
+  for (const Node& node : m_Nodes)
+  {
+    if (node.m_DataPointers.IsEmpty())
+      continue;
+
+    if (filterCategory == ezInvalidSpatialDataCategory || (node.m_uiCategoryBitmask & filterCategory.GetBitmask()) != 0)
+    {
+      out_BoundingBoxes.ExpandAndGetRef() = ezSimdConversion::ToBBox(node.GetLooseBox());
+    }
+  }
+}
+
+void ezSpatialSystem_LooseOctree::FindObjectsInSphereInternal(
+  const ezBoundingSphere& sphere, ezUInt32 uiCategoryBitmask, QueryCallback callback, QueryStats* pStats) const
+{
+  ezSimdBSphere simdSphere(ezSimdConversion::ToVec3(sphere.m_vCenter), sphere.m_fRadius);
+
+  const ezSimdVec4f sphereX(simdSphere.m_CenterAndRadius.x());
+  const ezSimdVec4f sphereY(simdSphere.m_CenterAndRadius.y());
+  const ezSimdVec4f sphereZ(simdSphere.m_CenterAndRadius.z());
+  const ezSimdVec4f sphereRadiusSquared(simdSphere.m_CenterAndRadius.w() * simdSphere.m_CenterAndRadius.w());
+
+  TraverseNodes(
+    uiCategoryBitmask,
+    [&](const ezSimdVec4f& x, const ezSimdVec4f& y, const ezSimdVec4f& z, const ezSimdFloat& fHalfSize) {
+      const ezSimdVec4f halfSize(fHalfSize);
+      const ezSimdVec4f dx = ((x - sphereX).Abs() - halfSize).CompMax(ezSimdVec4f::ZeroVector());
+      const ezSimdVec4f dy = ((y - sphereY).Abs() - halfSize).CompMax(ezSimdVec4f::ZeroVector());
+      const ezSimdVec4f dz = ((z - sphereZ).Abs() - halfSize).CompMax(ezSimdVec4f::ZeroVector());
+
+      ezSimdVec4f distSquared = dx.CompMul(dx);
+      distSquared = ezSimdVec4f::MulAdd(dy, dy, distSquared);
+      distSquared = ezSimdVec4f::MulAdd(dz, dz, distSquared);
+
+      return distSquared <= sphereRadiusSquared;
+    },
+    [&](const Node& node) {
+      if ((node.m_uiCategoryBitmask & uiCategoryBitmask) == 0)
+        return ezVisitorExecution::Continue;
+
+      const ezUInt32 uiNumObjects = node.m_BoundingSpheres.GetCount();
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+      if (pStats != nullptr)
+      {
+        pStats->m_uiNumObjectsTested += uiNumObjects;
+      }
+#endif
+
+      for (ezUInt32 i = 0; i < uiNumObjects; ++i)
+      {
+        if ((node.m_CategoryBitmasks[i] & uiCategoryBitmask) == 0 || !simdSphere.Overlaps(node.m_BoundingSpheres[i]))
+          continue;
+
+        if (callback(node.m_DataPointers[i]->m_pObject) == ezVisitorExecution::Stop)
+          return ezVisitorExecution::Stop;
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+        if (pStats != nullptr)
+        {
+          pStats->m_uiNumObjectsPassed++;
+        }
+#endif
+      }
+
+      return ezVisitorExecution::Continue;
+    });
+}
+
+void ezSpatialSystem_LooseOctree::FindObjectsInBoxInternal(
+  const ezBoundingBox& box, ezUInt32 uiCategoryBitmask, QueryCallback callback, QueryStats* pStats) const
+{
+  ezSimdBBox simdBox(ezSimdConversion::ToVec3(box.m_vMin), ezSimdConversion::ToVec3(box.m_vMax));
+
+  const ezSimdVec4f boxCenter = simdBox.GetCenter();
+  const ezSimdVec4f boxHalfExtents = simdBox.GetHalfExtents();
+
+  const ezSimdVec4f boxX(boxCenter.x());
+  const ezSimdVec4f boxY(boxCenter.y());
+  const ezSimdVec4f boxZ(boxCenter.z());
+
+  TraverseNodes(
+    uiCategoryBitmask,
+    [&](const ezSimdVec4f& x, const ezSimdVec4f& y, const ezSimdVec4f& z, const ezSimdFloat& fHalfSize) {
+      const ezSimdVec4b overlapX = (x - boxX).Abs() <= ezSimdVec4f(boxHalfExtents.x() + fHalfSize);
+      const ezSimdVec4b overlapY = (y - boxY).Abs() <= ezSimdVec4f(boxHalfExtents.y() + fHalfSize);
+      const ezSimdVec4b overlapZ = (z - boxZ).Abs() <= ezSimdVec4f(boxHalfExtents.z() + fHalfSize);
+
+      return overlapX && overlapY && overlapZ;
+    },
+    [&](const Node& node) {
+      if ((node.m_uiCategoryBitmask & uiCategoryBitmask) == 0)
+        return ezVisitorExecution::Continue;
+
+      const ezUInt32 uiNumObjects = node.m_BoundingSpheres.GetCount();
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+      if (pStats != nullptr)
+      {
+        pStats->m_uiNumObjectsTested += uiNumObjects;
+      }
+#endif
+
+      for (ezUInt32 i = 0; i < uiNumObjects; ++i)
+      {
+        if ((node.m_CategoryBitmasks[i] & uiCategoryBitmask) == 0 || !simdBox.Overlaps(node.m_BoundingSpheres[i]))
+          continue;
+
+        const ezSpatialData* pData = node.m_DataPointers[i];
+        if (!simdBox.Overlaps(pData->m_Bounds.GetBox()))
+          continue;
+
+        if (callback(pData->m_pObject) == ezVisitorExecution::Stop)
+          return ezVisitorExecution::Stop;
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+        if (pStats != nullptr)
+        {
+          pStats->m_uiNumObjectsPassed++;
+        }
+#endif
+      }
+
+      return ezVisitorExecution::Continue;
+    });
+}
+
+void ezSpatialSystem_LooseOctree::FindVisibleObjectsInternal(const ezFrustum& frustum, ezUInt32 uiCategoryBitmask,
+  ezDynamicArray<const ezGameObject*>& out_Objects, QueryStats* pStats, IsOccludedCallback isOccludedCallback, VisibilityCache* pCache) const
+{
+  FrustumPlanes4 nodePlanes;
+  nodePlanes.SetFrustum(frustum);
+
+  ezInternal::FrustumPlaneData planeData;
+  planeData.SetFrustum(frustum);
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+  ezUInt32 uiNumObjectsTested = 0;
+  ezUInt32 uiNumObjectsPassed = 0;
+  ezUInt32 uiNumObjectsOccluded = 0;
+#endif
+
+  TraverseNodes(
+    uiCategoryBitmask,
+    [&](const ezSimdVec4f& x, const ezSimdVec4f& y, const ezSimdVec4f& z, const ezSimdFloat& fHalfSize) {
+      return nodePlanes.Intersect(x, y, z, fHalfSize);
+    },
+    [&](const Node& node) {
+      // The loose bounds of a node contain the bounds of all objects in its subtree. The root node is never tested since it is infinitely large.
+      if (isOccludedCallback.IsValid() && node.m_uiParent != ezInvalidIndex && isOccludedCallback(node.GetLooseBox()))
+        return ezVisitorExecution::Skip;
+
+      if ((node.m_uiCategoryBitmask & uiCategoryBitmask) == 0)
+        return ezVisitorExecution::Continue;
+
+      const ezUInt32 uiNumObjects = node.m_BoundingSpheres.GetCount();
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+      uiNumObjectsTested += uiNumObjects;
+#endif
+
+      auto AddObject = [&](ezUInt32 uiIndex) {
+        if ((node.m_CategoryBitmasks[uiIndex] & uiCategoryBitmask) == 0)
+          return;
+
+        const ezSpatialData* pData = node.m_DataPointers[uiIndex];
+        if (isOccludedCallback.IsValid() && isOccludedCallback(pData->m_Bounds.GetBox()))
+        {
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+          uiNumObjectsOccluded++;
+#endif
+          return;
+        }
+
+        out_Objects.PushBack(pData->m_pObject);
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+        uiNumObjectsPassed++;
+#endif
+      };
+
+      ezUInt32 i = 0;
+      for (; i + 1 < uiNumObjects; i += 2)
+      {
+        ezUInt32 mask = ezInternal::SphereFrustumIntersect(node.m_BoundingSpheres[i], node.m_BoundingSpheres[i + 1], planeData);
+        while (mask > 0)
+        {
+          AddObject(i + ezMath::FirstBitLow(mask));
+          mask &= mask - 1;
+        }
+      }
+
+      if (i < uiNumObjects && ezInternal::SphereFrustumIntersect(node.m_BoundingSpheres[i], planeData))
+      {
+        AddObject(i);
+      }
+
+      return ezVisitorExecution::Continue;
+    });
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+  if (pStats != nullptr)
+  {
+    pStats->m_uiNumObjectsTested = uiNumObjectsTested;
+    pStats->m_uiNumObjectsPassed = uiNumObjectsPassed;
+    pStats->m_uiNumObjectsOccluded = uiNumObjectsOccluded;
+  }
+#endif
+}
+
+void ezSpatialSystem_LooseOctree::SpatialDataAdded(ezSpatialData* pData)
+{
+  AddToNode(GetOrCreateNode(pData->m_Bounds, 0), pData);
+}
+
+void ezSpatialSystem_LooseOctree::SpatialDataRemoved(ezSpatialData* pData)
+{
+  auto pUserData = reinterpret_cast<SpatialUserData*>(&pData->m_uiUserData[0]);
+  if (pUserData->m_uiNodeIndex != ezInvalidIndex)
+  {
+    RemoveFromNode(pUserData->m_uiNodeIndex, pUserData->m_uiDataIndex);
+
+    pUserData->m_uiNodeIndex = ezInvalidIndex;
+    pUserData->m_uiDataIndex = ezInvalidIndex;
+  }
+}
+
+void ezSpatialSystem_LooseOctree::SpatialDataChanged(ezSpatialData* pData, const ezSimdBBoxSphere& oldBounds, ezUInt32 uiOldCategoryBitmask)
+{
+  auto pUserData = reinterpret_cast<SpatialUserData*>(&pData->m_uiUserData[0]);
+  const ezUInt32 uiNodeIndex = pUserData->m_uiNodeIndex;
+
+  if (uiNodeIndex != ezInvalidIndex && pData->m_uiCategoryBitmask != 0 && IsInNodeBounds(m_Nodes[uiNodeIndex], pData->m_Bounds))
+  {
+    Node& node = m_Nodes[uiNodeIndex];
+    node.m_BoundingSpheres[pUserData->m_uiDataIndex] = pData->m_Bounds.GetSphere();
+
+    if (pData->m_uiCategoryBitmask != uiOldCategoryBitmask)
+    {
+      node.m_CategoryBitmasks[pUserData->m_uiDataIndex] = pData->m_uiCategoryBitmask;
+      node.m_uiCategoryBitmask |= pData->m_uiCategoryBitmask;
+
+      AddSubtreeCategories(uiNodeIndex, pData->m_uiCategoryBitmask);
+    }
+
+    return;
+  }
+
+  if (uiNodeIndex == ezInvalidIndex)
+  {
+    if (pData->m_uiCategoryBitmask != 0)
+    {
+      SpatialDataAdded(pData);
+    }
+
+    return;
+  }
+
+  const ezUInt32 uiDataIndex = pUserData->m_uiDataIndex;
+  pUserData->m_uiNodeIndex = ezInvalidIndex;
+  pUserData->m_uiDataIndex = ezInvalidIndex;
+
+  // Objects usually only move a little, so the search for the new node starts at the old one.
+  // The object is added before it is removed from the old node, otherwise the new node might already have been freed.
+  if (pData->m_uiCategoryBitmask != 0)
+  {
+    AddToNode(GetOrCreateNode(pData->m_Bounds, uiNodeIndex), pData);
+  }
+
+  RemoveFromNode(uiNodeIndex, uiDataIndex);
+}
+
+void ezSpatialSystem_LooseOctree::SpatialDataChangedBatch(ezArrayPtr<const ChangedSpatialData> changes)
+{
+  if (changes.GetCount() < MIN_PARALLEL_BATCH_SIZE)
+  {
+    SUPER::SpatialDataChangedBatch(changes);
+    return;
+  }
+
+  const ezUInt32 uiNumChanges = changes.GetCount();
+  m_UpdatedInPlace.SetCountUninitialized(uiNumChanges);
+
+  ezParallelForParams params;
+  params.uiBinSize = 64;
+  params.bAdaptiveGranularity = true;
+
+  // Objects that stay inside the loose bounds of their node only need their bounding spheres rewritten.
+  // Every object only writes its own entry, so this can be done in parallel. Everything else is done afterwards.
+  ezTaskSystem::ParallelForIndexed(
+    0, uiNumChanges,
+    [&](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+      for (ezUInt32 i = uiStartIndex; i < uiEndIndex; ++i)
+      {
+        const ChangedSpatialData& change = changes[i];
+        ezSpatialData* pData = change.m_pData;
+        auto pUserData = reinterpret_cast<SpatialUserData*>(&pData->m_uiUserData[0]);
+
+        m_UpdatedInPlace[i] = 0;
+
+        if (pData->m_uiCategoryBitmask != change.m_uiOldCategoryBitmask || pUserData->m_uiNodeIndex == ezInvalidIndex)
+          continue;
+
+        Node& node = m_Nodes[pUserData->m_uiNodeIndex];
+        if (IsInNodeBounds(node, pData->m_Bounds))
+        {
+          node.m_BoundingSpheres[pUserData->m_uiDataIndex] = pData->m_Bounds.GetSphere();
+          m_UpdatedInPlace[i] = 1;
+        }
+      }
+    },
+    "SpatialSystem UpdateInPlace", params);
+
+  for (ezUInt32 i = 0; i < uiNumChanges; ++i)
+  {
+    if (m_UpdatedInPlace[i] == 0)
+    {
+      const ChangedSpatialData& change = changes[i];
+      SpatialDataChanged(change.m_pData, change.m_OldBounds, change.m_uiOldCategoryBitmask);
+    }
+  }
+}
+
+void ezSpatialSystem_LooseOctree::FixSpatialDataPointer(ezSpatialData* pOldPtr, ezSpatialData* pNewPtr)
+{
+  auto pUserData = reinterpret_cast<SpatialUserData*>(&pNewPtr->m_uiUserData[0]);
+  if (pUserData->m_uiNodeIndex != ezInvalidIndex)
+  {
+    m_Nodes[pUserData->m_uiNodeIndex].m_DataPointers[pUserData->m_uiDataIndex] = pNewPtr;
+  }
+}
+
+template <typename NodeFilter, typename NodeFunctor>
+EZ_FORCE_INLINE void ezSpatialSystem_LooseOctree::TraverseNodes(ezUInt32 uiCategoryBitmask, NodeFilter nodeFilter, NodeFunctor nodeFunc) const
+{
+  // The root node is always visited since it also contains all objects outside of the octree.
+  if ((m_Nodes[0].m_uiSubtreeCategoryBitmask & uiCategoryBitmask) == 0)
+    return;
+
+  ezHybridArray<ezUInt32, 64> nodeStack;
+  nodeStack.PushBack(0);
+
+  while (!nodeStack.IsEmpty())
+  {
+    const Node& node = m_Nodes[nodeStack.PeekBack()];
+    nodeStack.PopBack();
+
+    const ezVisitorExecution::Enum result = nodeFunc(node);
+    if (result == ezVisitorExecution::Stop)
+      return;
+
+    if (result == ezVisitorExecution::Skip || node.m_uiChildMask == 0)
+      continue;
+
+    // The cells of the children are half as large as the cell of this node, so their loose bounds have the half size of this node.
+    const ezSimdFloat fLooseHalfSize = node.m_CenterAndHalfSize.w();
+    const ezSimdFloat fChildHalfSize = fLooseHalfSize * ezSimdFloat(0.5f);
+
+    const ezSimdVec4f x = ezSimdVec4f::MulAdd(GetChildOffsetsX(), ezSimdVec4f(fChildHalfSize), ezSimdVec4f(node.m_CenterAndHalfSize.x()));
+    const ezSimdVec4f y = ezSimdVec4f::MulAdd(GetChildOffsetsY(), ezSimdVec4f(fChildHalfSize), ezSimdVec4f(node.m_CenterAndHalfSize.y()));
+    const ezSimdVec4f zLow(node.m_CenterAndHalfSize.z() - fChildHalfSize);
+    const ezSimdVec4f zHigh(node.m_CenterAndHalfSize.z() + fChildHalfSize);
+
+    ezUInt32 uiChildMask = GetLaneMask(nodeFilter(x, y, zLow, fLooseHalfSize));
+    uiChildMask |= GetLaneMask(nodeFilter(x, y, zHigh, fLooseHalfSize)) << 4;
+    uiChildMask &= node.m_uiChildMask;
+
+    while (uiChildMask > 0)
+    {
+      const ezUInt32 uiChildNodeIndex = node.m_Children[ezMath::FirstBitLow(uiChildMask)];
+      uiChildMask &= uiChildMask - 1;
+
+      if ((m_Nodes[uiChildNodeIndex].m_uiSubtreeCategoryBitmask & uiCategoryBitmask) != 0)
+      {
+        nodeStack.PushBack(uiChildNodeIndex);
+      }
+    }
+  }
+}
+
+ezUInt32 ezSpatialSystem_LooseOctree::FindTargetNodeDepth(const ezSimdBBoxSphere& bounds) const
+{
+  // objects outside of the root cell can't be put into any child
+  if (!(bounds.m_CenterAndRadius.Abs() <= ezSimdVec4f(m_fRootHalfSize)).AllSet<3>())
+    return 0;
+
+  const ezSimdFloat fRadius = bounds.m_CenterAndRadius.w();
+
+  // The bounding sphere of an object fits into the loose bounds of a node if its center is inside the node's cell
+  // and its radius is not larger than half the cell size.
+  ezSimdFloat fChildHalfSize = m_fRootHalfSize * ezSimdFloat(0.5f);
+  ezUInt32 uiDepth = 0;
+  while (uiDepth < m_uiMaxDepth && fChildHalfSize >= fRadius)
+  {
+    fChildHalfSize = fChildHalfSize * ezSimdFloat(0.5f);
+    ++uiDepth;
+  }
+
+  return uiDepth;
+}
+
+bool ezSpatialSystem_LooseOctree::IsInNodeBounds(const Node& node, const ezSimdBBoxSphere& bounds) const
+{
+  if (node.m_uiParent == ezInvalidIndex)
+  {
+    return FindTargetNodeDepth(bounds) == 0;
+  }
+
+  // Queries only test the objects' bounding spheres, so the whole sphere has to be inside the loose bounds.
+  const ezSimdVec4f distance = (bounds.m_CenterAndRadius - node.m_CenterAndHalfSize).Abs() + ezSimdVec4f(bounds.m_CenterAndRadius.w());
+  return (distance <= ezSimdVec4f(node.m_CenterAndHalfSize.w() * ezSimdFloat(2.0f))).AllSet<3>();
+}
+
+ezUInt32 ezSpatialSystem_LooseOctree::GetOrCreateNode(const ezSimdBBoxSphere& bounds, ezUInt32 uiStartNodeIndex)
+{
+  const ezUInt32 uiTargetDepth = FindTargetNodeDepth(bounds);
+
+  // go up until the cell of the node contains the object's center, from there on the object is sorted into the children as usual
+  ezUInt32 uiNodeIndex = uiStartNodeIndex;
+  while (uiNodeIndex != 0)
+  {
+    const Node& node = m_Nodes[uiNodeIndex];
+    if (node.m_uiDepth <= uiTargetDepth && ((bounds.m_CenterAndRadius - node.m_CenterAndHalfSize).Abs() <= ezSimdVec4f(node.m_CenterAndHalfSize.w())).AllSet<3>())
+      break;
+
+    uiNodeIndex = node.m_uiParent;
+  }
+
+  for (ezUInt32 uiDepth = m_Nodes[uiNodeIndex].m_uiDepth; uiDepth < uiTargetDepth; ++uiDepth)
+  {
+    const Node& node = m_Nodes[uiNodeIndex];
+    const ezUInt32 uiChildIndex = GetLaneMask(bounds.m_CenterAndRadius >= node.m_CenterAndHalfSize) & 7;
+
+    ezUInt32 uiChildNodeIndex = node.m_Children[uiChildIndex];
+    if (uiChildNodeIndex == ezInvalidIndex)
+    {
+      uiChildNodeIndex = AllocateNode(uiNodeIndex, uiChildIndex);
+    }
+
+    uiNodeIndex = uiChildNodeIndex;
+  }
+
+  return uiNodeIndex;
+}
+
+ezUInt32 ezSpatialSystem_LooseOctree::AllocateNode(ezUInt32 uiParent, ezUInt32 uiChildIndex)
+{
+  ezUInt32 uiNodeIndex;
+  if (!m_FreeNodes.IsEmpty())
+  {
+    uiNodeIndex = m_FreeNodes.PeekBack();
+    m_FreeNodes.PopBack();
+  }
+  else
+  {
+    uiNodeIndex = m_Nodes.GetCount();
+    m_Nodes.ExpandAndGetRef();
+  }
+
+  Node& parent = m_Nodes[uiParent];
+  parent.m_Children[uiChildIndex] = uiNodeIndex;
+  parent.m_uiChildMask |= EZ_BIT(uiChildIndex);
+
+  const ezSimdFloat fHalfSize = parent.m_CenterAndHalfSize.w() * ezSimdFloat(0.5f);
+  const ezSimdVec4f offset((uiChildIndex & 1) ? 1.0f : -1.0f, (uiChildIndex & 2) ? 1.0f : -1.0f, (uiChildIndex & 4) ? 1.0f : -1.0f);
+
+  Node& node = m_Nodes[uiNodeIndex];
+  node.m_CenterAndHalfSize = ezSimdVec4f::MulAdd(offset, ezSimdVec4f(fHalfSize), parent.m_CenterAndHalfSize);
+  node.m_CenterAndHalfSize.SetW(fHalfSize);
+  node.m_uiParent = uiParent;
+  node.m_uiDepth = parent.m_uiDepth + 1;
+
+  return uiNodeIndex;
+}
+
+void ezSpatialSystem_LooseOctree::AddToNode(ezUInt32 uiNodeIndex, ezSpatialData* pData)
+{
+  Node& node = m_Nodes[uiNodeIndex];
+
+  auto pUserData = reinterpret_cast<SpatialUserData*>(&pData->m_uiUserData[0]);
+  EZ_ASSERT_DEBUG(pUserData->m_uiNodeIndex == ezInvalidIndex, "Data can't be in multiple nodes");
+  pUserData->m_uiNodeIndex = uiNodeIndex;
+  pUserData->m_uiDataIndex = node.m_DataPointers.GetCount();
+
+  node.m_BoundingSpheres.PushBack(pData->m_Bounds.GetSphere());
+  node.m_DataPointers.PushBack(pData);
+  node.m_CategoryBitmasks.PushBack(pData->m_uiCategoryBitmask);
+  node.m_uiCategoryBitmask |= pData->m_uiCategoryBitmask;
+
+  AddSubtreeCategories(uiNodeIndex, pData->m_uiCategoryBitmask);
+}
+
+void ezSpatialSystem_LooseOctree::AddSubtreeCategories(ezUInt32 uiNodeIndex, ezUInt32 uiCategoryBitmask)
+{
+  // The subtree categories of a node always include the ones of its children, so we can stop at the first node that has them already.
+  while (uiNodeIndex != ezInvalidIndex)
+  {
+    Node& node = m_Nodes[uiNodeIndex];
+    if ((node.m_uiSubtreeCategoryBitmask & uiCategoryBitmask) == uiCategoryBitmask)
+      break;
+
+    node.m_uiSubtreeCategoryBitmask |= uiCategoryBitmask;
+    uiNodeIndex = node.m_uiParent;
+  }
+}
+
+void ezSpatialSystem_LooseOctree::RemoveFromNode(ezUInt32 uiNodeIndex, ezUInt32 uiDataIndex)
+{
+  Node& node = m_Nodes[uiNodeIndex];
+
+  if (uiDataIndex != node.m_DataPointers.GetCount() - 1)
+  {
+    ezSpatialData* pLastData = node.m_DataPointers.PeekBack();
+    reinterpret_cast<SpatialUserData*>(&pLastData->m_uiUserData[0])->m_uiDataIndex = uiDataIndex;
+  }
+
+  node.m_BoundingSpheres.RemoveAtAndSwap(uiDataIndex);
+  node.m_DataPointers.RemoveAtAndSwap(uiDataIndex);
+  node.m_CategoryBitmasks.RemoveAtAndSwap(uiDataIndex);
+
+  if (!node.m_DataPointers.IsEmpty())
+    return;
+
+  node.m_uiCategoryBitmask = 0;
+
+  // Nodes without objects and children are unlinked from their parents, the root node is never freed.
+  while (uiNodeIndex != 0)
+  {
+    Node& emptyNode = m_Nodes[uiNodeIndex];
+    if (!emptyNode.m_DataPointers.IsEmpty() || emptyNode.m_uiChildMask != 0)
+      break;
+
+    const ezUInt32 uiParent = emptyNode.m_uiParent;
+    Node& parent = m_Nodes[uiParent];
+    for (ezUInt32 i = 0; i < 8; ++i)
+    {
+      if (parent.m_Children[i] == uiNodeIndex)
+      {
+        parent.m_Children[i] = ezInvalidIndex;
+        parent.m_uiChildMask &= ~EZ_BIT(i);
+        break;
+      }
+    }
+
+    emptyNode.m_uiParent = ezInvalidIndex;
+    emptyNode.m_uiCategoryBitmask = 0;
+    emptyNode.m_uiSubtreeCategoryBitmask = 0;
+    m_FreeNodes.PushBack(uiNodeIndex);
+
+    uiNodeIndex = uiParent;
+  }
+}
+
+EZ_STATICLINK_FILE(Core, Core_World_Implementation_SpatialSystem_LooseOctree);
@@ -1,15 +1,33 @@
 #include <CorePCH.h>
 
+#include <Core/World/Implementation/SpatialSystemHelper.h>
 #include <Core/World/SpatialSystem_RegularGrid.h>
 #include <Foundation/Containers/HashSet.h>
 #include <Foundation/SimdMath/SimdConversion.h>
+#include <Foundation/Threading/TaskSystem.h>
 
 namespace
 {
   enum
   {
     MAX_CELL_INDEX = (1 << 20) - 1,
-    CELL_INDEX_MASK = (1 << 21) - 1
+    CELL_INDEX_MASK = (1 << 21) - 1,
+
+    // smaller batches are not worth the overhead of the parallel update
+    MIN_PARALLEL_BATCH_SIZE = 256
+  };
+
+  // cell keys only use 63 bits
+  static constexpr ezUInt64 s_uiOverflowCellKey = 0xFFFFFFFFFFFFFFFFull;
+
+  struct ChangeType
+  {
+    enum Enum : ezUInt8
+    {
+      UpdatedInPlace,
+      MoveToOtherCell,
+      CategoryChanged
+    };
   };
 
   EZ_ALWAYS_INLINE ezSimdVec4f ToVec3(const ezSimdVec4i& v) { return v.ToFloat(); }
@@ -39,86 +57,6 @@ namespace
 
     return ezSimdBBox(bmin, bmax);
   }
-
-  struct PlaneData
-  {
-    ezSimdVec4f m_x0x1x2x3;
-    ezSimdVec4f m_y0y1y2y3;
-    ezSimdVec4f m_z0z1z2z3;
-    ezSimdVec4f m_w0w1w2w3;
-
-    ezSimdVec4f m_x4x5x4x5;
-    ezSimdVec4f m_y4y5y4y5;
-    ezSimdVec4f m_z4z5z4z5;
-    ezSimdVec4f m_w4w5w4w5;
-  };
-
-  EZ_FORCE_INLINE bool SphereFrustumIntersect(const ezSimdBSphere& sphere, const PlaneData& planeData)
-  {
-    ezSimdVec4f pos_xxxx(sphere.m_CenterAndRadius.x());
-    ezSimdVec4f pos_yyyy(sphere.m_CenterAndRadius.y());
-    ezSimdVec4f pos_zzzz(sphere.m_CenterAndRadius.z());
-    ezSimdVec4f pos_rrrr(sphere.m_CenterAndRadius.w());
-
-    ezSimdVec4f dot_0123;
-    dot_0123 = ezSimdVec4f::MulAdd(pos_xxxx, planeData.m_x0x1x2x3, planeData.m_w0w1w2w3);
-    dot_0123 = ezSimdVec4f::MulAdd(pos_yyyy, planeData.m_y0y1y2y3, dot_0123);
-    dot_0123 = ezSimdVec4f::MulAdd(pos_zzzz, planeData.m_z0z1z2z3, dot_0123);
-
-    ezSimdVec4f dot_4545;
-    dot_4545 = ezSimdVec4f::MulAdd(pos_xxxx, planeData.m_x4x5x4x5, planeData.m_w4w5w4w5);
-    dot_4545 = ezSimdVec4f::MulAdd(pos_yyyy, planeData.m_y4y5y4y5, dot_4545);
-    dot_4545 = ezSimdVec4f::MulAdd(pos_zzzz, planeData.m_z4z5z4z5, dot_4545);
-
-    ezSimdVec4b cmp_0123 = dot_0123 > pos_rrrr;
-    ezSimdVec4b cmp_4545 = dot_4545 > pos_rrrr;
-    return (cmp_0123 || cmp_4545).NoneSet<4>();
-  }
-
-  EZ_FORCE_INLINE ezUInt32 SphereFrustumIntersect(const ezSimdBSphere& sphereA, const ezSimdBSphere& sphereB, const PlaneData& planeData)
-  {
-    ezSimdVec4f posA_xxxx(sphereA.m_CenterAndRadius.x());
-    ezSimdVec4f posA_yyyy(sphereA.m_CenterAndRadius.y());
-    ezSimdVec4f posA_zzzz(sphereA.m_CenterAndRadius.z());
-    ezSimdVec4f posA_rrrr(sphereA.m_CenterAndRadius.w());
-
-    ezSimdVec4f dotA_0123;
-    dotA_0123 = ezSimdVec4f::MulAdd(posA_xxxx, planeData.m_x0x1x2x3, planeData.m_w0w1w2w3);
-    dotA_0123 = ezSimdVec4f::MulAdd(posA_yyyy, planeData.m_y0y1y2y3, dotA_0123);
-    dotA_0123 = ezSimdVec4f::MulAdd(posA_zzzz, planeData.m_z0z1z2z3, dotA_0123);
-
-    ezSimdVec4f posB_xxxx(sphereB.m_CenterAndRadius.x());
-    ezSimdVec4f posB_yyyy(sphereB.m_CenterAndRadius.y());
-    ezSimdVec4f posB_zzzz(sphereB.m_CenterAndRadius.z());
-    ezSimdVec4f posB_rrrr(sphereB.m_CenterAndRadius.w());
-
-    ezSimdVec4f dotB_0123;
-    dotB_0123 = ezSimdVec4f::MulAdd(posB_xxxx, planeData.m_x0x1x2x3, planeData.m_w0w1w2w3);
-    dotB_0123 = ezSimdVec4f::MulAdd(posB_yyyy, planeData.m_y0y1y2y3, dotB_0123);
-    dotB_0123 = ezSimdVec4f::MulAdd(posB_zzzz, planeData.m_z0z1z2z3, dotB_0123);
-
-    ezSimdVec4f posAB_xxxx = posA_xxxx.GetCombined<ezSwizzle::XXXX>(posB_xxxx);
-    ezSimdVec4f posAB_yyyy = posA_yyyy.GetCombined<ezSwizzle::XXXX>(posB_yyyy);
-    ezSimdVec4f posAB_zzzz = posA_zzzz.GetCombined<ezSwizzle::XXXX>(posB_zzzz);
-    ezSimdVec4f posAB_rrrr = posA_rrrr.GetCombined<ezSwizzle::XXXX>(posB_rrrr);
-
-    ezSimdVec4f dot_A45B45;
-    dot_A45B45 = ezSimdVec4f::MulAdd(posAB_xxxx, planeData.m_x4x5x4x5, planeData.m_w4w5w4w5);
-    dot_A45B45 = ezSimdVec4f::MulAdd(posAB_yyyy, planeData.m_y4y5y4y5, dot_A45B45);
-    dot_A45B45 = ezSimdVec4f::MulAdd(posAB_zzzz, planeData.m_z4z5z4z5, dot_A45B45);
-
-    ezSimdVec4b cmp_A0123 = dotA_0123 > posA_rrrr;
-    ezSimdVec4b cmp_B0123 = dotB_0123 > posB_rrrr;
-    ezSimdVec4b cmp_A45B45 = dot_A45B45 > posAB_rrrr;
-
-    ezSimdVec4b cmp_A45 = cmp_A45B45.Get<ezSwizzle::XYXY>();
-    ezSimdVec4b cmp_B45 = cmp_A45B45.Get<ezSwizzle::ZWZW>();
-
-    ezUInt32 result = (cmp_A0123 || cmp_A45).NoneSet<4>() ? 1 : 0;
-    result |= (cmp_B0123 || cmp_B45).NoneSet<4>() ? 2 : 0;
-
-    return result;
-  }
 } // namespace
 
 //////////////////////////////////////////////////////////////////////////
@@ -185,6 +123,7 @@ struct ezSpatialSystem_RegularGrid::Cell
     }
 
     m_uiCategoryBitmask |= pData->m_uiCategoryBitmask;
+    ++m_uiVersion;
   }
 
   EZ_FORCE_INLINE void RemoveData(ezSpatialData* pData)
@@ -240,8 +179,11 @@ struct ezSpatialSystem_RegularGrid::Cell
       m_BoundingSpheres[category].RemoveAtAndSwap(dataIndex);
       m_DataPointers[category].RemoveAtAndSwap(dataIndex);
     }
+
+    ++m_uiVersion;
   }
 
+  /// \brief Does not increment m_uiVersion since it is called in parallel for objects in the same cell. The caller has to take care of that.
   EZ_FORCE_INLINE void UpdateData(ezSpatialData* pData)
   {
     ezUInt32 mask = pData->m_uiCategoryBitmask;
@@ -269,7 +211,9 @@ struct ezSpatialSystem_RegularGrid::Cell
   EZ_ALWAYS_INLINE ezBoundingBox GetBoundingBox() const { return ezSimdConversion::ToBBoxSphere(m_Bounds).GetBox(); }
 
   ezSimdBBoxSphere m_Bounds;
+  ezUInt64 m_uiKey = s_uiOverflowCellKey;
   ezUInt32 m_uiCategoryBitmask = 0;
+  ezUInt32 m_uiVersion = 0; ///< Changes whenever an object in this cell is added, removed or changed. Invalidates cached visibility results.
 
   ezHybridArray<ezDynamicArray<ezSimdBSphere>, 4> m_BoundingSpheres;
   ezHybridArray<ezDynamicArray<ezSpatialData*>, 4> m_DataPointers;
@@ -291,6 +235,48 @@ struct ezSpatialSystem_RegularGrid::CellKeyHashHelper
 
 //////////////////////////////////////////////////////////////////////////
 
+struct ezSpatialSystem_RegularGrid::CellMove
+{
+  EZ_DECLARE_POD_TYPE();
+
+  ezSpatialData* m_pData;
+  Cell* m_pOldCell;
+  Cell* m_pNewCell;
+  ezUInt32 m_uiOrder; ///< Index in the batch, keeps the order inside of a cell independent of the cell addresses.
+};
+
+//////////////////////////////////////////////////////////////////////////
+
+struct ezSpatialSystem_RegularGrid::CachedCell
+{
+  ezSimdBSphere m_ContentSphere; ///< Encloses the bounding spheres of all objects in the cell that match m_uiCategoryBitmask.
+  const Cell* m_pCell;
+  ezUInt32 m_uiCellVersion;
+  ezUInt32 m_uiCategoryBitmask;
+  ezUInt32 m_uiInsidePlanesMask; ///< The frustum planes that m_ContentSphere was completely inside of.
+  ezUInt32 m_uiFirstObject;
+  ezUInt32 m_uiNumObjects;
+};
+
+/// \brief Stores the objects of every visited cell that passed the frustum test, before the occlusion test.
+///
+/// The results of a cell can be reused as long as the cell didn't change and each frustum plane that moved since the last query had
+/// all objects of the cell completely inside of it, before and after the move. Everything is double buffered, the results of the current
+/// query are written while the previous ones are read.
+class ezSpatialSystem_RegularGrid::GridVisibilityCache : public ezSpatialSystem::VisibilityCache
+{
+public:
+  ezInternal::FrustumPlaneData m_PlaneData;
+  bool m_bHasPlaneData = false;
+
+  ezUInt32 m_uiCurrent = 0;
+  ezHashTable<const Cell*, ezUInt32> m_CellToCachedCell[2];
+  ezDynamicArray<CachedCell, ezAlignedAllocatorWrapper> m_CachedCells[2];
+  ezDynamicArray<const ezSpatialData*> m_Objects[2];
+};
+
+//////////////////////////////////////////////////////////////////////////
+
 EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezSpatialSystem_RegularGrid, 1, ezRTTINoAllocator)
 EZ_END_DYNAMIC_REFLECTED_TYPE;
 
@@ -299,6 +285,9 @@ ezSpatialSystem_RegularGrid::ezSpatialSystem_RegularGrid(ezUInt32 uiCellSize /*
   , m_iCellSize(uiCellSize)
   , m_fOverlapSize(uiCellSize / 4.0f)
   , m_fInvCellSize(1.0f / uiCellSize)
+  , m_ChangeTypes(&m_Allocator)
+  , m_CellMoves(&m_Allocator)
+  , m_CellMoveGroups(&m_Allocator)
 {
   EZ_CHECK_AT_COMPILETIME(sizeof(ezSpatialSystem_RegularGrid::SpatialUserData) <= sizeof(ezSpatialData::m_uiUserData));
 
@@ -443,8 +432,8 @@ void ezSpatialSystem_RegularGrid::FindObjectsInBoxInternal(
     });
 }
 
-void ezSpatialSystem_RegularGrid::FindVisibleObjectsInternal(
-  const ezFrustum& frustum, ezUInt32 uiCategoryBitmask, ezDynamicArray<const ezGameObject*>& out_Objects, QueryStats* pStats) const
+void ezSpatialSystem_RegularGrid::FindVisibleObjectsInternal(const ezFrustum& frustum, ezUInt32 uiCategoryBitmask,
+  ezDynamicArray<const ezGameObject*>& out_Objects, QueryStats* pStats, IsOccludedCallback isOccludedCallback, VisibilityCache* pCache) const
 {
   ezVec3 cornerPoints[8];
   frustum.ComputeCornerPoints(cornerPoints);
@@ -458,43 +447,135 @@ void ezSpatialSystem_RegularGrid::FindVisibleObjectsInternal(
   ezSimdBBox simdBox;
   simdBox.SetFromPoints(simdCornerPoints, 8);
 
-  PlaneData planeData;
+  ezInternal::FrustumPlaneData planeData;
+  planeData.SetFrustum(frustum);
+
+  GridVisibilityCache* pGridCache = static_cast<GridVisibilityCache*>(pCache);
+  const ezHashTable<const Cell*, ezUInt32>* pPrevCellToCachedCell = nullptr;
+  const CachedCell* pPrevCachedCells = nullptr;
+  const ezSpatialData* const* pPrevObjects = nullptr;
+  ezDynamicArray<CachedCell, ezAlignedAllocatorWrapper>* pCachedCells = nullptr;
+  ezDynamicArray<const ezSpatialData*>* pCachedObjects = nullptr;
+  ezUInt32 uiChangedPlanesMask = 0;
+
+  if (pGridCache != nullptr)
   {
-    // Compiler is too stupid to properly unroll a constant loop so we do it by hand
-    ezSimdVec4f plane0 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(0).m_vNormal.x)));
-    ezSimdVec4f plane1 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(1).m_vNormal.x)));
-    ezSimdVec4f plane2 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(2).m_vNormal.x)));
-    ezSimdVec4f plane3 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(3).m_vNormal.x)));
-    ezSimdVec4f plane4 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(4).m_vNormal.x)));
-    ezSimdVec4f plane5 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(5).m_vNormal.x)));
-
-    ezSimdMat4f helperMat;
-    helperMat.SetRows(plane0, plane1, plane2, plane3);
-
-    planeData.m_x0x1x2x3 = helperMat.m_col0;
-    planeData.m_y0y1y2y3 = helperMat.m_col1;
-    planeData.m_z0z1z2z3 = helperMat.m_col2;
-    planeData.m_w0w1w2w3 = helperMat.m_col3;
-
-    helperMat.SetRows(plane4, plane5, plane4, plane5);
-
-    planeData.m_x4x5x4x5 = helperMat.m_col0;
-    planeData.m_y4y5y4y5 = helperMat.m_col1;
-    planeData.m_z4z5z4z5 = helperMat.m_col2;
-    planeData.m_w4w5w4w5 = helperMat.m_col3;
+    const ezUInt32 uiPrev = pGridCache->m_uiCurrent;
+    const ezUInt32 uiCurrent = 1 - uiPrev;
+    pGridCache->m_uiCurrent = uiCurrent;
+
+    pPrevCellToCachedCell = &pGridCache->m_CellToCachedCell[uiPrev];
+    pPrevCachedCells = pGridCache->m_CachedCells[uiPrev].GetData();
+    pPrevObjects = pGridCache->m_Objects[uiPrev].GetData();
+
+    pGridCache->m_CellToCachedCell[uiCurrent].Clear();
+    pCachedCells = &pGridCache->m_CachedCells[uiCurrent];
+    pCachedCells->Clear();
+    pCachedObjects = &pGridCache->m_Objects[uiCurrent];
+    pCachedObjects->Clear();
+
+    uiChangedPlanesMask = pGridCache->m_bHasPlaneData ? ezInternal::GetChangedPlanesMask(pGridCache->m_PlaneData, planeData) : 0x3F;
+    pGridCache->m_PlaneData = planeData;
+    pGridCache->m_bHasPlaneData = true;
   }
 
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
   ezUInt32 uiNumObjectsTested = 0;
   ezUInt32 uiNumObjectsPassed = 0;
+  ezUInt32 uiNumObjectsOccluded = 0;
+  ezUInt32 uiNumObjectsCached = 0;
 #endif
 
+  auto AddObject = [&](const ezSpatialData* pData) {
+    if (isOccludedCallback.IsValid() && isOccludedCallback(pData->m_Bounds.GetBox()))
+    {
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+      uiNumObjectsOccluded++;
+#endif
+      return;
+    }
+
+    out_Objects.PushBack(pData->m_pObject);
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+    uiNumObjectsPassed++;
+#endif
+  };
+
+  auto AddTestedObject = [&](const ezSpatialData* pData) {
+    if (pCachedObjects != nullptr)
+    {
+      pCachedObjects->PushBack(pData);
+    }
+
+    AddObject(pData);
+  };
+
   ForEachCellInBox(
     simdBox, uiCategoryBitmask, [&](const ezSimdVec4i& cellIndex, ezUInt64 cellKey, const Cell& cell, ezUInt32 uiFilteredCategoryBitmask) {
       ezSimdBSphere cellSphere = cell.m_Bounds.GetSphere();
-      if (!SphereFrustumIntersect(cellSphere, planeData))
+      if (!ezInternal::SphereFrustumIntersect(cellSphere, planeData))
         return;
 
+      // the cell box contains the boxes of all its objects
+      if (isOccludedCallback.IsValid() && isOccludedCallback(cell.m_Bounds.GetBox()))
+        return;
+
+      CachedCell* pCachedCell = nullptr;
+      ezSimdBBox contentBox;
+
+      if (pGridCache != nullptr)
+      {
+        ezUInt32 uiPrevIndex;
+        if (pPrevCellToCachedCell->TryGetValue(&cell, uiPrevIndex))
+        {
+          const CachedCell& prevCachedCell = pPrevCachedCells[uiPrevIndex];
+
+          ezUInt32 uiInsidePlanesMask = 0;
+          if (prevCachedCell.m_uiCellVersion == cell.m_uiVersion && prevCachedCell.m_uiCategoryBitmask == uiFilteredCategoryBitmask)
+          {
+            const bool bIntersects = ezInternal::SphereFrustumClassify(prevCachedCell.m_ContentSphere, planeData, uiInsidePlanesMask);
+
+            // Nothing in the cell can have changed its visibility if all planes that moved had all objects completely inside of them.
+            if (!bIntersects || (uiChangedPlanesMask & ~(prevCachedCell.m_uiInsidePlanesMask & uiInsidePlanesMask)) == 0)
+            {
+              const ezUInt32 uiFirstObject = pCachedObjects->GetCount();
+              const ezUInt32 uiNumObjects = bIntersects ? prevCachedCell.m_uiNumObjects : 0;
+
+              pCachedObjects->PushBackRange(ezMakeArrayPtr(pPrevObjects + prevCachedCell.m_uiFirstObject, uiNumObjects));
+
+              for (ezUInt32 i = 0; i < uiNumObjects; ++i)
+              {
+                AddObject((*pCachedObjects)[uiFirstObject + i]);
+              }
+
+              CachedCell& cachedCell = pCachedCells->ExpandAndGetRef();
+              cachedCell = prevCachedCell;
+              cachedCell.m_uiInsidePlanesMask = uiInsidePlanesMask;
+              cachedCell.m_uiFirstObject = uiFirstObject;
+              cachedCell.m_uiNumObjects = uiNumObjects;
+
+              pGridCache->m_CellToCachedCell[pGridCache->m_uiCurrent].Insert(&cell, pCachedCells->GetCount() - 1);
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+              uiNumObjectsCached += uiNumObjects;
+#endif
+              return;
+            }
+          }
+        }
+
+        pCachedCell = &pCachedCells->ExpandAndGetRef();
+        pCachedCell->m_pCell = &cell;
+        pCachedCell->m_uiCellVersion = cell.m_uiVersion;
+        pCachedCell->m_uiCategoryBitmask = uiFilteredCategoryBitmask;
+        pCachedCell->m_uiFirstObject = pCachedObjects->GetCount();
+
+        pGridCache->m_CellToCachedCell[pGridCache->m_uiCurrent].Insert(&cell, pCachedCells->GetCount() - 1);
+
+        contentBox.SetInvalid();
+      }
+
       ezUInt32 filteredMask = uiFilteredCategoryBitmask;
       while (filteredMask > 0)
       {
@@ -509,6 +590,18 @@ void ezSpatialSystem_RegularGrid::FindVisibleObjectsInternal(
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
         uiNumObjectsTested += numSpheres;
 #endif
+
+        if (pCachedCell != nullptr)
+        {
+          for (ezUInt32 i = 0; i < numSpheres; ++i)
+          {
+            const ezSimdVec4f& centerAndRadius = boundingSpheres[i].m_CenterAndRadius;
+            const ezSimdVec4f radius = centerAndRadius.Get<ezSwizzle::WWWW>();
+            contentBox.ExpandToInclude(centerAndRadius - radius);
+            contentBox.ExpandToInclude(centerAndRadius + radius);
+          }
+        }
+
         ezUInt32 currentIndex = 0;
 
         while (currentIndex < numSpheres)
@@ -522,7 +615,7 @@ void ezSpatialSystem_RegularGrid::FindVisibleObjectsInternal(
               auto& objectSphereA = boundingSpheres[currentIndex + i + 0];
               auto& objectSphereB = boundingSpheres[currentIndex + i + 1];
 
-              mask |= SphereFrustumIntersect(objectSphereA, objectSphereB, planeData) << i;
+              mask |= ezInternal::SphereFrustumIntersect(objectSphereA, objectSphereB, planeData) << i;
             }
 
             while (mask > 0)
@@ -530,12 +623,7 @@ void ezSpatialSystem_RegularGrid::FindVisibleObjectsInternal(
               ezUInt32 i = ezMath::FirstBitLow(mask);
               mask &= mask - 1;
 
-              ezSpatialData* pData = dataPointers[currentIndex + i];
-              out_Objects.PushBack(pData->m_pObject);
-
-#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
-              uiNumObjectsPassed++;
-#endif
+              AddTestedObject(dataPointers[currentIndex + i]);
             }
 
             currentIndex += 32;
@@ -546,18 +634,24 @@ void ezSpatialSystem_RegularGrid::FindVisibleObjectsInternal(
             ++currentIndex;
 
             auto& objectSphere = boundingSpheres[i];
-            if (!SphereFrustumIntersect(objectSphere, planeData))
+            if (!ezInternal::SphereFrustumIntersect(objectSphere, planeData))
               continue;
 
-            ezSpatialData* pData = dataPointers[i];
-            out_Objects.PushBack(pData->m_pObject);
-
-#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
-            uiNumObjectsPassed++;
-#endif
+            AddTestedObject(dataPointers[i]);
           }
         }
       }
+
+      if (pCachedCell != nullptr)
+      {
+        pCachedCell->m_uiNumObjects = pCachedObjects->GetCount() - pCachedCell->m_uiFirstObject;
+
+        ezSimdVec4f vHalfExtents = contentBox.GetHalfExtents();
+        pCachedCell->m_ContentSphere = ezSimdBSphere(contentBox.GetCenter(), vHalfExtents.GetLength<3>());
+
+        pCachedCell->m_uiInsidePlanesMask = 0;
+        ezInternal::SphereFrustumClassify(pCachedCell->m_ContentSphere, planeData, pCachedCell->m_uiInsidePlanesMask);
+      }
     });
 
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
@@ -565,10 +659,18 @@ void ezSpatialSystem_RegularGrid::FindVisibleObjectsInternal(
   {
     pStats->m_uiNumObjectsTested = uiNumObjectsTested;
     pStats->m_uiNumObjectsPassed = uiNumObjectsPassed;
+    pStats->m_uiNumObjectsOccluded = uiNumObjectsOccluded;
+    pStats->m_uiNumObjectsCached = uiNumObjectsCached;
   }
 #endif
 }
 
+ezUniquePtr<ezSpatialSystem::VisibilityCache> ezSpatialSystem_RegularGrid::CreateVisibilityCacheInternal() const
+{
+  // the cache is owned by the view and may outlive the spatial system, so it must not use any of its allocators
+  return EZ_NEW(ezFoundation::GetAlignedAllocator(), GridVisibilityCache);
+}
+
 void ezSpatialSystem_RegularGrid::SpatialDataAdded(ezSpatialData* pData)
 {
   Cell* pCell = GetOrCreateCell(pData->m_Bounds);
@@ -594,6 +696,7 @@ void ezSpatialSystem_RegularGrid::SpatialDataChanged(ezSpatialData* pData, const
     if (pOldCell->m_Bounds.GetBox().Contains(pData->m_Bounds.GetBox()))
     {
       pOldCell->UpdateData(pData);
+      ++pOldCell->m_uiVersion;
     }
     else
     {
@@ -601,6 +704,7 @@ void ezSpatialSystem_RegularGrid::SpatialDataChanged(ezSpatialData* pData, const
       if (pOldCell == pNewCell)
       {
         pOldCell->UpdateData(pData);
+        ++pOldCell->m_uiVersion;
       }
       else
       {
@@ -626,6 +730,128 @@ void ezSpatialSystem_RegularGrid::SpatialDataChanged(ezSpatialData* pData, const
   }
 }
 
+void ezSpatialSystem_RegularGrid::SpatialDataChangedBatch(ezArrayPtr<const ChangedSpatialData> changes)
+{
+  if (changes.GetCount() < MIN_PARALLEL_BATCH_SIZE)
+  {
+    SUPER::SpatialDataChangedBatch(changes);
+    return;
+  }
+
+  const ezUInt32 uiNumChanges = changes.GetCount();
+  m_ChangeTypes.SetCountUninitialized(uiNumChanges);
+
+  ezParallelForParams params;
+  params.uiBinSize = 64;
+  params.bAdaptiveGranularity = true;
+
+  // Objects that stay in their cell only need their bounding spheres rewritten. Every object only writes its own entries,
+  // so this can be done in parallel. For all other objects only the type of change is recorded here.
+  ezTaskSystem::ParallelForIndexed(
+    0, uiNumChanges,
+    [&](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+      for (ezUInt32 i = uiStartIndex; i < uiEndIndex; ++i)
+      {
+        const ChangedSpatialData& change = changes[i];
+        ezSpatialData* pData = change.m_pData;
+
+        if (pData->m_uiCategoryBitmask != change.m_uiOldCategoryBitmask)
+        {
+          m_ChangeTypes[i] = ChangeType::CategoryChanged;
+          continue;
+        }
+
+        auto pUserData = reinterpret_cast<SpatialUserData*>(&pData->m_uiUserData[0]);
+        Cell* pOldCell = pUserData->m_pCell;
+
+        ezSimdBBox newCellBox;
+        if (pOldCell->m_Bounds.GetBox().Contains(pData->m_Bounds.GetBox()) || ComputeCellKey(pData->m_Bounds, newCellBox) == pOldCell->m_uiKey)
+        {
+          pOldCell->UpdateData(pData);
+          m_ChangeTypes[i] = ChangeType::UpdatedInPlace;
+        }
+        else
+        {
+          m_ChangeTypes[i] = ChangeType::MoveToOtherCell;
+        }
+      }
+    },
+    "SpatialSystem UpdateInPlace", params);
+
+  // Creating cells modifies the cell table, so the destination cells are looked up serially.
+  m_CellMoves.Clear();
+  for (ezUInt32 i = 0; i < uiNumChanges; ++i)
+  {
+    const ChangedSpatialData& change = changes[i];
+
+    if (m_ChangeTypes[i] == ChangeType::UpdatedInPlace)
+    {
+      auto pUserData = reinterpret_cast<SpatialUserData*>(&change.m_pData->m_uiUserData[0]);
+      ++pUserData->m_pCell->m_uiVersion;
+    }
+    else if (m_ChangeTypes[i] == ChangeType::MoveToOtherCell)
+    {
+      auto pUserData = reinterpret_cast<SpatialUserData*>(&change.m_pData->m_uiUserData[0]);
+
+      CellMove& move = m_CellMoves.ExpandAndGetRef();
+      move.m_pData = change.m_pData;
+      move.m_pOldCell = pUserData->m_pCell;
+      move.m_pNewCell = GetOrCreateCell(change.m_pData->m_Bounds);
+      move.m_uiOrder = i;
+    }
+    else if (m_ChangeTypes[i] == ChangeType::CategoryChanged)
+    {
+      SpatialDataChanged(change.m_pData, change.m_OldBounds, change.m_uiOldCategoryBitmask);
+    }
+  }
+
+  if (m_CellMoves.IsEmpty())
+    return;
+
+  // Every cell is only modified by one task at a time. First all objects are removed from their old cells, then added to their new ones.
+  auto ForEachCellInParallel = [&](Cell* CellMove::*pCellMember, const char* szTaskName, auto func) {
+    m_CellMoves.Sort([pCellMember](const CellMove& a, const CellMove& b) {
+      if (a.*pCellMember != b.*pCellMember)
+        return a.*pCellMember < b.*pCellMember;
+
+      return a.m_uiOrder < b.m_uiOrder;
+    });
+
+    m_CellMoveGroups.Clear();
+
+    ezUInt32 uiGroupStart = 0;
+    for (ezUInt32 i = 1; i <= m_CellMoves.GetCount(); ++i)
+    {
+      if (i == m_CellMoves.GetCount() || m_CellMoves[i].*pCellMember != m_CellMoves[uiGroupStart].*pCellMember)
+      {
+        m_CellMoveGroups.PushBack(m_CellMoves.GetArrayPtr().GetSubArray(uiGroupStart, i - uiGroupStart));
+        uiGroupStart = i;
+      }
+    }
+
+    ezParallelForParams groupParams;
+    groupParams.uiBinSize = 4;
+    groupParams.bAdaptiveGranularity = true;
+
+    ezTaskSystem::ParallelForSingle(m_CellMoveGroups.GetArrayPtr(), func, szTaskName, groupParams);
+  };
+
+  ForEachCellInParallel(&CellMove::m_pOldCell, "SpatialSystem RemoveFromCells", [](ezArrayPtr<CellMove> moves) {
+    for (const CellMove& move : moves)
+    {
+      move.m_pOldCell->RemoveData(move.m_pData);
+    }
+  });
+
+  ezAllocatorBase* pAlignedAllocator = &m_AlignedAllocator;
+  ForEachCellInParallel(&CellMove::m_pNewCell, "SpatialSystem AddToCells", [pAlignedAllocator](ezArrayPtr<CellMove> moves) {
+    for (const CellMove& move : moves)
+    {
+      move.m_pNewCell->AddData(move.m_pData, pAlignedAllocator);
+    }
+  });
+}
+
 void ezSpatialSystem_RegularGrid::FixSpatialDataPointer(ezSpatialData* pOldPtr, ezSpatialData* pNewPtr)
 {
   auto pUserData = reinterpret_cast<SpatialUserData*>(&pNewPtr->m_uiUserData[0]);
@@ -648,6 +874,11 @@ void ezSpatialSystem_RegularGrid::FixSpatialDataPointer(ezSpatialData* pOldPtr,
       EZ_ASSERT_NOT_IMPLEMENTED;
     }
   }
+
+  if (pCell != nullptr)
+  {
+    ++pCell->m_uiVersion;
+  }
 }
 
 template <typename Functor>
@@ -728,15 +959,26 @@ EZ_FORCE_INLINE void ezSpatialSystem_RegularGrid::ForEachCellInBox(const ezSimdB
 #endif
 }
 
-ezSpatialSystem_RegularGrid::Cell* ezSpatialSystem_RegularGrid::GetOrCreateCell(const ezSimdBBoxSphere& bounds)
+ezUInt64 ezSpatialSystem_RegularGrid::ComputeCellKey(const ezSimdBBoxSphere& bounds, ezSimdBBox& out_CellBox) const
 {
   ezSimdVec4i cellIndex = ToVec3I32(bounds.m_CenterAndRadius * m_fInvCellSize);
-  ezSimdBBox cellBox = ComputeCellBoundingBox(cellIndex, m_iCellSize);
+  out_CellBox = ComputeCellBoundingBox(cellIndex, m_iCellSize);
 
-  if (cellBox.Contains(bounds.GetBox()))
+  if (out_CellBox.Contains(bounds.GetBox()))
   {
-    ezUInt64 cellKey = GetCellKey(cellIndex.x(), cellIndex.y(), cellIndex.z());
+    return GetCellKey(cellIndex.x(), cellIndex.y(), cellIndex.z());
+  }
 
+  return s_uiOverflowCellKey;
+}
+
+ezSpatialSystem_RegularGrid::Cell* ezSpatialSystem_RegularGrid::GetOrCreateCell(const ezSimdBBoxSphere& bounds)
+{
+  ezSimdBBox cellBox;
+  const ezUInt64 cellKey = ComputeCellKey(bounds, cellBox);
+
+  if (cellKey != s_uiOverflowCellKey)
+  {
     if (auto ppCell = m_Cells.GetValue(cellKey))
     {
       return ppCell->Borrow();
@@ -744,6 +986,7 @@ ezSpatialSystem_RegularGrid::Cell* ezSpatialSystem_RegularGrid::GetOrCreateCell(
 
     ezUniquePtr<Cell> pNewCell = EZ_NEW(&m_AlignedAllocator, Cell, &m_Allocator);
     pNewCell->m_Bounds = cellBox;
+    pNewCell->m_uiKey = cellKey;
 
     Cell* pCell = pNewCell.Borrow();
     m_Cells.Insert(cellKey, std::move(pNewCell));
@@ -756,5 +999,4 @@ ezSpatialSystem_RegularGrid::Cell* ezSpatialSystem_RegularGrid::GetOrCreateCell(
   }
 }
 
-
 EZ_STATICLINK_FILE(Core, Core_World_Implementation_SpatialSystem_RegularGrid);
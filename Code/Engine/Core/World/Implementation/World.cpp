@@ -7,6 +7,7 @@
 #include <Core/World/WorldModule.h>
 #include <Foundation/Memory/FrameAllocator.h>
 #include <Foundation/Profiling/Profiling.h>
+#include <Foundation/Threading/TaskSystem.h>
 #include <Foundation/Utilities/Stats.h>
 
 ezStaticArray<ezWorld*, ezWorld::GetMaxNumWorlds()> ezWorld::s_Worlds;
@@ -141,15 +142,143 @@ ezGameObjectHandle ezWorld::CreateObject(const ezGameObjectDesc& desc, ezGameObj
   EZ_ASSERT_DEV(m_Data.m_Objects.GetCount() < GetMaxNumGameObjects(), "Max number of game objects reached: {}", GetMaxNumGameObjects());
 
   ezGameObject* pParentObject = nullptr;
-  ezGameObject::TransformationData* pParentData = nullptr;
-  ezUInt32 uiParentIndex = 0;
+  TryGetObject(desc.m_hParent, pParentObject);
+
+  out_pObject = CreateObjectInternal(desc, pParentObject);
+  return ezGameObjectHandle(out_pObject->m_InternalId);
+}
+
+void ezWorld::CreateObjects(ezArrayPtr<const ezGameObjectDesc> descs, ezArrayPtr<const ezUInt32> parentIndices, ezArrayPtr<ezGameObjectHandle> out_Handles,
+  ezArrayPtr<ezGameObject*> out_Objects /*= ezArrayPtr<ezGameObject*>()*/)
+{
+  CheckForWriteAccess();
+
+  const ezUInt32 uiNumObjects = descs.GetCount();
+
+  EZ_ASSERT_DEV(parentIndices.IsEmpty() || parentIndices.GetCount() == uiNumObjects, "Need one parent index per object");
+  EZ_ASSERT_DEV(out_Handles.IsEmpty() || out_Handles.GetCount() == uiNumObjects, "Need space for one handle per object");
+  EZ_ASSERT_DEV(out_Objects.IsEmpty() || out_Objects.GetCount() == uiNumObjects, "Need space for one object pointer per object");
+  EZ_ASSERT_DEV(m_Data.m_Objects.GetCount() + uiNumObjects <= GetMaxNumGameObjects(), "Max number of game objects reached: {}", GetMaxNumGameObjects());
+
+  if (uiNumObjects == 0)
+    return;
+
+  ezAllocatorBase* pTempAllocator = m_Data.m_StackAllocator.GetCurrentAllocator();
+
+  // all objects are created before any of them is initialized, so the pointers are needed even if the caller is not interested in them
+  ezDynamicArray<ezGameObject*> tempObjects(pTempAllocator);
+  if (out_Objects.IsEmpty())
+  {
+    tempObjects.SetCountUninitialized(uiNumObjects);
+    out_Objects = tempObjects;
+  }
+
+  struct NewObjectInfo
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezGameObject* m_pParentObject;
+    ezGameObject::TransformationData* m_pTransformationData;
+    ezUInt16 m_uiHierarchyLevel;
+    bool m_bDynamic;
+  };
+
+  ezDynamicArray<NewObjectInfo> newObjects(pTempAllocator);
+  newObjects.SetCountUninitialized(uiNumObjects);
+
+  // count the objects per hierarchy level of the static and the dynamic hierarchy, afterwards the counts are turned into offsets
+  ezHybridArray<ezUInt32, 16> numObjectsPerLevel[2] = {ezHybridArray<ezUInt32, 16>(pTempAllocator), ezHybridArray<ezUInt32, 16>(pTempAllocator)};
+
+  for (ezUInt32 i = 0; i < uiNumObjects; ++i)
+  {
+    const ezGameObjectDesc& desc = descs[i];
+    const ezUInt32 uiParentIndex = parentIndices.IsEmpty() ? ezInvalidIndex : parentIndices[i];
+
+    NewObjectInfo& info = newObjects[i];
+    info.m_pParentObject = nullptr;
+    info.m_bDynamic = desc.m_bDynamic;
+
+    ezUInt64 uiHierarchyLevel = 0;
+    if (uiParentIndex != ezInvalidIndex)
+    {
+      EZ_ASSERT_DEV(uiParentIndex < i, "The parent of object {} needs to come before it, got index {}", i, uiParentIndex);
+
+      const NewObjectInfo& parentInfo = newObjects[uiParentIndex];
+      uiHierarchyLevel = parentInfo.m_uiHierarchyLevel + 1;
+      info.m_bDynamic |= parentInfo.m_bDynamic;
+    }
+    else if (TryGetObject(desc.m_hParent, info.m_pParentObject))
+    {
+      uiHierarchyLevel = info.m_pParentObject->m_uiHierarchyLevel + 1;
+      info.m_bDynamic |= info.m_pParentObject->IsDynamic();
+    }
+
+    EZ_ASSERT_DEV(uiHierarchyLevel < GetMaxNumHierarchyLevels(), "Max hierarchy level reached: {}", GetMaxNumHierarchyLevels());
+    info.m_uiHierarchyLevel = static_cast<ezUInt16>(uiHierarchyLevel);
+
+    auto& numObjects = numObjectsPerLevel[info.m_bDynamic ? 1 : 0];
+    if (info.m_uiHierarchyLevel >= numObjects.GetCount())
+    {
+      numObjects.SetCount(info.m_uiHierarchyLevel + 1);
+    }
+
+    ++numObjects[info.m_uiHierarchyLevel];
+  }
+
+  // reserve the transformation data of each hierarchy level at once
+  ezDynamicArray<ezGameObject::TransformationData*> transformationData(pTempAllocator);
+  transformationData.SetCountUninitialized(uiNumObjects);
+
+  ezUInt32 uiDataOffset = 0;
+  for (ezUInt32 uiDynamic = 0; uiDynamic < 2; ++uiDynamic)
+  {
+    auto& numObjects = numObjectsPerLevel[uiDynamic];
+    for (ezUInt32 uiLevel = 0; uiLevel < numObjects.GetCount(); ++uiLevel)
+    {
+      const ezUInt32 uiNumInLevel = numObjects[uiLevel];
+      if (uiNumInLevel > 0)
+      {
+        m_Data.CreateTransformationData(uiDynamic != 0, uiLevel, transformationData.GetArrayPtr().GetSubArray(uiDataOffset, uiNumInLevel));
+      }
+
+      numObjects[uiLevel] = uiDataOffset;
+      uiDataOffset += uiNumInLevel;
+    }
+  }
+
+  for (NewObjectInfo& info : newObjects)
+  {
+    info.m_pTransformationData = transformationData[numObjectsPerLevel[info.m_bDynamic ? 1 : 0][info.m_uiHierarchyLevel]++];
+  }
+
+  // reserve the objects themselves
+  m_Data.m_ObjectStorage.Create(out_Objects);
+  m_Data.m_Objects.Reserve(m_Data.m_Objects.GetCount() + uiNumObjects);
+
+  for (ezUInt32 i = 0; i < uiNumObjects; ++i)
+  {
+    const NewObjectInfo& info = newObjects[i];
+    const ezUInt32 uiParentIndex = parentIndices.IsEmpty() ? ezInvalidIndex : parentIndices[i];
+
+    ezGameObject* pParentObject = uiParentIndex != ezInvalidIndex ? out_Objects[uiParentIndex] : info.m_pParentObject;
+    ezGameObject* pNewObject = out_Objects[i];
+
+    InitializeObject(descs[i], pParentObject, info.m_bDynamic, info.m_uiHierarchyLevel, pNewObject, info.m_pTransformationData);
+
+    if (!out_Handles.IsEmpty())
+    {
+      out_Handles[i] = ezGameObjectHandle(pNewObject->m_InternalId);
+    }
+  }
+}
+
+ezGameObject* ezWorld::CreateObjectInternal(const ezGameObjectDesc& desc, ezGameObject* pParentObject)
+{
   ezUInt64 uiHierarchyLevel = 0;
   bool bDynamic = desc.m_bDynamic;
 
-  if (TryGetObject(desc.m_hParent, pParentObject))
+  if (pParentObject != nullptr)
   {
-    pParentData = pParentObject->m_pTransformationData;
-    uiParentIndex = desc.m_hParent.m_InternalId.m_InstanceIndex;
     uiHierarchyLevel = pParentObject->m_uiHierarchyLevel + 1; // if there is a parent hierarchy level is parent level + 1
     EZ_ASSERT_DEV(uiHierarchyLevel < GetMaxNumHierarchyLevels(), "Max hierarchy level reached: {}", GetMaxNumHierarchyLevels());
     bDynamic |= pParentObject->IsDynamic();
@@ -161,6 +290,23 @@ ezGameObjectHandle ezWorld::CreateObject(const ezGameObjectDesc& desc, ezGameObj
   // get storage for the object itself
   ezGameObject* pNewObject = m_Data.m_ObjectStorage.Create();
 
+  InitializeObject(desc, pParentObject, bDynamic, static_cast<ezUInt16>(uiHierarchyLevel), pNewObject, pTransformationData);
+
+  return pNewObject;
+}
+
+void ezWorld::InitializeObject(const ezGameObjectDesc& desc, ezGameObject* pParentObject, bool bDynamic, ezUInt16 uiHierarchyLevel,
+  ezGameObject* pNewObject, ezGameObject::TransformationData* pTransformationData)
+{
+  ezGameObject::TransformationData* pParentData = nullptr;
+  ezUInt32 uiParentIndex = 0;
+
+  if (pParentObject != nullptr)
+  {
+    pParentData = pParentObject->m_pTransformationData;
+    uiParentIndex = pParentObject->m_InternalId.m_InstanceIndex;
+  }
+
   // insert the new object into the id mapping table
   ezGameObjectId newId = m_Data.m_Objects.Insert(pNewObject);
   newId.m_WorldIndex = static_cast<ezUInt8>(m_uiIndex);
@@ -176,7 +322,7 @@ ezGameObjectHandle ezWorld::CreateObject(const ezGameObjectDesc& desc, ezGameObj
   pNewObject->m_uiTeamID = desc.m_uiTeamID;
 
   static_assert((GetMaxNumHierarchyLevels() - 1) <= ezMath::MaxValue<ezUInt16>());
-  pNewObject->m_uiHierarchyLevel = static_cast<ezUInt16>(uiHierarchyLevel);
+  pNewObject->m_uiHierarchyLevel = uiHierarchyLevel;
 
   // fill out the transformation data
   pTransformationData->m_pObject = pNewObject;
@@ -233,9 +379,6 @@ ezGameObjectHandle ezWorld::CreateObject(const ezGameObjectDesc& desc, ezGameObj
   LinkToParent(pNewObject);
 
   pNewObject->UpdateActiveState(pParentObject == nullptr ? true : pParentObject->IsActive());
-
-  out_pObject = pNewObject;
-  return ezGameObjectHandle(newId);
 }
 
 void ezWorld::DeleteObjectNow(const ezGameObjectHandle& hObject)
@@ -660,6 +803,8 @@ void ezWorld::LinkToParent(ezGameObject* pObject)
 
     pObject->m_pTransformationData->m_pParentData = pParentObject->m_pTransformationData;
 
+    pParentObject->AddHandledMessages(pObject->GetHandledMessageMask());
+
     if (pParentObject->m_Flags.IsSet(ezObjectFlags::ChildChangesNotifications))
     {
       ezMsgChildrenChanged msg;
@@ -843,9 +988,10 @@ void ezWorld::ProcessQueuedMessages(ezObjectMsgQueueType::Enum queueType)
     ezInternal::WorldData::MessageQueue& queue = m_Data.m_MessageQueues[queueType];
     queue.Sort(MessageComparer());
 
-    for (ezUInt32 i = 0; i < queue.GetCount(); ++i)
+    // messages that are posted while processing the queue are appended and processed as well
+    for (ezUInt32 i = 0; i < queue.GetCount();)
     {
-      ProcessQueuedMessage(queue[i]);
+      i = ProcessQueuedMessages(queue, i, queue.GetCount());
 
       // no need to deallocate these messages, they are allocated through a frame allocator
     }
@@ -860,21 +1006,164 @@ void ezWorld::ProcessQueuedMessages(ezObjectMsgQueueType::Enum queueType)
 
     const ezTime now = m_Data.m_Clock.GetAccumulatedTime();
 
-    while (!queue.IsEmpty())
+    ezUInt32 uiNumDueMessages = 0;
+    while (uiNumDueMessages < queue.GetCount() && queue[uiNumDueMessages].m_MetaData.m_Due <= now)
     {
-      auto& entry = queue.Peek();
-      if (entry.m_MetaData.m_Due > now)
-        break;
+      ++uiNumDueMessages;
+    }
 
-      ProcessQueuedMessage(entry);
+    for (ezUInt32 i = 0; i < uiNumDueMessages;)
+    {
+      i = ProcessQueuedMessages(queue, i, uiNumDueMessages);
+    }
 
-      EZ_DELETE(&m_Data.m_Allocator, entry.m_pMessage);
+    for (ezUInt32 i = 0; i < uiNumDueMessages; ++i)
+    {
+      EZ_DELETE(&m_Data.m_Allocator, queue.Peek().m_pMessage);
 
       queue.Dequeue();
     }
   }
 }
 
+ezUInt32 ezWorld::ProcessQueuedMessages(ezInternal::WorldData::MessageQueue& queue, ezUInt32 uiStartIndex, ezUInt32 uiEndIndex)
+{
+  // Only consecutive messages that allow parallel delivery and have the same sorting key are delivered in parallel, so all messages with
+  // a smaller sorting key have been delivered before. Recursive messages also reach the children of the receiver and thus are never delivered in parallel.
+  const ezInt32 iSortingKey = queue[uiStartIndex].m_pMessage->GetSortingKey();
+
+  ezUInt32 uiRunEnd = uiStartIndex;
+  while (uiRunEnd < uiEndIndex)
+  {
+    const auto& entry = queue[uiRunEnd];
+    if (!entry.m_pMessage->CanBeDeliveredInParallel() || entry.m_MetaData.m_uiRecursive || entry.m_pMessage->GetSortingKey() != iSortingKey)
+      break;
+
+    ++uiRunEnd;
+  }
+
+  const ezUInt32 uiNumMessages = uiRunEnd - uiStartIndex;
+  if (uiNumMessages < 64)
+  {
+    uiRunEnd = ezMath::Max(uiRunEnd, uiStartIndex + 1);
+
+    for (ezUInt32 i = uiStartIndex; i < uiRunEnd; ++i)
+    {
+      ProcessQueuedMessage(queue[i]);
+    }
+
+    return uiRunEnd;
+  }
+
+  EZ_PROFILE_SCOPE("Deliver Messages In Parallel");
+
+  struct MessageToDeliver
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezMessage* m_pMessage;
+    ezGameObject* m_pReceiverObject;
+    ezComponent* m_pReceiverComponent;
+  };
+
+  // Messages are partitioned by their receiver object, messages for components go to the partition of the owner object.
+  // The partitions keep the order of the queue so messages for the same receiver are delivered in the same order as before.
+  const ezUInt32 uiNumPartitions = (ezTaskSystem::GetWorkerThreadCount(ezWorkerThreadType::ShortTasks) + 1) * 4;
+
+  ezDynamicArray<ezUInt32> partitionStart(m_Data.m_StackAllocator.GetCurrentAllocator());
+  partitionStart.SetCount(uiNumPartitions + 1);
+
+  ezDynamicArray<MessageToDeliver> resolvedMessages(m_Data.m_StackAllocator.GetCurrentAllocator());
+  resolvedMessages.SetCountUninitialized(uiNumMessages);
+
+  ezDynamicArray<ezUInt32> partitions(m_Data.m_StackAllocator.GetCurrentAllocator());
+  partitions.SetCountUninitialized(uiNumMessages);
+
+  // Receivers are resolved here since looking up components requires write access. Messages for receivers that do not exist anymore
+  // are handed to ProcessQueuedMessage directly, which only reports them.
+  ezUInt32 uiNumResolvedMessages = 0;
+  for (ezUInt32 i = uiStartIndex; i < uiRunEnd; ++i)
+  {
+    const auto& entry = queue[i];
+
+    MessageToDeliver& msg = resolvedMessages[uiNumResolvedMessages];
+    msg.m_pMessage = entry.m_pMessage;
+    msg.m_pReceiverObject = nullptr;
+    msg.m_pReceiverComponent = nullptr;
+
+    if (entry.m_MetaData.m_uiReceiverIsComponent)
+    {
+      if (TryGetComponent(ezComponentHandle(ezComponentId(entry.m_MetaData.m_uiReceiverObjectOrComponent)), msg.m_pReceiverComponent))
+      {
+        msg.m_pReceiverObject = msg.m_pReceiverComponent->GetOwner();
+      }
+    }
+    else
+    {
+      TryGetObject(ezGameObjectHandle(ezGameObjectId(entry.m_MetaData.m_uiReceiverObjectOrComponent)), msg.m_pReceiverObject);
+    }
+
+    if (msg.m_pReceiverObject == nullptr)
+    {
+      ProcessQueuedMessage(entry);
+      continue;
+    }
+
+    const ezUInt32 uiPartition = msg.m_pReceiverObject->m_InternalId.m_InstanceIndex % uiNumPartitions;
+    partitions[uiNumResolvedMessages] = uiPartition;
+    ++partitionStart[uiPartition + 1];
+    ++uiNumResolvedMessages;
+  }
+
+  for (ezUInt32 i = 1; i <= uiNumPartitions; ++i)
+  {
+    partitionStart[i] += partitionStart[i - 1];
+  }
+
+  ezDynamicArray<MessageToDeliver> partitionedMessages(m_Data.m_StackAllocator.GetCurrentAllocator());
+  partitionedMessages.SetCountUninitialized(uiNumResolvedMessages);
+
+  {
+    ezDynamicArray<ezUInt32> writeIndex(m_Data.m_StackAllocator.GetCurrentAllocator());
+    writeIndex = partitionStart;
+
+    for (ezUInt32 i = 0; i < uiNumResolvedMessages; ++i)
+    {
+      partitionedMessages[writeIndex[partitions[i]]++] = resolvedMessages[i];
+    }
+  }
+
+  // Same as in the async phase the world may only be read while the messages are delivered.
+  const ezThreadID writeThreadID = m_Data.m_WriteThreadID;
+  m_Data.m_WriteThreadID = (ezThreadID)0;
+
+  ezParallelForParams params;
+  params.uiBinSize = 1;
+
+  ezTaskSystem::ParallelForIndexed(
+    0, uiNumPartitions,
+    [&](ezUInt32 uiStartPartition, ezUInt32 uiEndPartition) {
+      for (ezUInt32 i = partitionStart[uiStartPartition]; i < partitionStart[uiEndPartition]; ++i)
+      {
+        const MessageToDeliver& msg = partitionedMessages[i];
+
+        if (msg.m_pReceiverComponent != nullptr)
+        {
+          msg.m_pReceiverComponent->SendMessageInternal(*msg.m_pMessage, true);
+        }
+        else
+        {
+          msg.m_pReceiverObject->SendMessageInternal(*msg.m_pMessage, true);
+        }
+      }
+    },
+    "DeliverQueuedMessages", params);
+
+  m_Data.m_WriteThreadID = writeThreadID;
+
+  return uiRunEnd;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 void ezWorld::RegisterUpdateFunction(const ezComponentManagerBase::UpdateFunctionDesc& desc)
@@ -212,6 +212,46 @@ namespace ezInternal
     return pBlock->ReserveBack();
   }
 
+  void WorldData::CreateTransformationData(bool bDynamic, ezUInt32 uiHierarchyLevel, ezArrayPtr<ezGameObject::TransformationData*> out_Data)
+  {
+    Hierarchy& hierarchy = m_Hierarchies[GetHierarchyType(bDynamic)];
+
+    while (uiHierarchyLevel >= hierarchy.m_Data.GetCount())
+    {
+      hierarchy.m_Data.PushBack(EZ_NEW(&m_Allocator, Hierarchy::DataBlockArray, &m_Allocator));
+    }
+
+    Hierarchy::DataBlockArray& blocks = *hierarchy.m_Data[uiHierarchyLevel];
+
+    // only the last block of a level may be partially filled, so the new entries first fill up the last block and then the new ones in order
+    const ezUInt32 uiNumEntries = out_Data.GetCount();
+    const ezUInt32 uiFreeInLastBlock = blocks.IsEmpty() ? 0 : TRANSFORMATION_DATA_PER_BLOCK - blocks.PeekBack().m_uiCount;
+
+    ezUInt32 uiBlockIndex = blocks.IsEmpty() || blocks.PeekBack().IsFull() ? blocks.GetCount() : blocks.GetCount() - 1;
+
+    if (uiNumEntries > uiFreeInLastBlock)
+    {
+      const ezUInt32 uiNumNewBlocks = (uiNumEntries - uiFreeInLastBlock + TRANSFORMATION_DATA_PER_BLOCK - 1) / TRANSFORMATION_DATA_PER_BLOCK;
+      const ezUInt32 uiFirstNewBlock = blocks.GetCount();
+
+      blocks.SetCount(uiFirstNewBlock + uiNumNewBlocks, Hierarchy::DataBlock(nullptr, 0));
+      m_BlockAllocator.AllocateBlocks<ezGameObject::TransformationData>(blocks.GetArrayPtr().GetSubArray(uiFirstNewBlock));
+    }
+
+    for (ezUInt32 uiEntryIndex = 0; uiEntryIndex < uiNumEntries; ++uiBlockIndex)
+    {
+      Hierarchy::DataBlock& block = blocks[uiBlockIndex];
+
+      const ezUInt32 uiNumInBlock = ezMath::Min<ezUInt32>(TRANSFORMATION_DATA_PER_BLOCK - block.m_uiCount, uiNumEntries - uiEntryIndex);
+      for (ezUInt32 i = 0; i < uiNumInBlock; ++i)
+      {
+        out_Data[uiEntryIndex++] = block.m_pData + block.m_uiCount + i;
+      }
+
+      block.m_uiCount += uiNumInBlock;
+    }
+  }
+
   void WorldData::DeleteTransformationData(bool bDynamic, ezUInt32 uiHierarchyLevel, ezGameObject::TransformationData* pData)
   {
     Hierarchy& hierarchy = m_Hierarchies[GetHierarchyType(bDynamic)];
@@ -309,12 +349,10 @@ namespace ezInternal
     struct UserData
     {
       ezSimdFloat m_fInvDt;
-      ezSpatialSystem* m_pSpatialSystem;
     };
 
     UserData userData;
     userData.m_fInvDt = fInvDeltaSeconds;
-    userData.m_pSpatialSystem = m_pSpatialSystem.Borrow();
 
     struct RootLevel
     {
@@ -336,19 +374,17 @@ namespace ezInternal
 
     struct RootLevelWithSpatialData
     {
-      EZ_ALWAYS_INLINE static ezVisitorExecution::Enum Visit(ezGameObject::TransformationData* pData, void* pUserData)
+      EZ_ALWAYS_INLINE static bool Visit(ezGameObject::TransformationData* pData, void* pUserData, SpatialDataChange& out_change)
       {
-        WorldData::UpdateGlobalTransformAndSpatialData(pData, static_cast<UserData*>(pUserData)->m_fInvDt, *static_cast<UserData*>(pUserData)->m_pSpatialSystem);
-        return ezVisitorExecution::Continue;
+        return WorldData::UpdateGlobalTransformAndCheckSpatialData(pData, static_cast<UserData*>(pUserData)->m_fInvDt, out_change);
       }
     };
 
     struct WithParentWithSpatialData
     {
-      EZ_ALWAYS_INLINE static ezVisitorExecution::Enum Visit(ezGameObject::TransformationData* pData, void* pUserData)
+      EZ_ALWAYS_INLINE static bool Visit(ezGameObject::TransformationData* pData, void* pUserData, SpatialDataChange& out_change)
       {
-        WorldData::UpdateGlobalTransformWithParentAndSpatialData(pData, static_cast<UserData*>(pUserData)->m_fInvDt, *static_cast<UserData*>(pUserData)->m_pSpatialSystem);
-        return ezVisitorExecution::Continue;
+        return WorldData::UpdateGlobalTransformWithParentAndCheckSpatialData(pData, static_cast<UserData*>(pUserData)->m_fInvDt, out_change);
       }
     };
 
@@ -357,8 +393,6 @@ namespace ezInternal
     {
       auto dataPtr = hierarchy.m_Data.GetData();
 
-      // If we have no spatial system, we perform multi-threaded update as we do not
-      // have to acquire a write lock in the process.
       if (m_pSpatialSystem == nullptr)
       {
         TraverseHierarchyLevelMultiThreaded<RootLevel>(*dataPtr[0], &userData);
@@ -370,12 +404,39 @@ namespace ezInternal
       }
       else
       {
-        TraverseHierarchyLevel<RootLevelWithSpatialData>(*dataPtr[0], &userData);
+        // The transforms only depend on the parent level, so every level is still updated in parallel. Objects whose bounds changed are
+        // collected and their spatial data is updated afterwards in one batch, which the spatial system can then distribute itself.
+        m_SpatialDataChanges.Clear();
+
+        TraverseHierarchyLevelAndCollectSpatialDataChanges<RootLevelWithSpatialData>(*dataPtr[0], &userData);
 
         for (ezUInt32 i = 1; i < hierarchy.m_Data.GetCount(); ++i)
         {
-          TraverseHierarchyLevel<WithParentWithSpatialData>(*dataPtr[i], &userData);
+          TraverseHierarchyLevelAndCollectSpatialDataChanges<WithParentWithSpatialData>(*dataPtr[i], &userData);
+        }
+
+        m_SpatialDataUpdates.Clear();
+
+        for (const SpatialDataChange& change : m_SpatialDataChanges)
+        {
+          ezGameObject::TransformationData* pData = change.m_pData;
+
+          // only existing spatial data that stays in the spatial system can be batched, everything else creates or deletes spatial data
+          if (!change.m_bWasAlwaysVisible && !change.m_bIsAlwaysVisible && !pData->m_hSpatialData.IsInvalidated() && pData->m_globalBounds.IsValid())
+          {
+            auto& update = m_SpatialDataUpdates.ExpandAndGetRef();
+            update.m_Bounds = pData->m_globalBounds;
+            update.m_hData = pData->m_hSpatialData;
+            update.m_pObject = pData->m_pObject;
+            update.m_uiCategoryBitmask = pData->m_uiSpatialDataCategoryBitmask;
+          }
+          else
+          {
+            pData->UpdateSpatialData(*m_pSpatialSystem, change.m_bWasAlwaysVisible, change.m_bIsAlwaysVisible);
+          }
         }
+
+        m_pSpatialSystem->UpdateSpatialDataBatch(m_SpatialDataUpdates);
       }
     }
   }
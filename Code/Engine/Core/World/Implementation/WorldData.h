@@ -121,6 +121,9 @@ namespace ezInternal
 
     ezGameObject::TransformationData* CreateTransformationData(bool bDynamic, ezUInt32 uiHierarchyLevel);
 
+    /// \brief Creates one transformation data entry for every entry of out_Data. All needed blocks are allocated at once and filled contiguously.
+    void CreateTransformationData(bool bDynamic, ezUInt32 uiHierarchyLevel, ezArrayPtr<ezGameObject::TransformationData*> out_Data);
+
     void DeleteTransformationData(bool bDynamic, ezUInt32 uiHierarchyLevel, ezGameObject::TransformationData* pData);
 
     template <typename VISITOR>
@@ -128,6 +131,19 @@ namespace ezInternal
     template <typename VISITOR>
     ezVisitorExecution::Enum TraverseHierarchyLevelMultiThreaded(Hierarchy::DataBlockArray& blocks, void* pUserData = nullptr);
 
+    struct SpatialDataChange
+    {
+      EZ_DECLARE_POD_TYPE();
+
+      ezGameObject::TransformationData* m_pData;
+      bool m_bWasAlwaysVisible;
+      bool m_bIsAlwaysVisible;
+    };
+
+    /// \brief Like TraverseHierarchyLevelMultiThreaded, but the visitor may report a SpatialDataChange, which is added to m_SpatialDataChanges.
+    template <typename VISITOR>
+    void TraverseHierarchyLevelAndCollectSpatialDataChanges(Hierarchy::DataBlockArray& blocks, void* pUserData = nullptr);
+
     typedef ezDelegate<ezVisitorExecution::Enum(ezGameObject*)> VisitorFunc;
     void TraverseBreadthFirst(VisitorFunc& func);
     void TraverseDepthFirst(VisitorFunc& func);
@@ -136,11 +152,16 @@ namespace ezInternal
     static void UpdateGlobalTransform(ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds);
     static void UpdateGlobalTransformWithParent(ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds);
 
-    static void UpdateGlobalTransformAndSpatialData(ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds, ezSpatialSystem& spatialSystem);
-    static void UpdateGlobalTransformWithParentAndSpatialData(ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds, ezSpatialSystem& spatialSystem);
+    static bool UpdateGlobalTransformAndCheckSpatialData(ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds, SpatialDataChange& out_change);
+    static bool UpdateGlobalTransformWithParentAndCheckSpatialData(ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds, SpatialDataChange& out_change);
 
     void UpdateGlobalTransforms(float fInvDeltaSeconds);
 
+    // The spatial system can't be modified from multiple threads, so changes are collected during the parallel transform update and applied afterwards.
+    ezMutex m_SpatialDataChangesMutex;
+    ezDynamicArray<SpatialDataChange, ezLocalAllocatorWrapper> m_SpatialDataChanges;
+    ezDynamicArray<ezSpatialSystem::SpatialDataUpdate, ezAlignedAllocatorWrapper> m_SpatialDataUpdates;
+
     // game object lookups
     ezHashTable<ezUInt64, ezGameObjectId, ezHashHelper<ezUInt64>, ezLocalAllocatorWrapper> m_GlobalKeyToIdTable;
     ezHashTable<ezUInt64, ezHashedString, ezHashHelper<ezUInt64>, ezLocalAllocatorWrapper> m_IdToGlobalKeyTable;
@@ -59,6 +59,56 @@ namespace ezInternal
     return ezVisitorExecution::Continue;
   }
 
+  template <typename VISITOR>
+  void WorldData::TraverseHierarchyLevelAndCollectSpatialDataChanges(Hierarchy::DataBlockArray& blocks, void* pUserData /* = nullptr*/)
+  {
+    ezParallelForParams parallelForParams;
+    parallelForParams.uiBinSize = 100;
+    parallelForParams.uiMaxTasksPerThread = 2;
+    parallelForParams.pTaskAllocator = m_StackAllocator.GetCurrentAllocator();
+
+    ezTaskSystem::ParallelFor(
+      blocks.GetArrayPtr(),
+      [this, pUserData](ezArrayPtr<WorldData::Hierarchy::DataBlock> blocksSlice) {
+        // collect the changes locally, so the shared array is only locked once in a while
+        ezHybridArray<SpatialDataChange, 64> changes;
+
+        auto FlushChanges = [&]() {
+          EZ_LOCK(m_SpatialDataChangesMutex);
+          m_SpatialDataChanges.PushBackRange(changes);
+          changes.Clear();
+        };
+
+        for (WorldData::Hierarchy::DataBlock& block : blocksSlice)
+        {
+          ezGameObject::TransformationData* pCurrentData = block.m_pData;
+          ezGameObject::TransformationData* pEndData = block.m_pData + block.m_uiCount;
+
+          while (pCurrentData < pEndData)
+          {
+            SpatialDataChange change;
+            if (VISITOR::Visit(pCurrentData, pUserData, change))
+            {
+              changes.PushBack(change);
+
+              if (changes.GetCount() == changes.GetCapacity())
+              {
+                FlushChanges();
+              }
+            }
+
+            ++pCurrentData;
+          }
+        }
+
+        if (!changes.IsEmpty())
+        {
+          FlushChanges();
+        }
+      },
+      "World DataBlock Traversal Task", parallelForParams);
+  }
+
   // static
   EZ_FORCE_INLINE void WorldData::UpdateGlobalTransform(ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds)
   {
@@ -76,21 +126,25 @@ namespace ezInternal
   }
 
   // static
-  EZ_FORCE_INLINE void WorldData::UpdateGlobalTransformAndSpatialData(
-    ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds, ezSpatialSystem& spatialSystem)
+  EZ_FORCE_INLINE bool WorldData::UpdateGlobalTransformAndCheckSpatialData(
+    ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds, SpatialDataChange& out_change)
   {
     pData->UpdateGlobalTransform();
     pData->UpdateVelocity(fInvDeltaSeconds);
-    pData->UpdateGlobalBoundsAndSpatialData(spatialSystem);
+
+    out_change.m_pData = pData;
+    return pData->UpdateGlobalBoundsAndCheckSpatialData(out_change.m_bWasAlwaysVisible, out_change.m_bIsAlwaysVisible);
   }
 
   // static
-  EZ_FORCE_INLINE void WorldData::UpdateGlobalTransformWithParentAndSpatialData(
-    ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds, ezSpatialSystem& spatialSystem)
+  EZ_FORCE_INLINE bool WorldData::UpdateGlobalTransformWithParentAndCheckSpatialData(
+    ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds, SpatialDataChange& out_change)
   {
     pData->UpdateGlobalTransformWithParent();
     pData->UpdateVelocity(fInvDeltaSeconds);
-    pData->UpdateGlobalBoundsAndSpatialData(spatialSystem);
+
+    out_change.m_pData = pData;
+    return pData->UpdateGlobalBoundsAndCheckSpatialData(out_change.m_bWasAlwaysVisible, out_change.m_bIsAlwaysVisible);
   }
 
   ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -4,6 +4,7 @@
 #include <Foundation/Containers/IdTable.h>
 #include <Foundation/Math/Frustum.h>
 #include <Foundation/Memory/CommonAllocators.h>
+#include <Foundation/Types/UniquePtr.h>
 
 class EZ_CORE_DLL ezSpatialSystem : public ezReflectedClass
 {
@@ -25,6 +26,19 @@ public:
 
   void UpdateSpatialData(const ezSpatialDataHandle& hData, const ezSimdBBoxSphere& bounds, ezGameObject* pObject, ezUInt32 uiCategoryBitmask);
 
+  struct SpatialDataUpdate
+  {
+    ezSimdBBoxSphere m_Bounds;
+    ezSpatialDataHandle m_hData;
+    ezGameObject* m_pObject = nullptr;
+    ezUInt32 m_uiCategoryBitmask = 0;
+  };
+
+  /// \brief Same as calling UpdateSpatialData() for every entry, but the spatial system may process all changes together and in parallel.
+  ///
+  /// Use this when many objects move at once, e.g. after the global transforms of a world have been updated.
+  void UpdateSpatialDataBatch(ezArrayPtr<const SpatialDataUpdate> updates);
+
   ///@}
   /// \name Simple Queries
   ///@{
@@ -33,16 +47,20 @@ public:
 
   struct QueryStats
   {
-    ezUInt32 m_uiTotalNumObjects;  ///< The total number of spatial objects in this system.
-    ezUInt32 m_uiNumObjectsTested; ///< Number of objects tested for the query condition.
-    ezUInt32 m_uiNumObjectsPassed; ///< Number of objects that passed the query condition.
-    ezTime m_TimeTaken;            ///< Time taken to execute the query
+    ezUInt32 m_uiTotalNumObjects;    ///< The total number of spatial objects in this system.
+    ezUInt32 m_uiNumObjectsTested;   ///< Number of objects tested for the query condition.
+    ezUInt32 m_uiNumObjectsPassed;   ///< Number of objects that passed the query condition.
+    ezUInt32 m_uiNumObjectsOccluded; ///< Number of objects that passed the frustum test but were rejected by the occlusion callback.
+    ezUInt32 m_uiNumObjectsCached;   ///< Number of objects whose frustum test result was taken from the visibility cache.
+    ezTime m_TimeTaken;              ///< Time taken to execute the query
 
     EZ_ALWAYS_INLINE QueryStats()
     {
       m_uiTotalNumObjects = 0;
       m_uiNumObjectsTested = 0;
       m_uiNumObjectsPassed = 0;
+      m_uiNumObjectsOccluded = 0;
+      m_uiNumObjectsCached = 0;
     }
   };
 
@@ -58,8 +76,38 @@ public:
   /// \name Visibility Queries
   ///@{
 
-  void FindVisibleObjects(
-    const ezFrustum& frustum, ezUInt32 uiCategoryBitmask, ezDynamicArray<const ezGameObject*>& out_Objects, QueryStats* pStats = nullptr) const;
+  /// \brief Returns true if everything inside the given box is hidden behind occluders.
+  typedef ezDelegate<bool(const ezSimdBBox&)> IsOccludedCallback;
+
+  /// \brief Stores the results of a visibility query, so that the next query with a similar frustum only has to re-test what might have changed.
+  ///
+  /// Create one cache per view (or anything else that queries a slowly changing frustum every frame) with CreateVisibilityCache()
+  /// and pass it to all of its FindVisibleObjects() calls. A cache must not be used by multiple queries at the same time.
+  class EZ_CORE_DLL VisibilityCache
+  {
+  public:
+    virtual ~VisibilityCache();
+
+  private:
+    friend class ezSpatialSystem;
+
+    ezUInt32 m_uiSpatialSystemId = 0;
+  };
+
+  /// \brief Creates a new visibility cache for this spatial system. Returns nullptr if the spatial system does not support caching.
+  ezUniquePtr<VisibilityCache> CreateVisibilityCache() const;
+
+  /// \brief Returns true if the given cache was created by this spatial system, i.e. it can be passed to FindVisibleObjects().
+  bool IsVisibilityCacheValid(const VisibilityCache* pCache) const;
+
+  /// \brief Finds all objects that intersect the given frustum.
+  ///
+  /// If an occlusion callback is given, it is asked for the bounds of whole groups of objects (e.g. grid cells) first and for each object that is
+  /// inside the frustum afterwards. Everything it considers occluded is skipped.
+  /// If a visibility cache is given, the frustum test results of the previous query that used the same cache are reused wherever neither the
+  /// objects nor the relevant parts of the frustum have changed since. The occlusion callback is always asked again.
+  void FindVisibleObjects(const ezFrustum& frustum, ezUInt32 uiCategoryBitmask, ezDynamicArray<const ezGameObject*>& out_Objects,
+    QueryStats* pStats = nullptr, IsOccludedCallback isOccludedCallback = IsOccludedCallback(), VisibilityCache* pCache = nullptr) const;
 
   ///@}
 
@@ -67,12 +115,25 @@ protected:
   virtual void FindObjectsInSphereInternal(
     const ezBoundingSphere& sphere, ezUInt32 uiCategoryBitmask, QueryCallback callback, QueryStats* pStats) const = 0;
   virtual void FindObjectsInBoxInternal(const ezBoundingBox& box, ezUInt32 uiCategoryBitmask, QueryCallback callback, QueryStats* pStats) const = 0;
-  virtual void FindVisibleObjectsInternal(
-    const ezFrustum& frustum, ezUInt32 uiCategoryBitmask, ezDynamicArray<const ezGameObject*>& out_Objects, QueryStats* pStats) const = 0;
+  virtual void FindVisibleObjectsInternal(const ezFrustum& frustum, ezUInt32 uiCategoryBitmask, ezDynamicArray<const ezGameObject*>& out_Objects,
+    QueryStats* pStats, IsOccludedCallback isOccludedCallback, VisibilityCache* pCache) const = 0;
+
+  /// \brief Creates the spatial system specific visibility cache. The default implementation returns nullptr, which disables caching.
+  virtual ezUniquePtr<VisibilityCache> CreateVisibilityCacheInternal() const;
 
   virtual void SpatialDataAdded(ezSpatialData* pData) = 0;
   virtual void SpatialDataRemoved(ezSpatialData* pData) = 0;
   virtual void SpatialDataChanged(ezSpatialData* pData, const ezSimdBBoxSphere& oldBounds, ezUInt32 uiOldCategoryBitmask) = 0;
+
+  struct ChangedSpatialData
+  {
+    ezSimdBBoxSphere m_OldBounds;
+    ezSpatialData* m_pData;
+    ezUInt32 m_uiOldCategoryBitmask;
+  };
+
+  /// \brief Called by UpdateSpatialDataBatch() with all spatial data that actually changed. The default implementation calls SpatialDataChanged() for each.
+  virtual void SpatialDataChangedBatch(ezArrayPtr<const ChangedSpatialData> changes);
   virtual void FixSpatialDataPointer(ezSpatialData* pOldPtr, ezSpatialData* pNewPtr) = 0;
 
   ezProxyAllocator m_Allocator;
@@ -84,4 +145,8 @@ protected:
   DataStorage m_DataStorage;
 
   ezDynamicArray<ezSpatialData*> m_DataAlwaysVisible;
+
+  ezDynamicArray<ChangedSpatialData, ezAlignedAllocatorWrapper> m_ChangedData;
+
+  ezUInt32 m_uiId = 0; ///< Unique for every spatial system, so that caches don't have to hold on to a pointer that might be reused.
 };
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <Core/World/SpatialSystem.h>
+
+/// \brief A spatial system that sorts objects into a loose octree.
+///
+/// Every object is put into the deepest node whose cell is at least as large as its bounding sphere, so huge objects end up close to the root
+/// while small objects in dense areas are distributed over many small nodes. The bounds of a node are twice as large as its cell,
+/// which means that an object only has to be moved to another node once it has left these loose bounds.
+/// Objects that are outside of the octree or larger than its root cell are stored in the root node.
+///
+/// Queries test all 8 children of a node with a few SIMD operations and skip whole subtrees that don't contain the queried categories.
+class EZ_CORE_DLL ezSpatialSystem_LooseOctree : public ezSpatialSystem
+{
+  EZ_ADD_DYNAMIC_REFLECTION(ezSpatialSystem_LooseOctree, ezSpatialSystem);
+
+public:
+  /// \brief The octree covers a cube of uiWorldSize around the origin. Nodes are not subdivided any further once they reach uiMinNodeSize.
+  ezSpatialSystem_LooseOctree(ezUInt32 uiWorldSize = 65536, ezUInt32 uiMinNodeSize = 16);
+  ~ezSpatialSystem_LooseOctree();
+
+  /// \brief Returns the loose bounding box of the node that contains the given spatial data. Useful for debug visualizations.
+  ezResult GetNodeBoxForSpatialData(const ezSpatialDataHandle& hData, ezBoundingBox& out_BoundingBox) const;
+
+  /// \brief Returns the loose bounding boxes of all nodes that contain objects.
+  void GetAllNodeBoxes(
+    ezHybridArray<ezBoundingBox, 16>& out_BoundingBoxes, ezSpatialData::Category filterCategory = ezInvalidSpatialDataCategory) const;
+
+private:
+  // ezSpatialSystem implementation
+  virtual void FindObjectsInSphereInternal(
+    const ezBoundingSphere& sphere, ezUInt32 uiCategoryBitmask, QueryCallback callback, QueryStats* pStats = nullptr) const override;
+  virtual void FindObjectsInBoxInternal(
+    const ezBoundingBox& box, ezUInt32 uiCategoryBitmask, QueryCallback callback, QueryStats* pStats = nullptr) const override;
+
+  virtual void FindVisibleObjectsInternal(const ezFrustum& frustum, ezUInt32 uiCategoryBitmask, ezDynamicArray<const ezGameObject*>& out_Objects,
+    QueryStats* pStats, IsOccludedCallback isOccludedCallback, VisibilityCache* pCache) const override;
+
+  virtual void SpatialDataAdded(ezSpatialData* pData) override;
+  virtual void SpatialDataRemoved(ezSpatialData* pData) override;
+  virtual void SpatialDataChanged(ezSpatialData* pData, const ezSimdBBoxSphere& oldBounds, ezUInt32 uiOldCategoryBitmask) override;
+  virtual void SpatialDataChangedBatch(ezArrayPtr<const ChangedSpatialData> changes) override;
+  virtual void FixSpatialDataPointer(ezSpatialData* pOldPtr, ezSpatialData* pNewPtr) override;
+
+  struct SpatialUserData;
+  struct Node;
+
+  template <typename NodeFilter, typename NodeFunctor>
+  void TraverseNodes(ezUInt32 uiCategoryBitmask, NodeFilter nodeFilter, NodeFunctor nodeFunc) const;
+
+  ezUInt32 FindTargetNodeDepth(const ezSimdBBoxSphere& bounds) const;
+  bool IsInNodeBounds(const Node& node, const ezSimdBBoxSphere& bounds) const;
+
+  ezUInt32 GetOrCreateNode(const ezSimdBBoxSphere& bounds, ezUInt32 uiStartNodeIndex);
+  ezUInt32 AllocateNode(ezUInt32 uiParent, ezUInt32 uiChildIndex);
+  void AddToNode(ezUInt32 uiNodeIndex, ezSpatialData* pData);
+  void AddSubtreeCategories(ezUInt32 uiNodeIndex, ezUInt32 uiCategoryBitmask);
+  void RemoveFromNode(ezUInt32 uiNodeIndex, ezUInt32 uiDataIndex);
+
+  ezProxyAllocator m_AlignedAllocator;
+  ezSimdFloat m_fRootHalfSize;
+  ezUInt32 m_uiMaxDepth;
+
+  ezDynamicArray<Node> m_Nodes;
+  ezDynamicArray<ezUInt32> m_FreeNodes;
+
+  // scratch data for SpatialDataChangedBatch
+  ezDynamicArray<ezUInt8> m_UpdatedInPlace;
+};
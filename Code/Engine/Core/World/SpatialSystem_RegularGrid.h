@@ -27,11 +27,13 @@ private:
     const ezBoundingBox& box, ezUInt32 uiCategoryBitmask, QueryCallback callback, QueryStats* pStats = nullptr) const override;
 
   virtual void FindVisibleObjectsInternal(const ezFrustum& frustum, ezUInt32 uiCategoryBitmask, ezDynamicArray<const ezGameObject*>& out_Objects,
-    QueryStats* pStats = nullptr) const override;
+    QueryStats* pStats, IsOccludedCallback isOccludedCallback, VisibilityCache* pCache) const override;
+  virtual ezUniquePtr<VisibilityCache> CreateVisibilityCacheInternal() const override;
 
   virtual void SpatialDataAdded(ezSpatialData* pData) override;
   virtual void SpatialDataRemoved(ezSpatialData* pData) override;
   virtual void SpatialDataChanged(ezSpatialData* pData, const ezSimdBBoxSphere& oldBounds, ezUInt32 uiOldCategoryBitmask) override;
+  virtual void SpatialDataChangedBatch(ezArrayPtr<const ChangedSpatialData> changes) override;
   virtual void FixSpatialDataPointer(ezSpatialData* pOldPtr, ezSpatialData* pNewPtr) override;
 
   ezProxyAllocator m_AlignedAllocator;
@@ -42,6 +44,9 @@ private:
   struct SpatialUserData;
   struct Cell;
   struct CellKeyHashHelper;
+  struct CellMove;
+  struct CachedCell;
+  class GridVisibilityCache;
 
   ezHashTable<ezUInt64, ezUniquePtr<Cell>, CellKeyHashHelper, ezLocalAllocatorWrapper> m_Cells;
   ezUniquePtr<Cell> m_pOverflowCell;
@@ -49,5 +54,11 @@ private:
   template <typename Functor>
   void ForEachCellInBox(const ezSimdBBox& box, ezUInt32 uiCategoryBitmask, Functor func) const;
 
+  ezUInt64 ComputeCellKey(const ezSimdBBoxSphere& bounds, ezSimdBBox& out_CellBox) const;
   Cell* GetOrCreateCell(const ezSimdBBoxSphere& bounds);
+
+  // scratch data for SpatialDataChangedBatch
+  ezDynamicArray<ezUInt8> m_ChangeTypes;
+  ezDynamicArray<CellMove> m_CellMoves;
+  ezDynamicArray<ezArrayPtr<CellMove>> m_CellMoveGroups;
 };
@@ -43,6 +43,16 @@ public:
   /// \brief Create a new game object from the given description, writes a pointer to it to out_pObject and returns a handle to it.
   ezGameObjectHandle CreateObject(const ezGameObjectDesc& desc, ezGameObject*& out_pObject);
 
+  /// \brief Creates multiple game objects at once. Write access is only checked once and parents can be referenced by their index in the array.
+  ///
+  /// The storage for all objects and their transformation data is reserved up front, so objects of the same hierarchy level end up next to each other.
+  ///
+  /// If parentIndices is not empty it needs one entry per desc. Each entry that is not ezInvalidIndex is the index of the desc of the parent
+  /// object, which has to come before the child in the array, and is used instead of ezGameObjectDesc::m_hParent.
+  /// out_Handles and out_Objects may be empty, otherwise they need one entry per desc as well.
+  void CreateObjects(ezArrayPtr<const ezGameObjectDesc> descs, ezArrayPtr<const ezUInt32> parentIndices, ezArrayPtr<ezGameObjectHandle> out_Handles,
+    ezArrayPtr<ezGameObject*> out_Objects = ezArrayPtr<ezGameObject*>());
+
   /// \brief Deletes the given object, its children and all components.
   /// \note This function deletes the object immediately! It is unsafe to use this during a game update loop, as other objects
   /// may rely on this object staying valid for the rest of the frame.
@@ -347,6 +357,10 @@ private:
 
   ezGameObject* GetObjectUnchecked(ezUInt32 uiIndex) const;
 
+  ezGameObject* CreateObjectInternal(const ezGameObjectDesc& desc, ezGameObject* pParentObject);
+  void InitializeObject(const ezGameObjectDesc& desc, ezGameObject* pParentObject, bool bDynamic, ezUInt16 uiHierarchyLevel, ezGameObject* pNewObject,
+    ezGameObject::TransformationData* pTransformationData);
+
   void SetParent(ezGameObject* pObject, ezGameObject* pNewParent,
     ezGameObject::TransformPreservation preserve = ezGameObject::TransformPreservation::PreserveGlobal);
   void LinkToParent(ezGameObject* pObject);
@@ -358,6 +372,7 @@ private:
   void PostMessage(const ezGameObjectHandle& receiverObject, const ezMessage& msg, ezObjectMsgQueueType::Enum queueType, ezTime delay, bool bRecursive) const;
   void ProcessQueuedMessage(const ezInternal::WorldData::MessageQueue::Entry& entry);
   void ProcessQueuedMessages(ezObjectMsgQueueType::Enum queueType);
+  ezUInt32 ProcessQueuedMessages(ezInternal::WorldData::MessageQueue& queue, ezUInt32 uiStartIndex, ezUInt32 uiEndIndex);
 
   void RegisterUpdateFunction(const ezWorldModule::UpdateFunctionDesc& desc);
   void DeregisterUpdateFunction(const ezWorldModule::UpdateFunctionDesc& desc);
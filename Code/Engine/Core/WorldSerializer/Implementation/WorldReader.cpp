@@ -2,6 +2,7 @@
 
 #include <Core/WorldSerializer/WorldReader.h>
 #include <Foundation/IO/StringDeduplicationContext.h>
+#include <Foundation/Threading/DelegateTask.h>
 #include <Foundation/Types/ScopeExit.h>
 #include <Foundation/Utilities/Progress.h>
 
@@ -201,6 +202,15 @@ void ezWorldReader::ReadGameObjectDesc(GameObjectToCreate& godesc)
   }
 }
 
+// static
+void ezWorldReader::ReadComponentToCreate(ezStreamReader& stream, ComponentToCreate& out_ComponentToCreate)
+{
+  stream >> out_ComponentToCreate.m_uiOwnerIndex;
+  stream >> out_ComponentToCreate.m_uiComponentIndex;
+  stream >> out_ComponentToCreate.m_bActive;
+  stream >> out_ComponentToCreate.m_uiUserFlags;
+}
+
 void ezWorldReader::ReadComponentTypeInfo(ezUInt32 uiComponentTypeIdx)
 {
   ezStreamReader& s = *m_pStream;
@@ -340,10 +350,18 @@ ezWorldReader::InstantiationContext::InstantiationContext(ezWorldReader& worldRe
 
     m_pOverallProgressRange->BeginNextStep("CreateRootObjects");
   }
+
+  if (options.m_MaxStepTime.IsPositive() && options.m_bPrepareOnWorkerThread)
+  {
+    m_pPrepareTask = EZ_DEFAULT_NEW(ezDelegateTask<void>, "ezWorldReader::Prepare", ezMakeDelegate(&InstantiationContext::PrepareOnWorkerThread, this));
+    m_PrepareTaskGroup = ezTaskSystem::StartSingleTask(m_pPrepareTask, ezTaskPriority::LongRunningHighPriority);
+  }
 }
 
 ezWorldReader::InstantiationContext::~InstantiationContext()
 {
+  WaitForPreparation();
+
   if (!m_hComponentInitBatch.IsInvalidated())
   {
     m_WorldReader.m_pWorld->DeleteComponentInitBatch(m_hComponentInitBatch);
@@ -357,6 +375,15 @@ ezWorldReader::InstantiationContext::StepResult ezWorldReader::InstantiationCont
 
   EZ_PROFILE_SCOPE("ezWorldReader::InstContext::Step");
 
+  // the world doesn't need to be locked while the worker thread is busy
+  if (m_pPrepareTask != nullptr)
+  {
+    if (!ezTaskSystem::IsTaskGroupFinished(m_PrepareTaskGroup))
+      return StepResult::ContinueNextFrame;
+
+    WaitForPreparation();
+  }
+
   EZ_LOCK(m_WorldReader.m_pWorld->GetWriteMarker());
 
   ezTime endTime = ezTime::Now() + m_Options.m_MaxStepTime;
@@ -365,12 +392,12 @@ ezWorldReader::InstantiationContext::StepResult ezWorldReader::InstantiationCont
   {
     if (m_bUseTransform)
     {
-      if (!CreateGameObjects<true>(m_WorldReader.m_RootObjectsToCreate, m_Options.m_hParent, m_Options.m_pCreatedRootObjectsOut, endTime))
+      if (!CreateGameObjects<true>(m_WorldReader.m_RootObjectsToCreate, 0, m_Options.m_hParent, m_Options.m_pCreatedRootObjectsOut, endTime))
         return StepResult::Continue;
     }
     else
     {
-      if (!CreateGameObjects<false>(m_WorldReader.m_RootObjectsToCreate, m_Options.m_hParent, m_Options.m_pCreatedRootObjectsOut, endTime))
+      if (!CreateGameObjects<false>(m_WorldReader.m_RootObjectsToCreate, 0, m_Options.m_hParent, m_Options.m_pCreatedRootObjectsOut, endTime))
         return StepResult::Continue;
     }
 
@@ -380,7 +407,7 @@ ezWorldReader::InstantiationContext::StepResult ezWorldReader::InstantiationCont
 
   if (m_Phase == Phase::CreateChildObjects)
   {
-    if (!CreateGameObjects<false>(m_WorldReader.m_ChildObjectsToCreate, ezGameObjectHandle(), m_Options.m_pCreatedChildObjectsOut, endTime))
+    if (!CreateGameObjects<false>(m_WorldReader.m_ChildObjectsToCreate, m_WorldReader.m_RootObjectsToCreate.GetCount(), ezGameObjectHandle(), m_Options.m_pCreatedChildObjectsOut, endTime))
       return StepResult::Continue;
 
     m_CurrentReader.SetStorage(&m_WorldReader.m_ComponentCreationStream);
@@ -459,6 +486,8 @@ ezWorldReader::InstantiationContext::StepResult ezWorldReader::InstantiationCont
 
 void ezWorldReader::InstantiationContext::Cancel()
 {
+  WaitForPreparation();
+
   if (!m_hComponentInitBatch.IsInvalidated())
   {
     m_WorldReader.m_pWorld->CancelComponentInitBatch(m_hComponentInitBatch);
@@ -477,68 +506,121 @@ inline static ezUInt32 NextStableRandomSeed(ezUInt32& seed)
 }
 
 template <bool UseTransform>
-bool ezWorldReader::InstantiationContext::CreateGameObjects(const ezDynamicArray<GameObjectToCreate>& objects, ezGameObjectHandle hParent, ezHybridArray<ezGameObject*, 8>* out_CreatedObjects, ezTime endTime)
+void ezWorldReader::InstantiationContext::PrepareGameObjectDesc(const GameObjectToCreate& godesc, ezGameObjectDesc& out_Desc)
+{
+  out_Desc = godesc.m_Desc; // make a copy
+  out_Desc.m_bDynamic |= m_Options.bForceDynamic;
+
+  switch (m_Options.m_RandomSeedMode)
+  {
+    case ezPrefabInstantiationOptions::RandomSeedMode::DeterministicFromParent:
+      out_Desc.m_uiStableRandomSeed = 0xFFFFFFFF; // ezWorld::CreateObject() will either derive a deterministic value from the parent object, or assign a random value, if no parent exists
+      break;
+
+    case ezPrefabInstantiationOptions::RandomSeedMode::CompletelyRandom:
+      out_Desc.m_uiStableRandomSeed = 0; // ezWorld::CreateObject() will assign a random value to this object
+      break;
+
+    case ezPrefabInstantiationOptions::RandomSeedMode::FixedFromSerialization:
+      // keep deserialized value
+      break;
+
+    case ezPrefabInstantiationOptions::RandomSeedMode::CustomRootValue:
+      // we use the given seed root value to assign a deterministic (but different) value to each game object
+      out_Desc.m_uiStableRandomSeed = NextStableRandomSeed(m_Options.m_uiCustomRandomSeedRootValue);
+      break;
+  }
+
+  if (m_Options.m_pOverrideTeamID != nullptr)
+  {
+    out_Desc.m_uiTeamID = *m_Options.m_pOverrideTeamID;
+  }
+
+  if (UseTransform)
+  {
+    ezTransform tChild(out_Desc.m_LocalPosition, out_Desc.m_LocalRotation, out_Desc.m_LocalScaling);
+    ezTransform tFinal;
+    tFinal.SetGlobalTransform(m_RootTransform, tChild);
+
+    out_Desc.m_LocalPosition = tFinal.m_vPosition;
+    out_Desc.m_LocalRotation = tFinal.m_qRotation;
+    out_Desc.m_LocalScaling = tFinal.m_vScale;
+  }
+}
+
+template <bool UseTransform>
+bool ezWorldReader::InstantiationContext::CreateGameObjects(const ezDynamicArray<GameObjectToCreate>& objects, ezUInt32 uiFirstObjectIndex, ezGameObjectHandle hParent, ezHybridArray<ezGameObject*, 8>* out_CreatedObjects, ezTime endTime)
 {
   EZ_PROFILE_SCOPE("ezWorldReader::CreateGameObjects");
 
+  // objects are committed to the world in batches, the time budget is checked after each batch
+  constexpr ezUInt32 uiMaxObjectsPerBatch = 128;
+
+  ezHybridArray<ezUInt32, uiMaxObjectsPerBatch> parentIndices;
+  ezHybridArray<ezGameObject*, uiMaxObjectsPerBatch> createdObjects;
+
+  auto& indexToHandle = m_WorldReader.m_IndexToGameObjectHandle;
+
   while (m_uiCurrentIndex < objects.GetCount())
   {
-    auto& godesc = objects[m_uiCurrentIndex];
-
-    ezGameObjectDesc desc = godesc.m_Desc; // make a copy
-    desc.m_hParent = hParent.IsInvalidated() ? m_WorldReader.m_IndexToGameObjectHandle[godesc.m_uiParentHandleIdx] : hParent;
-    desc.m_bDynamic |= m_Options.bForceDynamic;
+    const ezUInt32 uiBatchStart = m_uiCurrentIndex;
+    const ezUInt32 uiBatchCount = ezMath::Min(objects.GetCount() - uiBatchStart, uiMaxObjectsPerBatch);
 
-    switch (m_Options.m_RandomSeedMode)
+    ezArrayPtr<ezGameObjectDesc> descs;
+    if (m_bPrepared)
     {
-      case ezPrefabInstantiationOptions::RandomSeedMode::DeterministicFromParent:
-        desc.m_uiStableRandomSeed = 0xFFFFFFFF; // ezWorld::CreateObject() will either derive a deterministic value from the parent object, or assign a random value, if no parent exists
-        break;
-
-      case ezPrefabInstantiationOptions::RandomSeedMode::CompletelyRandom:
-        desc.m_uiStableRandomSeed = 0; // ezWorld::CreateObject() will assign a random value to this object
-        break;
-
-      case ezPrefabInstantiationOptions::RandomSeedMode::FixedFromSerialization:
-        // keep deserialized value
-        break;
-
-      case ezPrefabInstantiationOptions::RandomSeedMode::CustomRootValue:
-        // we use the given seed root value to assign a deterministic (but different) value to each game object
-        desc.m_uiStableRandomSeed = NextStableRandomSeed(m_Options.m_uiCustomRandomSeedRootValue);
-        break;
+      descs = m_PreparedObjectDescs.GetArrayPtr().GetSubArray(uiFirstObjectIndex + uiBatchStart, uiBatchCount);
     }
-
-    if (m_Options.m_pOverrideTeamID != nullptr)
+    else
     {
-      desc.m_uiTeamID = *m_Options.m_pOverrideTeamID;
+      m_BatchObjectDescs.SetCount(uiBatchCount);
+      for (ezUInt32 i = 0; i < uiBatchCount; ++i)
+      {
+        PrepareGameObjectDesc<UseTransform>(objects[uiBatchStart + i], m_BatchObjectDescs[i]);
+      }
+
+      descs = m_BatchObjectDescs;
     }
 
-    if (UseTransform)
+    // parents that are part of this batch are referenced by index, all others are already created and referenced by handle
+    const ezUInt32 uiFirstHandleIndex = indexToHandle.GetCount();
+    parentIndices.SetCountUninitialized(uiBatchCount);
+
+    for (ezUInt32 i = 0; i < uiBatchCount; ++i)
     {
-      ezTransform tChild(desc.m_LocalPosition, desc.m_LocalRotation, desc.m_LocalScaling);
-      ezTransform tFinal;
-      tFinal.SetGlobalTransform(m_RootTransform, tChild);
+      const ezUInt32 uiParentHandleIndex = objects[uiBatchStart + i].m_uiParentHandleIdx;
 
-      desc.m_LocalPosition = tFinal.m_vPosition;
-      desc.m_LocalRotation = tFinal.m_qRotation;
-      desc.m_LocalScaling = tFinal.m_vScale;
+      if (hParent.IsInvalidated() && uiParentHandleIndex >= uiFirstHandleIndex)
+      {
+        parentIndices[i] = uiParentHandleIndex - uiFirstHandleIndex;
+      }
+      else
+      {
+        descs[i].m_hParent = hParent.IsInvalidated() ? indexToHandle[uiParentHandleIndex] : hParent;
+        parentIndices[i] = ezInvalidIndex;
+      }
     }
 
-    ezGameObject* pObject = nullptr;
-    m_WorldReader.m_IndexToGameObjectHandle.PushBack(m_WorldReader.m_pWorld->CreateObject(desc, pObject));
+    indexToHandle.SetCount(uiFirstHandleIndex + uiBatchCount);
+    createdObjects.SetCountUninitialized(uiBatchCount);
+
+    m_WorldReader.m_pWorld->CreateObjects(descs, parentIndices, indexToHandle.GetArrayPtr().GetSubArray(uiFirstHandleIndex), createdObjects);
 
-    if (!godesc.m_sGlobalKey.IsEmpty())
+    for (ezUInt32 i = 0; i < uiBatchCount; ++i)
     {
-      pObject->SetGlobalKey(godesc.m_sGlobalKey);
+      const ezString& sGlobalKey = objects[uiBatchStart + i].m_sGlobalKey;
+      if (!sGlobalKey.IsEmpty())
+      {
+        createdObjects[i]->SetGlobalKey(sGlobalKey);
+      }
     }
 
     if (out_CreatedObjects)
     {
-      out_CreatedObjects->PushBack(pObject);
+      out_CreatedObjects->PushBackRange(createdObjects);
     }
 
-    ++m_uiCurrentIndex;
+    m_uiCurrentIndex += uiBatchCount;
 
     // exit here to ensure that we at least did some work
     if (ezTime::Now() >= endTime)
@@ -572,16 +654,17 @@ bool ezWorldReader::InstantiationContext::CreateComponents(ezTime endTime)
 
     while (m_uiCurrentIndex < compTypeInfo.m_uiNumComponents)
     {
-      const ezGameObjectHandle hOwner = m_WorldReader.ReadGameObjectHandle();
-
-      ezUInt32 uiComponentIdx = 0;
-      s >> uiComponentIdx;
-
-      bool bActive = true;
-      s >> bActive;
+      ComponentToCreate toCreate;
+      if (m_bPrepared)
+      {
+        toCreate = m_PreparedComponents[(ezUInt32)m_uiCurrentNumComponentsProcessed];
+      }
+      else
+      {
+        ReadComponentToCreate(s, toCreate);
+      }
 
-      ezUInt8 userFlags = 0;
-      s >> userFlags;
+      const ezGameObjectHandle hOwner = m_WorldReader.m_IndexToGameObjectHandle[toCreate.m_uiOwnerIndex];
 
       ezGameObject* pOwnerObject = nullptr;
       m_WorldReader.m_pWorld->TryGetObject(hOwner, pOwnerObject);
@@ -591,14 +674,14 @@ bool ezWorldReader::InstantiationContext::CreateComponents(ezTime endTime)
       ezComponent* pComponent = nullptr;
       auto hComponent = pManager->CreateComponentNoInit(pOwnerObject, pComponent);
 
-      pComponent->SetActiveFlag(bActive);
+      pComponent->SetActiveFlag(toCreate.m_bActive);
 
       for (ezUInt8 j = 0; j < 8; ++j)
       {
-        pComponent->SetUserFlag(j, (userFlags & EZ_BIT(j)) != 0);
+        pComponent->SetUserFlag(j, (toCreate.m_uiUserFlags & EZ_BIT(j)) != 0);
       }
 
-      EZ_ASSERT_DEBUG(uiComponentIdx == compTypeInfo.m_ComponentIndexToHandle.GetCount(), "Component index doesn't match");
+      EZ_ASSERT_DEBUG(toCreate.m_uiComponentIndex == compTypeInfo.m_ComponentIndexToHandle.GetCount(), "Component index doesn't match");
       compTypeInfo.m_ComponentIndexToHandle.PushBack(hComponent);
 
       ++m_uiCurrentIndex;
@@ -720,6 +803,60 @@ bool ezWorldReader::InstantiationContext::AddComponentsToBatch(ezTime endTime)
   return true;
 }
 
+void ezWorldReader::InstantiationContext::PrepareOnWorkerThread()
+{
+  EZ_PROFILE_SCOPE("ezWorldReader::PrepareOnWorkerThread");
+
+  const auto& rootObjects = m_WorldReader.m_RootObjectsToCreate;
+  const auto& childObjects = m_WorldReader.m_ChildObjectsToCreate;
+
+  m_PreparedObjectDescs.SetCount(rootObjects.GetCount() + childObjects.GetCount());
+
+  for (ezUInt32 i = 0; i < rootObjects.GetCount(); ++i)
+  {
+    if (m_bUseTransform)
+    {
+      PrepareGameObjectDesc<true>(rootObjects[i], m_PreparedObjectDescs[i]);
+    }
+    else
+    {
+      PrepareGameObjectDesc<false>(rootObjects[i], m_PreparedObjectDescs[i]);
+    }
+  }
+
+  for (ezUInt32 i = 0; i < childObjects.GetCount(); ++i)
+  {
+    PrepareGameObjectDesc<false>(childObjects[i], m_PreparedObjectDescs[rootObjects.GetCount() + i]);
+  }
+
+  // the creation data only consists of plain values, so it can be decoded without the string deduplication context
+  ezMemoryStreamReader reader(&m_WorldReader.m_ComponentCreationStream);
+  m_PreparedComponents.Reserve((ezUInt32)m_WorldReader.m_uiTotalNumComponents);
+
+  for (const auto& compTypeInfo : m_WorldReader.m_ComponentTypes)
+  {
+    if (compTypeInfo.m_pRtti == nullptr)
+      continue;
+
+    for (ezUInt32 i = 0; i < compTypeInfo.m_uiNumComponents; ++i)
+    {
+      ReadComponentToCreate(reader, m_PreparedComponents.ExpandAndGetRef());
+    }
+  }
+}
+
+void ezWorldReader::InstantiationContext::WaitForPreparation()
+{
+  if (m_pPrepareTask != nullptr)
+  {
+    // the task writes to this context and reads from the world reader, so it has to be finished before either can be used or destroyed
+    ezTaskSystem::WaitForGroup(m_PrepareTaskGroup);
+
+    m_pPrepareTask = nullptr;
+    m_bPrepared = true;
+  }
+}
+
 void ezWorldReader::InstantiationContext::BeginNextProgressStep(const char* szName)
 {
   if (m_pOverallProgressRange != nullptr)
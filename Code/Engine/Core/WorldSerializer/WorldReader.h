@@ -3,6 +3,7 @@
 #include <Core/World/World.h>
 #include <Foundation/IO/MemoryStream.h>
 #include <Foundation/IO/Stream.h>
+#include <Foundation/Threading/TaskSystem.h>
 #include <Foundation/Time/Time.h>
 #include <Foundation/Types/UniquePtr.h>
 
@@ -33,6 +34,13 @@ struct ezPrefabInstantiationOptions
 
   ezTime m_MaxStepTime = ezTime::Zero();
 
+  /// \brief If set and m_MaxStepTime is positive, the game object descriptions and component creation data are prepared on a worker thread.
+  ///
+  /// The returned context reports ContinueNextFrame until the worker is done, so the world is only locked for committing the prepared
+  /// objects in batches and for creating and deserializing the components. All data that is passed in through pointers has to stay valid
+  /// until the instantiation is finished.
+  bool m_bPrepareOnWorkerThread = false;
+
   ezProgress* m_pProgress = nullptr;
 };
 
@@ -155,7 +163,16 @@ private:
     ezUInt32 m_uiParentHandleIdx;
   };
 
+  struct ComponentToCreate
+  {
+    ezUInt32 m_uiOwnerIndex = 0;
+    ezUInt32 m_uiComponentIndex = 0;
+    bool m_bActive = true;
+    ezUInt8 m_uiUserFlags = 0;
+  };
+
   void ReadGameObjectDesc(GameObjectToCreate& godesc);
+  static void ReadComponentToCreate(ezStreamReader& stream, ComponentToCreate& out_ComponentToCreate);
   void ReadComponentTypeInfo(ezUInt32 uiComponentTypeIdx);
   void ReadComponentDataToMemStream();
   void ClearHandles();
@@ -195,26 +212,42 @@ private:
     virtual void Cancel() override;
 
     template <bool UseTransform>
-    bool CreateGameObjects(const ezDynamicArray<GameObjectToCreate>& objects, ezGameObjectHandle hParent, ezHybridArray<ezGameObject*, 8>* out_CreatedObjects, ezTime endTime);
+    void PrepareGameObjectDesc(const GameObjectToCreate& godesc, ezGameObjectDesc& out_Desc);
+
+    template <bool UseTransform>
+    bool CreateGameObjects(const ezDynamicArray<GameObjectToCreate>& objects, ezUInt32 uiFirstObjectIndex, ezGameObjectHandle hParent, ezHybridArray<ezGameObject*, 8>* out_CreatedObjects, ezTime endTime);
 
     bool CreateComponents(ezTime endTime);
     bool DeserializeComponents(ezTime endTime);
     bool AddComponentsToBatch(ezTime endTime);
 
   private:
+    void PrepareOnWorkerThread();
+    void WaitForPreparation();
+
     void BeginNextProgressStep(const char* szName);
     void SetSubProgressCompletion(double fCompletion);
 
     friend class ezWorldReader;
     ezWorldReader& m_WorldReader;
 
-    bool m_bUseTransform = false;
+    bool m_bUseTransform = false;
     ezTransform m_RootTransform;
-
+
     ezPrefabInstantiationOptions m_Options;
 
     ezComponentInitBatchHandle m_hComponentInitBatch;
 
+    // Data prepared on a worker thread, only valid if m_bPrepared is set
+    ezSharedPtr<ezTask> m_pPrepareTask;
+    ezTaskGroupID m_PrepareTaskGroup;
+    bool m_bPrepared = false;
+    ezDynamicArray<ezGameObjectDesc> m_PreparedObjectDescs;
+    ezDynamicArray<ComponentToCreate> m_PreparedComponents;
+
+    // Descs of the current batch if nothing was prepared on a worker thread
+    ezDynamicArray<ezGameObjectDesc> m_BatchObjectDescs;
+
     // Current state
     struct Phase
     {
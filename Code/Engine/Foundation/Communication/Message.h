@@ -44,6 +44,12 @@ public:
   /// \brief Derived message types can override this method to influence sorting order. Smaller keys are processed first.
   virtual ezInt32 GetSortingKey() const { return 0; }
 
+  /// \brief Derived message types can return true to allow ezWorld to deliver queued messages of this type to different receivers in parallel.
+  ///
+  /// Messages for the same receiver object are still delivered in order on one thread. The message handlers must only modify the
+  /// receiving object and its components and must not create, delete or look up other objects for writing.
+  virtual bool CanBeDeliveredInParallel() const { return false; }
+
   /// \brief Returns the id for this message type.
   EZ_ALWAYS_INLINE ezMessageId GetId() const { return m_Id; }
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Foundation/Algorithm/HashingUtils.h>
+#include <Foundation/Containers/HashTableStorage.h>
 #include <Foundation/Math/Math.h>
 #include <Foundation/Memory/AllocatorWrapper.h>
 
@@ -12,9 +13,10 @@
 /// All insertion/erasure/lookup functions take O(1) time if the table does not need to be expanded,
 /// which happens when the load gets greater than 60%.
 /// The hash function can be customized by providing a Hasher helper class like ezHashHelper.
+/// How the set keeps track of used entries and probes for keys can be customized with a storage policy.
 
-/// \see ezHashHelper
-template <typename KeyType, typename Hasher>
+/// \see ezHashHelper, ezHashTableLinearStorage, ezHashTableGroupedStorage
+template <typename KeyType, typename Hasher, typename Storage = ezHashTableLinearStorage>
 class ezHashSetBase
 {
 public:
@@ -26,10 +28,10 @@ public:
     bool IsValid() const; // [tested]
 
     /// \brief Checks whether the two iterators point to the same element.
-    bool operator==(const typename ezHashSetBase<KeyType, Hasher>::ConstIterator& rhs) const;
+    bool operator==(const typename ezHashSetBase<KeyType, Hasher, Storage>::ConstIterator& rhs) const;
 
     /// \brief Checks whether the two iterators point to the same element.
-    bool operator!=(const typename ezHashSetBase<KeyType, Hasher>::ConstIterator& rhs) const;
+    bool operator!=(const typename ezHashSetBase<KeyType, Hasher, Storage>::ConstIterator& rhs) const;
 
     /// \brief Returns the 'key' of the element that this iterator points to.
     const KeyType& Key() const; // [tested]
@@ -44,13 +46,13 @@ public:
     void operator++(); // [tested]
 
   protected:
-    friend class ezHashSetBase<KeyType, Hasher>;
+    friend class ezHashSetBase<KeyType, Hasher, Storage>;
 
-    explicit ConstIterator(const ezHashSetBase<KeyType, Hasher>& hashSet);
+    explicit ConstIterator(const ezHashSetBase<KeyType, Hasher, Storage>& hashSet);
     void SetToBegin();
     void SetToEnd();
 
-    const ezHashSetBase<KeyType, Hasher>* m_hashSet = nullptr;
+    const ezHashSetBase<KeyType, Hasher, Storage>* m_hashSet = nullptr;
     ezUInt32 m_uiCurrentIndex = 0; // current element index that this iterator points to.
     ezUInt32 m_uiCurrentCount = 0; // current number of valid elements that this iterator has found so far.
   };
@@ -60,26 +62,26 @@ protected:
   ezHashSetBase(ezAllocatorBase* pAllocator); // [tested]
 
   /// \brief Creates a copy of the given hashset.
-  ezHashSetBase(const ezHashSetBase<KeyType, Hasher>& rhs, ezAllocatorBase* pAllocator); // [tested]
+  ezHashSetBase(const ezHashSetBase<KeyType, Hasher, Storage>& rhs, ezAllocatorBase* pAllocator); // [tested]
 
   /// \brief Moves data from an existing hashtable into this one.
-  ezHashSetBase(ezHashSetBase<KeyType, Hasher>&& rhs, ezAllocatorBase* pAllocator); // [tested]
+  ezHashSetBase(ezHashSetBase<KeyType, Hasher, Storage>&& rhs, ezAllocatorBase* pAllocator); // [tested]
 
   /// \brief Destructor.
   ~ezHashSetBase(); // [tested]
 
   /// \brief Copies the data from another hashset into this one.
-  void operator=(const ezHashSetBase<KeyType, Hasher>& rhs); // [tested]
+  void operator=(const ezHashSetBase<KeyType, Hasher, Storage>& rhs); // [tested]
 
   /// \brief Moves data from an existing hashset into this one.
-  void operator=(ezHashSetBase<KeyType, Hasher>&& rhs); // [tested]
+  void operator=(ezHashSetBase<KeyType, Hasher, Storage>&& rhs); // [tested]
 
 public:
   /// \brief Compares this table to another table.
-  bool operator==(const ezHashSetBase<KeyType, Hasher>& rhs) const; // [tested]
+  bool operator==(const ezHashSetBase<KeyType, Hasher, Storage>& rhs) const; // [tested]
 
   /// \brief Compares this table to another table.
-  bool operator!=(const ezHashSetBase<KeyType, Hasher>& rhs) const; // [tested]
+  bool operator!=(const ezHashSetBase<KeyType, Hasher, Storage>& rhs) const; // [tested]
 
   /// \brief Expands the hashset by over-allocating the internal storage so that the load factor is lower or equal to 60% when inserting the
   /// given number of entries.
@@ -114,16 +116,16 @@ public:
   bool Contains(const KeyType& key) const; // [tested]
 
   /// \brief Checks whether all keys of the given set are in the container.
-  bool ContainsSet(const ezHashSetBase<KeyType, Hasher>& operand) const; // [tested]
+  bool ContainsSet(const ezHashSetBase<KeyType, Hasher, Storage>& operand) const; // [tested]
 
   /// \brief Makes this set the union of itself and the operand.
-  void Union(const ezHashSetBase<KeyType, Hasher>& operand); // [tested]
+  void Union(const ezHashSetBase<KeyType, Hasher, Storage>& operand); // [tested]
 
   /// \brief Makes this set the difference of itself and the operand, i.e. subtracts operand.
-  void Difference(const ezHashSetBase<KeyType, Hasher>& operand); // [tested]
+  void Difference(const ezHashSetBase<KeyType, Hasher, Storage>& operand); // [tested]
 
   /// \brief Makes this set the intersection of itself and the operand.
-  void Intersection(const ezHashSetBase<KeyType, Hasher>& operand); // [tested]
+  void Intersection(const ezHashSetBase<KeyType, Hasher, Storage>& operand); // [tested]
 
   /// \brief Returns a constant Iterator to the very first element.
   ConstIterator GetIterator() const; // [tested]
@@ -139,11 +141,11 @@ public:
   ezUInt64 GetHeapMemoryUsage() const; // [tested]
 
   /// \brief Swaps this map with the other one.
-  void Swap(ezHashSetBase<KeyType, Hasher>& other); // [tested]
+  void Swap(ezHashSetBase<KeyType, Hasher, Storage>& other); // [tested]
 
 private:
   KeyType* m_pEntries;
-  ezUInt32* m_pEntryFlags;
+  Storage m_Storage;
 
   ezUInt32 m_uiCount;
   ezUInt32 m_uiCapacity;
@@ -152,10 +154,6 @@ private:
 
   enum
   {
-    FREE_ENTRY = 0,
-    VALID_ENTRY = 1,
-    DELETED_ENTRY = 2,
-    FLAGS_MASK = 3,
     CAPACITY_ALIGNMENT = 32
   };
 
@@ -164,60 +162,51 @@ private:
   ezUInt32 FindEntry(const KeyType& key) const;
   ezUInt32 FindEntry(ezUInt32 uiHash, const KeyType& key) const;
 
-  ezUInt32 GetFlagsCapacity() const;
-  ezUInt32 GetFlags(ezUInt32* pFlags, ezUInt32 uiEntryIndex) const;
-  void SetFlags(ezUInt32 uiEntryIndex, ezUInt32 uiFlags);
-
-  bool IsFreeEntry(ezUInt32 uiEntryIndex) const;
   bool IsValidEntry(ezUInt32 uiEntryIndex) const;
-  bool IsDeletedEntry(ezUInt32 uiEntryIndex) const;
-
-  void MarkEntryAsFree(ezUInt32 uiEntryIndex);
-  void MarkEntryAsValid(ezUInt32 uiEntryIndex);
-  void MarkEntryAsDeleted(ezUInt32 uiEntryIndex);
 };
 
 /// \brief \see ezHashSetBase
-template <typename KeyType, typename Hasher = ezHashHelper<KeyType>, typename AllocatorWrapper = ezDefaultAllocatorWrapper>
-class ezHashSet : public ezHashSetBase<KeyType, Hasher>
+template <typename KeyType, typename Hasher = ezHashHelper<KeyType>, typename AllocatorWrapper = ezDefaultAllocatorWrapper,
+  typename Storage = ezHashTableLinearStorage>
+class ezHashSet : public ezHashSetBase<KeyType, Hasher, Storage>
 {
 public:
   ezHashSet();
   ezHashSet(ezAllocatorBase* pAllocator);
 
-  ezHashSet(const ezHashSet<KeyType, Hasher, AllocatorWrapper>& other);
-  ezHashSet(const ezHashSetBase<KeyType, Hasher>& other);
+  ezHashSet(const ezHashSet<KeyType, Hasher, AllocatorWrapper, Storage>& other);
+  ezHashSet(const ezHashSetBase<KeyType, Hasher, Storage>& other);
 
-  ezHashSet(ezHashSet<KeyType, Hasher, AllocatorWrapper>&& other);
-  ezHashSet(ezHashSetBase<KeyType, Hasher>&& other);
+  ezHashSet(ezHashSet<KeyType, Hasher, AllocatorWrapper, Storage>&& other);
+  ezHashSet(ezHashSetBase<KeyType, Hasher, Storage>&& other);
 
-  void operator=(const ezHashSet<KeyType, Hasher, AllocatorWrapper>& rhs);
-  void operator=(const ezHashSetBase<KeyType, Hasher>& rhs);
+  void operator=(const ezHashSet<KeyType, Hasher, AllocatorWrapper, Storage>& rhs);
+  void operator=(const ezHashSetBase<KeyType, Hasher, Storage>& rhs);
 
-  void operator=(ezHashSet<KeyType, Hasher, AllocatorWrapper>&& rhs);
-  void operator=(ezHashSetBase<KeyType, Hasher>&& rhs);
+  void operator=(ezHashSet<KeyType, Hasher, AllocatorWrapper, Storage>&& rhs);
+  void operator=(ezHashSetBase<KeyType, Hasher, Storage>&& rhs);
 };
 
-template <typename KeyType, typename Hasher>
-typename ezHashSetBase<KeyType, Hasher>::ConstIterator begin(const ezHashSetBase<KeyType, Hasher>& set)
+template <typename KeyType, typename Hasher, typename Storage>
+typename ezHashSetBase<KeyType, Hasher, Storage>::ConstIterator begin(const ezHashSetBase<KeyType, Hasher, Storage>& set)
 {
   return set.GetIterator();
 }
 
-template <typename KeyType, typename Hasher>
-typename ezHashSetBase<KeyType, Hasher>::ConstIterator cbegin(const ezHashSetBase<KeyType, Hasher>& set)
+template <typename KeyType, typename Hasher, typename Storage>
+typename ezHashSetBase<KeyType, Hasher, Storage>::ConstIterator cbegin(const ezHashSetBase<KeyType, Hasher, Storage>& set)
 {
   return set.GetIterator();
 }
 
-template <typename KeyType, typename Hasher>
-typename ezHashSetBase<KeyType, Hasher>::ConstIterator end(const ezHashSetBase<KeyType, Hasher>& set)
+template <typename KeyType, typename Hasher, typename Storage>
+typename ezHashSetBase<KeyType, Hasher, Storage>::ConstIterator end(const ezHashSetBase<KeyType, Hasher, Storage>& set)
 {
   return set.GetEndIterator();
 }
 
-template <typename KeyType, typename Hasher>
-typename ezHashSetBase<KeyType, Hasher>::ConstIterator cend(const ezHashSetBase<KeyType, Hasher>& set)
+template <typename KeyType, typename Hasher, typename Storage>
+typename ezHashSetBase<KeyType, Hasher, Storage>::ConstIterator cend(const ezHashSetBase<KeyType, Hasher, Storage>& set)
 {
   return set.GetEndIterator();
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Foundation/Algorithm/HashingUtils.h>
+#include <Foundation/Containers/HashTableStorage.h>
 #include <Foundation/Math/Math.h>
 #include <Foundation/Memory/AllocatorWrapper.h>
 
@@ -12,9 +13,11 @@
 /// All insertion/erasure/lookup functions take O(1) time if the table does not need to be expanded,
 /// which happens when the load gets greater than 60%.
 /// The hash function can be customized by providing a Hasher helper class like ezHashHelper.
+/// How the table keeps track of used entries and probes for keys can be customized with a storage policy.
+/// ezHashTableGroupedStorage is faster for keys that are expensive to compare and for tables with many failed lookups.
 
-/// \see ezHashHelper
-template <typename KeyType, typename ValueType, typename Hasher>
+/// \see ezHashHelper, ezHashTableLinearStorage, ezHashTableGroupedStorage
+template <typename KeyType, typename ValueType, typename Hasher, typename Storage = ezHashTableLinearStorage>
 class ezHashTableBase
 {
 public:
@@ -27,10 +30,10 @@ public:
     bool IsValid() const; // [tested]
 
     /// \brief Checks whether the two iterators point to the same element.
-    bool operator==(const typename ezHashTableBase<KeyType, ValueType, Hasher>::ConstIterator& rhs) const;
+    bool operator==(const typename ezHashTableBase<KeyType, ValueType, Hasher, Storage>::ConstIterator& rhs) const;
 
     /// \brief Checks whether the two iterators point to the same element.
-    bool operator!=(const typename ezHashTableBase<KeyType, ValueType, Hasher>::ConstIterator& rhs) const;
+    bool operator!=(const typename ezHashTableBase<KeyType, ValueType, Hasher, Storage>::ConstIterator& rhs) const;
 
     /// \brief Returns the 'key' of the element that this iterator points to.
     const KeyType& Key() const; // [tested]
@@ -48,13 +51,13 @@ public:
     EZ_ALWAYS_INLINE ConstIterator& operator*() { return *this; } // [tested]
 
   protected:
-    friend class ezHashTableBase<KeyType, ValueType, Hasher>;
+    friend class ezHashTableBase<KeyType, ValueType, Hasher, Storage>;
 
-    explicit ConstIterator(const ezHashTableBase<KeyType, ValueType, Hasher>& hashTable);
+    explicit ConstIterator(const ezHashTableBase<KeyType, ValueType, Hasher, Storage>& hashTable);
     void SetToBegin();
     void SetToEnd();
 
-    const ezHashTableBase<KeyType, ValueType, Hasher>* m_hashTable = nullptr;
+    const ezHashTableBase<KeyType, ValueType, Hasher, Storage>* m_hashTable = nullptr;
     ezUInt32 m_uiCurrentIndex = 0; // current element index that this iterator points to.
     ezUInt32 m_uiCurrentCount = 0; // current number of valid elements that this iterator has found so far.
   };
@@ -80,9 +83,9 @@ public:
     EZ_ALWAYS_INLINE Iterator& operator*() { return *this; } // [tested]
 
   private:
-    friend class ezHashTableBase<KeyType, ValueType, Hasher>;
+    friend class ezHashTableBase<KeyType, ValueType, Hasher, Storage>;
 
-    explicit Iterator(const ezHashTableBase<KeyType, ValueType, Hasher>& hashTable);
+    explicit Iterator(const ezHashTableBase<KeyType, ValueType, Hasher, Storage>& hashTable);
   };
 
 protected:
@@ -90,26 +93,26 @@ protected:
   ezHashTableBase(ezAllocatorBase* pAllocator); // [tested]
 
   /// \brief Creates a copy of the given hashtable.
-  ezHashTableBase(const ezHashTableBase<KeyType, ValueType, Hasher>& rhs, ezAllocatorBase* pAllocator); // [tested]
+  ezHashTableBase(const ezHashTableBase<KeyType, ValueType, Hasher, Storage>& rhs, ezAllocatorBase* pAllocator); // [tested]
 
   /// \brief Moves data from an existing hashtable into this one.
-  ezHashTableBase(ezHashTableBase<KeyType, ValueType, Hasher>&& rhs, ezAllocatorBase* pAllocator); // [tested]
+  ezHashTableBase(ezHashTableBase<KeyType, ValueType, Hasher, Storage>&& rhs, ezAllocatorBase* pAllocator); // [tested]
 
   /// \brief Destructor.
   ~ezHashTableBase(); // [tested]
 
   /// \brief Copies the data from another hashtable into this one.
-  void operator=(const ezHashTableBase<KeyType, ValueType, Hasher>& rhs); // [tested]
+  void operator=(const ezHashTableBase<KeyType, ValueType, Hasher, Storage>& rhs); // [tested]
 
   /// \brief Moves data from an existing hashtable into this one.
-  void operator=(ezHashTableBase<KeyType, ValueType, Hasher>&& rhs); // [tested]
+  void operator=(ezHashTableBase<KeyType, ValueType, Hasher, Storage>&& rhs); // [tested]
 
 public:
   /// \brief Compares this table to another table.
-  bool operator==(const ezHashTableBase<KeyType, ValueType, Hasher>& rhs) const; // [tested]
+  bool operator==(const ezHashTableBase<KeyType, ValueType, Hasher, Storage>& rhs) const; // [tested]
 
   /// \brief Compares this table to another table.
-  bool operator!=(const ezHashTableBase<KeyType, ValueType, Hasher>& rhs) const; // [tested]
+  bool operator!=(const ezHashTableBase<KeyType, ValueType, Hasher, Storage>& rhs) const; // [tested]
 
   /// \brief Expands the hashtable by over-allocating the internal storage so that the load factor is lower or equal to 60% when inserting the given
   /// number of entries.
@@ -200,7 +203,7 @@ public:
   ezUInt64 GetHeapMemoryUsage() const; // [tested]
 
   /// \brief Swaps this map with the other one.
-  void Swap(ezHashTableBase<KeyType, ValueType, Hasher>& other); // [tested]
+  void Swap(ezHashTableBase<KeyType, ValueType, Hasher, Storage>& other); // [tested]
 
 
 private:
@@ -211,7 +214,7 @@ private:
   };
 
   Entry* m_pEntries;
-  ezUInt32* m_pEntryFlags;
+  Storage m_Storage;
 
   ezUInt32 m_uiCount;
   ezUInt32 m_uiCapacity;
@@ -220,10 +223,6 @@ private:
 
   enum
   {
-    FREE_ENTRY = 0,
-    VALID_ENTRY = 1,
-    DELETED_ENTRY = 2,
-    FLAGS_MASK = 3,
     CAPACITY_ALIGNMENT = 32
   };
 
@@ -236,76 +235,67 @@ private:
   template <typename CompatibleKeyType>
   ezUInt32 FindEntry(ezUInt32 uiHash, const CompatibleKeyType& key) const;
 
-  ezUInt32 GetFlagsCapacity() const;
-  ezUInt32 GetFlags(ezUInt32* pFlags, ezUInt32 uiEntryIndex) const;
-  void SetFlags(ezUInt32 uiEntryIndex, ezUInt32 uiFlags);
-
-  bool IsFreeEntry(ezUInt32 uiEntryIndex) const;
   bool IsValidEntry(ezUInt32 uiEntryIndex) const;
-  bool IsDeletedEntry(ezUInt32 uiEntryIndex) const;
-
-  void MarkEntryAsFree(ezUInt32 uiEntryIndex);
-  void MarkEntryAsValid(ezUInt32 uiEntryIndex);
-  void MarkEntryAsDeleted(ezUInt32 uiEntryIndex);
 };
 
 /// \brief \see ezHashTableBase
-template <typename KeyType, typename ValueType, typename Hasher = ezHashHelper<KeyType>, typename AllocatorWrapper = ezDefaultAllocatorWrapper>
-class ezHashTable : public ezHashTableBase<KeyType, ValueType, Hasher>
+template <typename KeyType, typename ValueType, typename Hasher = ezHashHelper<KeyType>, typename AllocatorWrapper = ezDefaultAllocatorWrapper,
+  typename Storage = ezHashTableLinearStorage>
+class ezHashTable : public ezHashTableBase<KeyType, ValueType, Hasher, Storage>
 {
 public:
   ezHashTable();
   ezHashTable(ezAllocatorBase* pAllocator);
 
-  ezHashTable(const ezHashTable<KeyType, ValueType, Hasher, AllocatorWrapper>& other);
-  ezHashTable(const ezHashTableBase<KeyType, ValueType, Hasher>& other);
+  ezHashTable(const ezHashTable<KeyType, ValueType, Hasher, AllocatorWrapper, Storage>& other);
+  ezHashTable(const ezHashTableBase<KeyType, ValueType, Hasher, Storage>& other);
 
-  ezHashTable(ezHashTable<KeyType, ValueType, Hasher, AllocatorWrapper>&& other);
-  ezHashTable(ezHashTableBase<KeyType, ValueType, Hasher>&& other);
+  ezHashTable(ezHashTable<KeyType, ValueType, Hasher, AllocatorWrapper, Storage>&& other);
+  ezHashTable(ezHashTableBase<KeyType, ValueType, Hasher, Storage>&& other);
 
 
-  void operator=(const ezHashTable<KeyType, ValueType, Hasher, AllocatorWrapper>& rhs);
-  void operator=(const ezHashTableBase<KeyType, ValueType, Hasher>& rhs);
+  void operator=(const ezHashTable<KeyType, ValueType, Hasher, AllocatorWrapper, Storage>& rhs);
+  void operator=(const ezHashTableBase<KeyType, ValueType, Hasher, Storage>& rhs);
 
-  void operator=(ezHashTable<KeyType, ValueType, Hasher, AllocatorWrapper>&& rhs);
-  void operator=(ezHashTableBase<KeyType, ValueType, Hasher>&& rhs);
+  void operator=(ezHashTable<KeyType, ValueType, Hasher, AllocatorWrapper, Storage>&& rhs);
+  void operator=(ezHashTableBase<KeyType, ValueType, Hasher, Storage>&& rhs);
 };
 
 //////////////////////////////////////////////////////////////////////////
 // begin() /end() for range-based for-loop support
 
-template <typename KeyType, typename ValueType, typename Hasher>
-typename ezHashTableBase<KeyType, ValueType, Hasher>::Iterator begin(ezHashTableBase<KeyType, ValueType, Hasher>& container)
+template <typename KeyType, typename ValueType, typename Hasher, typename Storage>
+typename ezHashTableBase<KeyType, ValueType, Hasher, Storage>::Iterator begin(ezHashTableBase<KeyType, ValueType, Hasher, Storage>& container)
 {
   return container.GetIterator();
 }
 
-template <typename KeyType, typename ValueType, typename Hasher>
-typename ezHashTableBase<KeyType, ValueType, Hasher>::ConstIterator begin(const ezHashTableBase<KeyType, ValueType, Hasher>& container)
+template <typename KeyType, typename ValueType, typename Hasher, typename Storage>
+typename ezHashTableBase<KeyType, ValueType, Hasher, Storage>::ConstIterator begin(const ezHashTableBase<KeyType, ValueType, Hasher, Storage>& container)
 {
   return container.GetIterator();
 }
 
-template <typename KeyType, typename ValueType, typename Hasher>
-typename ezHashTableBase<KeyType, ValueType, Hasher>::ConstIterator cbegin(const ezHashTableBase<KeyType, ValueType, Hasher>& container)
+template <typename KeyType, typename ValueType, typename Hasher, typename Storage>
+typename ezHashTableBase<KeyType, ValueType, Hasher, Storage>::ConstIterator cbegin(const ezHashTableBase<KeyType, ValueType, Hasher, Storage>& container)
 {
   return container.GetIterator();
 }
 
-template <typename KeyType, typename ValueType, typename Hasher>
-typename ezHashTableBase<KeyType, ValueType, Hasher>::Iterator end(ezHashTableBase<KeyType, ValueType, Hasher>& container)
+template <typename KeyType, typename ValueType, typename Hasher, typename Storage>
+typename ezHashTableBase<KeyType, ValueType, Hasher, Storage>::Iterator end(ezHashTableBase<KeyType, ValueType, Hasher, Storage>& container)
 {
   return container.GetEndIterator();
 }
 
-template <typename KeyType, typename ValueType, typename Hasher>
-typename ezHashTableBase<KeyType, ValueType, Hasher>::ConstIterator end(const ezHashTableBase<KeyType, ValueType, Hasher>& container)
+template <typename KeyType, typename ValueType, typename Hasher, typename Storage>
+typename ezHashTableBase<KeyType, ValueType, Hasher, Storage>::ConstIterator end(const ezHashTableBase<KeyType, ValueType, Hasher, Storage>& container)
 {
   return container.GetEndIterator();
 }
 
-template <typename KeyType, typename ValueType, typename Hasher>
-typename ezHashTableBase<KeyType, ValueType, Hasher>::ConstIterator cend(const ezHashTableBase<KeyType, ValueType, Hasher>& container)
+template <typename KeyType, typename ValueType, typename Hasher, typename Storage>
+typename ezHashTableBase<KeyType, ValueType, Hasher, Storage>::ConstIterator cend(const ezHashTableBase<KeyType, ValueType, Hasher, Storage>& container)
 {
   return container.GetEndIterator();
 }
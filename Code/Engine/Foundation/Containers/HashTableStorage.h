@@ -0,0 +1,170 @@
+#pragma once
+
+#include <Foundation/Math/Math.h>
+#include <Foundation/Memory/AllocatorBase.h>
+#include <Foundation/Memory/MemoryUtils.h>
+
+#if EZ_ENABLED(EZ_PLATFORM_ARCH_X86) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#  define EZ_HASHTABLE_GROUP_MATCH_SSE2 EZ_ON
+#  define EZ_HASHTABLE_GROUP_MATCH_NEON EZ_OFF
+#  include <emmintrin.h>
+#elif EZ_ENABLED(EZ_PLATFORM_ARCH_ARM) && (defined(__ARM_NEON) || defined(_M_ARM64))
+#  define EZ_HASHTABLE_GROUP_MATCH_SSE2 EZ_OFF
+#  define EZ_HASHTABLE_GROUP_MATCH_NEON EZ_ON
+#  include <arm_neon.h>
+#else
+#  define EZ_HASHTABLE_GROUP_MATCH_SSE2 EZ_OFF
+#  define EZ_HASHTABLE_GROUP_MATCH_NEON EZ_OFF
+#endif
+
+/// \brief Storage policies decide how ezHashTableBase and ezHashSetBase keep track of which entries are in use and how collisions are resolved.
+///
+/// The containers own the entry array and the allocator, a storage policy only manages the per-entry state next to it.
+/// All functions that take an index and a hash expect the index to be the start position of the probe sequence,
+/// i.e. the hash mapped into [0; uiCapacity). The containers always reserve enough space,
+/// so there is at least one free entry whenever a new entry is about to be inserted.
+
+/// \brief The default storage policy: Two bits of state per entry and linear probing, one entry at a time.
+///
+/// Uses very little memory and is fast for tables with short probe sequences, which is the common case.
+class ezHashTableLinearStorage
+{
+public:
+  /// \brief Allocates the state for uiCapacity entries and marks all of them as free. Previously allocated state must have been deallocated.
+  void Allocate(ezAllocatorBase* pAllocator, ezUInt32 uiCapacity);
+
+  /// \brief Deallocates the state.
+  void Deallocate(ezAllocatorBase* pAllocator);
+
+  /// \brief Marks all entries as free.
+  void Clear(ezUInt32 uiCapacity);
+
+  /// \brief Returns the amount of bytes that are allocated for uiCapacity entries.
+  ezUInt64 GetHeapMemoryUsage(ezUInt32 uiCapacity) const;
+
+  /// \brief Returns whether too many removed entries accumulated, such that the table should be rebuilt at the same capacity.
+  bool NeedsRehash(ezUInt32 uiCount, ezUInt32 uiCapacity) const
+  {
+    EZ_IGNORE_UNUSED(uiCount);
+    EZ_IGNORE_UNUSED(uiCapacity);
+    return false;
+  }
+
+  /// \brief Returns whether the given entry is in use.
+  bool IsValidEntry(ezUInt32 uiEntryIndex) const;
+
+  /// \brief Returns the index of the entry for which isKey(index) returns true, or ezInvalidIndex.
+  template <typename IsKey>
+  ezUInt32 FindEntry(ezUInt32 uiIndex, ezUInt32 uiHash, ezUInt32 uiCapacity, IsKey isKey) const;
+
+  /// \brief Same as FindEntry(), but returns the index at which the key should be inserted, if it is not found.
+  template <typename IsKey>
+  ezUInt32 FindEntryOrInsertPosition(ezUInt32 uiIndex, ezUInt32 uiHash, ezUInt32 uiCapacity, IsKey isKey, bool& out_bFound) const;
+
+  /// \brief Returns the index at which a key that is known not to be in the table should be inserted.
+  ezUInt32 FindInsertPosition(ezUInt32 uiIndex, ezUInt32 uiHash, ezUInt32 uiCapacity) const;
+
+  /// \brief Marks the entry as in use.
+  void MarkEntryAsValid(ezUInt32 uiEntryIndex, ezUInt32 uiHash);
+
+  /// \brief Marks the entry as not in use anymore.
+  void MarkEntryAsRemoved(ezUInt32 uiEntryIndex, ezUInt32 uiCapacity);
+
+private:
+  enum
+  {
+    FREE_ENTRY = 0,
+    VALID_ENTRY = 1,
+    DELETED_ENTRY = 2,
+    FLAGS_MASK = 3,
+  };
+
+  static ezUInt32 GetFlagsCapacity(ezUInt32 uiCapacity);
+  ezUInt32 GetFlags(ezUInt32 uiEntryIndex) const;
+  void SetFlags(ezUInt32 uiEntryIndex, ezUInt32 uiFlags);
+
+  bool IsFreeEntry(ezUInt32 uiEntryIndex) const;
+  bool IsDeletedEntry(ezUInt32 uiEntryIndex) const;
+
+  ezUInt32* m_pEntryFlags = nullptr;
+};
+
+/// \brief Storage policy with one control byte per entry, which probes groups of 16 entries at a time.
+///
+/// Every entry stores 7 bits of its hash in its control byte. A lookup compares the control bytes of a whole group with the hash bits
+/// in a single SSE2 or NEON instruction and only compares the keys of the few entries that match. Groups are probed one after another
+/// until one is found that contains a free entry.
+/// This is faster than ezHashTableLinearStorage for keys that are expensive to compare and especially for lookups of keys
+/// that are not in the table, at the cost of one byte per entry instead of two bits. For cheap keys, like integers, it is rarely worth it.
+///
+/// Select it per instantiation, e.g. ezHashTable<ezString, ezUInt32, ezHashHelper<ezString>, ezDefaultAllocatorWrapper, ezHashTableGroupedStorage>.
+/// Requires the capacity to be a multiple of 16, which ezHashTable and ezHashSet guarantee.
+class ezHashTableGroupedStorage
+{
+public:
+  /// \brief \see ezHashTableLinearStorage::Allocate
+  void Allocate(ezAllocatorBase* pAllocator, ezUInt32 uiCapacity);
+
+  /// \brief \see ezHashTableLinearStorage::Deallocate
+  void Deallocate(ezAllocatorBase* pAllocator);
+
+  /// \brief \see ezHashTableLinearStorage::Clear
+  void Clear(ezUInt32 uiCapacity);
+
+  /// \brief \see ezHashTableLinearStorage::GetHeapMemoryUsage
+  ezUInt64 GetHeapMemoryUsage(ezUInt32 uiCapacity) const;
+
+  /// \brief Returns true, once removed entries and used entries together occupy more than 7/8 of the table.
+  bool NeedsRehash(ezUInt32 uiCount, ezUInt32 uiCapacity) const;
+
+  /// \brief \see ezHashTableLinearStorage::IsValidEntry
+  bool IsValidEntry(ezUInt32 uiEntryIndex) const;
+
+  /// \brief \see ezHashTableLinearStorage::FindEntry
+  template <typename IsKey>
+  ezUInt32 FindEntry(ezUInt32 uiIndex, ezUInt32 uiHash, ezUInt32 uiCapacity, IsKey isKey) const;
+
+  /// \brief \see ezHashTableLinearStorage::FindEntryOrInsertPosition
+  template <typename IsKey>
+  ezUInt32 FindEntryOrInsertPosition(ezUInt32 uiIndex, ezUInt32 uiHash, ezUInt32 uiCapacity, IsKey isKey, bool& out_bFound) const;
+
+  /// \brief \see ezHashTableLinearStorage::FindInsertPosition
+  ezUInt32 FindInsertPosition(ezUInt32 uiIndex, ezUInt32 uiHash, ezUInt32 uiCapacity) const;
+
+  /// \brief \see ezHashTableLinearStorage::MarkEntryAsValid
+  void MarkEntryAsValid(ezUInt32 uiEntryIndex, ezUInt32 uiHash);
+
+  /// \brief \see ezHashTableLinearStorage::MarkEntryAsRemoved
+  void MarkEntryAsRemoved(ezUInt32 uiEntryIndex, ezUInt32 uiCapacity);
+
+private:
+  enum : ezUInt8
+  {
+    EMPTY_ENTRY = 0x80,
+    DELETED_ENTRY = 0xFE,
+  };
+
+  enum
+  {
+    GROUP_SIZE = 16
+  };
+
+#if EZ_ENABLED(EZ_HASHTABLE_GROUP_MATCH_NEON)
+  // NEON has no movemask, every entry is represented by the highest bit of a nibble
+  using GroupMask = ezUInt64;
+#else
+  using GroupMask = ezUInt32;
+#endif
+
+  static ezUInt8 GetHashBits(ezUInt32 uiHash);
+
+  static GroupMask MatchByte(const ezUInt8* pGroup, ezUInt8 uiByte);
+  static GroupMask MatchEmpty(const ezUInt8* pGroup);
+  static GroupMask MatchEmptyOrDeleted(const ezUInt8* pGroup);
+  static ezUInt32 GetLowestEntry(GroupMask mask);
+
+  ezUInt8* m_pControlBytes = nullptr;
+  ezUInt32 m_uiNumDeleted = 0;
+};
+
+#include <Foundation/Containers/Implementation/HashTableStorage_inl.h>
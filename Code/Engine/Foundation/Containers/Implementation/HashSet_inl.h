@@ -6,14 +6,14 @@
 
 // ***** Const Iterator *****
 
-template <typename K, typename H>
-ezHashSetBase<K, H>::ConstIterator::ConstIterator(const ezHashSetBase<K, H>& hashSet)
+template <typename K, typename H, typename S>
+ezHashSetBase<K, H, S>::ConstIterator::ConstIterator(const ezHashSetBase<K, H, S>& hashSet)
   : m_hashSet(&hashSet)
 {
 }
 
-template <typename K, typename H>
-void ezHashSetBase<K, H>::ConstIterator::SetToBegin()
+template <typename K, typename H, typename S>
+void ezHashSetBase<K, H, S>::ConstIterator::SetToBegin()
 {
   if (m_hashSet->IsEmpty())
   {
@@ -26,39 +26,39 @@ void ezHashSetBase<K, H>::ConstIterator::SetToBegin()
   }
 }
 
-template <typename K, typename H>
-inline void ezHashSetBase<K, H>::ConstIterator::SetToEnd()
+template <typename K, typename H, typename S>
+inline void ezHashSetBase<K, H, S>::ConstIterator::SetToEnd()
 {
   m_uiCurrentCount = m_hashSet->m_uiCount;
   m_uiCurrentIndex = m_hashSet->m_uiCapacity;
 }
 
-template <typename K, typename H>
-EZ_ALWAYS_INLINE bool ezHashSetBase<K, H>::ConstIterator::IsValid() const
+template <typename K, typename H, typename S>
+EZ_ALWAYS_INLINE bool ezHashSetBase<K, H, S>::ConstIterator::IsValid() const
 {
   return m_uiCurrentCount < m_hashSet->m_uiCount;
 }
 
-template <typename K, typename H>
-EZ_ALWAYS_INLINE bool ezHashSetBase<K, H>::ConstIterator::operator==(const typename ezHashSetBase<K, H>::ConstIterator& rhs) const
+template <typename K, typename H, typename S>
+EZ_ALWAYS_INLINE bool ezHashSetBase<K, H, S>::ConstIterator::operator==(const typename ezHashSetBase<K, H, S>::ConstIterator& rhs) const
 {
   return m_uiCurrentIndex == rhs.m_uiCurrentIndex && m_hashSet->m_pEntries == rhs.m_hashSet->m_pEntries;
 }
 
-template <typename K, typename H>
-EZ_ALWAYS_INLINE bool ezHashSetBase<K, H>::ConstIterator::operator!=(const typename ezHashSetBase<K, H>::ConstIterator& rhs) const
+template <typename K, typename H, typename S>
+EZ_ALWAYS_INLINE bool ezHashSetBase<K, H, S>::ConstIterator::operator!=(const typename ezHashSetBase<K, H, S>::ConstIterator& rhs) const
 {
   return !(*this == rhs);
 }
 
-template <typename K, typename H>
-EZ_FORCE_INLINE const K& ezHashSetBase<K, H>::ConstIterator::Key() const
+template <typename K, typename H, typename S>
+EZ_FORCE_INLINE const K& ezHashSetBase<K, H, S>::ConstIterator::Key() const
 {
   return m_hashSet->m_pEntries[m_uiCurrentIndex];
 }
 
-template <typename K, typename H>
-void ezHashSetBase<K, H>::ConstIterator::Next()
+template <typename K, typename H, typename S>
+void ezHashSetBase<K, H, S>::ConstIterator::Next()
 {
   ++m_uiCurrentCount;
   if (m_uiCurrentCount == m_hashSet->m_uiCount)
@@ -73,8 +73,8 @@ void ezHashSetBase<K, H>::ConstIterator::Next()
   } while (!m_hashSet->IsValidEntry(m_uiCurrentIndex));
 }
 
-template <typename K, typename H>
-EZ_ALWAYS_INLINE void ezHashSetBase<K, H>::ConstIterator::operator++()
+template <typename K, typename H, typename S>
+EZ_ALWAYS_INLINE void ezHashSetBase<K, H, S>::ConstIterator::operator++()
 {
   Next();
 }
@@ -82,21 +82,19 @@ EZ_ALWAYS_INLINE void ezHashSetBase<K, H>::ConstIterator::operator++()
 
 // ***** ezHashSetBase *****
 
-template <typename K, typename H>
-ezHashSetBase<K, H>::ezHashSetBase(ezAllocatorBase* pAllocator)
+template <typename K, typename H, typename S>
+ezHashSetBase<K, H, S>::ezHashSetBase(ezAllocatorBase* pAllocator)
 {
   m_pEntries = nullptr;
-  m_pEntryFlags = nullptr;
   m_uiCount = 0;
   m_uiCapacity = 0;
   m_pAllocator = pAllocator;
 }
 
-template <typename K, typename H>
-ezHashSetBase<K, H>::ezHashSetBase(const ezHashSetBase<K, H>& other, ezAllocatorBase* pAllocator)
+template <typename K, typename H, typename S>
+ezHashSetBase<K, H, S>::ezHashSetBase(const ezHashSetBase<K, H, S>& other, ezAllocatorBase* pAllocator)
 {
   m_pEntries = nullptr;
-  m_pEntryFlags = nullptr;
   m_uiCount = 0;
   m_uiCapacity = 0;
   m_pAllocator = pAllocator;
@@ -104,11 +102,10 @@ ezHashSetBase<K, H>::ezHashSetBase(const ezHashSetBase<K, H>& other, ezAllocator
   *this = other;
 }
 
-template <typename K, typename H>
-ezHashSetBase<K, H>::ezHashSetBase(ezHashSetBase<K, H>&& other, ezAllocatorBase* pAllocator)
+template <typename K, typename H, typename S>
+ezHashSetBase<K, H, S>::ezHashSetBase(ezHashSetBase<K, H, S>&& other, ezAllocatorBase* pAllocator)
 {
   m_pEntries = nullptr;
-  m_pEntryFlags = nullptr;
   m_uiCount = 0;
   m_uiCapacity = 0;
   m_pAllocator = pAllocator;
@@ -116,17 +113,17 @@ ezHashSetBase<K, H>::ezHashSetBase(ezHashSetBase<K, H>&& other, ezAllocatorBase*
   *this = std::move(other);
 }
 
-template <typename K, typename H>
-ezHashSetBase<K, H>::~ezHashSetBase()
+template <typename K, typename H, typename S>
+ezHashSetBase<K, H, S>::~ezHashSetBase()
 {
   Clear();
   EZ_DELETE_RAW_BUFFER(m_pAllocator, m_pEntries);
-  EZ_DELETE_RAW_BUFFER(m_pAllocator, m_pEntryFlags);
+  m_Storage.Deallocate(m_pAllocator);
   m_uiCapacity = 0;
 }
 
-template <typename K, typename H>
-void ezHashSetBase<K, H>::operator=(const ezHashSetBase<K, H>& rhs)
+template <typename K, typename H, typename S>
+void ezHashSetBase<K, H, S>::operator=(const ezHashSetBase<K, H, S>& rhs)
 {
   Clear();
   Reserve(rhs.GetCount());
@@ -142,8 +139,8 @@ void ezHashSetBase<K, H>::operator=(const ezHashSetBase<K, H>& rhs)
   }
 }
 
-template <typename K, typename H>
-void ezHashSetBase<K, H>::operator=(ezHashSetBase<K, H>&& rhs)
+template <typename K, typename H, typename S>
+void ezHashSetBase<K, H, S>::operator=(ezHashSetBase<K, H, S>&& rhs)
 {
   // Clear any existing data (calls destructors if necessary)
   Clear();
@@ -167,24 +164,24 @@ void ezHashSetBase<K, H>::operator=(ezHashSetBase<K, H>&& rhs)
   else
   {
     EZ_DELETE_RAW_BUFFER(m_pAllocator, m_pEntries);
-    EZ_DELETE_RAW_BUFFER(m_pAllocator, m_pEntryFlags);
+    m_Storage.Deallocate(m_pAllocator);
 
     // Move all data over.
     m_pEntries = rhs.m_pEntries;
-    m_pEntryFlags = rhs.m_pEntryFlags;
+    m_Storage = rhs.m_Storage;
     m_uiCount = rhs.m_uiCount;
     m_uiCapacity = rhs.m_uiCapacity;
 
     // Temp copy forgets all its state.
     rhs.m_pEntries = nullptr;
-    rhs.m_pEntryFlags = nullptr;
+    rhs.m_Storage = S();
     rhs.m_uiCount = 0;
     rhs.m_uiCapacity = 0;
   }
 }
 
-template <typename K, typename H>
-bool ezHashSetBase<K, H>::operator==(const ezHashSetBase<K, H>& rhs) const
+template <typename K, typename H, typename S>
+bool ezHashSetBase<K, H, S>::operator==(const ezHashSetBase<K, H, S>& rhs) const
 {
   if (m_uiCount != rhs.m_uiCount)
     return false;
@@ -204,14 +201,14 @@ bool ezHashSetBase<K, H>::operator==(const ezHashSetBase<K, H>& rhs) const
   return true;
 }
 
-template <typename K, typename H>
-EZ_ALWAYS_INLINE bool ezHashSetBase<K, H>::operator!=(const ezHashSetBase<K, H>& rhs) const
+template <typename K, typename H, typename S>
+EZ_ALWAYS_INLINE bool ezHashSetBase<K, H, S>::operator!=(const ezHashSetBase<K, H, S>& rhs) const
 {
   return !(*this == rhs);
 }
 
-template <typename K, typename H>
-void ezHashSetBase<K, H>::Reserve(ezUInt32 uiCapacity)
+template <typename K, typename H, typename S>
+void ezHashSetBase<K, H, S>::Reserve(ezUInt32 uiCapacity)
 {
   const ezUInt64 uiCap64 = static_cast<ezUInt64>(uiCapacity);
   ezUInt64 uiNewCapacity64 = uiCap64 + (uiCap64 * 2 / 3); // ensure a maximum load of 60%
@@ -222,20 +219,26 @@ void ezHashSetBase<K, H>::Reserve(ezUInt32 uiCapacity)
   EZ_ASSERT_DEBUG(uiCapacity <= uiNewCapacity32, "ezHashSet/Map do not support more than 2 billion entries.");
 
   if (m_uiCapacity >= uiNewCapacity32)
+  {
+    // rebuild the set at the same size, if the storage ran out of free entries for probing
+    if (m_Storage.NeedsRehash(m_uiCount, m_uiCapacity))
+      SetCapacity(m_uiCapacity);
+
     return;
+  }
 
   uiNewCapacity32 = ezMath::Max<ezUInt32>(ezMath::PowerOfTwo_Ceil(uiNewCapacity32), CAPACITY_ALIGNMENT);
   SetCapacity(uiNewCapacity32);
 }
 
-template <typename K, typename H>
-void ezHashSetBase<K, H>::Compact()
+template <typename K, typename H, typename S>
+void ezHashSetBase<K, H, S>::Compact()
 {
   if (IsEmpty())
   {
     // completely deallocate all data, if the table is empty.
     EZ_DELETE_RAW_BUFFER(m_pAllocator, m_pEntries);
-    EZ_DELETE_RAW_BUFFER(m_pAllocator, m_pEntryFlags);
+    m_Storage.Deallocate(m_pAllocator);
     m_uiCapacity = 0;
   }
   else
@@ -246,20 +249,20 @@ void ezHashSetBase<K, H>::Compact()
   }
 }
 
-template <typename K, typename H>
-EZ_ALWAYS_INLINE ezUInt32 ezHashSetBase<K, H>::GetCount() const
+template <typename K, typename H, typename S>
+EZ_ALWAYS_INLINE ezUInt32 ezHashSetBase<K, H, S>::GetCount() const
 {
   return m_uiCount;
 }
 
-template <typename K, typename H>
-EZ_ALWAYS_INLINE bool ezHashSetBase<K, H>::IsEmpty() const
+template <typename K, typename H, typename S>
+EZ_ALWAYS_INLINE bool ezHashSetBase<K, H, S>::IsEmpty() const
 {
   return m_uiCount == 0;
 }
 
-template <typename K, typename H>
-void ezHashSetBase<K, H>::Clear()
+template <typename K, typename H, typename S>
+void ezHashSetBase<K, H, S>::Clear()
 {
   for (ezUInt32 i = 0; i < m_uiCapacity; ++i)
   {
@@ -269,52 +272,40 @@ void ezHashSetBase<K, H>::Clear()
     }
   }
 
-  ezMemoryUtils::ZeroFill(m_pEntryFlags, GetFlagsCapacity());
+  m_Storage.Clear(m_uiCapacity);
   m_uiCount = 0;
 }
 
-template <typename K, typename H>
+template <typename K, typename H, typename S>
 template <typename CompatibleKeyType>
-bool ezHashSetBase<K, H>::Insert(CompatibleKeyType&& key)
+bool ezHashSetBase<K, H, S>::Insert(CompatibleKeyType&& key)
 {
   Reserve(m_uiCount + 1);
 
-  ezUInt32 uiIndex = H::Hash(key) % m_uiCapacity;
-  ezUInt32 uiDeletedIndex = ezInvalidIndex;
+  const ezUInt32 uiHash = H::Hash(key);
 
-  ezUInt32 uiCounter = 0;
-  while (!IsFreeEntry(uiIndex) && uiCounter < m_uiCapacity)
-  {
-    if (IsDeletedEntry(uiIndex))
-    {
-      if (uiDeletedIndex == ezInvalidIndex)
-        uiDeletedIndex = uiIndex;
-    }
-    else if (H::Equal(m_pEntries[uiIndex], key))
-    {
-      return true;
-    }
-    ++uiIndex;
-    if (uiIndex == m_uiCapacity)
-      uiIndex = 0;
+  bool bFound = false;
+  const ezUInt32 uiIndex = m_Storage.FindEntryOrInsertPosition(
+    uiHash % m_uiCapacity, uiHash, m_uiCapacity, [&](ezUInt32 uiEntryIndex) { return H::Equal(m_pEntries[uiEntryIndex], key); }, bFound);
 
-    ++uiCounter;
+  if (bFound)
+  {
+    return true;
   }
 
   // new entry
-  uiIndex = uiDeletedIndex != ezInvalidIndex ? uiDeletedIndex : uiIndex;
 
   // Constructions might either be a move or a copy.
   ezMemoryUtils::CopyOrMoveConstruct(&m_pEntries[uiIndex], std::forward<CompatibleKeyType>(key));
 
-  MarkEntryAsValid(uiIndex);
+  m_Storage.MarkEntryAsValid(uiIndex, uiHash);
   ++m_uiCount;
 
   return false;
 }
 
-template <typename K, typename H>
-bool ezHashSetBase<K, H>::Remove(const K& key)
+template <typename K, typename H, typename S>
+bool ezHashSetBase<K, H, S>::Remove(const K& key)
 {
   ezUInt32 uiIndex = FindEntry(key);
   if (uiIndex != ezInvalidIndex)
@@ -326,8 +317,8 @@ bool ezHashSetBase<K, H>::Remove(const K& key)
   return false;
 }
 
-template <typename K, typename H>
-typename ezHashSetBase<K, H>::ConstIterator ezHashSetBase<K, H>::Remove(const typename ezHashSetBase<K, H>::ConstIterator& pos)
+template <typename K, typename H, typename S>
+typename ezHashSetBase<K, H, S>::ConstIterator ezHashSetBase<K, H, S>::Remove(const typename ezHashSetBase<K, H, S>::ConstIterator& pos)
 {
   ConstIterator it = pos;
   ezUInt32 uiIndex = pos.m_uiCurrentIndex;
@@ -337,50 +328,23 @@ typename ezHashSetBase<K, H>::ConstIterator ezHashSetBase<K, H>::Remove(const ty
   return it;
 }
 
-template <typename K, typename H>
-void ezHashSetBase<K, H>::RemoveInternal(ezUInt32 uiIndex)
+template <typename K, typename H, typename S>
+void ezHashSetBase<K, H, S>::RemoveInternal(ezUInt32 uiIndex)
 {
   ezMemoryUtils::Destruct(&m_pEntries[uiIndex], 1);
 
-  ezUInt32 uiNextIndex = uiIndex + 1;
-  if (uiNextIndex == m_uiCapacity)
-    uiNextIndex = 0;
-
-  // if the next entry is free we are at the end of a chain and
-  // can immediately mark this entry as free as well
-  if (IsFreeEntry(uiNextIndex))
-  {
-    MarkEntryAsFree(uiIndex);
-
-    // run backwards and free all deleted entries in this chain
-    ezUInt32 uiPrevIndex = (uiIndex != 0) ? uiIndex : m_uiCapacity;
-    --uiPrevIndex;
-
-    while (IsDeletedEntry(uiPrevIndex))
-    {
-      MarkEntryAsFree(uiPrevIndex);
-
-      if (uiPrevIndex == 0)
-        uiPrevIndex = m_uiCapacity;
-      --uiPrevIndex;
-    }
-  }
-  else
-  {
-    MarkEntryAsDeleted(uiIndex);
-  }
-
+  m_Storage.MarkEntryAsRemoved(uiIndex, m_uiCapacity);
   --m_uiCount;
 }
 
-template <typename K, typename H>
-EZ_FORCE_INLINE bool ezHashSetBase<K, H>::Contains(const K& key) const
+template <typename K, typename H, typename S>
+EZ_FORCE_INLINE bool ezHashSetBase<K, H, S>::Contains(const K& key) const
 {
   return FindEntry(key) != ezInvalidIndex;
 }
 
-template <typename K, typename H>
-bool ezHashSetBase<K, H>::ContainsSet(const ezHashSetBase<K, H>& operand) const
+template <typename K, typename H, typename S>
+bool ezHashSetBase<K, H, S>::ContainsSet(const ezHashSetBase<K, H, S>& operand) const
 {
   for (const K& key : operand)
   {
@@ -391,8 +355,8 @@ bool ezHashSetBase<K, H>::ContainsSet(const ezHashSetBase<K, H>& operand) const
   return true;
 }
 
-template <typename K, typename H>
-void ezHashSetBase<K, H>::Union(const ezHashSetBase<K, H>& operand)
+template <typename K, typename H, typename S>
+void ezHashSetBase<K, H, S>::Union(const ezHashSetBase<K, H, S>& operand)
 {
   Reserve(GetCount() + operand.GetCount());
   for (const auto& key : operand)
@@ -401,8 +365,8 @@ void ezHashSetBase<K, H>::Union(const ezHashSetBase<K, H>& operand)
   }
 }
 
-template <typename K, typename H>
-void ezHashSetBase<K, H>::Difference(const ezHashSetBase<K, H>& operand)
+template <typename K, typename H, typename S>
+void ezHashSetBase<K, H, S>::Difference(const ezHashSetBase<K, H, S>& operand)
 {
   for (const auto& key : operand)
   {
@@ -410,8 +374,8 @@ void ezHashSetBase<K, H>::Difference(const ezHashSetBase<K, H>& operand)
   }
 }
 
-template <typename K, typename H>
-void ezHashSetBase<K, H>::Intersection(const ezHashSetBase<K, H>& operand)
+template <typename K, typename H, typename S>
+void ezHashSetBase<K, H, S>::Intersection(const ezHashSetBase<K, H, S>& operand)
 {
   for (auto it = GetIterator(); it.IsValid();)
   {
@@ -422,233 +386,151 @@ void ezHashSetBase<K, H>::Intersection(const ezHashSetBase<K, H>& operand)
   }
 }
 
-template <typename K, typename H>
-EZ_FORCE_INLINE typename ezHashSetBase<K, H>::ConstIterator ezHashSetBase<K, H>::GetIterator() const
+template <typename K, typename H, typename S>
+EZ_FORCE_INLINE typename ezHashSetBase<K, H, S>::ConstIterator ezHashSetBase<K, H, S>::GetIterator() const
 {
   ConstIterator iterator(*this);
   iterator.SetToBegin();
   return iterator;
 }
 
-template <typename K, typename H>
-EZ_FORCE_INLINE typename ezHashSetBase<K, H>::ConstIterator ezHashSetBase<K, H>::GetEndIterator() const
+template <typename K, typename H, typename S>
+EZ_FORCE_INLINE typename ezHashSetBase<K, H, S>::ConstIterator ezHashSetBase<K, H, S>::GetEndIterator() const
 {
   ConstIterator iterator(*this);
   iterator.SetToEnd();
   return iterator;
 }
 
-template <typename K, typename H>
-EZ_ALWAYS_INLINE ezAllocatorBase* ezHashSetBase<K, H>::GetAllocator() const
+template <typename K, typename H, typename S>
+EZ_ALWAYS_INLINE ezAllocatorBase* ezHashSetBase<K, H, S>::GetAllocator() const
 {
   return m_pAllocator;
 }
 
-template <typename K, typename H>
-ezUInt64 ezHashSetBase<K, H>::GetHeapMemoryUsage() const
+template <typename K, typename H, typename S>
+ezUInt64 ezHashSetBase<K, H, S>::GetHeapMemoryUsage() const
 {
-  return ((ezUInt64)m_uiCapacity * sizeof(K)) + (sizeof(ezUInt32) * (ezUInt64)GetFlagsCapacity());
+  return ((ezUInt64)m_uiCapacity * sizeof(K)) + m_Storage.GetHeapMemoryUsage(m_uiCapacity);
 }
 
 // private methods
-template <typename K, typename H>
-void ezHashSetBase<K, H>::SetCapacity(ezUInt32 uiCapacity)
+template <typename K, typename H, typename S>
+void ezHashSetBase<K, H, S>::SetCapacity(ezUInt32 uiCapacity)
 {
   const ezUInt32 uiOldCapacity = m_uiCapacity;
   m_uiCapacity = uiCapacity;
 
   K* pOldEntries = m_pEntries;
-  ezUInt32* pOldEntryFlags = m_pEntryFlags;
+  S oldStorage = m_Storage;
 
   m_pEntries = EZ_NEW_RAW_BUFFER(m_pAllocator, K, m_uiCapacity);
-  m_pEntryFlags = EZ_NEW_RAW_BUFFER(m_pAllocator, ezUInt32, GetFlagsCapacity());
-  ezMemoryUtils::ZeroFill(m_pEntryFlags, GetFlagsCapacity());
+  m_Storage.Allocate(m_pAllocator, m_uiCapacity);
 
-  m_uiCount = 0;
+  // all keys are unique, so they can be moved to the first free entry of their probe sequence
   for (ezUInt32 i = 0; i < uiOldCapacity; ++i)
   {
-    if (GetFlags(pOldEntryFlags, i) == VALID_ENTRY)
+    if (oldStorage.IsValidEntry(i))
     {
-      EZ_VERIFY(!Insert(std::move(pOldEntries[i])), "Implementation error");
+      const ezUInt32 uiHash = H::Hash(pOldEntries[i]);
+      const ezUInt32 uiIndex = m_Storage.FindInsertPosition(uiHash % m_uiCapacity, uiHash, m_uiCapacity);
 
-      ezMemoryUtils::Destruct(&pOldEntries[i], 1);
+      ezMemoryUtils::RelocateConstruct(&m_pEntries[uiIndex], &pOldEntries[i], 1);
+      m_Storage.MarkEntryAsValid(uiIndex, uiHash);
     }
   }
 
   EZ_DELETE_RAW_BUFFER(m_pAllocator, pOldEntries);
-  EZ_DELETE_RAW_BUFFER(m_pAllocator, pOldEntryFlags);
+  oldStorage.Deallocate(m_pAllocator);
 }
 
-template <typename K, typename H>
-EZ_FORCE_INLINE ezUInt32 ezHashSetBase<K, H>::FindEntry(const K& key) const
+template <typename K, typename H, typename S>
+EZ_FORCE_INLINE ezUInt32 ezHashSetBase<K, H, S>::FindEntry(const K& key) const
 {
   return FindEntry(H::Hash(key), key);
 }
 
-template <typename K, typename H>
-inline ezUInt32 ezHashSetBase<K, H>::FindEntry(ezUInt32 uiHash, const K& key) const
-{
-  if (m_uiCapacity > 0)
-  {
-    ezUInt32 uiIndex = uiHash % m_uiCapacity;
-    ezUInt32 uiCounter = 0;
-    while (!IsFreeEntry(uiIndex) && uiCounter < m_uiCapacity)
-    {
-      if (IsValidEntry(uiIndex) && H::Equal(m_pEntries[uiIndex], key))
-        return uiIndex;
-
-      ++uiIndex;
-      if (uiIndex == m_uiCapacity)
-        uiIndex = 0;
-
-      ++uiCounter;
-    }
-  }
-  // not found
-  return ezInvalidIndex;
-}
-
-#define EZ_HASHSET_USE_BITFLAGS EZ_ON
-
-template <typename K, typename H>
-EZ_FORCE_INLINE ezUInt32 ezHashSetBase<K, H>::GetFlagsCapacity() const
-{
-#if EZ_ENABLED(EZ_HASHSET_USE_BITFLAGS)
-  return (m_uiCapacity + 15) / 16;
-#else
-  return m_uiCapacity;
-#endif
-}
-
-template <typename K, typename H>
-ezUInt32 ezHashSetBase<K, H>::GetFlags(ezUInt32* pFlags, ezUInt32 uiEntryIndex) const
-{
-#if EZ_ENABLED(EZ_HASHSET_USE_BITFLAGS)
-  const ezUInt32 uiIndex = uiEntryIndex / 16;
-  const ezUInt32 uiSubIndex = (uiEntryIndex & 15) * 2;
-  return (pFlags[uiIndex] >> uiSubIndex) & FLAGS_MASK;
-#else
-  return pFlags[uiEntryIndex] & FLAGS_MASK;
-#endif
-}
-
-template <typename K, typename H>
-void ezHashSetBase<K, H>::SetFlags(ezUInt32 uiEntryIndex, ezUInt32 uiFlags)
-{
-#if EZ_ENABLED(EZ_HASHSET_USE_BITFLAGS)
-  const ezUInt32 uiIndex = uiEntryIndex / 16;
-  const ezUInt32 uiSubIndex = (uiEntryIndex & 15) * 2;
-  EZ_ASSERT_DEV(uiIndex < GetFlagsCapacity(), "Out of bounds access");
-  m_pEntryFlags[uiIndex] &= ~(FLAGS_MASK << uiSubIndex);
-  m_pEntryFlags[uiIndex] |= (uiFlags << uiSubIndex);
-#else
-  EZ_ASSERT_DEV(uiEntryIndex < GetFlagsCapacity(), "Out of bounds access");
-  m_pEntryFlags[uiEntryIndex] = uiFlags;
-#endif
-}
-
-template <typename K, typename H>
-EZ_FORCE_INLINE bool ezHashSetBase<K, H>::IsFreeEntry(ezUInt32 uiEntryIndex) const
-{
-  return GetFlags(m_pEntryFlags, uiEntryIndex) == FREE_ENTRY;
-}
-
-template <typename K, typename H>
-EZ_FORCE_INLINE bool ezHashSetBase<K, H>::IsValidEntry(ezUInt32 uiEntryIndex) const
-{
-  return GetFlags(m_pEntryFlags, uiEntryIndex) == VALID_ENTRY;
-}
-
-template <typename K, typename H>
-EZ_FORCE_INLINE bool ezHashSetBase<K, H>::IsDeletedEntry(ezUInt32 uiEntryIndex) const
+template <typename K, typename H, typename S>
+inline ezUInt32 ezHashSetBase<K, H, S>::FindEntry(ezUInt32 uiHash, const K& key) const
 {
-  return GetFlags(m_pEntryFlags, uiEntryIndex) == DELETED_ENTRY;
-}
+  if (m_uiCapacity == 0)
+    return ezInvalidIndex;
 
-template <typename K, typename H>
-EZ_FORCE_INLINE void ezHashSetBase<K, H>::MarkEntryAsFree(ezUInt32 uiEntryIndex)
-{
-  SetFlags(uiEntryIndex, FREE_ENTRY);
-}
-
-template <typename K, typename H>
-EZ_FORCE_INLINE void ezHashSetBase<K, H>::MarkEntryAsValid(ezUInt32 uiEntryIndex)
-{
-  SetFlags(uiEntryIndex, VALID_ENTRY);
+  return m_Storage.FindEntry(uiHash % m_uiCapacity, uiHash, m_uiCapacity, [&](ezUInt32 uiEntryIndex) { return H::Equal(m_pEntries[uiEntryIndex], key); });
 }
 
-template <typename K, typename H>
-EZ_FORCE_INLINE void ezHashSetBase<K, H>::MarkEntryAsDeleted(ezUInt32 uiEntryIndex)
+template <typename K, typename H, typename S>
+EZ_FORCE_INLINE bool ezHashSetBase<K, H, S>::IsValidEntry(ezUInt32 uiEntryIndex) const
 {
-  SetFlags(uiEntryIndex, DELETED_ENTRY);
+  return m_Storage.IsValidEntry(uiEntryIndex);
 }
 
 
-template <typename K, typename H, typename A>
-ezHashSet<K, H, A>::ezHashSet()
-  : ezHashSetBase<K, H>(A::GetAllocator())
+template <typename K, typename H, typename A, typename S>
+ezHashSet<K, H, A, S>::ezHashSet()
+  : ezHashSetBase<K, H, S>(A::GetAllocator())
 {
 }
 
-template <typename K, typename H, typename A>
-ezHashSet<K, H, A>::ezHashSet(ezAllocatorBase* pAllocator)
-  : ezHashSetBase<K, H>(pAllocator)
+template <typename K, typename H, typename A, typename S>
+ezHashSet<K, H, A, S>::ezHashSet(ezAllocatorBase* pAllocator)
+  : ezHashSetBase<K, H, S>(pAllocator)
 {
 }
 
-template <typename K, typename H, typename A>
-ezHashSet<K, H, A>::ezHashSet(const ezHashSet<K, H, A>& other)
-  : ezHashSetBase<K, H>(other, A::GetAllocator())
+template <typename K, typename H, typename A, typename S>
+ezHashSet<K, H, A, S>::ezHashSet(const ezHashSet<K, H, A, S>& other)
+  : ezHashSetBase<K, H, S>(other, A::GetAllocator())
 {
 }
 
-template <typename K, typename H, typename A>
-ezHashSet<K, H, A>::ezHashSet(const ezHashSetBase<K, H>& other)
-  : ezHashSetBase<K, H>(other, A::GetAllocator())
+template <typename K, typename H, typename A, typename S>
+ezHashSet<K, H, A, S>::ezHashSet(const ezHashSetBase<K, H, S>& other)
+  : ezHashSetBase<K, H, S>(other, A::GetAllocator())
 {
 }
 
-template <typename K, typename H, typename A>
-ezHashSet<K, H, A>::ezHashSet(ezHashSet<K, H, A>&& other)
-  : ezHashSetBase<K, H>(std::move(other), other.GetAllocator())
+template <typename K, typename H, typename A, typename S>
+ezHashSet<K, H, A, S>::ezHashSet(ezHashSet<K, H, A, S>&& other)
+  : ezHashSetBase<K, H, S>(std::move(other), other.GetAllocator())
 {
 }
 
-template <typename K, typename H, typename A>
-ezHashSet<K, H, A>::ezHashSet(ezHashSetBase<K, H>&& other)
-  : ezHashSetBase<K, H>(std::move(other), other.GetAllocator())
+template <typename K, typename H, typename A, typename S>
+ezHashSet<K, H, A, S>::ezHashSet(ezHashSetBase<K, H, S>&& other)
+  : ezHashSetBase<K, H, S>(std::move(other), other.GetAllocator())
 {
 }
 
-template <typename K, typename H, typename A>
-void ezHashSet<K, H, A>::operator=(const ezHashSet<K, H, A>& rhs)
+template <typename K, typename H, typename A, typename S>
+void ezHashSet<K, H, A, S>::operator=(const ezHashSet<K, H, A, S>& rhs)
 {
-  ezHashSetBase<K, H>::operator=(rhs);
+  ezHashSetBase<K, H, S>::operator=(rhs);
 }
 
-template <typename K, typename H, typename A>
-void ezHashSet<K, H, A>::operator=(const ezHashSetBase<K, H>& rhs)
+template <typename K, typename H, typename A, typename S>
+void ezHashSet<K, H, A, S>::operator=(const ezHashSetBase<K, H, S>& rhs)
 {
-  ezHashSetBase<K, H>::operator=(rhs);
+  ezHashSetBase<K, H, S>::operator=(rhs);
 }
 
-template <typename K, typename H, typename A>
-void ezHashSet<K, H, A>::operator=(ezHashSet<K, H, A>&& rhs)
+template <typename K, typename H, typename A, typename S>
+void ezHashSet<K, H, A, S>::operator=(ezHashSet<K, H, A, S>&& rhs)
 {
-  ezHashSetBase<K, H>::operator=(std::move(rhs));
+  ezHashSetBase<K, H, S>::operator=(std::move(rhs));
 }
 
-template <typename K, typename H, typename A>
-void ezHashSet<K, H, A>::operator=(ezHashSetBase<K, H>&& rhs)
+template <typename K, typename H, typename A, typename S>
+void ezHashSet<K, H, A, S>::operator=(ezHashSetBase<K, H, S>&& rhs)
 {
-  ezHashSetBase<K, H>::operator=(std::move(rhs));
+  ezHashSetBase<K, H, S>::operator=(std::move(rhs));
 }
 
-template <typename KeyType, typename Hasher>
-void ezHashSetBase<KeyType, Hasher>::Swap(ezHashSetBase<KeyType, Hasher>& other)
+template <typename KeyType, typename Hasher, typename Storage>
+void ezHashSetBase<KeyType, Hasher, Storage>::Swap(ezHashSetBase<KeyType, Hasher, Storage>& other)
 {
   ezMath::Swap(this->m_pEntries, other.m_pEntries);
-  ezMath::Swap(this->m_pEntryFlags, other.m_pEntryFlags);
+  ezMath::Swap(this->m_Storage, other.m_Storage);
   ezMath::Swap(this->m_uiCount, other.m_uiCount);
   ezMath::Swap(this->m_uiCapacity, other.m_uiCapacity);
   ezMath::Swap(this->m_pAllocator, other.m_pAllocator);
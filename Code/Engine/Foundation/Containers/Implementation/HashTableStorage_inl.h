@@ -0,0 +1,389 @@
+/// \brief Value used by containers for indices to indicate an invalid index.
+#ifndef ezInvalidIndex
+#  define ezInvalidIndex 0xFFFFFFFF
+#endif
+
+// ***** ezHashTableLinearStorage *****
+
+#define EZ_HASHTABLE_USE_BITFLAGS EZ_ON
+
+inline void ezHashTableLinearStorage::Allocate(ezAllocatorBase* pAllocator, ezUInt32 uiCapacity)
+{
+  m_pEntryFlags = EZ_NEW_RAW_BUFFER(pAllocator, ezUInt32, GetFlagsCapacity(uiCapacity));
+  ezMemoryUtils::ZeroFill(m_pEntryFlags, GetFlagsCapacity(uiCapacity));
+}
+
+EZ_ALWAYS_INLINE void ezHashTableLinearStorage::Deallocate(ezAllocatorBase* pAllocator)
+{
+  EZ_DELETE_RAW_BUFFER(pAllocator, m_pEntryFlags);
+}
+
+EZ_ALWAYS_INLINE void ezHashTableLinearStorage::Clear(ezUInt32 uiCapacity)
+{
+  ezMemoryUtils::ZeroFill(m_pEntryFlags, GetFlagsCapacity(uiCapacity));
+}
+
+EZ_ALWAYS_INLINE ezUInt64 ezHashTableLinearStorage::GetHeapMemoryUsage(ezUInt32 uiCapacity) const
+{
+  return sizeof(ezUInt32) * (ezUInt64)GetFlagsCapacity(uiCapacity);
+}
+
+EZ_FORCE_INLINE bool ezHashTableLinearStorage::IsValidEntry(ezUInt32 uiEntryIndex) const
+{
+  return GetFlags(uiEntryIndex) == VALID_ENTRY;
+}
+
+template <typename IsKey>
+inline ezUInt32 ezHashTableLinearStorage::FindEntry(ezUInt32 uiIndex, ezUInt32 uiHash, ezUInt32 uiCapacity, IsKey isKey) const
+{
+  EZ_IGNORE_UNUSED(uiHash);
+
+  ezUInt32 uiCounter = 0;
+  while (!IsFreeEntry(uiIndex) && uiCounter < uiCapacity)
+  {
+    if (IsValidEntry(uiIndex) && isKey(uiIndex))
+      return uiIndex;
+
+    ++uiIndex;
+    if (uiIndex == uiCapacity)
+      uiIndex = 0;
+
+    ++uiCounter;
+  }
+
+  // not found
+  return ezInvalidIndex;
+}
+
+template <typename IsKey>
+inline ezUInt32 ezHashTableLinearStorage::FindEntryOrInsertPosition(ezUInt32 uiIndex, ezUInt32 uiHash, ezUInt32 uiCapacity, IsKey isKey, bool& out_bFound) const
+{
+  EZ_IGNORE_UNUSED(uiHash);
+
+  ezUInt32 uiDeletedIndex = ezInvalidIndex;
+
+  ezUInt32 uiCounter = 0;
+  while (!IsFreeEntry(uiIndex) && uiCounter < uiCapacity)
+  {
+    if (IsDeletedEntry(uiIndex))
+    {
+      if (uiDeletedIndex == ezInvalidIndex)
+        uiDeletedIndex = uiIndex;
+    }
+    else if (isKey(uiIndex))
+    {
+      out_bFound = true;
+      return uiIndex;
+    }
+    ++uiIndex;
+    if (uiIndex == uiCapacity)
+      uiIndex = 0;
+
+    ++uiCounter;
+  }
+
+  out_bFound = false;
+  return uiDeletedIndex != ezInvalidIndex ? uiDeletedIndex : uiIndex;
+}
+
+inline ezUInt32 ezHashTableLinearStorage::FindInsertPosition(ezUInt32 uiIndex, ezUInt32 uiHash, ezUInt32 uiCapacity) const
+{
+  EZ_IGNORE_UNUSED(uiHash);
+
+  while (IsValidEntry(uiIndex))
+  {
+    ++uiIndex;
+    if (uiIndex == uiCapacity)
+      uiIndex = 0;
+  }
+
+  return uiIndex;
+}
+
+EZ_FORCE_INLINE void ezHashTableLinearStorage::MarkEntryAsValid(ezUInt32 uiEntryIndex, ezUInt32 uiHash)
+{
+  EZ_IGNORE_UNUSED(uiHash);
+  SetFlags(uiEntryIndex, VALID_ENTRY);
+}
+
+inline void ezHashTableLinearStorage::MarkEntryAsRemoved(ezUInt32 uiEntryIndex, ezUInt32 uiCapacity)
+{
+  ezUInt32 uiNextIndex = uiEntryIndex + 1;
+  if (uiNextIndex == uiCapacity)
+    uiNextIndex = 0;
+
+  // if the next entry is free we are at the end of a chain and
+  // can immediately mark this entry as free as well
+  if (IsFreeEntry(uiNextIndex))
+  {
+    SetFlags(uiEntryIndex, FREE_ENTRY);
+
+    // run backwards and free all deleted entries in this chain
+    ezUInt32 uiPrevIndex = (uiEntryIndex != 0) ? uiEntryIndex : uiCapacity;
+    --uiPrevIndex;
+
+    while (IsDeletedEntry(uiPrevIndex))
+    {
+      SetFlags(uiPrevIndex, FREE_ENTRY);
+
+      if (uiPrevIndex == 0)
+        uiPrevIndex = uiCapacity;
+      --uiPrevIndex;
+    }
+  }
+  else
+  {
+    SetFlags(uiEntryIndex, DELETED_ENTRY);
+  }
+}
+
+EZ_FORCE_INLINE ezUInt32 ezHashTableLinearStorage::GetFlagsCapacity(ezUInt32 uiCapacity)
+{
+#if EZ_ENABLED(EZ_HASHTABLE_USE_BITFLAGS)
+  return (uiCapacity + 15) / 16;
+#else
+  return uiCapacity;
+#endif
+}
+
+EZ_ALWAYS_INLINE ezUInt32 ezHashTableLinearStorage::GetFlags(ezUInt32 uiEntryIndex) const
+{
+#if EZ_ENABLED(EZ_HASHTABLE_USE_BITFLAGS)
+  const ezUInt32 uiIndex = uiEntryIndex / 16;
+  const ezUInt32 uiSubIndex = (uiEntryIndex & 15) * 2;
+  return (m_pEntryFlags[uiIndex] >> uiSubIndex) & FLAGS_MASK;
+#else
+  return m_pEntryFlags[uiEntryIndex] & FLAGS_MASK;
+#endif
+}
+
+EZ_ALWAYS_INLINE void ezHashTableLinearStorage::SetFlags(ezUInt32 uiEntryIndex, ezUInt32 uiFlags)
+{
+#if EZ_ENABLED(EZ_HASHTABLE_USE_BITFLAGS)
+  const ezUInt32 uiIndex = uiEntryIndex / 16;
+  const ezUInt32 uiSubIndex = (uiEntryIndex & 15) * 2;
+  m_pEntryFlags[uiIndex] &= ~(FLAGS_MASK << uiSubIndex);
+  m_pEntryFlags[uiIndex] |= (uiFlags << uiSubIndex);
+#else
+  m_pEntryFlags[uiEntryIndex] = uiFlags;
+#endif
+}
+
+EZ_FORCE_INLINE bool ezHashTableLinearStorage::IsFreeEntry(ezUInt32 uiEntryIndex) const
+{
+  return GetFlags(uiEntryIndex) == FREE_ENTRY;
+}
+
+EZ_FORCE_INLINE bool ezHashTableLinearStorage::IsDeletedEntry(ezUInt32 uiEntryIndex) const
+{
+  return GetFlags(uiEntryIndex) == DELETED_ENTRY;
+}
+
+
+// ***** ezHashTableGroupedStorage *****
+
+inline void ezHashTableGroupedStorage::Allocate(ezAllocatorBase* pAllocator, ezUInt32 uiCapacity)
+{
+  EZ_ASSERT_DEV((uiCapacity % GROUP_SIZE) == 0, "The capacity must be a multiple of the group size.");
+
+  m_pControlBytes = EZ_NEW_RAW_BUFFER(pAllocator, ezUInt8, uiCapacity);
+  Clear(uiCapacity);
+}
+
+EZ_ALWAYS_INLINE void ezHashTableGroupedStorage::Deallocate(ezAllocatorBase* pAllocator)
+{
+  EZ_DELETE_RAW_BUFFER(pAllocator, m_pControlBytes);
+  m_uiNumDeleted = 0;
+}
+
+EZ_ALWAYS_INLINE void ezHashTableGroupedStorage::Clear(ezUInt32 uiCapacity)
+{
+  ezMemoryUtils::PatternFill(m_pControlBytes, EMPTY_ENTRY, uiCapacity);
+  m_uiNumDeleted = 0;
+}
+
+EZ_ALWAYS_INLINE ezUInt64 ezHashTableGroupedStorage::GetHeapMemoryUsage(ezUInt32 uiCapacity) const
+{
+  return (ezUInt64)uiCapacity;
+}
+
+EZ_ALWAYS_INLINE bool ezHashTableGroupedStorage::NeedsRehash(ezUInt32 uiCount, ezUInt32 uiCapacity) const
+{
+  // lookups of missing keys only stop at groups with empty entries, so these must not run out
+  return ((ezUInt64)uiCount + m_uiNumDeleted) * 8 > (ezUInt64)uiCapacity * 7;
+}
+
+EZ_FORCE_INLINE bool ezHashTableGroupedStorage::IsValidEntry(ezUInt32 uiEntryIndex) const
+{
+  return (m_pControlBytes[uiEntryIndex] & EMPTY_ENTRY) == 0;
+}
+
+template <typename IsKey>
+inline ezUInt32 ezHashTableGroupedStorage::FindEntry(ezUInt32 uiIndex, ezUInt32 uiHash, ezUInt32 uiCapacity, IsKey isKey) const
+{
+  const ezUInt8 uiHashBits = GetHashBits(uiHash);
+  ezUInt32 uiGroup = uiIndex & ~(GROUP_SIZE - 1);
+
+  for (ezUInt32 uiProbed = 0; uiProbed < uiCapacity; uiProbed += GROUP_SIZE)
+  {
+    const ezUInt8* pGroup = m_pControlBytes + uiGroup;
+
+    for (GroupMask mask = MatchByte(pGroup, uiHashBits); mask != 0; mask &= mask - 1)
+    {
+      const ezUInt32 uiEntryIndex = uiGroup + GetLowestEntry(mask);
+      if (isKey(uiEntryIndex))
+        return uiEntryIndex;
+    }
+
+    // an entry is never moved past a group with empty entries
+    if (MatchEmpty(pGroup) != 0)
+      break;
+
+    uiGroup += GROUP_SIZE;
+    if (uiGroup == uiCapacity)
+      uiGroup = 0;
+  }
+
+  // not found
+  return ezInvalidIndex;
+}
+
+template <typename IsKey>
+inline ezUInt32 ezHashTableGroupedStorage::FindEntryOrInsertPosition(ezUInt32 uiIndex, ezUInt32 uiHash, ezUInt32 uiCapacity, IsKey isKey, bool& out_bFound) const
+{
+  const ezUInt8 uiHashBits = GetHashBits(uiHash);
+  ezUInt32 uiGroup = uiIndex & ~(GROUP_SIZE - 1);
+  ezUInt32 uiInsertIndex = ezInvalidIndex;
+
+  for (ezUInt32 uiProbed = 0; uiProbed < uiCapacity; uiProbed += GROUP_SIZE)
+  {
+    const ezUInt8* pGroup = m_pControlBytes + uiGroup;
+
+    for (GroupMask mask = MatchByte(pGroup, uiHashBits); mask != 0; mask &= mask - 1)
+    {
+      const ezUInt32 uiEntryIndex = uiGroup + GetLowestEntry(mask);
+      if (isKey(uiEntryIndex))
+      {
+        out_bFound = true;
+        return uiEntryIndex;
+      }
+    }
+
+    if (uiInsertIndex == ezInvalidIndex)
+    {
+      const GroupMask freeMask = MatchEmptyOrDeleted(pGroup);
+      if (freeMask != 0)
+        uiInsertIndex = uiGroup + GetLowestEntry(freeMask);
+    }
+
+    if (MatchEmpty(pGroup) != 0)
+      break;
+
+    uiGroup += GROUP_SIZE;
+    if (uiGroup == uiCapacity)
+      uiGroup = 0;
+  }
+
+  out_bFound = false;
+  return uiInsertIndex;
+}
+
+inline ezUInt32 ezHashTableGroupedStorage::FindInsertPosition(ezUInt32 uiIndex, ezUInt32 uiHash, ezUInt32 uiCapacity) const
+{
+  EZ_IGNORE_UNUSED(uiHash);
+
+  ezUInt32 uiGroup = uiIndex & ~(GROUP_SIZE - 1);
+
+  while (true)
+  {
+    const GroupMask freeMask = MatchEmptyOrDeleted(m_pControlBytes + uiGroup);
+    if (freeMask != 0)
+      return uiGroup + GetLowestEntry(freeMask);
+
+    uiGroup += GROUP_SIZE;
+    if (uiGroup == uiCapacity)
+      uiGroup = 0;
+  }
+}
+
+EZ_FORCE_INLINE void ezHashTableGroupedStorage::MarkEntryAsValid(ezUInt32 uiEntryIndex, ezUInt32 uiHash)
+{
+  if (m_pControlBytes[uiEntryIndex] == DELETED_ENTRY)
+    --m_uiNumDeleted;
+
+  m_pControlBytes[uiEntryIndex] = GetHashBits(uiHash);
+}
+
+inline void ezHashTableGroupedStorage::MarkEntryAsRemoved(ezUInt32 uiEntryIndex, ezUInt32 uiCapacity)
+{
+  EZ_IGNORE_UNUSED(uiCapacity);
+
+  // If the group already has an empty entry, no lookup ever continued past it, so this entry can become empty as well.
+  // Otherwise entries in the following groups may rely on this group being full.
+  if (MatchEmpty(m_pControlBytes + (uiEntryIndex & ~(GROUP_SIZE - 1))) != 0)
+  {
+    m_pControlBytes[uiEntryIndex] = EMPTY_ENTRY;
+  }
+  else
+  {
+    m_pControlBytes[uiEntryIndex] = DELETED_ENTRY;
+    ++m_uiNumDeleted;
+  }
+}
+
+EZ_ALWAYS_INLINE ezUInt8 ezHashTableGroupedStorage::GetHashBits(ezUInt32 uiHash)
+{
+  // the lower bits already select the group
+  return static_cast<ezUInt8>(uiHash >> 25);
+}
+
+EZ_ALWAYS_INLINE ezHashTableGroupedStorage::GroupMask ezHashTableGroupedStorage::MatchByte(const ezUInt8* pGroup, ezUInt8 uiByte)
+{
+#if EZ_ENABLED(EZ_HASHTABLE_GROUP_MATCH_SSE2)
+  const __m128i control = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pGroup));
+  return static_cast<GroupMask>(_mm_movemask_epi8(_mm_cmpeq_epi8(control, _mm_set1_epi8(static_cast<char>(uiByte)))));
+#elif EZ_ENABLED(EZ_HASHTABLE_GROUP_MATCH_NEON)
+  const uint8x16_t matches = vceqq_u8(vld1q_u8(pGroup), vdupq_n_u8(uiByte));
+  return vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(matches), 4)), 0) & 0x8888888888888888ull;
+#else
+  GroupMask mask = 0;
+  for (ezUInt32 i = 0; i < GROUP_SIZE; ++i)
+  {
+    mask |= static_cast<GroupMask>(pGroup[i] == uiByte) << i;
+  }
+  return mask;
+#endif
+}
+
+EZ_ALWAYS_INLINE ezHashTableGroupedStorage::GroupMask ezHashTableGroupedStorage::MatchEmpty(const ezUInt8* pGroup)
+{
+  return MatchByte(pGroup, EMPTY_ENTRY);
+}
+
+EZ_ALWAYS_INLINE ezHashTableGroupedStorage::GroupMask ezHashTableGroupedStorage::MatchEmptyOrDeleted(const ezUInt8* pGroup)
+{
+  // both have the highest bit set, valid entries never do
+#if EZ_ENABLED(EZ_HASHTABLE_GROUP_MATCH_SSE2)
+  return static_cast<GroupMask>(_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pGroup))));
+#elif EZ_ENABLED(EZ_HASHTABLE_GROUP_MATCH_NEON)
+  const uint8x16_t matches = vtstq_u8(vld1q_u8(pGroup), vdupq_n_u8(EMPTY_ENTRY));
+  return vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(matches), 4)), 0) & 0x8888888888888888ull;
+#else
+  GroupMask mask = 0;
+  for (ezUInt32 i = 0; i < GROUP_SIZE; ++i)
+  {
+    mask |= static_cast<GroupMask>(pGroup[i] >> 7) << i;
+  }
+  return mask;
+#endif
+}
+
+EZ_ALWAYS_INLINE ezUInt32 ezHashTableGroupedStorage::GetLowestEntry(GroupMask mask)
+{
+#if EZ_ENABLED(EZ_HASHTABLE_GROUP_MATCH_NEON)
+  const ezUInt32 uiLow = static_cast<ezUInt32>(mask);
+  return uiLow != 0 ? (ezMath::FirstBitLow(uiLow) >> 2) : 8 + (ezMath::FirstBitLow(static_cast<ezUInt32>(mask >> 32)) >> 2);
+#else
+  return ezMath::FirstBitLow(mask);
+#endif
+}
@@ -6,14 +6,14 @@
 
 // ***** Const Iterator *****
 
-template <typename K, typename V, typename H>
-ezHashTableBase<K, V, H>::ConstIterator::ConstIterator(const ezHashTableBase<K, V, H>& hashTable)
+template <typename K, typename V, typename H, typename S>
+ezHashTableBase<K, V, H, S>::ConstIterator::ConstIterator(const ezHashTableBase<K, V, H, S>& hashTable)
   : m_hashTable(&hashTable)
 {
 }
 
-template <typename K, typename V, typename H>
-void ezHashTableBase<K, V, H>::ConstIterator::SetToBegin()
+template <typename K, typename V, typename H, typename S>
+void ezHashTableBase<K, V, H, S>::ConstIterator::SetToBegin()
 {
   if (m_hashTable->IsEmpty())
   {
@@ -26,46 +26,46 @@ void ezHashTableBase<K, V, H>::ConstIterator::SetToBegin()
   }
 }
 
-template <typename K, typename V, typename H>
-inline void ezHashTableBase<K, V, H>::ConstIterator::SetToEnd()
+template <typename K, typename V, typename H, typename S>
+inline void ezHashTableBase<K, V, H, S>::ConstIterator::SetToEnd()
 {
   m_uiCurrentCount = m_hashTable->m_uiCount;
   m_uiCurrentIndex = m_hashTable->m_uiCapacity;
 }
 
 
-template <typename K, typename V, typename H>
-EZ_FORCE_INLINE bool ezHashTableBase<K, V, H>::ConstIterator::IsValid() const
+template <typename K, typename V, typename H, typename S>
+EZ_FORCE_INLINE bool ezHashTableBase<K, V, H, S>::ConstIterator::IsValid() const
 {
   return m_uiCurrentCount < m_hashTable->m_uiCount;
 }
 
-template <typename K, typename V, typename H>
-EZ_FORCE_INLINE bool ezHashTableBase<K, V, H>::ConstIterator::operator==(const typename ezHashTableBase<K, V, H>::ConstIterator& rhs) const
+template <typename K, typename V, typename H, typename S>
+EZ_FORCE_INLINE bool ezHashTableBase<K, V, H, S>::ConstIterator::operator==(const typename ezHashTableBase<K, V, H, S>::ConstIterator& rhs) const
 {
   return m_uiCurrentIndex == rhs.m_uiCurrentIndex && m_hashTable->m_pEntries == rhs.m_hashTable->m_pEntries;
 }
 
-template <typename K, typename V, typename H>
-EZ_ALWAYS_INLINE bool ezHashTableBase<K, V, H>::ConstIterator::operator!=(const typename ezHashTableBase<K, V, H>::ConstIterator& rhs) const
+template <typename K, typename V, typename H, typename S>
+EZ_ALWAYS_INLINE bool ezHashTableBase<K, V, H, S>::ConstIterator::operator!=(const typename ezHashTableBase<K, V, H, S>::ConstIterator& rhs) const
 {
   return !(*this == rhs);
 }
 
-template <typename K, typename V, typename H>
-EZ_ALWAYS_INLINE const K& ezHashTableBase<K, V, H>::ConstIterator::Key() const
+template <typename K, typename V, typename H, typename S>
+EZ_ALWAYS_INLINE const K& ezHashTableBase<K, V, H, S>::ConstIterator::Key() const
 {
   return m_hashTable->m_pEntries[m_uiCurrentIndex].key;
 }
 
-template <typename K, typename V, typename H>
-EZ_ALWAYS_INLINE const V& ezHashTableBase<K, V, H>::ConstIterator::Value() const
+template <typename K, typename V, typename H, typename S>
+EZ_ALWAYS_INLINE const V& ezHashTableBase<K, V, H, S>::ConstIterator::Value() const
 {
   return m_hashTable->m_pEntries[m_uiCurrentIndex].value;
 }
 
-template <typename K, typename V, typename H>
-void ezHashTableBase<K, V, H>::ConstIterator::Next()
+template <typename K, typename V, typename H, typename S>
+void ezHashTableBase<K, V, H, S>::ConstIterator::Next()
 {
   // if we already iterated over the amount of valid elements that the hash-table stores, early out
   if (m_uiCurrentCount >= m_hashTable->m_uiCount)
@@ -90,8 +90,8 @@ void ezHashTableBase<K, V, H>::ConstIterator::Next()
   m_uiCurrentCount = m_hashTable->m_uiCount;
 }
 
-template <typename K, typename V, typename H>
-EZ_ALWAYS_INLINE void ezHashTableBase<K, V, H>::ConstIterator::operator++()
+template <typename K, typename V, typename H, typename S>
+EZ_ALWAYS_INLINE void ezHashTableBase<K, V, H, S>::ConstIterator::operator++()
 {
   Next();
 }
@@ -99,30 +99,30 @@ EZ_ALWAYS_INLINE void ezHashTableBase<K, V, H>::ConstIterator::operator++()
 
 // ***** Iterator *****
 
-template <typename K, typename V, typename H>
-ezHashTableBase<K, V, H>::Iterator::Iterator(const ezHashTableBase<K, V, H>& hashTable)
+template <typename K, typename V, typename H, typename S>
+ezHashTableBase<K, V, H, S>::Iterator::Iterator(const ezHashTableBase<K, V, H, S>& hashTable)
   : ConstIterator(hashTable)
 {
 }
 
-template <typename K, typename V, typename H>
-ezHashTableBase<K, V, H>::Iterator::Iterator(const typename ezHashTableBase<K, V, H>::Iterator& rhs)
+template <typename K, typename V, typename H, typename S>
+ezHashTableBase<K, V, H, S>::Iterator::Iterator(const typename ezHashTableBase<K, V, H, S>::Iterator& rhs)
   : ConstIterator(*rhs.m_hashTable)
 {
   this->m_uiCurrentIndex = rhs.m_uiCurrentIndex;
   this->m_uiCurrentCount = rhs.m_uiCurrentCount;
 }
 
-template <typename K, typename V, typename H>
-EZ_ALWAYS_INLINE void ezHashTableBase<K, V, H>::Iterator::operator=(const Iterator& rhs) // [tested]
+template <typename K, typename V, typename H, typename S>
+EZ_ALWAYS_INLINE void ezHashTableBase<K, V, H, S>::Iterator::operator=(const Iterator& rhs) // [tested]
 {
   this->m_hashTable = rhs.m_hashTable;
   this->m_uiCurrentIndex = rhs.m_uiCurrentIndex;
   this->m_uiCurrentCount = rhs.m_uiCurrentCount;
 }
 
-template <typename K, typename V, typename H>
-EZ_FORCE_INLINE V& ezHashTableBase<K, V, H>::Iterator::Value()
+template <typename K, typename V, typename H, typename S>
+EZ_FORCE_INLINE V& ezHashTableBase<K, V, H, S>::Iterator::Value()
 {
   return this->m_hashTable->m_pEntries[this->m_uiCurrentIndex].value;
 }
@@ -130,21 +130,19 @@ EZ_FORCE_INLINE V& ezHashTableBase<K, V, H>::Iterator::Value()
 
 // ***** ezHashTableBase *****
 
-template <typename K, typename V, typename H>
-ezHashTableBase<K, V, H>::ezHashTableBase(ezAllocatorBase* pAllocator)
+template <typename K, typename V, typename H, typename S>
+ezHashTableBase<K, V, H, S>::ezHashTableBase(ezAllocatorBase* pAllocator)
 {
   m_pEntries = nullptr;
-  m_pEntryFlags = nullptr;
   m_uiCount = 0;
   m_uiCapacity = 0;
   m_pAllocator = pAllocator;
 }
 
-template <typename K, typename V, typename H>
-ezHashTableBase<K, V, H>::ezHashTableBase(const ezHashTableBase<K, V, H>& other, ezAllocatorBase* pAllocator)
+template <typename K, typename V, typename H, typename S>
+ezHashTableBase<K, V, H, S>::ezHashTableBase(const ezHashTableBase<K, V, H, S>& other, ezAllocatorBase* pAllocator)
 {
   m_pEntries = nullptr;
-  m_pEntryFlags = nullptr;
   m_uiCount = 0;
   m_uiCapacity = 0;
   m_pAllocator = pAllocator;
@@ -152,11 +150,10 @@ ezHashTableBase<K, V, H>::ezHashTableBase(const ezHashTableBase<K, V, H>& other,
   *this = other;
 }
 
-template <typename K, typename V, typename H>
-ezHashTableBase<K, V, H>::ezHashTableBase(ezHashTableBase<K, V, H>&& other, ezAllocatorBase* pAllocator)
+template <typename K, typename V, typename H, typename S>
+ezHashTableBase<K, V, H, S>::ezHashTableBase(ezHashTableBase<K, V, H, S>&& other, ezAllocatorBase* pAllocator)
 {
   m_pEntries = nullptr;
-  m_pEntryFlags = nullptr;
   m_uiCount = 0;
   m_uiCapacity = 0;
   m_pAllocator = pAllocator;
@@ -164,17 +161,17 @@ ezHashTableBase<K, V, H>::ezHashTableBase(ezHashTableBase<K, V, H>&& other, ezAl
   *this = std::move(other);
 }
 
-template <typename K, typename V, typename H>
-ezHashTableBase<K, V, H>::~ezHashTableBase()
+template <typename K, typename V, typename H, typename S>
+ezHashTableBase<K, V, H, S>::~ezHashTableBase()
 {
   Clear();
   EZ_DELETE_RAW_BUFFER(m_pAllocator, m_pEntries);
-  EZ_DELETE_RAW_BUFFER(m_pAllocator, m_pEntryFlags);
+  m_Storage.Deallocate(m_pAllocator);
   m_uiCapacity = 0;
 }
 
-template <typename K, typename V, typename H>
-void ezHashTableBase<K, V, H>::operator=(const ezHashTableBase<K, V, H>& rhs)
+template <typename K, typename V, typename H, typename S>
+void ezHashTableBase<K, V, H, S>::operator=(const ezHashTableBase<K, V, H, S>& rhs)
 {
   Clear();
   Reserve(rhs.GetCount());
@@ -190,8 +187,8 @@ void ezHashTableBase<K, V, H>::operator=(const ezHashTableBase<K, V, H>& rhs)
   }
 }
 
-template <typename K, typename V, typename H>
-void ezHashTableBase<K, V, H>::operator=(ezHashTableBase<K, V, H>&& rhs)
+template <typename K, typename V, typename H, typename S>
+void ezHashTableBase<K, V, H, S>::operator=(ezHashTableBase<K, V, H, S>&& rhs)
 {
   // Clear any existing data (calls destructors if necessary)
   Clear();
@@ -215,24 +212,24 @@ void ezHashTableBase<K, V, H>::operator=(ezHashTableBase<K, V, H>&& rhs)
   else
   {
     EZ_DELETE_RAW_BUFFER(m_pAllocator, m_pEntries);
-    EZ_DELETE_RAW_BUFFER(m_pAllocator, m_pEntryFlags);
+    m_Storage.Deallocate(m_pAllocator);
 
     // Move all data over.
     m_pEntries = rhs.m_pEntries;
-    m_pEntryFlags = rhs.m_pEntryFlags;
+    m_Storage = rhs.m_Storage;
     m_uiCount = rhs.m_uiCount;
     m_uiCapacity = rhs.m_uiCapacity;
 
     // Temp copy forgets all its state.
     rhs.m_pEntries = nullptr;
-    rhs.m_pEntryFlags = nullptr;
+    rhs.m_Storage = S();
     rhs.m_uiCount = 0;
     rhs.m_uiCapacity = 0;
   }
 }
 
-template <typename K, typename V, typename H>
-bool ezHashTableBase<K, V, H>::operator==(const ezHashTableBase<K, V, H>& rhs) const
+template <typename K, typename V, typename H, typename S>
+bool ezHashTableBase<K, V, H, S>::operator==(const ezHashTableBase<K, V, H, S>& rhs) const
 {
   if (m_uiCount != rhs.m_uiCount)
     return false;
@@ -256,14 +253,14 @@ bool ezHashTableBase<K, V, H>::operator==(const ezHashTableBase<K, V, H>& rhs) c
   return true;
 }
 
-template <typename K, typename V, typename H>
-EZ_ALWAYS_INLINE bool ezHashTableBase<K, V, H>::operator!=(const ezHashTableBase<K, V, H>& rhs) const
+template <typename K, typename V, typename H, typename S>
+EZ_ALWAYS_INLINE bool ezHashTableBase<K, V, H, S>::operator!=(const ezHashTableBase<K, V, H, S>& rhs) const
 {
   return !(*this == rhs);
 }
 
-template <typename K, typename V, typename H>
-void ezHashTableBase<K, V, H>::Reserve(ezUInt32 uiCapacity)
+template <typename K, typename V, typename H, typename S>
+void ezHashTableBase<K, V, H, S>::Reserve(ezUInt32 uiCapacity)
 {
   const ezUInt64 uiCap64 = static_cast<ezUInt64>(uiCapacity);
   ezUInt64 uiNewCapacity64 = uiCap64 + (uiCap64 * 2 / 3); // ensure a maximum load of 60%
@@ -274,20 +271,26 @@ void ezHashTableBase<K, V, H>::Reserve(ezUInt32 uiCapacity)
   EZ_ASSERT_DEBUG(uiCapacity <= uiNewCapacity32, "ezHashSet/Map do not support more than 2 billion entries.");
 
   if (m_uiCapacity >= uiNewCapacity32)
+  {
+    // rebuild the table at the same size, if the storage ran out of free entries for probing
+    if (m_Storage.NeedsRehash(m_uiCount, m_uiCapacity))
+      SetCapacity(m_uiCapacity);
+
     return;
+  }
 
   uiNewCapacity32 = ezMath::Max<ezUInt32>(ezMath::PowerOfTwo_Ceil(uiNewCapacity32), CAPACITY_ALIGNMENT);
   SetCapacity(uiNewCapacity32);
 }
 
-template <typename K, typename V, typename H>
-void ezHashTableBase<K, V, H>::Compact()
+template <typename K, typename V, typename H, typename S>
+void ezHashTableBase<K, V, H, S>::Compact()
 {
   if (IsEmpty())
   {
     // completely deallocate all data, if the table is empty.
     EZ_DELETE_RAW_BUFFER(m_pAllocator, m_pEntries);
-    EZ_DELETE_RAW_BUFFER(m_pAllocator, m_pEntryFlags);
+    m_Storage.Deallocate(m_pAllocator);
     m_uiCapacity = 0;
   }
   else
@@ -298,20 +301,20 @@ void ezHashTableBase<K, V, H>::Compact()
   }
 }
 
-template <typename K, typename V, typename H>
-EZ_ALWAYS_INLINE ezUInt32 ezHashTableBase<K, V, H>::GetCount() const
+template <typename K, typename V, typename H, typename S>
+EZ_ALWAYS_INLINE ezUInt32 ezHashTableBase<K, V, H, S>::GetCount() const
 {
   return m_uiCount;
 }
 
-template <typename K, typename V, typename H>
-EZ_ALWAYS_INLINE bool ezHashTableBase<K, V, H>::IsEmpty() const
+template <typename K, typename V, typename H, typename S>
+EZ_ALWAYS_INLINE bool ezHashTableBase<K, V, H, S>::IsEmpty() const
 {
   return m_uiCount == 0;
 }
 
-template <typename K, typename V, typename H>
-void ezHashTableBase<K, V, H>::Clear()
+template <typename K, typename V, typename H, typename S>
+void ezHashTableBase<K, V, H, S>::Clear()
 {
   for (ezUInt32 i = 0; i < m_uiCapacity; ++i)
   {
@@ -322,58 +325,46 @@ void ezHashTableBase<K, V, H>::Clear()
     }
   }
 
-  ezMemoryUtils::ZeroFill(m_pEntryFlags, GetFlagsCapacity());
+  m_Storage.Clear(m_uiCapacity);
   m_uiCount = 0;
 }
 
-template <typename K, typename V, typename H>
+template <typename K, typename V, typename H, typename S>
 template <typename CompatibleKeyType, typename CompatibleValueType>
-bool ezHashTableBase<K, V, H>::Insert(CompatibleKeyType&& key, CompatibleValueType&& value, V* out_oldValue /*= nullptr*/)
+bool ezHashTableBase<K, V, H, S>::Insert(CompatibleKeyType&& key, CompatibleValueType&& value, V* out_oldValue /*= nullptr*/)
 {
   Reserve(m_uiCount + 1);
 
-  ezUInt32 uiIndex = H::Hash(key) & (m_uiCapacity - 1);
-  ezUInt32 uiDeletedIndex = ezInvalidIndex;
+  const ezUInt32 uiHash = H::Hash(key);
 
-  ezUInt32 uiCounter = 0;
-  while (!IsFreeEntry(uiIndex) && uiCounter < m_uiCapacity)
-  {
-    if (IsDeletedEntry(uiIndex))
-    {
-      if (uiDeletedIndex == ezInvalidIndex)
-        uiDeletedIndex = uiIndex;
-    }
-    else if (H::Equal(m_pEntries[uiIndex].key, key))
-    {
-      if (out_oldValue != nullptr)
-        *out_oldValue = std::move(m_pEntries[uiIndex].value);
+  bool bFound = false;
+  const ezUInt32 uiIndex = m_Storage.FindEntryOrInsertPosition(
+    uiHash & (m_uiCapacity - 1), uiHash, m_uiCapacity, [&](ezUInt32 uiEntryIndex) { return H::Equal(m_pEntries[uiEntryIndex].key, key); }, bFound);
 
-      m_pEntries[uiIndex].value = std::forward<CompatibleValueType>(value); // Either move or copy assignment.
-      return true;
-    }
-    ++uiIndex;
-    if (uiIndex == m_uiCapacity)
-      uiIndex = 0;
+  if (bFound)
+  {
+    if (out_oldValue != nullptr)
+      *out_oldValue = std::move(m_pEntries[uiIndex].value);
 
-    ++uiCounter;
+    m_pEntries[uiIndex].value = std::forward<CompatibleValueType>(value); // Either move or copy assignment.
+    return true;
   }
 
   // new entry
-  uiIndex = uiDeletedIndex != ezInvalidIndex ? uiDeletedIndex : uiIndex;
 
   // Both constructions might either be a move or a copy.
   ezMemoryUtils::CopyOrMoveConstruct(&m_pEntries[uiIndex].key, std::forward<CompatibleKeyType>(key));
   ezMemoryUtils::CopyOrMoveConstruct(&m_pEntries[uiIndex].value, std::forward<CompatibleValueType>(value));
 
-  MarkEntryAsValid(uiIndex);
+  m_Storage.MarkEntryAsValid(uiIndex, uiHash);
   ++m_uiCount;
 
   return false;
 }
 
-template <typename K, typename V, typename H>
+template <typename K, typename V, typename H, typename S>
 template <typename CompatibleKeyType>
-bool ezHashTableBase<K, V, H>::Remove(const CompatibleKeyType& key, V* out_oldValue /*= nullptr*/)
+bool ezHashTableBase<K, V, H, S>::Remove(const CompatibleKeyType& key, V* out_oldValue /*= nullptr*/)
 {
   ezUInt32 uiIndex = FindEntry(key);
   if (uiIndex != ezInvalidIndex)
@@ -388,8 +379,8 @@ bool ezHashTableBase<K, V, H>::Remove(const CompatibleKeyType& key, V* out_oldVa
   return false;
 }
 
-template <typename K, typename V, typename H>
-typename ezHashTableBase<K, V, H>::Iterator ezHashTableBase<K, V, H>::Remove(const typename ezHashTableBase<K, V, H>::Iterator& pos)
+template <typename K, typename V, typename H, typename S>
+typename ezHashTableBase<K, V, H, S>::Iterator ezHashTableBase<K, V, H, S>::Remove(const typename ezHashTableBase<K, V, H, S>::Iterator& pos)
 {
   Iterator it = pos;
   ezUInt32 uiIndex = pos.m_uiCurrentIndex;
@@ -399,46 +390,19 @@ typename ezHashTableBase<K, V, H>::Iterator ezHashTableBase<K, V, H>::Remove(con
   return it;
 }
 
-template <typename K, typename V, typename H>
-void ezHashTableBase<K, V, H>::RemoveInternal(ezUInt32 uiIndex)
+template <typename K, typename V, typename H, typename S>
+void ezHashTableBase<K, V, H, S>::RemoveInternal(ezUInt32 uiIndex)
 {
   ezMemoryUtils::Destruct(&m_pEntries[uiIndex].key, 1);
   ezMemoryUtils::Destruct(&m_pEntries[uiIndex].value, 1);
 
-  ezUInt32 uiNextIndex = uiIndex + 1;
-  if (uiNextIndex == m_uiCapacity)
-    uiNextIndex = 0;
-
-  // if the next entry is free we are at the end of a chain and
-  // can immediately mark this entry as free as well
-  if (IsFreeEntry(uiNextIndex))
-  {
-    MarkEntryAsFree(uiIndex);
-
-    // run backwards and free all deleted entries in this chain
-    ezUInt32 uiPrevIndex = (uiIndex != 0) ? uiIndex : m_uiCapacity;
-    --uiPrevIndex;
-
-    while (IsDeletedEntry(uiPrevIndex))
-    {
-      MarkEntryAsFree(uiPrevIndex);
-
-      if (uiPrevIndex == 0)
-        uiPrevIndex = m_uiCapacity;
-      --uiPrevIndex;
-    }
-  }
-  else
-  {
-    MarkEntryAsDeleted(uiIndex);
-  }
-
+  m_Storage.MarkEntryAsRemoved(uiIndex, m_uiCapacity);
   --m_uiCount;
 }
 
-template <typename K, typename V, typename H>
+template <typename K, typename V, typename H, typename S>
 template <typename CompatibleKeyType>
-inline bool ezHashTableBase<K, V, H>::TryGetValue(const CompatibleKeyType& key, V& out_value) const
+inline bool ezHashTableBase<K, V, H, S>::TryGetValue(const CompatibleKeyType& key, V& out_value) const
 {
   ezUInt32 uiIndex = FindEntry(key);
   if (uiIndex != ezInvalidIndex)
@@ -450,9 +414,9 @@ inline bool ezHashTableBase<K, V, H>::TryGetValue(const CompatibleKeyType& key,
   return false;
 }
 
-template <typename K, typename V, typename H>
+template <typename K, typename V, typename H, typename S>
 template <typename CompatibleKeyType>
-inline bool ezHashTableBase<K, V, H>::TryGetValue(const CompatibleKeyType& key, const V*& out_pValue) const
+inline bool ezHashTableBase<K, V, H, S>::TryGetValue(const CompatibleKeyType& key, const V*& out_pValue) const
 {
   ezUInt32 uiIndex = FindEntry(key);
   if (uiIndex != ezInvalidIndex)
@@ -464,9 +428,9 @@ inline bool ezHashTableBase<K, V, H>::TryGetValue(const CompatibleKeyType& key,
   return false;
 }
 
-template <typename K, typename V, typename H>
+template <typename K, typename V, typename H, typename S>
 template <typename CompatibleKeyType>
-inline bool ezHashTableBase<K, V, H>::TryGetValue(const CompatibleKeyType& key, V*& out_pValue) const
+inline bool ezHashTableBase<K, V, H, S>::TryGetValue(const CompatibleKeyType& key, V*& out_pValue) const
 {
   ezUInt32 uiIndex = FindEntry(key);
   if (uiIndex != ezInvalidIndex)
@@ -478,9 +442,9 @@ inline bool ezHashTableBase<K, V, H>::TryGetValue(const CompatibleKeyType& key,
   return false;
 }
 
-template <typename K, typename V, typename H>
+template <typename K, typename V, typename H, typename S>
 template <typename CompatibleKeyType>
-inline typename ezHashTableBase<K, V, H>::ConstIterator ezHashTableBase<K, V, H>::Find(const CompatibleKeyType& key) const
+inline typename ezHashTableBase<K, V, H, S>::ConstIterator ezHashTableBase<K, V, H, S>::Find(const CompatibleKeyType& key) const
 {
   ezUInt32 uiIndex = FindEntry(key);
   if (uiIndex == ezInvalidIndex)
@@ -495,9 +459,9 @@ inline typename ezHashTableBase<K, V, H>::ConstIterator ezHashTableBase<K, V, H>
   return it;
 }
 
-template <typename K, typename V, typename H>
+template <typename K, typename V, typename H, typename S>
 template <typename CompatibleKeyType>
-inline typename ezHashTableBase<K, V, H>::Iterator ezHashTableBase<K, V, H>::Find(const CompatibleKeyType& key)
+inline typename ezHashTableBase<K, V, H, S>::Iterator ezHashTableBase<K, V, H, S>::Find(const CompatibleKeyType& key)
 {
   ezUInt32 uiIndex = FindEntry(key);
   if (uiIndex == ezInvalidIndex)
@@ -512,24 +476,24 @@ inline typename ezHashTableBase<K, V, H>::Iterator ezHashTableBase<K, V, H>::Fin
 }
 
 
-template <typename K, typename V, typename H>
+template <typename K, typename V, typename H, typename S>
 template <typename CompatibleKeyType>
-inline const V* ezHashTableBase<K, V, H>::GetValue(const CompatibleKeyType& key) const
+inline const V* ezHashTableBase<K, V, H, S>::GetValue(const CompatibleKeyType& key) const
 {
   ezUInt32 uiIndex = FindEntry(key);
   return (uiIndex != ezInvalidIndex) ? &m_pEntries[uiIndex].value : nullptr;
 }
 
-template <typename K, typename V, typename H>
+template <typename K, typename V, typename H, typename S>
 template <typename CompatibleKeyType>
-inline V* ezHashTableBase<K, V, H>::GetValue(const CompatibleKeyType& key)
+inline V* ezHashTableBase<K, V, H, S>::GetValue(const CompatibleKeyType& key)
 {
   ezUInt32 uiIndex = FindEntry(key);
   return (uiIndex != ezInvalidIndex) ? &m_pEntries[uiIndex].value : nullptr;
 }
 
-template <typename K, typename V, typename H>
-inline V& ezHashTableBase<K, V, H>::operator[](const K& key)
+template <typename K, typename V, typename H, typename S>
+inline V& ezHashTableBase<K, V, H, S>::operator[](const K& key)
 {
   const ezUInt32 uiHash = H::Hash(key);
   ezUInt32 uiIndex = FindEntry(uiHash, key);
@@ -539,277 +503,190 @@ inline V& ezHashTableBase<K, V, H>::operator[](const K& key)
     Reserve(m_uiCount + 1);
 
     // search for suitable insertion index again, table might have been resized
-    uiIndex = uiHash & (m_uiCapacity - 1);
-    while (IsValidEntry(uiIndex))
-    {
-      ++uiIndex;
-      if (uiIndex == m_uiCapacity)
-        uiIndex = 0;
-    }
+    uiIndex = m_Storage.FindInsertPosition(uiHash & (m_uiCapacity - 1), uiHash, m_uiCapacity);
 
     // new entry
     ezMemoryUtils::CopyConstruct(&m_pEntries[uiIndex].key, key, 1);
     ezMemoryUtils::DefaultConstruct(&m_pEntries[uiIndex].value, 1);
-    MarkEntryAsValid(uiIndex);
+    m_Storage.MarkEntryAsValid(uiIndex, uiHash);
     ++m_uiCount;
   }
   return m_pEntries[uiIndex].value;
 }
 
-template <typename K, typename V, typename H>
+template <typename K, typename V, typename H, typename S>
 template <typename CompatibleKeyType>
-EZ_FORCE_INLINE bool ezHashTableBase<K, V, H>::Contains(const CompatibleKeyType& key) const
+EZ_FORCE_INLINE bool ezHashTableBase<K, V, H, S>::Contains(const CompatibleKeyType& key) const
 {
   return FindEntry(key) != ezInvalidIndex;
 }
 
-template <typename K, typename V, typename H>
-EZ_ALWAYS_INLINE typename ezHashTableBase<K, V, H>::Iterator ezHashTableBase<K, V, H>::GetIterator()
+template <typename K, typename V, typename H, typename S>
+EZ_ALWAYS_INLINE typename ezHashTableBase<K, V, H, S>::Iterator ezHashTableBase<K, V, H, S>::GetIterator()
 {
   Iterator iterator(*this);
   iterator.SetToBegin();
   return iterator;
 }
 
-template <typename K, typename V, typename H>
-EZ_ALWAYS_INLINE typename ezHashTableBase<K, V, H>::Iterator ezHashTableBase<K, V, H>::GetEndIterator()
+template <typename K, typename V, typename H, typename S>
+EZ_ALWAYS_INLINE typename ezHashTableBase<K, V, H, S>::Iterator ezHashTableBase<K, V, H, S>::GetEndIterator()
 {
   Iterator iterator(*this);
   iterator.SetToEnd();
   return iterator;
 }
 
-template <typename K, typename V, typename H>
-EZ_ALWAYS_INLINE typename ezHashTableBase<K, V, H>::ConstIterator ezHashTableBase<K, V, H>::GetIterator() const
+template <typename K, typename V, typename H, typename S>
+EZ_ALWAYS_INLINE typename ezHashTableBase<K, V, H, S>::ConstIterator ezHashTableBase<K, V, H, S>::GetIterator() const
 {
   ConstIterator iterator(*this);
   iterator.SetToBegin();
   return iterator;
 }
 
-template <typename K, typename V, typename H>
-EZ_ALWAYS_INLINE typename ezHashTableBase<K, V, H>::ConstIterator ezHashTableBase<K, V, H>::GetEndIterator() const
+template <typename K, typename V, typename H, typename S>
+EZ_ALWAYS_INLINE typename ezHashTableBase<K, V, H, S>::ConstIterator ezHashTableBase<K, V, H, S>::GetEndIterator() const
 {
   ConstIterator iterator(*this);
   iterator.SetToEnd();
   return iterator;
 }
 
-template <typename K, typename V, typename H>
-EZ_ALWAYS_INLINE ezAllocatorBase* ezHashTableBase<K, V, H>::GetAllocator() const
+template <typename K, typename V, typename H, typename S>
+EZ_ALWAYS_INLINE ezAllocatorBase* ezHashTableBase<K, V, H, S>::GetAllocator() const
 {
   return m_pAllocator;
 }
 
-template <typename K, typename V, typename H>
-ezUInt64 ezHashTableBase<K, V, H>::GetHeapMemoryUsage() const
+template <typename K, typename V, typename H, typename S>
+ezUInt64 ezHashTableBase<K, V, H, S>::GetHeapMemoryUsage() const
 {
-  return ((ezUInt64)m_uiCapacity * sizeof(Entry)) + (sizeof(ezUInt32) * (ezUInt64)GetFlagsCapacity());
+  return ((ezUInt64)m_uiCapacity * sizeof(Entry)) + m_Storage.GetHeapMemoryUsage(m_uiCapacity);
 }
 
 // private methods
-template <typename K, typename V, typename H>
-void ezHashTableBase<K, V, H>::SetCapacity(ezUInt32 uiCapacity)
+template <typename K, typename V, typename H, typename S>
+void ezHashTableBase<K, V, H, S>::SetCapacity(ezUInt32 uiCapacity)
 {
   EZ_ASSERT_DEV(ezMath::IsPowerOf2(uiCapacity), "uiCapacity must be a power of two to avoid modulo during lookup.");
   const ezUInt32 uiOldCapacity = m_uiCapacity;
   m_uiCapacity = uiCapacity;
 
   Entry* pOldEntries = m_pEntries;
-  ezUInt32* pOldEntryFlags = m_pEntryFlags;
+  S oldStorage = m_Storage;
 
   m_pEntries = EZ_NEW_RAW_BUFFER(m_pAllocator, Entry, m_uiCapacity);
-  m_pEntryFlags = EZ_NEW_RAW_BUFFER(m_pAllocator, ezUInt32, GetFlagsCapacity());
-  ezMemoryUtils::ZeroFill(m_pEntryFlags, GetFlagsCapacity());
+  m_Storage.Allocate(m_pAllocator, m_uiCapacity);
 
-  m_uiCount = 0;
+  // all keys are unique, so they can be moved to the first free entry of their probe sequence
   for (ezUInt32 i = 0; i < uiOldCapacity; ++i)
   {
-    if (GetFlags(pOldEntryFlags, i) == VALID_ENTRY)
+    if (oldStorage.IsValidEntry(i))
     {
-      EZ_VERIFY(!Insert(std::move(pOldEntries[i].key), std::move(pOldEntries[i].value)), "Implementation error");
+      const ezUInt32 uiHash = H::Hash(pOldEntries[i].key);
+      const ezUInt32 uiIndex = m_Storage.FindInsertPosition(uiHash & (m_uiCapacity - 1), uiHash, m_uiCapacity);
 
-      ezMemoryUtils::Destruct(&pOldEntries[i].key, 1);
-      ezMemoryUtils::Destruct(&pOldEntries[i].value, 1);
+      ezMemoryUtils::RelocateConstruct(&m_pEntries[uiIndex].key, &pOldEntries[i].key, 1);
+      ezMemoryUtils::RelocateConstruct(&m_pEntries[uiIndex].value, &pOldEntries[i].value, 1);
+      m_Storage.MarkEntryAsValid(uiIndex, uiHash);
     }
   }
 
   EZ_DELETE_RAW_BUFFER(m_pAllocator, pOldEntries);
-  EZ_DELETE_RAW_BUFFER(m_pAllocator, pOldEntryFlags);
+  oldStorage.Deallocate(m_pAllocator);
 }
 
-template <typename K, typename V, typename H>
+template <typename K, typename V, typename H, typename S>
 template <typename CompatibleKeyType>
-EZ_ALWAYS_INLINE ezUInt32 ezHashTableBase<K, V, H>::FindEntry(const CompatibleKeyType& key) const
+EZ_ALWAYS_INLINE ezUInt32 ezHashTableBase<K, V, H, S>::FindEntry(const CompatibleKeyType& key) const
 {
   return FindEntry(H::Hash(key), key);
 }
 
-template <typename K, typename V, typename H>
+template <typename K, typename V, typename H, typename S>
 template <typename CompatibleKeyType>
-inline ezUInt32 ezHashTableBase<K, V, H>::FindEntry(ezUInt32 uiHash, const CompatibleKeyType& key) const
+inline ezUInt32 ezHashTableBase<K, V, H, S>::FindEntry(ezUInt32 uiHash, const CompatibleKeyType& key) const
 {
-  if (m_uiCapacity > 0)
-  {
-    ezUInt32 uiIndex = uiHash & (m_uiCapacity - 1);
-    ezUInt32 uiCounter = 0;
-    while (!IsFreeEntry(uiIndex) && uiCounter < m_uiCapacity)
-    {
-      if (IsValidEntry(uiIndex) && H::Equal(m_pEntries[uiIndex].key, key))
-        return uiIndex;
-
-      ++uiIndex;
-      if (uiIndex == m_uiCapacity)
-        uiIndex = 0;
+  if (m_uiCapacity == 0)
+    return ezInvalidIndex;
 
-      ++uiCounter;
-    }
-  }
-  // not found
-  return ezInvalidIndex;
-}
-
-#define EZ_HASHTABLE_USE_BITFLAGS EZ_ON
-
-template <typename K, typename V, typename H>
-EZ_FORCE_INLINE ezUInt32 ezHashTableBase<K, V, H>::GetFlagsCapacity() const
-{
-#if EZ_ENABLED(EZ_HASHTABLE_USE_BITFLAGS)
-  return (m_uiCapacity + 15) / 16;
-#else
-  return m_uiCapacity;
-#endif
-}
-
-template <typename K, typename V, typename H>
-EZ_ALWAYS_INLINE ezUInt32 ezHashTableBase<K, V, H>::GetFlags(ezUInt32* pFlags, ezUInt32 uiEntryIndex) const
-{
-#if EZ_ENABLED(EZ_HASHTABLE_USE_BITFLAGS)
-  const ezUInt32 uiIndex = uiEntryIndex / 16;
-  const ezUInt32 uiSubIndex = (uiEntryIndex & 15) * 2;
-  return (pFlags[uiIndex] >> uiSubIndex) & FLAGS_MASK;
-#else
-  return pFlags[uiEntryIndex] & FLAGS_MASK;
-#endif
-}
-
-template <typename K, typename V, typename H>
-void ezHashTableBase<K, V, H>::SetFlags(ezUInt32 uiEntryIndex, ezUInt32 uiFlags)
-{
-#if EZ_ENABLED(EZ_HASHTABLE_USE_BITFLAGS)
-  const ezUInt32 uiIndex = uiEntryIndex / 16;
-  const ezUInt32 uiSubIndex = (uiEntryIndex & 15) * 2;
-  EZ_ASSERT_DEBUG(uiIndex < GetFlagsCapacity(), "Out of bounds access");
-  m_pEntryFlags[uiIndex] &= ~(FLAGS_MASK << uiSubIndex);
-  m_pEntryFlags[uiIndex] |= (uiFlags << uiSubIndex);
-#else
-  EZ_ASSERT_DEV(uiEntryIndex < GetFlagsCapacity(), "Out of bounds access");
-  m_pEntryFlags[uiEntryIndex] = uiFlags;
-#endif
-}
-
-template <typename K, typename V, typename H>
-EZ_FORCE_INLINE bool ezHashTableBase<K, V, H>::IsFreeEntry(ezUInt32 uiEntryIndex) const
-{
-  return GetFlags(m_pEntryFlags, uiEntryIndex) == FREE_ENTRY;
-}
-
-template <typename K, typename V, typename H>
-EZ_FORCE_INLINE bool ezHashTableBase<K, V, H>::IsValidEntry(ezUInt32 uiEntryIndex) const
-{
-  return GetFlags(m_pEntryFlags, uiEntryIndex) == VALID_ENTRY;
-}
-
-template <typename K, typename V, typename H>
-EZ_FORCE_INLINE bool ezHashTableBase<K, V, H>::IsDeletedEntry(ezUInt32 uiEntryIndex) const
-{
-  return GetFlags(m_pEntryFlags, uiEntryIndex) == DELETED_ENTRY;
-}
-
-template <typename K, typename V, typename H>
-EZ_FORCE_INLINE void ezHashTableBase<K, V, H>::MarkEntryAsFree(ezUInt32 uiEntryIndex)
-{
-  SetFlags(uiEntryIndex, FREE_ENTRY);
-}
-
-template <typename K, typename V, typename H>
-EZ_FORCE_INLINE void ezHashTableBase<K, V, H>::MarkEntryAsValid(ezUInt32 uiEntryIndex)
-{
-  SetFlags(uiEntryIndex, VALID_ENTRY);
+  return m_Storage.FindEntry(
+    uiHash & (m_uiCapacity - 1), uiHash, m_uiCapacity, [&](ezUInt32 uiEntryIndex) { return H::Equal(m_pEntries[uiEntryIndex].key, key); });
 }
 
-template <typename K, typename V, typename H>
-EZ_FORCE_INLINE void ezHashTableBase<K, V, H>::MarkEntryAsDeleted(ezUInt32 uiEntryIndex)
+template <typename K, typename V, typename H, typename S>
+EZ_FORCE_INLINE bool ezHashTableBase<K, V, H, S>::IsValidEntry(ezUInt32 uiEntryIndex) const
 {
-  SetFlags(uiEntryIndex, DELETED_ENTRY);
+  return m_Storage.IsValidEntry(uiEntryIndex);
 }
 
 
-template <typename K, typename V, typename H, typename A>
-ezHashTable<K, V, H, A>::ezHashTable()
-  : ezHashTableBase<K, V, H>(A::GetAllocator())
+template <typename K, typename V, typename H, typename A, typename S>
+ezHashTable<K, V, H, A, S>::ezHashTable()
+  : ezHashTableBase<K, V, H, S>(A::GetAllocator())
 {
 }
 
-template <typename K, typename V, typename H, typename A>
-ezHashTable<K, V, H, A>::ezHashTable(ezAllocatorBase* pAllocator)
-  : ezHashTableBase<K, V, H>(pAllocator)
+template <typename K, typename V, typename H, typename A, typename S>
+ezHashTable<K, V, H, A, S>::ezHashTable(ezAllocatorBase* pAllocator)
+  : ezHashTableBase<K, V, H, S>(pAllocator)
 {
 }
 
-template <typename K, typename V, typename H, typename A>
-ezHashTable<K, V, H, A>::ezHashTable(const ezHashTable<K, V, H, A>& other)
-  : ezHashTableBase<K, V, H>(other, A::GetAllocator())
+template <typename K, typename V, typename H, typename A, typename S>
+ezHashTable<K, V, H, A, S>::ezHashTable(const ezHashTable<K, V, H, A, S>& other)
+  : ezHashTableBase<K, V, H, S>(other, A::GetAllocator())
 {
 }
 
-template <typename K, typename V, typename H, typename A>
-ezHashTable<K, V, H, A>::ezHashTable(const ezHashTableBase<K, V, H>& other)
-  : ezHashTableBase<K, V, H>(other, A::GetAllocator())
+template <typename K, typename V, typename H, typename A, typename S>
+ezHashTable<K, V, H, A, S>::ezHashTable(const ezHashTableBase<K, V, H, S>& other)
+  : ezHashTableBase<K, V, H, S>(other, A::GetAllocator())
 {
 }
 
-template <typename K, typename V, typename H, typename A>
-ezHashTable<K, V, H, A>::ezHashTable(ezHashTable<K, V, H, A>&& other)
-  : ezHashTableBase<K, V, H>(std::move(other), other.GetAllocator())
+template <typename K, typename V, typename H, typename A, typename S>
+ezHashTable<K, V, H, A, S>::ezHashTable(ezHashTable<K, V, H, A, S>&& other)
+  : ezHashTableBase<K, V, H, S>(std::move(other), other.GetAllocator())
 {
 }
 
-template <typename K, typename V, typename H, typename A>
-ezHashTable<K, V, H, A>::ezHashTable(ezHashTableBase<K, V, H>&& other)
-  : ezHashTableBase<K, V, H>(std::move(other), other.GetAllocator())
+template <typename K, typename V, typename H, typename A, typename S>
+ezHashTable<K, V, H, A, S>::ezHashTable(ezHashTableBase<K, V, H, S>&& other)
+  : ezHashTableBase<K, V, H, S>(std::move(other), other.GetAllocator())
 {
 }
 
-template <typename K, typename V, typename H, typename A>
-void ezHashTable<K, V, H, A>::operator=(const ezHashTable<K, V, H, A>& rhs)
+template <typename K, typename V, typename H, typename A, typename S>
+void ezHashTable<K, V, H, A, S>::operator=(const ezHashTable<K, V, H, A, S>& rhs)
 {
-  ezHashTableBase<K, V, H>::operator=(rhs);
+  ezHashTableBase<K, V, H, S>::operator=(rhs);
 }
 
-template <typename K, typename V, typename H, typename A>
-void ezHashTable<K, V, H, A>::operator=(const ezHashTableBase<K, V, H>& rhs)
+template <typename K, typename V, typename H, typename A, typename S>
+void ezHashTable<K, V, H, A, S>::operator=(const ezHashTableBase<K, V, H, S>& rhs)
 {
-  ezHashTableBase<K, V, H>::operator=(rhs);
+  ezHashTableBase<K, V, H, S>::operator=(rhs);
 }
 
-template <typename K, typename V, typename H, typename A>
-void ezHashTable<K, V, H, A>::operator=(ezHashTable<K, V, H, A>&& rhs)
+template <typename K, typename V, typename H, typename A, typename S>
+void ezHashTable<K, V, H, A, S>::operator=(ezHashTable<K, V, H, A, S>&& rhs)
 {
-  ezHashTableBase<K, V, H>::operator=(std::move(rhs));
+  ezHashTableBase<K, V, H, S>::operator=(std::move(rhs));
 }
 
-template <typename K, typename V, typename H, typename A>
-void ezHashTable<K, V, H, A>::operator=(ezHashTableBase<K, V, H>&& rhs)
+template <typename K, typename V, typename H, typename A, typename S>
+void ezHashTable<K, V, H, A, S>::operator=(ezHashTableBase<K, V, H, S>&& rhs)
 {
-  ezHashTableBase<K, V, H>::operator=(std::move(rhs));
+  ezHashTableBase<K, V, H, S>::operator=(std::move(rhs));
 }
 
-template <typename KeyType, typename ValueType, typename Hasher>
-void ezHashTableBase<KeyType, ValueType, Hasher>::Swap(ezHashTableBase<KeyType, ValueType, Hasher>& other)
+template <typename KeyType, typename ValueType, typename Hasher, typename Storage>
+void ezHashTableBase<KeyType, ValueType, Hasher, Storage>::Swap(ezHashTableBase<KeyType, ValueType, Hasher, Storage>& other)
 {
   ezMath::Swap(this->m_pEntries, other.m_pEntries);
-  ezMath::Swap(this->m_pEntryFlags, other.m_pEntryFlags);
+  ezMath::Swap(this->m_Storage, other.m_Storage);
   ezMath::Swap(this->m_uiCount, other.m_uiCount);
   ezMath::Swap(this->m_uiCapacity, other.m_uiCapacity);
   ezMath::Swap(this->m_pAllocator, other.m_pAllocator);
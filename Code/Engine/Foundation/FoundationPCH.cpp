@@ -108,10 +108,13 @@ EZ_STATICLINK_LIBRARY(Foundation)
   EZ_STATICLINK_REFERENCE(Foundation_Memory_Implementation_AllocatorWrapper);
   EZ_STATICLINK_REFERENCE(Foundation_Memory_Implementation_EndianHelper);
   EZ_STATICLINK_REFERENCE(Foundation_Memory_Implementation_FrameAllocator);
+  EZ_STATICLINK_REFERENCE(Foundation_Memory_Implementation_HeapProfile);
   EZ_STATICLINK_REFERENCE(Foundation_Memory_Implementation_MemoryTracker);
   EZ_STATICLINK_REFERENCE(Foundation_Memory_Implementation_MemoryUtils);
   EZ_STATICLINK_REFERENCE(Foundation_Memory_Implementation_PageAllocator);
+  EZ_STATICLINK_REFERENCE(Foundation_Memory_Implementation_StackAllocator);
   EZ_STATICLINK_REFERENCE(Foundation_Memory_Policies_GuardedAllocation);
+  EZ_STATICLINK_REFERENCE(Foundation_Memory_Policies_SlabAllocation);
   EZ_STATICLINK_REFERENCE(Foundation_Profiling_Implementation_Profiling);
   EZ_STATICLINK_REFERENCE(Foundation_Reflection_Implementation_PropertyAttributes);
   EZ_STATICLINK_REFERENCE(Foundation_Reflection_Implementation_PropertyPath);
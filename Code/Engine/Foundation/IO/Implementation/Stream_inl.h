@@ -245,8 +245,8 @@ ezResult ezStreamWriter::WriteMap(const ezMapBase<KeyType, ValueType, Comparer>&
   return EZ_SUCCESS;
 }
 
-template <typename KeyType, typename ValueType, typename Hasher>
-ezResult ezStreamWriter::WriteHashTable(const ezHashTableBase<KeyType, ValueType, Hasher>& HashTable)
+template <typename KeyType, typename ValueType, typename Hasher, typename Storage>
+ezResult ezStreamWriter::WriteHashTable(const ezHashTableBase<KeyType, ValueType, Hasher, Storage>& HashTable)
 {
   const ezUInt64 uiWriteSize = HashTable.GetCount();
   EZ_SUCCEED_OR_RETURN(WriteQWordValue(&uiWriteSize));
@@ -397,8 +397,8 @@ ezResult ezStreamReader::ReadMap(ezMapBase<KeyType, ValueType, Comparer>& Map)
   }
 }
 
-template <typename KeyType, typename ValueType, typename Hasher>
-ezResult ezStreamReader::ReadHashTable(ezHashTableBase<KeyType, ValueType, Hasher>& HashTable)
+template <typename KeyType, typename ValueType, typename Hasher, typename Storage>
+ezResult ezStreamReader::ReadHashTable(ezHashTableBase<KeyType, ValueType, Hasher, Storage>& HashTable)
 {
   ezUInt64 uiCount = 0;
   EZ_SUCCEED_OR_RETURN(ReadQWordValue(&uiCount));
@@ -61,8 +61,8 @@ public:
   ezResult ReadMap(ezMapBase<KeyType, ValueType, Comparer>& Map); // [tested]
 
   /// \brief Read a hash table (note that the entry order is not stable)
-  template <typename KeyType, typename ValueType, typename Hasher>
-  ezResult ReadHashTable(ezHashTableBase<KeyType, ValueType, Hasher>& HashTable); // [tested]
+  template <typename KeyType, typename ValueType, typename Hasher, typename Storage>
+  ezResult ReadHashTable(ezHashTableBase<KeyType, ValueType, Hasher, Storage>& HashTable); // [tested]
 
   /// \brief Reads a string into an ezStringBuilder
   ezResult ReadString(ezStringBuilder& builder); // [tested]
@@ -152,8 +152,8 @@ public:
   ezResult WriteMap(const ezMapBase<KeyType, ValueType, Comparer>& Map); // [tested]
 
   /// \brief Writes a hash table (note that the entry order might change on read)
-  template <typename KeyType, typename ValueType, typename Hasher>
-  ezResult WriteHashTable(const ezHashTableBase<KeyType, ValueType, Hasher>& HashTable); // [tested]
+  template <typename KeyType, typename ValueType, typename Hasher, typename Storage>
+  ezResult WriteHashTable(const ezHashTableBase<KeyType, ValueType, Hasher, Storage>& HashTable); // [tested]
 
   /// \brief Writes a string
   ezResult WriteString(const ezStringView szStringView); // [tested]
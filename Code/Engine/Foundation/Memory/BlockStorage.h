@@ -61,10 +61,23 @@ public:
   void Clear();
 
   T* Create();
+
+  /// \brief Creates one object for every entry of out_Objects and writes the pointers to it.
+  ///
+  /// Entries of the free list are re-used first. All other objects are appended behind the last object,
+  /// the blocks needed for them are allocated at once and filled contiguously.
+  void Create(ezArrayPtr<T*> out_Objects);
+
   void Delete(T* pObject);
   void Delete(T* pObject, T*& out_pMovedObject);
 
   ezUInt32 GetCount() const;
+
+  /// \brief Returns the index of the given object as used by GetIterator(), or ezInvalidIndex if the object is not part of this storage.
+  ///
+  /// This searches all blocks, so it should not be used for every object in performance critical code.
+  ezUInt32 GetIndex(const T* pObject) const;
+
   Iterator GetIterator(ezUInt32 uiStartIndex = 0, ezUInt32 uiCount = ezInvalidIndex);
   ConstIterator GetIterator(ezUInt32 uiStartIndex = 0, ezUInt32 uiCount = ezInvalidIndex) const;
 
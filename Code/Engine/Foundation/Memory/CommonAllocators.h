@@ -9,6 +9,7 @@
 #include <Foundation/Memory/Policies/GuardedAllocation.h>
 #include <Foundation/Memory/Policies/HeapAllocation.h>
 #include <Foundation/Memory/Policies/ProxyAllocation.h>
+#include <Foundation/Memory/Policies/SlabAllocation.h>
 
 
 /// \brief Default heap allocator
@@ -22,3 +23,6 @@ typedef ezAllocator<ezMemoryPolicies::ezGuardedAllocation> ezGuardedAllocator;
 
 /// \brief Proxy allocator
 typedef ezAllocator<ezMemoryPolicies::ezProxyAllocation> ezProxyAllocator;
+
+/// \brief Allocator for many small allocations, with per-thread caches
+typedef ezAllocator<ezMemoryPolicies::ezSlabAllocation> ezSlabAllocator;
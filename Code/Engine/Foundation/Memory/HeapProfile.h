@@ -0,0 +1,51 @@
+#pragma once
+
+#include <Foundation/Containers/DynamicArray.h>
+#include <Foundation/Containers/HashTable.h>
+#include <Foundation/Containers/HybridArray.h>
+#include <Foundation/Strings/StringBuilder.h>
+
+/// \brief The live memory of sampled allocations, aggregated by the stack traces of the call sites that allocated it.
+///
+/// Captured with ezMemoryTracker::CaptureHeapProfile() from allocators that use ezMemoryTrackingFlags::EnableAllocationSampling.
+/// The bytes and counts are estimates, every sample stands for all the allocations that were not sampled around it.
+/// Subtract a profile that was captured earlier to see which call sites allocated the memory that stayed alive in between.
+class EZ_FOUNDATION_DLL ezHeapProfile
+{
+public:
+  struct Site
+  {
+    ezHybridArray<void*, 32> m_StackTrace; ///< Innermost frame first.
+    ezInt64 m_iLiveBytes = 0;
+    ezInt64 m_iLiveAllocations = 0;
+  };
+
+  /// \brief Removes all sites.
+  void Clear();
+
+  /// \brief Adds memory to the site with the given stack trace. The site is created if it doesn't exist yet.
+  void AddToSite(ezArrayPtr<void* const> stackTrace, ezInt64 iBytes, ezInt64 iAllocations);
+
+  /// \brief Subtracts the sites of the given profile from this one. Sites that end up without any difference are removed.
+  void Subtract(const ezHeapProfile& baseline);
+
+  /// \brief Returns all sites in no particular order.
+  const ezDynamicArray<Site>& GetSites() const { return m_Sites; }
+
+  /// \brief Returns the sum of the live bytes of all sites.
+  ezInt64 GetTotalLiveBytes() const;
+
+  /// \brief Returns the sum of the live allocations of all sites.
+  ezInt64 GetTotalLiveAllocations() const;
+
+  /// \brief Merges all sites into a call tree, starting at the outermost frames, and writes it as text with resolved symbols.
+  ///
+  /// Every line shows the live bytes and allocations of all sites below that frame. Children are sorted by the amount of bytes.
+  void WriteCallTree(ezStringBuilder& out_sText) const;
+
+private:
+  static ezUInt64 GetStackTraceHash(ezArrayPtr<void* const> stackTrace);
+
+  ezDynamicArray<Site> m_Sites;
+  ezHashTable<ezUInt64, ezUInt32> m_SiteIndices;
+};
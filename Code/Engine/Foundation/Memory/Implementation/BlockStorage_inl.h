@@ -193,6 +193,63 @@ T* ezBlockStorage<T, BlockSize, StorageType>::Create()
   return pNewObject;
 }
 
+template <typename T, ezUInt32 BlockSize, ezBlockStorageType::Enum StorageType>
+void ezBlockStorage<T, BlockSize, StorageType>::Create(ezArrayPtr<T*> out_Objects)
+{
+  const ezUInt32 uiNumObjects = out_Objects.GetCount();
+  ezUInt32 uiObjectIndex = 0;
+
+  if (StorageType == ezBlockStorageType::FreeList)
+  {
+    for (; uiObjectIndex < uiNumObjects && m_uiFreelistStart != ezInvalidIndex; ++uiObjectIndex)
+    {
+      out_Objects[uiObjectIndex] = Create();
+    }
+  }
+
+  if (uiObjectIndex == uiNumObjects)
+    return;
+
+  const ezUInt32 uiCapacity = ezDataBlock<T, BlockSize>::CAPACITY;
+  const ezUInt32 uiNumNewObjects = uiNumObjects - uiObjectIndex;
+  const ezUInt32 uiFirstNewIndex = m_uiCount;
+
+  // only the last block can have free space, everything else is taken from new blocks
+  const ezUInt32 uiFreeInLastBlock = m_Blocks.IsEmpty() ? 0 : uiCapacity - m_Blocks.PeekBack().m_uiCount;
+  if (uiNumNewObjects > uiFreeInLastBlock)
+  {
+    const ezUInt32 uiNumNewBlocks = (uiNumNewObjects - uiFreeInLastBlock + uiCapacity - 1) / uiCapacity;
+    const ezUInt32 uiFirstNewBlock = m_Blocks.GetCount();
+
+    m_Blocks.SetCount(uiFirstNewBlock + uiNumNewBlocks, ezDataBlock<T, BlockSize>(nullptr, 0));
+    m_pBlockAllocator->template AllocateBlocks<T>(m_Blocks.GetArrayPtr().GetSubArray(uiFirstNewBlock));
+  }
+
+  while (uiObjectIndex < uiNumObjects)
+  {
+    ezDataBlock<T, BlockSize>& block = m_Blocks[m_uiCount / uiCapacity];
+
+    const ezUInt32 uiNumInBlock = ezMath::Min(uiCapacity - block.m_uiCount, uiNumObjects - uiObjectIndex);
+    T* pFirstObject = block.m_pData + block.m_uiCount;
+
+    ezMemoryUtils::Construct(pFirstObject, uiNumInBlock);
+
+    for (ezUInt32 i = 0; i < uiNumInBlock; ++i)
+    {
+      out_Objects[uiObjectIndex++] = pFirstObject + i;
+    }
+
+    block.m_uiCount += uiNumInBlock;
+    m_uiCount += uiNumInBlock;
+  }
+
+  if (StorageType == ezBlockStorageType::FreeList)
+  {
+    m_UsedEntries.SetCount(m_uiCount);
+    m_UsedEntries.SetBitRange(uiFirstNewIndex, m_uiCount - uiFirstNewIndex);
+  }
+}
+
 template <typename T, ezUInt32 BlockSize, ezBlockStorageType::Enum StorageType>
 EZ_FORCE_INLINE void ezBlockStorage<T, BlockSize, StorageType>::Delete(T* pObject)
 {
@@ -212,6 +269,22 @@ EZ_ALWAYS_INLINE ezUInt32 ezBlockStorage<T, BlockSize, StorageType>::GetCount()
   return m_uiCount;
 }
 
+template <typename T, ezUInt32 BlockSize, ezBlockStorageType::Enum StorageType>
+ezUInt32 ezBlockStorage<T, BlockSize, StorageType>::GetIndex(const T* pObject) const
+{
+  for (ezUInt32 uiBlockIndex = 0; uiBlockIndex < m_Blocks.GetCount(); ++uiBlockIndex)
+  {
+    // compare the addresses first, the pointer difference is only meaningful for objects inside of the block
+    const ezDataBlock<T, BlockSize>& block = m_Blocks[uiBlockIndex];
+    if (pObject >= block.m_pData && pObject < block.m_pData + block.m_uiCount)
+    {
+      return uiBlockIndex * ezDataBlock<T, BlockSize>::CAPACITY + static_cast<ezUInt32>(pObject - block.m_pData);
+    }
+  }
+
+  return ezInvalidIndex;
+}
+
 template <typename T, ezUInt32 BlockSize, ezBlockStorageType::Enum StorageType>
 EZ_ALWAYS_INLINE typename ezBlockStorage<T, BlockSize, StorageType>::Iterator ezBlockStorage<T, BlockSize, StorageType>::GetIterator(
   ezUInt32 uiStartIndex /*= 0*/, ezUInt32 uiCount /*= ezInvalidIndex*/)
@@ -254,16 +327,7 @@ EZ_FORCE_INLINE void ezBlockStorage<T, BlockSize, StorageType>::Delete(T* pObjec
 template <typename T, ezUInt32 BlockSize, ezBlockStorageType::Enum StorageType>
 EZ_FORCE_INLINE void ezBlockStorage<T, BlockSize, StorageType>::Delete(T* pObject, T*& out_pMovedObject, ezTraitInt<ezBlockStorageType::FreeList>)
 {
-  ezUInt32 uiIndex = ezInvalidIndex;
-  for (ezUInt32 uiBlockIndex = 0; uiBlockIndex < m_Blocks.GetCount(); ++uiBlockIndex)
-  {
-    ptrdiff_t diff = pObject - m_Blocks[uiBlockIndex].m_pData;
-    if (diff >= 0 && diff < ezDataBlock<T, BlockSize>::CAPACITY)
-    {
-      uiIndex = uiBlockIndex * ezDataBlock<T, BlockSize>::CAPACITY + (ezInt32)diff;
-      break;
-    }
-  }
+  const ezUInt32 uiIndex = GetIndex(pObject);
 
   EZ_ASSERT_DEV(uiIndex != ezInvalidIndex, "Invalid object {0} was not found in block storage.", ezArgP(pObject));
 
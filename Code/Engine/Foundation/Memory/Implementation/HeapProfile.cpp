@@ -0,0 +1,173 @@
+#include <FoundationPCH.h>
+
+#include <Foundation/Algorithm/HashingUtils.h>
+#include <Foundation/Memory/HeapProfile.h>
+#include <Foundation/System/StackTracer.h>
+
+namespace
+{
+  struct CallTreeNode
+  {
+    void* m_pFrame = nullptr;
+    ezInt64 m_iLiveBytes = 0;
+    ezInt64 m_iLiveAllocations = 0;
+    ezHybridArray<ezUInt32, 4> m_Children;
+  };
+
+  void WriteCallTreeNode(ezDynamicArray<CallTreeNode>& nodes, ezUInt32 uiNodeIndex, ezUInt32 uiDepth, ezStringBuilder& out_sText)
+  {
+    CallTreeNode& node = nodes[uiNodeIndex];
+
+    if (uiDepth > 0)
+    {
+      ezStringBuilder sSymbol;
+      ezStackTracer::ResolveStackTrace(ezArrayPtr<void*>(&node.m_pFrame, 1), [&sSymbol](const char* szText) { sSymbol.Append(szText); });
+      sSymbol.Trim(" \t\r\n");
+
+      if (sSymbol.IsEmpty())
+      {
+        sSymbol.Format("{}", ezArgP(node.m_pFrame));
+      }
+
+      for (ezUInt32 i = 1; i < uiDepth; ++i)
+      {
+        out_sText.Append("  ");
+      }
+
+      out_sText.AppendFormat("{} bytes, {} allocations: {}\n", node.m_iLiveBytes, node.m_iLiveAllocations, sSymbol);
+    }
+
+    node.m_Children.Sort([&nodes](ezUInt32 a, ezUInt32 b) { return ezMath::Abs(nodes[a].m_iLiveBytes) > ezMath::Abs(nodes[b].m_iLiveBytes); });
+
+    // copy, nodes might not stay where they are
+    const ezHybridArray<ezUInt32, 4> children = node.m_Children;
+    for (ezUInt32 uiChild : children)
+    {
+      WriteCallTreeNode(nodes, uiChild, uiDepth + 1, out_sText);
+    }
+  }
+} // namespace
+
+void ezHeapProfile::Clear()
+{
+  m_Sites.Clear();
+  m_SiteIndices.Clear();
+}
+
+void ezHeapProfile::AddToSite(ezArrayPtr<void* const> stackTrace, ezInt64 iBytes, ezInt64 iAllocations)
+{
+  const ezUInt64 uiHash = GetStackTraceHash(stackTrace);
+
+  ezUInt32 uiSiteIndex;
+  if (!m_SiteIndices.TryGetValue(uiHash, uiSiteIndex))
+  {
+    uiSiteIndex = m_Sites.GetCount();
+    m_SiteIndices.Insert(uiHash, uiSiteIndex);
+
+    Site& site = m_Sites.ExpandAndGetRef();
+    site.m_StackTrace.SetCountUninitialized(stackTrace.GetCount());
+    ezMemoryUtils::Copy(site.m_StackTrace.GetData(), stackTrace.GetPtr(), stackTrace.GetCount());
+  }
+
+  Site& site = m_Sites[uiSiteIndex];
+  site.m_iLiveBytes += iBytes;
+  site.m_iLiveAllocations += iAllocations;
+}
+
+void ezHeapProfile::Subtract(const ezHeapProfile& baseline)
+{
+  for (const Site& site : baseline.m_Sites)
+  {
+    AddToSite(site.m_StackTrace, -site.m_iLiveBytes, -site.m_iLiveAllocations);
+  }
+
+  ezDynamicArray<Site> sites;
+  sites.Reserve(m_Sites.GetCount());
+
+  for (Site& site : m_Sites)
+  {
+    if (site.m_iLiveBytes != 0 || site.m_iLiveAllocations != 0)
+    {
+      sites.PushBack(std::move(site));
+    }
+  }
+
+  Clear();
+
+  for (const Site& site : sites)
+  {
+    AddToSite(site.m_StackTrace, site.m_iLiveBytes, site.m_iLiveAllocations);
+  }
+}
+
+ezInt64 ezHeapProfile::GetTotalLiveBytes() const
+{
+  ezInt64 iBytes = 0;
+  for (const Site& site : m_Sites)
+  {
+    iBytes += site.m_iLiveBytes;
+  }
+
+  return iBytes;
+}
+
+ezInt64 ezHeapProfile::GetTotalLiveAllocations() const
+{
+  ezInt64 iAllocations = 0;
+  for (const Site& site : m_Sites)
+  {
+    iAllocations += site.m_iLiveAllocations;
+  }
+
+  return iAllocations;
+}
+
+void ezHeapProfile::WriteCallTree(ezStringBuilder& out_sText) const
+{
+  out_sText.Clear();
+  out_sText.AppendFormat("Total: {} bytes, {} allocations\n", GetTotalLiveBytes(), GetTotalLiveAllocations());
+
+  ezDynamicArray<CallTreeNode> nodes;
+  nodes.ExpandAndGetRef(); // root
+
+  // (parent node index, frame) -> node index
+  ezHashTable<ezUInt64, ezUInt32> nodeIndices;
+
+  for (const Site& site : m_Sites)
+  {
+    ezUInt32 uiNodeIndex = 0;
+    nodes[0].m_iLiveBytes += site.m_iLiveBytes;
+    nodes[0].m_iLiveAllocations += site.m_iLiveAllocations;
+
+    for (ezUInt32 i = site.m_StackTrace.GetCount(); i-- > 0;)
+    {
+      void* pFrame = site.m_StackTrace[i];
+
+      const ezUInt64 uiKey = ezHashingUtils::xxHash64(&pFrame, sizeof(void*), uiNodeIndex);
+
+      ezUInt32 uiChildIndex;
+      if (!nodeIndices.TryGetValue(uiKey, uiChildIndex))
+      {
+        uiChildIndex = nodes.GetCount();
+        nodeIndices.Insert(uiKey, uiChildIndex);
+
+        nodes.ExpandAndGetRef().m_pFrame = pFrame;
+        nodes[uiNodeIndex].m_Children.PushBack(uiChildIndex);
+      }
+
+      uiNodeIndex = uiChildIndex;
+      nodes[uiNodeIndex].m_iLiveBytes += site.m_iLiveBytes;
+      nodes[uiNodeIndex].m_iLiveAllocations += site.m_iLiveAllocations;
+    }
+  }
+
+  WriteCallTreeNode(nodes, 0, 0, out_sText);
+}
+
+// static
+ezUInt64 ezHeapProfile::GetStackTraceHash(ezArrayPtr<void* const> stackTrace)
+{
+  return ezHashingUtils::xxHash64(stackTrace.GetPtr(), stackTrace.GetCount() * sizeof(void*));
+}
+
+EZ_STATICLINK_FILE(Foundation, Foundation_Memory_Implementation_HeapProfile);
@@ -90,6 +90,41 @@ EZ_FORCE_INLINE ezDataBlock<T, BlockSize> ezLargeBlockAllocator<BlockSize>::Allo
   return block;
 }
 
+template <ezUInt32 BlockSize>
+template <typename T>
+void ezLargeBlockAllocator<BlockSize>::AllocateBlocks(ezArrayPtr<ezDataBlock<T, BlockSize>> out_Blocks)
+{
+  struct Helper
+  {
+    enum
+    {
+      BLOCK_CAPACITY = ezDataBlock<T, BlockSize>::CAPACITY
+    };
+  };
+
+  EZ_CHECK_AT_COMPILETIME_MSG(
+    Helper::BLOCK_CAPACITY >= 1, "Type is too big for block allocation. Consider using regular heap allocation instead or increase the block size.");
+
+  EZ_LOCK(m_mutex);
+
+  // the allocations are reported to the memory tracker in batches, so the stack trace is only captured once per batch
+  void* ptrs[64];
+  for (ezUInt32 uiFirstBlock = 0; uiFirstBlock < out_Blocks.GetCount(); uiFirstBlock += EZ_ARRAY_SIZE(ptrs))
+  {
+    ezTime fAllocationTime = ezTime::Now();
+
+    const ezUInt32 uiNumBlocks = ezMath::Min<ezUInt32>(out_Blocks.GetCount() - uiFirstBlock, EZ_ARRAY_SIZE(ptrs));
+    for (ezUInt32 i = 0; i < uiNumBlocks; ++i)
+    {
+      ptrs[i] = AllocateUnlocked(EZ_ALIGNMENT_OF(T));
+      out_Blocks[uiFirstBlock + i] = ezDataBlock<T, BlockSize>(static_cast<T*>(ptrs[i]), 0);
+    }
+
+    ezMemoryTracker::AddAllocations(
+      m_Id, m_TrackingFlags, ezArrayPtr<void* const>(ptrs, uiNumBlocks), BlockSize, EZ_ALIGNMENT_OF(T), ezTime::Now() - fAllocationTime);
+  }
+}
+
 template <ezUInt32 BlockSize>
 template <typename T>
 EZ_FORCE_INLINE void ezLargeBlockAllocator<BlockSize>::DeallocateBlock(ezDataBlock<T, BlockSize>& block)
@@ -126,6 +161,16 @@ void* ezLargeBlockAllocator<BlockSize>::Allocate(size_t uiAlign)
 
   EZ_LOCK(m_mutex);
 
+  void* ptr = AllocateUnlocked(uiAlign);
+
+  ezMemoryTracker::AddAllocation(m_Id, m_TrackingFlags, ptr, BlockSize, uiAlign, ezTime::Now() - fAllocationTime);
+
+  return ptr;
+}
+
+template <ezUInt32 BlockSize>
+void* ezLargeBlockAllocator<BlockSize>::AllocateUnlocked(size_t uiAlign)
+{
   void* ptr = nullptr;
 
   if (!m_freeBlocks.IsEmpty())
@@ -162,8 +207,6 @@ void* ezLargeBlockAllocator<BlockSize>::Allocate(size_t uiAlign)
     ptr = pMemory;
   }
 
-  ezMemoryTracker::AddAllocation(m_Id, m_TrackingFlags, ptr, BlockSize, uiAlign, ezTime::Now() - fAllocationTime);
-
   return ptr;
 }
 
@@ -4,9 +4,11 @@
 #include <Foundation/Containers/IdTable.h>
 #include <Foundation/Logging/Log.h>
 #include <Foundation/Memory/Allocator.h>
+#include <Foundation/Memory/HeapProfile.h>
 #include <Foundation/Memory/Policies/HeapAllocation.h>
 #include <Foundation/Strings/String.h>
 #include <Foundation/System/StackTracer.h>
+#include <Foundation/Threading/AtomicInteger.h>
 #include <Foundation/Threading/Lock.h>
 #include <Foundation/Threading/Mutex.h>
 
@@ -41,6 +43,51 @@ namespace
     ezHashTable<const void*, ezMemoryTracker::AllocationInfo, ezHashHelper<const void*>, TrackerDataAllocatorWrapper> m_Allocations;
   };
 
+  struct SampleKey
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    const void* m_Ptr;
+    ezAllocatorId m_AllocatorId;
+  };
+
+  struct SampleKeyHashHelper
+  {
+    EZ_ALWAYS_INLINE static ezUInt32 Hash(const SampleKey& key) { return ezHashHelper<const void*>::Hash(key.m_Ptr); }
+
+    EZ_ALWAYS_INLINE static bool Equal(const SampleKey& a, const SampleKey& b)
+    {
+      return a.m_Ptr == b.m_Ptr && a.m_AllocatorId == b.m_AllocatorId;
+    }
+  };
+
+  struct SampledAllocation
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    void** m_pStackTrace;
+    ezUInt32 m_uiStackTraceLength;
+
+    // the estimated bytes and number of allocations this sample stands for
+    double m_fWeightedBytes;
+    double m_fWeightedAllocations;
+
+    EZ_ALWAYS_INLINE ezArrayPtr<void*> GetStackTrace() const { return ezArrayPtr<void*>(m_pStackTrace, m_uiStackTraceLength); }
+  };
+
+  struct SampleShard
+  {
+    ezMutex m_Mutex;
+    ezHashTable<SampleKey, SampledAllocation, SampleKeyHashHelper, TrackerDataAllocatorWrapper> m_Samples;
+  };
+
+  enum
+  {
+    NUM_SAMPLE_SHARDS = 16,
+    NUM_SAMPLE_FILTER_COUNTERS = 4096,
+    DEFAULT_SAMPLING_INTERVAL = 512 * 1024,
+  };
+
   struct TrackerData
   {
     EZ_ALWAYS_INLINE void Lock() { m_Mutex.Lock(); }
@@ -52,8 +99,26 @@ namespace
     AllocatorTable m_AllocatorData;
 
     ezAllocatorId m_StaticAllocatorId;
+
+    ezAtomicInteger64 m_iSamplingInterval = DEFAULT_SAMPLING_INTERVAL;
+
+    // Sampled allocations can be freed on any thread, so they are stored in shards with their own locks.
+    SampleShard m_SampleShards[NUM_SAMPLE_SHARDS];
+
+    // Counts the sampled allocations per pointer hash. Deallocations whose counter is zero were not sampled and don't need to lock a shard.
+    ezAtomicInteger32 m_SampleFilter[NUM_SAMPLE_FILTER_COUNTERS];
   };
 
+  struct SamplingState
+  {
+    ezUInt64 m_uiRandom;
+    ezInt64 m_iInterval;
+    ezInt64 m_iBytesUntilSample;
+  };
+
+  // whether an allocation is sampled is decided per thread, so allocations that are not sampled never have to synchronize
+  thread_local SamplingState s_SamplingState;
+
   static TrackerData* s_pTrackerData;
   static bool s_bIsInitialized = false;
   static bool s_bIsInitializing = false;
@@ -99,6 +164,61 @@ namespace
 
     ezLog::Print("--------------------------------------------------------------------\n\n");
   }
+
+  EZ_ALWAYS_INLINE ezUInt32 GetSampleFilterIndex(const void* ptr)
+  {
+    return static_cast<ezUInt32>(((reinterpret_cast<size_t>(ptr) >> 4) * 0x9E3779B97F4A7C15ull) >> 52);
+  }
+
+  EZ_ALWAYS_INLINE SampleShard& GetSampleShard(const void* ptr)
+  {
+    return s_pTrackerData->m_SampleShards[GetSampleFilterIndex(ptr) % NUM_SAMPLE_SHARDS];
+  }
+
+  /// Returns the number of bytes until the next sample. The distances between samples are exponentially distributed,
+  /// which makes every allocated byte equally likely to be sampled, independent of the size of the allocation it belongs to.
+  static ezInt64 GetNextSampleDistance(SamplingState& state)
+  {
+    if (state.m_uiRandom == 0)
+    {
+      state.m_uiRandom = (reinterpret_cast<size_t>(&state) ^ static_cast<ezUInt64>(ezTime::Now().GetNanoseconds())) | 1;
+    }
+
+    // xorshift64
+    state.m_uiRandom ^= state.m_uiRandom << 13;
+    state.m_uiRandom ^= state.m_uiRandom >> 7;
+    state.m_uiRandom ^= state.m_uiRandom << 17;
+
+    // uniform in (0, 1]
+    const double fUniform = ((state.m_uiRandom >> 11) + 1) * (1.0 / 9007199254740992.0);
+    const double fDistance = -ezMath::Ln(fUniform) * static_cast<double>(state.m_iInterval);
+
+    return ezMath::Max<ezInt64>(1, static_cast<ezInt64>(fDistance));
+  }
+
+  static void RemoveSamples(ezAllocatorId allocatorId)
+  {
+    for (ezUInt32 uiShard = 0; uiShard < NUM_SAMPLE_SHARDS; ++uiShard)
+    {
+      SampleShard& shard = s_pTrackerData->m_SampleShards[uiShard];
+      EZ_LOCK(shard.m_Mutex);
+
+      for (auto it = shard.m_Samples.GetIterator(); it.IsValid();)
+      {
+        if (it.Key().m_AllocatorId == allocatorId)
+        {
+          s_pTrackerData->m_SampleFilter[GetSampleFilterIndex(it.Key().m_Ptr)].Decrement();
+          EZ_DELETE_ARRAY(s_pTrackerDataAllocator, it.Value().GetStackTrace());
+
+          it = shard.m_Samples.Remove(it);
+        }
+        else
+        {
+          ++it;
+        }
+      }
+    }
+  }
 } // namespace
 
 // Iterator
@@ -182,6 +302,11 @@ void ezMemoryTracker::DeregisterAllocator(ezAllocatorId allocatorId)
     EZ_REPORT_FAILURE("Allocator '{0}' leaked {1} allocation(s)", data.m_sName.GetData(), uiLiveAllocations);
   }
 
+  if (data.m_Flags.IsSet(ezMemoryTrackingFlags::EnableAllocationSampling))
+  {
+    RemoveSamples(allocatorId);
+  }
+
   s_pTrackerData->m_AllocatorData.Remove(allocatorId);
 }
 
@@ -219,6 +344,49 @@ void ezMemoryTracker::AddAllocation(
   }
 }
 
+// static
+void ezMemoryTracker::AddAllocations(ezAllocatorId allocatorId, ezBitflags<ezMemoryTrackingFlags> flags, ezArrayPtr<void* const> ptrs, size_t uiSize,
+  size_t uiAlign, ezTime allocationTime)
+{
+  EZ_ASSERT_DEV(uiAlign < 0xFFFF, "Alignment too big");
+
+  void* pBuffer[64];
+  ezUInt32 uiNumTraces = 0;
+  if (flags.IsSet(ezMemoryTrackingFlags::EnableStackTrace))
+  {
+    ezArrayPtr<void*> tempTrace(pBuffer);
+    uiNumTraces = ezStackTracer::GetStackTrace(tempTrace);
+  }
+
+  {
+    EZ_LOCK(*s_pTrackerData);
+
+    AllocatorData& data = s_pTrackerData->m_AllocatorData[allocatorId];
+    data.m_Stats.m_uiNumAllocations += ptrs.GetCount();
+    data.m_Stats.m_uiAllocationSize += uiSize * ptrs.GetCount();
+    data.m_Stats.m_uiPerFrameAllocationSize += uiSize * ptrs.GetCount();
+    data.m_Stats.m_PerFrameAllocationTime += allocationTime;
+
+    EZ_ASSERT_DEBUG(data.m_Flags == flags, "Given flags have to be identical to allocator flags");
+
+    for (const void* ptr : ptrs)
+    {
+      // every allocation owns its stack trace, since they can be removed independently
+      ezArrayPtr<void*> stackTrace;
+      if (uiNumTraces > 0)
+      {
+        stackTrace = EZ_NEW_ARRAY(s_pTrackerDataAllocator, void*, uiNumTraces);
+        ezMemoryUtils::Copy(stackTrace.GetPtr(), pBuffer, uiNumTraces);
+      }
+
+      auto pInfo = &data.m_Allocations[ptr];
+      pInfo->m_uiSize = uiSize;
+      pInfo->m_uiAlignment = (ezUInt16)uiAlign;
+      pInfo->SetStackTrace(stackTrace);
+    }
+  }
+}
+
 // static
 void ezMemoryTracker::RemoveAllocation(ezAllocatorId allocatorId, const void* ptr)
 {
@@ -260,6 +428,11 @@ void ezMemoryTracker::RemoveAllAllocations(ezAllocatorId allocatorId)
     EZ_DELETE_ARRAY(s_pTrackerDataAllocator, info.GetStackTrace());
   }
   data.m_Allocations.Clear();
+
+  if (data.m_Flags.IsSet(ezMemoryTrackingFlags::EnableAllocationSampling))
+  {
+    RemoveSamples(allocatorId);
+  }
 }
 
 // static
@@ -423,6 +596,175 @@ void ezMemoryTracker::DumpMemoryLeaks()
   }
 }
 
+// static
+void ezMemoryTracker::SetSamplingInterval(ezUInt64 uiBytes)
+{
+  Initialize();
+
+  s_pTrackerData->m_iSamplingInterval = ezMath::Max<ezInt64>(1, static_cast<ezInt64>(uiBytes));
+}
+
+// static
+ezUInt64 ezMemoryTracker::GetSamplingInterval()
+{
+  Initialize();
+
+  return static_cast<ezUInt64>(static_cast<ezInt64>(s_pTrackerData->m_iSamplingInterval));
+}
+
+// static
+void ezMemoryTracker::SampleAllocation(ezAllocatorId allocatorId, const void* ptr, size_t uiSize)
+{
+  SamplingState& state = s_SamplingState;
+
+  const ezInt64 iInterval = s_pTrackerData->m_iSamplingInterval;
+  if (state.m_iInterval != iInterval)
+  {
+    state.m_iInterval = iInterval;
+    state.m_iBytesUntilSample = GetNextSampleDistance(state);
+  }
+
+  state.m_iBytesUntilSample -= static_cast<ezInt64>(uiSize);
+  if (state.m_iBytesUntilSample > 0)
+    return;
+
+  state.m_iBytesUntilSample = GetNextSampleDistance(state);
+
+  void* pBuffer[64];
+  ezArrayPtr<void*> tempTrace(pBuffer);
+  const ezUInt32 uiNumTraces = ezStackTracer::GetStackTrace(tempTrace);
+
+  ezArrayPtr<void*> stackTrace = EZ_NEW_ARRAY(s_pTrackerDataAllocator, void*, uiNumTraces);
+  ezMemoryUtils::Copy(stackTrace.GetPtr(), pBuffer, uiNumTraces);
+
+  // An allocation of uiSize bytes is sampled with a probability of 1 - e^(-uiSize / interval),
+  // so every sample stands for 1 / probability allocations of its size.
+  const double fSize = static_cast<double>(ezMath::Max<size_t>(uiSize, 1));
+  const double fProbability = 1.0 - ezMath::Exp(-fSize / iInterval);
+
+  SampledAllocation sample;
+  sample.m_pStackTrace = stackTrace.GetPtr();
+  sample.m_uiStackTraceLength = uiNumTraces;
+  sample.m_fWeightedBytes = fSize / fProbability;
+  sample.m_fWeightedAllocations = 1.0 / fProbability;
+
+  SampleKey key;
+  key.m_Ptr = ptr;
+  key.m_AllocatorId = allocatorId;
+
+  SampledAllocation oldSample;
+  bool bExisted = false;
+
+  {
+    SampleShard& shard = GetSampleShard(ptr);
+    EZ_LOCK(shard.m_Mutex);
+
+    bExisted = shard.m_Samples.Insert(key, sample, &oldSample);
+    if (!bExisted)
+    {
+      s_pTrackerData->m_SampleFilter[GetSampleFilterIndex(ptr)].Increment();
+    }
+  }
+
+  if (bExisted)
+  {
+    EZ_DELETE_ARRAY(s_pTrackerDataAllocator, oldSample.GetStackTrace());
+  }
+}
+
+// static
+void ezMemoryTracker::RemoveSampledAllocation(ezAllocatorId allocatorId, const void* ptr)
+{
+  ezAtomicInteger32& filterCounter = s_pTrackerData->m_SampleFilter[GetSampleFilterIndex(ptr)];
+  if (filterCounter == 0)
+    return;
+
+  SampleKey key;
+  key.m_Ptr = ptr;
+  key.m_AllocatorId = allocatorId;
+
+  SampledAllocation sample;
+
+  {
+    SampleShard& shard = GetSampleShard(ptr);
+    EZ_LOCK(shard.m_Mutex);
+
+    if (!shard.m_Samples.Remove(key, &sample))
+      return;
+
+    filterCounter.Decrement();
+  }
+
+  EZ_DELETE_ARRAY(s_pTrackerDataAllocator, sample.GetStackTrace());
+}
+
+// static
+void ezMemoryTracker::CaptureHeapProfile(ezHeapProfile& out_profile, ezAllocatorId allocatorId)
+{
+  out_profile.Clear();
+
+  if (s_pTrackerData == nullptr)
+    return;
+
+  struct CapturedSample
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezUInt32 m_uiFirstFrame;
+    ezUInt32 m_uiNumFrames;
+    double m_fWeightedBytes;
+    double m_fWeightedAllocations;
+  };
+
+  // Building the profile allocates, and with sampling enabled these allocations may be sampled into the shards.
+  // So the samples are copied out with the tracker allocator first, which is never sampled, and the profile is built without holding any lock.
+  // The stack traces have to be copied as well, they are freed as soon as the sampled allocation is.
+  ezDynamicArray<CapturedSample, TrackerDataAllocatorWrapper> samples;
+  ezDynamicArray<void*, TrackerDataAllocatorWrapper> frames;
+
+  for (ezUInt32 uiShard = 0; uiShard < NUM_SAMPLE_SHARDS; ++uiShard)
+  {
+    SampleShard& shard = s_pTrackerData->m_SampleShards[uiShard];
+    EZ_LOCK(shard.m_Mutex);
+
+    for (auto it = shard.m_Samples.GetIterator(); it.IsValid(); ++it)
+    {
+      if (!allocatorId.IsInvalidated() && it.Key().m_AllocatorId != allocatorId)
+        continue;
+
+      const SampledAllocation& sample = it.Value();
+
+      CapturedSample& captured = samples.ExpandAndGetRef();
+      captured.m_uiFirstFrame = frames.GetCount();
+      captured.m_uiNumFrames = sample.m_uiStackTraceLength;
+      captured.m_fWeightedBytes = sample.m_fWeightedBytes;
+      captured.m_fWeightedAllocations = sample.m_fWeightedAllocations;
+
+      frames.PushBackRange(sample.GetStackTrace());
+    }
+  }
+
+  // The weights are fractional. Carry the rounding error over to the next sample, so that the totals stay accurate.
+  double fBytes = 0.0;
+  double fAllocations = 0.0;
+  ezInt64 iBytes = 0;
+  ezInt64 iAllocations = 0;
+
+  for (const CapturedSample& sample : samples)
+  {
+    fBytes += sample.m_fWeightedBytes;
+    fAllocations += sample.m_fWeightedAllocations;
+
+    const ezInt64 iNewBytes = static_cast<ezInt64>(fBytes + 0.5);
+    const ezInt64 iNewAllocations = static_cast<ezInt64>(fAllocations + 0.5);
+
+    out_profile.AddToSite(frames.GetArrayPtr().GetSubArray(sample.m_uiFirstFrame, sample.m_uiNumFrames), iNewBytes - iBytes, iNewAllocations - iAllocations);
+
+    iBytes = iNewBytes;
+    iAllocations = iNewAllocations;
+  }
+}
+
 // static
 ezMemoryTracker::Iterator ezMemoryTracker::GetIterator()
 {
@@ -111,7 +111,7 @@ EZ_ALWAYS_INLINE void ezMemoryUtils::Destruct(T* pDestination, size_t uiCount)
 template <typename T>
 EZ_ALWAYS_INLINE ezMemoryUtils::DestructorFunction ezMemoryUtils::MakeDestructorFunction()
 {
-  return MakeDestructorFunction<T>(ezIsPodType<T>());
+  return MakeDestructorFunction<T>(ezTraitInt<ezIsPodType<T>::value || std::is_trivially_destructible<T>::value>());
 }
 
 EZ_ALWAYS_INLINE void ezMemoryUtils::RawByteCopy(void* pDestination, const void* pSource, size_t uiNumBytesToCopy)
@@ -0,0 +1,54 @@
+#include <FoundationPCH.h>
+
+#include <Foundation/Memory/StackAllocator.h>
+
+namespace
+{
+  enum
+  {
+    NUM_CACHED_ALLOCATORS = 8
+  };
+
+  struct ThreadCache
+  {
+    ezUInt32 m_InstanceIds[NUM_CACHED_ALLOCATORS] = {};
+    void* m_ThreadData[NUM_CACHED_ALLOCATORS] = {};
+    ezUInt32 m_uiNextSlot = 0;
+  };
+
+  static thread_local ThreadCache s_ThreadCache;
+  static ezAtomicInteger32 s_iNextInstanceId;
+} // namespace
+
+ezUInt32 ezInternal::ezStackAllocatorThreadCache::AcquireInstanceId()
+{
+  // 0 marks an empty cache slot
+  return static_cast<ezUInt32>(s_iNextInstanceId.Increment());
+}
+
+void* ezInternal::ezStackAllocatorThreadCache::GetThreadData(ezUInt32 uiInstanceId)
+{
+  ThreadCache& cache = s_ThreadCache;
+
+  for (ezUInt32 i = 0; i < NUM_CACHED_ALLOCATORS; ++i)
+  {
+    if (cache.m_InstanceIds[i] == uiInstanceId)
+      return cache.m_ThreadData[i];
+  }
+
+  return nullptr;
+}
+
+void ezInternal::ezStackAllocatorThreadCache::SetThreadData(ezUInt32 uiInstanceId, void* pThreadData)
+{
+  ThreadCache& cache = s_ThreadCache;
+
+  // replace the oldest entry
+  const ezUInt32 uiSlot = cache.m_uiNextSlot;
+  cache.m_uiNextSlot = (uiSlot + 1) % NUM_CACHED_ALLOCATORS;
+
+  cache.m_InstanceIds[uiSlot] = uiInstanceId;
+  cache.m_ThreadData[uiSlot] = pThreadData;
+}
+
+EZ_STATICLINK_FILE(Foundation, Foundation_Memory_Implementation_StackAllocator);
@@ -1,8 +1,17 @@
+template <ezUInt32 TrackingFlags>
+ezStackAllocator<TrackingFlags>::ThreadData::ThreadData(ezThreadID threadId, ezAllocatorBase* pParent)
+  : m_ThreadId(threadId)
+  , m_DestructData(pParent)
+  , m_DeallocatedPtrs(pParent)
+{
+}
+
 template <ezUInt32 TrackingFlags>
 ezStackAllocator<TrackingFlags>::ezStackAllocator(const char* szName, ezAllocatorBase* pParent)
   : ezAllocator<ezMemoryPolicies::ezStackAllocation, TrackingFlags>(szName, pParent)
-  , m_DestructData(pParent)
-  , m_PtrToDestructDataIndexTable(pParent)
+  , m_uiInstanceId(ezInternal::ezStackAllocatorThreadCache::AcquireInstanceId())
+  , m_ThreadData(pParent)
+  , m_DeallocatedPtrSet(pParent)
 {
 }
 
@@ -10,23 +19,67 @@ template <ezUInt32 TrackingFlags>
 ezStackAllocator<TrackingFlags>::~ezStackAllocator()
 {
   Reset();
+
+  for (ThreadData* pThreadData : m_ThreadData)
+  {
+    EZ_DELETE(this->GetParent(), pThreadData);
+  }
 }
 
 template <ezUInt32 TrackingFlags>
 void* ezStackAllocator<TrackingFlags>::Allocate(size_t uiSize, size_t uiAlign, ezMemoryUtils::DestructorFunction destructorFunc)
 {
-  EZ_LOCK(m_Mutex);
+  // zero size allocations always return nullptr without tracking (since deallocate nullptr is ignored)
+  if (uiSize == 0)
+    return nullptr;
 
-  void* ptr = ezAllocator<ezMemoryPolicies::ezStackAllocation, TrackingFlags>::Allocate(uiSize, uiAlign, destructorFunc);
+  EZ_ASSERT_DEBUG(ezMath::IsPowerOf2((ezUInt32)uiAlign), "Alignment must be power of two");
+  EZ_ASSERT_DEV(uiAlign <= ezMemoryPolicies::ezStackAllocation::Alignment && ezMemoryPolicies::ezStackAllocation::Alignment % uiAlign == 0,
+    "Unsupported alignment {0}", ((ezUInt32)uiAlign));
 
-  if (destructorFunc != nullptr)
+  ezTime fAllocationTime;
+  if ((TrackingFlags & ezMemoryTrackingFlags::EnableAllocationTracking) != 0)
+  {
+    fAllocationTime = ezTime::Now();
+  }
+
+  ThreadData* pThreadData = GetThreadData();
+
+  const size_t uiAlignedSize = ezMemoryUtils::AlignSize(uiSize, (size_t)ezMemoryPolicies::ezStackAllocation::Alignment);
+
+  ezUInt8* ptr = nullptr;
+  if (uiAlignedSize <= static_cast<size_t>(pThreadData->m_pChunkEnd - pThreadData->m_pNextAllocation))
+  {
+    ptr = pThreadData->m_pNextAllocation;
+    pThreadData->m_pNextAllocation += uiAlignedSize;
+  }
+  else
   {
-    ezUInt32 uiIndex = m_DestructData.GetCount();
-    m_PtrToDestructDataIndexTable.Insert(ptr, uiIndex);
+    ptr = AllocateFromSharedPages(pThreadData, uiAlignedSize);
+  }
 
-    auto& data = m_DestructData.ExpandAndGetRef();
+  if (destructorFunc != nullptr)
+  {
+    auto& data = pThreadData->m_DestructData.ExpandAndGetRef();
     data.m_Func = destructorFunc;
     data.m_Ptr = ptr;
+
+    if (!m_bHasDestructData)
+    {
+      m_bHasDestructData = true;
+    }
+  }
+
+  if ((TrackingFlags & ezMemoryTrackingFlags::EnableAllocationTracking) != 0)
+  {
+    ezBitflags<ezMemoryTrackingFlags> flags;
+    flags.SetValue(TrackingFlags);
+
+    ezMemoryTracker::AddAllocation(this->m_Id, flags, ptr, uiSize, uiAlign, ezTime::Now() - fAllocationTime);
+  }
+  else if ((TrackingFlags & ezMemoryTrackingFlags::EnableAllocationSampling) != 0)
+  {
+    ezMemoryTracker::SampleAllocation(this->m_Id, ptr, uiSize);
   }
 
   return ptr;
@@ -35,17 +88,21 @@ void* ezStackAllocator<TrackingFlags>::Allocate(size_t uiSize, size_t uiAlign, e
 template <ezUInt32 TrackingFlags>
 void ezStackAllocator<TrackingFlags>::Deallocate(void* ptr)
 {
-  EZ_LOCK(m_Mutex);
-
-  ezUInt32 uiIndex;
-  if (m_PtrToDestructDataIndexTable.Remove(ptr, &uiIndex))
+  if ((TrackingFlags & ezMemoryTrackingFlags::EnableAllocationTracking) != 0)
+  {
+    ezMemoryTracker::RemoveAllocation(this->m_Id, ptr);
+  }
+  else if ((TrackingFlags & ezMemoryTrackingFlags::EnableAllocationSampling) != 0)
   {
-    auto& data = m_DestructData[uiIndex];
-    data.m_Func = nullptr;
-    data.m_Ptr = nullptr;
+    ezMemoryTracker::RemoveSampledAllocation(this->m_Id, ptr);
   }
 
-  ezAllocator<ezMemoryPolicies::ezStackAllocation, TrackingFlags>::Deallocate(ptr);
+  // Memory is only reused after Reset(), so a pointer is unique until then and Reset() can skip the destructor of a deallocated object.
+  // As long as nothing with a destructor was allocated, there is nothing to skip.
+  if (ptr != nullptr && m_bHasDestructData)
+  {
+    GetThreadData()->m_DeallocatedPtrs.PushBack(ptr);
+  }
 }
 
 EZ_MSVC_ANALYSIS_WARNING_PUSH
@@ -59,14 +116,38 @@ void ezStackAllocator<TrackingFlags>::Reset()
 {
   EZ_LOCK(m_Mutex);
 
-  for (ezUInt32 i = m_DestructData.GetCount(); i-- > 0;)
+  if (m_bHasDestructData)
   {
-    auto& data = m_DestructData[i];
-    if (data.m_Func != nullptr)
-      data.m_Func(data.m_Ptr);
+    for (ThreadData* pThreadData : m_ThreadData)
+    {
+      for (void* ptr : pThreadData->m_DeallocatedPtrs)
+      {
+        m_DeallocatedPtrSet.Insert(ptr);
+      }
+    }
+
+    for (ezUInt32 t = m_ThreadData.GetCount(); t-- > 0;)
+    {
+      auto& destructData = m_ThreadData[t]->m_DestructData;
+      for (ezUInt32 i = destructData.GetCount(); i-- > 0;)
+      {
+        auto& data = destructData[i];
+        if (m_DeallocatedPtrSet.IsEmpty() || !m_DeallocatedPtrSet.Contains(data.m_Ptr))
+          data.m_Func(data.m_Ptr);
+      }
+    }
+
+    m_DeallocatedPtrSet.Clear();
+    m_bHasDestructData = false;
+  }
+
+  for (ThreadData* pThreadData : m_ThreadData)
+  {
+    pThreadData->m_pNextAllocation = nullptr;
+    pThreadData->m_pChunkEnd = nullptr;
+    pThreadData->m_DestructData.Clear();
+    pThreadData->m_DeallocatedPtrs.Clear();
   }
-  m_DestructData.Clear();
-  m_PtrToDestructDataIndexTable.Clear();
 
   this->m_allocator.Reset();
   if ((TrackingFlags & ezMemoryTrackingFlags::EnableAllocationTracking) != 0)
@@ -75,6 +156,11 @@ void ezStackAllocator<TrackingFlags>::Reset()
   }
   else if ((TrackingFlags & ezMemoryTrackingFlags::RegisterAllocator) != 0)
   {
+    if ((TrackingFlags & ezMemoryTrackingFlags::EnableAllocationSampling) != 0)
+    {
+      ezMemoryTracker::RemoveAllAllocations(this->m_Id);
+    }
+
     ezAllocatorBase::Stats stats;
     this->m_allocator.FillStats(stats);
 
@@ -82,3 +168,61 @@ void ezStackAllocator<TrackingFlags>::Reset()
   }
 }
 EZ_MSVC_ANALYSIS_WARNING_POP
+
+template <ezUInt32 TrackingFlags>
+typename ezStackAllocator<TrackingFlags>::ThreadData* ezStackAllocator<TrackingFlags>::GetThreadData()
+{
+  if (void* pThreadData = ezInternal::ezStackAllocatorThreadCache::GetThreadData(m_uiInstanceId))
+  {
+    return static_cast<ThreadData*>(pThreadData);
+  }
+
+  // The cache only holds a few allocators per thread, so the data might already exist
+  const ezThreadID threadId = ezThreadUtils::GetCurrentThreadID();
+
+  EZ_LOCK(m_Mutex);
+
+  ThreadData* pThreadData = nullptr;
+  for (ThreadData* pExistingData : m_ThreadData)
+  {
+    if (pExistingData->m_ThreadId == threadId)
+    {
+      pThreadData = pExistingData;
+      break;
+    }
+  }
+
+  if (pThreadData == nullptr)
+  {
+    pThreadData = EZ_NEW(this->GetParent(), ThreadData, threadId, this->GetParent());
+    m_ThreadData.PushBack(pThreadData);
+  }
+
+  ezInternal::ezStackAllocatorThreadCache::SetThreadData(m_uiInstanceId, pThreadData);
+  return pThreadData;
+}
+
+template <ezUInt32 TrackingFlags>
+ezUInt8* ezStackAllocator<TrackingFlags>::AllocateFromSharedPages(ThreadData* pThreadData, size_t uiSize)
+{
+  EZ_LOCK(m_Mutex);
+
+  // large allocations would waste most of a chunk
+  if (uiSize > MaxChunkAllocationSize)
+  {
+    return static_cast<ezUInt8*>(this->m_allocator.Allocate(uiSize, ezMemoryPolicies::ezStackAllocation::Alignment));
+  }
+
+  ezUInt32 uiChunkSize = pThreadData->m_uiNextChunkSize;
+  while (uiChunkSize < uiSize)
+  {
+    uiChunkSize *= 2;
+  }
+
+  ezUInt8* pChunk = static_cast<ezUInt8*>(this->m_allocator.Allocate(uiChunkSize, ezMemoryPolicies::ezStackAllocation::Alignment));
+  pThreadData->m_pNextAllocation = pChunk + uiSize;
+  pThreadData->m_pChunkEnd = pChunk + uiChunkSize;
+  pThreadData->m_uiNextChunkSize = ezMath::Min<ezUInt32>(uiChunkSize * 2, MaxChunkSize);
+
+  return pChunk;
+}
@@ -45,6 +45,10 @@ public:
   template <typename T>
   ezDataBlock<T, BlockSizeInByte> AllocateBlock();
 
+  /// \brief Allocates one empty block for every entry of out_Blocks. The mutex is only locked once for all of them.
+  template <typename T>
+  void AllocateBlocks(ezArrayPtr<ezDataBlock<T, BlockSizeInByte>> out_Blocks);
+
   template <typename T>
   void DeallocateBlock(ezDataBlock<T, BlockSizeInByte>& block);
 
@@ -57,6 +61,7 @@ public:
 
 private:
   void* Allocate(size_t uiAlign);
+  void* AllocateUnlocked(size_t uiAlign);
   void Deallocate(void* ptr);
 
   ezAllocatorId m_Id;
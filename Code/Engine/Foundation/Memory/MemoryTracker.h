@@ -15,11 +15,15 @@ struct ezMemoryTrackingFlags
                                    ///< allocator implementation whether it collects usable stats or not.
     EnableAllocationTracking = EZ_BIT(1), ///< Enable tracking of individual allocations
     EnableStackTrace = EZ_BIT(2),         ///< Enable stack traces for each allocation
+    EnableAllocationSampling = EZ_BIT(3), ///< Only record a random sample of the allocations, including their stack traces, see
+                                          ///< ezMemoryTracker::SetSamplingInterval(). Has no effect if EnableAllocationTracking is set.
 
-    All = RegisterAllocator | EnableAllocationTracking | EnableStackTrace,
+    All = RegisterAllocator | EnableAllocationTracking | EnableStackTrace | EnableAllocationSampling,
 
     Default = 0
-#if EZ_ENABLED(EZ_USE_ALLOCATION_TRACKING)
+#if EZ_ENABLED(EZ_USE_ALLOCATION_SAMPLING)
+              | RegisterAllocator | EnableAllocationSampling
+#elif EZ_ENABLED(EZ_USE_ALLOCATION_TRACKING)
               | RegisterAllocator | EnableAllocationTracking
 #endif
 #if EZ_ENABLED(EZ_USE_ALLOCATION_STACK_TRACING)
@@ -32,6 +36,7 @@ struct ezMemoryTrackingFlags
     StorageType RegisterAllocator : 1;
     StorageType EnableAllocationTracking : 1;
     StorageType EnableStackTrace : 1;
+    StorageType EnableAllocationSampling : 1;
   };
 };
 
@@ -39,6 +44,8 @@ struct ezMemoryTrackingFlags
 
 #define EZ_STATIC_ALLOCATOR_NAME "Statics"
 
+class ezHeapProfile;
+
 /// \brief Memory tracker which keeps track of all allocations and constructions
 class EZ_FOUNDATION_DLL ezMemoryTracker
 {
@@ -103,6 +110,12 @@ public:
 
   static void AddAllocation(
     ezAllocatorId allocatorId, ezBitflags<ezMemoryTrackingFlags> flags, const void* ptr, size_t uiSize, size_t uiAlign, ezTime allocationTime);
+
+  /// \brief Same as AddAllocation() for several allocations of the same size and alignment that were made at once.
+  ///
+  /// The stack trace is only captured once, each allocation gets its own copy of it. allocationTime is the time it took to make all allocations.
+  static void AddAllocations(ezAllocatorId allocatorId, ezBitflags<ezMemoryTrackingFlags> flags, ezArrayPtr<void* const> ptrs, size_t uiSize,
+    size_t uiAlign, ezTime allocationTime);
   static void RemoveAllocation(ezAllocatorId allocatorId, const void* ptr);
   static void RemoveAllAllocations(ezAllocatorId allocatorId);
   static void SetAllocatorStats(ezAllocatorId allocatorId, const ezAllocatorBase::Stats& stats);
@@ -116,5 +129,24 @@ public:
 
   static void DumpMemoryLeaks();
 
+  /// \brief Sets the average number of bytes that are allocated between two sampled allocations.
+  ///
+  /// Allocators with ezMemoryTrackingFlags::EnableAllocationSampling record one allocation per that many bytes, chosen randomly (as a Poisson
+  /// process). Every thread decides on its own whether to sample an allocation, so allocations that are not sampled never take a lock.
+  /// The default is 512 KB.
+  static void SetSamplingInterval(ezUInt64 uiBytes);
+  static ezUInt64 GetSamplingInterval();
+
+  /// \brief Called by allocators with ezMemoryTrackingFlags::EnableAllocationSampling for every allocation.
+  static void SampleAllocation(ezAllocatorId allocatorId, const void* ptr, size_t uiSize);
+
+  /// \brief Called by allocators with ezMemoryTrackingFlags::EnableAllocationSampling for every deallocation.
+  static void RemoveSampledAllocation(ezAllocatorId allocatorId, const void* ptr);
+
+  /// \brief Aggregates the live sampled allocations by their stack traces.
+  ///
+  /// Only looks at the allocations of the given allocator, if it is valid.
+  static void CaptureHeapProfile(ezHeapProfile& out_profile, ezAllocatorId allocatorId = ezAllocatorId());
+
   static Iterator GetIterator();
 };
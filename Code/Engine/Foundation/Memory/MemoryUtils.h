@@ -80,7 +80,7 @@ public:
   template <typename T>
   static void Destruct(T* pDestination, size_t uiCount); // [tested]
 
-  /// \brief Returns a function pointer to destruct an instance of T. Returns nullptr for POD-types.
+  /// \brief Returns a function pointer to destruct an instance of T. Returns nullptr for POD-types and types that are trivially destructible.
   template <typename T>
   static DestructorFunction MakeDestructorFunction(); // [tested]
 
@@ -0,0 +1,476 @@
+#include <FoundationPCH.h>
+
+#include <Foundation/Memory/PageAllocator.h>
+#include <Foundation/Memory/Policies/SlabAllocation.h>
+#include <Foundation/Threading/AtomicInteger.h>
+#include <Foundation/Threading/Lock.h>
+#include <Foundation/Threading/ThreadUtils.h>
+
+#include <atomic>
+
+namespace
+{
+  enum
+  {
+    SLAB_HEADER_SIZE = 64,
+    THREAD_CACHE_SIZE = 32,
+    NUM_CACHED_POLICIES = 4,
+  };
+
+  struct ThreadCacheLookup
+  {
+    ezUInt32 m_InstanceIds[NUM_CACHED_POLICIES] = {};
+    void* m_ThreadCaches[NUM_CACHED_POLICIES] = {};
+    ezUInt32 m_uiNextSlot = 0;
+  };
+
+  static thread_local ThreadCacheLookup s_ThreadCacheLookup;
+  static ezAtomicInteger32 s_iNextInstanceId;
+} // namespace
+
+/// \internal Three level radix map from slab addresses to whether the slab belongs to a span of this allocator.
+///
+/// Spans are never given back before the allocator is destroyed, so nodes and bits are only ever added.
+/// This allows Deallocate() to read the map without a lock.
+struct ezMemoryPolicies::ezSlabAllocation::SpanMap
+{
+  enum
+  {
+    LeafBits = 15, // one page of bits, covers 128 MB of address space
+    MidBits = 12,
+    RootBits = 9, // together 36 bits of slab index, which covers 48 bit addresses
+  };
+
+  struct Leaf
+  {
+    std::atomic<ezUInt64> m_Bits[(1 << LeafBits) / 64];
+  };
+
+  struct Mid
+  {
+    std::atomic<Leaf*> m_Leaves[1 << MidBits];
+  };
+
+  std::atomic<Mid*> m_Mids[1 << RootBits];
+
+  static ezUInt64 GetSlabIndex(const void* ptr) { return static_cast<ezUInt64>(reinterpret_cast<size_t>(ptr)) / SlabSize; }
+
+  bool Contains(const void* ptr) const
+  {
+    const ezUInt64 uiSlab = GetSlabIndex(ptr);
+
+    if ((uiSlab >> (LeafBits + MidBits + RootBits)) != 0)
+      return false;
+
+    const Mid* pMid = m_Mids[uiSlab >> (LeafBits + MidBits)].load(std::memory_order_acquire);
+    if (pMid == nullptr)
+      return false;
+
+    const Leaf* pLeaf = pMid->m_Leaves[(uiSlab >> LeafBits) & ((1 << MidBits) - 1)].load(std::memory_order_acquire);
+    if (pLeaf == nullptr)
+      return false;
+
+    const ezUInt32 uiBit = static_cast<ezUInt32>(uiSlab & ((1 << LeafBits) - 1));
+    return (pLeaf->m_Bits[uiBit / 64].load(std::memory_order_relaxed) & (1ull << (uiBit % 64))) != 0;
+  }
+
+  void Add(const void* ptr)
+  {
+    const ezUInt64 uiSlab = GetSlabIndex(ptr);
+    EZ_ASSERT_ALWAYS((uiSlab >> (LeafBits + MidBits + RootBits)) == 0, "Address 0x{0} is outside of the range that the span map covers", ezArgU(reinterpret_cast<size_t>(ptr), 16, false, 16, true));
+
+    std::atomic<Mid*>& mid = m_Mids[uiSlab >> (LeafBits + MidBits)];
+    Mid* pMid = mid.load(std::memory_order_relaxed);
+    if (pMid == nullptr)
+    {
+      pMid = new (ezPageAllocator::AllocatePage(sizeof(Mid))) Mid();
+      mid.store(pMid, std::memory_order_release);
+    }
+
+    std::atomic<Leaf*>& leaf = pMid->m_Leaves[(uiSlab >> LeafBits) & ((1 << MidBits) - 1)];
+    Leaf* pLeaf = leaf.load(std::memory_order_relaxed);
+    if (pLeaf == nullptr)
+    {
+      pLeaf = new (ezPageAllocator::AllocatePage(sizeof(Leaf))) Leaf();
+      leaf.store(pLeaf, std::memory_order_release);
+    }
+
+    const ezUInt32 uiBit = static_cast<ezUInt32>(uiSlab & ((1 << LeafBits) - 1));
+    pLeaf->m_Bits[uiBit / 64].fetch_or(1ull << (uiBit % 64), std::memory_order_relaxed);
+  }
+
+  void Clear()
+  {
+    for (auto& mid : m_Mids)
+    {
+      Mid* pMid = mid.load(std::memory_order_relaxed);
+      if (pMid == nullptr)
+        continue;
+
+      for (auto& leaf : pMid->m_Leaves)
+      {
+        if (Leaf* pLeaf = leaf.load(std::memory_order_relaxed))
+        {
+          ezPageAllocator::DeallocatePage(pLeaf);
+        }
+      }
+
+      ezPageAllocator::DeallocatePage(pMid);
+    }
+  }
+};
+
+struct ezMemoryPolicies::ezSlabAllocation::Slab
+{
+  ezUInt32 m_uiSizeClass;
+  ezUInt32 m_uiObjectSize;
+  ezUInt32 m_uiNumUsed; // including the objects in the thread caches
+  ezUInt32 m_uiNumUnused;
+  void* m_pFreeList;
+  ezUInt8* m_pNextUnused;
+  Slab* m_pPrev;
+  Slab* m_pNext;
+  Slab* m_pNextSpan; // only valid for the first slab of every span
+
+  bool HasFreeObjects() const { return m_pFreeList != nullptr || m_uiNumUnused > 0; }
+
+  void* PopObject()
+  {
+    ++m_uiNumUsed;
+
+    if (m_pFreeList != nullptr)
+    {
+      void* ptr = m_pFreeList;
+      m_pFreeList = *static_cast<void**>(ptr);
+      return ptr;
+    }
+
+    --m_uiNumUnused;
+    void* ptr = m_pNextUnused;
+    m_pNextUnused += m_uiObjectSize;
+    return ptr;
+  }
+
+  void PushObject(void* ptr)
+  {
+    --m_uiNumUsed;
+
+    *static_cast<void**>(ptr) = m_pFreeList;
+    m_pFreeList = ptr;
+  }
+};
+
+struct ezMemoryPolicies::ezSlabAllocation::ThreadCache
+{
+  struct Objects
+  {
+    ezUInt32 m_uiCount = 0;
+    void* m_Ptrs[THREAD_CACHE_SIZE];
+  };
+
+  ezThreadID m_ThreadId;
+  ThreadCache* m_pNext = nullptr;
+  Objects m_SizeClasses[NumSizeClasses];
+};
+
+ezMemoryPolicies::ezSlabAllocation::ezSlabAllocation(ezAllocatorBase* pParent)
+  : m_uiInstanceId(static_cast<ezUInt32>(s_iNextInstanceId.Increment()))
+  , m_HeapAllocation(pParent)
+{
+  EZ_CHECK_AT_COMPILETIME(sizeof(Slab) <= SLAB_HEADER_SIZE);
+
+  m_pSpanMap = new (ezPageAllocator::AllocatePage(sizeof(SpanMap))) SpanMap();
+}
+
+ezMemoryPolicies::ezSlabAllocation::~ezSlabAllocation()
+{
+  while (m_pThreadCaches != nullptr)
+  {
+    ThreadCache* pCache = m_pThreadCaches;
+    m_pThreadCaches = pCache->m_pNext;
+
+    pCache->~ThreadCache();
+    m_HeapAllocation.Deallocate(pCache);
+  }
+
+  while (m_pSpans != nullptr)
+  {
+    Slab* pSpan = m_pSpans;
+    m_pSpans = pSpan->m_pNextSpan;
+
+    ezPageAllocator::DeallocatePage(pSpan);
+  }
+
+  m_pSpanMap->Clear();
+  ezPageAllocator::DeallocatePage(m_pSpanMap);
+}
+
+ezUInt32 ezMemoryPolicies::ezSlabAllocation::GetSizeClass(size_t uiSize)
+{
+  EZ_ASSERT_DEBUG(uiSize > 0 && uiSize <= MaxSlabAllocationSize, "Invalid size {0}", (ezUInt32)uiSize);
+
+  // 16 byte steps up to 128, then four steps per power of two
+  if (uiSize <= 128)
+    return static_cast<ezUInt32>((uiSize + 15) / 16 - 1);
+  if (uiSize <= 256)
+    return static_cast<ezUInt32>(8 + (uiSize - 129) / 32);
+  if (uiSize <= 512)
+    return static_cast<ezUInt32>(12 + (uiSize - 257) / 64);
+
+  return static_cast<ezUInt32>(16 + (uiSize - 513) / 128);
+}
+
+ezUInt32 ezMemoryPolicies::ezSlabAllocation::GetSizeClassSize(ezUInt32 uiSizeClass)
+{
+  EZ_ASSERT_DEBUG(uiSizeClass < NumSizeClasses, "Invalid size class {0}", uiSizeClass);
+
+  if (uiSizeClass < 8)
+    return (uiSizeClass + 1) * 16;
+  if (uiSizeClass < 12)
+    return 128 + (uiSizeClass - 7) * 32;
+  if (uiSizeClass < 16)
+    return 256 + (uiSizeClass - 11) * 64;
+
+  return 512 + (uiSizeClass - 15) * 128;
+}
+
+void* ezMemoryPolicies::ezSlabAllocation::Allocate(size_t uiSize, size_t uiAlign)
+{
+  if (uiSize > MaxSlabAllocationSize || uiAlign > Alignment)
+  {
+    return m_HeapAllocation.Allocate(uiSize, uiAlign);
+  }
+
+  const ezUInt32 uiSizeClass = GetSizeClass(uiSize);
+  ThreadCache* pCache = GetThreadCache();
+
+  auto& objects = pCache->m_SizeClasses[uiSizeClass];
+  if (objects.m_uiCount == 0)
+  {
+    RefillThreadCache(pCache, uiSizeClass);
+  }
+
+  return objects.m_Ptrs[--objects.m_uiCount];
+}
+
+void ezMemoryPolicies::ezSlabAllocation::Deallocate(void* ptr)
+{
+  if (ptr == nullptr)
+    return;
+
+  if (!IsSlabMemory(ptr))
+  {
+    m_HeapAllocation.Deallocate(ptr);
+    return;
+  }
+
+  Slab* pSlab = reinterpret_cast<Slab*>(reinterpret_cast<size_t>(ptr) & ~static_cast<size_t>(SlabSize - 1));
+  const ezUInt32 uiSizeClass = pSlab->m_uiSizeClass;
+
+  ThreadCache* pCache = GetThreadCache();
+
+  auto& objects = pCache->m_SizeClasses[uiSizeClass];
+  if (objects.m_uiCount == THREAD_CACHE_SIZE)
+  {
+    FlushThreadCache(pCache, uiSizeClass, THREAD_CACHE_SIZE / 2);
+  }
+
+  objects.m_Ptrs[objects.m_uiCount++] = ptr;
+}
+
+bool ezMemoryPolicies::ezSlabAllocation::IsSlabMemory(const void* ptr) const
+{
+  return m_pSpanMap->Contains(ptr);
+}
+
+void ezMemoryPolicies::ezSlabAllocation::RegisterSpan(const void* pSpan)
+{
+  EZ_ASSERT_DEBUG(m_SlabMutex.IsLocked(), "");
+
+  for (ezUInt32 i = 0; i < SlabsPerSpan; ++i)
+  {
+    m_pSpanMap->Add(static_cast<const ezUInt8*>(pSpan) + i * SlabSize);
+  }
+}
+
+ezMemoryPolicies::ezSlabAllocation::ThreadCache* ezMemoryPolicies::ezSlabAllocation::GetThreadCache()
+{
+  ThreadCacheLookup& lookup = s_ThreadCacheLookup;
+
+  for (ezUInt32 i = 0; i < NUM_CACHED_POLICIES; ++i)
+  {
+    if (lookup.m_InstanceIds[i] == m_uiInstanceId)
+      return static_cast<ThreadCache*>(lookup.m_ThreadCaches[i]);
+  }
+
+  // the lookup only holds a few policies per thread, so the cache might already exist
+  const ezThreadID threadId = ezThreadUtils::GetCurrentThreadID();
+
+  ThreadCache* pCache = nullptr;
+  {
+    EZ_LOCK(m_ThreadCacheMutex);
+
+    for (ThreadCache* pExistingCache = m_pThreadCaches; pExistingCache != nullptr; pExistingCache = pExistingCache->m_pNext)
+    {
+      if (pExistingCache->m_ThreadId == threadId)
+      {
+        pCache = pExistingCache;
+        break;
+      }
+    }
+
+    if (pCache == nullptr)
+    {
+      pCache = new (m_HeapAllocation.Allocate(sizeof(ThreadCache), EZ_ALIGNMENT_OF(ThreadCache))) ThreadCache();
+      pCache->m_ThreadId = threadId;
+      pCache->m_pNext = m_pThreadCaches;
+      m_pThreadCaches = pCache;
+    }
+  }
+
+  const ezUInt32 uiSlot = lookup.m_uiNextSlot;
+  lookup.m_uiNextSlot = (uiSlot + 1) % NUM_CACHED_POLICIES;
+  lookup.m_InstanceIds[uiSlot] = m_uiInstanceId;
+  lookup.m_ThreadCaches[uiSlot] = pCache;
+
+  return pCache;
+}
+
+void ezMemoryPolicies::ezSlabAllocation::RefillThreadCache(ThreadCache* pCache, ezUInt32 uiSizeClass)
+{
+  auto& objects = pCache->m_SizeClasses[uiSizeClass];
+  SizeClass& sizeClass = m_SizeClasses[uiSizeClass];
+
+  EZ_LOCK(sizeClass.m_Mutex);
+
+  // only fill half of the cache, so that the following deallocations don't immediately need to flush it
+  while (objects.m_uiCount < THREAD_CACHE_SIZE / 2)
+  {
+    Slab* pSlab = sizeClass.m_pPartialSlabs;
+    if (pSlab == nullptr)
+    {
+      pSlab = AllocateSlab(uiSizeClass);
+      LinkSlab(sizeClass.m_pPartialSlabs, pSlab);
+    }
+
+    while (objects.m_uiCount < THREAD_CACHE_SIZE / 2 && pSlab->HasFreeObjects())
+    {
+      objects.m_Ptrs[objects.m_uiCount++] = pSlab->PopObject();
+    }
+
+    if (!pSlab->HasFreeObjects())
+    {
+      UnlinkSlab(sizeClass.m_pPartialSlabs, pSlab);
+    }
+  }
+}
+
+void ezMemoryPolicies::ezSlabAllocation::FlushThreadCache(ThreadCache* pCache, ezUInt32 uiSizeClass, ezUInt32 uiNumObjects)
+{
+  auto& objects = pCache->m_SizeClasses[uiSizeClass];
+  SizeClass& sizeClass = m_SizeClasses[uiSizeClass];
+
+  EZ_LOCK(sizeClass.m_Mutex);
+
+  for (ezUInt32 i = 0; i < uiNumObjects; ++i)
+  {
+    void* ptr = objects.m_Ptrs[--objects.m_uiCount];
+    Slab* pSlab = reinterpret_cast<Slab*>(reinterpret_cast<size_t>(ptr) & ~static_cast<size_t>(SlabSize - 1));
+
+    if (!pSlab->HasFreeObjects())
+    {
+      LinkSlab(sizeClass.m_pPartialSlabs, pSlab);
+    }
+
+    pSlab->PushObject(ptr);
+
+    // keep one slab around to prevent allocating and deallocating the same slab over and over
+    if (pSlab->m_uiNumUsed == 0 && (pSlab->m_pPrev != nullptr || pSlab->m_pNext != nullptr))
+    {
+      UnlinkSlab(sizeClass.m_pPartialSlabs, pSlab);
+      DeallocateSlab(pSlab);
+    }
+  }
+}
+
+ezMemoryPolicies::ezSlabAllocation::Slab* ezMemoryPolicies::ezSlabAllocation::AllocateSlab(ezUInt32 uiSizeClass)
+{
+  Slab* pSlab = nullptr;
+
+  {
+    EZ_LOCK(m_SlabMutex);
+
+    if (m_pFreeSlabs == nullptr)
+    {
+      ezUInt8* pSpan = static_cast<ezUInt8*>(ezPageAllocator::AllocatePage(SlabSize * SlabsPerSpan));
+      EZ_CHECK_ALIGNMENT(pSpan, SlabSize);
+
+      for (ezUInt32 i = SlabsPerSpan; i-- > 0;)
+      {
+        Slab* pSpanSlab = reinterpret_cast<Slab*>(pSpan + i * SlabSize);
+        pSpanSlab->m_pNextSpan = nullptr;
+        LinkSlab(m_pFreeSlabs, pSpanSlab);
+      }
+
+      Slab* pFirstSlab = reinterpret_cast<Slab*>(pSpan);
+      pFirstSlab->m_pNextSpan = m_pSpans;
+      m_pSpans = pFirstSlab;
+
+      RegisterSpan(pSpan);
+    }
+
+    pSlab = m_pFreeSlabs;
+    UnlinkSlab(m_pFreeSlabs, pSlab);
+  }
+
+  pSlab->m_uiSizeClass = uiSizeClass;
+  pSlab->m_uiObjectSize = GetSizeClassSize(uiSizeClass);
+  pSlab->m_uiNumUsed = 0;
+  pSlab->m_uiNumUnused = (SlabSize - SLAB_HEADER_SIZE) / pSlab->m_uiObjectSize;
+  pSlab->m_pFreeList = nullptr;
+  pSlab->m_pNextUnused = reinterpret_cast<ezUInt8*>(pSlab) + SLAB_HEADER_SIZE;
+
+  return pSlab;
+}
+
+void ezMemoryPolicies::ezSlabAllocation::DeallocateSlab(Slab* pSlab)
+{
+  EZ_LOCK(m_SlabMutex);
+
+  LinkSlab(m_pFreeSlabs, pSlab);
+}
+
+// static
+void ezMemoryPolicies::ezSlabAllocation::LinkSlab(Slab*& pList, Slab* pSlab)
+{
+  pSlab->m_pPrev = nullptr;
+  pSlab->m_pNext = pList;
+  if (pList != nullptr)
+  {
+    pList->m_pPrev = pSlab;
+  }
+  pList = pSlab;
+}
+
+// static
+void ezMemoryPolicies::ezSlabAllocation::UnlinkSlab(Slab*& pList, Slab* pSlab)
+{
+  if (pSlab->m_pPrev != nullptr)
+  {
+    pSlab->m_pPrev->m_pNext = pSlab->m_pNext;
+  }
+  else
+  {
+    pList = pSlab->m_pNext;
+  }
+
+  if (pSlab->m_pNext != nullptr)
+  {
+    pSlab->m_pNext->m_pPrev = pSlab->m_pPrev;
+  }
+
+  pSlab->m_pPrev = nullptr;
+  pSlab->m_pNext = nullptr;
+}
+
+EZ_STATICLINK_FILE(Foundation, Foundation_Memory_Policies_SlabAllocation);
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <Foundation/Memory/Policies/AlignedHeapAllocation.h>
+#include <Foundation/Threading/Mutex.h>
+
+namespace ezMemoryPolicies
+{
+  /// \brief Allocation policy for many small allocations, e.g. ezMap and ezList nodes, small strings or components.
+  ///
+  /// Allocations of up to MaxSlabAllocationSize bytes are rounded up to one of a few size classes. Every size class hands out objects
+  /// from slabs of SlabSize bytes, which are carved out of larger spans that are taken from ezPageAllocator.
+  /// Every thread keeps a small cache of free objects per size class, so most allocations and deallocations don't need to take a lock.
+  /// Only refilling or flushing such a cache locks the size class.
+  ///
+  /// Larger allocations and allocations with an alignment above 16 bytes are forwarded to the aligned heap with their own alignment.
+  /// Deallocate() tells both apart through a small radix map that has one bit for every slab of every span.
+  /// Empty slabs are reused by all size classes, the spans are only given back to the system when the policy is destroyed.
+  ///
+  /// \see ezAllocator
+  class EZ_FOUNDATION_DLL ezSlabAllocation
+  {
+  public:
+    enum
+    {
+      Alignment = 16,
+      SlabSize = 4096,
+      SlabsPerSpan = 16,
+      MaxSlabAllocationSize = 1024,
+      NumSizeClasses = 20,
+    };
+
+    ezSlabAllocation(ezAllocatorBase* pParent);
+    ~ezSlabAllocation();
+
+    void* Allocate(size_t uiSize, size_t uiAlign);
+    void Deallocate(void* ptr);
+
+    EZ_ALWAYS_INLINE ezAllocatorBase* GetParent() const { return nullptr; }
+
+    /// \brief Returns the size class that an allocation of uiSize bytes is taken from. uiSize must not be larger than MaxSlabAllocationSize.
+    static ezUInt32 GetSizeClass(size_t uiSize);
+
+    /// \brief Returns the size of the objects in the given size class.
+    static ezUInt32 GetSizeClassSize(ezUInt32 uiSizeClass);
+
+  private:
+    struct Slab;
+    struct ThreadCache;
+    struct SpanMap;
+
+    struct SizeClass
+    {
+      ezMutex m_Mutex;
+      Slab* m_pPartialSlabs = nullptr; ///< Slabs that still have free objects.
+    };
+
+    ThreadCache* GetThreadCache();
+    void RefillThreadCache(ThreadCache* pCache, ezUInt32 uiSizeClass);
+    void FlushThreadCache(ThreadCache* pCache, ezUInt32 uiSizeClass, ezUInt32 uiNumObjects);
+
+    bool IsSlabMemory(const void* ptr) const;
+    void RegisterSpan(const void* pSpan);
+
+    Slab* AllocateSlab(ezUInt32 uiSizeClass);
+    void DeallocateSlab(Slab* pSlab);
+
+    static void LinkSlab(Slab*& pList, Slab* pSlab);
+    static void UnlinkSlab(Slab*& pList, Slab* pSlab);
+
+    ezUInt32 m_uiInstanceId;
+
+    SizeClass m_SizeClasses[NumSizeClasses];
+
+    ezMutex m_SlabMutex;
+    Slab* m_pFreeSlabs = nullptr;
+    Slab* m_pSpans = nullptr;
+    SpanMap* m_pSpanMap = nullptr; ///< Written under m_SlabMutex, read without a lock.
+
+    ezMutex m_ThreadCacheMutex;
+    ThreadCache* m_pThreadCaches = nullptr;
+
+    ezAlignedHeapAllocation m_HeapAllocation;
+  };
+} // namespace ezMemoryPolicies
@@ -1,12 +1,35 @@
 #pragma once
 
 #include <Foundation/Containers/DynamicArray.h>
-#include <Foundation/Containers/HashTable.h>
+#include <Foundation/Containers/HashSet.h>
+#include <Foundation/Containers/HybridArray.h>
 #include <Foundation/Memory/Allocator.h>
 #include <Foundation/Memory/Policies/StackAllocation.h>
+#include <Foundation/Threading/AtomicInteger.h>
 #include <Foundation/Threading/Lock.h>
 #include <Foundation/Threading/Mutex.h>
 
+namespace ezInternal
+{
+  /// \brief Small thread local cache that maps ezStackAllocator instances to the data of the current thread.
+  ///
+  /// Shared by all instantiations of ezStackAllocator. Instance ids are never reused, so stale entries of destroyed allocators are never returned.
+  struct EZ_FOUNDATION_DLL ezStackAllocatorThreadCache
+  {
+    static ezUInt32 AcquireInstanceId();
+    static void* GetThreadData(ezUInt32 uiInstanceId);
+    static void SetThreadData(ezUInt32 uiInstanceId, void* pThreadData);
+  };
+} // namespace ezInternal
+
+/// \brief An allocator that hands out memory like a stack and frees all of it at once in Reset().
+///
+/// Every thread allocates from its own chunk of memory without taking a lock.
+/// Only when a chunk is used up, a new one is taken from the shared pool of pages under a lock.
+/// The destructors that need to run in Reset() are recorded per thread as well. Types that are trivially destructible
+/// don't have a destructor function (see ezMemoryUtils::MakeDestructorFunction) and are not recorded at all.
+///
+/// Allocating and deallocating may happen on any number of threads at the same time, Reset() must not run concurrently with either.
 template <ezUInt32 TrackingFlags = ezMemoryTrackingFlags::Default>
 class ezStackAllocator : public ezAllocator<ezMemoryPolicies::ezStackAllocation, TrackingFlags>
 {
@@ -19,9 +42,18 @@ public:
 
   /// \brief
   ///   Resets the allocator freeing all memory.
+  ///
+  /// Runs the destructors of all objects that were not deallocated. Apart from that the cost only depends on the number of pages and threads.
   void Reset();
 
 private:
+  enum
+  {
+    MinChunkSize = 4 * 1024,
+    MaxChunkSize = 64 * 1024,
+    MaxChunkAllocationSize = MaxChunkSize / 4, ///< Larger allocations are taken directly from the shared pages.
+  };
+
   struct DestructData
   {
     EZ_DECLARE_POD_TYPE();
@@ -30,9 +62,31 @@ private:
     void* m_Ptr;
   };
 
-  ezMutex m_Mutex;
-  ezDynamicArray<DestructData> m_DestructData;
-  ezHashTable<void*, ezUInt32> m_PtrToDestructDataIndexTable;
+  struct ThreadData
+  {
+    ThreadData(ezThreadID threadId, ezAllocatorBase* pParent);
+
+    ezThreadID m_ThreadId;
+    ezUInt8* m_pNextAllocation = nullptr;
+    ezUInt8* m_pChunkEnd = nullptr;
+    ezUInt32 m_uiNextChunkSize = MinChunkSize;
+
+    ezDynamicArray<DestructData> m_DestructData;
+
+    // Deallocated pointers are only looked at in Reset(), so deallocating never needs to find the destruct data of another thread
+    ezDynamicArray<void*> m_DeallocatedPtrs;
+  };
+
+  ThreadData* GetThreadData();
+  ezUInt8* AllocateFromSharedPages(ThreadData* pThreadData, size_t uiSize);
+
+  ezUInt32 m_uiInstanceId;
+
+  ezMutex m_Mutex; // protects m_allocator and m_ThreadData
+  ezHybridArray<ThreadData*, 16> m_ThreadData;
+  ezAtomicBool m_bHasDestructData;
+
+  ezHashSet<void*> m_DeallocatedPtrSet;
 };
 
 #include <Foundation/Memory/Implementation/StackAllocator_inl.h>
@@ -14,7 +14,8 @@ class ezTempHashedString;
 /// (it's a pointer comparison).\n
 /// Copying ezHashedString objects around and assigning between them is very fast as well.\n
 /// \n
-/// Assigning from some other string type is rather slow though, as it requires thread synchronization.\n
+/// Assigning from some other string type is slower, as the string has to be hashed and looked up in the central storage.
+/// Looking up a string that already exists does not take a lock, only adding a new string locks one of several shards of the storage.\n
 /// You can also get access to the actual string data via GetString().\n
 /// \n
 /// You should use ezHashedString whenever the size of the encapsulating object is important and when changes to the string itself
@@ -26,15 +27,33 @@ class EZ_FOUNDATION_DLL ezHashedString
 public:
   struct HashedData
   {
+    ezUInt64 m_uiHash;
 #if EZ_ENABLED(EZ_HASHED_STRING_REF_COUNTING)
     ezAtomicInteger32 m_iRefCount;
 #endif
     ezString m_sString;
   };
 
-  // Do NOT use a hash-table! The map does not relocate memory when it resizes, which is a vital aspect for the hashed strings to work.
-  typedef ezMap<ezUInt64, HashedData, ezCompareHelper<ezUInt64>, ezStaticAllocatorWrapper> StringStorage;
-  typedef StringStorage::Iterator HashedType;
+  /// \brief References one entry in the central string storage. The entries never move in memory.
+  class HashedType
+  {
+  public:
+    HashedType() = default;
+    EZ_ALWAYS_INLINE explicit HashedType(HashedData* pData)
+      : m_pData(pData)
+    {
+    }
+
+    EZ_ALWAYS_INLINE bool IsValid() const { return m_pData != nullptr; }
+    EZ_ALWAYS_INLINE ezUInt64 Key() const { return m_pData->m_uiHash; }
+    EZ_ALWAYS_INLINE HashedData& Value() const { return *m_pData; }
+
+    EZ_ALWAYS_INLINE bool operator==(const HashedType& rhs) const { return m_pData == rhs.m_pData; }
+    EZ_ALWAYS_INLINE bool operator!=(const HashedType& rhs) const { return m_pData != rhs.m_pData; }
+
+  private:
+    HashedData* m_pData = nullptr;
+  };
 
 #if EZ_ENABLED(EZ_HASHED_STRING_REF_COUNTING)
   /// \brief This will remove all hashed strings from the central storage, that are not referenced anymore.
@@ -45,6 +64,9 @@ public:
   /// This function will clean up all unused strings. It should typically not be necessary to call this function at all, unless lots of
   /// strings get stored in ezHashedString that are not really used throughout the applications life time.
   ///
+  /// Other threads may create hashed strings while this runs. Since they look up existing strings without locking, the memory of the removed
+  /// strings is only freed once all lookups that started before the removal have finished.
+  ///
   /// Returns the number of unused strings that were removed.
   static ezUInt32 ClearUnusedStrings();
 #endif
@@ -1,18 +1,205 @@
 #include <FoundationPCH.h>
 
 #include <Foundation/Logging/Log.h>
+#include <Foundation/Memory/AllocatorWrapper.h>
 #include <Foundation/Strings/HashedString.h>
+#include <Foundation/Threading/AtomicInteger.h>
 #include <Foundation/Threading/Lock.h>
 #include <Foundation/Threading/Mutex.h>
+#include <Foundation/Threading/ThreadUtils.h>
 
-struct HashedStringData
+#include <atomic>
+
+// The strings are distributed over several shards by the upper bits of their hash, each shard has its own open addressing table.
+// Looking up a string that already exists only reads the table and does not lock anything. New strings are added under the mutex
+// of their shard and published with a release store, which the lookups pair with acquire loads. The entries never move,
+// only the arrays of pointers to them get replaced.
+// Replaced arrays and removed entries are kept alive until all lookups that might still see them have finished, see WaitForLookups().
+// Without reference counting strings are never removed, and the replaced arrays are simply kept. Since the arrays double in size,
+// they take less memory than the current ones.
+
+namespace
 {
-  ezMutex m_Mutex;
-  ezHashedString::StringStorage m_Storage;
-  ezHashedString::HashedType m_Empty;
-};
+  enum
+  {
+    NumShardBits = 6,
+    NumShards = 1 << NumShardBits,
+    MinTableSize = 32,
+  };
+
+  struct StringTable
+  {
+    ezUInt32 m_uiMask = 0;
+    std::atomic<ezHashedString::HashedData*>* m_pSlots = nullptr;
+    StringTable* m_pNextRetired = nullptr;
+  };
+
+  struct StringShard
+  {
+    // Serializes adding strings and replacing the table.
+    ezMutex m_Mutex;
+
+    std::atomic<StringTable*> m_pTable{nullptr};
+    ezUInt32 m_uiNumEntries = 0;
+
+    // Tables that were replaced, but may still be read by lookups.
+    StringTable* m_pRetiredTables = nullptr;
+
+    // The number of lookups in progress, separately for even and odd epochs.
+    ezAtomicInteger32 m_iNumLookups[2];
+
+    // The lookup counters are written by all threads, don't share the cache line with the next shard.
+    ezUInt8 m_Padding[64];
+  };
+
+  struct HashedStringData
+  {
+    StringShard m_Shards[NumShards];
+
+    // Selects which of the lookup counters new lookups use.
+    ezAtomicInteger32 m_iEpoch;
+
+    // Only one thread at a time may remove strings.
+    ezMutex m_ReclaimMutex;
+
+    ezHashedString::HashedType m_Empty;
+  };
+
+  HashedStringData* s_pHSData = nullptr;
+
+  EZ_ALWAYS_INLINE StringShard& GetShard(ezUInt64 uiHash)
+  {
+    return s_pHSData->m_Shards[uiHash >> (64 - NumShardBits)];
+  }
+
+  EZ_ALWAYS_INLINE ezHashedString::HashedData* ReadSlot(const StringTable* pTable, ezUInt32 uiSlot)
+  {
+    return pTable->m_pSlots[uiSlot].load(std::memory_order_acquire);
+  }
+
+  // The tables are at most half full, so there is always an empty slot that ends the search.
+  ezHashedString::HashedData* FindEntry(const StringTable* pTable, ezUInt64 uiHash)
+  {
+    for (ezUInt32 uiSlot = static_cast<ezUInt32>(uiHash) & pTable->m_uiMask;; uiSlot = (uiSlot + 1) & pTable->m_uiMask)
+    {
+      ezHashedString::HashedData* pEntry = ReadSlot(pTable, uiSlot);
+
+      if (pEntry == nullptr || pEntry->m_uiHash == uiHash)
+        return pEntry;
+    }
+  }
+
+  // Publishes the entry. Only called while the shard is locked.
+  void InsertEntry(StringTable* pTable, ezHashedString::HashedData* pEntry)
+  {
+    ezUInt32 uiSlot = static_cast<ezUInt32>(pEntry->m_uiHash) & pTable->m_uiMask;
+
+    while (pTable->m_pSlots[uiSlot].load(std::memory_order_relaxed) != nullptr)
+    {
+      uiSlot = (uiSlot + 1) & pTable->m_uiMask;
+    }
+
+    pTable->m_pSlots[uiSlot].store(pEntry, std::memory_order_release);
+  }
+
+  StringTable* CreateTable(ezUInt32 uiSize)
+  {
+    ezAllocatorBase* pAllocator = ezStaticAllocatorWrapper::GetAllocator();
+
+    StringTable* pTable = EZ_NEW(pAllocator, StringTable);
+    pTable->m_uiMask = uiSize - 1;
+    pTable->m_pSlots = EZ_NEW_RAW_BUFFER(pAllocator, std::atomic<ezHashedString::HashedData*>, uiSize);
+
+    for (ezUInt32 uiSlot = 0; uiSlot < uiSize; ++uiSlot)
+    {
+      new (&pTable->m_pSlots[uiSlot]) std::atomic<ezHashedString::HashedData*>(nullptr);
+    }
+
+    return pTable;
+  }
+
+  void DestroyTable(StringTable* pTable)
+  {
+    ezAllocatorBase* pAllocator = ezStaticAllocatorWrapper::GetAllocator();
+
+    EZ_DELETE_RAW_BUFFER(pAllocator, pTable->m_pSlots);
+    EZ_DELETE(pAllocator, pTable);
+  }
+
+  // Builds a new table of the given size from all entries of the current one, for which the filter returns true.
+  // The old table is retired, lookups may still be reading it. Only called while the shard is locked.
+  template <typename Filter>
+  void ReplaceTable(StringShard& shard, ezUInt32 uiNewSize, Filter filter)
+  {
+    StringTable* pOldTable = shard.m_pTable.load(std::memory_order_relaxed);
+    StringTable* pNewTable = CreateTable(uiNewSize);
+
+    shard.m_uiNumEntries = 0;
+
+    for (ezUInt32 uiSlot = 0; uiSlot <= pOldTable->m_uiMask; ++uiSlot)
+    {
+      ezHashedString::HashedData* pEntry = pOldTable->m_pSlots[uiSlot].load(std::memory_order_relaxed);
+
+      if (pEntry != nullptr && filter(pEntry))
+      {
+        InsertEntry(pNewTable, pEntry);
+        ++shard.m_uiNumEntries;
+      }
+    }
+
+    // the entries were inserted before, lookups that see the new table also see all of them
+    shard.m_pTable.store(pNewTable, std::memory_order_release);
+
+    pOldTable->m_pNextRetired = shard.m_pRetiredTables;
+    shard.m_pRetiredTables = pOldTable;
+  }
+
+  // Adds a reference to an entry that was found without holding the shard's lock.
+  // Fails if ClearUnusedStrings() is about to remove the entry.
+  EZ_ALWAYS_INLINE bool TryAddReference(ezHashedString::HashedData* pEntry)
+  {
+#if EZ_ENABLED(EZ_HASHED_STRING_REF_COUNTING)
+    while (true)
+    {
+      const ezInt32 iRefCount = pEntry->m_iRefCount;
+
+      if (iRefCount < 0)
+        return false;
+
+      if (pEntry->m_iRefCount.TestAndSet(iRefCount, iRefCount + 1))
+        return true;
+    }
+#else
+    EZ_IGNORE_UNUSED(pEntry);
+    return true;
+#endif
+  }
+
+#if EZ_ENABLED(EZ_HASHED_STRING_REF_COUNTING)
+  // Removed tables and entries may be freed once both lookup counters were seen at zero after the data was unpublished:
+  // a lookup that incremented a counter before that is done, one that increments it later also reads the table later and only sees
+  // the new data, since both sides use full barriers. Flipping the epoch before waiting sends new lookups to the other counter,
+  // so the waited-on counter only drains, even under a constant stream of lookups.
+  // One flip is not enough, because the epoch a lookup registers with is read before the increment. A lookup can read the epoch,
+  // stall across an earlier flip and register in the counter that is current again now, while still reading the old table.
+  // The first flip drains the counter of the previous epoch, the second one the counter that was current during the first wait.
+  void WaitForLookups()
+  {
+    for (ezUInt32 uiFlip = 0; uiFlip < 2; ++uiFlip)
+    {
+      const ezUInt32 uiPrevEpoch = static_cast<ezUInt32>(s_pHSData->m_iEpoch.PostIncrement()) & 1;
 
-static HashedStringData* s_pHSData;
+      for (StringShard& shard : s_pHSData->m_Shards)
+      {
+        while (shard.m_iNumLookups[uiPrevEpoch] > 0)
+        {
+          ezThreadUtils::YieldTimeSlice();
+        }
+      }
+    }
+  }
+#endif
+} // namespace
 
 EZ_MSVC_ANALYSIS_WARNING_PUSH
 EZ_MSVC_ANALYSIS_WARNING_DISABLE(6011) // Disable warning for null pointer dereference as InitHashedString() will ensure that s_pHSData is set
@@ -23,37 +210,71 @@ ezHashedString::HashedType ezHashedString::AddHashedString(ezStringView szString
   if (s_pHSData == nullptr)
     InitHashedString();
 
-  EZ_LOCK(s_pHSData->m_Mutex);
+  StringShard& shard = GetShard(uiHash);
+  HashedData* pEntry = nullptr;
 
-  // try to find the existing string
-  bool bExisted = false;
-  auto ret = s_pHSData->m_Storage.FindOrAdd(uiHash, &bExisted);
-
-  // if it already exists, just increase the refcount
-  if (bExisted)
   {
-#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
-    if (ret.Value().m_sString != szString)
-    {
-      // TODO: I think this should be a more serious issue
-      ezLog::Error("Hash collision encountered: Strings \"{}\" and \"{}\" both hash to {}.", ezArgSensitive(ret.Value().m_sString), ezArgSensitive(szString), uiHash);
-    }
+    // try to find the existing string without locking
+#if EZ_ENABLED(EZ_HASHED_STRING_REF_COUNTING)
+    const ezUInt32 uiEpoch = static_cast<ezUInt32>(s_pHSData->m_iEpoch) & 1;
+    shard.m_iNumLookups[uiEpoch].Increment();
 #endif
 
+    pEntry = FindEntry(shard.m_pTable.load(std::memory_order_acquire), uiHash);
+
+    if (pEntry != nullptr && !TryAddReference(pEntry))
+      pEntry = nullptr;
+
 #if EZ_ENABLED(EZ_HASHED_STRING_REF_COUNTING)
-    ret.Value().m_iRefCount.Increment();
+    shard.m_iNumLookups[uiEpoch].Decrement();
 #endif
   }
-  else
+
+  if (pEntry == nullptr)
   {
-    ezHashedString::HashedData& d = ret.Value();
+    EZ_LOCK(shard.m_Mutex);
+
+    // some other thread may have added it in the mean time, and removed strings are not in the table anymore, once we have the lock
+    pEntry = FindEntry(shard.m_pTable.load(std::memory_order_relaxed), uiHash);
+
+    if (pEntry != nullptr)
+    {
+#if EZ_ENABLED(EZ_HASHED_STRING_REF_COUNTING)
+      pEntry->m_iRefCount.Increment();
+#endif
+    }
+    else
+    {
+      // keep the table at most half full
+      const ezUInt32 uiTableSize = shard.m_pTable.load(std::memory_order_relaxed)->m_uiMask + 1;
+      if ((shard.m_uiNumEntries + 1) * 2 > uiTableSize)
+      {
+        ReplaceTable(shard, uiTableSize * 2, [](HashedData*) { return true; });
+      }
+
+      pEntry = EZ_NEW(ezStaticAllocatorWrapper::GetAllocator(), HashedData);
+      pEntry->m_uiHash = uiHash;
 #if EZ_ENABLED(EZ_HASHED_STRING_REF_COUNTING)
-    d.m_iRefCount = 1;
+      pEntry->m_iRefCount = 1;
 #endif
-    d.m_sString = szString;
+      pEntry->m_sString = szString;
+
+      InsertEntry(shard.m_pTable.load(std::memory_order_relaxed), pEntry);
+      ++shard.m_uiNumEntries;
+
+      return HashedType(pEntry);
+    }
+  }
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+  if (pEntry->m_sString != szString)
+  {
+    // TODO: I think this should be a more serious issue
+    ezLog::Error("Hash collision encountered: Strings \"{}\" and \"{}\" both hash to {}.", ezArgSensitive(pEntry->m_sString), ezArgSensitive(szString), uiHash);
   }
+#endif
 
-  return ret;
+  return HashedType(pEntry);
 }
 
 EZ_MSVC_ANALYSIS_WARNING_POP
@@ -67,6 +288,11 @@ void ezHashedString::InitHashedString()
   EZ_ALIGN_VARIABLE(static ezUInt8 HashedStringDataBuffer[sizeof(HashedStringData)], EZ_ALIGNMENT_OF(HashedStringData));
   s_pHSData = new (HashedStringDataBuffer) HashedStringData();
 
+  for (StringShard& shard : s_pHSData->m_Shards)
+  {
+    shard.m_pTable.store(CreateTable(MinTableSize), std::memory_order_release);
+  }
+
   // makes sure the empty string exists for the default constructor to use
   s_pHSData->m_Empty = AddHashedString("", ezHashingUtils::StringHash(""));
 
@@ -79,22 +305,61 @@ void ezHashedString::InitHashedString()
 #if EZ_ENABLED(EZ_HASHED_STRING_REF_COUNTING)
 ezUInt32 ezHashedString::ClearUnusedStrings()
 {
-  EZ_LOCK(s_pHSData->m_Mutex);
+  EZ_LOCK(s_pHSData->m_ReclaimMutex);
 
-  ezUInt32 uiDeleted = 0;
+  ezDynamicArray<HashedData*> removedEntries;
+  StringTable* pRetiredTables = nullptr;
 
-  for (auto it = s_pHSData->m_Storage.GetIterator(); it.IsValid();)
+  for (StringShard& shard : s_pHSData->m_Shards)
   {
-    if (it.Value().m_iRefCount == 0)
+    EZ_LOCK(shard.m_Mutex);
+
+    const ezUInt32 uiFirstRemoved = removedEntries.GetCount();
+    const StringTable* pCurrentTable = shard.m_pTable.load(std::memory_order_relaxed);
+
+    for (ezUInt32 uiSlot = 0; uiSlot <= pCurrentTable->m_uiMask; ++uiSlot)
     {
-      it = s_pHSData->m_Storage.Remove(it);
-      ++uiDeleted;
+      HashedData* pEntry = pCurrentTable->m_pSlots[uiSlot].load(std::memory_order_relaxed);
+
+      // mark the entry as removed, lookups that find it from now on won't use it anymore
+      if (pEntry != nullptr && pEntry->m_iRefCount.TestAndSet(0, -1))
+      {
+        removedEntries.PushBack(pEntry);
+      }
     }
-    else
-      ++it;
+
+    if (removedEntries.GetCount() > uiFirstRemoved)
+    {
+      ReplaceTable(shard, pCurrentTable->m_uiMask + 1, [](HashedData* pEntry) { return pEntry->m_iRefCount >= 0; });
+    }
+
+    while (shard.m_pRetiredTables != nullptr)
+    {
+      StringTable* pTable = shard.m_pRetiredTables;
+      shard.m_pRetiredTables = pTable->m_pNextRetired;
+
+      pTable->m_pNextRetired = pRetiredTables;
+      pRetiredTables = pTable;
+    }
+  }
+
+  // new lookups can't find the removed entries and tables anymore, free them once the running lookups are done
+  WaitForLookups();
+
+  for (HashedData* pEntry : removedEntries)
+  {
+    EZ_DELETE(ezStaticAllocatorWrapper::GetAllocator(), pEntry);
+  }
+
+  while (pRetiredTables != nullptr)
+  {
+    StringTable* pTable = pRetiredTables;
+    pRetiredTables = pTable->m_pNextRetired;
+
+    DestroyTable(pTable);
   }
 
-  return uiDeleted;
+  return removedEntries.GetCount();
 }
 #endif
 
@@ -8,6 +8,98 @@ EZ_FOUNDATION_INTERNAL_HEADER
 #include <sys/vmmeter.h>
 #include <unistd.h>
 
+namespace
+{
+  bool ReadSysctlUInt32(const char* szName, ezUInt32& out_uiValue)
+  {
+    ezUInt64 uiValue = 0;
+    size_t uiLength = sizeof(uiValue);
+
+    // depending on the key the kernel writes a 32 or a 64 bit integer
+    if (sysctlbyname(szName, &uiValue, &uiLength, nullptr, 0) != 0)
+      return false;
+
+    if (uiLength == sizeof(ezUInt32))
+    {
+      ezUInt32 uiValue32 = 0;
+      memcpy(&uiValue32, &uiValue, sizeof(uiValue32));
+      out_uiValue = uiValue32;
+    }
+    else if (uiLength == sizeof(ezUInt64))
+    {
+      out_uiValue = static_cast<ezUInt32>(uiValue);
+    }
+    else
+    {
+      return false;
+    }
+
+    return true;
+  }
+
+  // macOS reports how many processors share a core, a cache or a package, but not which ones.
+  // The processors of one group are assumed to be numbered consecutively, which is what the kernel does.
+  // There are no thread affinities on macOS, so only the grouping matters to the callers anyway.
+  bool ReadCPUTopologyFromSysctl(ezCPUTopology& topology)
+  {
+    ezUInt32 uiNumLogical = 0;
+    ezUInt32 uiNumPhysical = 0;
+    ezUInt32 uiNumPackages = 1;
+
+    if (!ReadSysctlUInt32("hw.logicalcpu", uiNumLogical) || !ReadSysctlUInt32("hw.physicalcpu", uiNumPhysical))
+      return false;
+
+    ReadSysctlUInt32("hw.packages", uiNumPackages);
+
+    uiNumLogical = ezMath::Min<ezUInt32>(uiNumLogical, ezCPUTopology::MaxLogicalProcessors);
+
+    if (uiNumLogical == 0 || uiNumPhysical == 0 || uiNumPackages == 0 || uiNumPhysical > uiNumLogical || uiNumPackages > uiNumPhysical)
+      return false;
+
+    // hw.cacheconfig has the number of processors that share memory, the L1, L2 and L3 cache, in that order
+    ezUInt64 cacheConfig[10] = {};
+    size_t uiCacheConfigSize = sizeof(cacheConfig);
+    ezUInt32 uiProcessorsPerCache = 0;
+
+    if (sysctlbyname("hw.cacheconfig", cacheConfig, &uiCacheConfigSize, nullptr, 0) == 0)
+    {
+      for (ezUInt32 uiLevel = 1; uiLevel < uiCacheConfigSize / sizeof(ezUInt64); ++uiLevel)
+      {
+        if (cacheConfig[uiLevel] != 0)
+        {
+          uiProcessorsPerCache = static_cast<ezUInt32>(cacheConfig[uiLevel]);
+        }
+      }
+    }
+
+    if (uiProcessorsPerCache == 0 || uiProcessorsPerCache > uiNumLogical)
+    {
+      uiProcessorsPerCache = uiNumLogical;
+    }
+
+    const ezUInt32 uiProcessorsPerCore = uiNumLogical / uiNumPhysical;
+    const ezUInt32 uiProcessorsPerPackage = uiNumLogical / uiNumPackages;
+
+    topology.m_uiNumLogicalProcessors = uiNumLogical;
+    topology.m_uiNumCores = uiNumPhysical;
+    topology.m_uiNumCacheGroups = (uiNumLogical + uiProcessorsPerCache - 1) / uiProcessorsPerCache;
+    topology.m_uiNumNumaNodes = 1;
+    topology.m_uiNumPackages = uiNumPackages;
+
+    for (ezUInt32 i = 0; i < uiNumLogical; ++i)
+    {
+      ezCPUTopology::LogicalProcessor& lp = topology.m_LogicalProcessors[i];
+      lp.m_uiOSIndex = static_cast<ezUInt16>(i);
+      lp.m_uiCore = static_cast<ezUInt16>(ezMath::Min(i / uiProcessorsPerCore, uiNumPhysical - 1));
+      lp.m_uiCacheGroup = static_cast<ezUInt16>(i / uiProcessorsPerCache);
+      lp.m_uiNumaNode = 0;
+      lp.m_uiPackage = static_cast<ezUInt16>(ezMath::Min(i / uiProcessorsPerPackage, uiNumPackages - 1));
+    }
+
+    return true;
+  }
+} // namespace
+
 // https://developer.apple.com/library/archive/qa/qa1361/_index.html
 // Returns true if the current process is being debugged (either
 // running under the debugger or has a debugger attached post facto).
@@ -46,6 +138,11 @@ void ezSystemInformation::Initialize()
   // Get system information via various APIs
   s_SystemInformation.m_uiCPUCoreCount = sysconf(_SC_NPROCESSORS_ONLN);
 
+  if (!ReadCPUTopologyFromSysctl(s_SystemInformation.m_CPUTopology))
+  {
+    InitializeFlatCPUTopology(s_SystemInformation.m_CPUTopology, s_SystemInformation.m_uiCPUCoreCount);
+  }
+
   ezUInt64 uiPageSize = sysconf(_SC_PAGE_SIZE);
 
   s_SystemInformation.m_uiMemoryPageSize = uiPageSize;
@@ -1,8 +1,201 @@
 #include <Foundation/FoundationInternal.h>
 EZ_FOUNDATION_INTERNAL_HEADER
 
+#include <stdio.h>
 #include <unistd.h>
 
+namespace
+{
+  // reads the first line of a (tiny) file in /sys
+  bool ReadSysFile(const char* szPath, char* szBuffer, ezUInt32 uiBufferSize)
+  {
+    FILE* pFile = fopen(szPath, "r");
+    if (pFile == nullptr)
+      return false;
+
+    const bool bSuccess = fgets(szBuffer, uiBufferSize, pFile) != nullptr;
+    fclose(pFile);
+    return bSuccess;
+  }
+
+  bool ReadSysFileInt(const char* szPath, int& out_iValue)
+  {
+    char szBuffer[32];
+    return ReadSysFile(szPath, szBuffer, sizeof(szBuffer)) && sscanf(szBuffer, "%d", &out_iValue) == 1;
+  }
+
+  // parses lists such as "0-3,8,10-11" and returns the number of entries written to pOut
+  ezUInt32 ParseCPUList(const char* szList, ezUInt32* pOut, ezUInt32 uiMaxEntries)
+  {
+    ezUInt32 uiCount = 0;
+
+    while (*szList != '\0')
+    {
+      char* szEnd = nullptr;
+      const ezUInt32 uiFirst = static_cast<ezUInt32>(strtoul(szList, &szEnd, 10));
+      if (szEnd == szList)
+        break;
+
+      ezUInt32 uiLast = uiFirst;
+      szList = szEnd;
+
+      if (*szList == '-')
+      {
+        ++szList;
+        uiLast = static_cast<ezUInt32>(strtoul(szList, &szEnd, 10));
+        if (szEnd == szList)
+          break;
+
+        szList = szEnd;
+      }
+
+      for (ezUInt32 i = uiFirst; i <= uiLast && uiCount < uiMaxEntries; ++i)
+      {
+        pOut[uiCount++] = i;
+      }
+
+      if (*szList == ',')
+        ++szList;
+    }
+
+    return uiCount;
+  }
+
+  bool ReadCPUTopologyFromSysFs(ezCPUTopology& topology)
+  {
+    char szBuffer[4096];
+    char szPath[256];
+    ezUInt32 osIndices[ezCPUTopology::MaxLogicalProcessors];
+    ezUInt32 ids[ezCPUTopology::MaxLogicalProcessors];
+
+    if (!ReadSysFile("/sys/devices/system/cpu/online", szBuffer, sizeof(szBuffer)))
+      return false;
+
+    const ezUInt32 uiNumProcessors = ParseCPUList(szBuffer, osIndices, ezCPUTopology::MaxLogicalProcessors);
+    if (uiNumProcessors == 0)
+      return false;
+
+    topology.m_uiNumLogicalProcessors = uiNumProcessors;
+
+    for (ezUInt32 i = 0; i < uiNumProcessors; ++i)
+    {
+      topology.m_LogicalProcessors[i].m_uiOSIndex = static_cast<ezUInt16>(osIndices[i]);
+    }
+
+    // packages
+    for (ezUInt32 i = 0; i < uiNumProcessors; ++i)
+    {
+      int iPackage = 0;
+      snprintf(szPath, sizeof(szPath), "/sys/devices/system/cpu/cpu%u/topology/physical_package_id", osIndices[i]);
+      ReadSysFileInt(szPath, iPackage);
+      ids[i] = static_cast<ezUInt32>(iPackage);
+    }
+
+    topology.m_uiNumPackages = MakeIndicesDense(ids, uiNumProcessors);
+
+    for (ezUInt32 i = 0; i < uiNumProcessors; ++i)
+    {
+      topology.m_LogicalProcessors[i].m_uiPackage = static_cast<ezUInt16>(ids[i]);
+    }
+
+    // cores, the core IDs are only unique within a package
+    for (ezUInt32 i = 0; i < uiNumProcessors; ++i)
+    {
+      int iCore = static_cast<int>(osIndices[i]);
+      snprintf(szPath, sizeof(szPath), "/sys/devices/system/cpu/cpu%u/topology/core_id", osIndices[i]);
+      ReadSysFileInt(szPath, iCore);
+      ids[i] = (static_cast<ezUInt32>(topology.m_LogicalProcessors[i].m_uiPackage) << 20) | (static_cast<ezUInt32>(iCore) & 0xFFFFF);
+    }
+
+    topology.m_uiNumCores = MakeIndicesDense(ids, uiNumProcessors);
+
+    for (ezUInt32 i = 0; i < uiNumProcessors; ++i)
+    {
+      topology.m_LogicalProcessors[i].m_uiCore = static_cast<ezUInt16>(ids[i]);
+    }
+
+    // last level caches, identified by the first processor that shares them
+    for (ezUInt32 i = 0; i < uiNumProcessors; ++i)
+    {
+      int iHighestLevel = -1;
+      ezUInt32 uiFirstSharing = topology.m_LogicalProcessors[i].m_uiPackage | 0x80000000u;
+
+      for (ezUInt32 uiCacheIndex = 0; uiCacheIndex < 16; ++uiCacheIndex)
+      {
+        int iLevel = 0;
+        snprintf(szPath, sizeof(szPath), "/sys/devices/system/cpu/cpu%u/cache/index%u/level", osIndices[i], uiCacheIndex);
+        if (!ReadSysFileInt(szPath, iLevel))
+          break;
+
+        if (iLevel <= iHighestLevel)
+          continue;
+
+        ezUInt32 uiSharing = 0;
+        snprintf(szPath, sizeof(szPath), "/sys/devices/system/cpu/cpu%u/cache/index%u/shared_cpu_list", osIndices[i], uiCacheIndex);
+        if (ReadSysFile(szPath, szBuffer, sizeof(szBuffer)) && ParseCPUList(szBuffer, &uiSharing, 1) == 1)
+        {
+          iHighestLevel = iLevel;
+          uiFirstSharing = uiSharing;
+        }
+      }
+
+      // without cache information, assume one cache per package
+      ids[i] = uiFirstSharing;
+    }
+
+    topology.m_uiNumCacheGroups = MakeIndicesDense(ids, uiNumProcessors);
+
+    for (ezUInt32 i = 0; i < uiNumProcessors; ++i)
+    {
+      topology.m_LogicalProcessors[i].m_uiCacheGroup = static_cast<ezUInt16>(ids[i]);
+    }
+
+    // NUMA nodes, processors of nodes that are not listed stay on the first one
+    for (ezUInt32 i = 0; i < uiNumProcessors; ++i)
+    {
+      ids[i] = 0;
+    }
+
+    ezUInt32 nodes[256];
+    ezUInt32 uiNumNodes = 0;
+    if (ReadSysFile("/sys/devices/system/node/online", szBuffer, sizeof(szBuffer)))
+    {
+      uiNumNodes = ParseCPUList(szBuffer, nodes, EZ_ARRAY_SIZE(nodes));
+    }
+
+    for (ezUInt32 n = 0; n < uiNumNodes; ++n)
+    {
+      snprintf(szPath, sizeof(szPath), "/sys/devices/system/node/node%u/cpulist", nodes[n]);
+      if (!ReadSysFile(szPath, szBuffer, sizeof(szBuffer)))
+        continue;
+
+      ezUInt32 nodeProcessors[ezCPUTopology::MaxLogicalProcessors];
+      const ezUInt32 uiNumNodeProcessors = ParseCPUList(szBuffer, nodeProcessors, ezCPUTopology::MaxLogicalProcessors);
+
+      for (ezUInt32 p = 0; p < uiNumNodeProcessors; ++p)
+      {
+        for (ezUInt32 i = 0; i < uiNumProcessors; ++i)
+        {
+          if (osIndices[i] == nodeProcessors[p])
+          {
+            ids[i] = nodes[n];
+            break;
+          }
+        }
+      }
+    }
+
+    topology.m_uiNumNumaNodes = MakeIndicesDense(ids, uiNumProcessors);
+
+    for (ezUInt32 i = 0; i < uiNumProcessors; ++i)
+    {
+      topology.m_LogicalProcessors[i].m_uiNumaNode = static_cast<ezUInt16>(ids[i]);
+    }
+
+    return true;
+  }
+} // namespace
+
 bool ezSystemInformation::IsDebuggerAttached()
 {
   // TODO: No simple way to test without massive overhead.
@@ -17,6 +210,11 @@ void ezSystemInformation::Initialize()
   // Get system information via various APIs
   s_SystemInformation.m_uiCPUCoreCount = sysconf(_SC_NPROCESSORS_ONLN);
 
+  if (!ReadCPUTopologyFromSysFs(s_SystemInformation.m_CPUTopology))
+  {
+    InitializeFlatCPUTopology(s_SystemInformation.m_CPUTopology, s_SystemInformation.m_uiCPUCoreCount);
+  }
+
   ezUInt64 uiPageCount = sysconf(_SC_PHYS_PAGES);
   ezUInt64 uiPageSize = sysconf(_SC_PAGE_SIZE);
 
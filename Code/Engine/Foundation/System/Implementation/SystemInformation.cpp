@@ -5,6 +5,58 @@
 // Storage for the current configuration
 ezSystemInformation ezSystemInformation::s_SystemInformation;
 
+namespace
+{
+  // Fills out a topology where every logical processor is a separate core. Used where nothing more is known.
+  void InitializeFlatCPUTopology(ezCPUTopology& topology, ezUInt32 uiNumLogicalProcessors)
+  {
+    topology.m_uiNumLogicalProcessors = ezMath::Clamp<ezUInt32>(uiNumLogicalProcessors, 1, ezCPUTopology::MaxLogicalProcessors);
+    topology.m_uiNumCores = topology.m_uiNumLogicalProcessors;
+    topology.m_uiNumCacheGroups = 1;
+    topology.m_uiNumNumaNodes = 1;
+    topology.m_uiNumPackages = 1;
+
+    for (ezUInt32 i = 0; i < topology.m_uiNumLogicalProcessors; ++i)
+    {
+      ezCPUTopology::LogicalProcessor& lp = topology.m_LogicalProcessors[i];
+      lp.m_uiOSIndex = static_cast<ezUInt16>(i);
+      lp.m_uiCore = static_cast<ezUInt16>(i);
+      lp.m_uiCacheGroup = 0;
+      lp.m_uiNumaNode = 0;
+      lp.m_uiPackage = 0;
+    }
+  }
+
+  // Replaces arbitrary IDs by indices that count up from zero, in the order of their first occurrence. Returns the number of different IDs.
+  ezUInt32 MakeIndicesDense(ezUInt32* pIDs, ezUInt32 uiCount)
+  {
+    EZ_ASSERT_DEBUG(uiCount <= ezCPUTopology::MaxLogicalProcessors, "Too many IDs");
+
+    // only called once with a few hundred entries at most, no need for anything fancy
+    ezUInt32 uiNumDifferent = 0;
+    ezUInt32 uniqueIDs[ezCPUTopology::MaxLogicalProcessors];
+
+    for (ezUInt32 i = 0; i < uiCount; ++i)
+    {
+      ezUInt32 uiIndex = 0;
+      while (uiIndex < uiNumDifferent && uniqueIDs[uiIndex] != pIDs[i])
+      {
+        ++uiIndex;
+      }
+
+      if (uiIndex == uiNumDifferent)
+      {
+        uniqueIDs[uiNumDifferent] = pIDs[i];
+        ++uiNumDifferent;
+      }
+
+      pIDs[i] = uiIndex;
+    }
+
+    return uiNumDifferent;
+  }
+} // namespace
+
 // Include inline file
 #if EZ_ENABLED(EZ_PLATFORM_WINDOWS)
 #  include <Foundation/System/Implementation/Win/SystemInformation_win.h>
@@ -30,6 +30,97 @@ bool Is64BitWindows()
 #endif
 }
 
+#if EZ_DISABLED(EZ_PLATFORM_WINDOWS_UWP)
+// Reads the topology of the processors in the current processor group, which are at most 64
+bool ReadCPUTopology(ezCPUTopology& topology)
+{
+  SYSTEM_LOGICAL_PROCESSOR_INFORMATION infos[256];
+  DWORD uiBufferSize = sizeof(infos);
+
+  if (!GetLogicalProcessorInformation(infos, &uiBufferSize))
+    return false;
+
+  const ezUInt32 uiNumInfos = uiBufferSize / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION);
+
+  ezUInt64 uiAllProcessors = 0;
+  for (ezUInt32 i = 0; i < uiNumInfos; ++i)
+  {
+    if (infos[i].Relationship == RelationProcessorCore)
+      uiAllProcessors |= infos[i].ProcessorMask;
+  }
+
+  if (uiAllProcessors == 0)
+    return false;
+
+  ezUInt32 cores[64];
+  ezUInt32 caches[64];
+  ezUInt32 nodes[64];
+  ezUInt32 packages[64];
+  ezUInt32 uiNumProcessors = 0;
+
+  for (ezUInt32 uiOSIndex = 0; uiOSIndex < 64; ++uiOSIndex)
+  {
+    const ezUInt64 uiBit = 1ull << uiOSIndex;
+    if ((uiAllProcessors & uiBit) == 0)
+      continue;
+
+    cores[uiNumProcessors] = 0;
+    caches[uiNumProcessors] = 0;
+    nodes[uiNumProcessors] = 0;
+    packages[uiNumProcessors] = 0;
+    BYTE uiCacheLevel = 0;
+
+    // use the index of the info entry as the ID of the core, cache, etc.
+    for (ezUInt32 i = 0; i < uiNumInfos; ++i)
+    {
+      if ((infos[i].ProcessorMask & uiBit) == 0)
+        continue;
+
+      switch (infos[i].Relationship)
+      {
+        case RelationProcessorCore:
+          cores[uiNumProcessors] = i;
+          break;
+        case RelationCache:
+          if (infos[i].Cache.Level > uiCacheLevel)
+          {
+            uiCacheLevel = infos[i].Cache.Level;
+            caches[uiNumProcessors] = i;
+          }
+          break;
+        case RelationNumaNode:
+          nodes[uiNumProcessors] = i;
+          break;
+        case RelationProcessorPackage:
+          packages[uiNumProcessors] = i;
+          break;
+        default:
+          break;
+      }
+    }
+
+    topology.m_LogicalProcessors[uiNumProcessors].m_uiOSIndex = static_cast<ezUInt16>(uiOSIndex);
+    ++uiNumProcessors;
+  }
+
+  topology.m_uiNumLogicalProcessors = uiNumProcessors;
+  topology.m_uiNumCores = MakeIndicesDense(cores, uiNumProcessors);
+  topology.m_uiNumCacheGroups = MakeIndicesDense(caches, uiNumProcessors);
+  topology.m_uiNumNumaNodes = MakeIndicesDense(nodes, uiNumProcessors);
+  topology.m_uiNumPackages = MakeIndicesDense(packages, uiNumProcessors);
+
+  for (ezUInt32 i = 0; i < uiNumProcessors; ++i)
+  {
+    topology.m_LogicalProcessors[i].m_uiCore = static_cast<ezUInt16>(cores[i]);
+    topology.m_LogicalProcessors[i].m_uiCacheGroup = static_cast<ezUInt16>(caches[i]);
+    topology.m_LogicalProcessors[i].m_uiNumaNode = static_cast<ezUInt16>(nodes[i]);
+    topology.m_LogicalProcessors[i].m_uiPackage = static_cast<ezUInt16>(packages[i]);
+  }
+
+  return true;
+}
+#endif
+
 /// \endcond
 
 bool ezSystemInformation::IsDebuggerAttached()
@@ -50,6 +141,13 @@ void ezSystemInformation::Initialize()
   GetNativeSystemInfo(&sysInfo);
 
   s_SystemInformation.m_uiCPUCoreCount = sysInfo.dwNumberOfProcessors;
+
+#if EZ_DISABLED(EZ_PLATFORM_WINDOWS_UWP)
+  if (!ReadCPUTopology(s_SystemInformation.m_CPUTopology))
+#endif
+  {
+    InitializeFlatCPUTopology(s_SystemInformation.m_CPUTopology, s_SystemInformation.m_uiCPUCoreCount);
+  }
   s_SystemInformation.m_uiMemoryPageSize = sysInfo.dwPageSize;
 
   MEMORYSTATUSEX memStatus;
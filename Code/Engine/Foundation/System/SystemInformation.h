@@ -1,5 +1,35 @@
 #pragma once
 
+/// \brief Describes how the logical processors (hardware threads) of the system share cores, caches and memory.
+///
+/// All indices count up from zero. Where the platform does not provide this information, every logical processor
+/// is reported as a separate core, and all of them share one cache group, NUMA node and package.
+struct ezCPUTopology
+{
+  enum
+  {
+    MaxLogicalProcessors = 512
+  };
+
+  struct LogicalProcessor
+  {
+    ezUInt16 m_uiOSIndex = 0;    ///< The number that the OS uses for this processor, e.g. for thread affinities.
+    ezUInt16 m_uiCore = 0;       ///< The physical core. SMT siblings have the same core index.
+    ezUInt16 m_uiCacheGroup = 0; ///< The last level cache that this processor uses.
+    ezUInt16 m_uiNumaNode = 0;   ///< The NUMA node, i.e. the memory controller that is closest to this processor.
+    ezUInt16 m_uiPackage = 0;    ///< The physical package (socket).
+  };
+
+  ezUInt32 m_uiNumLogicalProcessors = 0;
+  ezUInt32 m_uiNumCores = 0;
+  ezUInt32 m_uiNumCacheGroups = 0;
+  ezUInt32 m_uiNumNumaNodes = 0;
+  ezUInt32 m_uiNumPackages = 0;
+
+  /// \brief All online logical processors, sorted by their OS index.
+  LogicalProcessor m_LogicalProcessors[MaxLogicalProcessors];
+};
+
 /// \brief The system configuration class encapsulates information about the system the application is running on.
 ///
 /// Retrieve the system configuration by using ezSystemInformation::Get(). If you use the system configuration in startup code
@@ -19,6 +49,11 @@ public:
   /// \brief Returns the CPU core count of the system.
   inline ezUInt32 GetCPUCoreCount() const { return m_uiCPUCoreCount; }
 
+  /// \brief Returns how the logical processors share cores, caches and NUMA nodes.
+  ///
+  /// On Linux this is read from /sys/devices/system/cpu and /sys/devices/system/node.
+  inline const ezCPUTopology& GetCPUTopology() const { return m_CPUTopology; }
+
   /// \brief Returns the total utilization of the CPU core in percent
   float GetCPUUtilization() const;
 
@@ -53,6 +88,7 @@ private:
   char m_sHostName[256];
   bool m_b64BitOS;
   bool m_bIsInitialized;
+  ezCPUTopology m_CPUTopology;
 
 
   static void Initialize();
@@ -1,5 +1,9 @@
 #include <FoundationPCH.h>
 
+#include <Foundation/Algorithm/HashingUtils.h>
+#include <Foundation/Profiling/Profiling.h>
+#include <Foundation/Strings/StringBuilder.h>
+#include <Foundation/Threading/Implementation/TaskSystemState.h>
 #include <Foundation/Threading/TaskSystem.h>
 
 /// \brief This is a helper class that splits up task items via index ranges.
@@ -36,6 +40,40 @@ private:
   ezParallelForIndexedFunction m_TaskCallback;
 };
 
+/// \brief Like IndexedTask, but measures how long the invocations take, for ParallelForIndexedAdaptive().
+class AdaptiveIndexedTask final : public ezTask
+{
+public:
+  AdaptiveIndexedTask(ezUInt32 uiStartIndex, ezUInt32 uiNumItems, const ezParallelForIndexedFunction& taskCallback, ezUInt32 uiItemsPerInvocation)
+    : m_uiStartIndex(uiStartIndex)
+    , m_uiNumItems(uiNumItems)
+    , m_uiItemsPerInvocation(uiItemsPerInvocation)
+    , m_TaskCallback(taskCallback)
+  {
+  }
+
+  void Execute() override { ExecuteWithMultiplicity(0); }
+
+  void ExecuteWithMultiplicity(ezUInt32 uiInvocation) const override
+  {
+    const ezUInt32 uiSliceStartIndex = m_uiStartIndex + uiInvocation * m_uiItemsPerInvocation;
+    const ezUInt32 uiSliceEndIndex = ezMath::Min(uiSliceStartIndex + m_uiItemsPerInvocation, m_uiStartIndex + m_uiNumItems);
+
+    const ezTime tStart = ezTime::Now();
+    m_TaskCallback(uiSliceStartIndex, uiSliceEndIndex);
+    m_iDurationNanoseconds.Add(static_cast<ezInt64>((ezTime::Now() - tStart).GetNanoseconds()));
+  }
+
+  ezTime GetDuration() const { return ezTime::Nanoseconds(static_cast<double>(m_iDurationNanoseconds)); }
+
+private:
+  ezUInt32 m_uiStartIndex;
+  ezUInt32 m_uiNumItems;
+  ezUInt32 m_uiItemsPerInvocation;
+  const ezParallelForIndexedFunction& m_TaskCallback;
+  mutable ezAtomicInteger64 m_iDurationNanoseconds;
+};
+
 ezUInt32 ezParallelForParams::DetermineMultiplicity(ezUInt32 uiNumTaskItems) const
 {
   // If we have not exceeded the threading threshold we will indicate to use serial execution.
@@ -85,6 +123,12 @@ ezUInt32 ezParallelForParams::DetermineItemsPerInvocation(ezUInt32 uiNumTaskItem
 void ezTaskSystem::ParallelForIndexed(
   ezUInt32 uiStartIndex, ezUInt32 uiNumItems, ezParallelForIndexedFunction taskCallback, const char* taskName, const ezParallelForParams& params)
 {
+  if (params.bAdaptiveGranularity)
+  {
+    ParallelForIndexedAdaptive(uiStartIndex, uiNumItems, std::move(taskCallback), taskName ? taskName : "Generic Indexed Task", params);
+    return;
+  }
+
   const ezUInt32 uiMultiplicity = params.DetermineMultiplicity(uiNumItems);
   const ezUInt32 uiItemsPerInvocation = params.DetermineItemsPerInvocation(uiNumItems, uiMultiplicity);
 
@@ -110,5 +154,110 @@ void ezTaskSystem::ParallelForIndexed(
   }
 }
 
+void ezTaskSystem::ParallelForIndexedAdaptive(
+  ezUInt32 uiStartIndex, ezUInt32 uiNumItems, ezParallelForIndexedFunction taskCallback, const char* taskName, const ezParallelForParams& params)
+{
+  if (uiNumItems == 0)
+    return;
+
+  const ezTime tStart = ezTime::Now();
+  const ezUInt32 uiKey = ezHashingUtils::StringHashTo32(ezHashingUtils::StringHash(taskName));
+  const ezUInt32 uiMinItemsPerTask = ezMath::Max(params.uiBinSize, 1u);
+  const double fTargetNanoseconds = ezMath::Max(params.targetTaskDuration.GetNanoseconds(), 1.0);
+
+  double fItemCost = 0.0;
+  bool bCostIsKnown = false;
+
+  {
+    EZ_LOCK(s_State->m_ParallelForCostMutex);
+    bCostIsKnown = s_State->m_ParallelForItemCosts.TryGetValue(uiKey, fItemCost);
+  }
+
+  ezUInt32 uiNextItem = uiStartIndex;
+  ezUInt32 uiRemainingItems = uiNumItems;
+  ezTime measuredDuration;
+
+  if (!bCostIsKnown)
+  {
+    // nothing is known about these items yet, so process the first ones on this thread and measure them
+    // the chunks double in size, until they are long enough to be measured reliably, but at most an eighth of the items is processed like this
+    const ezUInt32 uiMaxProbedItems = ezMath::Max(uiNumItems / 8, uiMinItemsPerTask);
+    const ezTime minProbeDuration = ezTime::Nanoseconds(fTargetNanoseconds / 4);
+
+    EZ_PROFILE_SCOPE(taskName);
+
+    for (ezUInt32 uiProbeItems = uiMinItemsPerTask; uiRemainingItems > 0; uiProbeItems *= 2)
+    {
+      const ezUInt32 uiCount = ezMath::Min(uiProbeItems, uiRemainingItems);
+
+      const ezTime tProbeStart = ezTime::Now();
+      taskCallback(uiNextItem, uiNextItem + uiCount);
+      measuredDuration += ezTime::Now() - tProbeStart;
+
+      uiNextItem += uiCount;
+      uiRemainingItems -= uiCount;
+
+      if (measuredDuration >= minProbeDuration || uiNumItems - uiRemainingItems >= uiMaxProbedItems)
+        break;
+    }
+
+    fItemCost = measuredDuration.GetNanoseconds() / (uiNumItems - uiRemainingItems);
+  }
+
+  ezUInt32 uiItemsPerTask = uiNumItems;
+
+  if (uiRemainingItems > 0)
+  {
+    const double fItemsForTarget = (fItemCost > 0.0) ? fTargetNanoseconds / fItemCost : static_cast<double>(uiRemainingItems);
+    uiItemsPerTask = static_cast<ezUInt32>(ezMath::Clamp(fItemsForTarget, 1.0, static_cast<double>(uiRemainingItems)));
+
+    // cheap items are still spread over all workers, as long as every task gets at least uiBinSize items
+    const ezUInt32 uiNumWorkers = ezMath::Max(GetWorkerThreadCount(ezWorkerThreadType::ShortTasks), 1u);
+    uiItemsPerTask = ezMath::Min(uiItemsPerTask, (uiRemainingItems + uiNumWorkers - 1) / uiNumWorkers);
+    uiItemsPerTask = ezMath::Max(uiItemsPerTask, uiMinItemsPerTask);
+
+    const ezUInt32 uiMultiplicity = (uiRemainingItems + uiItemsPerTask - 1) / uiItemsPerTask;
+
+    if (uiMultiplicity <= 1)
+    {
+      EZ_PROFILE_SCOPE(taskName);
+
+      const ezTime tTaskStart = ezTime::Now();
+      taskCallback(uiNextItem, uiNextItem + uiRemainingItems);
+      measuredDuration += ezTime::Now() - tTaskStart;
+    }
+    else
+    {
+      ezAllocatorBase* pAllocator = (params.pTaskAllocator != nullptr) ? params.pTaskAllocator : ezFoundation::GetDefaultAllocator();
+
+      ezSharedPtr<AdaptiveIndexedTask> pTask = EZ_NEW(pAllocator, AdaptiveIndexedTask, uiNextItem, uiRemainingItems, taskCallback, uiItemsPerTask);
+      pTask->ConfigureTask(taskName, params.nestingMode);
+      pTask->SetMultiplicity(uiMultiplicity);
+
+      ezTaskGroupID taskGroupId = ezTaskSystem::StartSingleTask(pTask, ezTaskPriority::EarlyThisFrame);
+      ezTaskSystem::WaitForGroup(taskGroupId);
+
+      measuredDuration += pTask->GetDuration();
+    }
+  }
+
+  {
+    // blend in the new measurement slowly, a single call may have been disturbed by other threads
+    const double fMeasuredItemCost = measuredDuration.GetNanoseconds() / uiNumItems;
+
+    EZ_LOCK(s_State->m_ParallelForCostMutex);
+    double& fStoredCost = s_State->m_ParallelForItemCosts[uiKey];
+    fStoredCost = bCostIsKnown ? ezMath::Lerp(fStoredCost, fMeasuredItemCost, 0.25) : fMeasuredItemCost;
+  }
+
+#if EZ_ENABLED(EZ_USE_PROFILING)
+  {
+    // the name is copied by the profiling system, the number goes first, because long names get truncated
+    ezStringBuilder sScopeName;
+    sScopeName.Format("{} per task: {}", uiItemsPerTask, taskName);
+    ezProfilingSystem::AddCPUScope(sScopeName, EZ_SOURCE_FUNCTION, tStart, ezTime::Now());
+  }
+#endif
+}
 
 EZ_STATICLINK_FILE(Foundation, Foundation_Threading_Implementation_ParallelFor);
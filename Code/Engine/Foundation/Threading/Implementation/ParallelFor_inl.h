@@ -45,6 +45,18 @@ template <typename ElemType>
 void ezTaskSystem::ParallelForInternal(
   ezArrayPtr<ElemType> taskItems, ezParallelForFunction<ElemType> taskCallback, const char* taskName, const ezParallelForParams& config)
 {
+  if (config.bAdaptiveGranularity)
+  {
+    // the adaptive mode only needs to be implemented once, for index ranges
+    auto indexedCallback = [taskItems, &taskCallback](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+      taskCallback(uiStartIndex, taskItems.GetSubArray(uiStartIndex, uiEndIndex - uiStartIndex));
+    };
+
+    ParallelForIndexedAdaptive(0, taskItems.GetCount(), ezParallelForIndexedFunction(std::move(indexedCallback), ezFrameAllocator::GetCurrentAllocator()),
+      taskName ? taskName : "Generic ArrayPtr Task", config);
+    return;
+  }
+
   const ezUInt32 uiMultiplicity = config.DetermineMultiplicity(taskItems.GetCount());
   const ezUInt32 uiItemsPerInvocation = config.DetermineItemsPerInvocation(taskItems.GetCount(), uiMultiplicity);
 
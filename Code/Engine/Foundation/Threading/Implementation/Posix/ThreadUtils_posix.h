@@ -8,6 +8,7 @@
 // Posix implementation of thread helper functions
 
 #include <pthread.h>
+#include <sched.h>
 
 static pthread_t g_MainThread = (pthread_t)0;
 
@@ -48,3 +49,36 @@ bool ezThreadUtils::IsMainThread()
 {
   return pthread_self() == g_MainThread;
 }
+
+ezResult ezThreadUtils::SetCurrentThreadAffinity(ezArrayPtr<const ezUInt32> logicalProcessors)
+{
+#if EZ_ENABLED(EZ_PLATFORM_LINUX) || EZ_ENABLED(EZ_PLATFORM_ANDROID)
+  cpu_set_t set;
+  CPU_ZERO(&set);
+
+  if (logicalProcessors.IsEmpty())
+  {
+    // the kernel ignores processors that do not exist
+    for (ezUInt32 i = 0; i < CPU_SETSIZE; ++i)
+    {
+      CPU_SET(i, &set);
+    }
+  }
+  else
+  {
+    for (ezUInt32 uiProcessor : logicalProcessors)
+    {
+      if (uiProcessor < CPU_SETSIZE)
+      {
+        CPU_SET(uiProcessor, &set);
+      }
+    }
+  }
+
+  // pid 0 means the calling thread
+  return sched_setaffinity(0, sizeof(set), &set) == 0 ? EZ_SUCCESS : EZ_FAILURE;
+#else
+  // OSX only supports affinity hints through thread_policy_set, which are not binding
+  return EZ_FAILURE;
+#endif
+}
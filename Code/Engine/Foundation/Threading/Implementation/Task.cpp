@@ -12,6 +12,8 @@ void ezTask::Reset()
   m_bCancelExecution = false;
   m_bTaskIsScheduled = false;
   m_bUsesMultiplicity = m_uiMultiplicity > 0;
+  m_ResumeAfterGroup.Invalidate();
+  m_uiResumeCount = 0;
 }
 
 void ezTask::ConfigureTask(const char* szTaskName, ezTaskNesting nestingMode, ezOnTaskFinishedCallback Callback /*= ezOnTaskFinishedCallback()*/)
@@ -56,6 +58,10 @@ void ezTask::Run(ezUInt32 uiInvocation)
     }
   }
 
+  // a suspended task is not done yet, the task system runs it again once the group that it waits for has finished
+  if (m_ResumeAfterGroup.IsValid())
+    return;
+
   m_iRemainingRuns.Decrement();
 }
 
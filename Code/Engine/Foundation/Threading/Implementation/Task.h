@@ -78,6 +78,7 @@ private:
   // The task system and its worker threads implement most of the functionality of the task handling.
   // Therefore they are allowed to modify all this internal state.
   friend class ezTaskSystem;
+  friend class ezSuspendableTask;
 
   void Reset();
 
@@ -107,5 +108,11 @@ private:
   /// \brief The parent group to which this task belongs.
   ezTaskGroupID m_BelongsToGroup;
 
+  /// \brief Set by ezSuspendableTask::SuspendUntil(). Execute() is called again once this group has finished.
+  ezTaskGroupID m_ResumeAfterGroup;
+
+  /// \brief How often Execute() has been called again after the task was suspended. See ezSuspendableTask.
+  ezUInt32 m_uiResumeCount = 0;
+
   ezString m_sTaskName;
 };
@@ -4,6 +4,8 @@
 #include <Foundation/Threading/Implementation/TaskGroup.h>
 #include <Foundation/Threading/Lock.h>
 
+ezTaskGroup::DependentLink ezTaskGroup::s_ClosedDependents;
+
 ezTaskGroup::ezTaskGroup() = default;
 ezTaskGroup::~ezTaskGroup() = default;
 
@@ -12,12 +14,22 @@ void ezTaskGroup::WaitForFinish(ezTaskGroupID group) const
   if (m_uiGroupCounter != group.m_uiGroupCounter)
     return;
 
-  EZ_LOCK(m_CondVarGroupFinished);
+  // announce the waiting thread before looking at the counter again,
+  // ezTaskSystem::TaskHasFinished() only signals the condition variable, when it sees a waiting thread after changing the counter
+  // both sides store first and load second, the atomic increment here and the atomic add there are full barriers,
+  // so at least one of the two threads is guaranteed to see the store of the other one
+  m_iNumWaitingThreads.Increment();
 
-  while (m_uiGroupCounter == group.m_uiGroupCounter)
   {
-    m_CondVarGroupFinished.UnlockWaitForSignalAndLock();
+    EZ_LOCK(m_CondVarGroupFinished);
+
+    while (m_uiGroupCounter == group.m_uiGroupCounter)
+    {
+      m_CondVarGroupFinished.UnlockWaitForSignalAndLock();
+    }
   }
+
+  m_iNumWaitingThreads.Decrement();
 }
 
 void ezTaskGroup::Reuse(ezTaskPriority::Enum priority, ezOnTaskGroupFinishedCallback callback)
@@ -27,11 +39,41 @@ void ezTaskGroup::Reuse(ezTaskPriority::Enum priority, ezOnTaskGroupFinishedCall
   m_uiGroupCounter += 2; // even if it wraps around, it will never be zero, thus zero stays an invalid group counter
   m_Tasks.Clear();
   m_DependsOnGroups.Clear();
-  m_OthersDependingOnMe.Clear();
+  m_DependentLinks.Clear();
+  m_pDependents = nullptr;
   m_Priority = priority;
   m_OnFinishedCallback = callback;
 }
 
+bool ezTaskGroup::TryAddDependent(DependentLink* pLink)
+{
+  while (true)
+  {
+    DependentLink* pHead = m_pDependents;
+
+    if (pHead == &s_ClosedDependents)
+      return false;
+
+    pLink->m_pNext = pHead;
+
+    if (ezAtomicUtils::TestAndSet(reinterpret_cast<void**>(&m_pDependents), pHead, pLink))
+      return true;
+  }
+}
+
+ezTaskGroup::DependentLink* ezTaskGroup::CloseDependents()
+{
+  while (true)
+  {
+    DependentLink* pHead = m_pDependents;
+
+    EZ_ASSERT_DEBUG(pHead != &s_ClosedDependents, "Task group has already finished.");
+
+    if (ezAtomicUtils::TestAndSet(reinterpret_cast<void**>(&m_pDependents), pHead, &s_ClosedDependents))
+      return pHead;
+  }
+}
+
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEBUG)
 void ezTaskGroup::DebugCheckTaskGroup(ezTaskGroupID groupID, ezMutex& mutex)
 {
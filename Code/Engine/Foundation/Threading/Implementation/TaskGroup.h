@@ -23,19 +23,42 @@ private:
   EZ_ALWAYS_INLINE static void DebugCheckTaskGroup(ezTaskGroupID groupID, ezMutex& mutex) {}
 #endif
 
+  /// \brief One entry in the list of groups that wait for another group to finish.
+  ///
+  /// The links are owned by the waiting group (one per entry in m_DependsOnGroups) and get inserted into the
+  /// m_pDependents list of the group that they depend on, so registering a dependency needs no allocation.
+  struct DependentLink
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezTaskGroup* m_pDependent;
+    DependentLink* m_pNext;
+  };
+
   /// \brief Puts the calling thread to sleep until this group is fully finished.
   void WaitForFinish(ezTaskGroupID group) const;
   void Reuse(ezTaskPriority::Enum priority, ezOnTaskGroupFinishedCallback callback);
 
+  /// \brief Inserts the link into the list of dependent groups. Returns false, if this group has already finished and will not notify anyone anymore.
+  bool TryAddDependent(DependentLink* pLink);
+
+  /// \brief Marks the list of dependent groups as closed, such that TryAddDependent() fails from now on, and returns all previously added links.
+  DependentLink* CloseDependents();
+
+  /// \brief Marker for m_pDependents, once the group has finished.
+  static DependentLink s_ClosedDependents;
+
   bool m_bInUse = true;
   bool m_bStartedByUser = false;
   ezUInt16 m_uiTaskGroupIndex = 0xFFFF; // only there as a debugging aid
   ezUInt32 m_uiGroupCounter = 1;
   ezHybridArray<ezSharedPtr<ezTask>, 16> m_Tasks;
   ezHybridArray<ezTaskGroupID, 4> m_DependsOnGroups;
-  ezHybridArray<ezTaskGroupID, 8> m_OthersDependingOnMe;
+  ezHybridArray<DependentLink, 4> m_DependentLinks; ///< One link for every entry in m_DependsOnGroups.
+  DependentLink* m_pDependents = nullptr;            ///< Lock-free list of the groups that depend on this one.
   ezAtomicInteger32 m_iNumActiveDependencies;
   ezAtomicInteger32 m_iNumRemainingTasks;
+  mutable ezAtomicInteger32 m_iNumWaitingThreads; ///< Number of threads in WaitForFinish(), the condition variable only needs to be signaled, if this is not zero.
   ezOnTaskGroupFinishedCallback m_OnFinishedCallback;
   ezTaskPriority::Enum m_Priority = ezTaskPriority::ThisFrame;
   mutable ezConditionVariable m_CondVarGroupFinished;
@@ -5,6 +5,7 @@
 #include <Foundation/Threading/Implementation/TaskSystemState.h>
 #include <Foundation/Threading/Implementation/TaskWorkerThread.h>
 #include <Foundation/Threading/TaskSystem.h>
+#include <Foundation/Threading/ThreadUtils.h>
 
 ezMutex ezTaskSystem::s_TaskSystemMutex;
 ezUniquePtr<ezTaskSystemState> ezTaskSystem::s_State;
@@ -38,6 +39,7 @@ void ezTaskSystem::Startup()
 
   tl_TaskWorkerInfo.m_WorkerType = ezWorkerThreadType::MainThread;
   tl_TaskWorkerInfo.m_iWorkerIndex = 0;
+  tl_TaskWorkerInfo.m_pLocalQueues = &s_ThreadState->m_MainThreadQueues;
 
   // initialize with the default number of worker threads
   SetWorkerThreadCount();
@@ -47,6 +49,13 @@ void ezTaskSystem::Shutdown()
 {
   StopWorkerThreads();
 
+  if (s_ThreadState->m_bReserveMainThreadCore)
+  {
+    // give the main thread back to the OS scheduler
+    ezThreadUtils::SetCurrentThreadAffinity({}).IgnoreResult();
+    tl_TaskWorkerInfo.m_uiCacheGroup = ezTaskWorkerInfo::NoCacheGroup;
+  }
+
   s_State.Clear();
   s_ThreadState.Clear();
 }
@@ -12,6 +12,7 @@ class ezTaskGroup;
 class ezTaskWorkerThread;
 class ezTaskSystemState;
 class ezTaskSystemThreadState;
+struct ezTaskLocalQueues;
 class ezDGMLGraph;
 class ezAllocatorBase;
 
@@ -82,6 +83,38 @@ struct ezOnTaskRunning
   };
 };
 
+/// \brief Selects how the ezTaskSystem hands out tasks of the 'this frame' priorities to the worker threads.
+///
+/// See ezTaskSystem::SetSchedulingMode().
+struct ezTaskSchedulingMode
+{
+  enum Enum : ezUInt8
+  {
+    GlobalQueues, ///< All tasks are put into one queue per priority, which is protected by a single mutex.
+    WorkStealing, ///< 'This frame' tasks started from the main thread or a short task worker are put into a lock-free queue owned by that thread.
+                  ///< Idle workers steal from the queues of other threads. All other priorities still use the global queues.
+
+    Default = GlobalQueues
+  };
+};
+
+/// \brief Selects how the ezTaskSystem pins its short task worker threads to logical processors.
+///
+/// See ezTaskSystem::SetWorkerThreadAffinity() and ezCPUTopology.
+struct ezWorkerThreadAffinity
+{
+  enum Enum : ezUInt8
+  {
+    None,    ///< The OS decides on which processors the worker threads run.
+    Compact, ///< Every worker is pinned to one logical processor. Consecutive workers use SMT siblings and processors that share
+             ///< a last level cache first, to keep the data of related tasks in as few caches as possible.
+    Scatter, ///< Every worker is pinned to one logical processor. Workers are spread over packages, caches and cores first,
+             ///< SMT siblings are only used once every core has a worker.
+
+    Default = None
+  };
+};
+
 /// \internal Enum that lists the different task worker thread types.
 struct ezWorkerThreadType
 {
@@ -182,6 +215,15 @@ struct EZ_FOUNDATION_DLL ezParallelForParams
 
   ezTaskNesting nestingMode = ezTaskNesting::Never;
 
+  /// If enabled, uiBinSize is only the lower limit of items per task and uiMaxTasksPerThread is ignored.
+  /// Instead the number of items per task is chosen such that each task takes about targetTaskDuration.
+  /// The cost of an item is measured while the items are processed and remembered per task name across calls,
+  /// so every call site should use its own task name. The first call for a task name runs a few chunks on the calling thread to measure them.
+  bool bAdaptiveGranularity = false;
+
+  /// How long each task should take, if bAdaptiveGranularity is enabled.
+  ezTime targetTaskDuration = ezTime::Microseconds(100);
+
   /// The allocator used to for the tasks that the parallel-for uses internally. If null, will use the default allocator.
   ezAllocatorBase* pTaskAllocator = nullptr;
 
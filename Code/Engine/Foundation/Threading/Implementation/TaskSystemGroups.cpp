@@ -80,37 +80,46 @@ void ezTaskSystem::StartTaskGroup(ezTaskGroupID groupID)
 
   ezTaskGroup::DebugCheckTaskGroup(groupID, s_TaskSystemMutex);
 
-  ezInt32 iActiveDependencies = 0;
+  ezTaskGroup& tg = *groupID.m_pTaskGroup;
+  bool bScheduleNow = true;
 
   {
+    // the lock prevents that a dependency gets reused while this group inserts itself into its list of dependents
     EZ_LOCK(s_TaskSystemMutex);
 
-    ezTaskGroup& tg = *groupID.m_pTaskGroup;
-
     tg.m_bStartedByUser = true;
 
-    for (ezUInt32 i = 0; i < tg.m_DependsOnGroups.GetCount(); ++i)
+    const ezUInt32 uiNumDependencies = tg.m_DependsOnGroups.GetCount();
+
+    if (uiNumDependencies != 0)
     {
-      if (!IsTaskGroupFinished(tg.m_DependsOnGroups[i]))
+      // the links must not move anymore, once they are inserted into the other groups' lists
+      tg.m_DependentLinks.SetCountUninitialized(uiNumDependencies);
+
+      // Dependencies may finish and decrement the counter while the loop below is still running.
+      // The additional count keeps the group from getting scheduled until all dependencies are registered.
+      tg.m_iNumActiveDependencies = uiNumDependencies + 1;
+
+      for (ezUInt32 i = 0; i < uiNumDependencies; ++i)
       {
-        ezTaskGroup& Dependency = *tg.m_DependsOnGroups[i].m_pTaskGroup;
+        const ezTaskGroupID& dependency = tg.m_DependsOnGroups[i];
 
-        // add this task group to the list of dependencies, such that when that group finishes, this task group can get woken up
-        Dependency.m_OthersDependingOnMe.PushBack(groupID);
+        ezTaskGroup::DependentLink& link = tg.m_DependentLinks[i];
+        link.m_pDependent = &tg;
 
-        // count how many other groups need to finish before this task group can be executed
-        ++iActiveDependencies;
+        // add this task group to the list of dependencies, such that when that group finishes, this task group can get woken up
+        // if the group has already finished, there is nothing to wait for
+        if (IsTaskGroupFinished(dependency) || !dependency.m_pTaskGroup->TryAddDependent(&link))
+        {
+          tg.m_iNumActiveDependencies.Decrement();
+        }
       }
-    }
 
-    if (iActiveDependencies != 0)
-    {
-      // atomic integers are quite slow, so do not use them in the loop, where they are not yet needed
-      tg.m_iNumActiveDependencies = iActiveDependencies;
+      bScheduleNow = tg.m_iNumActiveDependencies.Decrement() == 0;
     }
   }
 
-  if (iActiveDependencies == 0)
+  if (bScheduleNow)
   {
     ScheduleGroupTasks(groupID.m_pTaskGroup, false);
   }
@@ -145,6 +154,60 @@ void ezTaskSystem::ScheduleGroupTasks(ezTaskGroup* pGroup, bool bHighPriority)
 
   ezInt32 iRemainingTasks = 0;
 
+  if (s_State->m_SchedulingMode == ezTaskSchedulingMode::WorkStealing && tl_TaskWorkerInfo.m_pLocalQueues != nullptr &&
+      pGroup->m_Priority < ezTaskLocalQueues::NumPriorities)
+  {
+    // 'this frame' tasks go into the local queue of this thread, from where other threads can steal them without locking the mutex
+
+    {
+      // CancelTask() may still remove tasks from the group, until they are flagged as scheduled
+      EZ_LOCK(s_TaskSystemMutex);
+
+      for (auto pTask : pGroup->m_Tasks)
+      {
+        iRemainingTasks += ezMath::Max(1u, pTask->m_uiMultiplicity);
+        pTask->m_iRemainingRuns = ezMath::Max(1u, pTask->m_uiMultiplicity);
+        pTask->m_bTaskIsScheduled = true;
+      }
+
+      pGroup->m_iNumRemainingTasks = iRemainingTasks;
+    }
+
+    const ezTaskPriority::Enum priority = pGroup->m_Priority;
+    const ezUInt32 uiNumTasks = pGroup->m_Tasks.GetCount();
+    auto& queue = tl_TaskWorkerInfo.m_pLocalQueues->m_Queues[priority];
+
+    // once the last entry is pushed, other threads may finish and even reuse the group, so it must not be accessed after that
+    for (ezUInt32 task = 0; task < uiNumTasks; ++task)
+    {
+      const ezSharedPtr<ezTask>& pTask = pGroup->m_Tasks[task];
+      const ezUInt32 uiMultiplicity = ezMath::Max(1u, pTask->m_uiMultiplicity);
+
+      for (ezUInt32 mult = 0; mult < uiMultiplicity; ++mult)
+      {
+        ezTaskLocalQueues::Entry entry;
+        entry.m_pTask = &pTask;
+        entry.m_pBelongsToGroup = pGroup;
+        entry.m_uiInvocation = mult;
+
+        if (!queue.PushBottom(entry))
+        {
+          // the local queue is full, fall back to the global one
+          TaskData td;
+          td.m_pBelongsToGroup = pGroup;
+          td.m_pTask = pTask;
+          td.m_uiInvocation = mult;
+
+          EZ_LOCK(s_TaskSystemMutex);
+          AddTaskToGlobalQueue(priority, td, bHighPriority);
+        }
+      }
+    }
+
+    WakeUpThreads(ezWorkerThreadType::ShortTasks, iRemainingTasks);
+    return;
+  }
+
   // add all the tasks to the task list, so that they will be processed
   {
     EZ_LOCK(s_TaskSystemMutex);
@@ -173,10 +236,7 @@ void ezTaskSystem::ScheduleGroupTasks(ezTaskGroup* pGroup, bool bHighPriority)
         td.m_pTask->m_bTaskIsScheduled = true;
         td.m_uiInvocation = mult;
 
-        if (bHighPriority)
-          s_State->m_Tasks[pGroup->m_Priority].PushFront(td);
-        else
-          s_State->m_Tasks[pGroup->m_Priority].PushBack(td);
+        AddTaskToGlobalQueue(pGroup->m_Priority, td, bHighPriority);
       }
     }
 
@@ -246,7 +306,18 @@ ezResult ezTaskSystem::CancelGroup(ezTaskGroupID Group, ezOnTaskRunning::Enum On
 
   ezResult res = EZ_SUCCESS;
 
-  auto TasksCopy = Group.m_pTaskGroup->m_Tasks;
+  decltype(Group.m_pTaskGroup->m_Tasks) TasksCopy;
+
+  {
+    // the group may finish and release its tasks at the same time, see TaskHasFinished()
+    EZ_LOCK(Group.m_pTaskGroup->m_CondVarGroupFinished);
+
+    // the group may also have finished and got reused before the lock was taken
+    if (ezTaskSystem::IsTaskGroupFinished(Group))
+      return EZ_SUCCESS;
+
+    TasksCopy = Group.m_pTaskGroup->m_Tasks;
+  }
 
   // first cancel ALL the tasks in the group, without waiting for anything
   for (ezUInt32 task = 0; task < TasksCopy.GetCount(); ++task)
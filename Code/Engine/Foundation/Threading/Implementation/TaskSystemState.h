@@ -1,5 +1,7 @@
 #pragma once
 
+#include <Foundation/Containers/HashTable.h>
+#include <Foundation/Threading/Implementation/TaskWorkerThread.h>
 #include <Foundation/Threading/TaskSystem.h>
 
 class ezTaskSystemThreadState
@@ -16,6 +18,25 @@ private:
 
   // the maximum number of worker threads that should be non-idle (and not blocked) at any time
   ezUInt32 m_uiMaxWorkersToUse[ezWorkerThreadType::ENUM_COUNT] = {};
+
+  // The local queues of the main thread. The worker threads own theirs.
+  ezTaskLocalQueues m_MainThreadQueues;
+
+  // The cache group of the logical processor that the main thread is pinned to, see ezTaskWorkerInfo::m_uiCacheGroup.
+  ezUInt16 m_uiMainThreadCacheGroup = ezTaskWorkerInfo::NoCacheGroup;
+
+  ezWorkerThreadAffinity::Enum m_WorkerAffinity = ezWorkerThreadAffinity::Default;
+  bool m_bReserveMainThreadCore = false;
+
+  // The logical processors (OS indices) that the short task workers get pinned to, worker N uses entry N modulo the count.
+  // Empty if the workers are not pinned to single processors.
+  ezDynamicArray<ezUInt32> m_WorkerProcessors;
+
+  // The cache group of every entry in m_WorkerProcessors.
+  ezDynamicArray<ezUInt16> m_WorkerCacheGroups;
+
+  // The logical processors that all other workers may run on. Empty if they may run on all of them.
+  ezDynamicArray<ezUInt32> m_AllowedProcessors;
 };
 
 class ezTaskSystemState
@@ -31,4 +52,15 @@ private:
 
   // The lists of all scheduled tasks, for each priority.
   ezList<ezTaskSystem::TaskData> m_Tasks[ezTaskPriority::ENUM_COUNT];
+
+  // How 'this frame' tasks are distributed to the worker threads.
+  ezTaskSchedulingMode::Enum m_SchedulingMode = ezTaskSchedulingMode::Default;
+
+  // The number of tasks in m_Tasks for the priorities that may also be in local queues.
+  // Allows the work stealing mode to skip the mutex, when there is nothing in the global queues for these priorities.
+  ezAtomicInteger32 m_iNumGlobalFrameTasks[ezTaskLocalQueues::NumPriorities];
+
+  // The measured cost per item (in nanoseconds) of adaptive ParallelFor calls, by the hash of their task name.
+  ezMutex m_ParallelForCostMutex;
+  ezHashTable<ezUInt32, double> m_ParallelForItemCosts;
 };
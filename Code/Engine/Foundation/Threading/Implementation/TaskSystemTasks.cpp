@@ -37,29 +37,35 @@ void ezTaskSystem::TaskHasFinished(const ezSharedPtr<ezTask>& pTask, ezTaskGroup
   {
     // If this was the last task that had to be finished from this group, make sure all dependent groups are started
 
-    ezUInt32 groupCounter = 0;
-    {
-      // see ezTaskGroup::WaitForFinish() for why we need this lock here
-      // without it, there would be a race condition between these two places, reading and writing m_uiGroupCounter and waiting/signaling
-      // m_CondVarGroupFinished
-      EZ_LOCK(pGroup->m_CondVarGroupFinished);
+    const ezUInt32 groupCounter = pGroup->m_uiGroupCounter;
 
-      groupCounter = pGroup->m_uiGroupCounter;
+    // from now on, groups that get started and depend on this one, will not wait for it anymore
+    ezTaskGroup::DependentLink* pDependents = pGroup->CloseDependents();
 
-      // set this task group to be finished such that no one tries to append further dependencies
-      pGroup->m_uiGroupCounter += 2;
-    }
+    // set this task group to be finished
+    // this has to be a full barrier, the number of waiting threads must not be read before the new counter is visible to other threads
+    ezAtomicUtils::Add(reinterpret_cast<volatile ezInt32&>(pGroup->m_uiGroupCounter), 2);
 
-    // wake up all threads that are waiting for this group
-    pGroup->m_CondVarGroupFinished.SignalAll();
+    // only take the lock and wake up the threads that are waiting for this group, if there are any
+    // ezTaskGroup::WaitForFinish() registers as waiting (also with a full barrier) before it reads the counter,
+    // so either it sees the new counter and doesn't wait, or it registered early enough for this read to see it
+    if (pGroup->m_iNumWaitingThreads > 0)
+    {
+      EZ_LOCK(pGroup->m_CondVarGroupFinished);
+      pGroup->m_CondVarGroupFinished.SignalAll();
+    }
 
+    while (pDependents != nullptr)
     {
-      EZ_LOCK(s_TaskSystemMutex);
+      // the link belongs to the dependent group, which may run, finish and get reused as soon as it got notified
+      ezTaskGroup::DependentLink* pNext = pDependents->m_pNext;
+      DependencyHasFinished(pDependents->m_pDependent);
+      pDependents = pNext;
+    }
 
-      for (ezUInt32 dep = 0; dep < pGroup->m_OthersDependingOnMe.GetCount(); ++dep)
-      {
-        DependencyHasFinished(pGroup->m_OthersDependingOnMe[dep].m_pTaskGroup);
-      }
+    {
+      // CancelGroup() may copy the task list at the same time
+      EZ_LOCK(pGroup->m_CondVarGroupFinished);
 
       // unless an outside reference is held onto a task, this will deallocate the tasks
       pGroup->m_Tasks.Clear();
@@ -86,6 +92,48 @@ ezTaskSystem::TaskData ezTaskSystem::GetNextTask(ezTaskPriority::Enum FirstPrior
   EZ_ASSERT_DEV(FirstPriority >= ezTaskPriority::EarlyThisFrame && LastPriority < ezTaskPriority::ENUM_COUNT, "Priority Range is invalid: {0} to {1}",
     FirstPriority, LastPriority);
 
+  if (s_State->m_SchedulingMode != ezTaskSchedulingMode::WorkStealing)
+  {
+    return GetNextGlobalTask(FirstPriority, LastPriority, bOnlyTasksThatNeverWait, WaitingForGroup, pWorkerState);
+  }
+
+  while (true)
+  {
+    TaskData td;
+
+    // the 'this frame' priorities come first, for those look into the local queues before taking the lock for the global lists
+    ezUInt32 prio = FirstPriority;
+    for (; prio <= (ezUInt32)LastPriority && prio < ezTaskLocalQueues::NumPriorities; ++prio)
+    {
+      if (GetNextLocalTask((ezTaskPriority::Enum)prio, bOnlyTasksThatNeverWait, WaitingForGroup, td))
+        return td;
+
+      if (s_State->m_iNumGlobalFrameTasks[prio] > 0)
+      {
+        td = GetNextGlobalTask((ezTaskPriority::Enum)prio, (ezTaskPriority::Enum)prio, bOnlyTasksThatNeverWait, WaitingForGroup, nullptr);
+
+        if (td.m_pTask != nullptr)
+          return td;
+      }
+    }
+
+    // this also puts the worker to sleep, if nothing is found
+    td = GetNextGlobalTask((ezTaskPriority::Enum)prio, LastPriority, bOnlyTasksThatNeverWait, WaitingForGroup, pWorkerState);
+
+    if (td.m_pTask != nullptr || pWorkerState == nullptr || FirstPriority >= ezTaskLocalQueues::NumPriorities)
+      return td;
+
+    // tasks are pushed into the local queues without locking the mutex, so a task may have been added after we looked
+    // and the thread that added it may not have seen this worker as idle yet
+    // if the state was already changed back to 'active' by someone else, the wake up signal is raised and the worker will not sleep anyway
+    if (!AreLocalTasksQueued() || !pWorkerState->TestAndSet((int)ezTaskWorkerState::Idle, (int)ezTaskWorkerState::Active))
+      return td;
+  }
+}
+
+ezTaskSystem::TaskData ezTaskSystem::GetNextGlobalTask(ezTaskPriority::Enum FirstPriority, ezTaskPriority::Enum LastPriority,
+  bool bOnlyTasksThatNeverWait, const ezTaskGroupID& WaitingForGroup, ezAtomicInteger32* pWorkerState)
+{
   EZ_LOCK(s_TaskSystemMutex);
 
   // go through all the task lists that this thread is willing to work on
@@ -97,7 +145,7 @@ ezTaskSystem::TaskData ezTaskSystem::GetNextTask(ezTaskPriority::Enum FirstPrior
       {
         TaskData td = *it;
 
-        s_State->m_Tasks[prio].Remove(it);
+        RemoveTaskFromGlobalQueue((ezTaskPriority::Enum)prio, it);
         return td;
       }
     }
@@ -111,6 +159,198 @@ ezTaskSystem::TaskData ezTaskSystem::GetNextTask(ezTaskPriority::Enum FirstPrior
   return TaskData();
 }
 
+bool ezTaskSystem::GetNextLocalTask(
+  ezTaskPriority::Enum Priority, bool bOnlyTasksThatNeverWait, const ezTaskGroupID& WaitingForGroup, TaskData& out_Task)
+{
+  ezTaskLocalQueues::Entry entry;
+
+  auto TakeEntry = [&]() -> bool {
+    const ezSharedPtr<ezTask>& pTask = *entry.m_pTask;
+
+    if (!bOnlyTasksThatNeverWait || (pTask->m_NestingMode == ezTaskNesting::Never) || entry.m_pBelongsToGroup == WaitingForGroup.m_pTaskGroup)
+    {
+      out_Task.m_pTask = pTask;
+      out_Task.m_pBelongsToGroup = entry.m_pBelongsToGroup;
+      out_Task.m_uiInvocation = entry.m_uiInvocation;
+      return true;
+    }
+
+    // this thread is not allowed to execute the task right now, hand it over to the global list, where any other thread can pick it up
+    TaskData td;
+    td.m_pTask = pTask;
+    td.m_pBelongsToGroup = entry.m_pBelongsToGroup;
+    td.m_uiInvocation = entry.m_uiInvocation;
+
+    EZ_LOCK(s_TaskSystemMutex);
+    AddTaskToGlobalQueue(Priority, td, false);
+    return false;
+  };
+
+  ezTaskLocalQueues* pOwnQueues = tl_TaskWorkerInfo.m_pLocalQueues;
+
+  // prefer the most recently added tasks of this thread, their data is most likely still in the cache
+  if (pOwnQueues != nullptr)
+  {
+    while (pOwnQueues->m_Queues[Priority].PopBottom(entry))
+    {
+      if (TakeEntry())
+        return true;
+    }
+  }
+
+  // otherwise steal the oldest task from another thread
+  // the main thread queue is treated as the last entry, each thread starts looking at a different victim to spread out the stealing
+  const ezUInt32 uiNumWorkers = s_ThreadState->m_iAllocatedWorkers[ezWorkerThreadType::ShortTasks];
+  const ezUInt32 uiNumVictims = uiNumWorkers + 1;
+  const ezUInt32 uiFirstVictim = static_cast<ezUInt32>(tl_TaskWorkerInfo.m_iWorkerIndex + 1);
+
+  // when the workers are pinned to processors, the threads that share our last level cache are tried first
+  // the data of their tasks is then likely already in our cache, too
+  const ezUInt16 uiOwnCacheGroup = tl_TaskWorkerInfo.m_uiCacheGroup;
+  const ezUInt32 uiFirstPass = (uiOwnCacheGroup != ezTaskWorkerInfo::NoCacheGroup) ? 0 : 1;
+
+  bool bTryAgain = true;
+  while (bTryAgain)
+  {
+    bTryAgain = false;
+
+    for (ezUInt32 uiPass = uiFirstPass; uiPass < 2; ++uiPass)
+    {
+      for (ezUInt32 i = 0; i < uiNumVictims; ++i)
+      {
+        const ezUInt32 uiVictim = (uiFirstVictim + i) % uiNumVictims;
+        ezTaskWorkerThread* pVictimWorker = (uiVictim == uiNumWorkers) ? nullptr : s_ThreadState->m_Workers[ezWorkerThreadType::ShortTasks][uiVictim];
+        ezTaskLocalQueues* pVictimQueues = (pVictimWorker == nullptr) ? &s_ThreadState->m_MainThreadQueues : &pVictimWorker->m_LocalQueues;
+
+        if (pVictimQueues == pOwnQueues)
+          continue;
+
+        if (uiFirstPass == 0)
+        {
+          const ezUInt16 uiVictimCacheGroup = (pVictimWorker == nullptr) ? s_ThreadState->m_uiMainThreadCacheGroup : pVictimWorker->m_uiCacheGroup;
+
+          // first pass: only the threads that share our cache, second pass: all others
+          if ((uiVictimCacheGroup == uiOwnCacheGroup) != (uiPass == 0))
+            continue;
+        }
+
+        switch (pVictimQueues->m_Queues[Priority].Steal(entry))
+        {
+          case ezWorkStealResult::Success:
+            if (TakeEntry())
+              return true;
+
+            bTryAgain = true;
+            break;
+
+          case ezWorkStealResult::Contended:
+            bTryAgain = true;
+            break;
+
+          case ezWorkStealResult::Empty:
+            break;
+        }
+      }
+    }
+  }
+
+  return false;
+}
+
+bool ezTaskSystem::AreLocalTasksQueued()
+{
+  const ezUInt32 uiNumWorkers = s_ThreadState->m_iAllocatedWorkers[ezWorkerThreadType::ShortTasks];
+
+  for (ezUInt32 prio = 0; prio < ezTaskLocalQueues::NumPriorities; ++prio)
+  {
+    if (!s_ThreadState->m_MainThreadQueues.m_Queues[prio].IsEmpty())
+      return true;
+
+    for (ezUInt32 i = 0; i < uiNumWorkers; ++i)
+    {
+      if (!s_ThreadState->m_Workers[ezWorkerThreadType::ShortTasks][i]->m_LocalQueues.m_Queues[prio].IsEmpty())
+        return true;
+    }
+  }
+
+  return false;
+}
+
+void ezTaskSystem::SpillLocalQueues(ezTaskLocalQueues& queues)
+{
+  ezTaskLocalQueues::Entry entry;
+
+  for (ezUInt32 prio = 0; prio < ezTaskLocalQueues::NumPriorities; ++prio)
+  {
+    // steal from the top, to keep the order in which the tasks were added
+    while (true)
+    {
+      const ezWorkStealResult res = queues.m_Queues[prio].Steal(entry);
+
+      if (res == ezWorkStealResult::Empty)
+        break;
+
+      // another thread got this entry, it must not be added to the global queue as well
+      if (res == ezWorkStealResult::Contended)
+        continue;
+
+      TaskData td;
+      td.m_pTask = *entry.m_pTask;
+      td.m_pBelongsToGroup = entry.m_pBelongsToGroup;
+      td.m_uiInvocation = entry.m_uiInvocation;
+
+      AddTaskToGlobalQueue((ezTaskPriority::Enum)prio, td, false);
+    }
+  }
+}
+
+void ezTaskSystem::AddTaskToGlobalQueue(ezTaskPriority::Enum Priority, const TaskData& td, bool bHighPriority)
+{
+  if (bHighPriority)
+    s_State->m_Tasks[Priority].PushFront(td);
+  else
+    s_State->m_Tasks[Priority].PushBack(td);
+
+  if (Priority < ezTaskLocalQueues::NumPriorities)
+  {
+    s_State->m_iNumGlobalFrameTasks[Priority].Increment();
+  }
+}
+
+void ezTaskSystem::RemoveTaskFromGlobalQueue(ezTaskPriority::Enum Priority, ezList<TaskData>::Iterator it)
+{
+  s_State->m_Tasks[Priority].Remove(it);
+
+  if (Priority < ezTaskLocalQueues::NumPriorities)
+  {
+    s_State->m_iNumGlobalFrameTasks[Priority].Decrement();
+  }
+}
+
+void ezTaskSystem::SetSchedulingMode(ezTaskSchedulingMode::Enum mode)
+{
+  EZ_LOCK(s_TaskSystemMutex);
+
+  if (s_State->m_SchedulingMode == mode)
+    return;
+
+  s_State->m_SchedulingMode = mode;
+
+  // in the global queue mode nobody would look at the local queues anymore
+  SpillLocalQueues(s_ThreadState->m_MainThreadQueues);
+
+  const ezUInt32 uiNumWorkers = s_ThreadState->m_iAllocatedWorkers[ezWorkerThreadType::ShortTasks];
+  for (ezUInt32 i = 0; i < uiNumWorkers; ++i)
+  {
+    SpillLocalQueues(s_ThreadState->m_Workers[ezWorkerThreadType::ShortTasks][i]->m_LocalQueues);
+  }
+}
+
+ezTaskSchedulingMode::Enum ezTaskSystem::GetSchedulingMode()
+{
+  return s_State->m_SchedulingMode;
+}
+
 bool ezTaskSystem::ExecuteTask(ezTaskPriority::Enum FirstPriority, ezTaskPriority::Enum LastPriority, bool bOnlyTasksThatNeverWait,
   const ezTaskGroupID& WaitingForGroup, ezAtomicInteger32* pWorkerState)
 {
@@ -127,16 +367,73 @@ bool ezTaskSystem::ExecuteTask(ezTaskPriority::Enum FirstPriority, ezTaskPriorit
     EZ_ASSERT_DEV(td.m_pBelongsToGroup == WaitingForGroup.m_pTaskGroup, "");
   }
 
-  tl_TaskWorkerInfo.m_bAllowNestedTasks = td.m_pTask->m_NestingMode != ezTaskNesting::Never;
-  tl_TaskWorkerInfo.m_szTaskName = td.m_pTask->m_sTaskName;
-  td.m_pTask->Run(td.m_uiInvocation);
-  tl_TaskWorkerInfo.m_bAllowNestedTasks = true;
-  tl_TaskWorkerInfo.m_szTaskName = nullptr;
+  RunTask(td);
+
+  return true;
+}
+
+/// \internal Continues a suspended task. This task is put into a group that depends on the group that the suspended task waits for.
+class ezTaskResumption final : public ezTask
+{
+public:
+  ezTaskResumption(const ezTaskSystem::TaskData& td)
+    : m_TaskData(td)
+  {
+  }
+
+private:
+  virtual void Execute() override { ezTaskSystem::RunTask(m_TaskData); }
+
+  ezTaskSystem::TaskData m_TaskData;
+};
+
+void ezTaskSystem::RunTask(const TaskData& td)
+{
+  ezTask* pTask = td.m_pTask.Borrow();
+
+  while (true)
+  {
+    tl_TaskWorkerInfo.m_bAllowNestedTasks = pTask->m_NestingMode != ezTaskNesting::Never;
+    tl_TaskWorkerInfo.m_szTaskName = pTask->m_sTaskName;
+    pTask->Run(td.m_uiInvocation);
+    tl_TaskWorkerInfo.m_bAllowNestedTasks = true;
+    tl_TaskWorkerInfo.m_szTaskName = nullptr;
+
+    if (!pTask->m_ResumeAfterGroup.IsValid())
+      break;
+
+    if (!IsTaskGroupFinished(pTask->m_ResumeAfterGroup))
+    {
+      // the task stays unfinished and so does its group, but this thread is free to do other work
+      SuspendTask(td);
+      return;
+    }
+
+    // nothing to wait for, continue right away
+    pTask->m_ResumeAfterGroup.Invalidate();
+    ++pTask->m_uiResumeCount;
+  }
 
   // notify the group, that a task is finished, which might trigger other tasks to be executed
   TaskHasFinished(td.m_pTask, td.m_pBelongsToGroup);
+}
 
-  return true;
+void ezTaskSystem::SuspendTask(const TaskData& td)
+{
+  ezTask* pTask = td.m_pTask.Borrow();
+
+  const ezTaskGroupID waitFor = pTask->m_ResumeAfterGroup;
+  pTask->m_ResumeAfterGroup.Invalidate();
+  ++pTask->m_uiResumeCount;
+
+  ezSharedPtr<ezTask> pResumption = EZ_DEFAULT_NEW(ezTaskResumption, td);
+  pResumption->ConfigureTask(pTask->m_sTaskName, pTask->m_NestingMode);
+
+  // the task's own group cannot finish in the mean time, so it is safe to read its priority
+  ezTaskGroupID resumeGroup = CreateTaskGroup(td.m_pBelongsToGroup->m_Priority);
+  AddTaskGroupDependency(resumeGroup, waitFor);
+  AddTaskToGroup(resumeGroup, pResumption);
+  StartTaskGroup(resumeGroup);
 }
 
 
@@ -176,13 +473,14 @@ ezResult ezTaskSystem::CancelTask(const ezSharedPtr<ezTask>& pTask, ezOnTaskRunn
         {
           if (it->m_pTask == pTask)
           {
-            s_State->m_Tasks[i].Remove(it);
+            ezTaskGroup* pGroup = it->m_pBelongsToGroup;
+            RemoveTaskFromGlobalQueue((ezTaskPriority::Enum)i, it);
 
             // we set the task to finished, even though it was not executed
             pTask->m_iRemainingRuns = 0;
 
             // tell the system that one task of that group is 'finished', to ensure its dependencies will get scheduled
-            TaskHasFinished(it->m_pTask, it->m_pBelongsToGroup);
+            TaskHasFinished(pTask, pGroup);
             return EZ_SUCCESS;
           }
 
@@ -268,6 +566,11 @@ void ezTaskSystem::ReprioritizeFrameTasks()
     // remove the tasks from their current queue
     s_State->m_Tasks[i].Clear();
   }
+
+  for (ezUInt32 i = 0; i < ezTaskLocalQueues::NumPriorities; ++i)
+  {
+    s_State->m_iNumGlobalFrameTasks[i] = s_State->m_Tasks[i].GetCount();
+  }
 }
 
 void ezTaskSystem::ExecuteSomeFrameTasks(ezTime smoothFrameTime)
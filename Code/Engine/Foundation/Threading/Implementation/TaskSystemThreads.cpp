@@ -5,6 +5,7 @@
 #include <Foundation/Threading/Implementation/TaskSystemState.h>
 #include <Foundation/Threading/Implementation/TaskWorkerThread.h>
 #include <Foundation/Threading/TaskSystem.h>
+#include <Foundation/Threading/ThreadUtils.h>
 
 ezUInt32 ezTaskSystem::GetWorkerThreadCount(ezWorkerThreadType::Enum type)
 {
@@ -16,9 +17,9 @@ ezUInt32 ezTaskSystem::GetNumAllocatedWorkerThreads(ezWorkerThreadType::Enum typ
   return s_ThreadState->m_iAllocatedWorkers[type];
 }
 
-void ezTaskSystem::SetWorkerThreadCount(ezInt32 iShortTasks, ezInt32 iLongTasks)
+void ezTaskSystem::SetWorkerThreadCount(ezInt32 iShortTasks, ezInt32 iLongTasks, ezInt32 iFileAccessTasks)
 {
-  ezSystemInformation info = ezSystemInformation::Get();
+  const ezSystemInformation& info = ezSystemInformation::Get();
 
   // these settings are supposed to be a sensible default for most applications
   // an app can of course change that to optimize for its own usage
@@ -33,15 +34,17 @@ void ezTaskSystem::SetWorkerThreadCount(ezInt32 iShortTasks, ezInt32 iLongTasks)
   if (iLongTasks <= 0)
     iLongTasks = ezMath::Clamp<ezInt32>(iCpuCores - 2, 2, 8);
 
-  // plus there is always one additional 'file access' thread
+  // plus one additional 'file access' thread, unless more are requested
   // and the main thread, of course
 
   ezUInt32 uiShortTasks = static_cast<ezUInt32>(ezMath::Max<ezInt32>(iShortTasks, 1));
   ezUInt32 uiLongTasks = static_cast<ezUInt32>(ezMath::Max<ezInt32>(iLongTasks, 1));
+  ezUInt32 uiFileAccessTasks = static_cast<ezUInt32>(ezMath::Max<ezInt32>(iFileAccessTasks, 1));
 
   // if nothing has changed, do nothing
   if (s_ThreadState->m_uiMaxWorkersToUse[ezWorkerThreadType::ShortTasks] == uiShortTasks &&
-      s_ThreadState->m_uiMaxWorkersToUse[ezWorkerThreadType::LongTasks] == uiLongTasks)
+      s_ThreadState->m_uiMaxWorkersToUse[ezWorkerThreadType::LongTasks] == uiLongTasks &&
+      s_ThreadState->m_uiMaxWorkersToUse[ezWorkerThreadType::FileAccess] == uiFileAccessTasks)
     return;
 
   StopWorkerThreads();
@@ -53,7 +56,7 @@ void ezTaskSystem::SetWorkerThreadCount(ezInt32 iShortTasks, ezInt32 iLongTasks)
 
   s_ThreadState->m_uiMaxWorkersToUse[ezWorkerThreadType::ShortTasks] = uiShortTasks;
   s_ThreadState->m_uiMaxWorkersToUse[ezWorkerThreadType::LongTasks] = uiLongTasks;
-  s_ThreadState->m_uiMaxWorkersToUse[ezWorkerThreadType::FileAccess] = 1;
+  s_ThreadState->m_uiMaxWorkersToUse[ezWorkerThreadType::FileAccess] = uiFileAccessTasks;
 
   AllocateThreads(ezWorkerThreadType::ShortTasks, s_ThreadState->m_uiMaxWorkersToUse[ezWorkerThreadType::ShortTasks]);
   AllocateThreads(ezWorkerThreadType::LongTasks, s_ThreadState->m_uiMaxWorkersToUse[ezWorkerThreadType::LongTasks]);
@@ -93,6 +96,13 @@ void ezTaskSystem::StopWorkerThreads()
     for (ezUInt32 i = 0; i < uiNumWorkers; ++i)
     {
       s_ThreadState->m_Workers[type][i]->Join();
+
+      {
+        // don't lose the tasks that are still queued on this worker
+        EZ_LOCK(s_TaskSystemMutex);
+        SpillLocalQueues(s_ThreadState->m_Workers[type][i]->m_LocalQueues);
+      }
+
       EZ_DEFAULT_DELETE(s_ThreadState->m_Workers[type][i]);
     }
 
@@ -185,6 +195,191 @@ ezWorkerThreadType::Enum ezTaskSystem::GetCurrentThreadWorkerType()
   return tl_TaskWorkerInfo.m_WorkerType;
 }
 
+void ezTaskSystem::SetWorkerThreadAffinity(ezWorkerThreadAffinity::Enum affinity, bool bReserveMainThreadCore /*= false*/)
+{
+  EZ_ASSERT_DEV(ezThreadUtils::IsMainThread(), "The worker thread affinity can only be changed from the main thread.");
+
+  auto* s = s_ThreadState.Borrow();
+  const ezCPUTopology& topology = ezSystemInformation::Get().GetCPUTopology();
+
+  if (bReserveMainThreadCore && topology.m_uiNumCores < 2)
+  {
+    ezLog::Warning("Can't reserve a core for the main thread, the system only reports a single core.");
+    bReserveMainThreadCore = false;
+  }
+
+  const bool bMainThreadWasPinned = s->m_bReserveMainThreadCore;
+  const ezUInt32 uiShortTasks = s->m_uiMaxWorkersToUse[ezWorkerThreadType::ShortTasks];
+  const ezUInt32 uiLongTasks = s->m_uiMaxWorkersToUse[ezWorkerThreadType::LongTasks];
+  const ezUInt32 uiFileAccessTasks = s->m_uiMaxWorkersToUse[ezWorkerThreadType::FileAccess];
+
+  // the workers only apply their affinity when they start, so all of them have to be restarted
+  StopWorkerThreads();
+
+  s->m_WorkerAffinity = affinity;
+  s->m_bReserveMainThreadCore = bReserveMainThreadCore;
+  s->m_uiMainThreadCacheGroup = ezTaskWorkerInfo::NoCacheGroup;
+
+  ComputeWorkerThreadProcessors();
+
+  if (bReserveMainThreadCore)
+  {
+    const ezCPUTopology::LogicalProcessor& mainProcessor = topology.m_LogicalProcessors[0];
+
+    ezHybridArray<ezUInt32, 4> siblings;
+    for (ezUInt32 i = 0; i < topology.m_uiNumLogicalProcessors; ++i)
+    {
+      if (topology.m_LogicalProcessors[i].m_uiCore == mainProcessor.m_uiCore)
+        siblings.PushBack(topology.m_LogicalProcessors[i].m_uiOSIndex);
+    }
+
+    if (ezThreadUtils::SetCurrentThreadAffinity(siblings).Succeeded())
+    {
+      s->m_uiMainThreadCacheGroup = mainProcessor.m_uiCacheGroup;
+    }
+    else
+    {
+      ezLog::Warning("Failed to pin the main thread to processor {}.", mainProcessor.m_uiOSIndex);
+    }
+  }
+  else if (bMainThreadWasPinned)
+  {
+    ezThreadUtils::SetCurrentThreadAffinity({}).IgnoreResult();
+  }
+
+  tl_TaskWorkerInfo.m_uiCacheGroup = s->m_uiMainThreadCacheGroup;
+
+  if (uiShortTasks > 0)
+  {
+    SetWorkerThreadCount(uiShortTasks, uiLongTasks, uiFileAccessTasks);
+  }
+}
+
+ezWorkerThreadAffinity::Enum ezTaskSystem::GetWorkerThreadAffinity()
+{
+  return s_ThreadState->m_WorkerAffinity;
+}
+
+void ezTaskSystem::ComputeWorkerThreadProcessors()
+{
+  auto* s = s_ThreadState.Borrow();
+
+  s->m_WorkerProcessors.Clear();
+  s->m_WorkerCacheGroups.Clear();
+  s->m_AllowedProcessors.Clear();
+
+  if (s->m_WorkerAffinity == ezWorkerThreadAffinity::None && !s->m_bReserveMainThreadCore)
+    return;
+
+  const ezCPUTopology& topology = ezSystemInformation::Get().GetCPUTopology();
+  const ezUInt32 uiReservedCore = s->m_bReserveMainThreadCore ? topology.m_LogicalProcessors[0].m_uiCore : ezInvalidIndex;
+
+  // rank every processor within its core, every core within its cache group and every cache group within its package
+  // scattering the workers means to use all processors with rank 0 first, then those with rank 1, and so on
+  ezDynamicArray<ezUInt16> numProcessorsInCore;
+  ezDynamicArray<ezUInt16> numCoresInCacheGroup;
+  ezDynamicArray<ezUInt16> numCacheGroupsInPackage;
+  ezDynamicArray<ezUInt16> coreRank;
+  ezDynamicArray<ezUInt16> cacheGroupRank;
+  numProcessorsInCore.SetCount(topology.m_uiNumCores);
+  numCoresInCacheGroup.SetCount(topology.m_uiNumCacheGroups);
+  numCacheGroupsInPackage.SetCount(topology.m_uiNumPackages);
+  coreRank.SetCount(topology.m_uiNumCores);
+  cacheGroupRank.SetCount(topology.m_uiNumCacheGroups, 0xFFFF);
+
+  struct Candidate
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezUInt64 m_uiSortKey;
+    ezUInt32 m_uiIndex;
+
+    bool operator<(const Candidate& rhs) const
+    {
+      if (m_uiSortKey != rhs.m_uiSortKey)
+        return m_uiSortKey < rhs.m_uiSortKey;
+
+      return m_uiIndex < rhs.m_uiIndex;
+    }
+  };
+
+  ezDynamicArray<Candidate> candidates;
+
+  for (ezUInt32 i = 0; i < topology.m_uiNumLogicalProcessors; ++i)
+  {
+    const ezCPUTopology::LogicalProcessor& lp = topology.m_LogicalProcessors[i];
+
+    const ezUInt64 uiSmtRank = numProcessorsInCore[lp.m_uiCore]++;
+
+    if (uiSmtRank == 0)
+    {
+      coreRank[lp.m_uiCore] = numCoresInCacheGroup[lp.m_uiCacheGroup]++;
+    }
+
+    if (cacheGroupRank[lp.m_uiCacheGroup] == 0xFFFF)
+    {
+      cacheGroupRank[lp.m_uiCacheGroup] = numCacheGroupsInPackage[lp.m_uiPackage]++;
+    }
+
+    if (lp.m_uiCore == uiReservedCore)
+      continue;
+
+    Candidate& c = candidates.ExpandAndGetRef();
+    c.m_uiIndex = i;
+
+    if (s->m_WorkerAffinity == ezWorkerThreadAffinity::Scatter)
+    {
+      c.m_uiSortKey = (uiSmtRank << 48) | (ezUInt64(coreRank[lp.m_uiCore]) << 32) | (ezUInt64(cacheGroupRank[lp.m_uiCacheGroup]) << 16) | lp.m_uiPackage;
+    }
+    else
+    {
+      c.m_uiSortKey = (ezUInt64(lp.m_uiPackage) << 48) | (ezUInt64(lp.m_uiNumaNode) << 32) | (ezUInt64(lp.m_uiCacheGroup) << 16) | lp.m_uiCore;
+    }
+  }
+
+  if (s->m_bReserveMainThreadCore)
+  {
+    for (const Candidate& c : candidates)
+    {
+      s->m_AllowedProcessors.PushBack(topology.m_LogicalProcessors[c.m_uiIndex].m_uiOSIndex);
+    }
+  }
+
+  if (s->m_WorkerAffinity == ezWorkerThreadAffinity::None)
+    return;
+
+  candidates.Sort();
+
+  for (const Candidate& c : candidates)
+  {
+    s->m_WorkerProcessors.PushBack(topology.m_LogicalProcessors[c.m_uiIndex].m_uiOSIndex);
+    s->m_WorkerCacheGroups.PushBack(topology.m_LogicalProcessors[c.m_uiIndex].m_uiCacheGroup);
+  }
+}
+
+ezUInt16 ezTaskSystem::ApplyWorkerThreadAffinity(ezWorkerThreadType::Enum type, ezUInt32 uiWorkerIndex)
+{
+  const auto* s = s_ThreadState.Borrow();
+
+  if (type == ezWorkerThreadType::ShortTasks && !s->m_WorkerProcessors.IsEmpty())
+  {
+    // more workers than processors share them round robin
+    const ezUInt32 uiSlot = uiWorkerIndex % s->m_WorkerProcessors.GetCount();
+
+    if (ezThreadUtils::SetCurrentThreadAffinity(ezMakeArrayPtr(&s->m_WorkerProcessors[uiSlot], 1)).Succeeded())
+      return s->m_WorkerCacheGroups[uiSlot];
+
+    return ezTaskWorkerInfo::NoCacheGroup;
+  }
+
+  if (!s->m_AllowedProcessors.IsEmpty())
+  {
+    ezThreadUtils::SetCurrentThreadAffinity(s->m_AllowedProcessors).IgnoreResult();
+  }
+
+  return ezTaskWorkerInfo::NoCacheGroup;
+}
+
 double ezTaskSystem::GetThreadUtilization(ezWorkerThreadType::Enum Type, ezUInt32 uiThreadIndex, ezUInt32* pNumTasksExecuted /*= nullptr*/)
 {
   return s_ThreadState->m_Workers[Type][uiThreadIndex]->GetThreadUtilization(pNumTasksExecuted);
@@ -48,6 +48,10 @@ ezUInt32 ezTaskWorkerThread::Run()
   tl_TaskWorkerInfo.m_WorkerType = m_WorkerType;
   tl_TaskWorkerInfo.m_iWorkerIndex = m_uiWorkerThreadNumber;
   tl_TaskWorkerInfo.m_pWorkerState = &m_WorkerState;
+  tl_TaskWorkerInfo.m_pLocalQueues = (m_WorkerType == ezWorkerThreadType::ShortTasks) ? &m_LocalQueues : nullptr;
+
+  m_uiCacheGroup = ezTaskSystem::ApplyWorkerThreadAffinity(m_WorkerType, m_uiWorkerThreadNumber);
+  tl_TaskWorkerInfo.m_uiCacheGroup = m_uiCacheGroup;
 
   const bool bIsReserve = m_uiWorkerThreadNumber >= ezTaskSystem::s_ThreadState->m_uiMaxWorkersToUse[m_WorkerType];
 
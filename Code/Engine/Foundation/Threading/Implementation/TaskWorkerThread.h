@@ -1,10 +1,32 @@
 #pragma once
 
 #include <Foundation/Threading/Implementation/TaskSystemDeclarations.h>
+#include <Foundation/Threading/Implementation/WorkStealingDeque.h>
 
 #include <Foundation/Threading/Thread.h>
 #include <Foundation/Threading/ThreadSignal.h>
 
+/// \internal Per-thread queues for the 'this frame' priorities, used with ezTaskSchedulingMode::WorkStealing.
+///
+/// The owning thread pushes and pops its own tasks without any locking, all other threads may steal from it.
+struct ezTaskLocalQueues
+{
+  /// \brief The priorities EarlyThisFrame to LateThisFrame are distributed through the local queues.
+  static constexpr ezUInt32 NumPriorities = ezTaskPriority::LateThisFrame + 1;
+
+  struct Entry
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    // points into ezTaskGroup::m_Tasks, which is not modified while the group's tasks are scheduled
+    const ezSharedPtr<ezTask>* m_pTask;
+    ezTaskGroup* m_pBelongsToGroup;
+    ezUInt32 m_uiInvocation;
+  };
+
+  ezWorkStealingDeque<Entry, 512> m_Queues[NumPriorities];
+};
+
 /// \internal Internal task worker thread class.
 class ezTaskWorkerThread final : public ezThread
 {
@@ -22,6 +44,8 @@ public:
   ezResult DeactivateWorker();
 
 private:
+  friend class ezTaskSystem;
+
   // Which types of tasks this thread should work on.
   ezWorkerThreadType::Enum m_WorkerType;
 
@@ -31,6 +55,13 @@ private:
   // For display purposes.
   ezUInt16 m_uiWorkerThreadNumber = 0xFFFF;
 
+  // Only used by short task workers, when the work stealing scheduling mode is active.
+  ezTaskLocalQueues m_LocalQueues;
+
+  // The cache group of the logical processor that this thread is pinned to, see ezTaskWorkerInfo::m_uiCacheGroup.
+  // Other threads read this to decide whom to steal from first.
+  ezUInt16 m_uiCacheGroup = 0xFFFF;
+
   ///@}
 
   /// \name Thread Utilization
@@ -85,6 +116,13 @@ struct ezTaskWorkerInfo
   bool m_bAllowNestedTasks = true;
   const char* m_szTaskName = nullptr;
   ezAtomicInteger32* m_pWorkerState = nullptr;
+  ezTaskLocalQueues* m_pLocalQueues = nullptr;
+
+  static constexpr ezUInt16 NoCacheGroup = 0xFFFF;
+
+  // The last level cache group (see ezCPUTopology) of the logical processor that this thread is pinned to.
+  // NoCacheGroup, if the thread is not pinned to a single processor.
+  ezUInt16 m_uiCacheGroup = NoCacheGroup;
 };
 
 extern thread_local ezTaskWorkerInfo tl_TaskWorkerInfo;
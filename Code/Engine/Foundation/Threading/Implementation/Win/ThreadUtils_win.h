@@ -37,3 +37,35 @@ bool ezThreadUtils::IsMainThread()
 {
   return GetCurrentThreadID() == g_uiMainThreadID;
 }
+
+ezResult ezThreadUtils::SetCurrentThreadAffinity(ezArrayPtr<const ezUInt32> logicalProcessors)
+{
+#if EZ_ENABLED(EZ_PLATFORM_WINDOWS_DESKTOP)
+  DWORD_PTR uiMask = 0;
+
+  if (logicalProcessors.IsEmpty())
+  {
+    DWORD_PTR uiSystemMask = 0;
+    if (!GetProcessAffinityMask(GetCurrentProcess(), &uiMask, &uiSystemMask))
+      return EZ_FAILURE;
+  }
+  else
+  {
+    // only supports the processors of the thread's processor group
+    for (ezUInt32 uiProcessor : logicalProcessors)
+    {
+      if (uiProcessor < sizeof(DWORD_PTR) * 8)
+      {
+        uiMask |= static_cast<DWORD_PTR>(1) << uiProcessor;
+      }
+    }
+  }
+
+  if (uiMask == 0)
+    return EZ_FAILURE;
+
+  return SetThreadAffinityMask(GetCurrentThread(), uiMask) != 0 ? EZ_SUCCESS : EZ_FAILURE;
+#else
+  return EZ_FAILURE;
+#endif
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <Foundation/Threading/AtomicInteger.h>
+
+#include <atomic>
+
+/// \internal Result of ezWorkStealingDeque::Steal()
+enum class ezWorkStealResult
+{
+  Success,   ///< An item was stolen.
+  Empty,     ///< The deque was empty.
+  Contended, ///< Another thread took the item first. The deque may not be empty, so trying again may succeed.
+};
+
+/// \internal A fixed capacity, lock-free work-stealing deque (Chase-Lev).
+///
+/// Only the thread that owns the deque may call PushBottom() and PopBottom(). Any other thread may call Steal()
+/// to take items from the other end at the same time.
+/// Since a thief reads an item before it knows whether it won the race for it, T must be a POD type.
+/// The deque does not grow. PushBottom() returns false when it is full and the caller has to put the item elsewhere.
+template <typename T, ezUInt32 Capacity>
+class ezWorkStealingDeque
+{
+  EZ_DISALLOW_COPY_AND_ASSIGN(ezWorkStealingDeque);
+  EZ_CHECK_AT_COMPILETIME_MSG(ezMath::IsPowerOf2(Capacity), "Capacity must be a power of two.");
+
+public:
+  ezWorkStealingDeque() = default;
+
+  /// \brief Adds an item at the owner's end of the deque. Returns false, if the deque is full. Must only be called by the owning thread.
+  bool PushBottom(const T& item)
+  {
+    const ezInt64 b = m_iBottom;
+    const ezInt64 t = m_iTop;
+
+    if (b - t >= (ezInt64)Capacity)
+      return false;
+
+    m_Items[b & (Capacity - 1)] = item;
+
+    // publishes the item to thieves
+    m_iBottom.Set(b + 1);
+    return true;
+  }
+
+  /// \brief Takes the most recently pushed item. Returns false, if the deque is empty. Must only be called by the owning thread.
+  bool PopBottom(T& out_Item)
+  {
+    const ezInt64 b = m_iBottom - 1;
+
+    m_iBottom.Set(b);
+
+    // Set() is not guaranteed to be a full barrier (e.g. __sync_lock_test_and_set only has acquire semantics),
+    // but the store to m_iBottom must be visible before m_iTop is read, otherwise the owner and a thief may both take the last item
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    const ezInt64 t = m_iTop;
+
+    if (t > b)
+    {
+      // deque was empty, restore it
+      m_iBottom.Set(b + 1);
+      return false;
+    }
+
+    out_Item = m_Items[b & (Capacity - 1)];
+
+    if (t != b)
+    {
+      // more than one item left, no thief can reach this one
+      return true;
+    }
+
+    // this is the last item, race against the thieves for it
+    const bool bWon = m_iTop.TestAndSet(t, t + 1);
+    m_iBottom.Set(b + 1);
+    return bWon;
+  }
+
+  /// \brief Takes the oldest item from the deque. May be called by any thread.
+  ezWorkStealResult Steal(T& out_Item)
+  {
+    const ezInt64 t = m_iTop;
+
+    // pairs with the fence in PopBottom(), m_iTop has to be read before m_iBottom
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    const ezInt64 b = m_iBottom;
+
+    if (t >= b)
+      return ezWorkStealResult::Empty;
+
+    // the item may get overwritten by the owner in the mean time, but then the CAS below fails and the value is discarded
+    out_Item = m_Items[t & (Capacity - 1)];
+
+    if (!m_iTop.TestAndSet(t, t + 1))
+      return ezWorkStealResult::Contended;
+
+    return ezWorkStealResult::Success;
+  }
+
+  /// \brief Returns whether the deque currently contains no items. Only a snapshot when other threads access the deque at the same time.
+  bool IsEmpty() const { return m_iTop >= m_iBottom; }
+
+private:
+  ezAtomicInteger64 m_iTop;
+
+  // keep the end that thieves modify and the one that the owner modifies on separate cache lines
+  ezUInt8 m_Padding[64 - sizeof(ezAtomicInteger64)];
+
+  ezAtomicInteger64 m_iBottom;
+  T m_Items[Capacity];
+};
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <Foundation/Threading/TaskSystem.h>
+
+/// \brief Base class for tasks that wait for other task groups without blocking the thread that executes them.
+///
+/// Calling ezTaskSystem::WaitForGroup() from within a task either keeps the worker thread busy with other tasks
+/// or puts it to sleep. A suspendable task instead calls SuspendUntil() with the group that it needs to wait for
+/// and returns from Execute(). The worker thread is then free to run other tasks, and once the group has finished,
+/// the task system calls Execute() again, potentially on another thread.
+///
+/// Since this is the equivalent of a stackless coroutine, all state that is needed after resuming must be stored in the task.
+/// GetResumeCount() tells at which point the task continues, so Execute() is typically a switch over it.
+/// The group that the task belongs to only finishes once Execute() returns without calling SuspendUntil().
+///
+/// Suspendable tasks never block, so they can be configured with ezTaskNesting::Never.
+/// They cannot use multiplicity.
+class ezSuspendableTask : public ezTask
+{
+protected:
+  /// \brief Makes the task wait for \a group to finish, once Execute() returns. Execute() is then called again with an incremented resume count.
+  ///
+  /// If the group has already finished by the time Execute() returns, the task continues right away.
+  void SuspendUntil(ezTaskGroupID group)
+  {
+    EZ_ASSERT_DEV(group.IsValid(), "Invalid task group.");
+    EZ_ASSERT_DEV(!m_bUsesMultiplicity, "Tasks with multiplicity cannot be suspended.");
+    EZ_ASSERT_DEV(group != m_BelongsToGroup, "A task cannot wait for its own group.");
+
+    m_ResumeAfterGroup = group;
+  }
+
+  /// \brief Returns how often Execute() has been called again after the task was suspended. Zero on the first call.
+  ezUInt32 GetResumeCount() const { return m_uiResumeCount; }
+};
@@ -86,10 +86,38 @@ private:
   static TaskData GetNextTask(ezTaskPriority::Enum FirstPriority, ezTaskPriority::Enum LastPriority, bool bOnlyTasksThatNeverWait,
     const ezTaskGroupID& WaitingForGroup, ezAtomicInteger32* pWorkerState);
 
+  /// \brief Searches the global task lists for a task of priority between \a FirstPriority and \a LastPriority (inclusive).
+  ///
+  /// If none is found and \a pWorkerState is given, the worker is set to idle.
+  static TaskData GetNextGlobalTask(ezTaskPriority::Enum FirstPriority, ezTaskPriority::Enum LastPriority, bool bOnlyTasksThatNeverWait,
+    const ezTaskGroupID& WaitingForGroup, ezAtomicInteger32* pWorkerState);
+
+  /// \brief Pops a task of the given priority from the calling thread's local queue, or steals one from another thread.
+  static bool GetNextLocalTask(
+    ezTaskPriority::Enum Priority, bool bOnlyTasksThatNeverWait, const ezTaskGroupID& WaitingForGroup, TaskData& out_Task);
+
+  /// \brief Returns whether any thread currently has tasks in its local queues.
+  static bool AreLocalTasksQueued();
+
+  /// \brief Moves all tasks from the given local queues into the global task lists. s_TaskSystemMutex must be locked.
+  static void SpillLocalQueues(ezTaskLocalQueues& queues);
+
+  /// \brief Appends a task to the global list of the given priority. s_TaskSystemMutex must be locked.
+  static void AddTaskToGlobalQueue(ezTaskPriority::Enum Priority, const TaskData& td, bool bHighPriority);
+
+  /// \brief Removes a task from the global list of the given priority. s_TaskSystemMutex must be locked.
+  static void RemoveTaskFromGlobalQueue(ezTaskPriority::Enum Priority, ezList<TaskData>::Iterator it);
+
   /// \brief Executes some task of priority between \a FirstPriority and \a LastPriority (inclusive). Returns true, if any such task was available.
   static bool ExecuteTask(ezTaskPriority::Enum FirstPriority, ezTaskPriority::Enum LastPriority, bool bOnlyTasksThatNeverWait,
     const ezTaskGroupID& WaitingForGroup, ezAtomicInteger32* pWorkerState);
 
+  /// \brief Runs the given task and notifies its group afterwards. Suspends the task instead, if it has to wait for another group.
+  static void RunTask(const TaskData& td);
+
+  /// \brief Starts a group that resumes the given task once the group that it waits for has finished.
+  static void SuspendTask(const TaskData& td);
+
   /// \brief Called whenever a task has been finished/canceled. Makes sure that groups are marked as finished when all tasks are done.
   static void TaskHasFinished(const ezSharedPtr<ezTask>& pTask, ezTaskGroup* pGroup);
 
@@ -158,6 +186,9 @@ public:
   /// If you need to wait for some other task to finish, this should always be the preferred method to do so.
   /// WaitForGroup will put the current thread to sleep and use thread signals to only wake it up again once the group is indeed
   /// finished. This is the most efficient way to wait for a task.
+  ///
+  /// Tasks that need to wait for other groups in the middle of their work can derive from ezSuspendableTask instead,
+  /// which frees the worker thread while waiting, rather than blocking it.
   static void WaitForGroup(ezTaskGroupID Group); // [tested]
 
   /// \brief Blocks the current thread until the given delegate returns true.
@@ -185,7 +216,8 @@ public:
   /// \brief Sets the number of threads to use for the different task categories.
   ///
   /// \a uiShortTasks and \a uiLongTasks must be at least 1 and should not exceed the number of available CPU cores.
-  /// There will always be exactly one additional thread for file access tasks (ezTaskPriority::FileAccess).
+  /// Additionally there are \a iFileAccessTasks threads for file access tasks (ezTaskPriority::FileAccess), by default exactly one.
+  /// More than one file access thread allows to read several files at the same time, e.g. for parallel resource loading.
   ///
   /// If \a uiShortTasks or \a uiLongTasks is smaller than 1, a default number of threads will be used for that type of work.
   /// This number of threads depends on the number of available CPU cores.
@@ -193,7 +225,7 @@ public:
   /// this default configuration.
   /// Unless you have a good idea how to set up the number of worker threads to make good use of the available cores,
   /// it is a good idea to just use the default settings.
-  static void SetWorkerThreadCount(ezInt32 iShortTasks = -1, ezInt32 iLongTasks = -1); // [tested]
+  static void SetWorkerThreadCount(ezInt32 iShortTasks = -1, ezInt32 iLongTasks = -1, ezInt32 iFileAccessTasks = -1); // [tested]
 
   /// \brief Returns the maximum number of threads that should work on the given type of task at the same time.
   static ezUInt32 GetWorkerThreadCount(ezWorkerThreadType::Enum type);
@@ -208,6 +240,21 @@ public:
   /// \brief Returns the (thread local) type of tasks that would be executed on this thread
   static ezWorkerThreadType::Enum GetCurrentThreadWorkerType();
 
+  /// \brief Selects to which logical processors the worker threads are pinned. Restarts all worker threads.
+  ///
+  /// With ezWorkerThreadAffinity::Compact or ezWorkerThreadAffinity::Scatter every short task worker is pinned to a single logical processor,
+  /// in the order that ezSystemInformation::GetCPUTopology() suggests. Workers that steal tasks in ezTaskSchedulingMode::WorkStealing then
+  /// prefer threads that share their last level cache, such that the chunks of a ParallelFor() mostly stay on workers that share a cache.
+  ///
+  /// If \a bReserveMainThreadCore is true, the calling thread is pinned to the physical core of the first logical processor and no worker
+  /// thread runs on that core. Long task and file access workers are never pinned to single processors, but also stay off the reserved core.
+  ///
+  /// Must be called from the main thread.
+  static void SetWorkerThreadAffinity(ezWorkerThreadAffinity::Enum affinity, bool bReserveMainThreadCore = false);
+
+  /// \brief Returns the affinity that was set through SetWorkerThreadAffinity().
+  static ezWorkerThreadAffinity::Enum GetWorkerThreadAffinity();
+
   /// \brief Returns the utilization (0.0 to 1.0) of the given thread. Note: This will only be valid, if FinishFrameTasks() is called once
   /// per frame.
   ///
@@ -216,6 +263,7 @@ public:
 
 private:
   friend class ezTaskWorkerThread;
+  friend class ezTaskResumption;
 
   /// \brief Allocates \a uiAddThreads additional threads of \a type
   static void AllocateThreads(ezWorkerThreadType::Enum type, ezUInt32 uiAddThreads);
@@ -226,6 +274,12 @@ private:
   /// \brief Shuts down all worker threads. Does NOT finish the remaining tasks that were not started yet. Does not clear them either, though.
   static void StopWorkerThreads();
 
+  /// \brief Computes the logical processors that the worker threads get pinned to, according to the current affinity settings.
+  static void ComputeWorkerThreadProcessors();
+
+  /// \brief Pins the calling worker thread according to the current affinity settings. Returns the cache group of the processor, if it is pinned to a single one.
+  static ezUInt16 ApplyWorkerThreadAffinity(ezWorkerThreadType::Enum type, ezUInt32 uiWorkerIndex);
+
   /// \brief Uses a thread local variable to know the current thread type and to decide the range of task priorities that it may execute
   static void DetermineTasksToExecuteOnThread(ezTaskPriority::Enum& out_FirstPriority, ezTaskPriority::Enum& out_LastPriority);
 
@@ -271,6 +325,10 @@ private:
   static void ParallelForInternal(
     ezArrayPtr<ElemType> taskItems, ezParallelForFunction<ElemType> taskCallback, const char* taskName, const ezParallelForParams& config);
 
+  /// Implements ParallelForIndexed() for ezParallelForParams::bAdaptiveGranularity.
+  static void ParallelForIndexedAdaptive(ezUInt32 uiStartIndex, ezUInt32 uiNumItems, ezParallelForIndexedFunction taskCallback,
+    const char* taskName, const ezParallelForParams& params);
+
   ///@}
 
   /// \name Utilities
@@ -296,6 +354,22 @@ public:
   /// \see FinishFrameTasks() for more details.
   static void SetTargetFrameTime(ezTime targetFrameTime = ezTime::Seconds(1.0 / 40.0) /* 40 FPS -> 25 ms */);
 
+  /// \brief Selects how tasks of the 'this frame' priorities are distributed to the worker threads.
+  ///
+  /// With ezTaskSchedulingMode::WorkStealing, every short task worker and the main thread put the 'this frame' tasks that they start
+  /// into their own lock-free queue and idle workers steal from the queues of other threads. This avoids contention on the task system
+  /// mutex when many small tasks are started and executed in parallel, e.g. through ParallelFor().
+  /// Tasks that are started from other threads, as well as all other priorities, still go through the global queues.
+  ///
+  /// In this mode CancelTask() cannot remove a task from a local queue. Such a task is treated as if it was already running,
+  /// but since its cancel flag is set, it will not execute once it is dequeued.
+  ///
+  /// The mode should only be switched while no tasks are being started on other threads, e.g. right after startup.
+  static void SetSchedulingMode(ezTaskSchedulingMode::Enum mode);
+
+  /// \brief Returns the mode that was set through SetSchedulingMode().
+  static ezTaskSchedulingMode::Enum GetSchedulingMode();
+
 private:
   EZ_MAKE_SUBSYSTEM_STARTUP_FRIEND(Foundation, TaskSystem);
 
@@ -2,6 +2,7 @@
 
 #include <Foundation/Basics.h>
 #include <Foundation/Threading/Implementation/ThreadingDeclarations.h>
+#include <Foundation/Types/ArrayPtr.h>
 
 struct ezTime;
 class ezThread;
@@ -25,6 +26,13 @@ public:
   /// \brief Returns an identifier for the currently running thread.
   static ezThreadID GetCurrentThreadID();
 
+  /// \brief Restricts the current thread to run only on the given logical processors.
+  ///
+  /// The processors are identified by their OS index, see ezCPUTopology::LogicalProcessor::m_uiOSIndex.
+  /// An empty list allows the thread to run on all processors again.
+  /// Returns EZ_FAILURE, if the platform does not support this or the OS rejected the request.
+  static ezResult SetCurrentThreadAffinity(ezArrayPtr<const ezUInt32> logicalProcessors);
+
 private:
   EZ_MAKE_SUBSYSTEM_STARTUP_FRIEND(Foundation, ThreadUtils);
 
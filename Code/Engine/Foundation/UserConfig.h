@@ -75,6 +75,11 @@
 #    endif
 #  endif
 
+// Uncomment to only sample allocations instead of tracking every one of them. This is fast enough for long running tests,
+// use ezMemoryTracker::CaptureHeapProfile to find out where memory is held.
+//#undef EZ_USE_ALLOCATION_SAMPLING
+//#define EZ_USE_ALLOCATION_SAMPLING EZ_ON
+
 // Uncomment to use guarded allocations. This will use a lot of memory and should only be used in 64bit builds.
 //#undef EZ_USE_GUARDED_ALLOCATIONS
 //#define EZ_USE_GUARDED_ALLOCATIONS EZ_ON
@@ -0,0 +1,103 @@
+#include <RendererCorePCH.h>
+
+#include <Core/Messages/UpdateLocalBoundsMessage.h>
+#include <Core/WorldSerializer/WorldReader.h>
+#include <Core/WorldSerializer/WorldWriter.h>
+#include <RendererCore/Components/OccluderComponent.h>
+#include <RendererCore/Culling/OcclusionBuffer.h>
+
+// clang-format off
+EZ_BEGIN_COMPONENT_TYPE(ezOccluderComponent, 1, ezComponentMode::Static)
+{
+  EZ_BEGIN_PROPERTIES
+  {
+    EZ_ACCESSOR_PROPERTY("Extents", GetExtents, SetExtents)->AddAttributes(new ezDefaultValueAttribute(ezVec3(1.0f)), new ezClampValueAttribute(ezVec3(0), ezVariant())),
+  }
+  EZ_END_PROPERTIES;
+  EZ_BEGIN_MESSAGEHANDLERS
+  {
+    EZ_MESSAGE_HANDLER(ezMsgUpdateLocalBounds, OnUpdateLocalBounds),
+  }
+  EZ_END_MESSAGEHANDLERS;
+  EZ_BEGIN_ATTRIBUTES
+  {
+    new ezCategoryAttribute("Rendering"),
+    new ezBoxManipulatorAttribute("Extents"),
+    new ezBoxVisualizerAttribute("Extents"),
+  }
+  EZ_END_ATTRIBUTES;
+}
+EZ_END_COMPONENT_TYPE
+// clang-format on
+
+namespace
+{
+  static const ezVec3 s_BoxVertices[] = {ezVec3(-0.5f, -0.5f, -0.5f), ezVec3(0.5f, -0.5f, -0.5f), ezVec3(-0.5f, 0.5f, -0.5f),
+    ezVec3(0.5f, 0.5f, -0.5f), ezVec3(-0.5f, -0.5f, 0.5f), ezVec3(0.5f, -0.5f, 0.5f), ezVec3(-0.5f, 0.5f, 0.5f), ezVec3(0.5f, 0.5f, 0.5f)};
+
+  static const ezUInt16 s_BoxIndices[] = {0, 2, 1, 1, 2, 3, 4, 5, 6, 5, 7, 6, 0, 1, 4, 1, 5, 4, 2, 6, 3, 3, 6, 7, 0, 4, 2, 2, 4, 6, 1, 3, 5, 3,
+    7, 5};
+} // namespace
+
+ezOccluderComponent::ezOccluderComponent() = default;
+ezOccluderComponent::~ezOccluderComponent() = default;
+
+void ezOccluderComponent::OnActivated()
+{
+  GetOwner()->UpdateLocalBounds();
+}
+
+void ezOccluderComponent::OnDeactivated()
+{
+  GetOwner()->UpdateLocalBounds();
+}
+
+void ezOccluderComponent::SetExtents(const ezVec3& value)
+{
+  m_vExtents = value.CompMax(ezVec3::ZeroVector());
+
+  if (IsActiveAndInitialized())
+  {
+    GetOwner()->UpdateLocalBounds();
+  }
+}
+
+void ezOccluderComponent::RasterizeOccluder(ezOcclusionBuffer& buffer) const
+{
+  ezMat4 scale;
+  scale.SetScalingMatrix(m_vExtents);
+
+  buffer.RasterizeTriangles(GetOwner()->GetGlobalTransform().GetAsMat4() * scale, ezMakeArrayPtr(s_BoxVertices), ezMakeArrayPtr(s_BoxIndices));
+}
+
+// static
+ezSpatialData::Category ezOccluderComponent::GetSpatialCategory()
+{
+  static ezSpatialData::Category s_Category = ezSpatialData::RegisterCategory("Occluder");
+  return s_Category;
+}
+
+void ezOccluderComponent::OnUpdateLocalBounds(ezMsgUpdateLocalBounds& msg) const
+{
+  msg.AddBounds(ezBoundingBox(-m_vExtents * 0.5f, m_vExtents * 0.5f), GetSpatialCategory());
+}
+
+void ezOccluderComponent::SerializeComponent(ezWorldWriter& stream) const
+{
+  SUPER::SerializeComponent(stream);
+
+  ezStreamWriter& s = stream.GetStream();
+
+  s << m_vExtents;
+}
+
+void ezOccluderComponent::DeserializeComponent(ezWorldReader& stream)
+{
+  SUPER::DeserializeComponent(stream);
+  // const ezUInt32 uiVersion = stream.GetComponentTypeVersion(GetStaticRTTI());
+  ezStreamReader& s = stream.GetStream();
+
+  s >> m_vExtents;
+}
+
+EZ_STATICLINK_FILE(RendererCore, RendererCore_Components_Implementation_OccluderComponent);
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <Core/World/World.h>
+#include <RendererCore/RendererCoreDLL.h>
+
+struct ezMsgUpdateLocalBounds;
+class ezOcclusionBuffer;
+
+typedef ezComponentManager<class ezOccluderComponent, ezBlockStorageType::Compact> ezOccluderComponentManager;
+
+/// \brief Adds an invisible box to the scene that hides everything behind it from views that have occlusion culling enabled.
+///
+/// Occluders should only be placed inside of solid geometry like walls or large rocks, everything behind them is culled
+/// even if the actual geometry has holes.
+class EZ_RENDERERCORE_DLL ezOccluderComponent : public ezComponent
+{
+  EZ_DECLARE_COMPONENT_TYPE(ezOccluderComponent, ezComponent, ezOccluderComponentManager);
+
+  //////////////////////////////////////////////////////////////////////////
+  // ezComponent
+
+public:
+  virtual void SerializeComponent(ezWorldWriter& stream) const override;
+  virtual void DeserializeComponent(ezWorldReader& stream) override;
+
+protected:
+  virtual void OnActivated() override;
+  virtual void OnDeactivated() override;
+
+
+  //////////////////////////////////////////////////////////////////////////
+  // ezOccluderComponent
+
+public:
+  ezOccluderComponent();
+  ~ezOccluderComponent();
+
+  void SetExtents(const ezVec3& value);                   // [ property ]
+  const ezVec3& GetExtents() const { return m_vExtents; } // [ property ]
+
+  /// \brief Rasterizes the occluder box with the current global transform of the owner.
+  void RasterizeOccluder(ezOcclusionBuffer& buffer) const;
+
+  /// \brief The spatial category that all occluders are sorted into, used to find the occluders that are relevant for a view.
+  static ezSpatialData::Category GetSpatialCategory();
+
+protected:
+  void OnUpdateLocalBounds(ezMsgUpdateLocalBounds& msg) const;
+
+  ezVec3 m_vExtents = ezVec3(1.0f);
+};
@@ -0,0 +1,329 @@
+#include <RendererCorePCH.h>
+
+#include <Foundation/SimdMath/SimdConversion.h>
+#include <RendererCore/Culling/OcclusionBuffer.h>
+
+ezOcclusionBuffer::ezOcclusionBuffer()
+{
+  SetResolution(256, 128);
+  BeginFrame(ezMat4::IdentityMatrix());
+}
+
+ezOcclusionBuffer::~ezOcclusionBuffer() = default;
+
+EZ_ALWAYS_INLINE ezSimdVec4f ezOcclusionBuffer::ToScreen(const ezSimdVec4f& clipPos) const
+{
+  return ezSimdVec4f::MulAdd(clipPos / clipPos.w(), m_ScreenScale, m_ScreenOffset);
+}
+
+void ezOcclusionBuffer::SetResolution(ezUInt32 uiWidth, ezUInt32 uiHeight)
+{
+  m_uiWidth = ezMemoryUtils::AlignSize<ezUInt32>(ezMath::Max<ezUInt32>(uiWidth, TILE_SIZE), TILE_SIZE);
+  m_uiHeight = ezMemoryUtils::AlignSize<ezUInt32>(ezMath::Max<ezUInt32>(uiHeight, TILE_SIZE), TILE_SIZE);
+  m_uiNumTilesX = m_uiWidth / TILE_SIZE;
+  m_uiNumTilesY = m_uiHeight / TILE_SIZE;
+
+  m_Depth.SetCountUninitialized(m_uiWidth * m_uiHeight);
+  m_TileMaxDepth.SetCountUninitialized(m_uiNumTilesX * m_uiNumTilesY);
+
+  const float fHalfWidth = m_uiWidth * 0.5f;
+  const float fHalfHeight = m_uiHeight * 0.5f;
+  m_ScreenScale.Set(fHalfWidth, fHalfHeight, 1.0f, 0.0f);
+  m_ScreenOffset.Set(fHalfWidth, fHalfHeight, 0.0f, 0.0f);
+}
+
+void ezOcclusionBuffer::BeginFrame(const ezMat4& viewProjectionMatrix, ezClipSpaceDepthRange::Enum depthRange)
+{
+  m_BeginTime = ezTime::Now();
+  m_Stats = Stats();
+
+  m_ViewProjection = ezSimdConversion::ToMat4(viewProjectionMatrix);
+
+  if (depthRange == ezClipSpaceDepthRange::MinusOneToOne)
+  {
+    m_NearPlane.Set(0.0f, 0.0f, 1.0f, 1.0f);
+  }
+  else
+  {
+    m_NearPlane.Set(0.0f, 0.0f, 1.0f, 0.0f);
+  }
+
+  const float fFarAway = ezMath::MaxValue<float>();
+  for (float& fDepth : m_Depth)
+  {
+    fDepth = fFarAway;
+  }
+
+  for (float& fDepth : m_TileMaxDepth)
+  {
+    fDepth = fFarAway;
+  }
+}
+
+void ezOcclusionBuffer::RasterizeTriangles(const ezMat4& transform, ezArrayPtr<const ezVec3> vertices, ezArrayPtr<const ezUInt16> indices)
+{
+  EZ_ASSERT_DEV(indices.GetCount() % 3 == 0, "Invalid number of indices");
+
+  m_Stats.m_uiNumOccluders++;
+
+  const ezSimdMat4f modelViewProjection = m_ViewProjection * ezSimdConversion::ToMat4(transform);
+
+  m_ClipPositions.SetCountUninitialized(vertices.GetCount());
+  for (ezUInt32 i = 0; i < vertices.GetCount(); ++i)
+  {
+    m_ClipPositions[i] = modelViewProjection.TransformPosition(ezSimdConversion::ToVec3(vertices[i]));
+  }
+
+  for (ezUInt32 i = 0; i < indices.GetCount(); i += 3)
+  {
+    ClipAndRasterizeTriangle(m_ClipPositions[indices[i]], m_ClipPositions[indices[i + 1]], m_ClipPositions[indices[i + 2]]);
+  }
+}
+
+void ezOcclusionBuffer::EndRasterization()
+{
+  for (ezUInt32 uiTileY = 0; uiTileY < m_uiNumTilesY; ++uiTileY)
+  {
+    for (ezUInt32 uiTileX = 0; uiTileX < m_uiNumTilesX; ++uiTileX)
+    {
+      const float* pTile = m_Depth.GetData() + (uiTileY * TILE_SIZE * m_uiWidth) + uiTileX * TILE_SIZE;
+
+      ezSimdVec4f maxDepth = ezSimdVec4f::ZeroVector();
+      for (ezUInt32 y = 0; y < TILE_SIZE; ++y)
+      {
+        const float* pRow = pTile + y * m_uiWidth;
+
+        ezSimdVec4f a, b;
+        a.Load<4>(pRow);
+        b.Load<4>(pRow + 4);
+        maxDepth = maxDepth.CompMax(a).CompMax(b);
+      }
+
+      m_TileMaxDepth[uiTileY * m_uiNumTilesX + uiTileX] = maxDepth.HorizontalMax<4>();
+    }
+  }
+
+  m_Stats.m_RasterTime = ezTime::Now() - m_BeginTime;
+}
+
+bool ezOcclusionBuffer::IsOccluded(const ezSimdBBox& box) const
+{
+  const ezSimdVec4f xMin = m_ViewProjection.m_col0 * box.m_Min.x();
+  const ezSimdVec4f xMax = m_ViewProjection.m_col0 * box.m_Max.x();
+  const ezSimdVec4f yMin = m_ViewProjection.m_col1 * box.m_Min.y();
+  const ezSimdVec4f yMax = m_ViewProjection.m_col1 * box.m_Max.y();
+  const ezSimdVec4f zMin = m_ViewProjection.m_col2 * box.m_Min.z() + m_ViewProjection.m_col3;
+  const ezSimdVec4f zMax = m_ViewProjection.m_col2 * box.m_Max.z() + m_ViewProjection.m_col3;
+
+  ezSimdVec4f screenMin(ezMath::MaxValue<float>());
+  ezSimdVec4f screenMax(-ezMath::MaxValue<float>());
+
+  for (ezUInt32 i = 0; i < 8; ++i)
+  {
+    const ezSimdVec4f clipPos = ((i & 1) ? xMax : xMin) + ((i & 2) ? yMax : yMin) + ((i & 4) ? zMax : zMin);
+
+    // we don't know where a box ends up on screen if it crosses the near plane
+    if (clipPos.Dot<4>(m_NearPlane) < ezSimdFloat::Zero())
+      return false;
+
+    const ezSimdVec4f screenPos = ToScreen(clipPos);
+    screenMin = screenMin.CompMin(screenPos);
+    screenMax = screenMax.CompMax(screenPos);
+  }
+
+  float fScreenMin[4];
+  float fScreenMax[4];
+  screenMin.Store<4>(fScreenMin);
+  screenMax.Store<4>(fScreenMax);
+
+  // all pixels that the box touches
+  const float fMaxX = (float)(m_uiWidth - 1);
+  const float fMaxY = (float)(m_uiHeight - 1);
+  if (fScreenMax[0] < 0.0f || fScreenMax[1] < 0.0f || fScreenMin[0] > fMaxX + 1.0f || fScreenMin[1] > fMaxY + 1.0f)
+    return false;
+
+  const ezUInt32 uiMinX = (ezUInt32)ezMath::Clamp(fScreenMin[0], 0.0f, fMaxX);
+  const ezUInt32 uiMinY = (ezUInt32)ezMath::Clamp(fScreenMin[1], 0.0f, fMaxY);
+  const ezUInt32 uiMaxX = (ezUInt32)ezMath::Clamp(fScreenMax[0], 0.0f, fMaxX);
+  const ezUInt32 uiMaxY = (ezUInt32)ezMath::Clamp(fScreenMax[1], 0.0f, fMaxY);
+  const float fBoxDepth = fScreenMin[2];
+
+  for (ezUInt32 uiTileY = uiMinY / TILE_SIZE; uiTileY <= uiMaxY / TILE_SIZE; ++uiTileY)
+  {
+    for (ezUInt32 uiTileX = uiMinX / TILE_SIZE; uiTileX <= uiMaxX / TILE_SIZE; ++uiTileX)
+    {
+      // every pixel in this tile is in front of the box
+      if (m_TileMaxDepth[uiTileY * m_uiNumTilesX + uiTileX] < fBoxDepth)
+        continue;
+
+      const ezUInt32 uiStartX = ezMath::Max(uiMinX, uiTileX * TILE_SIZE);
+      const ezUInt32 uiEndX = ezMath::Min(uiMaxX, uiTileX * TILE_SIZE + TILE_SIZE - 1);
+      const ezUInt32 uiStartY = ezMath::Max(uiMinY, uiTileY * TILE_SIZE);
+      const ezUInt32 uiEndY = ezMath::Min(uiMaxY, uiTileY * TILE_SIZE + TILE_SIZE - 1);
+
+      for (ezUInt32 y = uiStartY; y <= uiEndY; ++y)
+      {
+        const float* pRow = m_Depth.GetData() + y * m_uiWidth;
+        for (ezUInt32 x = uiStartX; x <= uiEndX; ++x)
+        {
+          if (pRow[x] >= fBoxDepth)
+            return false;
+        }
+      }
+    }
+  }
+
+  return true;
+}
+
+void ezOcclusionBuffer::ClipAndRasterizeTriangle(const ezSimdVec4f& v0, const ezSimdVec4f& v1, const ezSimdVec4f& v2)
+{
+  const ezSimdVec4f vertices[3] = {v0, v1, v2};
+  ezSimdFloat distances[3];
+
+  ezUInt32 uiNumInFront = 0;
+  for (ezUInt32 i = 0; i < 3; ++i)
+  {
+    distances[i] = vertices[i].Dot<4>(m_NearPlane);
+    uiNumInFront += distances[i] >= ezSimdFloat::Zero() ? 1 : 0;
+  }
+
+  if (uiNumInFront == 0)
+    return;
+
+  if (uiNumInFront == 3)
+  {
+    RasterizeTriangle(ToScreen(v0), ToScreen(v1), ToScreen(v2));
+    return;
+  }
+
+  // Clipping a triangle at a single plane results in a triangle or a quad.
+  ezSimdVec4f clipped[4];
+  ezUInt32 uiNumClipped = 0;
+
+  for (ezUInt32 i = 0; i < 3; ++i)
+  {
+    const ezUInt32 uiNext = (i + 1) % 3;
+    const bool bInFront = distances[i] >= ezSimdFloat::Zero();
+
+    if (bInFront)
+    {
+      clipped[uiNumClipped++] = ToScreen(vertices[i]);
+    }
+
+    if (bInFront != (distances[uiNext] >= ezSimdFloat::Zero()))
+    {
+      const ezSimdFloat t = distances[i] / (distances[i] - distances[uiNext]);
+      clipped[uiNumClipped++] = ToScreen(ezSimdVec4f::Lerp(vertices[i], vertices[uiNext], ezSimdVec4f(t)));
+    }
+  }
+
+  for (ezUInt32 i = 2; i < uiNumClipped; ++i)
+  {
+    RasterizeTriangle(clipped[0], clipped[i - 1], clipped[i]);
+  }
+}
+
+void ezOcclusionBuffer::RasterizeTriangle(const ezSimdVec4f& s0, const ezSimdVec4f& s1, const ezSimdVec4f& s2)
+{
+  float v0[4], v1[4], v2[4];
+  s0.Store<4>(v0);
+  s1.Store<4>(v1);
+  s2.Store<4>(v2);
+
+  float x0 = v0[0], y0 = v0[1], z0 = v0[2];
+  float x1 = v1[0], y1 = v1[1], z1 = v1[2];
+  float x2 = v2[0], y2 = v2[1], z2 = v2[2];
+
+  float fArea = (x1 - x0) * (y2 - y0) - (y1 - y0) * (x2 - x0);
+  if (fArea == 0.0f)
+    return;
+
+  // both sides are rasterized, so make sure the vertices are always in counter-clockwise order
+  if (fArea < 0.0f)
+  {
+    ezMath::Swap(x1, x2);
+    ezMath::Swap(y1, y2);
+    ezMath::Swap(z1, z2);
+    fArea = -fArea;
+  }
+
+  // pixel centers are at .5, only pixels whose centers are inside the bounding rectangle can be covered
+  const float fMaxX = (float)(m_uiWidth - 1);
+  const float fMaxY = (float)(m_uiHeight - 1);
+  const float fMinCenterX = ezMath::Ceil(ezMath::Clamp(ezMath::Min(x0, x1, x2) - 0.5f, 0.0f, fMaxX + 1.0f));
+  const float fMinCenterY = ezMath::Ceil(ezMath::Clamp(ezMath::Min(y0, y1, y2) - 0.5f, 0.0f, fMaxY + 1.0f));
+  const float fMaxCenterX = ezMath::Floor(ezMath::Clamp(ezMath::Max(x0, x1, x2) - 0.5f, -1.0f, fMaxX));
+  const float fMaxCenterY = ezMath::Floor(ezMath::Clamp(ezMath::Max(y0, y1, y2) - 0.5f, -1.0f, fMaxY));
+
+  if (fMinCenterX > fMaxCenterX || fMinCenterY > fMaxCenterY)
+    return;
+
+  m_Stats.m_uiNumTrianglesRasterized++;
+
+  // 4 pixels are processed at once, so the first one has to be aligned to that
+  const ezUInt32 uiMinX = ((ezUInt32)fMinCenterX) & ~3u;
+  const ezUInt32 uiMaxX = (ezUInt32)fMaxCenterX;
+  const ezUInt32 uiMinY = (ezUInt32)fMinCenterY;
+  const ezUInt32 uiMaxY = (ezUInt32)fMaxCenterY;
+
+  // Edge functions relative to their start vertex to keep the precision for vertices that are far off screen.
+  // They are positive on the inside of the triangle.
+  const float a0 = y1 - y2, b0 = x2 - x1;
+  const float a1 = y2 - y0, b1 = x0 - x2;
+  const float a2 = y0 - y1, b2 = x1 - x0;
+
+  // Every edge is moved outwards by a tiny fraction of a pixel, otherwise pixels whose centers are exactly on an edge that is shared
+  // by two triangles would be missed by both of them due to rounding and the occluder would have cracks.
+  const float fEdgeBias = 1.0f / 256.0f;
+  const float bias0 = (ezMath::Abs(a0) + ezMath::Abs(b0)) * fEdgeBias;
+  const float bias1 = (ezMath::Abs(a1) + ezMath::Abs(b1)) * fEdgeBias;
+  const float bias2 = (ezMath::Abs(a2) + ezMath::Abs(b2)) * fEdgeBias;
+
+  const float fInvArea = 1.0f / fArea;
+  const float fDepthDx = (a1 * (z1 - z0) + a2 * (z2 - z0)) * fInvArea;
+  const float fDepthDy = (b1 * (z1 - z0) + b2 * (z2 - z0)) * fInvArea;
+
+  const ezSimdVec4f pixelX = ezSimdVec4f((float)uiMinX) + ezSimdVec4f(0.5f, 1.5f, 2.5f, 3.5f);
+
+  const ezSimdVec4f edge0X = ezSimdVec4f::MulAdd(ezSimdVec4f(a0), pixelX - ezSimdVec4f(x1), ezSimdVec4f(bias0));
+  const ezSimdVec4f edge1X = ezSimdVec4f::MulAdd(ezSimdVec4f(a1), pixelX - ezSimdVec4f(x2), ezSimdVec4f(bias1));
+  const ezSimdVec4f edge2X = ezSimdVec4f::MulAdd(ezSimdVec4f(a2), pixelX - ezSimdVec4f(x0), ezSimdVec4f(bias2));
+  const ezSimdVec4f depthX = ezSimdVec4f::MulAdd(ezSimdVec4f(fDepthDx), pixelX - ezSimdVec4f(x0), ezSimdVec4f(z0));
+
+  const ezSimdVec4f edge0Step(a0 * 4.0f);
+  const ezSimdVec4f edge1Step(a1 * 4.0f);
+  const ezSimdVec4f edge2Step(a2 * 4.0f);
+  const ezSimdVec4f depthStep(fDepthDx * 4.0f);
+  const ezSimdVec4f zero = ezSimdVec4f::ZeroVector();
+
+  for (ezUInt32 y = uiMinY; y <= uiMaxY; ++y)
+  {
+    const float fPixelY = y + 0.5f;
+
+    ezSimdVec4f edge0 = edge0X + ezSimdVec4f(b0 * (fPixelY - y1));
+    ezSimdVec4f edge1 = edge1X + ezSimdVec4f(b1 * (fPixelY - y2));
+    ezSimdVec4f edge2 = edge2X + ezSimdVec4f(b2 * (fPixelY - y0));
+    ezSimdVec4f depth = depthX + ezSimdVec4f(fDepthDy * (fPixelY - y0));
+
+    float* pRow = m_Depth.GetData() + y * m_uiWidth;
+
+    for (ezUInt32 x = uiMinX; x <= uiMaxX; x += 4)
+    {
+      const ezSimdVec4b inside = (edge0 > zero) && (edge1 > zero) && (edge2 > zero);
+      if (inside.AnySet<4>())
+      {
+        ezSimdVec4f oldDepth;
+        oldDepth.Load<4>(pRow + x);
+        ezSimdVec4f::Select(inside, oldDepth.CompMin(depth), oldDepth).Store<4>(pRow + x);
+      }
+
+      edge0 += edge0Step;
+      edge1 += edge1Step;
+      edge2 += edge2Step;
+      depth += depthStep;
+    }
+  }
+}
+
+EZ_STATICLINK_FILE(RendererCore, RendererCore_Culling_Implementation_OcclusionBuffer);
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <Foundation/Containers/DynamicArray.h>
+#include <Foundation/Math/Mat4.h>
+#include <Foundation/SimdMath/SimdBBox.h>
+#include <Foundation/SimdMath/SimdMat4f.h>
+#include <Foundation/Time/Time.h>
+#include <RendererCore/RendererCoreDLL.h>
+
+/// \brief A low resolution depth buffer that occluders are rasterized into on the CPU, used to find objects that are hidden behind them.
+///
+/// Usage per frame: call BeginFrame() with the view-projection matrix of the camera, rasterize all occluders with RasterizeTriangles()
+/// and then call EndRasterization(). Afterwards IsOccluded() can be used to test arbitrary boxes against the rasterized occluders.
+///
+/// Occluders are rasterized 4 pixels at a time. For every tile of 8x8 pixels the farthest depth is stored as well,
+/// so most boxes can be rejected or accepted by only looking at a few tiles.
+/// Occluders only cover pixels whose centers they contain and boxes are tested against all pixels they touch, so a box is only reported
+/// as occluded if it is completely hidden at the resolution of the buffer.
+class EZ_RENDERERCORE_DLL ezOcclusionBuffer
+{
+public:
+  enum
+  {
+    TILE_SIZE = 8
+  };
+
+  struct Stats
+  {
+    ezUInt32 m_uiNumOccluders = 0;
+    ezUInt32 m_uiNumTrianglesRasterized = 0; ///< Number of triangles that were not completely clipped or behind the camera.
+    ezTime m_RasterTime;                     ///< Time between BeginFrame() and EndRasterization().
+  };
+
+  ezOcclusionBuffer();
+  ~ezOcclusionBuffer();
+
+  /// \brief Sets the resolution of the buffer. Both values are rounded up to a multiple of TILE_SIZE.
+  void SetResolution(ezUInt32 uiWidth, ezUInt32 uiHeight);
+
+  ezUInt32 GetWidth() const { return m_uiWidth; }
+  ezUInt32 GetHeight() const { return m_uiHeight; }
+
+  /// \brief Clears the buffer and sets the camera for all following rasterization and occlusion tests.
+  void BeginFrame(const ezMat4& viewProjectionMatrix, ezClipSpaceDepthRange::Enum depthRange = ezClipSpaceDepthRange::Default);
+
+  /// \brief Rasterizes an indexed triangle list. Both sides of the triangles are rasterized.
+  void RasterizeTriangles(const ezMat4& transform, ezArrayPtr<const ezVec3> vertices, ezArrayPtr<const ezUInt16> indices);
+
+  /// \brief Builds the per tile depth that is needed by IsOccluded(). Must be called after all occluders have been rasterized.
+  void EndRasterization();
+
+  /// \brief Returns true if the given world space box is completely hidden behind the rasterized occluders.
+  ///
+  /// Boxes that intersect the near plane are never occluded.
+  bool IsOccluded(const ezSimdBBox& box) const;
+
+  /// \brief Returns the normalized device depth of every pixel, row by row starting at the bottom. Pixels without occluders are set to the largest float.
+  ezArrayPtr<const float> GetDepthValues() const { return m_Depth; }
+
+  const Stats& GetStats() const { return m_Stats; }
+
+private:
+  void ClipAndRasterizeTriangle(const ezSimdVec4f& v0, const ezSimdVec4f& v1, const ezSimdVec4f& v2);
+  void RasterizeTriangle(const ezSimdVec4f& s0, const ezSimdVec4f& s1, const ezSimdVec4f& s2);
+  ezSimdVec4f ToScreen(const ezSimdVec4f& clipPos) const;
+
+  ezUInt32 m_uiWidth = 0;
+  ezUInt32 m_uiHeight = 0;
+  ezUInt32 m_uiNumTilesX = 0;
+  ezUInt32 m_uiNumTilesY = 0;
+
+  ezSimdMat4f m_ViewProjection;
+  ezSimdVec4f m_NearPlane; ///< Dot product with a clip space position is >= 0 for everything in front of the near plane.
+  ezSimdVec4f m_ScreenScale;
+  ezSimdVec4f m_ScreenOffset;
+
+  ezDynamicArray<float, ezAlignedAllocatorWrapper> m_Depth;
+  ezDynamicArray<float> m_TileMaxDepth;
+
+  Stats m_Stats;
+  ezTime m_BeginTime;
+
+  // scratch data for RasterizeTriangles
+  ezDynamicArray<ezSimdVec4f, ezAlignedAllocatorWrapper> m_ClipPositions;
+};
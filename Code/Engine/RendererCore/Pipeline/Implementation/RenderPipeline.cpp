@@ -2,6 +2,8 @@
 
 #include <Core/World/World.h>
 #include <Foundation/Time/Clock.h>
+#include <RendererCore/Components/OccluderComponent.h>
+#include <RendererCore/Culling/OcclusionBuffer.h>
 #include <RendererCore/Debug/DebugRenderer.h>
 #include <RendererCore/GPUResourcePool/GPUResourcePool.h>
 #include <RendererCore/Pipeline/Extractor.h>
@@ -911,13 +913,26 @@ void ezRenderPipeline::FindVisibleObjects(const ezView& view)
 
   EZ_LOCK(view.GetWorld()->GetReadMarker());
 
+  const bool bOcclusionCulling = RasterizeOccluders(view, frustum);
+  auto isOccludedCallback = [this](const ezSimdBBox& box) { return m_pOcclusionBuffer->IsOccluded(box); };
+
+  const ezUInt32 uiCategoryBitmask = ezDefaultSpatialDataCategories::RenderStatic.GetBitmask() | ezDefaultSpatialDataCategories::RenderDynamic.GetBitmask();
+
+  // the pipeline belongs to a single view so the results of the previous frame can be reused where nothing has changed
+  const ezSpatialSystem* pSpatialSystem = view.GetWorld()->GetSpatialSystem();
+  if (!pSpatialSystem->IsVisibilityCacheValid(m_pVisibilityCache.Borrow()))
+  {
+    m_pVisibilityCache = pSpatialSystem->CreateVisibilityCache();
+  }
+
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
   const bool bIsMainView = (view.GetCameraUsageHint() == ezCameraUsageHint::MainView || view.GetCameraUsageHint() == ezCameraUsageHint::EditorView);
   const bool bRecordStats = CVarCullingStats && bIsMainView;
   ezSpatialSystem::QueryStats stats;
 
-  ezUInt32 uiCategoryBitmask = ezDefaultSpatialDataCategories::RenderStatic.GetBitmask() | ezDefaultSpatialDataCategories::RenderDynamic.GetBitmask();
-  view.GetWorld()->GetSpatialSystem()->FindVisibleObjects(frustum, uiCategoryBitmask, m_visibleObjects, bRecordStats ? &stats : nullptr);
+  pSpatialSystem->FindVisibleObjects(frustum, uiCategoryBitmask, m_visibleObjects, bRecordStats ? &stats : nullptr,
+    bOcclusionCulling ? ezSpatialSystem::IsOccludedCallback(isOccludedCallback) : ezSpatialSystem::IsOccludedCallback(),
+    m_pVisibilityCache.Borrow());
 
   ezViewHandle hView = view.GetHandle();
 
@@ -941,17 +956,85 @@ void ezRenderPipeline::FindVisibleObjects(const ezView& view)
     sb.Format("Num Objects Passed: {0}", stats.m_uiNumObjectsPassed);
     ezDebugRenderer::Draw2DText(hView, sb, ezVec2I32(10, 260), ezColor::LimeGreen);
 
+    sb.Format("Num Objects Cached: {0}", stats.m_uiNumObjectsCached);
+    ezDebugRenderer::Draw2DText(hView, sb, ezVec2I32(10, 280), ezColor::LimeGreen);
+
     // Exponential moving average for better readability.
     m_AverageCullingTime = ezMath::Lerp(m_AverageCullingTime, stats.m_TimeTaken, 0.05f);
 
     sb.Format("Time Taken: {0}ms", m_AverageCullingTime.GetMilliseconds());
-    ezDebugRenderer::Draw2DText(hView, sb, ezVec2I32(10, 280), ezColor::LimeGreen);
+    ezDebugRenderer::Draw2DText(hView, sb, ezVec2I32(10, 300), ezColor::LimeGreen);
+
+    if (bOcclusionCulling)
+    {
+      const ezOcclusionBuffer::Stats& occlusionStats = m_pOcclusionBuffer->GetStats();
+
+      sb.Format("Num Objects Occluded: {0}", stats.m_uiNumObjectsOccluded);
+      ezDebugRenderer::Draw2DText(hView, sb, ezVec2I32(10, 320), ezColor::LimeGreen);
+
+      sb.Format("Num Occluders: {0} ({1} triangles)", occlusionStats.m_uiNumOccluders, occlusionStats.m_uiNumTrianglesRasterized);
+      ezDebugRenderer::Draw2DText(hView, sb, ezVec2I32(10, 340), ezColor::LimeGreen);
+
+      sb.Format("Occluder Raster Time: {0}ms", occlusionStats.m_RasterTime.GetMilliseconds());
+      ezDebugRenderer::Draw2DText(hView, sb, ezVec2I32(10, 360), ezColor::LimeGreen);
+    }
   }
 #else
-  view.GetWorld()->GetSpatialSystem().FindVisibleObjects(frustum, m_visibleObjects, nullptr);
+  pSpatialSystem->FindVisibleObjects(frustum, uiCategoryBitmask, m_visibleObjects, nullptr,
+    bOcclusionCulling ? ezSpatialSystem::IsOccludedCallback(isOccludedCallback) : ezSpatialSystem::IsOccludedCallback(),
+    m_pVisibilityCache.Borrow());
 #endif
 }
 
+bool ezRenderPipeline::RasterizeOccluders(const ezView& view, const ezFrustum& frustum)
+{
+  // the occlusion buffer is rendered from a single eye which would cull objects that are visible from the other one
+  if (!view.GetOcclusionCulling() || view.GetCullingCamera()->IsStereoscopic())
+    return false;
+
+  EZ_PROFILE_SCOPE("Rasterize Occluders");
+
+  if (m_pOcclusionBuffer == nullptr)
+  {
+    // contains SIMD types, the unique pointer deletes it through the same allocator
+    m_pOcclusionBuffer = EZ_NEW(ezFoundation::GetAlignedAllocator(), ezOcclusionBuffer);
+  }
+
+  // keep the pixels of the buffer roughly square
+  const ezRectFloat& viewport = view.GetViewport();
+  const float fAspectRatio = viewport.height > 0.0f ? viewport.width / viewport.height : 1.0f;
+  const ezUInt32 uiWidth = 256;
+  m_pOcclusionBuffer->SetResolution(uiWidth, ezMath::Clamp((ezUInt32)(uiWidth / fAspectRatio), 8u, uiWidth));
+
+  ezMat4 viewProjectionMatrix;
+  view.ComputeCullingViewProjectionMatrix(viewProjectionMatrix);
+
+  m_pOcclusionBuffer->BeginFrame(viewProjectionMatrix);
+
+  // m_visibleObjects is used as scratch data here, it is filled with the actually visible objects afterwards
+  view.GetWorld()->GetSpatialSystem()->FindVisibleObjects(frustum, ezOccluderComponent::GetSpatialCategory().GetBitmask(), m_visibleObjects);
+
+  ezHybridArray<const ezOccluderComponent*, 8> occluders;
+  for (const ezGameObject* pObject : m_visibleObjects)
+  {
+    pObject->TryGetComponentsOfBaseType(occluders);
+
+    for (const ezOccluderComponent* pOccluder : occluders)
+    {
+      if (pOccluder->IsActive())
+      {
+        pOccluder->RasterizeOccluder(*m_pOcclusionBuffer);
+      }
+    }
+  }
+
+  m_visibleObjects.Clear();
+
+  m_pOcclusionBuffer->EndRasterization();
+
+  return true;
+}
+
 void ezRenderPipeline::Render(ezRenderContext* pRenderContext)
 {
   //EZ_PROFILE_AND_MARKER(pRenderContext->GetGALContext(), m_sName.GetData());
@@ -128,6 +128,14 @@ void ezView::ExtractData()
 }
 
 void ezView::ComputeCullingFrustum(ezFrustum& out_Frustum) const
+{
+  ezMat4 viewProjectionMatrix;
+  ComputeCullingViewProjectionMatrix(viewProjectionMatrix);
+
+  out_Frustum.SetFrustum(viewProjectionMatrix);
+}
+
+void ezView::ComputeCullingViewProjectionMatrix(ezMat4& out_ViewProjectionMatrix) const
 {
   const ezCamera* pCamera = GetCullingCamera();
   const float fViewportAspectRatio = m_Data.m_ViewPortRect.width / m_Data.m_ViewPortRect.height;
@@ -137,7 +145,7 @@ void ezView::ComputeCullingFrustum(ezFrustum& out_Frustum) const
   ezMat4 projectionMatrix;
   pCamera->GetProjectionMatrix(fViewportAspectRatio, projectionMatrix);
 
-  out_Frustum.SetFrustum(projectionMatrix * viewMatrix);
+  out_ViewProjectionMatrix = projectionMatrix * viewMatrix;
 }
 
 void ezView::SetShaderPermutationVariable(const char* szName, const char* szValue)
@@ -59,6 +59,16 @@ EZ_ALWAYS_INLINE const ezCamera* ezView::GetLodCamera() const
   return m_pLodCamera != nullptr ? m_pLodCamera : m_pCamera;
 }
 
+EZ_ALWAYS_INLINE void ezView::SetOcclusionCulling(bool bEnable)
+{
+  m_bOcclusionCulling = bEnable;
+}
+
+EZ_ALWAYS_INLINE bool ezView::GetOcclusionCulling() const
+{
+  return m_bOcclusionCulling;
+}
+
 EZ_ALWAYS_INLINE ezEnum<ezCameraUsageHint> ezView::GetCameraUsageHint() const
 {
   return m_Data.m_CameraUsageHint;
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <Core/World/SpatialSystem.h>
 #include <Foundation/Configuration/CVar.h>
 #include <Foundation/Containers/DynamicArray.h>
 #include <Foundation/Containers/HybridArray.h>
@@ -7,10 +8,12 @@
 #include <Foundation/Types/UniquePtr.h>
 #include <RendererCore/Pipeline/ExtractedRenderData.h>
 
+class ezFrustum;
 class ezProfilingId;
 class ezView;
 class ezRenderPipelinePass;
 class ezFrameDataProviderBase;
+class ezOcclusionBuffer;
 struct ezPermutationVar;
 
 class EZ_RENDERERCORE_DLL ezRenderPipeline : public ezRefCounted
@@ -84,6 +87,7 @@ private:
 
   void ExtractData(const ezView& view);
   void FindVisibleObjects(const ezView& view);
+  bool RasterizeOccluders(const ezView& view, const ezFrustum& frustum);
 
   void Render(ezRenderContext* pRenderer);
 
@@ -95,6 +99,8 @@ private: // Member data
   // Pipeline render data
   ezExtractedRenderData m_Data[2];
   ezDynamicArray<const ezGameObject*> m_visibleObjects;
+  ezUniquePtr<ezOcclusionBuffer> m_pOcclusionBuffer;
+  ezUniquePtr<ezSpatialSystem::VisibilityCache> m_pVisibilityCache;
 
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
   ezTime m_AverageCullingTime;
@@ -104,6 +104,15 @@ public:
   /// \brief Returns the frustum that should be used for determine visible objects for this view.
   void ComputeCullingFrustum(ezFrustum& out_Frustum) const;
 
+  /// \brief Returns the view-projection matrix of the culling camera, the frustum returned by ComputeCullingFrustum() is derived from it.
+  void ComputeCullingViewProjectionMatrix(ezMat4& out_ViewProjectionMatrix) const;
+
+  /// \brief Enables culling of objects that are hidden behind ezOccluderComponents. Disabled by default.
+  ///
+  /// Occluders are rasterized on the CPU during extraction, so this is only worth it for views that look at scenes with large occluders.
+  void SetOcclusionCulling(bool bEnable);
+  bool GetOcclusionCulling() const;
+
   void SetShaderPermutationVariable(const char* szName, const char* szValue);
 
   void SetRenderPassProperty(const char* szPassName, const char* szPropertyName, const ezVariant& value);
@@ -140,6 +149,7 @@ private:
   ezCamera* m_pCamera = nullptr;
   const ezCamera* m_pCullingCamera = nullptr;
   const ezCamera* m_pLodCamera = nullptr;
+  bool m_bOcclusionCulling = false;
 
 private:
   ezRenderPipelineNodeInputPin m_PinRenderTarget0;
@@ -17,11 +17,13 @@ EZ_STATICLINK_LIBRARY(RendererCore)
   EZ_STATICLINK_REFERENCE(RendererCore_Components_Implementation_BeamComponent);
   EZ_STATICLINK_REFERENCE(RendererCore_Components_Implementation_CameraComponent);
   EZ_STATICLINK_REFERENCE(RendererCore_Components_Implementation_FogComponent);
+  EZ_STATICLINK_REFERENCE(RendererCore_Components_Implementation_OccluderComponent);
   EZ_STATICLINK_REFERENCE(RendererCore_Components_Implementation_RenderComponent);
   EZ_STATICLINK_REFERENCE(RendererCore_Components_Implementation_RenderTargetActivatorComponent);
   EZ_STATICLINK_REFERENCE(RendererCore_Components_Implementation_SkyBoxComponent);
   EZ_STATICLINK_REFERENCE(RendererCore_Components_Implementation_SpriteComponent);
   EZ_STATICLINK_REFERENCE(RendererCore_Components_Implementation_SpriteRenderer);
+  EZ_STATICLINK_REFERENCE(RendererCore_Culling_Implementation_OcclusionBuffer);
   EZ_STATICLINK_REFERENCE(RendererCore_Debug_Implementation_DebugRenderer);
   EZ_STATICLINK_REFERENCE(RendererCore_Debug_Implementation_DebugTextComponent);
   EZ_STATICLINK_REFERENCE(RendererCore_Debug_Implementation_Inconsolata);
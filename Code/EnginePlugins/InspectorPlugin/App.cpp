@@ -86,6 +86,13 @@ void SetAppStats()
 #endif
   ezStats::SetStat("Features/Allocation Tracking", sOut.GetData());
 
+#if EZ_ENABLED(EZ_USE_ALLOCATION_SAMPLING)
+  sOut = "Enabled";
+#else
+  sOut = "Disabled";
+#endif
+  ezStats::SetStat("Features/Allocation Sampling", sOut.GetData());
+
 #if EZ_ENABLED(EZ_USE_ALLOCATION_STACK_TRACING)
   sOut = "Enabled";
 #else
@@ -1,6 +1,11 @@
 #include <CoreTestPCH.h>
 
 #include <Core/ResourceManager/ResourceManager.h>
+#include <Foundation/Containers/HashSet.h>
+#include <Foundation/IO/FileSystem/DataDirTypeFolder.h>
+#include <Foundation/IO/FileSystem/FileWriter.h>
+#include <Foundation/Threading/TaskSystem.h>
+#include <Foundation/Threading/Thread.h>
 #include <Foundation/Types/ScopeExit.h>
 
 EZ_CREATE_SIMPLE_TEST_GROUP(ResourceManager);
@@ -126,6 +131,245 @@ namespace
   EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(TestResource, 1, ezRTTIDefaultAllocator<TestResource>)
   EZ_END_DYNAMIC_REFLECTED_TYPE;
 
+  /// \brief Simulates the read latency of a file by sleeping before it returns a small amount of data.
+  template <ezUInt32 ReadLatencyMS>
+  class LatencyResourceTypeLoader : public ezResourceTypeLoader
+  {
+  public:
+    struct LoadedData
+    {
+      ezMemoryStreamStorage m_StreamData;
+      ezMemoryStreamReader m_Reader;
+    };
+
+    virtual ezResourceLoadData OpenDataStream(const ezResource* pResource) override
+    {
+      ezThreadUtils::Sleep(ezTime::Milliseconds(ReadLatencyMS));
+
+      LoadedData* pData = EZ_DEFAULT_NEW(LoadedData);
+
+      const ezUInt32 uiNumElements = 16;
+
+      ezMemoryStreamWriter writer(&pData->m_StreamData);
+      pData->m_Reader.SetStorage(&pData->m_StreamData);
+
+      writer << uiNumElements;
+
+      for (ezUInt32 i = 0; i < uiNumElements; ++i)
+      {
+        writer << i;
+      }
+
+      ezResourceLoadData ld;
+      ld.m_pCustomLoaderData = pData;
+      ld.m_pDataStream = &pData->m_Reader;
+      ld.m_sResourceDescription = pResource->GetResourceID();
+      ld.m_uiDataSize = pData->m_StreamData.GetStorageSize();
+
+      return ld;
+    }
+
+    virtual void CloseDataStream(const ezResource* pResource, const ezResourceLoadData& LoaderData) override
+    {
+      LoadedData* pData = static_cast<LoadedData*>(LoaderData.m_pCustomLoaderData);
+      EZ_DEFAULT_DELETE(pData);
+    }
+  };
+
+  /// \brief Records the order in which the resources are loaded. Loads only start once the gate is opened.
+  class OrderRecordingTypeLoader : public LatencyResourceTypeLoader<1>
+  {
+  public:
+    virtual ezResourceLoadData OpenDataStream(const ezResource* pResource) override
+    {
+      {
+        EZ_LOCK(m_Mutex);
+        m_LoadOrder.PushBack(pResource->GetResourceID());
+      }
+
+      // don't hang forever, if the test fails before it opens the gate
+      const ezTime tTimeout = ezTime::Now() + ezTime::Seconds(10);
+      while (!m_bGateOpen && ezTime::Now() < tTimeout)
+      {
+        ezThreadUtils::Sleep(ezTime::Milliseconds(1));
+      }
+
+      return LatencyResourceTypeLoader<1>::OpenDataStream(pResource);
+    }
+
+    ezUInt32 GetNumStartedLoads()
+    {
+      EZ_LOCK(m_Mutex);
+      return m_LoadOrder.GetCount();
+    }
+
+    ezMutex m_Mutex;
+    ezDynamicArray<ezString> m_LoadOrder;
+    ezAtomicBool m_bGateOpen = false;
+  };
+
+  /// \brief Sleeps until the condition is met, returns false if that did not happen within the timeout.
+  template <typename Condition>
+  bool WaitUntil(Condition condition, ezTime timeout = ezTime::Seconds(30))
+  {
+    const ezTime tEnd = ezTime::Now() + timeout;
+
+    while (!condition())
+    {
+      if (ezTime::Now() > tEnd)
+        return false;
+
+      ezThreadUtils::Sleep(ezTime::Milliseconds(1));
+    }
+
+    return true;
+  }
+
+  typedef ezTypedResourceHandle<class FastTestResource> FastTestResourceHandle;
+
+  class FastTestResource : public ezResource
+  {
+    EZ_ADD_DYNAMIC_REFLECTION(FastTestResource, ezResource);
+    EZ_RESOURCE_DECLARE_COMMON_CODE(FastTestResource);
+
+  public:
+    FastTestResource()
+      : ezResource(ezResource::DoUpdate::OnAnyThread, 1)
+    {
+    }
+
+  protected:
+    virtual ezResourceLoadDesc UnloadData(Unload WhatToUnload) override
+    {
+      ezResourceLoadDesc ld;
+      ld.m_State = ezResourceState::Unloaded;
+      ld.m_uiQualityLevelsDiscardable = 0;
+      ld.m_uiQualityLevelsLoadable = 0;
+
+      return ld;
+    }
+
+    virtual ezResourceLoadDesc UpdateContent(ezStreamReader* Stream) override
+    {
+      ezResourceLoadDesc ld;
+      ld.m_State = ezResourceState::Loaded;
+      ld.m_uiQualityLevelsDiscardable = 0;
+      ld.m_uiQualityLevelsLoadable = 0;
+
+      return ld;
+    }
+
+    virtual void UpdateMemoryUsage(MemoryUsage& out_NewMemoryUsage) override
+    {
+      out_NewMemoryUsage.m_uiMemoryCPU = sizeof(FastTestResource);
+      out_NewMemoryUsage.m_uiMemoryGPU = 0;
+    }
+  };
+
+  EZ_RESOURCE_IMPLEMENT_COMMON_CODE(FastTestResource);
+  EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(FastTestResource, 1, ezRTTIDefaultAllocator<FastTestResource>)
+  EZ_END_DYNAMIC_REFLECTED_TYPE;
+
+  ezTime LoadResources(const char* szPrefix, ezUInt32 uiNumResources)
+  {
+    ezDynamicArray<TestResourceHandle> hResources;
+    hResources.Reserve(uiNumResources);
+
+    const ezTime tStart = ezTime::Now();
+
+    ezStringBuilder sResourceID;
+    for (ezUInt32 i = 0; i < uiNumResources; ++i)
+    {
+      sResourceID.Format("{}-{}", szPrefix, i);
+      hResources.PushBack(ezResourceManager::LoadResource<TestResource>(sResourceID));
+      ezResourceManager::PreloadResource(hResources.PeekBack());
+    }
+
+    for (ezUInt32 i = 0; i < uiNumResources; ++i)
+    {
+      ezResourceLock<TestResource> pTestResource(hResources[i], ezResourceAcquireMode::BlockTillLoaded_NeverFail);
+
+      EZ_TEST_BOOL(pTestResource.GetAcquireResult() == ezResourceAcquireResult::Final);
+
+      pTestResource->Test();
+    }
+
+    const ezTime tDuration = ezTime::Now() - tStart;
+
+    hResources.Clear();
+
+    while (ezResourceManager::IsAnyLoadingInProgress())
+    {
+      ezThreadUtils::Sleep(ezTime::Milliseconds(1));
+    }
+
+    ezResourceManager::FreeAllUnusedResources();
+    EZ_TEST_INT(ezResourceManager::GetAllResourcesOfType<TestResource>()->GetCount(), 0);
+
+    return tDuration;
+  }
+
+  class LookupThread : public ezThread
+  {
+  public:
+    LookupThread(ezArrayPtr<const ezString> resourceIDs, ezUInt32 uiNumLookups, ezUInt32 uiSeed)
+      : ezThread("Lookup Thread")
+      , m_ResourceIDs(resourceIDs)
+      , m_uiNumLookups(uiNumLookups)
+      , m_uiSeed(uiSeed)
+    {
+    }
+
+    virtual ezUInt32 Run() override
+    {
+      for (ezUInt32 i = 0; i < m_uiNumLookups; ++i)
+      {
+        const ezString& sResourceID = m_ResourceIDs[(m_uiSeed + i * 7919) % m_ResourceIDs.GetCount()];
+
+        TestResourceHandle hResource = ezResourceManager::LoadResource<TestResource>(sResourceID);
+
+        if (!hResource.IsValid() || hResource.GetResourceID() != sResourceID)
+          ++m_uiNumFailed;
+      }
+
+      return 0;
+    }
+
+    ezUInt32 m_uiNumFailed = 0;
+
+  private:
+    ezArrayPtr<const ezString> m_ResourceIDs;
+    ezUInt32 m_uiNumLookups = 0;
+    ezUInt32 m_uiSeed = 0;
+  };
+
+  ezTime RunLookupThreads(ezArrayPtr<const ezString> resourceIDs, ezUInt32 uiNumThreads, ezUInt32 uiNumLookups, ezDelegate<void()> mainThreadWork)
+  {
+    ezHybridArray<ezUniquePtr<LookupThread>, 8> threads;
+
+    for (ezUInt32 t = 0; t < uiNumThreads; ++t)
+    {
+      threads.PushBack(EZ_DEFAULT_NEW(LookupThread, resourceIDs, uiNumLookups, t * 31));
+    }
+
+    const ezTime tStart = ezTime::Now();
+
+    for (auto& pThread : threads)
+    {
+      pThread->Start();
+    }
+
+    mainThreadWork();
+
+    for (auto& pThread : threads)
+    {
+      pThread->Join();
+      EZ_TEST_INT(pThread->m_uiNumFailed, 0);
+    }
+
+    return ezTime::Now() - tStart;
+  }
+
 } // namespace
 
 EZ_CREATE_SIMPLE_TEST(ResourceManager, Basics)
@@ -188,6 +432,29 @@ EZ_CREATE_SIMPLE_TEST(ResourceManager, Basics)
 
     EZ_TEST_INT(ezResourceManager::GetAllResourcesOfType<TestResource>()->GetCount(), 0);
   }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Named Resources")
+  {
+    TestResourceHandle hResourceA = ezResourceManager::LoadResource<TestResource>("NamedA");
+    TestResourceHandle hResourceB = ezResourceManager::LoadResource<TestResource>("NamedB");
+
+    // the second lookup is served from the lookup index
+    EZ_TEST_BOOL(ezResourceManager::LoadResource<TestResource>("NamedA") == hResourceA);
+    EZ_TEST_BOOL(ezResourceManager::GetExistingResource<TestResource>("NamedA") == hResourceA);
+
+    ezResourceManager::RegisterNamedResource("NamedA", "NamedB");
+    EZ_TEST_BOOL(ezResourceManager::LoadResource<TestResource>("NamedA") == hResourceB);
+
+    ezResourceManager::UnregisterNamedResource("NamedA");
+    EZ_TEST_BOOL(ezResourceManager::LoadResource<TestResource>("NamedA") == hResourceA);
+
+    hResourceA.Invalidate();
+    hResourceB.Invalidate();
+
+    ezResourceManager::FreeAllUnusedResources();
+    EZ_TEST_INT(ezResourceManager::GetAllResourcesOfType<TestResource>()->GetCount(), 0);
+    EZ_TEST_BOOL(!ezResourceManager::GetExistingResource<TestResource>("NamedA").IsValid());
+  }
 }
 
 EZ_CREATE_SIMPLE_TEST(ResourceManager, NestedLoading)
@@ -286,3 +553,533 @@ EZ_CREATE_SIMPLE_TEST(ResourceManager, NestedLoading)
     EZ_TEST_INT(ezResourceManager::GetAllResourcesOfType<TestResource>()->GetCount(), 0);
   }
 }
+
+EZ_CREATE_SIMPLE_TEST(ResourceManager, DependencyPrefetching)
+{
+  TestResourceTypeLoader TypeLoader;
+  LatencyResourceTypeLoader<0> FastTypeLoader;
+  ezResourceManager::SetResourceTypeLoader<TestResource>(&TypeLoader);
+  ezResourceManager::SetResourceTypeLoader<FastTestResource>(&FastTypeLoader);
+  EZ_SCOPE_EXIT(ezResourceManager::SetResourceTypeLoader<TestResource>(nullptr));
+  EZ_SCOPE_EXIT(ezResourceManager::SetResourceTypeLoader<FastTestResource>(nullptr));
+  EZ_SCOPE_EXIT(ezResourceManager::ClearResourceDependencies());
+
+  ezMemoryStreamStorage storage;
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Record")
+  {
+    ezResourceManager::SetRecordResourceDependencies(true);
+
+    {
+      // loads 'Level0-0' in its UpdateContent()
+      TestResourceHandle hResource = ezResourceManager::LoadResource<TestResource>("NonBlockingLevel1-0");
+
+      ezResourceLock<TestResource> pTestResource(hResource, ezResourceAcquireMode::BlockTillLoaded_NeverFail);
+      EZ_TEST_BOOL(pTestResource.GetAcquireResult() == ezResourceAcquireResult::Final);
+    }
+
+    ezResourceManager::SetRecordResourceDependencies(false);
+
+    ezMemoryStreamWriter writer(&storage);
+    ezResourceManager::SaveResourceDependencies(writer);
+
+    ezResourceManager::ClearResourceDependencies();
+
+    ezResourceManager::FreeAllUnusedResources();
+    EZ_TEST_INT(ezResourceManager::GetAllResourcesOfType<TestResource>()->GetCount(), 0);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Prefetch")
+  {
+    ezMemoryStreamReader reader(&storage);
+    EZ_TEST_BOOL(ezResourceManager::LoadResourceDependencies(reader).Succeeded());
+
+    ezResourceManager::SetPrefetchResourceDependencies(true);
+    EZ_SCOPE_EXIT(ezResourceManager::SetPrefetchResourceDependencies(false));
+
+    {
+      // same ID, but a different type, which has no known dependencies
+      FastTestResourceHandle hOtherType = ezResourceManager::LoadResource<FastTestResource>("NonBlockingLevel1-0");
+      ezResourceManager::PreloadResource(hOtherType);
+
+      EZ_TEST_BOOL(!ezResourceManager::GetExistingResource<TestResource>("Level0-0").IsValid());
+    }
+
+    {
+      TestResourceHandle hResource = ezResourceManager::LoadResource<TestResource>("NonBlockingLevel1-0");
+      EZ_TEST_BOOL(!ezResourceManager::GetExistingResource<TestResource>("Level0-0").IsValid());
+
+      {
+        ezResourceLock<TestResource> pTestResource(hResource, ezResourceAcquireMode::PointerOnly);
+        pTestResource->SetPriority(ezResourcePriority::High);
+      }
+
+      // the dependency is known right away, before the UpdateContent() of the resource ran
+      ezResourceManager::PreloadResource(hResource);
+
+      TestResourceHandle hDependency = ezResourceManager::GetExistingResource<TestResource>("Level0-0");
+      if (EZ_TEST_BOOL(hDependency.IsValid()))
+      {
+        ezResourceLock<TestResource> pDependency(hDependency, ezResourceAcquireMode::PointerOnly);
+        EZ_TEST_BOOL(pDependency->GetPriority() == ezResourcePriority::High);
+      }
+
+      ezResourceLock<TestResource> pTestResource(hResource, ezResourceAcquireMode::BlockTillLoaded_NeverFail);
+      EZ_TEST_BOOL(pTestResource.GetAcquireResult() == ezResourceAcquireResult::Final);
+    }
+
+    while (ezResourceManager::IsAnyLoadingInProgress())
+    {
+      ezThreadUtils::Sleep(ezTime::Milliseconds(1));
+    }
+
+    ezResourceManager::FreeAllUnusedResources();
+    EZ_TEST_INT(ezResourceManager::GetAllResourcesOfType<TestResource>()->GetCount(), 0);
+    EZ_TEST_INT(ezResourceManager::GetAllResourcesOfType<FastTestResource>()->GetCount(), 0);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Invalid Data")
+  {
+    ezResourceManager::ClearResourceDependencies();
+
+    ezMemoryStreamStorage emptyStorage;
+    {
+      ezMemoryStreamWriter writer(&emptyStorage);
+      ezResourceManager::SaveResourceDependencies(writer);
+    }
+
+    {
+      ezMemoryStreamStorage invalidStorage;
+      ezMemoryStreamWriter writer(&invalidStorage);
+      writer << ezUInt8(255);
+
+      ezMemoryStreamReader reader(&invalidStorage);
+      EZ_TEST_BOOL(ezResourceManager::LoadResourceDependencies(reader).Failed());
+    }
+
+    {
+      // a count that can't be right must be rejected before anything is allocated for it
+      ezMemoryStreamStorage invalidStorage;
+      ezMemoryStreamWriter writer(&invalidStorage);
+      writer << ezUInt8(2);
+      writer << ezUInt32(0xFFFFFFFF);
+
+      ezMemoryStreamReader reader(&invalidStorage);
+      EZ_TEST_BOOL(ezResourceManager::LoadResourceDependencies(reader).Failed());
+    }
+
+    {
+      // the last entry is cut off, none of the entries before it may be used
+      ezMemoryStreamStorage truncatedStorage;
+      ezMemoryStreamWriter writer(&truncatedStorage);
+      writer.WriteBytes(storage.GetData(), storage.GetStorageSize() - 1).IgnoreResult();
+
+      ezMemoryStreamReader reader(&truncatedStorage);
+      EZ_TEST_BOOL(ezResourceManager::LoadResourceDependencies(reader).Failed());
+    }
+
+    {
+      // a type that exists and can be allocated, but is no resource, must be ignored like an unknown type
+      ezMemoryStreamStorage wrongTypeStorage;
+      ezMemoryStreamWriter writer(&wrongTypeStorage);
+      writer << ezUInt8(2);
+
+      writer << ezUInt32(2);
+      writer << ezGetStaticRTTI<TestResource>()->GetTypeName();
+      writer << ezGetStaticRTTI<ezHiddenAttribute>()->GetTypeName();
+
+      writer << ezUInt32(2);
+      writer << "NonBlockingLevel1-0";
+      writer << "Level0-0";
+
+      writer << ezUInt32(2);
+      // the resource depends on a 'resource' of the wrong type
+      writer << ezUInt32(0) << ezUInt32(0) << ezUInt32(1);
+      writer << ezUInt32(1) << ezUInt32(1);
+      // the wrong type depends on a resource
+      writer << ezUInt32(1) << ezUInt32(1) << ezUInt32(1);
+      writer << ezUInt32(0) << ezUInt32(0);
+
+      ezMemoryStreamReader reader(&wrongTypeStorage);
+      EZ_TEST_BOOL(ezResourceManager::LoadResourceDependencies(reader).Succeeded());
+    }
+
+    ezMemoryStreamStorage resultStorage;
+    {
+      ezMemoryStreamWriter writer(&resultStorage);
+      ezResourceManager::SaveResourceDependencies(writer);
+    }
+
+    EZ_TEST_INT(resultStorage.GetStorageSize(), emptyStorage.GetStorageSize());
+  }
+}
+
+EZ_CREATE_SIMPLE_TEST(ResourceManager, Profile_Loading)
+{
+  LatencyResourceTypeLoader<1> TypeLoader;
+  LatencyResourceTypeLoader<0> FastTypeLoader;
+  ezResourceManager::SetResourceTypeLoader<TestResource>(&TypeLoader);
+  ezResourceManager::SetResourceTypeLoader<FastTestResource>(&FastTypeLoader);
+  EZ_SCOPE_EXIT(ezResourceManager::SetResourceTypeLoader<TestResource>(nullptr));
+  EZ_SCOPE_EXIT(ezResourceManager::SetResourceTypeLoader<FastTestResource>(nullptr));
+
+  const ezUInt32 uiNumResources = 2000;
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Concurrent Loads")
+  {
+    EZ_SCOPE_EXIT(ezTaskSystem::SetWorkerThreadCount());
+
+    for (ezUInt32 uiNumThreads : {1, 2, 4, 8})
+    {
+      ezTaskSystem::SetWorkerThreadCount(-1, -1, uiNumThreads);
+      EZ_TEST_INT(ezTaskSystem::GetWorkerThreadCount(ezWorkerThreadType::FileAccess), uiNumThreads);
+
+      const ezTime tDuration = LoadResources("Concurrent", uiNumResources);
+
+      ezLog::Info("Loading {} resources with {} file access threads: {}ms", uiNumResources, uiNumThreads, ezArgF(tDuration.GetMilliseconds(), 1));
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Byte Budget")
+  {
+    ezTaskSystem::SetWorkerThreadCount(-1, -1, 4);
+    EZ_SCOPE_EXIT(ezTaskSystem::SetWorkerThreadCount());
+
+    // less than the data of a single resource, so no further load starts while loaded data waits for UpdateContent()
+    ezResourceManager::SetDataLoadLimits(0, 1);
+    EZ_SCOPE_EXIT(ezResourceManager::SetDataLoadLimits(0, 0));
+
+    const ezTime tDuration = LoadResources("Budget", uiNumResources / 4);
+
+    ezLog::Info("Loading {} resources with a byte budget: {}ms", uiNumResources / 4, ezArgF(tDuration.GetMilliseconds(), 1));
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Fast Data Load")
+  {
+    ezTaskSystem::SetWorkerThreadCount(-1, -1, 2);
+    EZ_SCOPE_EXIT(ezTaskSystem::SetWorkerThreadCount());
+
+    ezResourceManager::SetFastDataLoadForResourceType<FastTestResource>(true);
+    EZ_SCOPE_EXIT(ezResourceManager::SetFastDataLoadForResourceType<FastTestResource>(false));
+
+    ezDynamicArray<TestResourceHandle> hResources;
+    hResources.Reserve(uiNumResources);
+
+    ezStringBuilder sResourceID;
+    for (ezUInt32 i = 0; i < uiNumResources; ++i)
+    {
+      sResourceID.Format("Slow-{}", i);
+      hResources.PushBack(ezResourceManager::LoadResource<TestResource>(sResourceID));
+      ezResourceManager::PreloadResource(hResources.PeekBack());
+    }
+
+    // preloaded with a regular priority, so it only gets ahead of the slow resources through its own queue
+    FastTestResourceHandle hFastResource = ezResourceManager::LoadResource<FastTestResource>("Fast");
+    ezResourceManager::PreloadResource(hFastResource);
+
+    const ezTime tStart = ezTime::Now();
+
+    while (ezResourceManager::GetLoadingState(hFastResource) != ezResourceState::Loaded)
+    {
+      ezThreadUtils::Sleep(ezTime::Microseconds(100));
+    }
+
+    const ezTime tFastDuration = ezTime::Now() - tStart;
+
+    // the slow resources need seconds, as only one of the two threads may load them
+    EZ_TEST_BOOL(ezResourceManager::IsAnyLoadingInProgress());
+
+    ezLog::Info("Loading a fast resource while {} slow resources are queued: {}ms", uiNumResources, ezArgF(tFastDuration.GetMilliseconds(), 1));
+
+    hFastResource.Invalidate();
+    hResources.Clear();
+
+    while (ezResourceManager::IsAnyLoadingInProgress())
+    {
+      ezThreadUtils::Sleep(ezTime::Milliseconds(1));
+    }
+
+    ezResourceManager::FreeAllUnusedResources();
+    EZ_TEST_INT(ezResourceManager::GetAllResourcesOfType<TestResource>()->GetCount(), 0);
+    EZ_TEST_INT(ezResourceManager::GetAllResourcesOfType<FastTestResource>()->GetCount(), 0);
+  }
+}
+
+EZ_CREATE_SIMPLE_TEST(ResourceManager, Profile_Lookup)
+{
+  LatencyResourceTypeLoader<1> TypeLoader;
+  ezResourceManager::SetResourceTypeLoader<TestResource>(&TypeLoader);
+  EZ_SCOPE_EXIT(ezResourceManager::SetResourceTypeLoader<TestResource>(nullptr));
+
+  const ezUInt32 uiNumResources = 1000;
+  const ezUInt32 uiNumLookups = 100000;
+
+  ezDynamicArray<ezString> resourceIDs;
+  ezDynamicArray<TestResourceHandle> hResources;
+
+  ezStringBuilder sResourceID;
+  for (ezUInt32 i = 0; i < uiNumResources; ++i)
+  {
+    sResourceID.Format("Lookup-{}", i);
+    resourceIDs.PushBack(sResourceID);
+    hResources.PushBack(ezResourceManager::LoadResource<TestResource>(sResourceID));
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Existing Resources")
+  {
+    for (ezUInt32 uiNumThreads : {1, 2, 4, 8})
+    {
+      const ezTime tDuration = RunLookupThreads(resourceIDs, uiNumThreads, uiNumLookups, []() {});
+
+      ezLog::Info("{} threads looking up {} existing resources each: {}ms", uiNumThreads, uiNumLookups, ezArgF(tDuration.GetMilliseconds(), 1));
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "While Loading")
+  {
+    // the loader tasks and the main thread need s_ResourceMutex all the time, lookups of existing resources should not be affected
+    ezDynamicArray<TestResourceHandle> hBackgroundResources;
+
+    const ezTime tDuration = RunLookupThreads(resourceIDs, 4, uiNumLookups, [&hBackgroundResources]() {
+      ezStringBuilder sResourceID;
+      for (ezUInt32 i = 0; i < 500; ++i)
+      {
+        sResourceID.Format("Background-{}", i);
+        hBackgroundResources.PushBack(ezResourceManager::LoadResource<TestResource>(sResourceID));
+        ezResourceManager::PreloadResource(hBackgroundResources.PeekBack());
+      }
+    });
+
+    ezLog::Info("4 threads looking up {} existing resources each, while loading: {}ms", uiNumLookups, ezArgF(tDuration.GetMilliseconds(), 1));
+
+    hBackgroundResources.Clear();
+
+    while (ezResourceManager::IsAnyLoadingInProgress())
+    {
+      ezThreadUtils::Sleep(ezTime::Milliseconds(1));
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "While Freeing")
+  {
+    // nothing keeps the resources alive, except for the short lived handles of the lookup threads
+    hResources.Clear();
+
+    ezUInt32 uiFreed = 0;
+    RunLookupThreads(resourceIDs, 4, uiNumLookups / 10, [&uiFreed]() {
+      for (ezUInt32 i = 0; i < 100; ++i)
+      {
+        uiFreed += ezResourceManager::FreeAllUnusedResources();
+      }
+    });
+
+    ezLog::Info("Freed {} resources while they were looked up", uiFreed);
+
+    ezResourceManager::FreeAllUnusedResources();
+    EZ_TEST_INT(ezResourceManager::GetAllResourcesOfType<TestResource>()->GetCount(), 0);
+  }
+}
+
+EZ_CREATE_SIMPLE_TEST(ResourceManager, LoadingPriorities)
+{
+  OrderRecordingTypeLoader TypeLoader;
+  ezResourceManager::SetResourceTypeLoader<TestResource>(&TypeLoader);
+  EZ_SCOPE_EXIT(ezResourceManager::SetResourceTypeLoader<TestResource>(nullptr));
+
+  // one load at a time, so that the order in which the loads start is the order in which they leave the queue
+  ezResourceManager::SetDataLoadLimits(1, 0);
+  EZ_SCOPE_EXIT(ezResourceManager::SetDataLoadLimits(0, 0));
+
+  ezResourceManager::ResetLoadingQueueStats();
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Urgent resources are loaded first")
+  {
+    const ezUInt32 uiNumResources = 500;
+
+    ezDynamicArray<TestResourceHandle> hResources;
+    hResources.Reserve(uiNumResources);
+
+    ezStringBuilder sResourceID;
+    for (ezUInt32 i = 0; i < uiNumResources; ++i)
+    {
+      sResourceID.Format("Unimportant-{}", i);
+      hResources.PushBack(ezResourceManager::LoadResource<TestResource>(sResourceID));
+
+      ezResourceLock<TestResource> pResource(hResources.PeekBack(), ezResourceAcquireMode::PointerOnly);
+      pResource->SetPriority(ezResourcePriority::VeryLow);
+
+      ezResourceManager::PreloadResource(hResources.PeekBack());
+    }
+
+    // the first unimportant resource is already being loaded and waits for the gate, all others are still queued
+    EZ_TEST_BOOL(WaitUntil([&]() { return TypeLoader.GetNumStartedLoads() == 1; }));
+
+    TestResourceHandle hUrgent = ezResourceManager::LoadResource<TestResource>("Urgent");
+    {
+      ezResourceLock<TestResource> pResource(hUrgent, ezResourceAcquireMode::PointerOnly);
+      pResource->SetPriority(ezResourcePriority::VeryHigh);
+    }
+
+    ezResourceManager::PreloadResource(hUrgent);
+
+    // one that is still queued becomes important after it was queued
+    ezUInt32 uiPromoted = uiNumResources - 1;
+    sResourceID.Format("Unimportant-{}", uiPromoted);
+
+    {
+      EZ_LOCK(TypeLoader.m_Mutex);
+
+      if (TypeLoader.m_LoadOrder[0] == sResourceID)
+      {
+        --uiPromoted;
+        sResourceID.Format("Unimportant-{}", uiPromoted);
+      }
+    }
+
+    const ezString sPromotedID = sResourceID;
+    TestResourceHandle hPromoted = hResources[uiPromoted];
+    {
+      ezResourceLock<TestResource> pResource(hPromoted, ezResourceAcquireMode::PointerOnly);
+      pResource->SetPriority(ezResourcePriority::High);
+    }
+
+    TypeLoader.m_bGateOpen = true;
+
+    EZ_TEST_BOOL(WaitUntil([&]() {
+      return ezResourceManager::GetLoadingState(hUrgent) == ezResourceState::Loaded && ezResourceManager::GetLoadingState(hPromoted) == ezResourceState::Loaded;
+    }));
+
+    {
+      EZ_LOCK(TypeLoader.m_Mutex);
+
+      if (EZ_TEST_BOOL(TypeLoader.m_LoadOrder.GetCount() >= 3))
+      {
+        EZ_TEST_BOOL(TypeLoader.m_LoadOrder[0].StartsWith("Unimportant-"));
+        EZ_TEST_STRING(TypeLoader.m_LoadOrder[1], "Urgent");
+        EZ_TEST_STRING(TypeLoader.m_LoadOrder[2], sPromotedID);
+      }
+    }
+
+    const ezResourceManager::LoadingQueueStats urgentStats = ezResourceManager::GetLoadingQueueStats(ezResourcePriority::VeryHigh);
+    EZ_TEST_INT(urgentStats.m_uiNumQueued, 0);
+    EZ_TEST_INT(urgentStats.m_uiNumDequeued, 1);
+
+    const ezResourceManager::LoadingQueueStats promotedStats = ezResourceManager::GetLoadingQueueStats(ezResourcePriority::High);
+    EZ_TEST_INT(promotedStats.m_uiNumDequeued, 1);
+
+    hUrgent.Invalidate();
+    hPromoted.Invalidate();
+
+    EZ_TEST_BOOL(WaitUntil([]() { return !ezResourceManager::IsAnyLoadingInProgress(); }));
+
+    {
+      // changing the priorities did not lead to anything being loaded twice
+      EZ_LOCK(TypeLoader.m_Mutex);
+
+      EZ_TEST_INT(TypeLoader.m_LoadOrder.GetCount(), uiNumResources + 1);
+
+      ezHashSet<ezString> loaded;
+      for (const ezString& sLoaded : TypeLoader.m_LoadOrder)
+      {
+        loaded.Insert(sLoaded);
+      }
+
+      EZ_TEST_INT(loaded.GetCount(), uiNumResources + 1);
+    }
+
+    const ezResourceManager::LoadingQueueStats unimportantStats = ezResourceManager::GetLoadingQueueStats(ezResourcePriority::VeryLow);
+    EZ_TEST_INT(unimportantStats.m_uiNumQueued, 0);
+    EZ_TEST_INT(unimportantStats.m_uiNumDequeued, uiNumResources - 1);
+    EZ_TEST_BOOL(unimportantStats.m_MaxLatency > urgentStats.m_MaxLatency);
+
+    hResources.Clear();
+
+    ezResourceManager::FreeAllUnusedResources();
+    EZ_TEST_INT(ezResourceManager::GetAllResourcesOfType<TestResource>()->GetCount(), 0);
+  }
+}
+
+EZ_CREATE_SIMPLE_TEST(ResourceManager, LoaderFromFile)
+{
+  ezFileSystem::RegisterDataDirectoryFactory(ezDataDirectory::FolderType::Factory);
+
+  ezStringBuilder sOutputFolder = ezTestFramework::GetInstance()->GetAbsOutputPath();
+  EZ_TEST_BOOL(ezFileSystem::AddDataDirectory(sOutputFolder, "ResourceManagerTest", "output", ezFileSystem::AllowWrites) == EZ_SUCCESS);
+  EZ_SCOPE_EXIT(ezFileSystem::RemoveDataDirectoryGroup("ResourceManagerTest"));
+
+  const char* szFile = ":output/ResourceLoaderFromFile.bin";
+  const ezUInt32 uiNumElements = 1024 * 16;
+
+  {
+    ezFileWriter file;
+    EZ_TEST_BOOL(file.Open(szFile) == EZ_SUCCESS);
+
+    file << uiNumElements;
+
+    for (ezUInt32 i = 0; i < uiNumElements; ++i)
+    {
+      file << i;
+    }
+  }
+
+  EZ_SCOPE_EXIT(ezFileSystem::DeleteFile(szFile));
+
+  {
+    // the loader only needs the resource ID, the resource itself is never loaded
+    TestResourceHandle hResource = ezResourceManager::LoadResource<TestResource>(szFile);
+    ezResourceLock<TestResource> pResource(hResource, ezResourceAcquireMode::PointerOnly);
+
+    ezResourceLoaderFromFile loader;
+
+    for (bool bMemoryMapped : {false, true})
+    {
+      EZ_TEST_BLOCK(ezTestBlock::Enabled, bMemoryMapped ? "Memory Mapped" : "Copy")
+      {
+        loader.SetUseMemoryMappedFiles(bMemoryMapped);
+
+        ezResourceLoadData ld = loader.OpenDataStream(pResource.GetPointer());
+
+        if (EZ_TEST_BOOL(ld.m_pDataStream != nullptr))
+        {
+          // read the header with the path and the file content in one go
+          ezDynamicArray<ezUInt8> data;
+          data.SetCountUninitialized(uiNumElements * sizeof(ezUInt32) + 1024);
+          const ezUInt64 uiBytesRead = ld.m_pDataStream->ReadBytes(data.GetData(), data.GetCount());
+
+          ezRawMemoryStreamReader s(data.GetData(), uiBytesRead);
+
+          ezStringBuilder sAbsolutePath;
+          s >> sAbsolutePath;
+          EZ_TEST_BOOL(sAbsolutePath.EndsWith("ResourceLoaderFromFile.bin"));
+
+          ezUInt32 uiReadElements = 0;
+          s >> uiReadElements;
+          EZ_TEST_INT(uiReadElements, uiNumElements);
+
+          bool bAllEqual = true;
+          for (ezUInt32 i = 0; i < uiNumElements; ++i)
+          {
+            ezUInt32 uiValue = 0;
+            s >> uiValue;
+            bAllEqual = bAllEqual && uiValue == i;
+          }
+
+          EZ_TEST_BOOL(bAllEqual);
+          EZ_TEST_INT(s.GetReadPosition(), uiBytesRead);
+          EZ_TEST_INT(ld.m_pDataStream->ReadBytes(data.GetData(), 1), 0);
+
+          // only the copy allocates memory for the file content
+          if (bMemoryMapped)
+            EZ_TEST_BOOL(ld.m_uiDataSize < uiNumElements * sizeof(ezUInt32));
+          else
+            EZ_TEST_BOOL(ld.m_uiDataSize > uiNumElements * sizeof(ezUInt32));
+        }
+
+        loader.CloseDataStream(pResource.GetPointer(), ld);
+      }
+    }
+  }
+
+  ezResourceManager::FreeAllUnusedResources();
+  EZ_TEST_INT(ezResourceManager::GetAllResourcesOfType<TestResource>()->GetCount(), 0);
+}
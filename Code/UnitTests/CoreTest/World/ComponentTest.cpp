@@ -138,6 +138,61 @@ namespace
   EZ_BEGIN_COMPONENT_TYPE(TestComponent2, 1, ezComponentMode::Static)
   EZ_END_COMPONENT_TYPE
 
+  struct TestComponent3HotData
+  {
+    ezInt32 m_iValue = 0;
+    ezUInt32 m_uiNumUpdates = 0;
+  };
+
+  class TestComponent3;
+  class TestComponent3Manager : public ezComponentManagerWithHotData<TestComponent3, TestComponent3HotData>
+  {
+  public:
+    TestComponent3Manager(ezWorld* pWorld)
+      : ezComponentManagerWithHotData<TestComponent3, TestComponent3HotData>(pWorld)
+    {
+    }
+
+    virtual void Initialize() override
+    {
+      auto desc = EZ_CREATE_MODULE_UPDATE_FUNCTION_DESC(TestComponent3Manager::Update, this);
+      desc.m_Phase = ezWorldModule::UpdateFunctionDesc::Phase::Async;
+      desc.m_uiGranularity = 20;
+
+      this->RegisterUpdateFunction(desc);
+    }
+
+    void Update(const ezWorldModule::UpdateContext& context);
+  };
+
+  class TestComponent3 : public ezComponent
+  {
+    EZ_DECLARE_COMPONENT_TYPE(TestComponent3, ezComponent, TestComponent3Manager);
+
+  public:
+    TestComponent3HotData& GetHotData() { return static_cast<TestComponent3Manager*>(GetOwningManager())->GetHotData(this); }
+
+    ezInt32 m_iExpectedValue = 0;
+  };
+
+  EZ_BEGIN_COMPONENT_TYPE(TestComponent3, 1, ezComponentMode::Static)
+  EZ_END_COMPONENT_TYPE
+
+  void TestComponent3Manager::Update(const ezWorldModule::UpdateContext& context)
+  {
+    ezArrayPtr<TestComponent3HotData> hotData = GetHotData();
+    ezUInt32 uiIndex = context.m_uiFirstComponentIndex;
+
+    for (auto it = this->m_ComponentStorage.GetIterator(context.m_uiFirstComponentIndex, context.m_uiComponentCount); it.IsValid(); ++it, ++uiIndex)
+    {
+      if (it->IsActiveAndInitialized())
+      {
+        hotData[uiIndex].m_iValue += 2;
+        hotData[uiIndex].m_uiNumUpdates++;
+      }
+    }
+  }
+
   void TestComponent::SpawnOther()
   {
     if (s_bSpawnOther)
@@ -499,6 +554,63 @@ EZ_CREATE_SIMPLE_TEST(World, Components)
     }
   }
 
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Component Hot Data")
+  {
+    ezGameObjectDesc desc;
+    ezGameObject* pObject = nullptr;
+    world.CreateObject(desc, pObject);
+
+    TestComponent3Manager* pHotManager = world.GetOrCreateComponentManager<TestComponent3Manager>();
+
+    ezDynamicArray<ezComponentHandle> handles;
+    for (ezInt32 i = 0; i < 100; ++i)
+    {
+      TestComponent3* pComponent = nullptr;
+      handles.PushBack(TestComponent3::CreateComponent(pObject, pComponent));
+
+      pComponent->GetHotData().m_iValue = i * 10;
+      pComponent->m_iExpectedValue = i * 10;
+    }
+
+    EZ_TEST_INT(pHotManager->GetHotData().GetCount(), 100);
+
+    world.Update();
+
+    // compact storage moves components around on deletion, the hot data has to follow them
+    for (ezUInt32 i = 0; i < handles.GetCount(); i += 3)
+    {
+      pHotManager->DeleteComponent(handles[i]);
+    }
+
+    world.Update();
+
+    EZ_TEST_INT(pHotManager->GetComponentCount(), 66);
+    EZ_TEST_INT(pHotManager->GetHotData().GetCount(), 66);
+
+    for (ezUInt32 i = 0; i < handles.GetCount(); ++i)
+    {
+      TestComponent3* pComponent = nullptr;
+      EZ_TEST_BOOL(world.TryGetComponent(handles[i], pComponent) == (i % 3 != 0));
+
+      if (pComponent != nullptr)
+      {
+        EZ_TEST_INT(pComponent->GetHotData().m_uiNumUpdates, 2);
+        EZ_TEST_INT(pComponent->GetHotData().m_iValue, pComponent->m_iExpectedValue + 4);
+      }
+    }
+
+    ezUInt32 uiIndex = 0;
+    for (auto it = pHotManager->GetComponents(); it.IsValid(); ++it, ++uiIndex)
+    {
+      EZ_TEST_BOOL(&it->GetHotData() == &pHotManager->GetHotData()[uiIndex]);
+    }
+
+    world.DeleteObjectNow(pObject->GetHandle());
+    world.Update();
+
+    EZ_TEST_INT(pHotManager->GetHotData().GetCount(), 0);
+  }
+
   EZ_TEST_BLOCK(ezTestBlock::Enabled, "Component dependent initialization")
   {
     ezGameObjectDesc desc;
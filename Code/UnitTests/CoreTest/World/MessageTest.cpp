@@ -33,6 +33,25 @@ namespace
     int m_iValue;
   };
 
+  static bool s_bDeliverInParallel = true;
+
+  struct TestMessageParallel : public ezMsgTest
+  {
+    EZ_DECLARE_MESSAGE_TYPE(TestMessageParallel, ezMsgTest);
+
+    virtual bool CanBeDeliveredInParallel() const override { return s_bDeliverInParallel; }
+
+    int m_iValue;
+  };
+
+  struct TestMessageParallelFirst : public ezMsgTest
+  {
+    EZ_DECLARE_MESSAGE_TYPE(TestMessageParallelFirst, ezMsgTest);
+
+    virtual ezInt32 GetSortingKey() const override { return -1; }
+    virtual bool CanBeDeliveredInParallel() const override { return s_bDeliverInParallel; }
+  };
+
   // clang-format off
   EZ_IMPLEMENT_MESSAGE_TYPE(TestMessage1);
   EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(TestMessage1, 1, ezRTTIDefaultAllocator<TestMessage1>)
@@ -41,6 +60,14 @@ namespace
   EZ_IMPLEMENT_MESSAGE_TYPE(TestMessage2);
   EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(TestMessage2, 1, ezRTTIDefaultAllocator<TestMessage2>)
   EZ_END_DYNAMIC_REFLECTED_TYPE;
+
+  EZ_IMPLEMENT_MESSAGE_TYPE(TestMessageParallel);
+  EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(TestMessageParallel, 1, ezRTTIDefaultAllocator<TestMessageParallel>)
+  EZ_END_DYNAMIC_REFLECTED_TYPE;
+
+  EZ_IMPLEMENT_MESSAGE_TYPE(TestMessageParallelFirst);
+  EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(TestMessageParallelFirst, 1, ezRTTIDefaultAllocator<TestMessageParallelFirst>)
+  EZ_END_DYNAMIC_REFLECTED_TYPE;
   // clang-format on
 
   class TestComponentMsg;
@@ -65,6 +92,11 @@ namespace
 
     void OnTestMessage2(TestMessage2& msg) { m_iSomeData2 += 2 * msg.m_iValue; }
 
+    // the result depends on the order in which the messages arrive
+    void OnTestMessageParallel(TestMessageParallel& msg) { m_iSomeData = m_iSomeData * 10 + msg.m_iValue; }
+
+    void OnTestMessageParallelFirst(TestMessageParallelFirst& msg) { m_iSomeData2 = m_iSomeData; }
+
     ezInt32 m_iSomeData;
     ezInt32 m_iSomeData2;
   };
@@ -76,6 +108,8 @@ namespace
     {
       EZ_MESSAGE_HANDLER(TestMessage1, OnTestMessage),
       EZ_MESSAGE_HANDLER(TestMessage2, OnTestMessage2),
+      EZ_MESSAGE_HANDLER(TestMessageParallel, OnTestMessageParallel),
+      EZ_MESSAGE_HANDLER(TestMessageParallelFirst, OnTestMessageParallelFirst),
     }
     EZ_END_MESSAGEHANDLERS;
   }
@@ -175,6 +209,60 @@ EZ_CREATE_SIMPLE_TEST(World, Messaging)
     }
   }
 
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Recursive Routing")
+  {
+    ResetComponents(*pRoot);
+
+    TestMessage1 msg;
+    msg.m_iValue = 4;
+    pParents[0]->SendMessageRecursive(msg);
+
+    TestComponentMsg* pComponent2 = nullptr;
+    pParents[0]->TryGetComponentOfBaseType(pComponent2);
+    EZ_TEST_INT(pComponent2->m_iSomeData, 5);
+
+    for (auto it = pParents[0]->GetChildren(); it.IsValid(); ++it)
+    {
+      it->TryGetComponentOfBaseType(pComponent2);
+      EZ_TEST_INT(pComponent2->m_iSomeData, 5);
+    }
+
+    pRoot->TryGetComponentOfBaseType(pComponent2);
+    EZ_TEST_INT(pComponent2->m_iSomeData, 1);
+    pParents[1]->TryGetComponentOfBaseType(pComponent2);
+    EZ_TEST_INT(pComponent2->m_iSomeData, 1);
+
+    // sub-trees without any component that handles the message are skipped, so handlers that are added later
+    // or re-parented objects need to be picked up as well
+    ezGameObjectDesc desc2;
+    desc2.m_sName.Assign("Unrelated");
+    ezGameObject* pUnrelated = nullptr;
+    world.CreateObject(desc2, pUnrelated);
+
+    desc2.m_hParent = pUnrelated->GetHandle();
+    ezGameObject* pUnrelatedChild = nullptr;
+    world.CreateObject(desc2, pUnrelatedChild);
+
+    pUnrelated->SendMessageRecursive(msg);
+
+    TestComponentMsg* pLateComponent = nullptr;
+    pManager->CreateComponent(pUnrelatedChild, pLateComponent);
+    world.Update();
+
+    pUnrelated->SendMessageRecursive(msg);
+    EZ_TEST_INT(pLateComponent->m_iSomeData, 5);
+
+    pUnrelatedChild->SetParent(pParents[1]->GetHandle());
+    pParents[1]->SendMessageRecursive(msg);
+    EZ_TEST_INT(pLateComponent->m_iSomeData, 9);
+
+    pParents[1]->TryGetComponentOfBaseType(pComponent2);
+    EZ_TEST_INT(pComponent2->m_iSomeData, 5);
+
+    world.DeleteObjectNow(pUnrelated->GetHandle());
+    world.DeleteObjectNow(pUnrelatedChild->GetHandle());
+  }
+
   EZ_TEST_BLOCK(ezTestBlock::Enabled, "Queuing")
   {
     ResetComponents(*pRoot);
@@ -235,4 +323,73 @@ EZ_CREATE_SIMPLE_TEST(World, Messaging)
 
     ezFrameAllocator::Reset();
   }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Parallel delivery")
+  {
+    ezDynamicArray<TestComponentMsg*> components;
+
+    desc.m_hParent.Invalidate();
+    for (ezUInt32 i = 0; i < 200; ++i)
+    {
+      ezGameObject* pObject = nullptr;
+      world.CreateObject(desc, pObject);
+      pManager->CreateComponent(pObject, pComponent);
+      components.PushBack(pComponent);
+    }
+
+    world.Update();
+
+    // the queue is sorted by the message hash for messages of the same type and receiver, so the same messages are delivered
+    // once serially and once in parallel and each receiver has to see them in the same order both times
+    ezDynamicArray<ezInt32> serialResults;
+
+    for (ezUInt32 uiPass = 0; uiPass < 2; ++uiPass)
+    {
+      s_bDeliverInParallel = uiPass == 1;
+
+      for (ezUInt32 i = 0; i < components.GetCount(); ++i)
+      {
+        components[i]->m_iSomeData = 1;
+        components[i]->m_iSomeData2 = 2;
+      }
+
+      for (ezInt32 iValue = 1; iValue <= 3; ++iValue)
+      {
+        for (ezUInt32 i = 0; i < components.GetCount(); ++i)
+        {
+          TestMessageParallel msg;
+          msg.m_iValue = iValue;
+
+          if (i % 2 == 0)
+            components[i]->GetOwner()->PostMessage(msg, ezTime::Zero(), ezObjectMsgQueueType::NextFrame);
+          else
+            components[i]->PostMessage(msg, ezTime::Zero(), ezObjectMsgQueueType::NextFrame);
+        }
+      }
+
+      // posted last, but has a smaller sorting key and thus needs to be delivered before all other messages
+      for (ezUInt32 i = 0; i < components.GetCount(); ++i)
+      {
+        TestMessageParallelFirst msg;
+        components[i]->GetOwner()->PostMessage(msg, ezTime::Zero(), ezObjectMsgQueueType::NextFrame);
+      }
+
+      world.Update();
+
+      for (ezUInt32 i = 0; i < components.GetCount(); ++i)
+      {
+        EZ_TEST_BOOL(components[i]->m_iSomeData > 1000);
+        EZ_TEST_INT(components[i]->m_iSomeData2, 1);
+
+        if (uiPass == 0)
+          serialResults.PushBack(components[i]->m_iSomeData);
+        else
+          EZ_TEST_INT(components[i]->m_iSomeData, serialResults[i]);
+      }
+    }
+
+    s_bDeliverInParallel = true;
+
+    ezFrameAllocator::Reset();
+  }
 }
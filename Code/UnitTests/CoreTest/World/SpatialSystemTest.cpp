@@ -1,12 +1,15 @@
 #include <CoreTestPCH.h>
 
 #include <Core/Messages/UpdateLocalBoundsMessage.h>
+#include <Core/World/SpatialSystem_LooseOctree.h>
+#include <Core/World/SpatialSystem_RegularGrid.h>
 #include <Core/World/World.h>
 #include <Foundation/Containers/HashSet.h>
 #include <Foundation/IO/FileSystem/DataDirTypeFolder.h>
 #include <Foundation/IO/FileSystem/FileSystem.h>
 #include <Foundation/IO/FileSystem/FileWriter.h>
 #include <Foundation/Profiling/Profiling.h>
+#include <Foundation/SimdMath/SimdConversion.h>
 
 namespace
 {
@@ -207,6 +210,339 @@ EZ_CREATE_SIMPLE_TEST(World, SpatialSystem)
     }
   }
 
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "FindVisibleObjects with occlusion")
+  {
+    ezFrustum frustum;
+    frustum.SetFrustum(ezVec3(-10000.0f, 0, 0), ezVec3(1, 0, 0), ezVec3(0, 0, 1), ezAngle::Degree(90.0f), ezAngle::Degree(90.0f), 0.1f, 30000.0f);
+
+    // acts like an infinite wall, everything that is completely behind it is occluded
+    const float fWallX = 2000.0f;
+    auto isOccluded = [&](const ezSimdBBox& box) { return ezSimdConversion::ToBBox(box).m_vMin.x > fWallX; };
+
+    ezDynamicArray<const ezGameObject*> visibleObjects;
+    ezHashSet<const ezGameObject*> uniqueObjects;
+    ezSpatialSystem::QueryStats stats;
+    world.GetSpatialSystem()->FindVisibleObjects(frustum, uiCategoryBitmask, visibleObjects, &stats, isOccluded);
+
+    for (auto pObject : visibleObjects)
+    {
+      EZ_TEST_BOOL(!uniqueObjects.Insert(pObject));
+      EZ_TEST_BOOL(pObject->GetGlobalBounds().GetBox().m_vMin.x <= fWallX);
+    }
+
+    ezUInt32 uiNumExpectedObjects = 0;
+    for (auto it = world.GetObjects(); it.IsValid(); ++it)
+    {
+      ezBoundingBoxSphere bounds = it->GetGlobalBounds();
+      if (it->IsStatic() && frustum.Overlaps(ezSimdConversion::ToBSphere(bounds.GetSphere())) && bounds.GetBox().m_vMin.x <= fWallX)
+      {
+        EZ_TEST_BOOL(uniqueObjects.Contains(it));
+        ++uiNumExpectedObjects;
+      }
+    }
+
+    EZ_TEST_INT(visibleObjects.GetCount(), uiNumExpectedObjects);
+    EZ_TEST_INT(stats.m_uiNumObjectsPassed, uiNumExpectedObjects);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Moving dynamic objects")
+  {
+    // the spatial data of dynamic objects is updated after the multi-threaded transform update, children have to end up there as well
+    for (ezUInt32 i = 500; i < 600; ++i)
+    {
+      ezGameObjectDesc desc;
+      desc.m_bDynamic = true;
+      desc.m_hParent = objects[i]->GetHandle();
+      desc.m_LocalPosition = ezVec3(10.0f, 0.0f, 0.0f);
+
+      ezGameObject* pChild = nullptr;
+      world.CreateObject(desc, pChild);
+
+      TestBoundsComponent* pComponent = nullptr;
+      TestBoundsComponent::CreateComponent(pChild, pComponent);
+    }
+
+    world.Update();
+
+    for (ezUInt32 i = 500; i < objects.GetCount(); ++i)
+    {
+      float x = (float)rng.DoubleMinMax(-range, range);
+      float y = (float)rng.DoubleMinMax(-range, range);
+      float z = (float)rng.DoubleMinMax(-range, range);
+
+      objects[i]->SetLocalPosition(ezVec3(x, y, z));
+    }
+
+    world.Update();
+
+    const ezUInt32 uiDynamicCategoryBitmask = ezDefaultSpatialDataCategories::RenderDynamic.GetBitmask();
+    ezBoundingSphere testSphere(ezVec3(100.0f, 60.0f, 400.0f), 5000.0f);
+
+    ezDynamicArray<ezGameObject*> objectsInSphere;
+    ezHashSet<ezGameObject*> uniqueObjects;
+    world.GetSpatialSystem()->FindObjectsInSphere(testSphere, uiDynamicCategoryBitmask, objectsInSphere);
+
+    for (auto pObject : objectsInSphere)
+    {
+      EZ_TEST_BOOL(testSphere.Overlaps(pObject->GetGlobalBounds().GetSphere()));
+      EZ_TEST_BOOL(!uniqueObjects.Insert(pObject));
+      EZ_TEST_BOOL(pObject->IsDynamic());
+    }
+
+    ezUInt32 uiNumChildrenInSphere = 0;
+    for (auto it = world.GetObjects(); it.IsValid(); ++it)
+    {
+      if (it->IsDynamic() && testSphere.Overlaps(it->GetGlobalBounds().GetSphere()))
+      {
+        EZ_TEST_BOOL(uniqueObjects.Contains(it));
+        uiNumChildrenInSphere += it->GetParent() != nullptr ? 1 : 0;
+      }
+    }
+
+    EZ_TEST_BOOL(uiNumChildrenInSphere > 0);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "UpdateSpatialDataBatch")
+  {
+    ezSpatialSystem_RegularGrid grid;
+
+    const ezUInt32 uiCategoryA = ezDefaultSpatialDataCategories::RenderStatic.GetBitmask();
+    const ezUInt32 uiCategoryB = s_SpecialTestCategory.GetBitmask();
+
+    auto GetRandomBounds = [&](const ezSimdVec4f& vCenter) {
+      float x = (float)rng.DoubleMinMax(1.0, 20.0);
+      float y = (float)rng.DoubleMinMax(1.0, 20.0);
+      float z = (float)rng.DoubleMinMax(1.0, 20.0);
+
+      ezSimdBBox box;
+      box.SetCenterAndHalfExtents(vCenter, ezSimdVec4f(x, y, z));
+      return ezSimdBBoxSphere(box);
+    };
+
+    auto GetRandomPosition = [&](double fRange) {
+      float x = (float)rng.DoubleMinMax(-fRange, fRange);
+      float y = (float)rng.DoubleMinMax(-fRange, fRange);
+      float z = (float)rng.DoubleMinMax(-fRange, fRange);
+      return ezSimdVec4f(x, y, z);
+    };
+
+    ezDynamicArray<ezSpatialSystem::SpatialDataUpdate> updates;
+    updates.Reserve(objects.GetCount());
+
+    for (ezGameObject* pObject : objects)
+    {
+      auto& update = updates.ExpandAndGetRef();
+      update.m_Bounds = GetRandomBounds(GetRandomPosition(2000.0));
+      update.m_pObject = pObject;
+      update.m_uiCategoryBitmask = uiCategoryA;
+      update.m_hData = grid.CreateSpatialData(update.m_Bounds, pObject, update.m_uiCategoryBitmask);
+    }
+
+    for (ezUInt32 uiRound = 0; uiRound < 3; ++uiRound)
+    {
+      // mix of moves within the same cell, moves to other cells, category changes and no changes at all
+      for (ezUInt32 i = 0; i < updates.GetCount(); ++i)
+      {
+        auto& update = updates[i];
+        switch ((i + uiRound) % 4)
+        {
+          case 0:
+            update.m_Bounds = GetRandomBounds(update.m_Bounds.m_CenterAndRadius + GetRandomPosition(2.0));
+            break;
+          case 1:
+            update.m_Bounds = GetRandomBounds(GetRandomPosition(2000.0));
+            break;
+          case 2:
+            update.m_uiCategoryBitmask = (update.m_uiCategoryBitmask == uiCategoryA) ? (uiCategoryA | uiCategoryB) : uiCategoryA;
+            break;
+          default:
+            break;
+        }
+      }
+
+      grid.UpdateSpatialDataBatch(updates);
+
+      for (ezUInt32 uiCategory : {uiCategoryA, uiCategoryB})
+      {
+        ezBoundingSphere testSphere(ezSimdConversion::ToVec3(GetRandomPosition(500.0)), 1500.0f);
+        ezSimdBSphere simdTestSphere(ezSimdConversion::ToVec3(testSphere.m_vCenter), testSphere.m_fRadius);
+
+        ezDynamicArray<ezGameObject*> objectsInSphere;
+        grid.FindObjectsInSphere(testSphere, uiCategory, objectsInSphere);
+
+        ezHashSet<ezGameObject*> uniqueObjects;
+        for (auto pObject : objectsInSphere)
+        {
+          EZ_TEST_BOOL(!uniqueObjects.Insert(pObject));
+        }
+
+        ezUInt32 uiExpectedCount = 0;
+        for (auto& update : updates)
+        {
+          if ((update.m_uiCategoryBitmask & uiCategory) != 0 && simdTestSphere.Overlaps(update.m_Bounds.GetSphere()))
+          {
+            EZ_TEST_BOOL(uniqueObjects.Contains(update.m_pObject));
+            ++uiExpectedCount;
+          }
+        }
+
+        EZ_TEST_INT(objectsInSphere.GetCount(), uiExpectedCount);
+        EZ_TEST_BOOL(uiExpectedCount > 0);
+      }
+    }
+
+    for (auto& update : updates)
+    {
+      grid.DeleteSpatialData(update.m_hData);
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "VisibilityCache")
+  {
+    ezSpatialSystem_RegularGrid grid;
+
+    const ezUInt32 uiCategoryA = ezDefaultSpatialDataCategories::RenderStatic.GetBitmask();
+    const ezUInt32 uiCategoryB = s_SpecialTestCategory.GetBitmask();
+
+    auto GetRandomPosition = [&](double fRange) {
+      float x = (float)rng.DoubleMinMax(-fRange, fRange);
+      float y = (float)rng.DoubleMinMax(-fRange, fRange);
+      float z = (float)rng.DoubleMinMax(-fRange, fRange);
+      return ezSimdVec4f(x, y, z);
+    };
+
+    auto GetRandomBounds = [&](const ezSimdVec4f& vCenter) {
+      ezSimdBBox box;
+      box.SetCenterAndHalfExtents(vCenter, GetRandomPosition(20.0).Abs() + ezSimdVec4f(1.0f));
+      return ezSimdBBoxSphere(box);
+    };
+
+    ezDynamicArray<ezSpatialSystem::SpatialDataUpdate> updates;
+    for (ezGameObject* pObject : objects)
+    {
+      auto& update = updates.ExpandAndGetRef();
+      update.m_Bounds = GetRandomBounds(GetRandomPosition(1500.0));
+      update.m_pObject = pObject;
+      update.m_uiCategoryBitmask = uiCategoryA;
+      update.m_hData = grid.CreateSpatialData(update.m_Bounds, pObject, update.m_uiCategoryBitmask);
+    }
+
+    ezUniquePtr<ezSpatialSystem::VisibilityCache> pCache = grid.CreateVisibilityCache();
+    EZ_TEST_BOOL(pCache != nullptr);
+    EZ_TEST_BOOL(grid.IsVisibilityCacheValid(pCache.Borrow()));
+    EZ_TEST_BOOL(!world.GetSpatialSystem()->IsVisibilityCacheValid(pCache.Borrow()));
+
+    // acts like an infinite wall
+    auto isOccluded = [&](const ezSimdBBox& box) { return ezSimdConversion::ToBBox(box).m_vMin.y > 800.0f; };
+
+    // Compares the cached query with an uncached one and returns the number of objects that were taken from the cache
+    auto CheckQuery = [&](const ezVec3& vPosition, const ezVec3& vForward, bool bOcclusion) {
+      ezFrustum frustum;
+      frustum.SetFrustum(vPosition, vForward, ezVec3(0, 0, 1), ezAngle::Degree(90.0f), ezAngle::Degree(60.0f), 0.1f, 2000.0f);
+
+      ezSpatialSystem::IsOccludedCallback callback;
+      if (bOcclusion)
+      {
+        callback = isOccluded;
+      }
+
+      ezDynamicArray<const ezGameObject*> expectedObjects;
+      grid.FindVisibleObjects(frustum, uiCategoryA, expectedObjects, nullptr, callback);
+
+      ezDynamicArray<const ezGameObject*> cachedObjects;
+      ezSpatialSystem::QueryStats stats;
+      grid.FindVisibleObjects(frustum, uiCategoryA, cachedObjects, &stats, callback, pCache.Borrow());
+
+      ezHashSet<const ezGameObject*> uniqueObjects;
+      for (auto pObject : cachedObjects)
+      {
+        EZ_TEST_BOOL(!uniqueObjects.Insert(pObject));
+      }
+
+      for (auto pObject : expectedObjects)
+      {
+        EZ_TEST_BOOL(uniqueObjects.Contains(pObject));
+      }
+
+      EZ_TEST_INT(cachedObjects.GetCount(), expectedObjects.GetCount());
+      EZ_TEST_BOOL(!expectedObjects.IsEmpty());
+
+      return stats.m_uiNumObjectsCached;
+    };
+
+    const ezVec3 vPosition(-1600.0f, 0.0f, 0.0f);
+    const ezVec3 vForward(1.0f, 0.0f, 0.0f);
+
+    CheckQuery(vPosition, vForward, false);
+
+    // nothing changed, so everything should be taken from the cache
+    ezUInt32 uiNumCached = CheckQuery(vPosition, vForward, false);
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+    EZ_TEST_BOOL(uiNumCached > 0);
+#endif
+
+    CheckQuery(vPosition, vForward, true);
+
+    // small camera movements only invalidate the cells close to the moved planes
+    for (ezUInt32 i = 0; i < 5; ++i)
+    {
+      ezVec3 vNewForward = vForward + ezSimdConversion::ToVec3(GetRandomPosition(0.05));
+      vNewForward.Normalize();
+
+      CheckQuery(vPosition + ezSimdConversion::ToVec3(GetRandomPosition(10.0)), vNewForward, (i % 2) != 0);
+    }
+
+    for (ezUInt32 uiRound = 0; uiRound < 4; ++uiRound)
+    {
+      // moves within the same cell, moves to other cells and category changes
+      for (ezUInt32 i = uiRound; i < updates.GetCount(); i += 4)
+      {
+        auto& update = updates[i];
+        if (uiRound == 2)
+        {
+          update.m_uiCategoryBitmask = (update.m_uiCategoryBitmask == uiCategoryA) ? uiCategoryB : uiCategoryA;
+        }
+        else
+        {
+          update.m_Bounds = GetRandomBounds(update.m_Bounds.m_CenterAndRadius + GetRandomPosition(uiRound == 0 ? 2.0 : 500.0));
+        }
+
+        if (uiRound == 3)
+        {
+          grid.UpdateSpatialData(update.m_hData, update.m_Bounds, update.m_pObject, update.m_uiCategoryBitmask);
+        }
+      }
+
+      if (uiRound != 3)
+      {
+        grid.UpdateSpatialDataBatch(updates);
+      }
+
+      CheckQuery(vPosition, vForward, false);
+      CheckQuery(vPosition, vForward, true);
+    }
+
+    // deleting objects moves other spatial data in memory
+    for (ezUInt32 i = 0; i < updates.GetCount(); i += 3)
+    {
+      grid.DeleteSpatialData(updates[i].m_hData);
+    }
+
+    CheckQuery(vPosition, vForward, false);
+    CheckQuery(vPosition, ezVec3(0.0f, 1.0f, 0.0f), false);
+    CheckQuery(vPosition, ezVec3(0.0f, 1.0f, 0.0f), false);
+
+    pCache = nullptr;
+
+    for (ezUInt32 i = 0; i < updates.GetCount(); ++i)
+    {
+      if (i % 3 != 0)
+      {
+        grid.DeleteSpatialData(updates[i].m_hData);
+      }
+    }
+  }
+
   if (false)
   {
     ezStringBuilder outputPath = ezTestFramework::GetInstance()->GetAbsOutputPath();
@@ -249,3 +585,175 @@ EZ_CREATE_SIMPLE_TEST(World, SpatialSystem)
 
   world.Update();
 }
+
+EZ_CREATE_SIMPLE_TEST(World, SpatialSystem_LooseOctree)
+{
+  ezWorldDesc worldDesc("Test");
+  worldDesc.m_uiRandomNumberGeneratorSeed = 7;
+
+  // the octree is smaller than the scene, so some objects have to end up in its root node
+  worldDesc.m_pSpatialSystem = EZ_NEW(ezFoundation::GetAlignedAllocator(), ezSpatialSystem_LooseOctree, 16384, 16);
+
+  ezWorld world(worldDesc);
+  EZ_LOCK(world.GetWriteMarker());
+
+  auto& rng = world.GetRandomNumberGenerator();
+
+  auto GetRandomPosition = [&](const ezVec3& vCenter, double fRange) {
+    float x = (float)rng.DoubleMinMax(-fRange, fRange);
+    float y = (float)rng.DoubleMinMax(-fRange, fRange);
+    float z = (float)rng.DoubleMinMax(-fRange, fRange);
+    return vCenter + ezVec3(x, y, z);
+  };
+
+  const ezVec3 vDenseCenter(500.0f, -300.0f, 200.0f);
+
+  ezDynamicArray<ezGameObject*> objects;
+  objects.Reserve(1500);
+
+  // a dense cluster, sparse objects all over the place and a few huge objects
+  for (ezUInt32 i = 0; i < 1500; ++i)
+  {
+    ezGameObjectDesc desc;
+    desc.m_bDynamic = (i % 2) != 0;
+    desc.m_LocalPosition = i < 1000 ? GetRandomPosition(vDenseCenter, 300.0) : GetRandomPosition(ezVec3::ZeroVector(), 12000.0);
+    desc.m_LocalScaling = ezVec3((i % 100) == 0 ? 50.0f : 1.0f);
+
+    ezGameObject* pObject = nullptr;
+    world.CreateObject(desc, pObject);
+
+    objects.PushBack(pObject);
+
+    TestBoundsComponent* pComponent = nullptr;
+    TestBoundsComponent::CreateComponent(pObject, pComponent);
+  }
+
+  world.Update();
+
+  auto GetCategoryBitmask = [](const ezGameObject* pObject) {
+    return pObject->IsDynamic() ? ezDefaultSpatialDataCategories::RenderDynamic.GetBitmask() : ezDefaultSpatialDataCategories::RenderStatic.GetBitmask();
+  };
+
+  // Compares the query results with a brute force test of all objects' bounding spheres
+  auto CheckResults = [&](const auto& foundObjects, ezUInt32 uiCategoryBitmask, auto isInQueryVolume) {
+    ezHashSet<const ezGameObject*> uniqueObjects;
+    for (auto pObject : foundObjects)
+    {
+      EZ_TEST_BOOL(!uniqueObjects.Insert(pObject));
+    }
+
+    ezUInt32 uiExpectedCount = 0;
+    for (auto it = world.GetObjects(); it.IsValid(); ++it)
+    {
+      if ((GetCategoryBitmask(it) & uiCategoryBitmask) != 0 && isInQueryVolume(ezSimdConversion::ToBBoxSphere(it->GetGlobalBounds())))
+      {
+        EZ_TEST_BOOL(uniqueObjects.Contains(it));
+        ++uiExpectedCount;
+      }
+    }
+
+    EZ_TEST_INT(foundObjects.GetCount(), uiExpectedCount);
+  };
+
+  auto CheckQueries = [&]() {
+    const ezSpatialSystem& octree = *world.GetSpatialSystem();
+
+    for (ezUInt32 uiCategoryBitmask : {ezDefaultSpatialDataCategories::RenderStatic.GetBitmask(),
+           ezDefaultSpatialDataCategories::RenderStatic.GetBitmask() | ezDefaultSpatialDataCategories::RenderDynamic.GetBitmask()})
+    {
+      for (ezUInt32 i = 0; i < 10; ++i)
+      {
+        const ezVec3 vCenter = (i % 2) == 0 ? GetRandomPosition(vDenseCenter, 300.0) : GetRandomPosition(ezVec3::ZeroVector(), 10000.0);
+
+        {
+          ezBoundingSphere testSphere(vCenter, (float)rng.DoubleMinMax(50.0, 4000.0));
+          ezSimdBSphere simdTestSphere = ezSimdConversion::ToBSphere(testSphere);
+
+          ezDynamicArray<ezGameObject*> foundObjects;
+          octree.FindObjectsInSphere(testSphere, uiCategoryBitmask, foundObjects);
+
+          CheckResults(foundObjects, uiCategoryBitmask, [&](const ezSimdBBoxSphere& bounds) { return simdTestSphere.Overlaps(bounds.GetSphere()); });
+        }
+
+        {
+          ezBoundingBox testBox;
+          testBox.SetCenterAndHalfExtents(vCenter, GetRandomPosition(ezVec3(3000.0f), 2900.0));
+          ezSimdBBox simdTestBox = ezSimdConversion::ToBBox(testBox);
+
+          ezDynamicArray<ezGameObject*> foundObjects;
+          octree.FindObjectsInBox(testBox, uiCategoryBitmask, foundObjects);
+
+          CheckResults(foundObjects, uiCategoryBitmask, [&](const ezSimdBBoxSphere& bounds) {
+            return simdTestBox.Overlaps(bounds.GetSphere()) && simdTestBox.Overlaps(bounds.GetBox());
+          });
+        }
+
+        {
+          ezVec3 vForward = GetRandomPosition(ezVec3::ZeroVector(), 1.0);
+          vForward.NormalizeIfNotZero(ezVec3(1, 0, 0)).IgnoreResult();
+
+          ezFrustum frustum;
+          frustum.SetFrustum(vCenter, vForward, ezVec3(0, 0, 1), ezAngle::Degree(90.0f), ezAngle::Degree(60.0f), 0.1f, 5000.0f);
+
+          ezDynamicArray<const ezGameObject*> foundObjects;
+          octree.FindVisibleObjects(frustum, uiCategoryBitmask, foundObjects);
+
+          CheckResults(foundObjects, uiCategoryBitmask, [&](const ezSimdBBoxSphere& bounds) { return frustum.Overlaps(bounds.GetSphere()); });
+
+          // everything that is completely behind a plane in front of the frustum origin counts as occluded
+          const float fWallDistance = 1000.0f;
+          auto isOccluded = [&](const ezSimdBBox& box) {
+            ezBoundingBox b = ezSimdConversion::ToBBox(box);
+            const float fMinDistance = (b.GetCenter() - vCenter).Dot(vForward) - b.GetHalfExtents().Dot(vForward.Abs());
+            return fMinDistance > fWallDistance;
+          };
+
+          foundObjects.Clear();
+          octree.FindVisibleObjects(frustum, uiCategoryBitmask, foundObjects, nullptr, isOccluded);
+
+          CheckResults(foundObjects, uiCategoryBitmask, [&](const ezSimdBBoxSphere& bounds) { return frustum.Overlaps(bounds.GetSphere()) && !isOccluded(bounds.GetBox()); });
+        }
+      }
+    }
+  };
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Queries")
+  {
+    CheckQueries();
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Moving objects")
+  {
+    for (ezUInt32 uiRound = 0; uiRound < 3; ++uiRound)
+    {
+      for (ezUInt32 i = 1; i < objects.GetCount(); i += 2)
+      {
+        ezGameObject* pObject = objects[i];
+        const double fRange = ((i / 2 + uiRound) % 3) == 0 ? 5000.0 : 5.0;
+        pObject->SetLocalPosition(GetRandomPosition(pObject->GetLocalPosition(), fRange));
+      }
+
+      world.Update();
+
+      CheckQueries();
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Deleting objects")
+  {
+    ezDynamicArray<ezGameObjectHandle> objectHandles;
+    for (ezUInt32 i = 0; i < objects.GetCount(); i += 3)
+    {
+      objectHandles.PushBack(objects[i]->GetHandle());
+    }
+
+    for (const ezGameObjectHandle& hObject : objectHandles)
+    {
+      world.DeleteObjectNow(hObject);
+    }
+
+    world.Update();
+
+    CheckQueries();
+  }
+}
@@ -1,7 +1,15 @@
 #include <CoreTestPCH.h>
 
+#include <Core/World/SpatialSystem_LooseOctree.h>
+#include <Core/World/SpatialSystem_RegularGrid.h>
 #include <Core/World/World.h>
+#include <Core/WorldSerializer/WorldReader.h>
+#include <Core/WorldSerializer/WorldWriter.h>
+#include <Foundation/IO/MemoryStream.h>
+#include <Foundation/Math/Random.h>
+#include <Foundation/SimdMath/SimdConversion.h>
 #include <Foundation/Time/Clock.h>
+#include <Foundation/Threading/ThreadUtils.h>
 #include <Foundation/Time/Stopwatch.h>
 
 namespace
@@ -56,6 +64,235 @@ namespace
   EZ_END_COMPONENT_TYPE;
   // clang-format on
 
+  struct ezMsgPerfTest : public ezMessage
+  {
+    EZ_DECLARE_MESSAGE_TYPE(ezMsgPerfTest, ezMessage);
+
+    ezUInt32 m_uiNumReceived;
+  };
+
+  struct ezMsgPerfTestUnhandled : public ezMessage
+  {
+    EZ_DECLARE_MESSAGE_TYPE(ezMsgPerfTestUnhandled, ezMessage);
+  };
+
+  // clang-format off
+  EZ_IMPLEMENT_MESSAGE_TYPE(ezMsgPerfTest);
+  EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezMsgPerfTest, 1, ezRTTIDefaultAllocator<ezMsgPerfTest>)
+  EZ_END_DYNAMIC_REFLECTED_TYPE;
+
+  EZ_IMPLEMENT_MESSAGE_TYPE(ezMsgPerfTestUnhandled);
+  EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezMsgPerfTestUnhandled, 1, ezRTTIDefaultAllocator<ezMsgPerfTestUnhandled>)
+  EZ_END_DYNAMIC_REFLECTED_TYPE;
+  // clang-format on
+
+  class ezTestMessageComponent;
+  typedef ezComponentManager<ezTestMessageComponent, ezBlockStorageType::Compact> ezTestMessageComponentManager;
+
+  class ezTestMessageComponent : public ezComponent
+  {
+    EZ_DECLARE_COMPONENT_TYPE(ezTestMessageComponent, ezComponent, ezTestMessageComponentManager);
+
+  public:
+    void OnPerfTest(ezMsgPerfTest& msg) { ++msg.m_uiNumReceived; }
+  };
+
+  // clang-format off
+  EZ_BEGIN_COMPONENT_TYPE(ezTestMessageComponent, 1, ezComponentMode::Static)
+  {
+    EZ_BEGIN_MESSAGEHANDLERS
+    {
+      EZ_MESSAGE_HANDLER(ezMsgPerfTest, OnPerfTest),
+    }
+    EZ_END_MESSAGEHANDLERS;
+  }
+  EZ_END_COMPONENT_TYPE;
+  // clang-format on
+
+  // the per frame state of a rotor like animation component
+  struct ezTestAnimationState
+  {
+    bool m_bRunning = false;
+    float m_fDegreesPerSecond = 90.0f;
+    ezTime m_AnimationTime;
+    ezVec3 m_vRotationAxis = ezVec3(0, 0, 1);
+  };
+
+  EZ_FORCE_INLINE void AnimateOwner(ezTestAnimationState& state, ezGameObject* pOwner, ezTime tDiff)
+  {
+    state.m_AnimationTime += tDiff;
+
+    ezQuat qRotation;
+    qRotation.SetFromAxisAndAngle(state.m_vRotationAxis, ezAngle::Degree(state.m_fDegreesPerSecond * state.m_AnimationTime.AsFloatInSeconds()));
+    pOwner->SetLocalRotation(qRotation);
+  }
+
+  class ezTestAnimComponent;
+  class ezTestAnimComponentManager : public ezComponentManager<ezTestAnimComponent, ezBlockStorageType::Compact>
+  {
+  public:
+    ezTestAnimComponentManager(ezWorld* pWorld)
+      : ezComponentManager<ezTestAnimComponent, ezBlockStorageType::Compact>(pWorld)
+    {
+    }
+
+    virtual void Initialize() override
+    {
+      auto desc = EZ_CREATE_MODULE_UPDATE_FUNCTION_DESC(ezTestAnimComponentManager::Update, this);
+      RegisterUpdateFunction(desc);
+    }
+
+    void Update(const ezWorldModule::UpdateContext& context);
+
+    ezTestAnimationState& GetAnimationState(ezTestAnimComponent* pComponent);
+
+    ezTime m_UpdateTime;
+  };
+
+  /// \brief Keeps its animation state inside of the component object, next to data that the update does not need.
+  class ezTestAnimComponent : public ezComponent
+  {
+    EZ_DECLARE_COMPONENT_TYPE(ezTestAnimComponent, ezComponent, ezTestAnimComponentManager);
+
+  public:
+    ezUInt8 m_ColdData[96]; // stands in for properties and resource handles
+    ezTestAnimationState m_State;
+  };
+
+  // clang-format off
+  EZ_BEGIN_COMPONENT_TYPE(ezTestAnimComponent, 1, ezComponentMode::Dynamic);
+  EZ_END_COMPONENT_TYPE;
+  // clang-format on
+
+  void ezTestAnimComponentManager::Update(const ezWorldModule::UpdateContext& context)
+  {
+    ezStopwatch sw;
+    const ezTime tDiff = GetWorld()->GetClock().GetTimeDiff();
+
+    for (auto it = this->m_ComponentStorage.GetIterator(context.m_uiFirstComponentIndex, context.m_uiComponentCount); it.IsValid(); ++it)
+    {
+      ComponentType* pComponent = it;
+      if (pComponent->IsActiveAndInitialized() && pComponent->m_State.m_bRunning)
+      {
+        AnimateOwner(pComponent->m_State, pComponent->GetOwner(), tDiff);
+      }
+    }
+
+    m_UpdateTime += sw.GetRunningTotal();
+  }
+
+  ezTestAnimationState& ezTestAnimComponentManager::GetAnimationState(ezTestAnimComponent* pComponent) { return pComponent->m_State; }
+
+  class ezTestHotAnimComponent;
+  class ezTestHotAnimComponentManager : public ezComponentManagerWithHotData<ezTestHotAnimComponent, ezTestAnimationState>
+  {
+  public:
+    ezTestHotAnimComponentManager(ezWorld* pWorld)
+      : ezComponentManagerWithHotData<ezTestHotAnimComponent, ezTestAnimationState>(pWorld)
+    {
+    }
+
+    virtual void Initialize() override
+    {
+      auto desc = EZ_CREATE_MODULE_UPDATE_FUNCTION_DESC(ezTestHotAnimComponentManager::Update, this);
+      RegisterUpdateFunction(desc);
+    }
+
+    void Update(const ezWorldModule::UpdateContext& context);
+
+    ezTestAnimationState& GetAnimationState(ezTestHotAnimComponent* pComponent);
+
+    ezTime m_UpdateTime;
+  };
+
+  /// \brief Same as ezTestAnimComponent but the animation state is kept in the hot data of the manager.
+  class ezTestHotAnimComponent : public ezComponent
+  {
+    EZ_DECLARE_COMPONENT_TYPE(ezTestHotAnimComponent, ezComponent, ezTestHotAnimComponentManager);
+
+  public:
+    ezUInt8 m_ColdData[96];
+  };
+
+  // clang-format off
+  EZ_BEGIN_COMPONENT_TYPE(ezTestHotAnimComponent, 1, ezComponentMode::Dynamic);
+  EZ_END_COMPONENT_TYPE;
+  // clang-format on
+
+  void ezTestHotAnimComponentManager::Update(const ezWorldModule::UpdateContext& context)
+  {
+    ezStopwatch sw;
+    const ezTime tDiff = GetWorld()->GetClock().GetTimeDiff();
+
+    ezArrayPtr<ezTestAnimationState> hotData = GetHotData();
+    ezUInt32 uiIndex = context.m_uiFirstComponentIndex;
+
+    // the component objects are only touched for the ones that are actually animated
+    for (auto it = this->m_ComponentStorage.GetIterator(context.m_uiFirstComponentIndex, context.m_uiComponentCount); it.IsValid(); ++it, ++uiIndex)
+    {
+      ezTestAnimationState& state = hotData[uiIndex];
+      if (state.m_bRunning)
+      {
+        ComponentType* pComponent = it;
+        if (pComponent->IsActiveAndInitialized())
+        {
+          AnimateOwner(state, pComponent->GetOwner(), tDiff);
+        }
+      }
+    }
+
+    m_UpdateTime += sw.GetRunningTotal();
+  }
+
+  ezTestAnimationState& ezTestHotAnimComponentManager::GetAnimationState(ezTestHotAnimComponent* pComponent)
+  {
+    return GetHotData(pComponent);
+  }
+
+  template <typename ManagerType>
+  ezTime MeasureAnimationUpdate(ezUInt32 uiNumComponents, ezUInt32 uiRunningEveryNth)
+  {
+    ezWorldDesc worldDesc("Test");
+    ezWorld world(worldDesc);
+    EZ_LOCK(world.GetWriteMarker());
+
+    ManagerType* pManager = world.GetOrCreateComponentManager<ManagerType>();
+
+    ezGameObjectDesc gd;
+    gd.m_bDynamic = true;
+
+    for (ezUInt32 i = 0; i < uiNumComponents; ++i)
+    {
+      ezGameObject* pObject;
+      world.CreateObject(gd, pObject);
+
+      typename ManagerType::ComponentType* pComponent;
+      pManager->CreateComponent(pObject, pComponent);
+      pManager->GetAnimationState(pComponent).m_bRunning = (i % uiRunningEveryNth) == 0;
+    }
+
+    // first round always has some overhead
+    world.Update();
+    pManager->m_UpdateTime.SetZero();
+
+    const ezUInt32 uiNumFrames = 10;
+    for (ezUInt32 i = 0; i < uiNumFrames; ++i)
+    {
+      world.Update();
+    }
+
+    return pManager->m_UpdateTime / uiNumFrames;
+  }
+
+  void MeasureAnimationUpdate(ezUInt32 uiNumComponents, ezUInt32 uiRunningEveryNth)
+  {
+    const ezTime tObjects = MeasureAnimationUpdate<ezTestAnimComponentManager>(uiNumComponents, uiRunningEveryNth);
+    const ezTime tHotData = MeasureAnimationUpdate<ezTestHotAnimComponentManager>(uiNumComponents, uiRunningEveryNth);
+
+    ezTestFramework::Output(ezTestOutput::Duration, "Updating %u animation components (%u running): %.3fms, with hot data: %.3fms",
+      uiNumComponents, uiNumComponents / uiRunningEveryNth, tObjects.GetMilliseconds(), tHotData.GetMilliseconds());
+  }
+
   void AddObjectsToWorld(ezWorld& world, bool bDynamic, ezUInt32 uiNumObjects, ezUInt32 uiTreeLevelNumNodeDiv, ezUInt32 uiTreeDepth,
     ezInt32 iAttachCompsDepth, ezGameObjectHandle hParent = ezGameObjectHandle())
   {
@@ -115,6 +352,383 @@ namespace
     }
   }
 
+  // Creates the same objects once one at a time and once with a single call to CreateObjects(). With a depth > 1 every object
+  // is parented to one of the objects of the previous level.
+  void MeasureBulkCreationTime(ezUInt32 uiNumObjects, ezUInt32 uiTreeDepth)
+  {
+    ezDynamicArray<ezGameObjectDesc> descs;
+    ezDynamicArray<ezUInt32> parentIndices;
+    descs.SetCount(uiNumObjects);
+    parentIndices.SetCountUninitialized(uiNumObjects);
+
+    const ezUInt32 uiObjectsPerLevel = uiNumObjects / uiTreeDepth;
+    for (ezUInt32 i = 0; i < uiNumObjects; ++i)
+    {
+      descs[i].m_LocalPosition.Set((i % uiObjectsPerLevel) * 5.0f, (i / uiObjectsPerLevel) * 5.0f, 0);
+      parentIndices[i] = i < uiObjectsPerLevel ? ezInvalidIndex : i - uiObjectsPerLevel;
+    }
+
+    ezDynamicArray<ezGameObjectHandle> handles;
+    handles.SetCountUninitialized(uiNumObjects);
+
+    ezTime tSingle;
+    {
+      ezWorldDesc worldDesc("Test");
+      ezWorld world(worldDesc);
+      EZ_LOCK(world.GetWriteMarker());
+
+      ezStopwatch sw;
+
+      for (ezUInt32 i = 0; i < uiNumObjects; ++i)
+      {
+        if (parentIndices[i] != ezInvalidIndex)
+        {
+          descs[i].m_hParent = handles[parentIndices[i]];
+        }
+
+        handles[i] = world.CreateObject(descs[i]);
+      }
+
+      tSingle = sw.Checkpoint();
+    }
+
+    ezTime tBulk;
+    {
+      ezWorldDesc worldDesc("Test");
+      ezWorld world(worldDesc);
+      EZ_LOCK(world.GetWriteMarker());
+
+      ezStopwatch sw;
+
+      world.CreateObjects(descs, parentIndices, handles);
+
+      tBulk = sw.Checkpoint();
+    }
+
+    ezTestFramework::Output(ezTestOutput::Duration, "Creating %u objects (depth: %u) one at a time: %.2fms, in bulk: %.2fms", uiNumObjects,
+      uiTreeDepth, tSingle.GetMilliseconds(), tBulk.GetMilliseconds());
+  }
+
+  // Instantiates the same prefab at once, in steps and in steps with the preparation on a worker thread.
+  // Reports the longest time a single call blocked the world thread and the total time spent on the world thread.
+  void MeasurePrefabInstantiation(ezUInt32 uiNumRootObjects, ezUInt32 uiNumChildrenPerRoot)
+  {
+    ezMemoryStreamStorage storage;
+
+    {
+      ezWorldDesc worldDesc("Source");
+      ezWorld world(worldDesc);
+      EZ_LOCK(world.GetWriteMarker());
+
+      for (ezUInt32 uiRoot = 0; uiRoot < uiNumRootObjects; ++uiRoot)
+      {
+        ezGameObjectDesc desc;
+        desc.m_LocalPosition.Set(uiRoot * 5.0f, 0.0f, 0.0f);
+
+        const ezGameObjectHandle hRoot = world.CreateObject(desc);
+        desc.m_hParent = hRoot;
+
+        for (ezUInt32 uiChild = 0; uiChild < uiNumChildrenPerRoot; ++uiChild)
+        {
+          // every other child is parented to the previous one
+          desc.m_LocalPosition.Set(0.0f, 1.0f, 0.0f);
+          const ezGameObjectHandle hChild = world.CreateObject(desc);
+          desc.m_hParent = (uiChild % 2) == 0 ? hChild : hRoot;
+        }
+      }
+
+      ezMemoryStreamWriter writer(&storage);
+      ezWorldWriter worldWriter;
+      worldWriter.WriteWorld(writer, world);
+    }
+
+    ezMemoryStreamReader memReader(&storage);
+    ezWorldReader worldReader;
+    EZ_TEST_BOOL(worldReader.ReadWorldDescription(memReader).Succeeded());
+
+    const char* szModes[] = {"at once", "in steps", "in steps, prepared on a worker"};
+
+    for (ezUInt32 uiMode = 0; uiMode < EZ_ARRAY_SIZE(szModes); ++uiMode)
+    {
+      ezWorldDesc worldDesc("Test");
+      ezWorld world(worldDesc);
+
+      ezPrefabInstantiationOptions options;
+      options.m_MaxStepTime = uiMode == 0 ? ezTime::Zero() : ezTime::Milliseconds(1);
+      options.m_bPrepareOnWorkerThread = uiMode == 2;
+
+      ezTime tLongest;
+      ezTime tTotal;
+      ezUInt32 uiNumFrames = 1;
+
+      ezStopwatch sw;
+      ezUniquePtr<ezWorldReader::InstantiationContextBase> pContext;
+
+      {
+        EZ_LOCK(world.GetWriteMarker());
+        pContext = worldReader.InstantiatePrefab(world, ezTransform::IdentityTransform(), options);
+      }
+
+      tLongest = sw.Checkpoint();
+      tTotal = tLongest;
+
+      while (pContext != nullptr)
+      {
+        sw.Checkpoint();
+        const ezWorldReader::InstantiationContextBase::StepResult result = pContext->Step();
+
+        const ezTime tStep = sw.Checkpoint();
+        tLongest = ezMath::Max(tLongest, tStep);
+        tTotal += tStep;
+
+        if (result == ezWorldReader::InstantiationContextBase::StepResult::Finished)
+          break;
+
+        // the rest of the frame, which also gives the worker thread some time
+        {
+          EZ_LOCK(world.GetWriteMarker());
+          world.Update();
+        }
+
+        ezThreadUtils::Sleep(ezTime::Milliseconds(1));
+        ++uiNumFrames;
+      }
+
+      EZ_LOCK(world.GetReadMarker());
+      EZ_TEST_INT(world.GetObjectCount(), uiNumRootObjects * (uiNumChildrenPerRoot + 1));
+
+      ezTestFramework::Output(ezTestOutput::Duration, "Instantiating %u objects %s: longest call %.2fms, %.2fms on the world thread over %u frames",
+        world.GetObjectCount(), szModes[uiMode], tLongest.GetMilliseconds(), tTotal.GetMilliseconds(), uiNumFrames);
+    }
+  }
+
+  void AddMessageHierarchy(ezWorld& world, ezUInt32 uiNumChildren, ezUInt32 uiDepth, ezUInt32& inout_uiLeafCounter, ezUInt32 uiReceiverEveryNthLeaf,
+    ezGameObjectHandle hParent = ezGameObjectHandle())
+  {
+    ezTestComponentManager* pMan = world.GetOrCreateComponentManager<ezTestComponentManager>();
+    ezTestMessageComponentManager* pMsgMan = world.GetOrCreateComponentManager<ezTestMessageComponentManager>();
+
+    ezGameObjectDesc gd;
+    gd.m_bDynamic = true;
+    gd.m_hParent = hParent;
+
+    for (ezUInt32 i = 0; i < uiNumChildren; ++i)
+    {
+      ezGameObject* pObj;
+      auto hObj = world.CreateObject(gd, pObj);
+
+      // every object has a component that does not handle any message
+      ezTestComponent* pComp;
+      pMan->CreateComponent(pObj, pComp);
+
+      if (uiDepth > 1)
+      {
+        AddMessageHierarchy(world, uiNumChildren, uiDepth - 1, inout_uiLeafCounter, uiReceiverEveryNthLeaf, hObj);
+      }
+      else if (++inout_uiLeafCounter % uiReceiverEveryNthLeaf == 0)
+      {
+        ezTestMessageComponent* pMsgComp;
+        pMsgMan->CreateComponent(pObj, pMsgComp);
+      }
+    }
+  }
+
+  void MeasureRecursiveMessaging(ezUInt32 uiNumChildren, ezUInt32 uiDepth, ezUInt32 uiReceiverEveryNthLeaf)
+  {
+    ezWorldDesc worldDesc("Test");
+    ezWorld world(worldDesc);
+    EZ_LOCK(world.GetWriteMarker());
+
+    ezGameObjectDesc gd;
+    ezGameObject* pRoot;
+    world.CreateObject(gd, pRoot);
+
+    ezUInt32 uiNumLeaves = 0;
+    AddMessageHierarchy(world, uiNumChildren, uiDepth, uiNumLeaves, uiReceiverEveryNthLeaf, pRoot->GetHandle());
+
+    // initialize the components
+    world.Update();
+
+    const ezUInt32 uiNumSends = 100;
+
+    ezStopwatch sw;
+
+    ezUInt32 uiNumReceived = 0;
+    for (ezUInt32 i = 0; i < uiNumSends; ++i)
+    {
+      ezMsgPerfTest msg;
+      pRoot->SendMessageRecursive(msg);
+      uiNumReceived += msg.m_uiNumReceived;
+    }
+
+    const ezTime tHandled = sw.Checkpoint();
+
+    for (ezUInt32 i = 0; i < uiNumSends; ++i)
+    {
+      ezMsgPerfTestUnhandled msg;
+      pRoot->SendMessageRecursive(msg);
+    }
+
+    const ezTime tUnhandled = sw.Checkpoint();
+
+    EZ_TEST_INT(uiNumReceived, uiNumSends * (uiNumLeaves / uiReceiverEveryNthLeaf));
+
+    ezTestFramework::Output(ezTestOutput::Duration, "%u recursive sends to %u objects (depth: %u, %u receivers): %.2fms, unhandled: %.2fms", uiNumSends,
+      world.GetObjectCount(), uiDepth, uiNumLeaves / uiReceiverEveryNthLeaf, tHandled.GetMilliseconds(), tUnhandled.GetMilliseconds());
+  }
+
+  struct SpatialSystemScene
+  {
+    ezDynamicArray<ezSimdBBoxSphere> m_Bounds;
+    ezDynamicArray<ezDynamicArray<ezSimdBBoxSphere>> m_MovedBounds;
+    ezDynamicArray<ezVec3> m_QueryPositions;
+    float m_fQueryRadius = 0.0f;
+  };
+
+  // The dense scene resembles a town with many small objects close together, the sparse scene an open world with objects scattered
+  // over a large area and a few huge objects like terrain chunks or big static meshes.
+  void CreateSpatialSystemScene(bool bDense, SpatialSystemScene& out_Scene)
+  {
+    ezRandom rng;
+    rng.Initialize(bDense ? 17 : 42);
+
+    const ezUInt32 uiNumObjects = 100000;
+    const ezVec3 vHalfSize = bDense ? ezVec3(200.0f) : ezVec3(16000.0f, 16000.0f, 200.0f);
+
+    auto GetRandomPosition = [&](const ezVec3& vHalfRange) {
+      return ezVec3((float)rng.DoubleMinMax(-vHalfRange.x, vHalfRange.x), (float)rng.DoubleMinMax(-vHalfRange.y, vHalfRange.y),
+        (float)rng.DoubleMinMax(-vHalfRange.z, vHalfRange.z));
+    };
+
+    auto GetBounds = [](const ezVec3& vCenter, const ezVec3& vHalfExtents) {
+      ezSimdBBox box;
+      box.SetCenterAndHalfExtents(ezSimdConversion::ToVec3(vCenter), ezSimdConversion::ToVec3(vHalfExtents));
+      return ezSimdBBoxSphere(box);
+    };
+
+    for (ezUInt32 i = 0; i < uiNumObjects; ++i)
+    {
+      const bool bHuge = !bDense && (i % 100) == 0;
+      const float fSize = bDense ? (float)rng.DoubleMinMax(0.5, 3.0) : bHuge ? (float)rng.DoubleMinMax(200.0, 3000.0) : (float)rng.DoubleMinMax(1.0, 20.0);
+
+      out_Scene.m_Bounds.PushBack(GetBounds(GetRandomPosition(vHalfSize), ezVec3(fSize)));
+    }
+
+    // every round moves all objects a bit and some of them far enough to change their cell or node
+    ezArrayPtr<const ezSimdBBoxSphere> previousBounds = out_Scene.m_Bounds;
+    for (ezUInt32 uiRound = 0; uiRound < 4; ++uiRound)
+    {
+      auto& movedBounds = out_Scene.m_MovedBounds.ExpandAndGetRef();
+      for (ezUInt32 i = 0; i < uiNumObjects; ++i)
+      {
+        const ezVec3 vOffset = GetRandomPosition(ezVec3((i % 10) == 0 ? 50.0f : 1.0f));
+        const ezSimdBBoxSphere& bounds = previousBounds[i];
+        movedBounds.PushBack(ezSimdBBoxSphere(bounds.m_CenterAndRadius + ezSimdConversion::ToVec3(vOffset), bounds.m_BoxHalfExtents,
+          bounds.m_CenterAndRadius.w()));
+      }
+
+      previousBounds = movedBounds;
+    }
+
+    for (ezUInt32 i = 0; i < 100; ++i)
+    {
+      out_Scene.m_QueryPositions.PushBack(GetRandomPosition(vHalfSize));
+    }
+
+    out_Scene.m_fQueryRadius = bDense ? 30.0f : 500.0f;
+  }
+
+  void MeasureSpatialSystem(const char* szName, ezSpatialSystem& spatialSystem, const SpatialSystemScene& scene)
+  {
+    const ezUInt32 uiCategoryBitmask = ezDefaultSpatialDataCategories::RenderStatic.GetBitmask();
+
+    ezDynamicArray<ezSpatialSystem::SpatialDataUpdate> updates;
+    updates.SetCount(scene.m_Bounds.GetCount());
+
+    ezStopwatch sw;
+
+    for (ezUInt32 i = 0; i < scene.m_Bounds.GetCount(); ++i)
+    {
+      updates[i].m_hData = spatialSystem.CreateSpatialData(scene.m_Bounds[i], nullptr, uiCategoryBitmask);
+      updates[i].m_uiCategoryBitmask = uiCategoryBitmask;
+    }
+
+    const ezTime tInsert = sw.Checkpoint();
+
+    ezTime tUpdate;
+    for (const auto& movedBounds : scene.m_MovedBounds)
+    {
+      for (ezUInt32 i = 0; i < movedBounds.GetCount(); ++i)
+      {
+        updates[i].m_Bounds = movedBounds[i];
+      }
+
+      sw.Checkpoint();
+      spatialSystem.UpdateSpatialDataBatch(updates);
+      tUpdate += sw.Checkpoint();
+    }
+
+    ezUInt32 uiNumFoundObjects = 0;
+    auto countObjects = [&](ezGameObject*) {
+      ++uiNumFoundObjects;
+      return ezVisitorExecution::Continue;
+    };
+
+    sw.Checkpoint();
+
+    for (const ezVec3& vPos : scene.m_QueryPositions)
+    {
+      spatialSystem.FindObjectsInSphere(ezBoundingSphere(vPos, scene.m_fQueryRadius), uiCategoryBitmask, countObjects);
+    }
+
+    const ezTime tSphereQueries = sw.Checkpoint();
+
+    ezDynamicArray<const ezGameObject*> visibleObjects;
+    for (const ezVec3& vPos : scene.m_QueryPositions)
+    {
+      ezFrustum frustum;
+      frustum.SetFrustum(vPos, ezVec3(1, 0, 0), ezVec3(0, 0, 1), ezAngle::Degree(90.0f), ezAngle::Degree(60.0f), 0.1f, scene.m_fQueryRadius * 4.0f);
+
+      visibleObjects.Clear();
+      spatialSystem.FindVisibleObjects(frustum, uiCategoryBitmask, visibleObjects);
+      uiNumFoundObjects += visibleObjects.GetCount();
+    }
+
+    const ezTime tFrustumQueries = sw.Checkpoint();
+
+    // a camera that only moves every few frames, once without and once with a visibility cache
+    ezUniquePtr<ezSpatialSystem::VisibilityCache> pCache = spatialSystem.CreateVisibilityCache();
+    ezTime tCameraQueries[2];
+    for (ezUInt32 uiPass = 0; uiPass < 2; ++uiPass)
+    {
+      sw.Checkpoint();
+
+      for (ezUInt32 uiFrame = 0; uiFrame < 100; ++uiFrame)
+      {
+        ezFrustum frustum;
+        frustum.SetFrustum(scene.m_QueryPositions[0] + ezVec3((uiFrame / 10) * 1.0f, 0, 0), ezVec3(1, 0, 0), ezVec3(0, 0, 1), ezAngle::Degree(90.0f),
+          ezAngle::Degree(60.0f), 0.1f, scene.m_fQueryRadius * 4.0f);
+
+        visibleObjects.Clear();
+        spatialSystem.FindVisibleObjects(frustum, uiCategoryBitmask, visibleObjects, nullptr, ezSpatialSystem::IsOccludedCallback(), uiPass == 1 ? pCache.Borrow() : nullptr);
+      }
+
+      tCameraQueries[uiPass] = sw.Checkpoint();
+    }
+
+    ezTestFramework::Output(ezTestOutput::Duration,
+      "%s: insert %u objects: %.2fms, %u batch updates: %.2fms, %u sphere queries: %.2fms, %u frustum queries: %.2fms (%u objects found), "
+      "100 slowly moving camera queries: %.2fms, cached: %.2fms",
+      szName, scene.m_Bounds.GetCount(), tInsert.GetMilliseconds(), scene.m_MovedBounds.GetCount(), tUpdate.GetMilliseconds(),
+      scene.m_QueryPositions.GetCount(), tSphereQueries.GetMilliseconds(), scene.m_QueryPositions.GetCount(), tFrustumQueries.GetMilliseconds(),
+      uiNumFoundObjects, tCameraQueries[0].GetMilliseconds(), tCameraQueries[1].GetMilliseconds());
+
+    for (const auto& update : updates)
+    {
+      spatialSystem.DeleteSpatialData(update.m_hData);
+    }
+  }
+
 } // namespace
 
 
@@ -142,6 +756,31 @@ EZ_CREATE_SIMPLE_TEST(World, Profile_Creation)
     MeasureCreationTime(bDynamic, 3, 1, 12, 0);
     MeasureCreationTime(bDynamic, 1, 1, 80, 0);
   }
+
+  EZ_TEST_BLOCK(EnableInRelease, "Create many objects in bulk")
+  {
+    MeasureBulkCreationTime(10000, 1);
+    MeasureBulkCreationTime(100000, 1);
+    MeasureBulkCreationTime(100000, 4);
+    MeasureBulkCreationTime(1000000, 1);
+  }
+
+  EZ_TEST_BLOCK(EnableInRelease, "Instantiate prefab")
+  {
+    MeasurePrefabInstantiation(1000, 9);
+    MeasurePrefabInstantiation(10000, 9);
+  }
+}
+
+EZ_CREATE_SIMPLE_TEST(World, Profile_Messaging)
+{
+  EZ_TEST_BLOCK(EnableInRelease, "Recursive messages")
+  {
+    MeasureRecursiveMessaging(4, 7, 1);
+    MeasureRecursiveMessaging(4, 7, 100);
+    MeasureRecursiveMessaging(2, 14, 1000);
+    MeasureRecursiveMessaging(1, 1000, 1);
+  }
 }
 
 EZ_CREATE_SIMPLE_TEST(World, Profile_Deletion)
@@ -289,3 +928,40 @@ EZ_CREATE_SIMPLE_TEST(World, Profile_Update)
     }
   }
 }
+
+EZ_CREATE_SIMPLE_TEST(World, Profile_ComponentUpdate)
+{
+  EZ_TEST_BLOCK(EnableInRelease, "Update animation components")
+  {
+    MeasureAnimationUpdate(100000, 1);
+    MeasureAnimationUpdate(100000, 10);
+    MeasureAnimationUpdate(100000, 100);
+  }
+}
+
+EZ_CREATE_SIMPLE_TEST(World, Profile_SpatialSystem)
+{
+  EZ_TEST_BLOCK(EnableInRelease, "Dense scene")
+  {
+    SpatialSystemScene scene;
+    CreateSpatialSystemScene(true, scene);
+
+    ezSpatialSystem_RegularGrid grid;
+    MeasureSpatialSystem("Regular grid", grid, scene);
+
+    ezSpatialSystem_LooseOctree octree;
+    MeasureSpatialSystem("Loose octree", octree, scene);
+  }
+
+  EZ_TEST_BLOCK(EnableInRelease, "Sparse scene")
+  {
+    SpatialSystemScene scene;
+    CreateSpatialSystemScene(false, scene);
+
+    ezSpatialSystem_RegularGrid grid;
+    MeasureSpatialSystem("Regular grid", grid, scene);
+
+    ezSpatialSystem_LooseOctree octree;
+    MeasureSpatialSystem("Loose octree", octree, scene);
+  }
+}
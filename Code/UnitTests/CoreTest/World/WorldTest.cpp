@@ -1,7 +1,11 @@
 #include <CoreTestPCH.h>
 
 #include <Core/World/World.h>
+#include <Core/WorldSerializer/WorldReader.h>
+#include <Core/WorldSerializer/WorldWriter.h>
+#include <Foundation/IO/MemoryStream.h>
 #include <Foundation/Time/Clock.h>
+#include <Foundation/Utilities/ConversionUtils.h>
 #include <Foundation/Utilities/GraphicsUtils.h>
 
 EZ_CREATE_SIMPLE_TEST_GROUP(World);
@@ -112,6 +116,44 @@ namespace
     world.Traverse(ezWorld::VisitorFunc(&Traverser::Visit, &traverser), ezWorld::TraversalMethod::BreadthFirst);
   }
 
+  class TestSerializedComponent;
+  typedef ezComponentManager<TestSerializedComponent, ezBlockStorageType::FreeList> TestSerializedComponentManager;
+
+  class TestSerializedComponent : public ezComponent
+  {
+    EZ_DECLARE_COMPONENT_TYPE(TestSerializedComponent, ezComponent, TestSerializedComponentManager);
+
+  public:
+    virtual void SerializeComponent(ezWorldWriter& stream) const override { stream.GetStream() << m_iValue; }
+    virtual void DeserializeComponent(ezWorldReader& stream) override { stream.GetStream() >> m_iValue; }
+
+    ezInt32 m_iValue = 0;
+  };
+
+  // clang-format off
+  EZ_BEGIN_COMPONENT_TYPE(TestSerializedComponent, 1, ezComponentMode::Static)
+  EZ_END_COMPONENT_TYPE;
+  // clang-format on
+
+  void InstantiateTestPrefab(ezWorld& world, ezWorldReader& reader, const ezTransform& rootTransform, bool bPrepareOnWorkerThread,
+    ezHybridArray<ezGameObject*, 8>& out_RootObjects, ezHybridArray<ezGameObject*, 8>& out_ChildObjects)
+  {
+    ezPrefabInstantiationOptions options;
+    options.m_pCreatedRootObjectsOut = &out_RootObjects;
+    options.m_pCreatedChildObjectsOut = &out_ChildObjects;
+    options.m_MaxStepTime = ezTime::Milliseconds(1);
+    options.m_bPrepareOnWorkerThread = bPrepareOnWorkerThread;
+
+    ezUniquePtr<ezWorldReader::InstantiationContextBase> pContext = reader.InstantiatePrefab(world, rootTransform, options);
+    EZ_TEST_BOOL(pContext != nullptr);
+
+    while (pContext->Step() != ezWorldReader::InstantiationContextBase::StepResult::Finished)
+    {
+      // component initialization is done during the world update
+      world.Update();
+    }
+  }
+
   class CustomCoordinateSystemProvider : public ezCoordinateSystemProvider
   {
   public:
@@ -319,6 +361,128 @@ EZ_CREATE_SIMPLE_TEST(World, World)
     EZ_TEST_INT(world.GetObjectCount(), 0);
   }
 
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Create objects in bulk")
+  {
+    ezWorldDesc worldDesc("Test");
+    ezWorld world(worldDesc);
+    EZ_LOCK(world.GetWriteMarker());
+
+    ezGameObjectDesc rootDesc;
+    rootDesc.m_LocalPosition = ezVec3(100.0f, 0.0f, 0.0f);
+    rootDesc.m_sName.Assign("Root");
+
+    ezGameObjectHandle hRoot = world.CreateObject(rootDesc);
+
+    // one object parented to an existing object via handle, followed by a chain of children that reference their parent by index
+    ezGameObjectDesc descs[5];
+    ezUInt32 parentIndices[5];
+    for (ezUInt32 i = 0; i < 5; ++i)
+    {
+      ezStringBuilder sb;
+      sb.AppendFormat("Object_{0}", i);
+      descs[i].m_sName.Assign(sb.GetData());
+      descs[i].m_LocalPosition = ezVec3(0.0f, 10.0f, 0.0f);
+      descs[i].m_hParent = hRoot;
+      descs[i].m_bActiveFlag = i != 3;
+
+      parentIndices[i] = i == 0 ? ezInvalidIndex : i - 1;
+    }
+
+    ezGameObjectHandle handles[5];
+    world.CreateObjects(ezMakeArrayPtr(descs), ezMakeArrayPtr(parentIndices), ezMakeArrayPtr(handles));
+
+    EZ_TEST_INT(world.GetObjectCount(), 6);
+
+    ezGameObject* pParent = nullptr;
+    EZ_TEST_BOOL(world.TryGetObject(hRoot, pParent));
+
+    for (ezUInt32 i = 0; i < 5; ++i)
+    {
+      ezGameObject* pObject = nullptr;
+      EZ_TEST_BOOL(world.TryGetObject(handles[i], pObject));
+
+      EZ_TEST_STRING(pObject->GetName(), descs[i].m_sName.GetString().GetData());
+      EZ_TEST_BOOL(pObject->GetParent() == pParent);
+      EZ_TEST_INT(pParent->GetChildCount(), 1);
+      EZ_TEST_VEC3(pObject->GetGlobalPosition(), ezVec3(100.0f, (i + 1) * 10.0f, 0.0f), 0.0f);
+      EZ_TEST_BOOL(pObject->IsActive() == (i < 3));
+
+      pParent = pObject;
+    }
+
+    // without parent indices all objects use their handle, no output is needed
+    world.CreateObjects(ezMakeArrayPtr(descs), ezArrayPtr<const ezUInt32>(), ezArrayPtr<ezGameObjectHandle>());
+
+    EZ_TEST_INT(world.GetObjectCount(), 11);
+    EZ_TEST_BOOL(world.TryGetObject(hRoot, pParent));
+    EZ_TEST_INT(pParent->GetChildCount(), 6);
+    SanityCheckWorld(world);
+
+    world.DeleteObjectNow(hRoot);
+
+    EZ_TEST_INT(world.GetObjectCount(), 0);
+
+    // enough objects to span several storage blocks, on top of partially filled blocks, with static and dynamic objects on multiple levels
+    for (ezUInt32 i = 0; i < 7; ++i)
+    {
+      ezGameObjectDesc desc;
+      desc.m_bDynamic = (i % 2) == 0;
+      world.CreateObject(desc);
+    }
+
+    const ezUInt32 uiNumObjects = 300;
+    ezDynamicArray<ezGameObjectDesc> manyDescs;
+    ezDynamicArray<ezUInt32> manyParentIndices;
+    ezDynamicArray<ezGameObjectHandle> manyHandles;
+    ezDynamicArray<ezGameObject*> manyObjects;
+    manyDescs.SetCount(uiNumObjects);
+    manyParentIndices.SetCount(uiNumObjects);
+    manyHandles.SetCount(uiNumObjects);
+    manyObjects.SetCount(uiNumObjects);
+
+    for (ezUInt32 i = 0; i < uiNumObjects; ++i)
+    {
+      manyDescs[i].m_LocalPosition = ezVec3(1.0f, 0.0f, 0.0f);
+      manyDescs[i].m_bDynamic = (i % 7) == 0;
+      manyParentIndices[i] = i < 100 ? ezInvalidIndex : i - 100;
+    }
+
+    world.CreateObjects(manyDescs, manyParentIndices, manyHandles, manyObjects);
+
+    EZ_TEST_INT(world.GetObjectCount(), 7 + uiNumObjects);
+
+    for (ezUInt32 i = 0; i < uiNumObjects; ++i)
+    {
+      ezGameObject* pObject = nullptr;
+      EZ_TEST_BOOL(world.TryGetObject(manyHandles[i], pObject));
+      EZ_TEST_BOOL(pObject == manyObjects[i]);
+      EZ_TEST_BOOL(pObject->GetParent() == (i < 100 ? nullptr : manyObjects[i - 100]));
+      EZ_TEST_BOOL(pObject->IsDynamic() == (manyDescs[i].m_bDynamic || (i >= 100 && manyObjects[i - 100]->IsDynamic())));
+      EZ_TEST_VEC3(pObject->GetGlobalPosition(), ezVec3((i / 100) + 1.0f, 0.0f, 0.0f), 0.0f);
+    }
+
+    // delete some of them, which moves other objects and transformation data around
+    for (ezUInt32 i = 0; i < 100; i += 3)
+    {
+      world.DeleteObjectNow(manyHandles[i]);
+    }
+
+    EZ_TEST_INT(world.GetObjectCount(), 7 + uiNumObjects - 34 * 3);
+
+    // dead objects are only removed from the hierarchy during the update
+    world.Update();
+    SanityCheckWorld(world);
+
+    for (ezUInt32 i = 0; i < uiNumObjects; ++i)
+    {
+      ezGameObject* pObject = nullptr;
+      if (world.TryGetObject(manyHandles[i], pObject))
+      {
+        EZ_TEST_VEC3(pObject->GetGlobalPosition(), ezVec3((i / 100) + 1.0f, 0.0f, 0.0f), 0.0f);
+      }
+    }
+  }
+
   EZ_TEST_BLOCK(ezTestBlock::Enabled, "Re-parenting 1")
   {
     ezWorldDesc worldDesc("Test");
@@ -641,4 +805,217 @@ EZ_CREATE_SIMPLE_TEST(World, World)
       EZ_TEST_BOOL(pObjects[i]->IsActive() == (i < iTopDisabled));
     }
   }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Instantiate prefab on worker thread")
+  {
+    ezMemoryStreamStorage storage;
+
+    {
+      ezWorldDesc worldDesc("Source");
+      ezWorld world(worldDesc);
+      EZ_LOCK(world.GetWriteMarker());
+
+      TestWorldObjects o = CreateTestWorld(world, false);
+
+      TestSerializedComponent* pComponent = nullptr;
+      TestSerializedComponent::CreateComponent(o.pChild11, pComponent);
+      pComponent->m_iValue = 42;
+      pComponent->SetUserFlag(3, true);
+
+      TestSerializedComponent::CreateComponent(o.pParent2, pComponent);
+      pComponent->m_iValue = 7;
+      pComponent->SetActiveFlag(false);
+
+      ezMemoryStreamWriter writer(&storage);
+      ezWorldWriter worldWriter;
+      worldWriter.WriteWorld(writer, world);
+    }
+
+    ezMemoryStreamReader memReader(&storage);
+    ezWorldReader worldReader;
+    EZ_TEST_BOOL(worldReader.ReadWorldDescription(memReader).Succeeded());
+
+    ezWorldDesc worldDesc("Test");
+    ezWorld world(worldDesc);
+    EZ_LOCK(world.GetWriteMarker());
+
+    ezQuat q;
+    q.SetFromAxisAndAngle(ezVec3(0.0f, 0.0f, 1.0f), ezAngle::Degree(90.0f));
+    const ezTransform rootTransform(ezVec3(0.0f, 50.0f, 0.0f), q);
+
+    ezHybridArray<ezGameObject*, 8> rootObjects[2];
+    ezHybridArray<ezGameObject*, 8> childObjects[2];
+
+    InstantiateTestPrefab(world, worldReader, rootTransform, false, rootObjects[0], childObjects[0]);
+    InstantiateTestPrefab(world, worldReader, rootTransform, true, rootObjects[1], childObjects[1]);
+
+    world.Update();
+    SanityCheckWorld(world);
+
+    EZ_TEST_INT(world.GetObjectCount(), 8);
+    EZ_TEST_INT(rootObjects[1].GetCount(), rootObjects[0].GetCount());
+    EZ_TEST_INT(childObjects[1].GetCount(), childObjects[0].GetCount());
+
+    for (ezUInt32 i = 0; i < rootObjects[0].GetCount(); ++i)
+    {
+      EZ_TEST_STRING(rootObjects[1][i]->GetName(), rootObjects[0][i]->GetName());
+      EZ_TEST_VEC3(rootObjects[1][i]->GetGlobalPosition(), rootObjects[0][i]->GetGlobalPosition(), 0);
+      EZ_TEST_BOOL(rootObjects[1][i]->GetGlobalRotation().IsEqualRotation(rootObjects[0][i]->GetGlobalRotation(), ezMath::DefaultEpsilon<float>()));
+      EZ_TEST_VEC3(rootObjects[1][i]->GetGlobalPosition(), rootTransform.TransformPosition(ezVec3(100.0f, 0.0f, 0.0f)), ezMath::DefaultEpsilon<float>() * 100.0f);
+    }
+
+    for (ezUInt32 uiRun = 0; uiRun < 2; ++uiRun)
+    {
+      ezUInt32 uiNumComponents = 0;
+      TestSerializedComponent* pComponent = nullptr;
+
+      for (ezGameObject* pChild : childObjects[uiRun])
+      {
+        EZ_TEST_BOOL(rootObjects[uiRun].Contains(pChild->GetParent()));
+        EZ_TEST_VEC3(pChild->GetGlobalPosition(), rootTransform.TransformPosition(ezVec3(100.0f, 150.0f, 0.0f)), ezMath::DefaultEpsilon<float>() * 100.0f);
+
+        if (pChild->TryGetComponentOfBaseType(pComponent))
+        {
+          ++uiNumComponents;
+          EZ_TEST_STRING(pChild->GetName(), "Child11");
+          EZ_TEST_INT(pComponent->m_iValue, 42);
+          EZ_TEST_BOOL(pComponent->GetUserFlag(3));
+          EZ_TEST_BOOL(pComponent->IsActiveAndInitialized());
+        }
+      }
+
+      for (ezGameObject* pRoot : rootObjects[uiRun])
+      {
+        if (pRoot->TryGetComponentOfBaseType(pComponent))
+        {
+          ++uiNumComponents;
+          EZ_TEST_STRING(pRoot->GetName(), "Parent2");
+          EZ_TEST_INT(pComponent->m_iValue, 7);
+          EZ_TEST_BOOL(!pComponent->GetActiveFlag());
+        }
+      }
+
+      EZ_TEST_INT(uiNumComponents, 2);
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Instantiate prefab in batches")
+  {
+    // enough objects for several batches, the chains of children reference parents in earlier batches and in the same batch
+    const ezUInt32 uiNumRoots = 50;
+    const ezUInt32 uiChainLength = 5;
+
+    ezMemoryStreamStorage storage;
+
+    {
+      ezWorldDesc worldDesc("Source");
+      ezWorld world(worldDesc);
+      EZ_LOCK(world.GetWriteMarker());
+
+      for (ezUInt32 uiRoot = 0; uiRoot < uiNumRoots; ++uiRoot)
+      {
+        ezGameObjectDesc desc;
+        desc.m_LocalPosition.Set(uiRoot * 10.0f, 0.0f, 0.0f);
+
+        for (ezUInt32 uiDepth = 0; uiDepth <= uiChainLength; ++uiDepth)
+        {
+          ezStringBuilder sName;
+          sName.Format("{0}", uiRoot * 100 + uiDepth);
+          desc.m_sName.Assign(sName.GetData());
+
+          ezGameObject* pObject = nullptr;
+          desc.m_hParent = world.CreateObject(desc, pObject);
+          desc.m_LocalPosition.Set(0.0f, 1.0f, 0.0f);
+
+          if (uiDepth % 2 == 1)
+          {
+            TestSerializedComponent* pComponent = nullptr;
+            TestSerializedComponent::CreateComponent(pObject, pComponent);
+            pComponent->m_iValue = uiRoot * 100 + uiDepth;
+          }
+        }
+      }
+
+      ezMemoryStreamWriter writer(&storage);
+      ezWorldWriter worldWriter;
+      worldWriter.WriteWorld(writer, world);
+    }
+
+    ezMemoryStreamReader memReader(&storage);
+    ezWorldReader worldReader;
+    EZ_TEST_BOOL(worldReader.ReadWorldDescription(memReader).Succeeded());
+
+    ezWorldDesc worldDesc("Test");
+    ezWorld world(worldDesc);
+    EZ_LOCK(world.GetWriteMarker());
+
+    ezQuat q;
+    q.SetFromAxisAndAngle(ezVec3(0.0f, 0.0f, 1.0f), ezAngle::Degree(90.0f));
+    const ezTransform rootTransform(ezVec3(0.0f, 50.0f, 0.0f), q);
+
+    ezHybridArray<ezGameObject*, 8> rootObjects[3];
+    ezHybridArray<ezGameObject*, 8> childObjects[3];
+
+    {
+      ezPrefabInstantiationOptions options;
+      options.m_pCreatedRootObjectsOut = &rootObjects[0];
+      options.m_pCreatedChildObjectsOut = &childObjects[0];
+
+      EZ_TEST_BOOL(worldReader.InstantiatePrefab(world, rootTransform, options) == nullptr);
+    }
+
+    InstantiateTestPrefab(world, worldReader, rootTransform, false, rootObjects[1], childObjects[1]);
+    InstantiateTestPrefab(world, worldReader, rootTransform, true, rootObjects[2], childObjects[2]);
+
+    world.Update();
+    SanityCheckWorld(world);
+
+    EZ_TEST_INT(world.GetObjectCount(), 3 * uiNumRoots * (uiChainLength + 1));
+
+    for (ezUInt32 uiRun = 0; uiRun < 3; ++uiRun)
+    {
+      EZ_TEST_INT(rootObjects[uiRun].GetCount(), uiNumRoots);
+      EZ_TEST_INT(childObjects[uiRun].GetCount(), uiNumRoots * uiChainLength);
+
+      ezUInt32 uiNumComponents = 0;
+
+      for (ezGameObject* pChild : childObjects[uiRun])
+      {
+        ezGameObject* pParent = pChild->GetParent();
+        if (!EZ_TEST_BOOL(pParent != nullptr))
+          continue;
+
+        // the names encode the root index and the depth in the chain
+        ezUInt32 uiName = 0;
+        ezUInt32 uiParentName = 0;
+        EZ_TEST_BOOL(ezConversionUtils::StringToUInt(pChild->GetName(), uiName).Succeeded());
+        EZ_TEST_BOOL(ezConversionUtils::StringToUInt(pParent->GetName(), uiParentName).Succeeded());
+        EZ_TEST_INT(uiParentName, uiName - 1);
+
+        EZ_TEST_VEC3(pChild->GetGlobalPosition() - pParent->GetGlobalPosition(), q * ezVec3(0.0f, 1.0f, 0.0f), ezMath::DefaultEpsilon<float>() * 100.0f);
+
+        TestSerializedComponent* pComponent = nullptr;
+        if (pChild->TryGetComponentOfBaseType(pComponent))
+        {
+          ++uiNumComponents;
+          EZ_TEST_INT(pComponent->m_iValue, uiName);
+          EZ_TEST_BOOL(pComponent->IsActiveAndInitialized());
+        }
+      }
+
+      EZ_TEST_INT(uiNumComponents, uiNumRoots * (uiChainLength + 1) / 2);
+    }
+
+    // cancelling right away has to wait for the worker thread, no objects are created
+    {
+      ezPrefabInstantiationOptions options;
+      options.m_MaxStepTime = ezTime::Milliseconds(1);
+      options.m_bPrepareOnWorkerThread = true;
+
+      ezUniquePtr<ezWorldReader::InstantiationContextBase> pContext = worldReader.InstantiatePrefab(world, rootTransform, options);
+      pContext->Cancel();
+    }
+
+    EZ_TEST_INT(world.GetObjectCount(), 3 * uiNumRoots * (uiChainLength + 1));
+  }
 }
@@ -1,7 +1,9 @@
 #include <FoundationTestPCH.h>
 
 #include <Foundation/Containers/HashSet.h>
+#include <Foundation/Containers/Set.h>
 #include <Foundation/Containers/StaticArray.h>
+#include <Foundation/Math/Random.h>
 
 namespace
 {
@@ -520,4 +522,46 @@ EZ_CREATE_SIMPLE_TEST(Containers, HashSet)
 
     EZ_TEST_BOOL(set2.IsEmpty());
   }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Grouped Storage")
+  {
+    ezHashSet<ezString, ezHashHelper<ezString>, ezDefaultAllocatorWrapper, ezHashTableGroupedStorage> set;
+    ezSet<ezString> reference;
+
+    ezRandom rng;
+    rng.Initialize(42);
+
+    ezStringBuilder sKey;
+    for (ezUInt32 i = 0; i < 10000; ++i)
+    {
+      sKey.Format("key{}", rng.UIntInRange(1000));
+
+      if (rng.Bool())
+      {
+        EZ_TEST_BOOL(set.Insert(sKey) == reference.Contains(sKey));
+        reference.Insert(sKey);
+      }
+      else
+      {
+        EZ_TEST_BOOL(set.Remove(sKey) == reference.Remove(sKey));
+      }
+    }
+
+    EZ_TEST_INT(set.GetCount(), reference.GetCount());
+
+    for (const ezString& key : reference)
+    {
+      EZ_TEST_BOOL(set.Contains(key));
+    }
+
+    set.Compact();
+
+    ezUInt32 uiIterated = 0;
+    for (const ezString& key : set)
+    {
+      EZ_TEST_BOOL(reference.Contains(key));
+      ++uiIterated;
+    }
+    EZ_TEST_INT(uiIterated, reference.GetCount());
+  }
 }
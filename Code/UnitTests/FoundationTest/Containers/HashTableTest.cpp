@@ -1,7 +1,9 @@
 #include <FoundationTestPCH.h>
 
 #include <Foundation/Containers/HashTable.h>
+#include <Foundation/Containers/Map.h>
 #include <Foundation/Containers/StaticArray.h>
+#include <Foundation/Math/Random.h>
 #include <Foundation/Strings/String.h>
 
 namespace HashTableTestDetail
@@ -598,4 +600,79 @@ EZ_CREATE_SIMPLE_TEST(Containers, HashTable)
       map.Remove(it);
     }
   }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Grouped Storage")
+  {
+    typedef ezHashTable<ezInt32, ezInt32, ezHashHelper<ezInt32>, ezDefaultAllocatorWrapper, ezHashTableGroupedStorage> GroupedTable;
+
+    GroupedTable table;
+    ezMap<ezInt32, ezInt32> reference;
+
+    ezRandom rng;
+    rng.Initialize(42);
+
+    for (ezUInt32 i = 0; i < 20000; ++i)
+    {
+      const ezInt32 iKey = rng.IntInRange(0, 2000);
+
+      switch (rng.UIntInRange(3))
+      {
+        case 0:
+          EZ_TEST_BOOL(table.Insert(iKey, i) == reference.Contains(iKey));
+          reference[iKey] = i;
+          break;
+
+        case 1:
+          EZ_TEST_BOOL(table.Remove(iKey) == reference.Remove(iKey));
+          break;
+
+        case 2:
+          EZ_TEST_BOOL(table.Contains(iKey) == reference.Contains(iKey));
+          break;
+      }
+    }
+
+    EZ_TEST_INT(table.GetCount(), reference.GetCount());
+
+    ezUInt32 uiIterated = 0;
+    for (auto it : table)
+    {
+      EZ_TEST_INT(it.Value(), reference[it.Key()]);
+      ++uiIterated;
+    }
+    EZ_TEST_INT(uiIterated, reference.GetCount());
+
+    GroupedTable copy = table;
+    EZ_TEST_BOOL(copy == table);
+
+    copy.Compact();
+    for (auto it : reference)
+    {
+      EZ_TEST_INT(copy[it.Key()], it.Value());
+    }
+
+    // many keys with the same hash overflow into the following groups
+    ezHashTable<HashTableTestDetail::Collision, ezInt32, ezHashHelper<HashTableTestDetail::Collision>, ezDefaultAllocatorWrapper,
+      ezHashTableGroupedStorage>
+      collisions;
+
+    for (ezInt32 i = 0; i < 40; ++i)
+    {
+      collisions[HashTableTestDetail::Collision(0, i)] = i;
+    }
+
+    // removing from full groups leaves tombstones, which are reused or cleaned up by rehashing
+    for (ezInt32 i = 0; i < 1000; ++i)
+    {
+      EZ_TEST_BOOL(collisions.Remove(HashTableTestDetail::Collision(0, i)));
+      EZ_TEST_BOOL(!collisions.Contains(HashTableTestDetail::Collision(0, i)));
+      EZ_TEST_BOOL(!collisions.Insert(HashTableTestDetail::Collision(0, i + 40), i + 40));
+    }
+
+    EZ_TEST_INT(collisions.GetCount(), 40);
+    for (ezInt32 i = 1000; i < 1040; ++i)
+    {
+      EZ_TEST_INT(*collisions.GetValue(HashTableTestDetail::Collision(0, i)), i);
+    }
+  }
 }
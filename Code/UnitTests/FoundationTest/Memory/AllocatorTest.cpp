@@ -1,8 +1,11 @@
 #include <FoundationTestPCH.h>
 
+#include <Foundation/Containers/HashSet.h>
 #include <Foundation/Memory/CommonAllocators.h>
+#include <Foundation/Memory/HeapProfile.h>
 #include <Foundation/Memory/LargeBlockAllocator.h>
 #include <Foundation/Memory/StackAllocator.h>
+#include <Foundation/Threading/TaskSystem.h>
 
 struct EZ_ALIGN(NonAlignedVector, EZ_ALIGNMENT_MINIMUM)
 {
@@ -37,6 +40,22 @@ struct EZ_ALIGN_16(AlignedVector)
   float w;
 };
 
+struct StackAllocatorDestructCounter
+{
+  StackAllocatorDestructCounter(ezUInt32 uiValue)
+    : m_uiValue(uiValue)
+  {
+  }
+
+  ~StackAllocatorDestructCounter() { s_iDestructions.Increment(); }
+
+  ezUInt32 m_uiValue;
+
+  static ezAtomicInteger32 s_iDestructions;
+};
+
+ezAtomicInteger32 StackAllocatorDestructCounter::s_iDestructions;
+
 template <typename T>
 void TestAlignmentHelper(size_t uiExpectedAlignment)
 {
@@ -131,6 +150,36 @@ EZ_CREATE_SIMPLE_TEST(Memory, Allocator)
     EZ_TEST_BOOL(stats.m_uiNumDeallocations == 200);
     EZ_TEST_BOOL(stats.m_uiAllocationSize == 17 * BLOCK_SIZE_IN_BYTES);
 
+    // allocate several blocks at once, this needs more than the free blocks of the existing super blocks
+    {
+      ezDynamicArray<ezDataBlock<int, BLOCK_SIZE_IN_BYTES>> bulkBlocks;
+      bulkBlocks.SetCount(40, ezDataBlock<int, BLOCK_SIZE_IN_BYTES>(nullptr, 0));
+      allocator.AllocateBlocks<int>(bulkBlocks.GetArrayPtr());
+
+      ezHashSet<int*> uniqueBlocks;
+      for (auto& block : bulkBlocks)
+      {
+        EZ_TEST_BOOL(ezMemoryUtils::IsAligned(block.m_pData, uiPageSize));
+        EZ_TEST_INT(block.m_uiCount, 0);
+        uniqueBlocks.Insert(block.m_pData);
+      }
+
+      EZ_TEST_INT(uniqueBlocks.GetCount(), 40);
+
+      stats = allocator.GetStats();
+      EZ_TEST_BOOL(stats.m_uiNumAllocations == 257);
+      EZ_TEST_BOOL(stats.m_uiAllocationSize == 57 * BLOCK_SIZE_IN_BYTES);
+
+      for (auto& block : bulkBlocks)
+      {
+        allocator.DeallocateBlock(block);
+      }
+
+      stats = allocator.GetStats();
+      EZ_TEST_BOOL(stats.m_uiNumDeallocations == 240);
+      EZ_TEST_BOOL(stats.m_uiAllocationSize == 17 * BLOCK_SIZE_IN_BYTES);
+    }
+
     for (ezUInt32 i = 0; i < 2000; ++i)
     {
       ezUInt32 uiAction = rand() % 2;
@@ -160,6 +209,144 @@ EZ_CREATE_SIMPLE_TEST(Memory, Allocator)
     EZ_TEST_BOOL(stats.m_uiAllocationSize == 0);
   }
 
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "SlabAllocator")
+  {
+    using SlabPolicy = ezMemoryPolicies::ezSlabAllocation;
+
+    for (ezUInt32 uiSize = 1; uiSize <= SlabPolicy::MaxSlabAllocationSize; ++uiSize)
+    {
+      const ezUInt32 uiSizeClass = SlabPolicy::GetSizeClass(uiSize);
+      EZ_TEST_BOOL(uiSizeClass < SlabPolicy::NumSizeClasses);
+      EZ_TEST_BOOL(SlabPolicy::GetSizeClassSize(uiSizeClass) >= uiSize);
+      EZ_TEST_BOOL(uiSizeClass == 0 || SlabPolicy::GetSizeClassSize(uiSizeClass - 1) < uiSize);
+    }
+
+    ezSlabAllocator allocator("TestSlabAllocator");
+
+    ezDynamicArray<ezUInt8*> allocations;
+    ezDynamicArray<ezUInt32> sizes;
+    size_t uiExpectedSize = 0;
+
+    for (ezUInt32 i = 0; i < 5000; ++i)
+    {
+      if (allocations.IsEmpty() || (rand() % 3) != 0)
+      {
+        // mostly small sizes, some too large for the slabs
+        const ezUInt32 uiSize = (i % 50) == 0 ? 1000 + rand() % 5000 : 1 + rand() % 300;
+        const ezUInt32 uiAlign = (i % 10) == 0 ? 64 : 8;
+
+        ezUInt8* ptr = static_cast<ezUInt8*>(allocator.Allocate(uiSize, uiAlign));
+        EZ_TEST_BOOL(ezMemoryUtils::IsAligned(ptr, uiAlign));
+        ezMemoryUtils::PatternFill(ptr, static_cast<ezUInt8>(allocations.GetCount()), uiSize);
+
+        allocations.PushBack(ptr);
+        sizes.PushBack(uiSize);
+        uiExpectedSize += uiSize;
+      }
+      else
+      {
+        const ezUInt32 uiIndex = rand() % allocations.GetCount();
+        const ezUInt32 uiLast = allocations.GetCount() - 1;
+
+        uiExpectedSize -= sizes[uiIndex];
+        allocator.Deallocate(allocations[uiIndex]);
+
+        // the remaining allocations must not have been overwritten
+        if (uiIndex != uiLast)
+        {
+          EZ_TEST_INT(allocations[uiLast][0], static_cast<ezUInt8>(uiLast));
+          EZ_TEST_INT(allocations[uiLast][sizes[uiLast] - 1], static_cast<ezUInt8>(uiLast));
+          ezMemoryUtils::PatternFill(allocations[uiLast], static_cast<ezUInt8>(uiIndex), sizes[uiLast]);
+        }
+
+        allocations.RemoveAtAndSwap(uiIndex);
+        sizes.RemoveAtAndSwap(uiIndex);
+      }
+    }
+
+    ezAllocatorBase::Stats stats = allocator.GetStats();
+    EZ_TEST_INT(stats.m_uiNumAllocations - stats.m_uiNumDeallocations, allocations.GetCount());
+    EZ_TEST_INT(stats.m_uiAllocationSize, uiExpectedSize);
+
+    for (ezUInt32 i = 0; i < allocations.GetCount(); ++i)
+    {
+      EZ_TEST_INT(allocations[i][0], static_cast<ezUInt8>(i));
+      allocator.Deallocate(allocations[i]);
+    }
+
+    stats = allocator.GetStats();
+    EZ_TEST_INT(stats.m_uiNumAllocations - stats.m_uiNumDeallocations, 0);
+    EZ_TEST_INT(stats.m_uiAllocationSize, 0);
+
+    // heap allocations keep their own alignment, even when they happen to start at a slab boundary
+    for (ezUInt32 uiAlign = 16; uiAlign <= 8192; uiAlign *= 2)
+    {
+      ezUInt8* pSmall = static_cast<ezUInt8*>(allocator.Allocate(32, 8));
+      ezUInt8* pLarge = static_cast<ezUInt8*>(allocator.Allocate(SlabPolicy::MaxSlabAllocationSize + 1, uiAlign));
+      EZ_TEST_BOOL(ezMemoryUtils::IsAligned(pLarge, uiAlign));
+      ezMemoryUtils::PatternFill(pLarge, 0xAB, SlabPolicy::MaxSlabAllocationSize + 1);
+
+      allocator.Deallocate(pLarge);
+      allocator.Deallocate(pSmall);
+    }
+
+    stats = allocator.GetStats();
+    EZ_TEST_INT(stats.m_uiNumAllocations - stats.m_uiNumDeallocations, 0);
+    EZ_TEST_INT(stats.m_uiAllocationSize, 0);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "SlabAllocator multi-threaded")
+  {
+    ezSlabAllocator allocator("TestSlabAllocator");
+
+    constexpr ezUInt32 uiNumAllocations = 20000;
+    ezDynamicArray<ezUInt32*> allocations;
+    allocations.SetCount(uiNumAllocations);
+
+    ezParallelForParams params;
+    params.uiBinSize = 128;
+
+    for (ezUInt32 uiRound = 0; uiRound < 3; ++uiRound)
+    {
+      ezTaskSystem::ParallelForIndexed(
+        0, uiNumAllocations,
+        [&](ezUInt32 uiStart, ezUInt32 uiEnd) {
+          for (ezUInt32 i = uiStart; i < uiEnd; ++i)
+          {
+            const ezUInt32 uiCount = 1 + (i + uiRound) % 40;
+            allocations[i] = EZ_NEW_RAW_BUFFER(&allocator, ezUInt32, uiCount);
+            for (ezUInt32 j = 0; j < uiCount; ++j)
+            {
+              allocations[i][j] = i;
+            }
+          }
+        },
+        "SlabAllocatorTest", params);
+
+      ezAtomicInteger32 iNumCorrect;
+
+      // deallocate in reverse order, so that most of the memory is freed on a different thread than the one that allocated it
+      ezTaskSystem::ParallelForIndexed(
+        0, uiNumAllocations,
+        [&](ezUInt32 uiStart, ezUInt32 uiEnd) {
+          for (ezUInt32 i = uiStart; i < uiEnd; ++i)
+          {
+            const ezUInt32 uiIndex = uiNumAllocations - 1 - i;
+            const ezUInt32 uiCount = 1 + (uiIndex + uiRound) % 40;
+            if (allocations[uiIndex][0] == uiIndex && allocations[uiIndex][uiCount - 1] == uiIndex)
+            {
+              iNumCorrect.Increment();
+            }
+
+            EZ_DELETE_RAW_BUFFER(&allocator, allocations[uiIndex]);
+          }
+        },
+        "SlabAllocatorTest", params);
+
+      EZ_TEST_INT(iNumCorrect, uiNumAllocations);
+    }
+  }
+
   EZ_TEST_BLOCK(ezTestBlock::Enabled, "StackAllocator")
   {
     ezStackAllocator<> allocator("TestStackAllocator", ezFoundation::GetAlignedAllocator());
@@ -235,4 +422,127 @@ EZ_CREATE_SIMPLE_TEST(Memory, Allocator)
 
     EZ_TEST_BOOL(ezConstructionCounter::HasDestructed(50));
   }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "StackAllocator multi-threaded")
+  {
+    ezStackAllocator<> allocator("TestStackAllocator", ezFoundation::GetAlignedAllocator());
+
+    constexpr ezUInt32 uiNumObjects = 10000;
+    ezDynamicArray<StackAllocatorDestructCounter*> objects;
+    ezDynamicArray<ezUInt32*> values;
+    objects.SetCount(uiNumObjects);
+    values.SetCount(uiNumObjects);
+
+    StackAllocatorDestructCounter::s_iDestructions = 0;
+
+    ezParallelForParams params;
+    params.uiBinSize = 64;
+
+    for (ezUInt32 uiRound = 0; uiRound < 3; ++uiRound)
+    {
+      ezTaskSystem::ParallelForIndexed(
+        0, uiNumObjects,
+        [&](ezUInt32 uiStart, ezUInt32 uiEnd) {
+          for (ezUInt32 i = uiStart; i < uiEnd; ++i)
+          {
+            objects[i] = EZ_NEW(&allocator, StackAllocatorDestructCounter, i);
+
+            // a few large allocations, which don't fit into a thread's chunk
+            const ezUInt32 uiCount = (i % 1000) == 0 ? 8 * 1024 : (i % 7) + 1;
+            values[i] = EZ_NEW_RAW_BUFFER(&allocator, ezUInt32, uiCount);
+            for (ezUInt32 j = 0; j < uiCount; ++j)
+            {
+              values[i][j] = i;
+            }
+          }
+        },
+        "StackAllocatorTest", params);
+
+      // deallocate every other object on a different thread than the one that allocated it
+      ezTaskSystem::ParallelForIndexed(
+        0, uiNumObjects / 2,
+        [&](ezUInt32 uiStart, ezUInt32 uiEnd) {
+          for (ezUInt32 i = uiStart; i < uiEnd; ++i)
+          {
+            EZ_DELETE(&allocator, objects[uiNumObjects - 1 - i * 2]);
+          }
+        },
+        "StackAllocatorTest", params);
+
+      EZ_TEST_INT(StackAllocatorDestructCounter::s_iDestructions, uiNumObjects / 2);
+
+      ezUInt32 uiNumCorrectValues = 0;
+      for (ezUInt32 i = 0; i < uiNumObjects; ++i)
+      {
+        if (values[i][0] == i && values[i][(i % 7)] == i && ((i & 1) == 1 || objects[i]->m_uiValue == i))
+        {
+          ++uiNumCorrectValues;
+        }
+      }
+      EZ_TEST_INT(uiNumCorrectValues, uiNumObjects);
+
+      allocator.Reset();
+
+      EZ_TEST_INT(StackAllocatorDestructCounter::s_iDestructions, uiNumObjects);
+      StackAllocatorDestructCounter::s_iDestructions = 0;
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Allocation Sampling")
+  {
+    using SamplingAllocator =
+      ezAllocator<ezMemoryPolicies::ezHeapAllocation, ezMemoryTrackingFlags::RegisterAllocator | ezMemoryTrackingFlags::EnableAllocationSampling>;
+
+    const ezUInt64 uiPrevInterval = ezMemoryTracker::GetSamplingInterval();
+    ezMemoryTracker::SetSamplingInterval(1024);
+
+    {
+      SamplingAllocator allocator("TestSamplingAllocator");
+
+      const ezUInt32 uiNumAllocations = 10000;
+      const ezInt64 iTotalBytes = uiNumAllocations * 256;
+
+      ezDynamicArray<void*> allocations;
+      for (ezUInt32 i = 0; i < uiNumAllocations; ++i)
+      {
+        allocations.PushBack(allocator.Allocate(256, 8));
+      }
+
+      // the estimates are random, but they should be close
+      ezHeapProfile baseline;
+      ezMemoryTracker::CaptureHeapProfile(baseline, allocator.GetId());
+      EZ_TEST_BOOL(!baseline.GetSites().IsEmpty());
+      EZ_TEST_BOOL(ezMath::Abs(baseline.GetTotalLiveBytes() - iTotalBytes) < iTotalBytes / 5);
+      EZ_TEST_BOOL(ezMath::Abs(baseline.GetTotalLiveAllocations() - static_cast<ezInt64>(uiNumAllocations)) < uiNumAllocations / 5);
+
+      ezStringBuilder sCallTree;
+      baseline.WriteCallTree(sCallTree);
+      EZ_TEST_BOOL(sCallTree.StartsWith("Total: "));
+
+      for (ezUInt32 i = 0; i < uiNumAllocations; i += 2)
+      {
+        allocator.Deallocate(allocations[i]);
+        allocations[i] = nullptr;
+      }
+
+      ezHeapProfile profile;
+      ezMemoryTracker::CaptureHeapProfile(profile, allocator.GetId());
+      profile.Subtract(baseline);
+      EZ_TEST_BOOL(ezMath::Abs(profile.GetTotalLiveBytes() + iTotalBytes / 2) < iTotalBytes / 5);
+
+      for (void* ptr : allocations)
+      {
+        if (ptr != nullptr)
+        {
+          allocator.Deallocate(ptr);
+        }
+      }
+
+      ezMemoryTracker::CaptureHeapProfile(profile, allocator.GetId());
+      EZ_TEST_INT(profile.GetTotalLiveBytes(), 0);
+      EZ_TEST_BOOL(profile.GetSites().IsEmpty());
+    }
+
+    ezMemoryTracker::SetSamplingInterval(uiPrevInterval);
+  }
 }
@@ -27,6 +27,13 @@ struct PODTest
   ezInt32 m_iData;
 };
 
+struct TrivialDestructorTest
+{
+  TrivialDestructorTest() { m_iData = 42; }
+
+  ezInt32 m_iData;
+};
+
 static const ezUInt32 uiSize = sizeof(ezConstructTest);
 
 EZ_CREATE_SIMPLE_TEST(Memory, MemoryUtils)
@@ -197,6 +204,9 @@ EZ_CREATE_SIMPLE_TEST(Memory, MemoryUtils)
 
     func = ezMemoryUtils::MakeDestructorFunction<ezInt32>();
     EZ_TEST_BOOL(func == nullptr);
+
+    func = ezMemoryUtils::MakeDestructorFunction<TrivialDestructorTest>();
+    EZ_TEST_BOOL(func == nullptr);
   }
 
   EZ_TEST_BLOCK(ezTestBlock::Enabled, "Copy")
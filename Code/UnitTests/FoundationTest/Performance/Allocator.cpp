@@ -0,0 +1,136 @@
+#include <FoundationTestPCH.h>
+
+#include <Foundation/Logging/Log.h>
+#include <Foundation/Memory/CommonAllocators.h>
+#include <Foundation/System/SystemInformation.h>
+#include <Foundation/Threading/TaskSystem.h>
+#include <Foundation/Time/Time.h>
+
+namespace
+{
+  enum constants
+  {
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEBUG)
+    NUM_LIVE_NODES = 1024 * 4,
+    NUM_CHURN_STEPS = 1024 * 64,
+#else
+    NUM_LIVE_NODES = 1024 * 16,
+    NUM_CHURN_STEPS = 1024 * 1024,
+#endif
+    NUM_PARALLEL_WINDOWS = 16,
+  };
+
+  // tracking is disabled to only measure the allocation policies themselves
+  using HeapAllocator = ezAllocator<ezMemoryPolicies::ezHeapAllocation, ezMemoryTrackingFlags::None>;
+  using SlabAllocator = ezAllocator<ezMemoryPolicies::ezSlabAllocation, ezMemoryTrackingFlags::None>;
+
+  // Keeps a window of live allocations with the sizes of typical ezMap and ezList nodes and replaces random ones.
+  // This resembles many small containers that insert and erase elements all the time.
+  void RunNodeChurn(ezAllocatorBase* pAllocator, ezUInt32 uiSeed, ezUInt32 uiNumSteps, ezUInt32& out_uiChecksum)
+  {
+    static const ezUInt32 s_NodeSizes[] = {24, 32, 40, 48, 64, 96};
+
+    ezDynamicArray<void*> nodes;
+    nodes.SetCount(NUM_LIVE_NODES);
+
+    ezUInt32 uiRandom = uiSeed * 2654435761u + 1;
+    auto NextRandom = [&]() {
+      uiRandom ^= uiRandom << 13;
+      uiRandom ^= uiRandom >> 17;
+      uiRandom ^= uiRandom << 5;
+      return uiRandom;
+    };
+
+    for (ezUInt32 i = 0; i < NUM_LIVE_NODES; ++i)
+    {
+      nodes[i] = pAllocator->Allocate(s_NodeSizes[NextRandom() % EZ_ARRAY_SIZE(s_NodeSizes)], 8);
+    }
+
+    ezUInt32 uiChecksum = 0;
+    for (ezUInt32 i = 0; i < uiNumSteps; ++i)
+    {
+      const ezUInt32 uiIndex = NextRandom() % NUM_LIVE_NODES;
+      pAllocator->Deallocate(nodes[uiIndex]);
+
+      ezUInt32* pNode = static_cast<ezUInt32*>(pAllocator->Allocate(s_NodeSizes[NextRandom() % EZ_ARRAY_SIZE(s_NodeSizes)], 8));
+      *pNode = i;
+      uiChecksum += *pNode & 1;
+      nodes[uiIndex] = pNode;
+    }
+
+    for (void* pNode : nodes)
+    {
+      pAllocator->Deallocate(pNode);
+    }
+
+    out_uiChecksum = uiChecksum;
+  }
+
+  ezTime MeasureNodeChurn(ezAllocatorBase* pAllocator)
+  {
+    ezUInt32 uiChecksum = 0;
+
+    const ezTime t0 = ezTime::Now();
+    RunNodeChurn(pAllocator, 1, NUM_CHURN_STEPS, uiChecksum);
+    const ezTime tDuration = ezTime::Now() - t0;
+
+    EZ_TEST_INT(uiChecksum, NUM_CHURN_STEPS / 2);
+    return tDuration;
+  }
+
+  ezTime MeasureParallelNodeChurn(ezAllocatorBase* pAllocator)
+  {
+    ezAtomicInteger32 iChecksum;
+
+    ezParallelForParams params;
+    params.uiBinSize = 1;
+
+    const ezTime t0 = ezTime::Now();
+
+    ezTaskSystem::ParallelForIndexed(
+      0, NUM_PARALLEL_WINDOWS,
+      [&](ezUInt32 uiStart, ezUInt32 uiEnd) {
+        for (ezUInt32 i = uiStart; i < uiEnd; ++i)
+        {
+          ezUInt32 uiChecksum = 0;
+          RunNodeChurn(pAllocator, i + 1, NUM_CHURN_STEPS / NUM_PARALLEL_WINDOWS, uiChecksum);
+          iChecksum.Add(uiChecksum);
+        }
+      },
+      "Allocator Churn", params);
+
+    const ezTime tDuration = ezTime::Now() - t0;
+
+    EZ_TEST_INT(iChecksum, NUM_CHURN_STEPS / 2);
+    return tDuration;
+  }
+} // namespace
+
+// Enable when needed
+#define EZ_PERFORMANCE_TESTS_STATE ezTestBlock::DisabledNoWarning
+
+EZ_CREATE_SIMPLE_TEST(Performance, Allocator)
+{
+  EZ_TEST_BLOCK(EZ_PERFORMANCE_TESTS_STATE, "Node Churn")
+  {
+    HeapAllocator heapAllocator("PerfHeap");
+    SlabAllocator slabAllocator("PerfSlab");
+
+    const ezTime tHeap = MeasureNodeChurn(&heapAllocator);
+    const ezTime tSlab = MeasureNodeChurn(&slabAllocator);
+
+    ezLog::Info("[test]Node churn, heap: {0} ms, slab: {1} ms", ezArgF(tHeap.GetMilliseconds(), 2), ezArgF(tSlab.GetMilliseconds(), 2));
+  }
+
+  EZ_TEST_BLOCK(EZ_PERFORMANCE_TESTS_STATE, "Parallel Node Churn")
+  {
+    HeapAllocator heapAllocator("PerfHeap");
+    SlabAllocator slabAllocator("PerfSlab");
+
+    const ezTime tHeap = MeasureParallelNodeChurn(&heapAllocator);
+    const ezTime tSlab = MeasureParallelNodeChurn(&slabAllocator);
+
+    ezLog::Info("[test]Parallel node churn, {0} cores, heap: {1} ms, slab: {2} ms", ezSystemInformation::Get().GetCPUCoreCount(),
+      ezArgF(tHeap.GetMilliseconds(), 2), ezArgF(tSlab.GetMilliseconds(), 2));
+  }
+}
@@ -1,9 +1,11 @@
 #include <FoundationTestPCH.h>
 
 #include <Foundation/Containers/DynamicArray.h>
+#include <Foundation/Containers/HashTable.h>
 #include <Foundation/Logging/Log.h>
 #include <Foundation/Reflection/Reflection.h>
 #include <Foundation/Strings/String.h>
+#include <Foundation/Strings/StringBuilder.h>
 #include <Foundation/Time/Time.h>
 
 #include <vector>
@@ -75,6 +77,89 @@ namespace
 
   ezUInt32 SomeBigObject::constructionCount = 0;
   ezUInt32 SomeBigObject::destructionCount = 0;
+
+  // Inserts 'size' keys and then looks up every key, as well as the same number of keys that are not in the table.
+  template <typename KeyType, typename Storage>
+  void MeasureHashTableLookups(const char* szName, const ezDynamicArray<KeyType>& keys, const ezDynamicArray<KeyType>& missingKeys)
+  {
+    for (ezUInt32 size = 1024; size <= keys.GetCount(); size *= 4)
+    {
+      ezHashTable<KeyType, ezUInt32, ezHashHelper<KeyType>, ezDefaultAllocatorWrapper, Storage> map;
+
+      ezTime t0 = ezTime::Now();
+      for (ezUInt32 i = 0; i < size; i++)
+      {
+        map.Insert(keys[i], i);
+      }
+
+      ezTime t1 = ezTime::Now();
+      ezUInt32 uiFound = 0;
+      for (ezUInt32 n = 0; n < 16; n++)
+      {
+        for (ezUInt32 i = 0; i < size; i++)
+        {
+          uiFound += map.Contains(keys[i]) ? 1 : 0;
+        }
+      }
+
+      ezTime t2 = ezTime::Now();
+      ezUInt32 uiMissing = 0;
+      for (ezUInt32 n = 0; n < 16; n++)
+      {
+        for (ezUInt32 i = 0; i < size; i++)
+        {
+          uiMissing += map.Contains(missingKeys[i]) ? 0 : 1;
+        }
+      }
+
+      ezTime t3 = ezTime::Now();
+
+      EZ_TEST_INT(uiFound, size * 16);
+      EZ_TEST_INT(uiMissing, size * 16);
+
+      ezLog::Info("[test]{0} size = {1}: insert {2}ns, hit {3}ns, miss {4}ns", szName, size, ezArgF((t1 - t0).GetNanoseconds() / size, 1),
+        ezArgF((t2 - t1).GetNanoseconds() / (size * 16), 1), ezArgF((t3 - t2).GetNanoseconds() / (size * 16), 1));
+    }
+  }
+
+  template <typename Storage>
+  void MeasureHashTableLookups(const char* szStorage)
+  {
+    const ezUInt32 uiMaxSize = 1024 * 256;
+
+    {
+      ezDynamicArray<ezUInt32> keys;
+      ezDynamicArray<ezUInt32> missingKeys;
+
+      for (ezUInt32 i = 0; i < uiMaxSize; i++)
+      {
+        keys.PushBack(i * 2);
+        missingKeys.PushBack(i * 2 + 1);
+      }
+
+      ezStringBuilder sName;
+      sName.Format("ezHashTable<ezUInt32, ezUInt32> ({0})", szStorage);
+      MeasureHashTableLookups<ezUInt32, Storage>(sName, keys, missingKeys);
+    }
+
+    {
+      ezDynamicArray<ezString> keys;
+      ezDynamicArray<ezString> missingKeys;
+
+      ezStringBuilder sKey;
+      for (ezUInt32 i = 0; i < uiMaxSize / 4; i++)
+      {
+        sKey.Format("Data/Textures/Surface{0}.dds", i);
+        keys.PushBack(sKey);
+        sKey.Format("Data/Textures/Surface{0}_N.dds", i);
+        missingKeys.PushBack(sKey);
+      }
+
+      ezStringBuilder sName;
+      sName.Format("ezHashTable<ezString, ezUInt32> ({0})", szStorage);
+      MeasureHashTableLookups<ezString, Storage>(sName, keys, missingKeys);
+    }
+  }
 } // namespace
 
 // Enable when needed
@@ -423,4 +508,14 @@ EZ_CREATE_SIMPLE_TEST(Performance, Container)
         ezArgF((t1 - t0).GetMilliseconds() / static_cast<double>(NUM_SAMPLES), 4), sum);
     }
   }
+
+  EZ_TEST_BLOCK(EZ_PERFORMANCE_TESTS_STATE, "ezHashTable Lookups (Linear Storage)")
+  {
+    MeasureHashTableLookups<ezHashTableLinearStorage>("Linear");
+  }
+
+  EZ_TEST_BLOCK(EZ_PERFORMANCE_TESTS_STATE, "ezHashTable Lookups (Grouped Storage)")
+  {
+    MeasureHashTableLookups<ezHashTableGroupedStorage>("Grouped");
+  }
 }
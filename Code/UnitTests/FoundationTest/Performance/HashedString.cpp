@@ -0,0 +1,118 @@
+#include <FoundationTestPCH.h>
+
+#include <Foundation/Logging/Log.h>
+#include <Foundation/Strings/HashedString.h>
+#include <Foundation/Strings/StringBuilder.h>
+#include <Foundation/System/SystemInformation.h>
+#include <Foundation/Threading/TaskSystem.h>
+#include <Foundation/Time/Time.h>
+
+namespace
+{
+  enum constants
+  {
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEBUG)
+    NUM_STRINGS = 1024 * 4,
+    NUM_LOOKUPS_PER_STRING = 4,
+#else
+    NUM_STRINGS = 1024 * 64,
+    NUM_LOOKUPS_PER_STRING = 16,
+#endif
+  };
+
+  // Every task assigns a range of strings, which are all new in the first pass and all exist in the following ones.
+  // This is similar to loading many resources in parallel, which mostly use the same names.
+  ezTime RunParallelAssign(ezUInt32 uiRun, ezUInt32 uiNumPasses, ezUInt32& out_uiChecksum)
+  {
+    ezAtomicInteger32 iChecksum;
+
+    ezParallelForParams params;
+    params.uiBinSize = 256;
+    params.uiMaxTasksPerThread = 4;
+
+    const ezTime t0 = ezTime::Now();
+
+    for (ezUInt32 uiPass = 0; uiPass < uiNumPasses; ++uiPass)
+    {
+      ezTaskSystem::ParallelForIndexed(
+        0, NUM_STRINGS,
+        [&](ezUInt32 uiStart, ezUInt32 uiEnd) {
+          ezStringBuilder sb;
+          ezHashedString s;
+          ezInt32 iLocalChecksum = 0;
+
+          for (ezUInt32 i = uiStart; i < uiEnd; ++i)
+          {
+            sb.Format("Perf/Run{}/Resource{}", uiRun, i);
+            s.Assign(sb.GetView());
+            iLocalChecksum += s.IsEmpty() ? 0 : 1;
+          }
+
+          iChecksum.Add(iLocalChecksum);
+        },
+        "HashedString Assign", params);
+    }
+
+    const ezTime tDuration = ezTime::Now() - t0;
+
+    out_uiChecksum = iChecksum;
+    return tDuration;
+  }
+} // namespace
+
+// Enable when needed
+#define EZ_PERFORMANCE_TESTS_STATE ezTestBlock::DisabledNoWarning
+
+EZ_CREATE_SIMPLE_TEST(Performance, HashedString)
+{
+  const ezUInt32 uiPrevShortTasks = ezTaskSystem::GetWorkerThreadCount(ezWorkerThreadType::ShortTasks);
+  const ezUInt32 uiPrevLongTasks = ezTaskSystem::GetWorkerThreadCount(ezWorkerThreadType::LongTasks);
+  const ezUInt32 uiNumCores = ezMath::Max(1u, ezSystemInformation::Get().GetCPUCoreCount());
+
+  // 1, 2, 4, ... threads up to the number of cores
+  ezHybridArray<ezUInt32, 16> threadCounts;
+  for (ezUInt32 uiThreads = 1; uiThreads < uiNumCores; uiThreads *= 2)
+  {
+    threadCounts.PushBack(uiThreads);
+  }
+  threadCounts.PushBack(uiNumCores);
+
+  EZ_TEST_BLOCK(EZ_PERFORMANCE_TESTS_STATE, "Parallel Insert")
+  {
+    ezUInt32 uiRun = 0;
+
+    for (ezUInt32 uiThreads : threadCounts)
+    {
+      ezTaskSystem::SetWorkerThreadCount(uiThreads, uiPrevLongTasks);
+
+      // every run uses new strings
+      ++uiRun;
+
+      ezUInt32 uiChecksum = 0;
+      const ezTime tDuration = RunParallelAssign(uiRun, 1, uiChecksum);
+      EZ_TEST_INT(uiChecksum, NUM_STRINGS);
+
+      ezLog::Info("[test]New strings, {0} threads: {1} strings per ms", uiThreads, ezArgF(NUM_STRINGS / tDuration.GetMilliseconds(), 1));
+    }
+  }
+
+  EZ_TEST_BLOCK(EZ_PERFORMANCE_TESTS_STATE, "Parallel Lookup")
+  {
+    // all strings exist already
+    ezUInt32 uiChecksum = 0;
+    RunParallelAssign(0, 1, uiChecksum);
+
+    for (ezUInt32 uiThreads : threadCounts)
+    {
+      ezTaskSystem::SetWorkerThreadCount(uiThreads, uiPrevLongTasks);
+
+      const ezTime tDuration = RunParallelAssign(0, NUM_LOOKUPS_PER_STRING, uiChecksum);
+      EZ_TEST_INT(uiChecksum, NUM_STRINGS * NUM_LOOKUPS_PER_STRING);
+
+      ezLog::Info("[test]Existing strings, {0} threads: {1} strings per ms", uiThreads,
+        ezArgF(NUM_STRINGS * NUM_LOOKUPS_PER_STRING / tDuration.GetMilliseconds(), 1));
+    }
+  }
+
+  ezTaskSystem::SetWorkerThreadCount(uiPrevShortTasks, uiPrevLongTasks);
+}
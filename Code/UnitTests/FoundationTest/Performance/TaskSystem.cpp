@@ -0,0 +1,256 @@
+#include <FoundationTestPCH.h>
+
+#include <Foundation/Logging/Log.h>
+#include <Foundation/System/SystemInformation.h>
+#include <Foundation/Threading/DelegateTask.h>
+#include <Foundation/Threading/TaskSystem.h>
+#include <Foundation/Time/Time.h>
+
+namespace
+{
+  enum constants
+  {
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEBUG)
+    NUM_FRAMES = 32,
+    NUM_PARALLEL_FORS = 16,
+    NUM_ITEMS = 1024 * 4,
+    NUM_CHAIN_GROUPS = 1024,
+    NUM_DIAMONDS = 128,
+    NUM_DIAMOND_WIDTH = 16,
+#else
+    NUM_FRAMES = 128,
+    NUM_PARALLEL_FORS = 64,
+    NUM_ITEMS = 1024 * 16,
+    NUM_CHAIN_GROUPS = 1024 * 4,
+    NUM_DIAMONDS = 1024,
+    NUM_DIAMOND_WIDTH = 32,
+#endif
+  };
+
+  // Simulates frames with many small ParallelFor invocations, which are started from within other tasks.
+  // The work per item is tiny, so the measured time is dominated by the overhead of scheduling and fetching tasks.
+  ezTime RunParallelForFrames(ezUInt32& out_uiChecksum)
+  {
+    ezAtomicInteger32 iSum;
+
+    ezParallelForParams params;
+    params.uiBinSize = 64;
+    params.uiMaxTasksPerThread = 8;
+
+    auto ParallelForWork = [&]() {
+      ezTaskSystem::ParallelForIndexed(
+        0, NUM_ITEMS / NUM_PARALLEL_FORS,
+        [&](ezUInt32 uiStart, ezUInt32 uiEnd) {
+          ezInt32 iLocalSum = 0;
+          for (ezUInt32 i = uiStart; i < uiEnd; ++i)
+          {
+            iLocalSum += i & 1;
+          }
+          iSum.Add(iLocalSum);
+        },
+        "Inner", params);
+    };
+
+    ezDynamicArray<ezSharedPtr<ezTask>> tasks;
+    for (ezUInt32 i = 0; i < NUM_PARALLEL_FORS; ++i)
+    {
+      ezSharedPtr<ezTask> pTask = EZ_DEFAULT_NEW(ezDelegateTask<void>, "Outer", ParallelForWork);
+      pTask->ConfigureTask("Outer", ezTaskNesting::Maybe);
+      tasks.PushBack(pTask);
+    }
+
+    const ezTime t0 = ezTime::Now();
+
+    for (ezUInt32 frame = 0; frame < NUM_FRAMES; ++frame)
+    {
+      ezTaskGroupID group = ezTaskSystem::CreateTaskGroup(ezTaskPriority::ThisFrame);
+
+      for (const auto& pTask : tasks)
+      {
+        ezTaskSystem::AddTaskToGroup(group, pTask);
+      }
+
+      ezTaskSystem::StartTaskGroup(group);
+      ezTaskSystem::WaitForGroup(group);
+
+      ezTaskSystem::FinishFrameTasks();
+    }
+
+    const ezTime tDuration = ezTime::Now() - t0;
+
+    out_uiChecksum = iSum;
+    return tDuration;
+  }
+
+  // Runs a long chain of groups with one tiny task each, where every group depends on the previous one.
+  // Only one task is ready at any time, so this measures the latency from finishing a group to starting its dependent.
+  ezTime RunDependencyChain(ezUInt32& out_uiChecksum)
+  {
+    ezAtomicInteger32 iSum;
+    auto Work = [&]() { iSum.Increment(); };
+
+    ezDynamicArray<ezTaskGroupID> groups;
+    groups.SetCount(NUM_CHAIN_GROUPS);
+
+    const ezTime t0 = ezTime::Now();
+
+    for (ezUInt32 i = 0; i < NUM_CHAIN_GROUPS; ++i)
+    {
+      groups[i] = ezTaskSystem::CreateTaskGroup(ezTaskPriority::ThisFrame);
+      ezTaskSystem::AddTaskToGroup(groups[i], EZ_DEFAULT_NEW(ezDelegateTask<void>, "Chain", Work));
+
+      if (i > 0)
+      {
+        ezTaskSystem::AddTaskGroupDependency(groups[i], groups[i - 1]);
+      }
+
+      ezTaskSystem::StartTaskGroup(groups[i]);
+    }
+
+    ezTaskSystem::WaitForGroup(groups.PeekBack());
+
+    const ezTime tDuration = ezTime::Now() - t0;
+
+    ezTaskSystem::FinishFrameTasks();
+
+    out_uiChecksum = iSum;
+    return tDuration;
+  }
+
+  // Runs a sequence of diamond shaped graphs: one root group, many groups that depend on it and one group that depends on all of those.
+  // This stresses the fan-out when a group with many dependents finishes and the fan-in of many groups finishing at the same time.
+  ezTime RunDiamondDAG(ezUInt32& out_uiChecksum)
+  {
+    ezAtomicInteger32 iSum;
+    auto Work = [&]() { iSum.Increment(); };
+
+    ezTaskGroupID previousSink;
+
+    const ezTime t0 = ezTime::Now();
+
+    for (ezUInt32 d = 0; d < NUM_DIAMONDS; ++d)
+    {
+      ezTaskGroupID root = ezTaskSystem::CreateTaskGroup(ezTaskPriority::ThisFrame);
+      ezTaskSystem::AddTaskToGroup(root, EZ_DEFAULT_NEW(ezDelegateTask<void>, "Root", Work));
+
+      if (previousSink.IsValid())
+      {
+        ezTaskSystem::AddTaskGroupDependency(root, previousSink);
+      }
+
+      ezTaskGroupID sink = ezTaskSystem::CreateTaskGroup(ezTaskPriority::ThisFrame);
+      ezTaskSystem::AddTaskToGroup(sink, EZ_DEFAULT_NEW(ezDelegateTask<void>, "Sink", Work));
+
+      for (ezUInt32 i = 0; i < NUM_DIAMOND_WIDTH; ++i)
+      {
+        ezTaskGroupID middle = ezTaskSystem::CreateTaskGroup(ezTaskPriority::ThisFrame);
+        ezTaskSystem::AddTaskToGroup(middle, EZ_DEFAULT_NEW(ezDelegateTask<void>, "Middle", Work));
+        ezTaskSystem::AddTaskGroupDependency(middle, root);
+        ezTaskSystem::AddTaskGroupDependency(sink, middle);
+        ezTaskSystem::StartTaskGroup(middle);
+      }
+
+      ezTaskSystem::StartTaskGroup(sink);
+      ezTaskSystem::StartTaskGroup(root);
+
+      previousSink = sink;
+    }
+
+    ezTaskSystem::WaitForGroup(previousSink);
+
+    const ezTime tDuration = ezTime::Now() - t0;
+
+    ezTaskSystem::FinishFrameTasks();
+
+    out_uiChecksum = iSum;
+    return tDuration;
+  }
+} // namespace
+
+// Enable when needed
+#define EZ_PERFORMANCE_TESTS_STATE ezTestBlock::DisabledNoWarning
+
+EZ_CREATE_SIMPLE_TEST(Performance, TaskSystem)
+{
+  const ezUInt32 uiPrevShortTasks = ezTaskSystem::GetWorkerThreadCount(ezWorkerThreadType::ShortTasks);
+  const ezUInt32 uiPrevLongTasks = ezTaskSystem::GetWorkerThreadCount(ezWorkerThreadType::LongTasks);
+  const ezUInt32 uiNumCores = ezMath::Max(1u, ezSystemInformation::Get().GetCPUCoreCount());
+
+  const ezUInt32 uiExpectedChecksum = NUM_FRAMES * NUM_ITEMS / 2;
+
+  // 1, 2, 4, ... threads up to the number of cores
+  ezHybridArray<ezUInt32, 16> threadCounts;
+  for (ezUInt32 uiThreads = 1; uiThreads < uiNumCores; uiThreads *= 2)
+  {
+    threadCounts.PushBack(uiThreads);
+  }
+  threadCounts.PushBack(uiNumCores);
+
+  EZ_TEST_BLOCK(EZ_PERFORMANCE_TESTS_STATE, "ParallelFor Contention")
+  {
+    const char* szModeNames[] = {"Global Queues", "Work Stealing"};
+    const ezTaskSchedulingMode::Enum modes[] = {ezTaskSchedulingMode::GlobalQueues, ezTaskSchedulingMode::WorkStealing};
+
+    for (ezUInt32 m = 0; m < EZ_ARRAY_SIZE(modes); ++m)
+    {
+      ezTaskSystem::SetSchedulingMode(modes[m]);
+
+      for (ezUInt32 uiThreads : threadCounts)
+      {
+        ezTaskSystem::SetWorkerThreadCount(uiThreads, uiPrevLongTasks);
+
+        ezUInt32 uiChecksum = 0;
+
+        // warm up
+        RunParallelForFrames(uiChecksum);
+
+        const ezTime tDuration = RunParallelForFrames(uiChecksum);
+        EZ_TEST_INT(uiChecksum, uiExpectedChecksum);
+
+        ezLog::Info("[test]{0}, {1} threads: {2}ms per frame", szModeNames[m], uiThreads,
+          ezArgF(tDuration.GetMilliseconds() / static_cast<double>(NUM_FRAMES), 4));
+      }
+    }
+  }
+
+  EZ_TEST_BLOCK(EZ_PERFORMANCE_TESTS_STATE, "Dependency Chain")
+  {
+    for (ezUInt32 uiThreads : threadCounts)
+    {
+      ezTaskSystem::SetWorkerThreadCount(uiThreads, uiPrevLongTasks);
+
+      ezUInt32 uiChecksum = 0;
+
+      // warm up
+      RunDependencyChain(uiChecksum);
+
+      const ezTime tDuration = RunDependencyChain(uiChecksum);
+      EZ_TEST_INT(uiChecksum, NUM_CHAIN_GROUPS);
+
+      ezLog::Info("[test]Dependency chain, {0} threads: {1} groups per ms", uiThreads, ezArgF(NUM_CHAIN_GROUPS / tDuration.GetMilliseconds(), 1));
+    }
+  }
+
+  EZ_TEST_BLOCK(EZ_PERFORMANCE_TESTS_STATE, "Diamond DAG")
+  {
+    const ezUInt32 uiGroupsPerDiamond = NUM_DIAMOND_WIDTH + 2;
+
+    for (ezUInt32 uiThreads : threadCounts)
+    {
+      ezTaskSystem::SetWorkerThreadCount(uiThreads, uiPrevLongTasks);
+
+      ezUInt32 uiChecksum = 0;
+
+      // warm up
+      RunDiamondDAG(uiChecksum);
+
+      const ezTime tDuration = RunDiamondDAG(uiChecksum);
+      EZ_TEST_INT(uiChecksum, NUM_DIAMONDS * uiGroupsPerDiamond);
+
+      ezLog::Info("[test]Diamond DAG, {0} threads: {1} groups per ms", uiThreads, ezArgF(NUM_DIAMONDS * uiGroupsPerDiamond / tDuration.GetMilliseconds(), 1));
+    }
+  }
+
+  ezTaskSystem::SetSchedulingMode(ezTaskSchedulingMode::Default);
+  ezTaskSystem::SetWorkerThreadCount(uiPrevShortTasks, uiPrevLongTasks);
+}
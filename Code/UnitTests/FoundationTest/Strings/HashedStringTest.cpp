@@ -1,6 +1,8 @@
 #include <FoundationTestPCH.h>
 
 #include <Foundation/Strings/HashedString.h>
+#include <Foundation/Strings/StringBuilder.h>
+#include <Foundation/Threading/TaskSystem.h>
 
 EZ_CREATE_SIMPLE_TEST(Strings, HashedString)
 {
@@ -201,4 +203,54 @@ EZ_CREATE_SIMPLE_TEST(Strings, HashedString)
     EZ_TEST_INT(ezHashedString::ClearUnusedStrings(), 0);
   }
 #endif
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Concurrent Assign")
+  {
+    // many threads add the same strings at the same time, all of them must end up with the same entries
+    const ezUInt32 uiNumStrings = 1000;
+    const ezUInt32 uiNumAssigns = 16 * uiNumStrings;
+
+    ezDynamicArray<ezHashedString> strings;
+    strings.SetCount(uiNumAssigns);
+
+    ezParallelForParams params;
+    params.uiBinSize = 64;
+
+    for (ezUInt32 uiRound = 0; uiRound < 2; ++uiRound)
+    {
+      ezTaskSystem::ParallelForIndexed(
+        0, uiNumAssigns,
+        [&strings, uiRound](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+          ezStringBuilder sb;
+
+          for (ezUInt32 i = uiStartIndex; i < uiEndIndex; ++i)
+          {
+            sb.Format("Concurrent {} {}", uiRound, i % uiNumStrings);
+            strings[i].Assign(sb.GetView());
+          }
+        },
+        "HashedString Concurrent Assign", params);
+
+      ezStringBuilder sb;
+      ezUInt32 uiNumWrong = 0;
+
+      for (ezUInt32 i = 0; i < uiNumAssigns; ++i)
+      {
+        sb.Format("Concurrent {} {}", uiRound, i % uiNumStrings);
+
+        if (strings[i].GetView() != sb.GetView() || strings[i] != strings[i % uiNumStrings])
+          ++uiNumWrong;
+      }
+
+      EZ_TEST_INT(uiNumWrong, 0);
+    }
+
+#if EZ_ENABLED(EZ_HASHED_STRING_REF_COUNTING)
+    // the strings of the first round are not referenced anymore
+    EZ_TEST_INT(ezHashedString::ClearUnusedStrings(), uiNumStrings);
+
+    strings.Clear();
+    EZ_TEST_INT(ezHashedString::ClearUnusedStrings(), uiNumStrings);
+#endif
+  }
 }
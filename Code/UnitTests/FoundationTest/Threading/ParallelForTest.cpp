@@ -212,4 +212,137 @@ EZ_CREATE_SIMPLE_TEST(Threading, ParallelFor)
     // check the resulting sum
     EZ_TEST_INT(uiNumbersSum, 4 * uiNumbersCheckSum);
   }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Parallel For (Adaptive)")
+  {
+    ezParallelForParams adaptiveParams;
+    adaptiveParams.bAdaptiveGranularity = true;
+    adaptiveParams.targetTaskDuration = ezTime::Microseconds(50);
+
+    ezDynamicArray<ezUInt32> visits;
+    ezDynamicArray<ezUInt32> results;
+    visits.SetCount(10000);
+    results.SetCount(10000);
+
+    // the first call measures the items, the later ones use and refine the stored cost
+    for (ezUInt32 uiCall = 0; uiCall < 4; ++uiCall)
+    {
+      for (ezUInt32& uiVisits : visits)
+      {
+        uiVisits = 0;
+      }
+
+      ezTaskSystem::ParallelForIndexed(
+        0, visits.GetCount(),
+        [&visits, &results](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+          for (ezUInt32 uiIndex = uiStartIndex; uiIndex < uiEndIndex; ++uiIndex)
+          {
+            // some work, so that the items are not free
+            ezUInt32 uiValue = uiIndex;
+            for (ezUInt32 i = 0; i < 100; ++i)
+            {
+              uiValue = uiValue * 1664525u + 1013904223u;
+            }
+
+            results[uiIndex] = uiValue;
+            visits[uiIndex] += 1;
+          }
+        },
+        "ParallelForIndexed Adaptive Test", adaptiveParams);
+
+      ezUInt32 uiWrongVisits = 0;
+      for (ezUInt32 uiVisits : visits)
+      {
+        if (uiVisits != 1)
+          ++uiWrongVisits;
+      }
+
+      EZ_TEST_INT(uiWrongVisits, 0);
+    }
+
+    // a sub-range and the array versions
+    ResetSharedVariables();
+
+    ezTaskSystem::ParallelForIndexed(
+      10, 50,
+      [&dataAccessMutex, &uiNumbersSum, &numbers](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+        EZ_LOCK(dataAccessMutex);
+        for (ezUInt32 uiIndex = uiStartIndex; uiIndex < uiEndIndex; ++uiIndex)
+        {
+          uiNumbersSum += numbers[uiIndex];
+        }
+      },
+      "ParallelForIndexed Adaptive Range Test", adaptiveParams);
+
+    // numbers 11 to 60
+    EZ_TEST_INT(uiNumbersSum, (11 + 60) * 50 / 2);
+
+    for (ezUInt32 uiCall = 0; uiCall < 2; ++uiCall)
+    {
+      uiNumbersSum = 0;
+
+      ezTaskSystem::ParallelForSingleIndex(
+        numbers.GetArrayPtr(),
+        [&dataAccessMutex, &uiNumbersSum](ezUInt32 uiIndex, ezUInt32 uiNumber) {
+          EZ_LOCK(dataAccessMutex);
+          uiNumbersSum += uiNumber + (uiIndex + 1);
+        },
+        "ParallelFor Array Single Index Adaptive Test", adaptiveParams);
+
+      EZ_TEST_INT(uiNumbersSum, 2 * uiNumbersCheckSum);
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Parallel For (Adaptive Granularity)")
+  {
+    ezParallelForParams adaptiveParams;
+    adaptiveParams.bAdaptiveGranularity = true;
+    adaptiveParams.uiBinSize = 1;
+    adaptiveParams.targetTaskDuration = ezTime::Microseconds(100);
+
+    // each expensive item takes at least 20us, so no more than 5 of them fit into the target duration
+    const ezTime expensiveItemDuration = ezTime::Microseconds(20);
+
+    auto runAndGetLargestRange = [&](const char* szTaskName, ezUInt32 uiNumItems, bool bExpensive) {
+      ezAtomicInteger32 iLargestRange;
+
+      ezTaskSystem::ParallelForIndexed(
+        0, uiNumItems,
+        [&](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+          iLargestRange.Max(static_cast<ezInt32>(uiEndIndex - uiStartIndex));
+
+          if (bExpensive)
+          {
+            for (ezUInt32 uiIndex = uiStartIndex; uiIndex < uiEndIndex; ++uiIndex)
+            {
+              const ezTime tEnd = ezTime::Now() + expensiveItemDuration;
+              while (ezTime::Now() < tEnd)
+              {
+              }
+            }
+          }
+        },
+        szTaskName, adaptiveParams);
+
+      return static_cast<ezUInt32>(iLargestRange);
+    };
+
+    const ezUInt32 uiExpensiveRange = runAndGetLargestRange("ParallelFor Adaptive Expensive Items", 500, true);
+    const ezUInt32 uiCheapRange = runAndGetLargestRange("ParallelFor Adaptive Cheap Items", 100000, false);
+
+    EZ_TEST_BOOL(uiExpensiveRange <= 5);
+    EZ_TEST_BOOL(uiCheapRange >= 1000);
+
+    // when the work behind the same task name gets cheaper, the tasks get larger from call to call, the stored cost only follows gradually
+    const ezUInt32 uiFirstRange = runAndGetLargestRange("ParallelFor Adaptive Changing Items", 500, true);
+    ezUInt32 uiLastRange = 0;
+
+    for (ezUInt32 uiCall = 0; uiCall < 10; ++uiCall)
+    {
+      uiLastRange = runAndGetLargestRange("ParallelFor Adaptive Changing Items", 100000, false);
+    }
+
+    EZ_TEST_BOOL(uiFirstRange <= 5);
+    EZ_TEST_BOOL(uiLastRange > 2 * uiFirstRange);
+  }
 }
@@ -2,6 +2,9 @@
 
 #include <Foundation/IO/FileSystem/DataDirTypeFolder.h>
 #include <Foundation/IO/FileSystem/FileWriter.h>
+#include <Foundation/System/SystemInformation.h>
+#include <Foundation/Threading/DelegateTask.h>
+#include <Foundation/Threading/SuspendableTask.h>
 #include <Foundation/Threading/TaskSystem.h>
 #include <Foundation/Time/Time.h>
 #include <Foundation/Utilities/DGMLWriter.h>
@@ -66,6 +69,46 @@ private:
   }
 };
 
+class ezTestSuspendableTask final : public ezSuspendableTask
+{
+public:
+  ezSharedPtr<ezTestTask> m_pChild;
+  bool m_bChildDoneWhenResumed = false;
+  ezUInt32 m_uiFinalResumeCount = 0;
+
+  ezTestSuspendableTask()
+  {
+    m_pChild = EZ_DEFAULT_NEW(ezTestTask);
+    m_pChild->m_uiIterations = 5;
+
+    ConfigureTask("ezTestSuspendableTask", ezTaskNesting::Never);
+  }
+
+private:
+  ezTaskGroupID m_ChildGroup;
+
+  virtual void Execute() override
+  {
+    switch (GetResumeCount())
+    {
+      case 0:
+        m_ChildGroup = ezTaskSystem::StartSingleTask(m_pChild, ezTaskPriority::ThisFrame);
+        SuspendUntil(m_ChildGroup);
+        return;
+
+      case 1:
+        m_bChildDoneWhenResumed = m_pChild->IsDone();
+        // the group has already finished, so this continues right away
+        SuspendUntil(m_ChildGroup);
+        return;
+
+      default:
+        m_uiFinalResumeCount = GetResumeCount();
+        return;
+    }
+  }
+};
+
 class TaskCallbacks
 {
 public:
@@ -550,6 +593,184 @@ EZ_CREATE_SIMPLE_TEST(Threading, TaskSystem)
     EZ_TEST_BOOL(t[2]->IsMultiplicityDone());
   }
 
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Work Stealing")
+  {
+    ezTaskSystem::SetSchedulingMode(ezTaskSchedulingMode::WorkStealing);
+    EZ_TEST_INT(ezTaskSystem::GetSchedulingMode(), ezTaskSchedulingMode::WorkStealing);
+
+    // tasks started from the main thread end up in its local queue and must be stolen by the workers
+    ezSharedPtr<ezTestTask> t[3];
+    ezTaskGroupID tg[3];
+
+    for (ezUInt32 i = 0; i < 3; ++i)
+    {
+      t[i] = EZ_DEFAULT_NEW(ezTestTask);
+      t[i]->m_uiIterations = 0;
+      t[i]->SetMultiplicity(200);
+    }
+
+    tg[0] = ezTaskSystem::StartSingleTask(t[0], ezTaskPriority::LateThisFrame);
+    tg[1] = ezTaskSystem::StartSingleTask(t[1], ezTaskPriority::ThisFrame);
+    tg[2] = ezTaskSystem::StartSingleTask(t[2], ezTaskPriority::EarlyThisFrame, tg[1]);
+
+    ezTaskSystem::WaitForGroup(tg[0]);
+    ezTaskSystem::WaitForGroup(tg[1]);
+    ezTaskSystem::WaitForGroup(tg[2]);
+
+    EZ_TEST_BOOL(t[0]->IsMultiplicityDone());
+    EZ_TEST_BOOL(t[1]->IsMultiplicityDone());
+    EZ_TEST_BOOL(t[2]->IsMultiplicityDone());
+
+    // tasks that start and wait for nested work, which ends up in the local queues of the workers
+    ezAtomicInteger32 iNumItemsProcessed;
+    ezDynamicArray<ezSharedPtr<ezTask>> outerTasks;
+    ezTaskGroupID outerGroup = ezTaskSystem::CreateTaskGroup(ezTaskPriority::ThisFrame);
+
+    for (ezUInt32 i = 0; i < 8; ++i)
+    {
+      ezSharedPtr<ezTask> pTask = EZ_DEFAULT_NEW(ezDelegateTask<void>, "Outer", [&iNumItemsProcessed]() {
+        ezTaskSystem::ParallelForIndexed(0, 1000, [&iNumItemsProcessed](ezUInt32 uiStart, ezUInt32 uiEnd) { iNumItemsProcessed.Add(uiEnd - uiStart); });
+      });
+      pTask->ConfigureTask("Outer", ezTaskNesting::Maybe);
+
+      outerTasks.PushBack(pTask);
+      ezTaskSystem::AddTaskToGroup(outerGroup, pTask);
+    }
+
+    ezTaskSystem::StartTaskGroup(outerGroup);
+    ezTaskSystem::WaitForGroup(outerGroup);
+
+    EZ_TEST_INT(iNumItemsProcessed, 8 * 1000);
+
+    ezTaskSystem::FinishFrameTasks();
+
+    ezTaskSystem::SetSchedulingMode(ezTaskSchedulingMode::GlobalQueues);
+    EZ_TEST_INT(ezTaskSystem::GetSchedulingMode(), ezTaskSchedulingMode::GlobalQueues);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Suspendable Tasks")
+  {
+    // more suspended tasks than worker threads, which would deadlock, if they blocked their threads while waiting
+    const ezUInt32 uiNumTasks = 16;
+
+    ezSharedPtr<ezTestSuspendableTask> t[uiNumTasks];
+    ezTaskGroupID group = ezTaskSystem::CreateTaskGroup(ezTaskPriority::ThisFrame);
+
+    for (ezUInt32 i = 0; i < uiNumTasks; ++i)
+    {
+      t[i] = EZ_DEFAULT_NEW(ezTestSuspendableTask);
+      ezTaskSystem::AddTaskToGroup(group, t[i]);
+    }
+
+    ezTaskSystem::StartTaskGroup(group);
+    ezTaskSystem::WaitForGroup(group);
+
+    for (ezUInt32 i = 0; i < uiNumTasks; ++i)
+    {
+      EZ_TEST_BOOL(t[i]->IsTaskFinished());
+      EZ_TEST_BOOL(t[i]->m_pChild->IsDone());
+      EZ_TEST_BOOL(t[i]->m_bChildDoneWhenResumed);
+      EZ_TEST_INT(t[i]->m_uiFinalResumeCount, 2);
+    }
+
+    ezTaskSystem::FinishFrameTasks();
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Dependency Fan-Out")
+  {
+    // diamond shaped graphs: one root, many groups that depend on it and one group that depends on all of them
+    // some of the middle groups get started while the root is running or already finished
+    const ezUInt32 uiNumMiddle = 16;
+
+    ezAtomicInteger32 iRootDone;
+    ezAtomicInteger32 iMiddleDone;
+    ezAtomicInteger32 iErrors;
+
+    auto RootFunc = [&]() { iRootDone.Increment(); };
+    auto MiddleFunc = [&]() {
+      if (iRootDone != 1)
+        iErrors.Increment();
+
+      iMiddleDone.Increment();
+    };
+    auto SinkFunc = [&]() {
+      if (iMiddleDone != static_cast<ezInt32>(uiNumMiddle))
+        iErrors.Increment();
+    };
+
+    for (ezUInt32 iteration = 0; iteration < 100; ++iteration)
+    {
+      iRootDone = 0;
+      iMiddleDone = 0;
+
+      ezTaskGroupID root = ezTaskSystem::StartSingleTask(EZ_DEFAULT_NEW(ezDelegateTask<void>, "Root", RootFunc), ezTaskPriority::ThisFrame);
+
+      ezTaskGroupID sink = ezTaskSystem::CreateTaskGroup(ezTaskPriority::ThisFrame);
+      ezTaskSystem::AddTaskToGroup(sink, EZ_DEFAULT_NEW(ezDelegateTask<void>, "Sink", SinkFunc));
+
+      for (ezUInt32 i = 0; i < uiNumMiddle; ++i)
+      {
+        ezTaskGroupID middle = ezTaskSystem::StartSingleTask(EZ_DEFAULT_NEW(ezDelegateTask<void>, "Middle", MiddleFunc), ezTaskPriority::ThisFrame, root);
+        ezTaskSystem::AddTaskGroupDependency(sink, middle);
+      }
+
+      ezTaskSystem::StartTaskGroup(sink);
+      ezTaskSystem::WaitForGroup(sink);
+
+      EZ_TEST_BOOL(ezTaskSystem::IsTaskGroupFinished(root));
+      EZ_TEST_INT(iMiddleDone, uiNumMiddle);
+    }
+
+    EZ_TEST_INT(iErrors, 0);
+
+    ezTaskSystem::FinishFrameTasks();
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Worker Thread Affinity")
+  {
+    const ezCPUTopology& topology = ezSystemInformation::Get().GetCPUTopology();
+
+    EZ_TEST_BOOL(topology.m_uiNumLogicalProcessors >= 1);
+    EZ_TEST_BOOL(topology.m_uiNumCores >= 1 && topology.m_uiNumCores <= topology.m_uiNumLogicalProcessors);
+    EZ_TEST_BOOL(topology.m_uiNumCacheGroups >= 1 && topology.m_uiNumCacheGroups <= topology.m_uiNumCores);
+    EZ_TEST_BOOL(topology.m_uiNumNumaNodes >= 1);
+    EZ_TEST_BOOL(topology.m_uiNumPackages >= 1);
+
+    for (ezUInt32 i = 0; i < topology.m_uiNumLogicalProcessors; ++i)
+    {
+      const ezCPUTopology::LogicalProcessor& lp = topology.m_LogicalProcessors[i];
+      EZ_TEST_BOOL(lp.m_uiCore < topology.m_uiNumCores);
+      EZ_TEST_BOOL(lp.m_uiCacheGroup < topology.m_uiNumCacheGroups);
+      EZ_TEST_BOOL(lp.m_uiNumaNode < topology.m_uiNumNumaNodes);
+      EZ_TEST_BOOL(lp.m_uiPackage < topology.m_uiNumPackages);
+    }
+
+    const ezUInt32 uiShortTasks = ezTaskSystem::GetWorkerThreadCount(ezWorkerThreadType::ShortTasks);
+    const ezUInt32 uiLongTasks = ezTaskSystem::GetWorkerThreadCount(ezWorkerThreadType::LongTasks);
+
+    ezTaskSystem::SetSchedulingMode(ezTaskSchedulingMode::WorkStealing);
+
+    const ezWorkerThreadAffinity::Enum affinities[] = {ezWorkerThreadAffinity::Compact, ezWorkerThreadAffinity::Scatter, ezWorkerThreadAffinity::None};
+
+    for (ezWorkerThreadAffinity::Enum affinity : affinities)
+    {
+      ezTaskSystem::SetWorkerThreadAffinity(affinity, affinity != ezWorkerThreadAffinity::None);
+      EZ_TEST_INT(ezTaskSystem::GetWorkerThreadAffinity(), affinity);
+
+      // the workers are restarted with the same counts
+      EZ_TEST_INT(ezTaskSystem::GetWorkerThreadCount(ezWorkerThreadType::ShortTasks), uiShortTasks);
+      EZ_TEST_INT(ezTaskSystem::GetWorkerThreadCount(ezWorkerThreadType::LongTasks), uiLongTasks);
+
+      ezAtomicInteger32 iNumItemsProcessed;
+      ezTaskSystem::ParallelForIndexed(0, 10000, [&iNumItemsProcessed](ezUInt32 uiStart, ezUInt32 uiEnd) { iNumItemsProcessed.Add(uiEnd - uiStart); });
+      EZ_TEST_INT(iNumItemsProcessed, 10000);
+
+      ezTaskSystem::FinishFrameTasks();
+    }
+
+    ezTaskSystem::SetSchedulingMode(ezTaskSchedulingMode::GlobalQueues);
+  }
+
   // capture profiling info for testing
   /*ezStringBuilder sOutputPath = ezTestFramework::GetInstance()->GetAbsOutputPath();
 
@@ -0,0 +1,119 @@
+#include <RendererTestPCH.h>
+
+#include <Foundation/SimdMath/SimdConversion.h>
+#include <Foundation/Utilities/GraphicsUtils.h>
+#include <RendererCore/Culling/OcclusionBuffer.h>
+
+EZ_CREATE_SIMPLE_TEST_GROUP(Culling);
+
+namespace
+{
+  // unit cube around the origin
+  static const ezVec3 s_BoxVertices[] = {ezVec3(-0.5f, -0.5f, -0.5f), ezVec3(0.5f, -0.5f, -0.5f), ezVec3(-0.5f, 0.5f, -0.5f),
+    ezVec3(0.5f, 0.5f, -0.5f), ezVec3(-0.5f, -0.5f, 0.5f), ezVec3(0.5f, -0.5f, 0.5f), ezVec3(-0.5f, 0.5f, 0.5f), ezVec3(0.5f, 0.5f, 0.5f)};
+
+  static const ezUInt16 s_BoxIndices[] = {0, 2, 1, 1, 2, 3, 4, 5, 6, 5, 7, 6, 0, 1, 4, 1, 5, 4, 2, 6, 3, 3, 6, 7, 0, 4, 2, 2, 4, 6, 1, 3, 5, 3,
+    7, 5};
+
+  void RasterizeBox(ezOcclusionBuffer& buffer, const ezVec3& vCenter, const ezVec3& vSize)
+  {
+    ezMat4 transform;
+    transform.SetScalingMatrix(vSize);
+    transform.SetTranslationVector(vCenter);
+
+    buffer.RasterizeTriangles(transform, ezMakeArrayPtr(s_BoxVertices), ezMakeArrayPtr(s_BoxIndices));
+  }
+
+  bool IsOccluded(const ezOcclusionBuffer& buffer, const ezVec3& vCenter, const ezVec3& vSize)
+  {
+    ezSimdBBox box;
+    box.SetCenterAndHalfExtents(ezSimdConversion::ToVec3(vCenter), ezSimdConversion::ToVec3(vSize * 0.5f));
+
+    return buffer.IsOccluded(box);
+  }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(Culling, OcclusionBuffer)
+{
+  // the camera is at the origin and looks along the positive x axis
+  const ezMat4 viewMatrix = ezGraphicsUtils::CreateLookAtViewMatrix(ezVec3::ZeroVector(), ezVec3(1, 0, 0), ezVec3(0, 0, 1));
+
+  for (ezUInt32 uiDepthRange = 0; uiDepthRange < 2; ++uiDepthRange)
+  {
+    const ezClipSpaceDepthRange::Enum depthRange = uiDepthRange == 0 ? ezClipSpaceDepthRange::MinusOneToOne : ezClipSpaceDepthRange::ZeroToOne;
+
+    const ezMat4 projectionMatrix = ezGraphicsUtils::CreatePerspectiveProjectionMatrixFromFovY(ezAngle::Degree(90.0f), 2.0f, 0.1f, 1000.0f, depthRange);
+    const ezMat4 viewProjectionMatrix = projectionMatrix * viewMatrix;
+
+    ezOcclusionBuffer buffer;
+    buffer.SetResolution(250, 123);
+
+    EZ_TEST_BLOCK(ezTestBlock::Enabled, "SetResolution")
+    {
+      EZ_TEST_INT(buffer.GetWidth(), 256);
+      EZ_TEST_INT(buffer.GetHeight(), 128);
+      EZ_TEST_INT(buffer.GetDepthValues().GetCount(), 256 * 128);
+    }
+
+    EZ_TEST_BLOCK(ezTestBlock::Enabled, "Empty")
+    {
+      buffer.BeginFrame(viewProjectionMatrix, depthRange);
+      buffer.EndRasterization();
+
+      EZ_TEST_BOOL(!IsOccluded(buffer, ezVec3(10, 0, 0), ezVec3(1)));
+      EZ_TEST_BOOL(!IsOccluded(buffer, ezVec3(500, 0, 0), ezVec3(1)));
+      EZ_TEST_INT(buffer.GetStats().m_uiNumOccluders, 0);
+    }
+
+    EZ_TEST_BLOCK(ezTestBlock::Enabled, "Wall")
+    {
+      buffer.BeginFrame(viewProjectionMatrix, depthRange);
+      RasterizeBox(buffer, ezVec3(10, 0, 0), ezVec3(1, 10, 10));
+      buffer.EndRasterization();
+
+      EZ_TEST_INT(buffer.GetStats().m_uiNumOccluders, 1);
+      EZ_TEST_BOOL(buffer.GetStats().m_uiNumTrianglesRasterized > 0);
+
+      // behind the wall
+      EZ_TEST_BOOL(IsOccluded(buffer, ezVec3(20, 0, 0), ezVec3(2)));
+      EZ_TEST_BOOL(IsOccluded(buffer, ezVec3(50, 3, -3), ezVec3(5)));
+      EZ_TEST_BOOL(IsOccluded(buffer, ezVec3(11, 4, 4), ezVec3(0.5f)));
+
+      // in front of the wall, intersecting it or partially sticking out behind it
+      EZ_TEST_BOOL(!IsOccluded(buffer, ezVec3(5, 0, 0), ezVec3(1)));
+      EZ_TEST_BOOL(!IsOccluded(buffer, ezVec3(10, 0, 0), ezVec3(2)));
+      EZ_TEST_BOOL(!IsOccluded(buffer, ezVec3(20, 10, 0), ezVec3(2)));
+      EZ_TEST_BOOL(!IsOccluded(buffer, ezVec3(200, 0, 0), ezVec3(150)));
+
+      // crossing the near plane or behind the camera
+      EZ_TEST_BOOL(!IsOccluded(buffer, ezVec3(0, 0, 0), ezVec3(1)));
+      EZ_TEST_BOOL(!IsOccluded(buffer, ezVec3(-20, 0, 0), ezVec3(1)));
+    }
+
+    EZ_TEST_BLOCK(ezTestBlock::Enabled, "Near Plane Clipping")
+    {
+      // a floor below the camera that extends to behind it
+      buffer.BeginFrame(viewProjectionMatrix, depthRange);
+      RasterizeBox(buffer, ezVec3(0, 0, -2), ezVec3(200, 200, 1));
+      buffer.EndRasterization();
+
+      EZ_TEST_BOOL(IsOccluded(buffer, ezVec3(20, 0, -10), ezVec3(2)));
+      EZ_TEST_BOOL(IsOccluded(buffer, ezVec3(5, -3, -5), ezVec3(1)));
+      EZ_TEST_BOOL(!IsOccluded(buffer, ezVec3(20, 0, 0), ezVec3(2)));
+      EZ_TEST_BOOL(!IsOccluded(buffer, ezVec3(20, 0, -2), ezVec3(2)));
+    }
+
+    EZ_TEST_BLOCK(ezTestBlock::Enabled, "Multiple Occluders")
+    {
+      // two walls next to each other only hide objects behind both of them together
+      buffer.BeginFrame(viewProjectionMatrix, depthRange);
+      RasterizeBox(buffer, ezVec3(10, -2.5f, 0), ezVec3(1, 5, 10));
+      RasterizeBox(buffer, ezVec3(10, 2.5f, 0), ezVec3(1, 5, 10));
+      buffer.EndRasterization();
+
+      EZ_TEST_INT(buffer.GetStats().m_uiNumOccluders, 2);
+      EZ_TEST_BOOL(IsOccluded(buffer, ezVec3(30, 0, 0), ezVec3(4)));
+      EZ_TEST_BOOL(!IsOccluded(buffer, ezVec3(30, 20, 0), ezVec3(4)));
+    }
+  }
+}